@@ -18,6 +18,7 @@
 #include "exceptions/exceptions.hh"
 #include "timestamp.hh"
 #include "types/map.hh"
+#include "types/listlike_partial_deserializing_iterator.hh"
 #include "schema.hh"
 #include "query-request.hh"
 #include "query-result-reader.hh"
@@ -105,6 +106,13 @@ json::json_return_type make_streamed(rjson::value&& value) {
     return func;
 }
 
+json::json_return_type make_response(rjson::value&& value) {
+    if (is_big(value)) {
+        return make_streamed(std::move(value));
+    }
+    return make_jsonable(std::move(value));
+}
+
 json_string::json_string(std::string&& value)
     : _value(std::move(value))
 {}
@@ -1278,6 +1286,20 @@ put_or_delete_item::put_or_delete_item(const rjson::value& key, schema_ptr schem
     check_key(key, schema);
 }
 
+// Calls func with the name and the serialized value of each attribute stored
+// in a serialized ATTRS_COLUMN_NAME map, walking the map rather than
+// deserializing it, so that the values of the attributes the caller isn't
+// interested in are not copied.
+template <typename Func>
+static void for_each_serialized_attribute(bytes_view serialized_map, Func&& func) {
+    auto size = read_collection_size(serialized_map);
+    for (int i = 0; i < size; ++i) {
+        auto name = read_collection_key(serialized_map);
+        auto value = read_collection_value_nonnull(serialized_map);
+        func(std::string(reinterpret_cast<const char*>(name.data()), name.size()), value);
+    }
+}
+
 // find_attribute() checks whether the named attribute is stored in the
 // schema as a real column (we do this for key attribute, and for a GSI key)
 // and if so, returns that column. If not, the function returns nullptr,
@@ -1499,7 +1521,7 @@ static future<executor::request_return_type> rmw_operation_return(rjson::value&&
     if (!attributes.IsNull()) {
         rjson::add(ret, "Attributes", std::move(attributes));
     }
-    return make_ready_future<executor::request_return_type>(make_jsonable(std::move(ret)));
+    return make_ready_future<executor::request_return_type>(make_response(std::move(ret)));
 }
 
 static future<std::unique_ptr<rjson::value>> get_previous_item(
@@ -2316,12 +2338,8 @@ void executor::describe_single_item(const cql3::selection::selection& selection,
                 rjson::add_with_string_name(field, type_to_string((*column_it)->type), json_key_column_value(*cell, **column_it));
             }
         } else if (cell) {
-            auto deserialized = attrs_type()->deserialize(*cell);
-            auto keys_and_values = value_cast<map_type_impl::native_type>(deserialized);
-            for (auto entry : keys_and_values) {
-                std::string attr_name = value_cast<sstring>(entry.first);
+            for_each_serialized_attribute(*cell, [&] (std::string attr_name, bytes_view value) {
                 if (include_all_embedded_attributes || !attrs_to_get || attrs_to_get->contains(attr_name)) {
-                    bytes value = value_cast<bytes>(entry.second);
                     rjson::value v = deserialize_item(value);
                     if (attrs_to_get) {
                         auto it = attrs_to_get->find(attr_name);
@@ -2330,7 +2348,7 @@ void executor::describe_single_item(const cql3::selection::selection& selection,
                             // this attribute. hierarchy_filter() modifies v,
                             // and returns false when nothing is to be kept.
                             if (!hierarchy_filter(v, it->second)) {
-                                continue;
+                                return;
                             }
                         }
                     }
@@ -2338,7 +2356,7 @@ void executor::describe_single_item(const cql3::selection::selection& selection,
                     // names are unique so add() makes sense
                     rjson::add_with_string_name(item, attr_name, std::move(v));
                 }
-            }
+            });
         }
         ++column_it;
     }
@@ -3114,7 +3132,7 @@ future<executor::request_return_type> executor::get_item(client_state& client_st
             service::storage_proxy::coordinator_query_options(executor::default_timeout(), std::move(permit), client_state, trace_state)).then(
             [this, schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = std::move(attrs_to_get), start_time = std::move(start_time)] (service::storage_proxy::coordinator_query_result qr) mutable {
         _stats.api_operations.get_item_latency.add(std::chrono::steady_clock::now() - start_time);
-        return make_ready_future<executor::request_return_type>(make_jsonable(describe_item(schema, partition_slice, *selection, *qr.query_result, std::move(attrs_to_get))));
+        return make_ready_future<executor::request_return_type>(make_response(describe_item(schema, partition_slice, *selection, *qr.query_result, std::move(attrs_to_get))));
     });
 }
 
@@ -3230,35 +3248,63 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
 
     // If we got here, all "requests" are valid, so let's start the
     // requests for the different partitions all in parallel.
-    std::vector<future<std::vector<rjson::value>>> response_futures;
+    auto start_read = [&] (const table_requests& rs, dht::partition_range_vector partition_ranges, std::vector<query::clustering_range> bounds) {
+        auto regular_columns = boost::copy_range<query::column_id_vector>(
+                rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
+        auto selection = cql3::selection::selection::wildcard(rs.schema);
+        auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
+        auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice),
+                query::tombstone_limit(_proxy.get_tombstone_limit()));
+        command->allow_limit = db::allow_per_partition_rate_limit::yes;
+        future<std::vector<rjson::value>> f = _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
+                service::storage_proxy::coordinator_query_options(executor::default_timeout(), permit, client_state, trace_state)).then(
+                [schema = rs.schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = rs.attrs_to_get] (service::storage_proxy::coordinator_query_result qr) mutable {
+            utils::get_local_injector().inject("alternator_batch_get_item", [] { throw std::runtime_error("batch_get_item injection"); });
+            std::vector<rjson::value> jsons = describe_multi_item(schema, partition_slice, *selection, *qr.query_result, *attrs_to_get);
+            return make_ready_future<std::vector<rjson::value>>(std::move(jsons));
+        });
+        return f;
+    };
+    // A read of one or more partitions of a table, with the keys it reads,
+    // which are reported as unprocessed if the read fails.
+    struct partitions_read {
+        const table_requests& rs;
+        std::vector<const table_requests::clustering_keys*> keys;
+        future<std::vector<rjson::value>> result;
+    };
+    std::vector<partitions_read> reads;
     for (const auto& rs : requests) {
+        if (rs.schema->clustering_key_size() == 0) {
+            // Without a clustering key, the same slice reads the item of
+            // every partition, so all the items of the table are read by a
+            // single multi-partition query, whose reads storage_proxy sends
+            // to each replica in a single batch, rather than by a query of
+            // its own for each item.
+            std::vector<dht::decorated_key> dks;
+            std::vector<const table_requests::clustering_keys*> keys;
+            dks.reserve(rs.requests.size());
+            keys.reserve(rs.requests.size());
+            for (const auto& r : rs.requests) {
+                dks.push_back(dht::decorate_key(*rs.schema, r.first));
+                keys.push_back(&r.second);
+            }
+            std::sort(dks.begin(), dks.end(), dht::decorated_key::less_comparator(rs.schema));
+            auto partition_ranges = boost::copy_range<dht::partition_range_vector>(dks | boost::adaptors::transformed([] (dht::decorated_key& dk) {
+                return dht::partition_range::make_singular(std::move(dk));
+            }));
+            std::vector<query::clustering_range> bounds{query::clustering_range::make_open_ended_both_sides()};
+            reads.push_back({rs, std::move(keys), start_read(rs, std::move(partition_ranges), std::move(bounds))});
+            continue;
+        }
         for (const auto &r : rs.requests) {
             auto& pk = r.first;
             auto& cks = r.second;
             dht::partition_range_vector partition_ranges{dht::partition_range(dht::decorate_key(*rs.schema, pk))};
             std::vector<query::clustering_range> bounds;
-            if (rs.schema->clustering_key_size() == 0) {
-                bounds.push_back(query::clustering_range::make_open_ended_both_sides());
-            } else {
-                for (auto& ck : cks) {
-                    bounds.push_back(query::clustering_range::make_singular(ck.first));
-                }
+            for (auto& ck : cks) {
+                bounds.push_back(query::clustering_range::make_singular(ck.first));
             }
-            auto regular_columns = boost::copy_range<query::column_id_vector>(
-                    rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
-            auto selection = cql3::selection::selection::wildcard(rs.schema);
-            auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
-            auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice),
-                    query::tombstone_limit(_proxy.get_tombstone_limit()));
-            command->allow_limit = db::allow_per_partition_rate_limit::yes;
-            future<std::vector<rjson::value>> f = _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
-                    service::storage_proxy::coordinator_query_options(executor::default_timeout(), permit, client_state, trace_state)).then(
-                    [schema = rs.schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = rs.attrs_to_get] (service::storage_proxy::coordinator_query_result qr) mutable {
-                utils::get_local_injector().inject("alternator_batch_get_item", [] { throw std::runtime_error("batch_get_item injection"); });
-                std::vector<rjson::value> jsons = describe_multi_item(schema, partition_slice, *selection, *qr.query_result, *attrs_to_get);
-                return make_ready_future<std::vector<rjson::value>>(std::move(jsons));
-            });
-            response_futures.push_back(std::move(f));
+            reads.push_back({rs, {&cks}, start_read(rs, std::move(partition_ranges), std::move(bounds))});
         }
     }
 
@@ -3272,43 +3318,40 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
     rjson::add(response, "Responses", rjson::empty_object());
     rjson::add(response, "UnprocessedKeys", rjson::empty_object());
 
-    auto fut_it = response_futures.begin();
-    for (const auto& rs : requests) {
+    for (auto& read : reads) {
+        const auto& rs = read.rs;
         auto table = table_name(*rs.schema);
-        for (const auto &r : rs.requests) {
-            auto& pk = r.first;
-            auto& cks = r.second;
-            auto& fut = *fut_it;
-            ++fut_it;
-            try {
-                std::vector<rjson::value> results = co_await std::move(fut);
-                some_succeeded = true;
-                if (!response["Responses"].HasMember(table)) {
-                    rjson::add_with_string_name(response["Responses"], table, rjson::empty_array());
-                }
-                for (rjson::value& json : results) {
-                    rjson::push_back(response["Responses"][table], std::move(json));
-                }
-            } catch(...) {
-                eptr = std::current_exception();
-                // This read of potentially several rows in one partition,
-                // failed. We need to add the row key(s) to UnprocessedKeys.
-                if (!response["UnprocessedKeys"].HasMember(table)) {
-                    // Add the table's entry in UnprocessedKeys. Need to copy
-                    // all the table's parameters from the request except the
-                    // Keys field, which we start empty and then build below.
-                    rjson::add_with_string_name(response["UnprocessedKeys"], table, rjson::empty_object());
-                    rjson::value& unprocessed_item = response["UnprocessedKeys"][table];
-                    rjson::value& request_item = request_items[table];
-                    for (auto it = request_item.MemberBegin(); it != request_item.MemberEnd(); ++it) {
-                        if (it->name != "Keys") {
-                            rjson::add_with_string_name(unprocessed_item,
-                                rjson::to_string_view(it->name), rjson::copy(it->value));
-                        }
+        try {
+            std::vector<rjson::value> results = co_await std::move(read.result);
+            some_succeeded = true;
+            if (!response["Responses"].HasMember(table)) {
+                rjson::add_with_string_name(response["Responses"], table, rjson::empty_array());
+            }
+            for (rjson::value& json : results) {
+                rjson::push_back(response["Responses"][table], std::move(json));
+            }
+        } catch(...) {
+            eptr = std::current_exception();
+            // This read of potentially several rows in one or more
+            // partitions failed. We need to add the row key(s) to
+            // UnprocessedKeys.
+            if (!response["UnprocessedKeys"].HasMember(table)) {
+                // Add the table's entry in UnprocessedKeys. Need to copy
+                // all the table's parameters from the request except the
+                // Keys field, which we start empty and then build below.
+                rjson::add_with_string_name(response["UnprocessedKeys"], table, rjson::empty_object());
+                rjson::value& unprocessed_item = response["UnprocessedKeys"][table];
+                rjson::value& request_item = request_items[table];
+                for (auto it = request_item.MemberBegin(); it != request_item.MemberEnd(); ++it) {
+                    if (it->name != "Keys") {
+                        rjson::add_with_string_name(unprocessed_item,
+                            rjson::to_string_view(it->name), rjson::copy(it->value));
                     }
-                    rjson::add_with_string_name(unprocessed_item, "Keys", rjson::empty_array());
                 }
-                for (auto& ck : cks) {
+                rjson::add_with_string_name(unprocessed_item, "Keys", rjson::empty_array());
+            }
+            for (auto cks : read.keys) {
+                for (auto& ck : *cks) {
                     rjson::push_back(response["UnprocessedKeys"][table]["Keys"], std::move(*ck.second));
                 }
             }
@@ -3318,11 +3361,7 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
     if (!some_succeeded && eptr) {
         co_await coroutine::return_exception_ptr(std::move(eptr));
     }
-    if (is_big(response)) {
-        co_return make_streamed(std::move(response));
-    } else {
-        co_return make_jsonable(std::move(response));
-    }
+    co_return make_response(std::move(response));
 }
 
 // "filter" represents a condition that can be applied to individual items
@@ -3512,12 +3551,8 @@ class describe_items_visitor {
                     rjson::add_with_string_name(field, type_to_string((*_column_it)->type), json_key_column_value(bv, **_column_it));
                 }
             } else {
-                auto deserialized = attrs_type()->deserialize(bv);
-                auto keys_and_values = value_cast<map_type_impl::native_type>(deserialized);
-                for (auto entry : keys_and_values) {
-                    std::string attr_name = value_cast<sstring>(entry.first);
+                for_each_serialized_attribute(bv, [&] (std::string attr_name, bytes_view value) {
                     if (!_attrs_to_get || _attrs_to_get->contains(attr_name) || _extra_filter_attrs.contains(attr_name)) {
-                        bytes value = value_cast<bytes>(entry.second);
                         // Even if _attrs_to_get asked to keep only a part of a
                         // top-level attribute, we keep the entire attribute
                         // at this stage, because the item filter might still
@@ -3526,7 +3561,7 @@ class describe_items_visitor {
                         // filter the unneeded parts after item filtering.
                         rjson::add_with_string_name(_item, attr_name, deserialize_item(value));
                     }
-                }
+                });
             }
         });
         ++_column_it;
@@ -3692,10 +3727,7 @@ static future<executor::request_return_type> do_query(service::storage_proxy& pr
             // update our "filtered_row_matched_total" for all the rows matched, despited the filter
             cql_stats.filtered_rows_matched_total += size;
         }
-        if (is_big(items)) {
-            return make_ready_future<executor::request_return_type>(make_streamed(std::move(items)));
-        }
-        return make_ready_future<executor::request_return_type>(make_jsonable(std::move(items)));
+        return make_ready_future<executor::request_return_type>(make_response(std::move(items)));
     });
 }
 
@@ -70,6 +70,14 @@ struct make_jsonable : public json::jsonable {
  */ 
 json::json_return_type make_streamed(rjson::value&&);
 
+/**
+ * Make return type for a response which may hold a lot of items or
+ * large items: streamed if it is_big(), so that it isn't printed into
+ * a contiguous string and copied again into the reply, or returned
+ * as a string otherwise.
+ */
+json::json_return_type make_response(rjson::value&&);
+
 struct json_string : public json::jsonable {
     std::string _value;
 public:
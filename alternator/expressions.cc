@@ -24,6 +24,7 @@
 #include <boost/algorithm/cxx11/all_of.hpp>
 
 #include <functional>
+#include <list>
 #include <unordered_map>
 
 namespace alternator {
@@ -43,31 +44,76 @@ Result do_with_parser(std::string_view input, Func&& f) {
     return result;
 }
 
+// Clients typically send the same few expressions over and over, with
+// different ExpressionAttributeValues, so each shard keeps the most recently
+// parsed expressions of each kind, and copies them instead of running the
+// ANTLR parser again. The cached expressions are not resolved, so they don't
+// depend on the ExpressionAttributeNames and ExpressionAttributeValues of the
+// request which parsed them - resolving a copy is cheap compared to parsing.
+template <typename Expression>
+class parsed_expression_cache {
+    // Long expressions are rare, and would take a lot of the cache's memory.
+    static constexpr size_t max_cached_expression_length = 4096;
+    static constexpr size_t max_entries = 1000;
+    using lru_list = std::list<std::pair<std::string, Expression>>;
+    lru_list _lru;
+    std::unordered_map<std::string_view, typename lru_list::iterator> _index;
+public:
+    template <typename Parse>
+    Expression get(std::string_view query, Parse&& parse) {
+        if (query.size() > max_cached_expression_length) {
+            return parse(query);
+        }
+        auto it = _index.find(query);
+        if (it != _index.end()) {
+            _lru.splice(_lru.begin(), _lru, it->second);
+            return it->second->second;
+        }
+        Expression e = parse(query);
+        if (_lru.size() >= max_entries) {
+            _index.erase(_lru.back().first);
+            _lru.pop_back();
+        }
+        _lru.emplace_front(std::string(query), e);
+        _index.emplace(_lru.front().first, _lru.begin());
+        return e;
+    }
+};
+
 parsed::update_expression
 parse_update_expression(std::string_view query) {
-    try {
-        return do_with_parser(query,  std::mem_fn(&expressionsParser::update_expression));
-    } catch (...) {
-        throw expressions_syntax_error(format("Failed parsing UpdateExpression '{}': {}", query, std::current_exception()));
-    }
+    static thread_local parsed_expression_cache<parsed::update_expression> cache;
+    return cache.get(query, [] (std::string_view query) {
+        try {
+            return do_with_parser(query,  std::mem_fn(&expressionsParser::update_expression));
+        } catch (...) {
+            throw expressions_syntax_error(format("Failed parsing UpdateExpression '{}': {}", query, std::current_exception()));
+        }
+    });
 }
 
 std::vector<parsed::path>
 parse_projection_expression(std::string_view query) {
-    try {
-        return do_with_parser(query,  std::mem_fn(&expressionsParser::projection_expression));
-    } catch (...) {
-        throw expressions_syntax_error(format("Failed parsing ProjectionExpression '{}': {}", query, std::current_exception()));
-    }
+    static thread_local parsed_expression_cache<std::vector<parsed::path>> cache;
+    return cache.get(query, [] (std::string_view query) {
+        try {
+            return do_with_parser(query,  std::mem_fn(&expressionsParser::projection_expression));
+        } catch (...) {
+            throw expressions_syntax_error(format("Failed parsing ProjectionExpression '{}': {}", query, std::current_exception()));
+        }
+    });
 }
 
 parsed::condition_expression
 parse_condition_expression(std::string_view query) {
-    try {
-        return do_with_parser(query,  std::mem_fn(&expressionsParser::condition_expression));
-    } catch (...) {
-        throw expressions_syntax_error(format("Failed parsing ConditionExpression '{}': {}", query, std::current_exception()));
-    }
+    static thread_local parsed_expression_cache<parsed::condition_expression> cache;
+    return cache.get(query, [] (std::string_view query) {
+        try {
+            return do_with_parser(query,  std::mem_fn(&expressionsParser::condition_expression));
+        } catch (...) {
+            throw expressions_syntax_error(format("Failed parsing ConditionExpression '{}': {}", query, std::current_exception()));
+        }
+    });
 }
 
 namespace parsed {
@@ -15,6 +15,7 @@
 #include <seastar/core/sleep.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/lowres_clock.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include <boost/multiprecision/cpp_int.hpp>
 
@@ -36,6 +37,7 @@
 #include "mutation.hh"
 #include "types.hh"
 #include "types/map.hh"
+#include "types/listlike_partial_deserializing_iterator.hh"
 #include "utils/rjson.hh"
 #include "utils/big_decimal.hh"
 #include "utils/fb_utilities.hh"
@@ -499,16 +501,36 @@ struct scan_ranges_context {
         , column_name(column_name)
         , member(member)
     {
-        // FIXME: don't read the entire items - read only parts of it.
-        // We must read the key columns (to be able to delete) and also
-        // the requested attribute. If the requested attribute is a map's
-        // member we may be forced to read the entire map - but it would
-        // be good if we can read only the single item of the map - it
-        // should be possible (and a must for issue #7751!).
+        // Don't read the entire items: we must read the key columns (to be
+        // able to delete) and the requested attribute. If the requested
+        // attribute is a map's member we are forced to read the entire map -
+        // but it would be good if we can read only the single item of the
+        // map - it should be possible (and a must for issue #7751!).
+        // If the attribute is a key column, we read all regular columns as
+        // before, so that items whose row has no row marker are still found.
         lw_shared_ptr<service::pager::paging_state> paging_state = nullptr;
-        auto regular_columns = boost::copy_range<query::column_id_vector>(
-            s->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
-        selection = cql3::selection::selection::wildcard(s);
+        const column_definition* cd = s->get_column_definition(column_name);
+        query::column_id_vector regular_columns;
+        if (cd->is_regular()) {
+            regular_columns.push_back(cd->id);
+        } else {
+            regular_columns = boost::copy_range<query::column_id_vector>(
+                s->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
+        }
+        // NOTICE: expire_item() relies on the partition key columns being
+        // first in the selection, immediately followed by the clustering
+        // key columns.
+        std::vector<const column_definition*> columns;
+        for (const column_definition& cdef : s->partition_key_columns()) {
+            columns.push_back(&cdef);
+        }
+        for (const column_definition& cdef : s->clustering_key_columns()) {
+            columns.push_back(&cdef);
+        }
+        for (auto id : regular_columns) {
+            columns.push_back(&s->regular_column_at(id));
+        }
+        selection = cql3::selection::selection::for_columns(s, std::move(columns));
         query::partition_slice::option_set opts = selection->get_query_options();
         opts.set<query::partition_slice::option::allow_short_read>();
         // It is important that the scan bypass cache to avoid polluting it:
@@ -529,6 +551,9 @@ struct scan_ranges_context {
     }
 };
 
+// The number of expired items of a page which are deleted concurrently.
+static constexpr size_t max_concurrent_expirations = 16;
+
 // Scan data in a list of token ranges in one table, looking for expired
 // items and deleting them.
 // Because of issue #9167, partition_ranges must have a single partition
@@ -591,12 +616,12 @@ static future<> scan_table_ranges(
         if (!expiration_column) {
             continue;
         }
+        std::vector<const std::vector<bytes_opt>*> expired_rows;
         for (const auto& row : rows) {
             const bytes_opt& cell = row[*expiration_column];
             if (!cell) {
                 continue;
             }
-            auto v = meta[*expiration_column]->type->deserialize(*cell);
             bool expired = false;
             // FIXME: don't recalculate "now" all the time
             auto now = gc_clock::now();
@@ -605,13 +630,16 @@ static future<> scan_table_ranges(
                 // looking for is a member in a map, saved serialized
                 // into bytes using Alternator's serialization (basically
                 // a JSON serialized into bytes)
-                // FIXME: is it possible to find a specific member of a map
-                // without iterating through it like we do here and compare
-                // the key?
-                for (const auto& entry : value_cast<map_type_impl::native_type>(v)) {
-                    std::string attr_name = value_cast<sstring>(entry.first);
-                    if (value_cast<sstring>(entry.first) == *scan_ctx.member) {
-                        bytes value = value_cast<bytes>(entry.second);
+                // The member is looked up in the serialized map, without
+                // deserializing the other members. The entries are sorted by
+                // name, but have variable lengths, so we can only skip over
+                // them one by one.
+                bytes_view in(*cell);
+                auto size = read_collection_size(in);
+                for (int i = 0; i < size; ++i) {
+                    auto name = read_collection_key(in);
+                    auto value = read_collection_value_nonnull(in);
+                    if (std::string_view(reinterpret_cast<const char*>(name.data()), name.size()) == *scan_ctx.member) {
                         rjson::value json = deserialize_item(value);
                         expired = is_expired(json, now);
                         break;
@@ -624,17 +652,23 @@ static future<> scan_table_ranges(
                 // what Alternator uses), but other numeric types can be
                 // supported as well to make this feature more useful in CQL.
                 // Note that kind::decimal is also checked above.
+                auto v = meta[*expiration_column]->type->deserialize(*cell);
                 big_decimal n = value_cast<big_decimal>(v);
                 expired = is_expired(n, now);
             }
             if (expired) {
-                expiration_stats.items_deleted++;
-                // FIXME: maybe don't recalculate new_timestamp() all the time
-                // FIXME: if expire_item() throws on timeout, we need to retry it.
-                auto ts = api::new_timestamp();
-                co_await expire_item(proxy, *scan_ctx.query_state_ptr, row, s, ts);
+                expired_rows.push_back(&row);
             }
         }
+        // Delete the expired items of the page concurrently, rather than
+        // waiting for each delete's round trip before sending the next one.
+        co_await max_concurrent_for_each(expired_rows, max_concurrent_expirations, [&] (const std::vector<bytes_opt>* row) {
+            expiration_stats.items_deleted++;
+            // FIXME: maybe don't recalculate new_timestamp() all the time
+            // FIXME: if expire_item() throws on timeout, we need to retry it.
+            auto ts = api::new_timestamp();
+            return expire_item(proxy, *scan_ctx.query_state_ptr, *row, s, ts);
+        });
         // FIXME: once in a while, persist p->state(), so on reboot
         // we don't start from scratch.
     }
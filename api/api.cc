@@ -203,6 +203,14 @@ future<> set_server_cache(http_context& ctx) {
             "The cache service API", set_cache_service);
 }
 
+future<> set_server_row_cache_saver(http_context& ctx, sharded<db::row_cache_saver>& saver) {
+    return ctx.http_server.set_routes([&ctx, &saver] (routes& r) { set_row_cache_saver(ctx, r, saver); });
+}
+
+future<> unset_server_row_cache_saver(http_context& ctx) {
+    return ctx.http_server.set_routes([&ctx] (routes& r) { unset_row_cache_saver(ctx, r); });
+}
+
 future<> set_hinted_handoff(http_context& ctx, sharded<gms::gossiper>& g) {
     return register_api(ctx, "hinted_handoff",
                 "The hinted handoff API", [&g] (http_context& ctx, routes& r) {
@@ -44,6 +44,7 @@ class thrift_controller;
 namespace db {
 class snapshot_ctl;
 class config;
+class row_cache_saver;
 namespace view {
 class view_builder;
 }
@@ -112,6 +113,8 @@ future<> set_hinted_handoff(http_context& ctx, sharded<gms::gossiper>& g);
 future<> unset_hinted_handoff(http_context& ctx);
 future<> set_server_gossip_settle(http_context& ctx, sharded<gms::gossiper>& g);
 future<> set_server_cache(http_context& ctx);
+future<> set_server_row_cache_saver(http_context& ctx, sharded<db::row_cache_saver>& saver);
+future<> unset_server_row_cache_saver(http_context& ctx);
 future<> set_server_compaction_manager(http_context& ctx);
 future<> set_server_done(http_context& ctx);
 future<> set_server_task_manager(http_context& ctx);
@@ -17,9 +17,12 @@ using namespace json;
 
 void set_authorization_cache(http_context& ctx, routes& r, sharded<auth::service> &auth_service) {
     httpd::authorization_cache_json::authorization_cache_reset.set(r, [&auth_service] (std::unique_ptr<request> req) -> future<json::json_return_type> {
-        co_await auth_service.invoke_on_all([] (auth::service& auth) -> future<>  {
+        // The other shards copy the cached permissions of shard 0.
+        co_await auth_service.invoke_on(0, [] (auth::service& auth) {
+            auth.reset_authorization_cache();
+        });
+        co_await auth_service.invoke_on_others([] (auth::service& auth) {
             auth.reset_authorization_cache();
-            return make_ready_future<>();
         });
 
         co_return json_void();
@@ -9,16 +9,16 @@
 #include "cache_service.hh"
 #include "api/api-doc/cache_service.json.hh"
 #include "column_family.hh"
+#include "db/row_cache_saver.hh"
 
 namespace api {
 using namespace json;
 namespace cs = httpd::cache_service_json;
 
 void set_cache_service(http_context& ctx, routes& r) {
-    cs::get_row_cache_save_period_in_seconds.set(r, [](std::unique_ptr<request> req) {
-        // We never save the cache
+    cs::get_row_cache_save_period_in_seconds.set(r, [&ctx](std::unique_ptr<request> req) {
         // Origin uses 0 for never
-        return make_ready_future<json::json_return_type>(0);
+        return make_ready_future<json::json_return_type>(ctx.db.local().get_config().row_cache_save_period());
     });
 
     cs::set_row_cache_save_period_in_seconds.set(r, [](std::unique_ptr<request> req) {
@@ -54,10 +54,8 @@ void set_cache_service(http_context& ctx, routes& r) {
         return make_ready_future<json::json_return_type>(json_void());
     });
 
-    cs::get_row_cache_keys_to_save.set(r, [](std::unique_ptr<request> req) {
-        // TBD
-        unimplemented();
-        return make_ready_future<json::json_return_type>(0);
+    cs::get_row_cache_keys_to_save.set(r, [&ctx](std::unique_ptr<request> req) {
+        return make_ready_future<json::json_return_type>(ctx.db.local().get_config().row_cache_keys_to_save());
     });
 
     cs::set_row_cache_keys_to_save.set(r, [](std::unique_ptr<request> req) {
@@ -126,12 +124,6 @@ void set_cache_service(http_context& ctx, routes& r) {
         return make_ready_future<json::json_return_type>(json_void());
     });
 
-    cs::save_caches.set(r, [](std::unique_ptr<request> req) {
-        // TBD
-        unimplemented();
-        return make_ready_future<json::json_return_type>(json_void());
-    });
-
     cs::get_key_capacity.set(r, [] (std::unique_ptr<request> req) {
         // TBD
         // FIXME
@@ -318,5 +310,27 @@ void set_cache_service(http_context& ctx, routes& r) {
     });
 }
 
+void set_row_cache_saver(http_context& ctx, routes& r, sharded<db::row_cache_saver>& saver) {
+    cs::save_caches.set(r, [&saver] (std::unique_ptr<request> req) -> future<json::json_return_type> {
+        co_await saver.invoke_on_all([] (db::row_cache_saver& s) {
+            return s.save();
+        });
+        co_return json_void();
+    });
+
+    cs::get_row_cache_warmup_progress.set(r, [&saver] (std::unique_ptr<request> req) -> future<json::json_return_type> {
+        cs::row_cache_warmup_progress res;
+        res.total = co_await saver.map_reduce0([] (db::row_cache_saver& s) { return s.get_stats().warmup_keys_total; }, uint64_t(0), std::plus<uint64_t>());
+        res.loaded = co_await saver.map_reduce0([] (db::row_cache_saver& s) { return s.get_stats().warmup_keys_loaded; }, uint64_t(0), std::plus<uint64_t>());
+        res.done = co_await saver.map_reduce0([] (db::row_cache_saver& s) { return s.get_stats().warmup_done; }, true, std::logical_and<bool>());
+        co_return res;
+    });
+}
+
+void unset_row_cache_saver(http_context& ctx, routes& r) {
+    cs::save_caches.unset(r);
+    cs::get_row_cache_warmup_progress.unset(r);
+}
+
 }
 
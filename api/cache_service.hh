@@ -10,8 +10,14 @@
 
 #include "api.hh"
 
+namespace db {
+class row_cache_saver;
+}
+
 namespace api {
 
 void set_cache_service(http_context& ctx, routes& r);
+void set_row_cache_saver(http_context& ctx, routes& r, sharded<db::row_cache_saver>& saver);
+void unset_row_cache_saver(http_context& ctx, routes& r);
 
 }
@@ -10,6 +10,7 @@
 #include "api/api-doc/column_family.json.hh"
 #include <vector>
 #include <seastar/http/exception.hh>
+#include <seastar/core/coroutine.hh>
 #include "sstables/sstables.hh"
 #include "sstables/metadata_collector.hh"
 #include "utils/estimated_histogram.hh"
@@ -1018,6 +1019,26 @@ void set_column_family(http_context& ctx, routes& r) {
         });
     });
 
+    cf::get_hot_partitions.set(r, [&ctx] (std::unique_ptr<request> req) -> future<json::json_return_type> {
+        auto id = get_uuid(req->param["name"], ctx.db.local());
+        api::req_param<unsigned> list_size(*req, "list_size", 10);
+        auto hot = co_await db::get_hot_partitions(ctx.db, id);
+        cf::hot_partitions_results results;
+        auto to_records = [&] (const db::toppartitions_data_listener::top_k& top, auto& records) {
+            for (auto& d : top.top(list_size.value)) {
+                cf::toppartitions_record r;
+                r.partition = sstring(d.item);
+                r.count = d.count;
+                r.error = d.error;
+                records.push(r);
+            }
+        };
+        to_records(hot.reads, results.read);
+        to_records(hot.writes, results.write);
+        to_records(hot.write_kbytes, results.write_kbytes);
+        co_return json::json_return_type(results);
+    });
+
     cf::force_major_compaction.set(r, [&ctx](std::unique_ptr<request> req) {
         if (req->get_query_param("split_output") != "") {
             fail(unimplemented::cause::API);
@@ -28,6 +28,33 @@ void set_lsa(http_context& ctx, routes& r) {
             return json::json_return_type(json::json_void());
         });
     });
+
+    httpd::lsa_json::get_reclaim_stats.set(r, [&ctx](std::unique_ptr<request> req) {
+        return ctx.db.map_reduce0([] (replica::database&) {
+            std::vector<httpd::lsa_json::reclaim_stats> res;
+            for (auto& s : logalloc::shard_tracker().reclaim_statistics()) {
+                httpd::lsa_json::reclaim_stats rs;
+                rs.shard = this_shard_id();
+                rs.operation = s.operation;
+                rs.scheduling_group = s.group.name();
+                rs.count = s.count;
+                rs.stalls = s.stalls;
+                rs.total_time = s.total_time.count();
+                rs.max_time = s.max_time.count();
+                rs.memory_released = s.memory_released;
+                rs.segments_compacted = s.segments_compacted;
+                rs.memory_compacted = s.memory_compacted;
+                rs.memory_evicted = s.memory_evicted;
+                res.push_back(std::move(rs));
+            }
+            return res;
+        }, std::vector<httpd::lsa_json::reclaim_stats>(), [] (std::vector<httpd::lsa_json::reclaim_stats> a, std::vector<httpd::lsa_json::reclaim_stats> b) {
+            std::move(b.begin(), b.end(), std::back_inserter(a));
+            return a;
+        }).then([] (std::vector<httpd::lsa_json::reclaim_stats> res) {
+            return json::json_return_type(std::move(res));
+        });
+    });
 }
 
 }
@@ -366,6 +366,56 @@ void set_storage_proxy(http_context& ctx, routes& r, sharded<service::storage_se
         });
     });
 
+    sp::get_replica_scores.set(r, [&ctx](std::unique_ptr<request> req) {
+        return ctx.sp.map_reduce0([] (const proxy& p) {
+            std::vector<sp::replica_score> res;
+            const auto& tracker = p.get_replica_latencies();
+            auto reset_interval = p.replica_latency_reset_interval();
+            for (const auto& [ep, state] : tracker.replicas()) {
+                sp::replica_score entry;
+                entry.shard = this_shard_id();
+                entry.endpoint = ep.to_sstring();
+                entry.latency = state.latency_us;
+                entry.inflight = state.inflight;
+                entry.score = tracker.score(ep, reset_interval);
+                res.emplace_back(std::move(entry));
+            }
+            return res;
+        }, std::vector<sp::replica_score>(), [] (std::vector<sp::replica_score> a, std::vector<sp::replica_score> b) {
+            std::move(b.begin(), b.end(), std::back_inserter(a));
+            return a;
+        }).then([] (std::vector<sp::replica_score> res) {
+            return make_ready_future<json::json_return_type>(std::move(res));
+        });
+    });
+
+    sp::get_write_path_profile.set(r, [&ctx](std::unique_ptr<request> req) {
+        using histograms = db::write_path_profiler::histograms;
+        return ctx.db.map_reduce0([] (replica::database& db) {
+            return db.get_write_path_profiler().get_histograms();
+        }, histograms(), [] (histograms a, const histograms& b) {
+            for (size_t i = 0; i < a.size(); ++i) {
+                a[i].merge(b[i]);
+            }
+            return a;
+        }).then([] (histograms res) {
+            std::vector<sp::write_stage_profile> stages;
+            for (size_t i = 0; i < res.size(); ++i) {
+                const auto& h = res[i];
+                sp::write_stage_profile entry;
+                entry.stage = sstring(db::to_string(db::write_stage(i)));
+                entry.count = h.count();
+                entry.mean = h.mean();
+                entry.p50 = h.percentile(0.5);
+                entry.p95 = h.percentile(0.95);
+                entry.p99 = h.percentile(0.99);
+                entry.max = h.max();
+                stages.emplace_back(std::move(entry));
+            }
+            return make_ready_future<json::json_return_type>(std::move(stages));
+        });
+    });
+
     sp::get_cas_read_timeouts.set(r, [&ctx](std::unique_ptr<request> req) {
         return sum_timed_rate_as_long(ctx.sp, &proxy::stats::cas_read_timeouts);
     });
@@ -46,6 +46,7 @@
 #include "locator/abstract_replication_strategy.hh"
 #include "sstables_loader.hh"
 #include "db/view/view_builder.hh"
+#include "tracing/trace_ring_helper.hh"
 
 extern logging::logger apilog;
 
@@ -767,6 +768,26 @@ void set_storage_service(http_context& ctx, routes& r, sharded<service::storage_
         co_return json::json_return_type(0);
     }));
 
+    ss::garbage_collect.set(r, wrap_ks_cf(ctx, [] (http_context& ctx, std::unique_ptr<request> req, sstring keyspace, std::vector<table_info> table_infos) -> future<json::json_return_type> {
+        auto& db = ctx.db;
+
+        apilog.info("garbage_collect: keyspace={} tables={}", keyspace, table_infos);
+        try {
+            co_await db.invoke_on_all([&] (replica::database& db) -> future<> {
+                co_await run_on_existing_tables("garbage_collect", db, keyspace, table_infos, [&] (replica::table& t) {
+                    return t.parallel_foreach_table_state([&] (compaction::table_state& ts) {
+                        return t.get_compaction_manager().perform_garbage_collection(ts);
+                    });
+                });
+            });
+        } catch (...) {
+            apilog.error("garbage_collect: keyspace={} tables={} failed: {}", keyspace, table_infos, std::current_exception());
+            throw;
+        }
+
+        co_return json::json_return_type(0);
+    }));
+
     ss::force_keyspace_flush.set(r, [&ctx](std::unique_ptr<request> req) -> future<json::json_return_type> {
         auto keyspace = validate_keyspace(ctx, req->param);
         auto column_families = parse_tables(keyspace, ctx, req->query_parameters, "cf");
@@ -1114,6 +1135,35 @@ void set_storage_service(http_context& ctx, routes& r, sharded<service::storage_
         }
     });
 
+    ss::get_recent_tracing_sessions.set(r, [](std::unique_ptr<request> req) -> future<json::json_return_type> {
+        std::chrono::microseconds threshold(0);
+        auto threshold_param = req->get_query_param("threshold");
+        if (threshold_param != "") {
+            try {
+                threshold = std::chrono::microseconds(std::stol(threshold_param.c_str()));
+            } catch (...) {
+                throw httpd::bad_param_exception(format("Bad threshold value: {}", threshold_param));
+            }
+        }
+        auto sessions = co_await tracing::tracing::tracing_instance().map_reduce0([threshold] (tracing::tracing& local_tracing) {
+            std::vector<sstring> ret;
+            if (!local_tracing.started()) {
+                return ret;
+            }
+            auto* ring = dynamic_cast<tracing::trace_ring_helper*>(&local_tracing.backend_helper());
+            if (ring) {
+                for (auto& s : ring->sessions(threshold)) {
+                    ret.push_back(fmt::format("{}", s));
+                }
+            }
+            return ret;
+        }, std::vector<sstring>(), [] (std::vector<sstring> a, std::vector<sstring> b) {
+            std::move(b.begin(), b.end(), std::back_inserter(a));
+            return a;
+        });
+        co_return json::json_return_type(std::move(sessions));
+    });
+
     ss::enable_auto_compaction.set(r, [&ctx](std::unique_ptr<request> req) {
         auto keyspace = validate_keyspace(ctx, req->param);
         auto tables = parse_tables(keyspace, ctx, req->query_parameters, "cf");
@@ -1446,6 +1496,20 @@ void set_snapshot(http_context& ctx, routes& r, sharded<db::snapshot_ctl>& snap_
         }
     });
 
+    ss::start_backup.set(r, [&snap_ctl] (std::unique_ptr<request> req) -> future<json::json_return_type> {
+        apilog.info("start_backup: {}", req->query_parameters);
+        auto keyspace = req->get_query_param("keyspace");
+        auto tag = req->get_query_param("snapshot");
+        auto destination = req->get_query_param("destination");
+        try {
+            auto id = co_await snap_ctl.local().start_backup(std::move(keyspace), std::move(tag), std::move(destination));
+            co_return id.to_sstring();
+        } catch (...) {
+            apilog.error("start_backup failed: {}", std::current_exception());
+            throw;
+        }
+    });
+
     ss::true_snapshots_size.set(r, [&snap_ctl](std::unique_ptr<request> req) {
         return snap_ctl.local().true_snapshots_size().then([] (int64_t size) {
             return make_ready_future<json::json_return_type>(size);
@@ -1551,6 +1615,7 @@ void unset_snapshot(http_context& ctx, routes& r) {
     ss::get_snapshot_details.unset(r);
     ss::take_snapshot.unset(r);
     ss::del_snapshot.unset(r);
+    ss::start_backup.unset(r);
     ss::true_snapshots_size.unset(r);
     ss::scrub.unset(r);
 }
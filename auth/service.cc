@@ -180,6 +180,7 @@ future<> service::stop() {
     // unregister on each one just to make sure.
     return _mnotifier.unregister_listener(_migration_listener.get()).then([this] {
         if (_permissions_cache) {
+            _permissions_cache_stopped = true;
             return _permissions_cache->stop();
         }
         return make_ready_future<>();
@@ -284,6 +285,27 @@ service::get_uncached_permissions(const role_or_anonymous& maybe_role, const res
     });
 }
 
+future<permission_set> service::load_permissions(const role_or_anonymous& maybe_role, const resource& r) {
+    if (this_shard_id() == 0) {
+        return get_uncached_permissions(maybe_role, r);
+    }
+
+    return container().invoke_on(0, [maybe_role, r] (service& s) -> future<std::optional<permission_set>> {
+        // Shard 0 stops its cache independently of the other shards.
+        if (!s._permissions_cache || s._permissions_cache_stopped) {
+            return make_ready_future<std::optional<permission_set>>();
+        }
+        return s._permissions_cache->get(maybe_role, r).then([] (permission_set perms) {
+            return std::optional<permission_set>(perms);
+        });
+    }).then([this, &maybe_role, &r] (std::optional<permission_set> perms) {
+        if (perms) {
+            return make_ready_future<permission_set>(*perms);
+        }
+        return get_uncached_permissions(maybe_role, r);
+    });
+}
+
 future<permission_set> service::get_permissions(const role_or_anonymous& maybe_role, const resource& r) const {
     return _permissions_cache->get(maybe_role, r);
 }
@@ -72,6 +72,7 @@ class incompatible_module_combination : public std::invalid_argument {
 class service final : public seastar::peering_sharded_service<service> {
     utils::loading_cache_config _loading_cache_config;
     std::unique_ptr<permissions_cache> _permissions_cache;
+    bool _permissions_cache_stopped = false;
 
     cql3::query_processor& _qp;
 
@@ -120,6 +121,10 @@ class service final : public seastar::peering_sharded_service<service> {
 
     void update_cache_config();
 
+    ///
+    /// Drops the permissions cached by this shard. Shard 0 must be reset before the others, or they may copy its old
+    /// entries back. See \ref load_permissions.
+    ///
     void reset_authorization_cache();
 
     ///
@@ -132,6 +137,15 @@ class service final : public seastar::peering_sharded_service<service> {
     ///
     future<permission_set> get_uncached_permissions(const role_or_anonymous&, const resource&) const;
 
+    ///
+    /// Loads the permissions into the cache of this shard.
+    ///
+    /// The permissions of the node are only queried by the cache of shard 0, the caches of the other shards copy them
+    /// from it. This way, when entries expire on a busy node, system_auth is queried once for each entry and not once on
+    /// every shard. A copied entry may be older than the cache update interval, but by less than twice that.
+    ///
+    future<permission_set> load_permissions(const role_or_anonymous&, const resource&);
+
     ///
     /// Query whether the named role has been granted a role that is a superuser.
     ///
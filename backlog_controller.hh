@@ -11,6 +11,7 @@
 #include <seastar/core/timer.hh>
 #include <seastar/core/gate.hh>
 #include <seastar/core/file.hh>
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 
@@ -130,11 +131,32 @@ class compaction_controller : public backlog_controller {
     static constexpr unsigned normalization_factor = 30;
     static constexpr float disable_backlog = std::numeric_limits<double>::infinity();
     static constexpr float backlog_disabled(float backlog) { return std::isinf(backlog); }
-    compaction_controller(backlog_controller::scheduling_group sg, float static_shares, std::chrono::milliseconds interval, std::function<float()> current_backlog)
+private:
+    // Returns by how much the latency of foreground reads exceeds its target,
+    // as the ratio of the two, or 1 (or less) when it doesn't.
+    std::function<float()> _foreground_latency_overshoot;
+protected:
+    // The shares picked after the backlog are divided by the overshoot of the
+    // foreground read latency, so that compaction backs off, for both cpu and
+    // I/O, while it slows reads down. They are never trimmed below the shares
+    // of an empty backlog, so that compaction still makes progress.
+    virtual void update_controller(float shares) override {
+        if (!controller_disabled() && _foreground_latency_overshoot) {
+            auto overshoot = _foreground_latency_overshoot();
+            if (overshoot > 1.0f) {
+                shares = std::max(_control_points.front().output, shares / overshoot);
+            }
+        }
+        backlog_controller::update_controller(shares);
+    }
+public:
+    compaction_controller(backlog_controller::scheduling_group sg, float static_shares, std::chrono::milliseconds interval, std::function<float()> current_backlog,
+            std::function<float()> foreground_latency_overshoot = {})
         : backlog_controller(std::move(sg), std::move(interval),
           std::vector<backlog_controller::control_point>({{0.0, 50}, {1.5, 100} , {normalization_factor, 1000}}),
           std::move(current_backlog),
           static_shares
         )
+        , _foreground_latency_overshoot(std::move(foreground_latency_overshoot))
     {}
 };
@@ -461,7 +461,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
                                 auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e), cmp);
                                 if (insert_result.second) {
                                     auto it = insert_result.first;
-                                    _snp->tracker()->insert(*it);
+                                    _snp->tracker()->insert(*it, table_schema());
                                     auto next = std::next(it);
                                     // Also works in reverse read mode.
                                     // It preserves the continuity of the range the entry falls into.
@@ -477,7 +477,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
                                 auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e), cmp);
                                 if (insert_result.second) {
                                     clogger.trace("csm {}: inserted dummy at {}", fmt::ptr(this), _upper_bound);
-                                    _snp->tracker()->insert(*insert_result.first);
+                                    _snp->tracker()->insert(*insert_result.first, table_schema());
                                 }
                                 if (_read_context.is_reversed()) [[unlikely]] {
                                     clogger.trace("csm {}: set_continuous({})", fmt::ptr(this), _last_row.position());
@@ -526,7 +526,7 @@ bool cache_flat_mutation_reader::ensure_population_lower_bound() {
             if (insert_result.second) {
                 auto it = insert_result.first;
                 clogger.trace("csm {}: inserted lower bound dummy at {}", fmt::ptr(this), it->position());
-                _snp->tracker()->insert(*it);
+                _snp->tracker()->insert(*it, table_schema());
             }
             _last_row.set_latest(insert_result.first);
         });
@@ -595,7 +595,7 @@ void cache_flat_mutation_reader::maybe_add_to_cache(const clustering_row& cr) {
         auto insert_result = mp.mutable_clustered_rows().insert_before_hint(it, std::move(new_entry), cmp);
         it = insert_result.first;
         if (insert_result.second) {
-            _snp->tracker()->insert(*it);
+            _snp->tracker()->insert(*it, table_schema());
         }
 
         rows_entry& e = *it;
@@ -705,7 +705,7 @@ void cache_flat_mutation_reader::move_to_range(query::clustering_row_ranges::con
                 });
                 auto it = insert_result.first;
                 if (insert_result.second) {
-                    _snp->tracker()->insert(*it);
+                    _snp->tracker()->insert(*it, table_schema());
                 }
                 _last_row = partition_snapshot_row_weakref(*_snp, it, true);
             } else {
@@ -729,12 +729,19 @@ void cache_flat_mutation_reader::maybe_drop_last_entry() noexcept {
     // Eviction can happen only from oldest versions to preserve the continuity non-overlapping rule
     // (See docs/dev/row_cache.md)
     //
+    // In reverse mode, _last_row is the successor of _next_row in table order, so the range on
+    // the other side of it is the one up to its own successor, whose continuity is on that successor.
+    // The last entry has no successor, and is never dropped.
+    auto continuous_after_last_row = [&] {
+        auto next = std::next(_last_row.iterator());
+        return next && next->continuous();
+    };
     if (_last_row
-            && !_read_context.is_reversed() // FIXME
             && _last_row->dummy()
             && _last_row->continuous()
             && _snp->at_latest_version()
-            && _snp->at_oldest_version()) {
+            && _snp->at_oldest_version()
+            && (!_read_context.is_reversed() || continuous_after_last_row())) {
 
         with_allocator(_snp->region().allocator(), [&] {
             cache_tracker& tracker = _read_context.cache()._tracker;
@@ -12,12 +12,16 @@
 #include "exceptions/exceptions.hh"
 #include "utils/rjson.hh"
 
-caching_options::caching_options(sstring k, sstring r, bool enabled)
-        : _key_cache(k), _row_cache(r), _enabled(enabled) {
+caching_options::caching_options(sstring k, sstring r, bool enabled, unsigned eviction_priority)
+        : _key_cache(k), _row_cache(r), _enabled(enabled), _eviction_priority(eviction_priority) {
     if ((k != "ALL") && (k != "NONE")) {
         throw exceptions::configuration_exception("Invalid key value: " + k); 
     }
 
+    if (eviction_priority > max_eviction_priority) {
+        throw exceptions::configuration_exception(format("Invalid eviction_priority value: {}, must be between 0 and {}", eviction_priority, max_eviction_priority));
+    }
+
     if ((r == "ALL") || (r == "NONE")) {
         return;
     } else {
@@ -40,6 +44,9 @@ caching_options::to_map() const {
     if (!_enabled) {
         res.insert({"enabled", "false"});
     }
+    if (_eviction_priority) {
+        res.insert({"eviction_priority", std::to_string(_eviction_priority)});
+    }
     return res;
 }
 
@@ -58,6 +65,7 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
     sstring k = default_key;
     sstring r = default_row;
     bool e = true;
+    unsigned prio = 0;
 
     for (auto& p : map) {
         if (p.first == "keys") {
@@ -66,11 +74,17 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
             r = p.second;
         } else if (p.first == "enabled") {
             e = p.second == "true";
+        } else if (p.first == "eviction_priority") {
+            try {
+                prio = boost::lexical_cast<unsigned>(p.second);
+            } catch (boost::bad_lexical_cast&) {
+                throw exceptions::configuration_exception("Invalid eviction_priority value: " + p.second);
+            }
         } else {
             throw exceptions::configuration_exception(format("Invalid caching option: {}", p.first));
         }
     }
-    return caching_options(k, r, e);
+    return caching_options(k, r, e, prio);
 }
 
 caching_options
@@ -81,7 +95,7 @@ caching_options::from_sstring(const sstring& str) {
 bool
 caching_options::operator==(const caching_options& other) const {
     return _key_cache == other._key_cache && _row_cache == other._row_cache
-        && _enabled == other._enabled;
+        && _enabled == other._enabled && _eviction_priority == other._eviction_priority;
 }
 
 bool
@@ -25,15 +25,24 @@ class caching_options {
     sstring _key_cache;
     sstring _row_cache;
     bool _enabled = true;
-    caching_options(sstring k, sstring r, bool enabled);
+    // Rows of tables with a higher priority survive more eviction attempts.
+    // See rows_entry::spare_from_eviction().
+    unsigned _eviction_priority = 0;
+    caching_options(sstring k, sstring r, bool enabled, unsigned eviction_priority = 0);
 
     friend class schema;
     caching_options();
 public:
+    static constexpr unsigned max_eviction_priority = 3;
+
     bool enabled() const {
         return _enabled;
     }
 
+    unsigned eviction_priority() const {
+        return _eviction_priority;
+    }
+
     std::map<sstring, sstring> to_map() const;
 
     sstring to_sstring() const;
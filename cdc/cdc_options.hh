@@ -42,6 +42,9 @@ class options final {
     bool _postimage = false;
     delta_mode _delta_mode = delta_mode::full;
     int _ttl = 86400; // 24h in seconds
+    // The table is written by inserts of rows which don't exist yet, so the
+    // images of inserts are generated without reading the rows first.
+    bool _blind_inserts = false;
 public:
     options() = default;
     options(const std::map<sstring, sstring>& map);
@@ -57,12 +60,14 @@ class options final {
     delta_mode get_delta_mode() const { return _delta_mode; }
     void set_delta_mode(delta_mode m) { _delta_mode = m; }
     int ttl() const { return _ttl; }
+    bool blind_inserts() const { return _blind_inserts; }
 
     void enabled(bool b) { _enabled = b; }
     void preimage(bool b) { preimage(b ? image_mode::on : image_mode::off); }
     void preimage(image_mode m) { _preimage = m; }
     void postimage(bool b) { _postimage = b; }
     void ttl(int v) { _ttl = v; }
+    void blind_inserts(bool b) { _blind_inserts = b; }
 
     bool operator==(const options& o) const;
     bool operator!=(const options& o) const;
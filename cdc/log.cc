@@ -116,6 +116,10 @@ cdc::stats::stats() {
     };
     register_counters(counters_total, "total");
     register_counters(counters_failed, "failed");
+    _metrics.add_group(cdc_group_name, {
+            sm::make_total_operations("preimage_selects_skipped", preimage_selects_skipped,
+                    sm::description("number of preimage queries not performed for inserts into tables with blind inserts"))
+        });
 }
 
 cdc::operation_result_tracker::~operation_result_tracker() {
@@ -367,6 +371,12 @@ cdc::options::options(const std::map<sstring, sstring>& map) {
             if (_ttl < 0) {
                 throw exceptions::configuration_exception("Invalid CDC option: ttl must be >= 0");
             }
+        } else if (key == "blind_inserts") {
+            if (is_true || is_false) {
+                _blind_inserts = is_true;
+            } else {
+                throw exceptions::configuration_exception("Invalid value for CDC option \"blind_inserts\": " + p.second);
+            }
         } else {
             throw exceptions::configuration_exception("Invalid CDC option: " + p.first);
         }
@@ -378,13 +388,19 @@ std::map<sstring, sstring> cdc::options::to_map() const {
         return {};
     }
 
-    return {
+    std::map<sstring, sstring> res = {
         { "enabled", enabled() ? "true" : "false" },
         { "preimage", to_string(_preimage) },
         { "postimage", _postimage ? "true" : "false" },
         { "delta", to_string(_delta_mode) },
         { "ttl", std::to_string(_ttl) },
     };
+    // Only set when enabled, so that the schema stays readable by nodes
+    // which don't know the option.
+    if (_blind_inserts) {
+        res.emplace("blind_inserts", "true");
+    }
+    return res;
 }
 
 sstring cdc::options::to_sstring() const {
@@ -393,7 +409,7 @@ sstring cdc::options::to_sstring() const {
 
 bool cdc::options::operator==(const options& o) const {
     return enabled() == o.enabled() && _preimage == o._preimage && _postimage == o._postimage && _ttl == o._ttl
-            && _delta_mode == o._delta_mode;
+            && _delta_mode == o._delta_mode && _blind_inserts == o._blind_inserts;
 }
 bool cdc::options::operator!=(const options& o) const {
     return !(*this == o);
@@ -1754,6 +1770,41 @@ class transformer final : public change_processor {
     }
 };
 
+// Whether m only inserts whole rows, so that in a table with blind inserts
+// the rows are known not to exist before it. Static rows and deletions may
+// change existing data, whatever the workload, so they are read.
+static bool is_blind_insert(const mutation& m) {
+    auto& p = m.partition();
+    if (!m.schema()->cdc_options().blind_inserts() || p.partition_tombstone() || !p.static_row().empty() || !p.row_tombstones().empty()) {
+        return false;
+    }
+    return std::all_of(p.clustered_rows().begin(), p.clustered_rows().end(), [] (const rows_entry& re) {
+        return !re.row().deleted_at() && re.row().marker().is_live();
+    });
+}
+
+// Merges the log mutations, starting at first_log_mutation, which go to the
+// same partition of the same log, that is to the same stream. The base
+// mutations of a batch then add a single mutation per stream to the write.
+static void coalesce_log_mutations(std::vector<mutation>& mutations, size_t first_log_mutation) {
+    auto first = mutations.begin() + first_log_mutation;
+    auto end = first;
+    for (auto it = first; it != mutations.end(); ++it) {
+        auto same = std::find_if(first, end, [&] (const mutation& m) {
+            return m.schema()->version() == it->schema()->version() && m.decorated_key().equal(*m.schema(), it->decorated_key());
+        });
+        if (same != end) {
+            same->apply(std::move(*it));
+        } else {
+            if (it != end) {
+                *end = std::move(*it);
+            }
+            ++end;
+        }
+    }
+    mutations.erase(end, mutations.end());
+}
+
 template <typename Func>
 future<std::vector<mutation>>
 transform_mutations(std::vector<mutation>& muts, decltype(muts.size()) batch_size, Func&& f) {
@@ -1778,10 +1829,11 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
     }
 
     tracing::trace(tr_state, "CDC: Started generating mutations for log rows");
+    const size_t base_mutations = mutations.size();
     mutations.reserve(2 * mutations.size());
 
     return do_with(std::move(mutations), service::query_state(service::client_state::for_internal_calls(), empty_service_permit()), operation_details{},
-            [this, timeout, i, tr_state = std::move(tr_state), write_cl] (std::vector<mutation>& mutations, service::query_state& qs, operation_details& details) {
+            [this, timeout, i, tr_state = std::move(tr_state), write_cl, base_mutations] (std::vector<mutation>& mutations, service::query_state& qs, operation_details& details) {
         return transform_mutations(mutations, 1, [this, &mutations, timeout, &qs, tr_state = tr_state, &details, write_cl] (int idx) mutable {
             auto& m = mutations[idx];
             auto s = m.schema();
@@ -1793,7 +1845,10 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
             transformer trans(_ctxt, s, m.decorated_key());
 
             auto f = make_ready_future<lw_shared_ptr<cql3::untyped_result_set>>(nullptr);
-            if (s->cdc_options().preimage() || s->cdc_options().postimage()) {
+            if ((s->cdc_options().preimage() || s->cdc_options().postimage()) && is_blind_insert(m)) {
+                tracing::trace(tr_state, "CDC: The table has blind inserts, not querying current value of {}", m.decorated_key());
+                _ctxt._proxy.get_cdc_stats().preimage_selects_skipped++;
+            } else if (s->cdc_options().preimage() || s->cdc_options().postimage()) {
                 // Note: further improvement here would be to coalesce the pre-image selects into one
                 // iff a batch contains several modifications to the same table. Otoh, batch is rare(?)
                 // so this is premature.
@@ -1841,7 +1896,8 @@ cdc::cdc_service::impl::augment_mutation_call(lowres_clock::time_point timeout,
                 tracing::trace(tr_state, "CDC: Generated {} log mutations from {}", generated_count, mutations[idx].decorated_key());
                 details.touched_parts.add(touched_parts);
             });
-        }).then([this, tr_state, &details](std::vector<mutation> mutations) {
+        }).then([this, tr_state, &details, base_mutations](std::vector<mutation> mutations) {
+            coalesce_log_mutations(mutations, base_mutations);
             tracing::trace(tr_state, "CDC: Finished generating all log mutations");
             auto tracker = make_lw_shared<cdc::operation_result_tracker>(_ctxt._proxy.get_cdc_stats(), details);
             return make_ready_future<std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>>(std::make_tuple(std::move(mutations), std::move(tracker)));
@@ -72,6 +72,8 @@ class stats final {
 
     counters counters_total;
     counters counters_failed;
+    // Preimage queries not performed for the inserts into tables with blind inserts.
+    uint64_t preimage_selects_skipped = 0;
 
     stats();
 };
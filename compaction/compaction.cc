@@ -52,6 +52,8 @@
 #include "utils/fmt-compat.hh"
 #include "utils/error_injection.hh"
 #include "readers/filtering.hh"
+#include "readers/multi_range.hh"
+#include "readers/mutation_source.hh"
 #include "readers/compacting.hh"
 #include "tombstone_gc.hh"
 #include "keys.hh"
@@ -1047,23 +1049,28 @@ class regular_compaction : public compaction {
     mutable compaction_read_monitor_generator _monitor_generator;
     seastar::semaphore _replacer_lock = {1};
 public:
-    regular_compaction(table_state& table_s, compaction_descriptor descriptor, compaction_data& cdata)
-        : compaction(table_s, std::move(descriptor), cdata)
-        , _monitor_generator(_table_s)
-    {
-    }
-
-    flat_mutation_reader_v2 make_sstable_reader() const override {
+protected:
+    flat_mutation_reader_v2 make_sstable_reader(const dht::partition_range& pr, ::mutation_reader::forwarding fwd_mr) const {
         return _compacting->make_local_shard_sstable_reader(_schema,
                 _permit,
-                query::full_partition_range,
+                pr,
                 _schema->full_slice(),
                 _io_priority,
                 tracing::trace_state_ptr(),
                 ::streamed_mutation::forwarding::no,
-                ::mutation_reader::forwarding::no,
+                fwd_mr,
                 _monitor_generator);
     }
+public:
+    regular_compaction(table_state& table_s, compaction_descriptor descriptor, compaction_data& cdata)
+        : compaction(table_s, std::move(descriptor), cdata)
+        , _monitor_generator(_table_s)
+    {
+    }
+
+    flat_mutation_reader_v2 make_sstable_reader() const override {
+        return make_sstable_reader(query::full_partition_range, ::mutation_reader::forwarding::no);
+    }
 
     std::string_view report_start_desc() const override {
         return "Compacting";
@@ -1213,8 +1220,39 @@ class cleanup_compaction final : public regular_compaction {
     cleanup_compaction(table_state& table_s, compaction_descriptor descriptor, compaction_data& cdata, compaction_type_options::upgrade opts)
         : cleanup_compaction(table_s, std::move(descriptor), cdata, std::move(opts.owned_ranges)) {}
 
+    // Only the owned ranges which the input sstables span are read, so the
+    // sstable readers skip the data of the other ranges using the index,
+    // instead of reading and filtering it out. Sstables which have no data
+    // in any owned range are then only dropped.
     flat_mutation_reader_v2 make_sstable_reader() const override {
-        return make_filtering_reader(regular_compaction::make_sstable_reader(), make_partition_filter());
+        auto ssts = _compacting->all();
+        if (ssts->empty()) {
+            return regular_compaction::make_sstable_reader();
+        }
+        auto first = (*ssts->begin())->get_first_decorated_key().token();
+        auto last = (*ssts->begin())->get_last_decorated_key().token();
+        for (auto& sst : *ssts) {
+            first = std::min(first, sst->get_first_decorated_key().token());
+            last = std::max(last, sst->get_last_decorated_key().token());
+        }
+        auto span = dht::token_range::make(first, last);
+
+        auto source = mutation_source([this] (schema_ptr, reader_permit, const dht::partition_range& pr, const query::partition_slice&,
+                const io_priority_class&, tracing::trace_state_ptr, streamed_mutation::forwarding, mutation_reader::forwarding fwd_mr) {
+            return regular_compaction::make_sstable_reader(pr, fwd_mr);
+        });
+        auto ranges = [owned_ranges = _owned_ranges, it = _owned_ranges->begin(), span = std::move(span)] () mutable -> std::optional<dht::partition_range> {
+            auto cmp = dht::token_comparator();
+            while (it != owned_ranges->end() && it->before(span.start()->value(), cmp)) {
+                ++it;
+            }
+            if (it == owned_ranges->end() || it->after(span.end()->value(), cmp)) {
+                return std::nullopt;
+            }
+            return dht::to_partition_range(*it++);
+        };
+        return make_filtering_reader(make_flat_multi_range_reader(_schema, _permit, std::move(source), std::move(ranges),
+                _schema->full_slice(), _io_priority), make_partition_filter());
     }
 
     std::string_view report_start_desc() const override {
@@ -527,8 +527,9 @@ std::ostream& operator<<(std::ostream& os, const compaction_manager::task& task)
     return os << task.describe();
 }
 
-inline compaction_controller make_compaction_controller(const compaction_manager::scheduling_group& csg, uint64_t static_shares, std::function<double()> fn) {
-    return compaction_controller(csg, static_shares, 250ms, std::move(fn));
+inline compaction_controller make_compaction_controller(const compaction_manager::scheduling_group& csg, uint64_t static_shares, std::function<double()> fn,
+        std::function<float()> foreground_latency_overshoot = {}) {
+    return compaction_controller(csg, static_shares, 250ms, std::move(fn), std::move(foreground_latency_overshoot));
 }
 
 compaction_manager::compaction_state::~compaction_state() {
@@ -658,7 +659,7 @@ compaction_manager::compaction_manager(config cfg, abort_source& as)
             return compaction_controller::normalization_factor;
         }
         return b;
-    }))
+    }, [this] { return foreground_latency_overshoot(); }))
     , _backlog_manager(_compaction_controller)
     , _early_abort_subscription(as.subscribe([this] () noexcept {
         do_stop();
@@ -730,6 +731,8 @@ void compaction_manager::register_metrics() {
                        sm::description("Holds the sum of compaction backlog for all tables in the system.")),
         sm::make_gauge("normalized_backlog", [this] { return _last_backlog / available_memory(); },
                        sm::description("Holds the sum of normalized compaction backlog for all tables in the system. Backlog is normalized by dividing backlog by shard's available memory.")),
+        sm::make_gauge("foreground_read_latency", [this] { return _last_foreground_read_latency; },
+                       sm::description("Holds the average latency of foreground disk reads, in microseconds, the compaction controller was last fed back with.")),
         sm::make_counter("validation_errors", [this] { return _validation_errors; },
                        sm::description("Holds the number of encountered validation errors.")),
     });
@@ -1125,7 +1128,8 @@ class compaction_manager::offstrategy_compaction_task : public compaction_manage
 
         auto get_next_job = [&] () -> std::optional<sstables::compaction_descriptor> {
             auto& iop = service::get_local_streaming_priority(); // run reshape in maintenance mode
-            auto desc = t.get_compaction_strategy().get_reshaping_job(reshape_candidates, t.schema(), iop, sstables::reshape_mode::strict);
+            auto desc = t.get_compaction_strategy().get_reshaping_job(reshape_candidates, t.schema(), iop, sstables::reshape_mode::strict,
+                    _cm.offstrategy_max_fan_in());
             return desc.sstables.size() ? std::make_optional(std::move(desc)) : std::nullopt;
         };
 
@@ -1555,6 +1559,24 @@ future<> compaction_manager::perform_sstable_upgrade(owned_ranges_ptr sorted_own
     return rewrite_sstables(t, sstables::compaction_type_options::make_upgrade(std::move(sorted_owned_ranges)), std::move(get_sstables)).discard_result();
 }
 
+future<> compaction_manager::perform_garbage_collection(compaction::table_state& t) {
+    auto get_sstables = [this, &t] {
+        std::vector<sstables::shared_sstable> tables;
+
+        auto compaction_time = gc_clock::now();
+        for (auto& sst : get_candidates(t)) {
+            auto gc_before = sst->get_gc_before_for_drop_estimation(compaction_time, t.get_tombstone_gc_state());
+            if (sst->estimate_droppable_tombstone_ratio(gc_before) > 0) {
+                tables.emplace_back(sst);
+            }
+        }
+
+        return make_ready_future<std::vector<sstables::shared_sstable>>(tables);
+    };
+
+    return rewrite_sstables(t, sstables::compaction_type_options::make_regular(), std::move(get_sstables), can_purge_tombstones::yes).discard_result();
+}
+
 // Submit a table to be scrubbed and wait for its termination.
 future<compaction_manager::compaction_stats_opt> compaction_manager::perform_sstable_scrub(compaction::table_state& t, sstables::compaction_type_options::scrub opts) {
     auto scrub_mode = opts.operation_mode;
@@ -1709,6 +1731,27 @@ void compaction_manager::unplug_system_keyspace() noexcept {
     _sys_ks = nullptr;
 }
 
+void compaction_manager::plug_foreground_read_latency(std::function<float()> latency) noexcept {
+    _foreground_read_latency = std::move(latency);
+}
+
+void compaction_manager::unplug_foreground_read_latency() noexcept {
+    _foreground_read_latency = nullptr;
+    _last_foreground_read_latency = 0.0f;
+}
+
+float compaction_manager::foreground_latency_overshoot() {
+    if (!_foreground_read_latency) {
+        return 1.0f;
+    }
+    _last_foreground_read_latency = _foreground_read_latency();
+    auto target = foreground_read_latency_target_us();
+    if (!target) {
+        return 1.0f;
+    }
+    return _last_foreground_read_latency / target;
+}
+
 double compaction_backlog_tracker::backlog() const {
     return disabled() ? compaction_controller::disable_backlog : _impl->backlog(_ongoing_writes, _ongoing_compactions);
 }
@@ -47,6 +47,8 @@ class compacting_sstable_registration;
 class repair_history_map {
 public:
     boost::icl::interval_map<dht::token, gc_clock::time_point, boost::icl::partial_absorber, std::less, boost::icl::inplace_max> map;
+    // The index of map, built on first use after map changes.
+    repair_history_index_ptr index;
 };
 
 // Compaction manager provides facilities to submit and track compaction jobs on
@@ -67,6 +69,12 @@ class compaction_manager {
         size_t available_memory = 0;
         utils::updateable_value<float> static_shares = utils::updateable_value<float>(0);
         utils::updateable_value<uint32_t> throughput_mb_per_sec = utils::updateable_value<uint32_t>(0);
+        // Compaction shares are trimmed while the latency of foreground disk reads
+        // exceeds this target. 0 disables the feedback.
+        utils::updateable_value<uint32_t> foreground_read_latency_target_us = utils::updateable_value<uint32_t>(0);
+        // Maximum number of sstables merged at once by off-strategy compaction.
+        // 0 means that the max_threshold of the table is used.
+        utils::updateable_value<uint32_t> offstrategy_max_fan_in = utils::updateable_value<uint32_t>(0);
     };
 private:
     struct compaction_state {
@@ -293,6 +301,11 @@ class compaction_manager {
 
     seastar::shared_ptr<db::system_keyspace> _sys_ks;
 
+    // Returns the average latency of foreground disk reads, in microseconds,
+    // since it was last called.
+    std::function<float()> _foreground_read_latency;
+    float _last_foreground_read_latency = 0.0f;
+
     std::function<void()> compaction_submission_callback();
     // all registered tables are reevaluated at a constant interval.
     // Submission is a NO-OP when there's nothing to do, so it's fine to call it regularly.
@@ -406,6 +419,16 @@ class compaction_manager {
         return _cfg.throughput_mb_per_sec.get();
     }
 
+    uint32_t foreground_read_latency_target_us() const noexcept {
+        return _cfg.foreground_read_latency_target_us.get();
+    }
+
+    float foreground_latency_overshoot();
+
+    uint32_t offstrategy_max_fan_in() const noexcept {
+        return _cfg.offstrategy_max_fan_in.get();
+    }
+
     void register_metrics();
 
     // enable the compaction manager.
@@ -441,15 +464,33 @@ class compaction_manager {
     // Cleanup is about discarding keys that are no longer relevant for a
     // given sstable, e.g. after node loses part of its token range because
     // of a newly added node.
+    //
+    // Cleanup and upgrade compose without reading an sstable twice. Cleanup
+    // writes the latest format, so its output isn't upgraded again. Upgrade
+    // discards the keys outside of sorted_owned_ranges, so its output needs no
+    // cleanup. Both register their input as compacting upfront, so concurrent
+    // jobs, regular ones included, leave it alone until it has been rewritten.
     future<> perform_cleanup(owned_ranges_ptr sorted_owned_ranges, compaction::table_state& t);
 
     // Submit a table to be upgraded and wait for its termination.
     future<> perform_sstable_upgrade(owned_ranges_ptr sorted_owned_ranges, compaction::table_state& t, bool exclude_current_version);
 
+    // Submit a table to be garbage collected and wait for its termination.
+    // Only the sstables which hold tombstones that can be purged are rewritten,
+    // one at a time, so that tombstone GC doesn't rewrite data having no
+    // garbage, as a major compaction would.
+    future<> perform_garbage_collection(compaction::table_state& t);
+
     // Submit a table to be scrubbed and wait for its termination.
     future<compaction_stats_opt> perform_sstable_scrub(compaction::table_state& t, sstables::compaction_type_options::scrub opts);
 
     // Submit a table for major compaction.
+    //
+    // All the sstables of the table are compacted by a single compaction,
+    // whose output is a single run. Splitting it into concurrent compactions
+    // of token sub-ranges wouldn't make it faster, as they would all run on
+    // the same reactor and merging is CPU bound; the I/O of a compaction is
+    // already overlapped with the merge by read-ahead and write-behind.
     future<> perform_major_compaction(compaction::table_state& t);
 
 
@@ -493,6 +534,11 @@ class compaction_manager {
     void plug_system_keyspace(db::system_keyspace& sys_ks) noexcept;
     void unplug_system_keyspace() noexcept;
 
+    // Plugs the source of the foreground read latency the compaction controller
+    // is fed back with, see config::foreground_read_latency_target_us.
+    void plug_foreground_read_latency(std::function<float()> latency) noexcept;
+    void unplug_foreground_read_latency() noexcept;
+
     // Adds a table to the compaction manager.
     // Creates a compaction_state structure that can be used for submitting
     // compaction jobs of all types.
@@ -26,6 +26,7 @@
 #include "date_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
 #include "backlog_controller.hh"
 #include "compaction_backlog_manager.hh"
 #include "size_tiered_backlog_tracker.hh"
@@ -65,6 +66,27 @@ bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& s
     return sst->estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
 }
 
+shared_sstable compaction_strategy_impl::get_urgent_tombstone_compaction_candidate(table_state& table_s,
+        const std::vector<shared_sstable>& candidates, gc_clock::time_point compaction_time) {
+    if (!_urgent_tombstone_threshold || _disable_tombstone_compaction) {
+        return {};
+    }
+    shared_sstable ret;
+    float ret_ratio = *_urgent_tombstone_threshold;
+    for (auto& sst : candidates) {
+        if (db_clock::now() - _tombstone_compaction_interval < sst->data_file_write_time()) {
+            continue;
+        }
+        auto gc_before = sst->get_gc_before_for_drop_estimation(compaction_time, table_s.get_tombstone_gc_state());
+        auto ratio = sst->estimate_droppable_tombstone_ratio(gc_before);
+        if (ratio >= ret_ratio) {
+            ret = sst;
+            ret_ratio = ratio;
+        }
+    }
+    return ret;
+}
+
 uint64_t compaction_strategy_impl::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) {
     return partition_estimate;
 }
@@ -74,7 +96,7 @@ reader_consumer_v2 compaction_strategy_impl::make_interposer_consumer(const muta
 }
 
 compaction_descriptor
-compaction_strategy_impl::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
+compaction_strategy_impl::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in) {
     return compaction_descriptor();
 }
 
@@ -96,6 +118,11 @@ compaction_strategy_impl::compaction_strategy_impl(const std::map<sstring, sstri
     auto interval = property_definitions::to_long(TOMBSTONE_COMPACTION_INTERVAL_OPTION, tmp_value, DEFAULT_TOMBSTONE_COMPACTION_INTERVAL().count());
     _tombstone_compaction_interval = db_clock::duration(std::chrono::seconds(interval));
 
+    tmp_value = get_value(options, URGENT_TOMBSTONE_THRESHOLD_OPTION);
+    if (tmp_value) {
+        _urgent_tombstone_threshold = property_definitions::to_double(URGENT_TOMBSTONE_THRESHOLD_OPTION, tmp_value, 1.0);
+    }
+
     // FIXME: validate options.
 }
 
@@ -744,8 +771,8 @@ compaction_backlog_tracker compaction_strategy::make_backlog_tracker() {
 }
 
 sstables::compaction_descriptor
-compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
-    return _compaction_strategy_impl->get_reshaping_job(std::move(input), schema, iop, mode);
+compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in) {
+    return _compaction_strategy_impl->get_reshaping_job(std::move(input), schema, iop, mode, max_fan_in);
 }
 
 uint64_t compaction_strategy::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) {
@@ -779,6 +806,9 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = ::make_shared<time_window_compaction_strategy>(options);
         break;
+    case compaction_strategy_type::incremental:
+        impl = ::make_shared<incremental_compaction_strategy>(options);
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
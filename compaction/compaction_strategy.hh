@@ -75,6 +75,8 @@ class compaction_strategy {
             return "DateTieredCompactionStrategy";
         case compaction_strategy_type::time_window:
             return "TimeWindowCompactionStrategy";
+        case compaction_strategy_type::incremental:
+            return "IncrementalCompactionStrategy";
         default:
             throw std::runtime_error("Invalid Compaction Strategy");
         }
@@ -93,6 +95,8 @@ class compaction_strategy {
             return compaction_strategy_type::date_tiered;
         } else if (short_name == "TimeWindowCompactionStrategy") {
             return compaction_strategy_type::time_window;
+        } else if (short_name == "IncrementalCompactionStrategy") {
+            return compaction_strategy_type::incremental;
         } else {
             throw exceptions::configuration_exception(format("Unable to find compaction strategy class '{}'", name));
         }
@@ -124,9 +128,12 @@ class compaction_strategy {
     // is restarting and previous compactions were likely in-flight. In strict mode, we are less
     // tolerant to invariant breakages.
     //
-    // The caller should also pass a maximum number of SSTables which is the maximum amount of
-    // SSTables that can be added into a single job.
-    compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode);
+    // The caller can also pass a maximum number of SSTables which can be added into a single job,
+    // when more than the max_compaction_threshold of the schema is acceptable (e.g. when the
+    // memory for that many readers is available). Merging more SSTables at once lowers the number
+    // of rounds needed to reshape a large set, and with it the number of times its data is rewritten.
+    // The max_compaction_threshold is used when it is 0 or lower.
+    compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in = 0);
 
 };
 
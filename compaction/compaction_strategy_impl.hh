@@ -32,11 +32,15 @@ class compaction_strategy_impl {
 protected:
     const sstring TOMBSTONE_THRESHOLD_OPTION = "tombstone_threshold";
     const sstring TOMBSTONE_COMPACTION_INTERVAL_OPTION = "tombstone_compaction_interval";
+    const sstring URGENT_TOMBSTONE_THRESHOLD_OPTION = "urgent_tombstone_threshold";
 
     bool _use_clustering_key_filter = false;
     bool _disable_tombstone_compaction = false;
     float _tombstone_threshold = DEFAULT_TOMBSTONE_THRESHOLD;
     db_clock::duration _tombstone_compaction_interval = DEFAULT_TOMBSTONE_COMPACTION_INTERVAL();
+    // Droppable tombstone ratio above which an sstable is compacted on its own
+    // ahead of regular compactions. Disabled if not set.
+    std::optional<float> _urgent_tombstone_threshold;
 public:
     static std::optional<sstring> get_value(const std::map<sstring, sstring>& options, const sstring& name);
 protected:
@@ -68,6 +72,13 @@ class compaction_strategy_impl {
     // droppable tombstone histogram and gc_before.
     bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point compaction_time, const tombstone_gc_state& gc_state);
 
+    // Returns the candidate with the highest droppable tombstone ratio, if it
+    // exceeds the urgent tombstone threshold and is entitled for tombstone
+    // compaction. Strategies compact it before looking for regular compactions,
+    // so that tombstone-heavy sstables don't wait for their tier or level to fill.
+    shared_sstable get_urgent_tombstone_compaction_candidate(table_state& table_s, const std::vector<shared_sstable>& candidates,
+            gc_clock::time_point compaction_time);
+
     virtual std::unique_ptr<compaction_backlog_tracker::impl> make_backlog_tracker() = 0;
 
     virtual uint64_t adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate);
@@ -78,6 +89,6 @@ class compaction_strategy_impl {
         return false;
     }
 
-    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode);
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in);
 };
 }
@@ -16,6 +16,7 @@ enum class compaction_strategy_type {
     leveled,
     date_tiered,
     time_window,
+    incremental,
 };
 
 enum class reshape_mode { strict, relaxed };
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2019-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "compaction_backlog_manager.hh"
+#include "incremental_compaction_strategy.hh"
+#include <cmath>
+#include <ctgmath>
+
+// Backlog for ICS is calculated exactly like the one for STCS (see size_tiered_backlog_tracker.hh),
+// except that the unit of compaction is a sstable run rather than a single SSTable. So Si is the
+// size of the run, and Ci the amount of bytes already compacted from all of its fragments.
+//
+// Fragments of the same run are tracked together, so a run that is being incrementally exhausted
+// by an ongoing compaction keeps contributing to the backlog with the bytes yet to be compacted.
+class incremental_backlog_tracker final : public compaction_backlog_tracker::impl {
+    sstables::size_tiered_compaction_strategy_options _options;
+    int64_t _total_bytes = 0;
+    int _min_threshold = 4;
+    double _runs_backlog_contribution = 0.0f;
+    // Maps each run contributing to the backlog to its data size.
+    std::unordered_map<sstables::run_id, uint64_t> _runs_contributing_backlog;
+    std::unordered_map<sstables::run_id, sstables::sstable_run> _all;
+
+    struct inflight_component {
+        uint64_t total_bytes = 0;
+        double contribution = 0;
+    };
+
+    inflight_component compacted_backlog(const compaction_backlog_tracker::ongoing_compactions& ongoing_compactions) const;
+
+    double log4(double x) const {
+        double inv_log_4 = 1.0f / std::log(4);
+        return log(x) * inv_log_4;
+    }
+
+    void refresh_runs_backlog_contribution();
+public:
+    incremental_backlog_tracker(sstables::size_tiered_compaction_strategy_options options) : _options(std::move(options)) {}
+
+    virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override;
+
+    virtual void replace_sstables(std::vector<sstables::shared_sstable> old_ssts, std::vector<sstables::shared_sstable> new_ssts) override;
+
+    int64_t total_bytes() const {
+        return _total_bytes;
+    }
+};
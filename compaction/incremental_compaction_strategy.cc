@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2019-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "sstables/sstables.hh"
+#include "incremental_compaction_strategy.hh"
+#include "incremental_backlog_tracker.hh"
+
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/adaptors.hpp>
+#include <boost/range/algorithm.hpp>
+#include <boost/range/numeric.hpp>
+#include <functional>
+
+namespace sstables {
+
+extern logging::logger clogger;
+
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _options(options)
+{
+    using namespace cql3::statements;
+
+    auto tmp_value = compaction_strategy_impl::get_value(options, FRAGMENT_SIZE_OPTION);
+    auto fragment_size_in_mb = property_definitions::to_int(FRAGMENT_SIZE_OPTION, tmp_value, DEFAULT_MAX_FRAGMENT_SIZE_IN_MB);
+    if (fragment_size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("{} value ({}) must be positive", FRAGMENT_SIZE_OPTION, fragment_size_in_mb));
+    }
+    if (fragment_size_in_mb < 100) {
+        clogger.warn("SStable size of {}MB is configured. The value may lead to sstable run having an substantial amount of fragments, "
+            "which may hurt read performance", fragment_size_in_mb);
+    }
+    _fragment_size = uint64_t(fragment_size_in_mb) * 1024 * 1024;
+
+    tmp_value = compaction_strategy_impl::get_value(options, SPACE_AMPLIFICATION_GOAL_OPTION);
+    if (tmp_value) {
+        auto space_amplification_goal = property_definitions::to_double(SPACE_AMPLIFICATION_GOAL_OPTION, tmp_value, 0.0);
+        if (space_amplification_goal <= 1.0) {
+            throw exceptions::configuration_exception(format("{} value ({}) must be greater than 1.0", SPACE_AMPLIFICATION_GOAL_OPTION, space_amplification_goal));
+        }
+        _space_amplification_goal = space_amplification_goal;
+    }
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::create_sstable_runs(const std::vector<shared_sstable>& candidates) {
+    std::unordered_map<run_id, sstable_run> runs;
+    std::vector<sstable_run> ret;
+
+    for (auto& sst : candidates) {
+        // A fragment that would break the disjointness invariant of its run is handled as a run of its own.
+        if (!runs[sst->run_identifier()].insert(sst)) {
+            clogger.warn("Fragment {} overlaps with other fragments of run {}, so it's going to be handled as a separate run",
+                    sst->get_filename(), sst->run_identifier());
+            sstable_run run;
+            run.insert(sst);
+            ret.push_back(std::move(run));
+        }
+    }
+    ret.reserve(ret.size() + runs.size());
+    for (auto& [id, run] : runs) {
+        ret.push_back(std::move(run));
+    }
+    return ret;
+}
+
+std::vector<shared_sstable>
+incremental_compaction_strategy::runs_to_sstables(std::vector<sstable_run> runs) {
+    std::vector<shared_sstable> sstables;
+    for (auto& run : runs) {
+        sstables.insert(sstables.end(), run.all().begin(), run.all().end());
+    }
+    return sstables;
+}
+
+std::vector<incremental_compaction_strategy::size_bucket_t>
+incremental_compaction_strategy::get_buckets(std::vector<sstable_run> runs, const size_tiered_compaction_strategy_options& options) {
+    // runs sorted by their data size.
+    std::vector<std::pair<sstable_run, uint64_t>> sorted_runs;
+    sorted_runs.reserve(runs.size());
+    for (auto& run : runs) {
+        auto run_size = run.data_size();
+        sorted_runs.emplace_back(std::move(run), run_size);
+    }
+    std::sort(sorted_runs.begin(), sorted_runs.end(), [] (auto& i, auto& j) {
+        return i.second < j.second;
+    });
+
+    std::vector<size_bucket_t> bucket_list;
+    // average size and size of the smallest run for each bucket.
+    std::vector<std::pair<double, uint64_t>> bucket_stats;
+
+    for (auto& [run, size] : sorted_runs) {
+        // look for a bucket containing similar-sized runs, following the same rules as size-tiered.
+        if (!bucket_list.empty()) {
+            auto& [bucket_average_size, smallest_run_in_bucket] = bucket_stats.back();
+
+            if ((size > (bucket_average_size * options.bucket_low) && size < (bucket_average_size * options.bucket_high)) ||
+                    (size < options.min_sstable_size && bucket_average_size < options.min_sstable_size)) {
+                auto& bucket = bucket_list.back();
+                auto total_size = bucket.size() * bucket_average_size;
+                auto new_average_size = (total_size + size) / (bucket.size() + 1);
+
+                // Don't let the average drift upwards to a point where the smallest run falls out of range.
+                if (size < options.min_sstable_size || smallest_run_in_bucket > new_average_size * options.bucket_low) {
+                    bucket.push_back(std::move(run));
+                    bucket_average_size = new_average_size;
+                    continue;
+                }
+            }
+        }
+
+        // no similar bucket found; put it in a new one
+        bucket_stats.emplace_back(size, size);
+        bucket_list.push_back(size_bucket_t{std::move(run)});
+    }
+
+    return bucket_list;
+}
+
+bool incremental_compaction_strategy::is_any_bucket_interesting(const std::vector<size_bucket_t>& buckets, size_t min_threshold) const {
+    return boost::algorithm::any_of(buckets, [&] (const size_bucket_t& bucket) {
+        return this->is_bucket_interesting(bucket, min_threshold);
+    });
+}
+
+incremental_compaction_strategy::size_bucket_t
+incremental_compaction_strategy::most_interesting_bucket(std::vector<size_bucket_t> buckets, size_t min_threshold, size_t max_threshold) const {
+    std::vector<size_bucket_t> pruned_buckets;
+    pruned_buckets.reserve(buckets.size());
+
+    for (auto& bucket : buckets) {
+        if (!is_bucket_interesting(bucket, min_threshold)) {
+            continue;
+        }
+        // Runs are sorted by size within a bucket, so trimming keeps the smallest ones,
+        // which are cheaper to compact and easier to promote into next tier.
+        if (bucket.size() > max_threshold) {
+            bucket.erase(bucket.begin() + max_threshold, bucket.end());
+        }
+        pruned_buckets.push_back(std::move(bucket));
+    }
+
+    if (pruned_buckets.empty()) {
+        return size_bucket_t();
+    }
+
+    // Pick the bucket with more runs, as efficiency of same-tier compactions increases with number of runs.
+    auto& max = *std::max_element(pruned_buckets.begin(), pruned_buckets.end(), [] (const size_bucket_t& i, const size_bucket_t& j) {
+        return i.size() < j.size();
+    });
+    return std::move(max);
+}
+
+std::vector<shared_sstable>
+incremental_compaction_strategy::find_space_amplification_job(const std::vector<size_bucket_t>& buckets) const {
+    if (!_space_amplification_goal || buckets.size() < 2) {
+        return {};
+    }
+    auto bucket_size = [] (const size_bucket_t& bucket) {
+        return boost::accumulate(bucket | boost::adaptors::transformed(std::mem_fn(&sstable_run::data_size)), uint64_t(0));
+    };
+
+    // Buckets are ordered by the size of their runs, so the last two are the largest tiers.
+    auto& largest_tier = buckets[buckets.size() - 1];
+    auto& second_largest_tier = buckets[buckets.size() - 2];
+    auto largest_tier_size = bucket_size(largest_tier);
+    auto second_largest_tier_size = bucket_size(second_largest_tier);
+
+    if (!largest_tier_size || double(largest_tier_size + second_largest_tier_size) / largest_tier_size <= *_space_amplification_goal) {
+        return {};
+    }
+    clogger.debug("ICS: space amplification goal of {} was exceeded by largest tiers of size {} and {}",
+            *_space_amplification_goal, largest_tier_size, second_largest_tier_size);
+
+    std::vector<sstable_run> runs;
+    runs.insert(runs.end(), second_largest_tier.begin(), second_largest_tier.end());
+    runs.insert(runs.end(), largest_tier.begin(), largest_tier.end());
+    return runs_to_sstables(std::move(runs));
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<shared_sstable> candidates) {
+    // make local copies so they can't be changed out from under us mid-method
+    size_t min_threshold = table_s.min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    auto compaction_time = gc_clock::now();
+
+    auto buckets = get_buckets(create_sstable_runs(candidates), _options);
+
+    if (is_any_bucket_interesting(buckets, min_threshold)) {
+        auto most_interesting = most_interesting_bucket(std::move(buckets), min_threshold, max_threshold);
+        return make_compaction_descriptor(runs_to_sstables(std::move(most_interesting)));
+    }
+
+    // If we are not enforcing min_threshold explicitly, try any pair of runs in the same tier.
+    if (!table_s.compaction_enforce_min_threshold() && is_any_bucket_interesting(buckets, 2)) {
+        auto most_interesting = most_interesting_bucket(std::move(buckets), 2, max_threshold);
+        return make_compaction_descriptor(runs_to_sstables(std::move(most_interesting)));
+    }
+
+    if (auto sstables = find_space_amplification_job(buckets); !sstables.empty()) {
+        return make_compaction_descriptor(std::move(sstables));
+    }
+
+    // if there is no run to compact in standard way, try compacting a single run whose droppable tombstone
+    // ratio is greater than threshold, preferring oldest runs from biggest tiers.
+    if (_disable_tombstone_compaction) {
+        return compaction_descriptor();
+    }
+    auto worth_dropping_tombstones = [&] (const sstable_run& run) {
+        auto& fragments = run.all();
+        // ignore runs that were created just recently, for the same reason as in compaction_strategy_impl::worth_dropping_tombstones().
+        auto newest_write_time = db_clock::now() - _tombstone_compaction_interval;
+        if (fragments.empty() || boost::algorithm::any_of(fragments, [&] (const shared_sstable& sst) { return sst->data_file_write_time() > newest_write_time; })) {
+            return false;
+        }
+        auto gc_before = (*fragments.begin())->get_gc_before_for_drop_estimation(compaction_time, table_s.get_tombstone_gc_state());
+        return run.estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
+    };
+    auto min_timestamp = [] (const sstable_run& run) {
+        auto ts = api::max_timestamp;
+        for (auto& sst : run.all()) {
+            ts = std::min(ts, sst->get_stats_metadata().min_timestamp);
+        }
+        return ts;
+    };
+    for (auto&& bucket : buckets | boost::adaptors::reversed) {
+        std::erase_if(bucket, std::not_fn(worth_dropping_tombstones));
+        if (bucket.empty()) {
+            continue;
+        }
+        auto it = std::min_element(bucket.begin(), bucket.end(), [&] (const sstable_run& i, const sstable_run& j) {
+            return min_timestamp(i) < min_timestamp(j);
+        });
+        return make_compaction_descriptor(runs_to_sstables({ std::move(*it) }));
+    }
+    return compaction_descriptor();
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<shared_sstable> candidates) {
+    if (candidates.empty()) {
+        return compaction_descriptor();
+    }
+    return make_major_compaction_job(std::move(candidates), compaction_descriptor::default_level, _fragment_size);
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(table_state& table_s) const {
+    size_t min_threshold = table_s.schema()->min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    std::vector<shared_sstable> sstables;
+
+    auto all_sstables = table_s.main_sstable_set().all();
+    sstables.reserve(all_sstables->size());
+    for (auto& entry : *all_sstables) {
+        sstables.push_back(entry);
+    }
+
+    int64_t n = 0;
+    for (auto& bucket : get_buckets(create_sstable_runs(sstables), _options)) {
+        if (bucket.size() >= min_threshold) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in) {
+    size_t offstrategy_threshold = std::max(schema->min_compaction_threshold(), 4);
+    size_t max_runs = std::max({size_t(schema->max_compaction_threshold()), offstrategy_threshold, max_fan_in});
+
+    if (mode == reshape_mode::relaxed) {
+        offstrategy_threshold = max_runs;
+    }
+
+    for (auto& bucket : get_buckets(create_sstable_runs(input), _options)) {
+        if (bucket.size() >= offstrategy_threshold) {
+            if (bucket.size() > max_runs) {
+                bucket.erase(bucket.begin() + max_runs, bucket.end());
+            }
+            compaction_descriptor desc(runs_to_sstables(std::move(bucket)), iop, compaction_descriptor::default_level, _fragment_size);
+            desc.options = compaction_type_options::make_reshape();
+            return desc;
+        }
+    }
+
+    return compaction_descriptor();
+}
+
+std::unique_ptr<compaction_backlog_tracker::impl> incremental_compaction_strategy::make_backlog_tracker() {
+    return std::make_unique<incremental_backlog_tracker>(_options);
+}
+
+}
+
+incremental_backlog_tracker::inflight_component
+incremental_backlog_tracker::compacted_backlog(const compaction_backlog_tracker::ongoing_compactions& ongoing_compactions) const {
+    inflight_component in;
+    for (auto const& crp : ongoing_compactions) {
+        // A run that doesn't belong to an interesting tier doesn't contribute to backlog,
+        // so its compacted bytes must not be discounted either.
+        auto it = _runs_contributing_backlog.find(crp.first->run_identifier());
+        if (it == _runs_contributing_backlog.end()) {
+            continue;
+        }
+        auto compacted = crp.second->compacted();
+        in.total_bytes += compacted;
+        in.contribution += compacted * log4(it->second);
+    }
+    return in;
+}
+
+void incremental_backlog_tracker::refresh_runs_backlog_contribution() {
+    _runs_backlog_contribution = 0.0f;
+    _runs_contributing_backlog = {};
+    if (_all.empty()) {
+        return;
+    }
+    using namespace sstables;
+
+    auto runs = boost::copy_range<std::vector<sstable_run>>(_all | boost::adaptors::map_values);
+    for (auto& bucket : incremental_compaction_strategy::get_buckets(std::move(runs), _options)) {
+        if (bucket.size() < size_t(_min_threshold)) {
+            continue;
+        }
+        for (auto& run : bucket) {
+            auto run_size = run.data_size();
+            _runs_backlog_contribution += run_size * log4(run_size);
+            // Controller is disabled if exception is caught during add / remove calls, so not making any effort to make this exception safe
+            _runs_contributing_backlog.emplace((*run.all().begin())->run_identifier(), run_size);
+        }
+    }
+}
+
+double incremental_backlog_tracker::backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const {
+    inflight_component compacted = compacted_backlog(oc);
+
+    auto total_backlog_bytes = boost::accumulate(_runs_contributing_backlog | boost::adaptors::map_values, uint64_t(0));
+
+    // Bail out if effective backlog is zero, which happens in a small window where ongoing compaction exhausted
+    // input files but is still sealing output files or doing managerial stuff like updating history table
+    if (total_backlog_bytes <= compacted.total_bytes) {
+        return 0;
+    }
+
+    // Same formula as size_tiered_backlog_tracker, with runs in place of SSTables.
+    auto effective_backlog_bytes = total_backlog_bytes - compacted.total_bytes;
+    auto runs_contribution = _runs_backlog_contribution - compacted.contribution;
+    auto b = (effective_backlog_bytes * log4(_total_bytes)) - runs_contribution;
+    return b > 0 ? b : 0;
+}
+
+void incremental_backlog_tracker::replace_sstables(std::vector<sstables::shared_sstable> old_ssts, std::vector<sstables::shared_sstable> new_ssts) {
+    for (auto& sst : old_ssts) {
+        if (sst->data_size() == 0) {
+            continue;
+        }
+        auto it = _all.find(sst->run_identifier());
+        if (it == _all.end() || !it->second.all().contains(sst)) {
+            continue;
+        }
+        _total_bytes -= sst->data_size();
+        it->second.erase(sst);
+        if (it->second.all().empty()) {
+            _all.erase(it);
+        }
+    }
+    for (auto& sst : new_ssts) {
+        if (sst->data_size() == 0) {
+            continue;
+        }
+        // Deduce threshold from the last SSTable added, like size_tiered_backlog_tracker.
+        _min_threshold = sst->get_schema()->min_compaction_threshold();
+        auto data_size = sst->data_size();
+        if (_all[sst->run_identifier()].insert(std::move(sst))) {
+            _total_bytes += data_size;
+        }
+    }
+    refresh_runs_backlog_contribution();
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2019-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "compaction.hh"
+#include "sstables/sstable_set.hh"
+#include "sstables/shared_sstable.hh"
+
+class incremental_backlog_tracker;
+
+namespace sstables {
+
+// Incremental compaction strategy (ICS) applies the size-tiered policy to sstable runs,
+// rather than to individual sstables. Each run is split into fixed-size fragments
+// (sstable_size_in_mb), which allows compaction to release input fragments as soon as
+// they're exhausted, and therefore bounds the temporary space overhead of a compaction
+// to roughly (number of input runs) * (fragment size), instead of the size of the
+// whole bucket as in STCS.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+    static constexpr int32_t DEFAULT_MAX_FRAGMENT_SIZE_IN_MB = 1000;
+    const sstring FRAGMENT_SIZE_OPTION = "sstable_size_in_mb";
+    const sstring SPACE_AMPLIFICATION_GOAL_OPTION = "space_amplification_goal";
+
+    size_tiered_compaction_strategy_options _options;
+    uint64_t _fragment_size;
+    std::optional<double> _space_amplification_goal;
+
+    using size_bucket_t = std::vector<sstable_run>;
+private:
+    // Group all candidates into sstable runs, according to their run identifier.
+    static std::vector<sstable_run> create_sstable_runs(const std::vector<shared_sstable>& candidates);
+
+    static std::vector<shared_sstable> runs_to_sstables(std::vector<sstable_run> runs);
+
+    bool is_bucket_interesting(const size_bucket_t& bucket, size_t min_threshold) const {
+        return bucket.size() >= min_threshold;
+    }
+
+    bool is_any_bucket_interesting(const std::vector<size_bucket_t>& buckets, size_t min_threshold) const;
+
+    // Returns the bucket with most runs, trimmed to max_threshold, or an empty one if none is interesting.
+    size_bucket_t most_interesting_bucket(std::vector<size_bucket_t> buckets, size_t min_threshold, size_t max_threshold) const;
+
+    // Returns a job that merges the two largest tiers, if they violate the space amplification goal.
+    std::vector<shared_sstable> find_space_amplification_job(const std::vector<size_bucket_t>& buckets) const;
+
+    compaction_descriptor make_compaction_descriptor(std::vector<shared_sstable> sstables, int level = compaction_descriptor::default_level) const {
+        return compaction_descriptor(std::move(sstables), service::get_local_compaction_priority(), level, _fragment_size);
+    }
+public:
+    // Group runs of similar size into buckets, following the size-tiered semantics.
+    static std::vector<size_bucket_t> get_buckets(std::vector<sstable_run> runs, const size_tiered_compaction_strategy_options& options);
+
+    incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(table_state& table_s, std::vector<shared_sstable> candidates) override;
+
+    virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
+
+    virtual compaction_strategy_type type() const override {
+        return compaction_strategy_type::incremental;
+    }
+
+    virtual std::unique_ptr<compaction_backlog_tracker::impl> make_backlog_tracker() override;
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in) override;
+
+    uint64_t fragment_size() const {
+        return _fragment_size;
+    }
+
+    friend class ::incremental_backlog_tracker;
+};
+
+}
@@ -20,6 +20,10 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(t
     // lists managed by the manifest may become outdated. For example, one
     // sstable in it may be marked for deletion after compacted.
     // Currently, we create a new manifest whenever it's time for compaction.
+    if (auto sst = get_urgent_tombstone_compaction_candidate(table_s, candidates, gc_clock::now())) {
+        auto level = sst->get_sstable_level();
+        return sstables::compaction_descriptor({ std::move(sst) }, service::get_local_compaction_priority(), level);
+    }
     leveled_manifest manifest = leveled_manifest::create(table_s, candidates, _max_sstable_size_in_mb, _stcs_options);
     if (!_last_compacted_keys) {
         generate_last_compacted_keys(manifest);
@@ -134,7 +138,7 @@ int64_t leveled_compaction_strategy::estimated_pending_compactions(table_state&
 }
 
 compaction_descriptor
-leveled_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
+leveled_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in) {
     std::array<std::vector<shared_sstable>, leveled_manifest::MAX_LEVELS> level_info;
 
     auto is_disjoint = [this, schema] (const std::vector<shared_sstable>& sstables, unsigned tolerance) -> std::tuple<bool, unsigned> {
@@ -167,7 +171,7 @@ leveled_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input
     }
 
     size_t offstrategy_threshold = (mode == reshape_mode::strict) ? std::max(schema->min_compaction_threshold(), 4) : std::max(schema->max_compaction_threshold(), 32);
-    size_t max_sstables = std::max(schema->max_compaction_threshold(), int(offstrategy_threshold));
+    size_t max_sstables = std::max({size_t(schema->max_compaction_threshold()), offstrategy_threshold, max_fan_in});
     auto tolerance = [mode] (unsigned level) -> unsigned {
         if (mode == reshape_mode::strict) {
             return 0;
@@ -190,7 +194,7 @@ leveled_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input
 
     if (level_info[0].size() > offstrategy_threshold) {
         size_tiered_compaction_strategy stcs(_stcs_options);
-        return stcs.get_reshaping_job(std::move(level_info[0]), schema, iop, mode);
+        return stcs.get_reshaping_job(std::move(level_info[0]), schema, iop, mode, max_fan_in);
     }
 
     for (unsigned level = leveled_manifest::MAX_LEVELS - 1; level > 0; --level) {
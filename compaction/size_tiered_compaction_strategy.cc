@@ -151,6 +151,10 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(table_state& table_
 
     // TODO: Add support to filter cold sstables (for reference: SizeTieredCompactionStrategy::filterColdSSTables).
 
+    if (auto sst = get_urgent_tombstone_compaction_candidate(table_s, candidates, compaction_time)) {
+        return sstables::compaction_descriptor({ std::move(sst) }, service::get_local_compaction_priority());
+    }
+
     auto buckets = get_buckets(candidates);
 
     if (is_any_bucket_interesting(buckets, min_threshold)) {
@@ -225,10 +229,10 @@ size_tiered_compaction_strategy::most_interesting_bucket(const std::vector<sstab
 }
 
 compaction_descriptor
-size_tiered_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode)
+size_tiered_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in)
 {
     size_t offstrategy_threshold = std::max(schema->min_compaction_threshold(), 4);
-    size_t max_sstables = std::max(schema->max_compaction_threshold(), int(offstrategy_threshold));
+    size_t max_sstables = std::max({size_t(schema->max_compaction_threshold()), offstrategy_threshold, max_fan_in});
 
     if (mode == reshape_mode::relaxed) {
         offstrategy_threshold = max_sstables;
@@ -128,12 +128,12 @@ reader_consumer_v2 time_window_compaction_strategy::make_interposer_consumer(con
 }
 
 compaction_descriptor
-time_window_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
+time_window_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in) {
     std::vector<shared_sstable> single_window;
     std::vector<shared_sstable> multi_window;
 
     size_t offstrategy_threshold = std::max(schema->min_compaction_threshold(), 4);
-    size_t max_sstables = std::max(schema->max_compaction_threshold(), int(offstrategy_threshold));
+    size_t max_sstables = std::max({size_t(schema->max_compaction_threshold()), offstrategy_threshold, max_fan_in});
 
     if (mode == reshape_mode::relaxed) {
         offstrategy_threshold = max_sstables;
@@ -201,7 +201,7 @@ time_window_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> i
             }
             // reuse STCS reshape logic which will only compact similar-sized files, to increase overall efficiency
             // when reshaping time buckets containing a huge amount of files
-            auto desc = size_tiered_compaction_strategy(_stcs_options).get_reshaping_job(std::move(ssts), schema, iop, mode);
+            auto desc = size_tiered_compaction_strategy(_stcs_options).get_reshaping_job(std::move(ssts), schema, iop, mode, max_fan_in);
             if (!desc.sstables.empty()) {
                 return desc;
             }
@@ -243,6 +243,11 @@ time_window_compaction_strategy::get_sstables_for_compaction(table_state& table_
         clogger.debug("[{}] TWCS skipping check for fully expired SSTables", fmt::ptr(this));
     }
 
+    if (auto sst = get_urgent_tombstone_compaction_candidate(table_s, candidates, compaction_time)) {
+        clogger.debug("[{}] Going to compact sstable {} for its droppable tombstones", fmt::ptr(this), sst->get_filename());
+        return compaction_descriptor({ std::move(sst) }, service::get_local_compaction_priority());
+    }
+
     auto compaction_candidates = get_next_non_expired_sstables(table_s, control, std::move(candidates), compaction_time);
     clogger.debug("[{}] Going to compact {} non-expired sstables", fmt::ptr(this), compaction_candidates.size());
     return compaction_descriptor(std::move(compaction_candidates), service::get_local_compaction_priority());
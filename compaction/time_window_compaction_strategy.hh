@@ -159,13 +159,17 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
 
     virtual uint64_t adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) override;
 
+    // Segregates the data written by memtable flushes, streaming and compaction
+    // by time window, so that each sstable written holds a single window (up to
+    // max_data_segregation_window_count windows), even when the data comes
+    // out-of-order. Data spanning a single window is written as-is.
     virtual reader_consumer_v2 make_interposer_consumer(const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer) override;
 
     virtual bool use_interposer_consumer() const override {
         return true;
     }
 
-    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) override;
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode, size_t max_fan_in) override;
 };
 
 }
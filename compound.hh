@@ -15,14 +15,118 @@
 #include <boost/range/iterator_range.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include "utils/serialization.hh"
+#include "utils/UUID.hh"
+#include <seastar/core/byteorder.hh>
 #include <seastar/util/backtrace.hh>
 
 enum class allow_prefixes { no, yes };
 
+// Compares values of a compound's component.
+//
+// For common key types, the comparison is done inline instead of through
+// abstract_type::compare(), which dispatches on the type for every call.
+// Which one is used is decided once, when the compound type is created
+// (i.e. once per schema), and yields the same ordering as abstract_type::compare().
+class component_comparator {
+public:
+    enum class kind : uint8_t {
+        generic,
+        // Ordered as unsigned bytes, like text and blob.
+        unsigned_bytes,
+        int32,
+        int64,
+        timeuuid,
+    };
+private:
+    // The underlying type for reversed types.
+    data_type _type;
+    kind _kind;
+    bool _reversed;
+
+    static kind kind_of(const abstract_type& t) {
+        switch (t.get_kind()) {
+        case abstract_type::kind::ascii:
+        case abstract_type::kind::utf8:
+        case abstract_type::kind::bytes:
+        case abstract_type::kind::inet:
+        case abstract_type::kind::date:
+        case abstract_type::kind::duration:
+            return kind::unsigned_bytes;
+        case abstract_type::kind::int32:
+            return kind::int32;
+        case abstract_type::kind::long_kind:
+        case abstract_type::kind::timestamp:
+        case abstract_type::kind::time:
+            return kind::int64;
+        case abstract_type::kind::timeuuid:
+            return kind::timeuuid;
+        default:
+            return kind::generic;
+        }
+    }
+
+    template <typename T>
+    static std::optional<std::strong_ordering> compare_fixed(bytes_view v1, bytes_view v2) noexcept {
+        if (v1.size() != sizeof(T) || v2.size() != sizeof(T)) {
+            return std::nullopt;
+        }
+        return read_be<T>(reinterpret_cast<const char*>(v1.data())) <=> read_be<T>(reinterpret_cast<const char*>(v2.data()));
+    }
+
+    std::optional<std::strong_ordering> compare_linearized(bytes_view v1, bytes_view v2) const noexcept {
+        if (_kind == kind::unsigned_bytes) {
+            return compare_unsigned(v1, v2);
+        }
+        if (v1.empty() || v2.empty()) {
+            // Empty values sort before all others.
+            return !v1.empty() <=> !v2.empty();
+        }
+        switch (_kind) {
+        case kind::int32:
+            return compare_fixed<int32_t>(v1, v2);
+        case kind::int64:
+            return compare_fixed<int64_t>(v1, v2);
+        case kind::timeuuid:
+            if (v1.size() != 16 || v2.size() != 16) {
+                return std::nullopt;
+            }
+            return utils::timeuuid_tri_compare(v1, v2);
+        default:
+            return std::nullopt;
+        }
+    }
+public:
+    explicit component_comparator(data_type t)
+        : _type(t->is_reversed() ? t->underlying_type() : t)
+        , _kind(kind_of(*_type))
+        , _reversed(t->is_reversed())
+    { }
+
+    kind get_kind() const noexcept {
+        return _kind;
+    }
+
+    std::strong_ordering operator()(managed_bytes_view v1, managed_bytes_view v2) const {
+        if (_reversed) {
+            std::swap(v1, v2);
+        }
+        // Keys are almost always contiguous, the fragmented case goes the slow path.
+        auto f1 = v1.current_fragment();
+        auto f2 = v2.current_fragment();
+        if (_kind != kind::generic && f1.size() == v1.size_bytes() && f2.size() == v2.size_bytes()) [[likely]] {
+            if (auto res = compare_linearized(f1, f2)) {
+                return *res;
+            }
+        }
+        return _type->compare(v1, v2);
+    }
+};
+
 template<allow_prefixes AllowPrefixes = allow_prefixes::no>
 class compound_type final {
 private:
     const std::vector<data_type> _types;
+    const std::vector<component_comparator> _comparators;
     const bool _byte_order_equal;
     const bool _byte_order_comparable;
     const bool _is_reversed;
@@ -34,6 +138,7 @@ class compound_type final {
 
     compound_type(std::vector<data_type> types)
         : _types(std::move(types))
+        , _comparators(_types.begin(), _types.end())
         , _byte_order_equal(std::all_of(_types.begin(), _types.end(), [] (const auto& t) {
                 return t->is_byte_order_equal();
             }))
@@ -249,11 +354,21 @@ class compound_type final {
                 return compare_unsigned(b1, b2);
             }
         }
-        return lexicographical_tri_compare(_types.begin(), _types.end(),
-            begin(b1), end(b1), begin(b2), end(b2), [] (auto&& type, auto&& v1, auto&& v2) {
-                return type->compare(v1, v2);
+        return lexicographical_tri_compare(_comparators.begin(), _comparators.end(),
+            begin(b1), end(b1), begin(b2), end(b2), [] (const component_comparator& cmp, auto&& v1, auto&& v2) {
+                return cmp(v1, v2);
             });
     }
+    // Compares serialized prefixes in the prefix equality order, see ::prefix_equality_tri_compare().
+    std::strong_ordering prefix_equality_tri_compare(managed_bytes_view b1, managed_bytes_view b2) const {
+        return ::prefix_equality_tri_compare(_comparators.begin(),
+            begin(b1), end(b1), begin(b2), end(b2), [] (const component_comparator& cmp, managed_bytes_view v1, managed_bytes_view v2) {
+                return cmp(v1, v2);
+            });
+    }
+    const std::vector<component_comparator>& comparators() const {
+        return _comparators;
+    }
     // Retruns true iff given prefix has no missing components
     bool is_full(managed_bytes_view v) const {
         assert(AllowPrefixes == allow_prefixes::yes);
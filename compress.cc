@@ -60,6 +60,14 @@ std::map<sstring, sstring> compressor::options() const {
     return {};
 }
 
+size_t compressor::dictionary_sample_size() const {
+    return 0;
+}
+
+shared_ptr<compressor> compressor::with_dictionary(const std::vector<temporary_buffer<char>>&) const {
+    return nullptr;
+}
+
 compressor::ptr_type compressor::create(const sstring& name, const opt_getter& opts) {
     if (name.empty()) {
         return {};
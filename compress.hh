@@ -10,10 +10,12 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
 
 #include "exceptions/exceptions.hh"
 
@@ -51,6 +53,24 @@ class compressor {
      */
     virtual std::map<sstring, sstring> options() const;
 
+    /**
+     * Chunks compressed independently of each other compress poorly when they
+     * are small. Compressors supporting dictionaries can share one among all
+     * chunks of a file, trained on samples of the file's own data.
+     *
+     * Returns the amount of uncompressed data, taken from the beginning of a
+     * file, which should be passed to with_dictionary() before any chunk of
+     * the file is compressed, or 0 if no dictionary should be used.
+     */
+    virtual size_t dictionary_sample_size() const;
+    /**
+     * Returns a compressor using a dictionary suitable for the given samples,
+     * or nullptr if none could be built, in which case this compressor should
+     * be used. The dictionary is part of the returned compressor's options(),
+     * which must be stored along the file to be able to uncompress it.
+     */
+    virtual shared_ptr<compressor> with_dictionary(const std::vector<temporary_buffer<char>>& samples) const;
+
     /**
      * Compressor class name.
      */
@@ -377,6 +377,7 @@ scylla_tests = set([
     'test/boost/cql_query_test',
     'test/boost/cql_query_large_test',
     'test/boost/cql_query_like_test',
+    'test/boost/cql_simple_statement_parser_test',
     'test/boost/cql_query_group_test',
     'test/boost/cql_functions_test',
     'test/boost/crc_test',
@@ -399,6 +400,7 @@ scylla_tests = set([
     'test/boost/hash_test',
     'test/boost/hashers_test',
     'test/boost/hint_test',
+    'test/boost/hyperloglog_test',
     'test/boost/idl_test',
     'test/boost/input_stream_test',
     'test/boost/json_cql_query_test',
@@ -462,6 +464,7 @@ scylla_tests = set([
     'test/boost/sstable_directory_test',
     'test/boost/sstable_test',
     'test/boost/sstable_move_test',
+    'test/boost/sstable_trie_test',
     'test/boost/statement_restrictions_test',
     'test/boost/storage_proxy_test',
     'test/boost/top_k_test',
@@ -538,6 +541,7 @@ perf_tests = set([
     'test/perf/perf_idl',
     'test/perf/perf_vint',
     'test/perf/perf_big_decimal',
+    'test/perf/perf_like_matcher',
 ])
 
 raft_tests = set([
@@ -653,6 +657,7 @@ scylla_raft_core = [
 ]
 
 scylla_core = (['message/messaging_service.cc',
+                'message/zstd_rpc_compressor.cc',
                 'replica/database.cc',
                 'replica/table.cc',
                 'replica/distributed_loader.cc',
@@ -707,6 +712,7 @@ scylla_core = (['message/messaging_service.cc',
                 'sstables/sstables.cc',
                 'sstables/sstables_manager.cc',
                 'sstables/sstable_set.cc',
+                'sstables/trie/trie.cc',
                 'sstables/mx/partition_reversing_data_source.cc',
                 'sstables/mx/reader.cc',
                 'sstables/mx/writer.cc',
@@ -718,6 +724,7 @@ scylla_core = (['message/messaging_service.cc',
                 'compaction/compaction_strategy.cc',
                 'compaction/size_tiered_compaction_strategy.cc',
                 'compaction/leveled_compaction_strategy.cc',
+                'compaction/incremental_compaction_strategy.cc',
                 'compaction/time_window_compaction_strategy.cc',
                 'compaction/compaction_manager.cc',
                 'sstables/integrity_checked_file_impl.cc',
@@ -725,11 +732,13 @@ scylla_core = (['message/messaging_service.cc',
                 'sstables/m_format_read_helpers.cc',
                 'sstables/sstable_directory.cc',
                 'sstables/random_access_reader.cc',
+                'sstables/read_ahead.cc',
                 'sstables/metadata_collector.cc',
                 'sstables/writer.cc',
                 'transport/cql_protocol_extension.cc',
                 'transport/event.cc',
                 'transport/event_notifier.cc',
+                'transport/segment.cc',
                 'transport/server.cc',
                 'transport/controller.cc',
                 'transport/messages/result_message.cc',
@@ -816,6 +825,7 @@ scylla_core = (['message/messaging_service.cc',
                 'cql3/statements/describe_statement.cc',
                 'cql3/update_parameters.cc',
                 'cql3/util.cc',
+                'cql3/simple_statement_parser.cc',
                 'cql3/ut_name.cc',
                 'cql3/role_name.cc',
                 'data_dictionary/data_dictionary.cc',
@@ -867,6 +877,7 @@ scylla_core = (['message/messaging_service.cc',
                 'db/commitlog/commitlog_replayer.cc',
                 'db/commitlog/commitlog_entry.cc',
                 'db/data_listeners.cc',
+                'db/write_path_profiler.cc',
                 'db/hints/manager.cc',
                 'db/hints/resource_manager.cc',
                 'db/hints/host_filter.cc',
@@ -883,6 +894,7 @@ scylla_core = (['message/messaging_service.cc',
                 'db/view/row_locking.cc',
                 'db/sstables-format-selector.cc',
                 'db/snapshot-ctl.cc',
+                'db/row_cache_saver.cc',
                 'db/rate_limiter.cc',
                 'db/per_partition_rate_limit_options.cc',
                 'index/secondary_index_manager.cc',
@@ -986,6 +998,7 @@ scylla_core = (['message/messaging_service.cc',
                 'auth/sasl_challenge.cc',
                 'tracing/tracing.cc',
                 'tracing/trace_keyspace_helper.cc',
+                'tracing/trace_ring_helper.cc',
                 'tracing/trace_state.cc',
                 'tracing/traced_file.cc',
                 'table_helper.cc',
@@ -1172,6 +1185,8 @@ scylla_perfs = ['test/perf/perf_fast_forward.cc',
                 'test/perf/perf_row_cache_update.cc',
                 'test/perf/perf_simple_query.cc',
                 'test/perf/perf_sstable.cc',
+                'test/perf/perf_compaction_strategy.cc',
+                'test/perf/perf_compaction.cc',
                 'test/perf/perf.cc',
                 'test/lib/alternator_test_env.cc',
                 'test/lib/cql_test_env.cc',
@@ -1201,6 +1216,7 @@ pure_boost_tests = set([
     'test/boost/dynamic_bitset_test',
     'test/boost/enum_option_test',
     'test/boost/enum_set_test',
+    'test/boost/hyperloglog_test',
     'test/boost/idl_test',
     'test/boost/json_test',
     'test/boost/keys_test',
@@ -1289,7 +1305,7 @@ deps['test/boost/reusable_buffer_test'] = [
     "test/boost/reusable_buffer_test.cc",
     "test/lib/log.cc",
 ]
-deps['test/boost/utf8_test'] = ['utils/utf8.cc', 'test/boost/utf8_test.cc']
+deps['test/boost/utf8_test'] = ['utils/utf8.cc', 'utils/ascii.cc', 'test/boost/utf8_test.cc']
 deps['test/boost/small_vector_test'] = ['test/boost/small_vector_test.cc']
 deps['test/boost/multishard_mutation_query_test'] += ['test/boost/test_table.cc']
 deps['test/boost/vint_serialization_test'] = ['test/boost/vint_serialization_test.cc', 'vint-serialization.cc', 'bytes.cc']
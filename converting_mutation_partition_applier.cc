@@ -101,6 +101,18 @@ converting_mutation_partition_applier::converting_mutation_partition_applier(
 { }
 
 
+const column_definition*
+converting_mutation_partition_applier::target_column(std::vector<std::optional<const column_definition*>>& defs, column_id id, const column_mapping_entry& col) {
+    if (defs.size() <= id) {
+        defs.resize(id + 1);
+    }
+    auto& def = defs[id];
+    if (!def) {
+        def = _p_schema.get_column_definition(col.name());
+    }
+    return *def;
+}
+
 void
 converting_mutation_partition_applier::accept_partition_tombstone(tombstone t) {
     _p.apply(t);
@@ -114,7 +126,7 @@ converting_mutation_partition_applier::accept_static_cell(column_id id, atomic_c
 void
 converting_mutation_partition_applier::accept_static_cell(column_id id, atomic_cell_view cell) {
     const column_mapping_entry& col = _visited_column_mapping.static_column_at(id);
-    const column_definition* def = _p_schema.get_column_definition(col.name());
+    const column_definition* def = target_column(_static_defs, id, col);
     if (def) {
         accept_cell(_p._static_row.maybe_create(), column_kind::static_column, *def, *col.type(), cell);
     }
@@ -123,7 +135,7 @@ converting_mutation_partition_applier::accept_static_cell(column_id id, atomic_c
 void
 converting_mutation_partition_applier::accept_static_cell(column_id id, collection_mutation_view collection) {
     const column_mapping_entry& col = _visited_column_mapping.static_column_at(id);
-    const column_definition* def = _p_schema.get_column_definition(col.name());
+    const column_definition* def = target_column(_static_defs, id, col);
     if (def) {
         accept_cell(_p._static_row.maybe_create(), column_kind::static_column, *def, *col.type(), collection);
     }
@@ -150,7 +162,7 @@ converting_mutation_partition_applier::accept_row_cell(column_id id, atomic_cell
 void
 converting_mutation_partition_applier::accept_row_cell(column_id id, atomic_cell_view cell) {
     const column_mapping_entry& col = _visited_column_mapping.regular_column_at(id);
-    const column_definition* def = _p_schema.get_column_definition(col.name());
+    const column_definition* def = target_column(_regular_defs, id, col);
     if (def) {
         accept_cell(_current_row->cells(), column_kind::regular_column, *def, *col.type(), cell);
     }
@@ -159,7 +171,7 @@ converting_mutation_partition_applier::accept_row_cell(column_id id, atomic_cell
 void
 converting_mutation_partition_applier::accept_row_cell(column_id id, collection_mutation_view collection) {
     const column_mapping_entry& col = _visited_column_mapping.regular_column_at(id);
-    const column_definition* def = _p_schema.get_column_definition(col.name());
+    const column_definition* def = target_column(_regular_defs, id, col);
     if (def) {
         accept_cell(_current_row->cells(), column_kind::regular_column, *def, *col.type(), collection);
     }
@@ -30,7 +30,13 @@ class converting_mutation_partition_applier : public mutation_partition_visitor
     mutation_partition& _p;
     const column_mapping& _visited_column_mapping;
     deletable_row* _current_row;
+    // The definitions in the target schema of the visited static and regular
+    // columns, by visited column id. Each is looked up by name on its first
+    // use, rather than for every cell.
+    std::vector<std::optional<const column_definition*>> _static_defs;
+    std::vector<std::optional<const column_definition*>> _regular_defs;
 private:
+    const column_definition* target_column(std::vector<std::optional<const column_definition*>>& defs, column_id id, const column_mapping_entry& col);
     static bool is_compatible(const column_definition& new_def, const abstract_type& old_type, column_kind kind);
     static atomic_cell upgrade_cell(const abstract_type& new_type, const abstract_type& old_type, atomic_cell_view cell,
                                     atomic_cell::collection_member cm = atomic_cell::collection_member::no);
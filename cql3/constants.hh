@@ -38,8 +38,9 @@ class constants {
         using operation_skip_if_unset::operation_skip_if_unset;
 
         virtual void execute(mutation& m, const clustering_key_prefix& prefix, const update_parameters& params) override {
-            auto value = expr::evaluate(*_e, params._options);
-            execute(m, prefix, params, column, value.view());
+            // Values of bind markers go straight from the request into the cell.
+            cql3::raw_value storage = cql3::raw_value::make_null();
+            execute(m, prefix, params, column, expr::evaluate_to_view(*_e, params._options, storage));
         }
 
         static void execute(mutation& m, const clustering_key_prefix& prefix, const update_parameters& params, const column_definition& column, cql3::raw_value_view value) {
@@ -26,6 +26,7 @@
 #include "cql3/util.hh"
 #include "index/secondary_index_manager.hh"
 #include "types/list.hh"
+#include "types/listlike_partial_deserializing_iterator.hh"
 #include "types/map.hh"
 #include "types/set.hh"
 #include "utils/like_matcher.hh"
@@ -166,7 +167,6 @@ get_value(const subscript& s, const evaluation_inputs& inputs) {
         // For null[i] we return null.
         return std::nullopt;
     }
-    const auto deserialized = cdef->type->deserialize(managed_bytes_view(*serialized));
     const auto key = evaluate(s.sub, inputs);
     auto&& key_type = col_type->is_map() ? col_type->name_comparator() : int32_type;
     if (key.is_null()) {
@@ -180,25 +180,37 @@ get_value(const subscript& s, const evaluation_inputs& inputs) {
         // not an error.
         return std::nullopt;
     }
+    // Look the element up in the serialized collection, skipping the
+    // other elements without deserializing them.
+    managed_bytes_view in(*serialized);
     if (col_type->is_map()) {
-        const auto& data_map = value_cast<map_type_impl::native_type>(deserialized);
-        const auto found = key.view().with_linearized([&] (bytes_view key_bv) {
-            using entry = std::pair<data_value, data_value>;
-            return std::find_if(data_map.cbegin(), data_map.cend(), [&] (const entry& element) {
-                return key_type->compare(element.first.serialize_nonnull(), key_bv) == 0;
-            });
+        return key.view().with_linearized([&] (bytes_view key_bv) -> managed_bytes_opt {
+            // The entries may not be sorted - e.g. in a frozen map bound by
+            // the client - so they are all compared.
+            auto size = read_collection_size(in);
+            for (int i = 0; i < size; ++i) {
+                auto entry_key = read_collection_key(in);
+                auto entry_value = read_collection_value_nonnull(in);
+                if (key_type->compare(entry_key, managed_bytes_view(key_bv)) == 0) {
+                    return managed_bytes(entry_value);
+                }
+            }
+            return std::nullopt;
         });
-        return found == data_map.cend() ? std::nullopt : managed_bytes_opt(found->second.serialize_nonnull());
     } else if (col_type->is_list()) {
-        const auto& data_list = value_cast<list_type_impl::native_type>(deserialized);
         auto key_deserialized = key.view().with_linearized([&] (bytes_view key_bv) {
             return key_type->deserialize(key_bv);
         });
         auto key_int = value_cast<int32_t>(key_deserialized);
-        if (key_int < 0 || size_t(key_int) >= data_list.size()) {
+        auto size = read_collection_size(in);
+        if (key_int < 0 || key_int >= size) {
             return std::nullopt;
         }
-        return managed_bytes_opt(data_list[key_int].serialize_nonnull());
+        for (int i = 0; i < key_int; ++i) {
+            read_collection_value(in);
+        }
+        auto element = read_collection_value(in);
+        return element ? managed_bytes_opt(*element) : std::nullopt;
     } else {
         throw exceptions::invalid_request_exception(format("subscripting non-map, non-list column {}", cdef->name_as_text()));
     }
@@ -1850,6 +1862,15 @@ static managed_bytes reserialize_value(View value_bytes,
         fmt::format("Reserializing type that shouldn't need reserialization: {}", type.name()));
 }
 
+static void validate_bound_value(const bind_variable& bind_var, const cql3::raw_value_view& value) {
+    try {
+        value.validate(bind_var.receiver->type->without_reversed());
+    } catch (const marshal_exception& e) {
+        throw exceptions::invalid_request_exception(format("Exception while binding column {:s}: {:s}",
+                                                           bind_var.receiver->name->to_cql_string(), e.what()));
+    }
+}
+
 static cql3::raw_value evaluate(const bind_variable& bind_var, const evaluation_inputs& inputs) {
     if (bind_var.receiver.get() == nullptr) {
         on_internal_error(expr_logger,
@@ -1863,12 +1884,7 @@ static cql3::raw_value evaluate(const bind_variable& bind_var, const evaluation_
     }
 
     const abstract_type& value_type = bind_var.receiver->type->without_reversed();
-    try {
-        value.validate(value_type);
-    } catch (const marshal_exception& e) {
-        throw exceptions::invalid_request_exception(format("Exception while binding column {:s}: {:s}",
-                                                           bind_var.receiver->name->to_cql_string(), e.what()));
-    }
+    validate_bound_value(bind_var, value);
 
     if (value_type.bound_value_needs_to_be_reserialized()) {
         managed_bytes new_value = value.with_value([&] (const FragmentedView auto& value_bytes) {
@@ -1881,6 +1897,19 @@ static cql3::raw_value evaluate(const bind_variable& bind_var, const evaluation_
     return raw_value::make_value(value);
 }
 
+cql3::raw_value_view evaluate_to_view(const expression& e, const query_options& options, cql3::raw_value& storage) {
+    auto bind_var = as_if<bind_variable>(&e);
+    if (bind_var && bind_var->receiver && !bind_var->receiver->type->without_reversed().bound_value_needs_to_be_reserialized()) {
+        cql3::raw_value_view value = options.get_value_at(bind_var->bind_index);
+        if (!value.is_null()) {
+            validate_bound_value(*bind_var, value);
+        }
+        return value;
+    }
+    storage = evaluate(e, options);
+    return storage.view();
+}
+
 static cql3::raw_value evaluate(const tuple_constructor& tuple, const evaluation_inputs& inputs) {
     if (tuple.type.get() == nullptr) {
         on_internal_error(expr_logger,
@@ -736,6 +736,12 @@ cql3::raw_value evaluate(const expression& e, const evaluation_inputs&);
 
 cql3::raw_value evaluate(const expression& e, const query_options&);
 
+// Like evaluate(), but returns the value of a bind variable which needs no
+// reserialization as a view into the request, rather than copying it out.
+// Other expressions are evaluated into storage. The returned view is valid
+// as long as both the options and storage are.
+cql3::raw_value_view evaluate_to_view(const expression& e, const query_options&, cql3::raw_value& storage);
+
 utils::chunked_vector<managed_bytes_opt> get_list_elements(const cql3::raw_value&);
 utils::chunked_vector<managed_bytes_opt> get_set_elements(const cql3::raw_value&);
 std::vector<managed_bytes_opt> get_tuple_elements(const cql3::raw_value&, const abstract_type& type);
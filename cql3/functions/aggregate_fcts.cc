@@ -20,9 +20,17 @@
 #include "native_aggregate_function.hh"
 #include "exceptions/exceptions.hh"
 #include "utils/multiprecision_int.hh"
+#include "utils/murmur_hash.hh"
+#include "utils/streaming_histogram.hh"
+#include "sstables/hyperloglog.hh"
+#include <array>
+#include <bit>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <optional>
+#include <span>
 #include <type_traits>
 
 using namespace cql3;
@@ -34,6 +42,76 @@ namespace cql3::functions {
 }
 
 namespace {
+
+// Types whose values are aggregated in batches straight from the serialized
+// form, rather than deserialized into a data_value one by one.
+template <typename T>
+constexpr bool is_fixed_width_v = std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>
+        || std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>
+        || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <typename T>
+T read_fixed_width(bytes_view v) {
+    auto p = reinterpret_cast<const char*>(v.data());
+    if constexpr (std::is_floating_point_v<T>) {
+        using int_type = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+        return std::bit_cast<T>(read_be<int_type>(p));
+    } else {
+        return read_be<T>(p);
+    }
+}
+
+// Number of values decoded at a time by for_each_fixed_width_chunk(), small
+// enough for the decoded values to stay in L1.
+constexpr size_t fixed_width_chunk_size = 256;
+
+// Decodes the non-null values of the column into arrays of native values,
+// and calls kernel with each array, in row order, so that the kernels are
+// plain loops over contiguous values which the compiler can vectorize.
+//
+// Values which aren't sizeof(T) long (e.g. empty ones) are given to the
+// aggregate's add_input(), after the values before them, so that they are
+// handled exactly as in row-by-row aggregation.
+template <typename T, typename Kernel>
+void for_each_fixed_width_chunk(aggregate_function::aggregate& agg, const db::functions::column_vector& col, size_t rows, Kernel kernel) {
+    std::array<T, fixed_width_chunk_size> chunk;
+    auto data = col.values();
+    if (col.null_count() == 0 && data.size() == rows * sizeof(T)) {
+        // The common case: the values are a contiguous array of big-endian T.
+        for (size_t i = 0; i < rows; i += chunk.size()) {
+            auto n = std::min(chunk.size(), rows - i);
+            for (size_t j = 0; j < n; ++j) {
+                chunk[j] = read_fixed_width<T>(data.substr((i + j) * sizeof(T), sizeof(T)));
+            }
+            kernel(std::span<const T>(chunk.data(), n));
+        }
+        return;
+    }
+    size_t n = 0;
+    auto flush = [&] {
+        if (n) {
+            kernel(std::span<const T>(chunk.data(), n));
+            n = 0;
+        }
+    };
+    for (size_t i = 0; i < rows; ++i) {
+        if (col.is_null(i)) {
+            continue;
+        }
+        auto v = col[i];
+        if (v.size() == sizeof(T)) [[likely]] {
+            chunk[n++] = read_fixed_width<T>(v);
+            if (n == chunk.size()) {
+                flush();
+            }
+        } else {
+            flush();
+            agg.add_input({col.get(i)});
+        }
+    }
+    flush();
+}
+
 class impl_count_function : public aggregate_function::aggregate {
     int64_t _count = 0;
 public:
@@ -46,6 +124,9 @@ class impl_count_function : public aggregate_function::aggregate {
     virtual void add_input(const std::vector<opt_bytes>& values) override {
         ++_count;
     }
+    virtual void add_input_batch(const std::vector<const db::functions::column_vector*>& args, size_t rows) override {
+        _count += rows;
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _count = value_cast<int64_t>(long_type->deserialize(bytes_view(*acc)));
@@ -166,10 +247,45 @@ struct same_type_accumulator_for {
     }
 };
 
+// Sums decimals in a native integer while they are small, see big_decimal_sum.
+struct decimal_accumulator_for {
+    using type = big_decimal_sum;
+
+    static big_decimal narrow(const type& acc) {
+        return acc.get();
+    }
+
+    static data_value decompose_to_data_value(const type& acc) {
+        return narrow(acc);
+    }
+
+    static bytes_opt decompose(const data_value& value) {
+        return decimal_type->decompose(value);
+    }
+
+    static bytes_opt decompose(const type& acc) {
+        return decimal_type->decompose(decompose_to_data_value(acc));
+    }
+
+    static type cast_to_accumulator(const data_value& value) {
+        return type(value_cast<big_decimal>(value));
+    }
+
+    static type deserialize(const bytes_opt& acc) {
+        return cast_to_accumulator(decimal_type->deserialize(*acc));
+    }
+
+    static shared_ptr<const abstract_type> data_type() {
+        return decimal_type;
+    }
+};
+
 template <typename T>
 struct accumulator_for : public std::conditional_t<std::is_integral_v<T>,
                                                    int128_accumulator_for<T>,
-                                                   same_type_accumulator_for<T>>
+                                                   std::conditional_t<std::is_same_v<T, big_decimal>,
+                                                                      decimal_accumulator_for,
+                                                                      same_type_accumulator_for<T>>>
 { };
 
 class impl_user_aggregate : public aggregate_function::aggregate {
@@ -227,6 +343,19 @@ class impl_sum_function_for : public aggregate_function::aggregate {
         }
         _sum += value_cast<Type>(data_type_for<Type>()->deserialize(*values[0]));
     }
+    virtual void add_input_batch(const std::vector<const db::functions::column_vector*>& args, size_t rows) override {
+        if constexpr (is_fixed_width_v<Type>) {
+            for_each_fixed_width_chunk<Type>(*this, *args[0], rows, [this] (std::span<const Type> values) {
+                auto sum = _sum;
+                for (auto v : values) {
+                    sum += v;
+                }
+                _sum = sum;
+            });
+        } else {
+            aggregate::add_input_batch(args, rows);
+        }
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _sum = accumulator_for<Type>::deserialize(acc);
@@ -301,8 +430,8 @@ class impl_div_for_avg {
 template <>
 class impl_div_for_avg<big_decimal> {
 public:
-    static big_decimal div(const big_decimal& x, const int64_t y) {
-        return x.div(y, big_decimal::rounding_mode::HALF_EVEN);
+    static big_decimal div(const big_decimal_sum& x, const int64_t y) {
+        return x.get().div(y, big_decimal::rounding_mode::HALF_EVEN);
     }
 };
 
@@ -330,6 +459,20 @@ class impl_avg_function_for : public aggregate_function::aggregate {
         ++_count;
         _sum += value_cast<Type>(data_type_for<Type>()->deserialize(*values[0]));
     }
+    virtual void add_input_batch(const std::vector<const db::functions::column_vector*>& args, size_t rows) override {
+        if constexpr (is_fixed_width_v<Type>) {
+            for_each_fixed_width_chunk<Type>(*this, *args[0], rows, [this] (std::span<const Type> values) {
+                auto sum = _sum;
+                for (auto v : values) {
+                    sum += v;
+                }
+                _sum = sum;
+                _count += values.size();
+            });
+        } else {
+            aggregate::add_input_batch(args, rows);
+        }
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             data_type tuple_type = tuple_type_impl::get_instance({accumulator_for<Type>::data_type(), long_type});
@@ -474,6 +617,19 @@ class impl_max_function_for final : public aggregate_function::aggregate {
             _max = max_wrapper(*_max, val);
         }
     }
+    virtual void add_input_batch(const std::vector<const db::functions::column_vector*>& args, size_t rows) override {
+        if constexpr (is_fixed_width_v<Type>) {
+            for_each_fixed_width_chunk<Type>(*this, *args[0], rows, [this] (std::span<const Type> values) {
+                Type max = _max ? *_max : values[0];
+                for (auto v : values) {
+                    max = max_wrapper(max, v);
+                }
+                _max = max;
+            });
+        } else {
+            aggregate::add_input_batch(args, rows);
+        }
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _max = value_cast<typename aggregate_type_for<Type>::type>(data_type_for<Type>()->deserialize(*acc));
@@ -615,6 +771,19 @@ class impl_min_function_for final : public aggregate_function::aggregate {
             _min = min_wrapper(*_min, val);
         }
     }
+    virtual void add_input_batch(const std::vector<const db::functions::column_vector*>& args, size_t rows) override {
+        if constexpr (is_fixed_width_v<Type>) {
+            for_each_fixed_width_chunk<Type>(*this, *args[0], rows, [this] (std::span<const Type> values) {
+                Type min = _min ? *_min : values[0];
+                for (auto v : values) {
+                    min = min_wrapper(min, v);
+                }
+                _min = min;
+            });
+        } else {
+            aggregate::add_input_batch(args, rows);
+        }
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _min = value_cast<typename aggregate_type_for<Type>::type>(data_type_for<Type>()->deserialize(*acc));
@@ -729,6 +898,9 @@ class impl_count_function_for final : public aggregate_function::aggregate {
         }
         ++_count;
     }
+    virtual void add_input_batch(const std::vector<const db::functions::column_vector*>& args, size_t rows) override {
+        _count += rows - args[0]->null_count();
+    }
     virtual void set_accumulator(const opt_bytes& acc) override {
         if (acc) {
             _count = value_cast<int64_t>(long_type->deserialize(bytes_view(*acc)));
@@ -772,6 +944,218 @@ template <typename Type>
 static shared_ptr<aggregate_function> make_count_function() {
     return make_shared<count_function_for<Type>>();
 }
+
+// HyperLogLog with 2^12 registers: a standard error of about 1.6%, for
+// 4KB of state per aggregate.
+constexpr uint8_t approx_count_distinct_precision = 12;
+
+class impl_approx_count_distinct_function : public aggregate_function::aggregate {
+protected:
+    hll::HyperLogLog _hll{approx_count_distinct_precision};
+
+    static hll::HyperLogLog deserialize(const bytes& acc) {
+        return hll::HyperLogLog::from_bytes(reinterpret_cast<const uint8_t*>(acc.data()), acc.size());
+    }
+    void offer(bytes_view v) {
+        _hll.offer_hashed(utils::murmur_hash::hash2_64(v, 0));
+    }
+public:
+    virtual void reset() override {
+        _hll = hll::HyperLogLog(approx_count_distinct_precision);
+    }
+    virtual opt_bytes compute() override {
+        return long_type->decompose(int64_t(std::llround(_hll.estimate())));
+    }
+    virtual void add_input(const std::vector<opt_bytes>& values) override {
+        if (values[0]) {
+            offer(*values[0]);
+        }
+    }
+    virtual void add_input_batch(const std::vector<const db::functions::column_vector*>& args, size_t rows) override {
+        auto& col = *args[0];
+        for (size_t i = 0; i < rows; ++i) {
+            if (!col.is_null(i)) {
+                offer(col[i]);
+            }
+        }
+    }
+    virtual void set_accumulator(const opt_bytes& acc) override {
+        if (acc) {
+            _hll = deserialize(*acc);
+        } else {
+            reset();
+        }
+    }
+    virtual opt_bytes get_accumulator() const override {
+        auto buf = _hll.get_bytes();
+        return bytes(reinterpret_cast<const int8_t*>(buf.get()), buf.size());
+    }
+    virtual void reduce(const opt_bytes& acc) override {
+        if (acc) {
+            _hll.merge(deserialize(*acc));
+        }
+    }
+};
+
+class impl_reducible_approx_count_distinct_function : public impl_approx_count_distinct_function {
+public:
+    virtual opt_bytes compute() override {
+        return get_accumulator();
+    }
+};
+
+/// Estimates the number of distinct non-null values, with HyperLogLog.
+/// The values are hashed in their serialized form, so it accepts any type.
+class approx_count_distinct_function : public native_aggregate_function {
+public:
+    approx_count_distinct_function(data_type arg_type, data_type return_type = long_type)
+            : native_aggregate_function(APPROX_COUNT_DISTINCT_FUNCTION_NAME, std::move(return_type), { std::move(arg_type) }) {}
+    virtual bool is_reducible() const override {
+        return true;
+    }
+    virtual std::unique_ptr<aggregate> new_aggregate() override {
+        return std::make_unique<impl_approx_count_distinct_function>();
+    }
+    virtual ::shared_ptr<aggregate_function> reducible_aggregate_function() override {
+        class reducible_approx_count_distinct_function : public approx_count_distinct_function {
+        public:
+            reducible_approx_count_distinct_function(data_type arg_type)
+                    : approx_count_distinct_function(std::move(arg_type), bytes_type) {}
+            virtual std::unique_ptr<aggregate> new_aggregate() override {
+                return std::make_unique<impl_reducible_approx_count_distinct_function>();
+            }
+        };
+        return ::make_shared<reducible_approx_count_distinct_function>(arg_types()[0]);
+    }
+};
+
+// The number of bins of the histograms of approx_percentile().
+constexpr uint32_t approx_percentile_bins = 100;
+
+// The state of approx_percentile() is serialized as the percentile (NaN
+// until the first value), followed by the bins of the histogram:
+//
+//   percentile (8) | bins count (4) | (point (8) | count (8))*
+template <typename Type>
+class impl_approx_percentile_function : public aggregate_function::aggregate {
+protected:
+    double _percentile = std::numeric_limits<double>::quiet_NaN();
+    utils::streaming_histogram _histogram{approx_percentile_bins};
+
+    void set_percentile(const opt_bytes& p) {
+        auto v = p && !p->empty() ? value_cast<double>(double_type->deserialize(*p)) : std::numeric_limits<double>::quiet_NaN();
+        if (!(v >= 0 && v <= 1)) {
+            throw exceptions::invalid_request_exception(format("{}() requires a percentile between 0 and 1", APPROX_PERCENTILE_FUNCTION_NAME));
+        }
+        _percentile = v;
+    }
+    void merge(const bytes& acc) {
+        auto p = reinterpret_cast<const char*>(acc.data());
+        auto end = p + acc.size();
+        auto read_double = [&] {
+            return std::bit_cast<double>(read_be<uint64_t>(p));
+        };
+        if (acc.size() < sizeof(uint64_t) + sizeof(uint32_t)) {
+            throw std::runtime_error(format("{}(): truncated state", APPROX_PERCENTILE_FUNCTION_NAME));
+        }
+        auto percentile = read_double();
+        p += sizeof(uint64_t);
+        auto bins = read_be<uint32_t>(p);
+        p += sizeof(uint32_t);
+        if (size_t(end - p) != bins * 2 * sizeof(uint64_t)) {
+            throw std::runtime_error(format("{}(): truncated state", APPROX_PERCENTILE_FUNCTION_NAME));
+        }
+        if (!std::isnan(percentile)) {
+            _percentile = percentile;
+        }
+        for (; p != end; p += 2 * sizeof(uint64_t)) {
+            _histogram.update(read_double(), read_be<uint64_t>(p + sizeof(uint64_t)));
+        }
+    }
+public:
+    virtual void reset() override {
+        _percentile = std::numeric_limits<double>::quiet_NaN();
+        _histogram = utils::streaming_histogram(approx_percentile_bins);
+    }
+    virtual opt_bytes compute() override {
+        if (_histogram.bin.empty()) {
+            return {};
+        }
+        return double_type->decompose(_histogram.quantile(_percentile));
+    }
+    virtual void add_input(const std::vector<opt_bytes>& values) override {
+        if (std::isnan(_percentile)) {
+            set_percentile(values[1]);
+        }
+        if (!values[0] || values[0]->empty()) {
+            return;
+        }
+        _histogram.update(double(value_cast<Type>(data_type_for<Type>()->deserialize(*values[0]))));
+    }
+    virtual void set_accumulator(const opt_bytes& acc) override {
+        reset();
+        if (acc) {
+            merge(*acc);
+        }
+    }
+    virtual opt_bytes get_accumulator() const override {
+        bytes ret(bytes::initialized_later(), sizeof(uint64_t) + sizeof(uint32_t) + _histogram.bin.size() * 2 * sizeof(uint64_t));
+        auto p = reinterpret_cast<char*>(ret.data());
+        write_be<uint64_t>(p, std::bit_cast<uint64_t>(_percentile));
+        p += sizeof(uint64_t);
+        write_be<uint32_t>(p, _histogram.bin.size());
+        p += sizeof(uint32_t);
+        for (auto& [point, count] : _histogram.bin) {
+            write_be<uint64_t>(p, std::bit_cast<uint64_t>(point));
+            write_be<uint64_t>(p + sizeof(uint64_t), count);
+            p += 2 * sizeof(uint64_t);
+        }
+        return ret;
+    }
+    virtual void reduce(const opt_bytes& acc) override {
+        if (acc) {
+            merge(*acc);
+        }
+    }
+};
+
+template <typename Type>
+class impl_reducible_approx_percentile_function : public impl_approx_percentile_function<Type> {
+public:
+    virtual bytes_opt compute() override {
+        return this->get_accumulator();
+    }
+};
+
+/// Estimates the given percentile (between 0 and 1) of the non-null values,
+/// with a streaming histogram, interpolating between its bins.
+template <typename Type>
+class approx_percentile_function_for : public native_aggregate_function {
+public:
+    approx_percentile_function_for(data_type return_type = double_type)
+            : native_aggregate_function(APPROX_PERCENTILE_FUNCTION_NAME, std::move(return_type), { data_type_for<Type>(), double_type }) {}
+    virtual bool is_reducible() const override {
+        return true;
+    }
+    virtual std::unique_ptr<aggregate> new_aggregate() override {
+        return std::make_unique<impl_approx_percentile_function<Type>>();
+    }
+    virtual ::shared_ptr<aggregate_function> reducible_aggregate_function() override {
+        class reducible_approx_percentile_function : public approx_percentile_function_for<Type> {
+        public:
+            reducible_approx_percentile_function() : approx_percentile_function_for<Type>(bytes_type) {}
+            virtual std::unique_ptr<aggregate> new_aggregate() override {
+                return std::make_unique<impl_reducible_approx_percentile_function<Type>>();
+            }
+        };
+        return ::make_shared<reducible_approx_percentile_function>();
+    }
+};
+
+template <typename Type>
+static shared_ptr<aggregate_function> make_approx_percentile_function() {
+    return make_shared<approx_percentile_function_for<Type>>();
+}
 }
 
 // Drops the first arg type from the types declaration (which denotes the accumulator)
@@ -858,6 +1242,16 @@ aggregate_fcts::make_min_dynamic_function(data_type io_type) {
     return make_shared<min_dynamic_function>(io_type);
 }
 
+shared_ptr<aggregate_function>
+aggregate_fcts::make_approx_count_distinct_function(data_type arg_type) {
+    return make_shared<approx_count_distinct_function>(std::move(arg_type));
+}
+
+bool
+aggregate_fcts::is_approximate_aggregate(const function_name& name) {
+    return name.name == APPROX_COUNT_DISTINCT_FUNCTION_NAME || name.name == APPROX_PERCENTILE_FUNCTION_NAME;
+}
+
 void cql3::functions::add_agg_functions(declared_t& funcs) {
     auto declare = [&funcs] (shared_ptr<function> f) { funcs.emplace(f->name(), f); };
 
@@ -951,4 +1345,16 @@ void cql3::functions::add_agg_functions(declared_t& funcs) {
     declare(make_avg_function<double>());
     declare(make_avg_function<utils::multiprecision_int>());
     declare(make_avg_function<big_decimal>());
+
+    for (auto& type : {byte_type, short_type, int32_type, long_type, varint_type, decimal_type, float_type, double_type,
+            utf8_type, ascii_type, simple_date_type, timestamp_type, timeuuid_type, time_type, uuid_type, bytes_type,
+            boolean_type, inet_addr_type}) {
+        declare(make_approx_count_distinct_function(type));
+    }
+    declare(make_approx_percentile_function<int8_t>());
+    declare(make_approx_percentile_function<int16_t>());
+    declare(make_approx_percentile_function<int32_t>());
+    declare(make_approx_percentile_function<int64_t>());
+    declare(make_approx_percentile_function<float>());
+    declare(make_approx_percentile_function<double>());
 }
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "aggregate_function.hh"
+#include "function_name.hh"
 
 namespace cql3 {
 namespace functions {
@@ -19,6 +20,8 @@ namespace functions {
 namespace aggregate_fcts {
 
 static const sstring COUNT_ROWS_FUNCTION_NAME = "countRows";
+static const sstring APPROX_COUNT_DISTINCT_FUNCTION_NAME = "approximate_count_distinct";
+static const sstring APPROX_PERCENTILE_FUNCTION_NAME = "approx_percentile";
 
 /// The function used to count the number of rows of a result set. This function is called when COUNT(*) or COUNT(1)
 /// is specified.
@@ -32,6 +35,16 @@ make_max_dynamic_function(data_type io_type);
 /// The same as `make_min_function()' but with type provided in runtime.
 shared_ptr<aggregate_function>
 make_min_dynamic_function(data_type io_type);
+
+/// The function estimating the number of distinct non-null values of a column of the given type,
+/// approximate_count_distinct(x).
+shared_ptr<aggregate_function>
+make_approx_count_distinct_function(data_type arg_type);
+
+/// Whether the function is one of the approximate aggregates, approximate_count_distinct() and
+/// approx_percentile(), which nodes can compute since the APPROXIMATE_AGGREGATES feature.
+bool
+is_approximate_aggregate(const function_name& name);
 }
 }
 }
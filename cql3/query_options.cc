@@ -95,15 +95,20 @@ query_options::query_options(db::consistency_level cl, cql3::raw_value_vector_wi
 {
 }
 
+query_options::query_options(query_options&& qo, lw_shared_ptr<service::pager::paging_state> paging_state)
+        : query_options(qo._cql_config,
+        qo._consistency,
+        std::move(qo._names),
+        std::move(qo._values),
+        std::move(qo._value_views),
+        std::move(qo._unset),
+        qo._skip_metadata,
+        query_options::specific_options{qo._options.page_size, paging_state, qo._options.serial_consistency, qo._options.timestamp}) {
+
+}
+
 query_options::query_options(std::unique_ptr<query_options> qo, lw_shared_ptr<service::pager::paging_state> paging_state)
-        : query_options(qo->_cql_config,
-        qo->_consistency,
-        std::move(qo->_names),
-        std::move(qo->_values),
-        std::move(qo->_value_views),
-        std::move(qo->_unset),
-        qo->_skip_metadata,
-        query_options::specific_options{qo->_options.page_size, paging_state, qo->_options.serial_consistency, qo->_options.timestamp}) {
+        : query_options(std::move(*qo), std::move(paging_state)) {
 
 }
 
@@ -10,11 +10,13 @@
 
 #include "cql3/query_processor.hh"
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/metrics.hh>
 
 #include "service/storage_proxy.hh"
 #include "cql3/CqlParser.hpp"
 #include "cql3/error_collector.hh"
+#include "cql3/simple_statement_parser.hh"
 #include "cql3/statements/batch_statement.hh"
 #include "cql3/statements/modification_statement.hh"
 #include "cql3/util.hh"
@@ -90,6 +92,11 @@ query_processor::query_processor(service::storage_proxy& proxy, service::forward
         "statements_prepared",
         _stats.prepare_invocations,
         sm::description("Counts the total number of parsed CQL requests.")));
+    qp_group.push_back(sm::make_counter(
+        "auto_prepared_statements_executed",
+        _stats.auto_prepared_executions,
+        sm::description("Counts the unprepared CQL requests executed as prepared statements, with their constants "
+                        "replaced by bind markers.")));
     for (auto cl = size_t(clevel::MIN_VALUE); cl <= size_t(clevel::MAX_VALUE); ++cl) {
         qp_group.push_back(
             sm::make_counter(
@@ -465,6 +472,18 @@ future<> query_processor::stop() {
 future<::shared_ptr<result_message>>
 query_processor::execute_direct_without_checking_exception_message(const sstring_view& query_string, service::query_state& query_state, query_options& options) {
     log.trace("execute_direct: \"{}\"", query_string);
+    if (options.get_values_count() == 0 && _db.get_config().auto_prepare_statements()) {
+        if (auto normalized = normalize_simple_statement(query_string)) {
+            auto key = compute_id(normalized->key, query_state.get_client_state().get_raw_keyspace());
+            auto prepared = _prepared_cache.find(key);
+            // A statement is checked to be one of the simple ones only
+            // before its normalized form is prepared. Afterwards, the
+            // key is enough.
+            if (prepared || try_parse_simple_statement(query_string)) {
+                return execute_auto_prepared(std::move(*normalized), std::move(key), std::move(prepared), query_state, options);
+            }
+        }
+    }
     tracing::trace(query_state.get_trace_state(), "Parsing a statement");
     auto p = get_statement(query_string, query_state.get_client_state());
     auto cql_statement = p->statement;
@@ -495,6 +514,49 @@ query_processor::execute_direct_without_checking_exception_message(const sstring
     });
 }
 
+future<::shared_ptr<result_message>>
+query_processor::execute_auto_prepared(
+        normalized_statement normalized,
+        prepared_cache_key_type key,
+        statements::prepared_statement::checked_weak_ptr prepared,
+        service::query_state& query_state,
+        const query_options& options) {
+    auto& client_state = query_state.get_client_state();
+    if (!prepared) {
+        tracing::trace(query_state.get_trace_state(), "Preparing a statement with its constants replaced by bind markers");
+        try {
+            prepared = co_await _prepared_cache.get(key, [this, &normalized, &client_state] {
+                return make_ready_future<std::unique_ptr<statements::prepared_statement>>(get_statement(normalized.query, client_state));
+            });
+        } catch (prepared_statements_cache::statement_is_too_big&) {
+            throw prepared_statement_is_too_big(normalized.query);
+        }
+    }
+    ++_stats.auto_prepared_executions;
+    auto statement = prepared->statement;
+    const auto warnings = prepared->warnings;
+    assert(prepared->bound_names.size() == normalized.values.size());
+    // Constants are validated against their receivers when prepared, as
+    // they would be when preparing the unprepared statement itself.
+    std::vector<cql3::raw_value> values;
+    values.reserve(normalized.values.size());
+    for (size_t i = 0; i < normalized.values.size(); ++i) {
+        auto& receiver = prepared->bound_names[i];
+        auto value = expr::prepare_expression(normalized.values[i], _db, receiver->ks_name, nullptr, receiver);
+        values.push_back(expr::evaluate(value, query_options::DEFAULT));
+    }
+    query_options bound_options(options.get_cql_config(), options.get_consistency(), std::nullopt,
+            raw_value_vector_with_unset(std::move(values)), options.skip_metadata(), options.get_specific_options());
+
+    tracing::trace(query_state.get_trace_state(), "Processing a statement");
+    co_await statement->check_access(*this, client_state);
+    auto msg = co_await process_authorized_statement(std::move(statement), query_state, bound_options);
+    for (const auto& w : warnings) {
+        msg->add_warning(w);
+    }
+    co_return msg;
+}
+
 future<::shared_ptr<result_message>>
 query_processor::execute_prepared_without_checking_exception_message(
         statements::prepared_statement::checked_weak_ptr prepared,
@@ -600,6 +662,9 @@ query_processor::get_statement(const sstring_view& query, const service::client_
 std::unique_ptr<raw::parsed_statement>
 query_processor::parse_statement(const sstring_view& query) {
     try {
+        if (auto statement = try_parse_simple_statement(query)) {
+            return statement;
+        }
         auto statement = util::do_with_parser(query,  std::mem_fn(&cql3_parser::CqlParser::query));
         if (!statement) {
             throw exceptions::syntax_exception("Parsing failed");
@@ -50,6 +50,7 @@ class parsed_statement;
 
 class untyped_result_set;
 class untyped_result_set_row;
+struct normalized_statement;
 
 /*!
  * \brief to allow paging, holds
@@ -103,6 +104,7 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
 
     struct stats {
         uint64_t prepare_invocations = 0;
+        uint64_t auto_prepared_executions = 0;
         uint64_t queries_by_cl[size_t(db::consistency_level::MAX_VALUE) + 1] = {};
     } _stats;
 
@@ -391,6 +393,16 @@ class query_processor : public seastar::peering_sharded_service<query_processor>
             const std::string_view& query,
             const service::client_state& client_state);
 
+    // Executes an unprepared statement with the prepared statement of its
+    // normalized form, preparing it if it isn't cached yet.
+    future<::shared_ptr<cql_transport::messages::result_message>>
+    execute_auto_prepared(
+            normalized_statement normalized,
+            prepared_cache_key_type key,
+            statements::prepared_statement::checked_weak_ptr prepared,
+            service::query_state& query_state,
+            const query_options& options);
+
     friend class migration_subscriber;
 
     shared_ptr<cql_transport::messages::result_message> bounce_to_shard(unsigned shard, cql3::computed_function_values cached_fn_calls);
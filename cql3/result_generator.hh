@@ -14,6 +14,23 @@
 namespace cql3 {
 class untyped_result_set;
 
+// A visitor may also accept values which, unlike those passed to accept_value(),
+// remain valid as long as the visited result is alive. This allows referencing
+// them instead of copying.
+template<typename Visitor>
+concept StableValueVisitor = requires(Visitor& visitor) {
+    visitor.accept_stable_value(std::optional<query::result_bytes_view>());
+};
+
+template<typename Visitor>
+void accept_stable_value(Visitor& visitor, std::optional<query::result_bytes_view> value) {
+    if constexpr (StableValueVisitor<Visitor>) {
+        visitor.accept_stable_value(value);
+    } else {
+        visitor.accept_value(value);
+    }
+}
+
 class result_generator {
     schema_ptr _schema;
     foreign_ptr<lw_shared_ptr<query::result>> _result;
@@ -33,11 +50,12 @@ class result_generator {
         const selection::selection& _selection;
     private:
         void accept_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
+            // Cell values point into the query result, so they are stable.
             if (def.is_multi_cell()) {
-                _visitor.accept_value(i.next_collection_cell());
+                accept_stable_value(_visitor, i.next_collection_cell());
             } else {
                 auto cell = i.next_atomic_cell();
-                _visitor.accept_value(cell ? std::optional<query::result_bytes_view>(cell->value()) : std::optional<query::result_bytes_view>());
+                accept_stable_value(_visitor, cell ? std::optional<query::result_bytes_view>(cell->value()) : std::optional<query::result_bytes_view>());
             }
         }
     public:
@@ -187,7 +187,7 @@ class result_set {
             visitor.start_row();
             for (auto i = 0u; i < column_count; i++) {
                 auto& cell = row[i];
-                visitor.accept_value(cell ? std::optional<query::result_bytes_view>(*cell) : std::optional<query::result_bytes_view>());
+                accept_stable_value(visitor, cell ? std::optional<query::result_bytes_view>(*cell) : std::optional<query::result_bytes_view>());
             }
             visitor.end_row();
         }
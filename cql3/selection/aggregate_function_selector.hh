@@ -8,6 +8,7 @@
  */
 
 #include "abstract_function_selector.hh"
+#include "simple_selector.hh"
 #include "cql3/functions/aggregate_function.hh"
 
 #pragma once
@@ -18,6 +19,7 @@ namespace selection {
 
 class aggregate_function_selector : public abstract_function_selector_for<functions::aggregate_function> {
     std::unique_ptr<functions::aggregate_function::aggregate> _aggregate;
+    std::vector<const db::functions::column_vector*> _batch_args;
 public:
     virtual bool is_aggregate() const override {
         return true;
@@ -35,6 +37,15 @@ class aggregate_function_selector : public abstract_function_selector_for<functi
         _aggregate->add_input(_args);
     }
 
+    virtual void add_input_batch(const db::functions::column_batch& batch) override {
+        // The arguments are simple selectors, so they are just columns of the batch.
+        _batch_args.clear();
+        for (auto&& s : _arg_selectors) {
+            _batch_args.push_back(&batch.column(dynamic_cast<const simple_selector&>(*s).idx()));
+        }
+        _aggregate->add_input_batch(_batch_args, batch.rows());
+    }
+
     virtual bytes_opt get_output() override {
         return _aggregate->compute();
     }
@@ -189,6 +189,18 @@ class selection_with_processing : public selection {
         return _factories->get_reductions();
     }
 
+    virtual bool is_reducible_with_group_by(const std::vector<sstring>& group_by_columns) const override {
+        return _factories->does_grouped_reduction(group_by_columns);
+    }
+
+    virtual std::vector<size_t> get_grouped_reduction_layout(const std::vector<sstring>& group_by_columns) const override {
+        return _factories->get_grouped_reduction_layout(group_by_columns);
+    }
+
+    virtual bool supports_columnar_aggregation() const override {
+        return _factories->does_columnar_aggregation();
+    }
+
 protected:
     class selectors_with_processing : public selectors {
     private:
@@ -230,6 +242,12 @@ class selection_with_processing : public selection {
                 s->add_input(rs);
             }
         }
+
+        virtual void add_input_batch(const db::functions::column_batch& batch) override {
+            for (auto&& s : _selectors) {
+                s->add_input_batch(batch);
+            }
+        }
     };
 
     std::unique_ptr<selectors> new_selectors() const override  {
@@ -307,9 +325,16 @@ result_set_builder::result_set_builder(const selection& s, gc_clock::time_point
     if (s._collect_TTLs) {
         _ttls.resize(s._columns.size(), 0);
     }
+    if (_group_by_cell_indices.empty() && s.supports_columnar_aggregation()) {
+        _batch.emplace(s._columns.size());
+    }
 }
 
 void result_set_builder::add_empty() {
+    if (_batch) {
+        _batch->add_null();
+        return;
+    }
     current->emplace_back();
     if (!_timestamps.empty()) {
         _timestamps[current->size() - 1] = api::missing_timestamp;
@@ -320,10 +345,23 @@ void result_set_builder::add_empty() {
 }
 
 void result_set_builder::add(bytes_opt value) {
+    if (_batch) {
+        if (value) {
+            _batch->add(bytes_view(*value));
+        } else {
+            _batch->add_null();
+        }
+        return;
+    }
     current->emplace_back(std::move(value));
 }
 
 void result_set_builder::add(const column_definition& def, const query::result_atomic_cell_view& c) {
+    if (_batch) {
+        // Copies the fragments straight into the batch, without linearizing the value first.
+        _batch->add(c.value());
+        return;
+    }
     current->emplace_back(get_value(def.type, c));
     if (!_timestamps.empty()) {
         _timestamps[current->size() - 1] = c.timestamp();
@@ -339,6 +377,10 @@ void result_set_builder::add(const column_definition& def, const query::result_a
 }
 
 void result_set_builder::add_collection(const column_definition& def, bytes_view c) {
+    if (_batch) {
+        _batch->add(c);
+        return;
+    }
     current->emplace_back(to_bytes(c));
     // timestamps, ttls meaningless for collections
 }
@@ -367,6 +409,13 @@ void result_set_builder::flush_selectors() {
     _selectors->reset();
 }
 
+void result_set_builder::flush_batch() {
+    if (_batch->rows()) {
+        _selectors->add_input_batch(*_batch);
+        _batch->clear();
+    }
+}
+
 void result_set_builder::process_current_row(bool more_rows_coming) {
     if (!current) {
         return;
@@ -384,6 +433,13 @@ void result_set_builder::process_current_row(bool more_rows_coming) {
 }
 
 void result_set_builder::new_row() {
+    if (_batch) {
+        if (_batch->full()) {
+            flush_batch();
+        }
+        _batch->start_row();
+        return;
+    }
     process_current_row(/*more_rows_coming=*/true);
     // FIXME: we use optional<> here because we don't have an end_row() signal
     //        instead, !current means that new_row has never been called, so this
@@ -392,6 +448,12 @@ void result_set_builder::new_row() {
 }
 
 std::unique_ptr<result_set> result_set_builder::build() {
+    if (_batch) {
+        // Aggregation without GROUP BY always yields a single row.
+        flush_batch();
+        _result_set->add_row(_selectors->get_output_row());
+        return std::move(_result_set);
+    }
     process_current_row(/*more_rows_coming=*/false);
     if (_result_set->empty() && _selectors->is_aggregate()) {
         _result_set->add_row(_selectors->get_output_row());
@@ -429,17 +491,24 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
         return false;
     }
 
+    // Computed once per row, when first needed.
+    std::optional<std::vector<managed_bytes_opt>> static_and_regular_columns;
+    auto get_static_and_regular_columns = [&] () -> const std::vector<managed_bytes_opt>* {
+        if (!static_and_regular_columns) {
+            static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
+        }
+        return &*static_and_regular_columns;
+    };
+
     const expr::expression& clustering_columns_restrictions = _restrictions->get_clustering_columns_restrictions();
     if (expr::contains_multi_column_restriction(clustering_columns_restrictions)) {
         clustering_key_prefix ckey = clustering_key_prefix::from_exploded(clustering_key);
-        // FIXME: push to upper layer so it happens once per row
-        auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
         bool multi_col_clustering_satisfied = expr::is_satisfied_by(
                 clustering_columns_restrictions,
                 expr::evaluation_inputs{
                     .partition_key = &partition_key,
                     .clustering_key = &clustering_key,
-                    .static_and_regular_columns = &static_and_regular_columns,
+                    .static_and_regular_columns = get_static_and_regular_columns(),
                     .selection = &selection,
                     .options = &_options,
                 });
@@ -464,14 +533,12 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
                 continue;
             }
             const expr::expression& single_col_restriction = restr_it->second;
-            // FIXME: push to upper layer so it happens once per row
-            auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
             bool regular_restriction_matches = expr::is_satisfied_by(
                     single_col_restriction,
                     expr::evaluation_inputs{
                         .partition_key = &partition_key,
                         .clustering_key = &clustering_key,
-                        .static_and_regular_columns = &static_and_regular_columns,
+                        .static_and_regular_columns = get_static_and_regular_columns(),
                         .selection = &selection,
                         .options = &_options,
                     });
@@ -482,10 +549,11 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
             }
             break;
         case column_kind::partition_key: {
-            if (_skip_pk_restrictions) {
+            // The partition key is the same for all rows of the partition.
+            if (_skip_pk_restrictions || _current_partition_key_matches) {
                 continue;
             }
-            auto partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
+            const expr::single_column_restrictions_map& partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
             auto restr_it = partition_key_restrictions_map.find(cdef);
             if (restr_it == partition_key_restrictions_map.end()) {
                 continue;
@@ -536,6 +604,7 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
             break;
         }
     }
+    _current_partition_key_matches = true;
     return true;
 }
 
@@ -560,6 +629,7 @@ bool result_set_builder::restrictions_filter::operator()(const selection& select
 
 void result_set_builder::restrictions_filter::reset(const partition_key* key) {
     _current_partition_key_does_not_match = false;
+    _current_partition_key_matches = false;
     _current_static_row_does_not_match = false;
     _rows_dropped = 0;
     _per_partition_remaining = _per_partition_limit;
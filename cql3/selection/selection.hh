@@ -15,6 +15,7 @@
 #include "query-result-reader.hh"
 #include "cql3/column_specification.hh"
 #include "cql3/selection/selector.hh"
+#include "db/functions/column_batch.hh"
 #include "exceptions/exceptions.hh"
 #include "unimplemented.hh"
 #include <seastar/core/thread.hh>
@@ -51,6 +52,14 @@ class selectors {
     */
     virtual void add_input_row(result_set_builder& rs) = 0;
 
+    /**
+     * Adds a batch of rows, stored column by column. Only supported if the selection
+     * supports_columnar_aggregation().
+     */
+    virtual void add_input_batch(const db::functions::column_batch& batch) {
+        throw std::runtime_error("selectors don't support columnar input");
+    }
+
     virtual std::vector<bytes_opt> get_output_row() = 0;
 
     virtual void reset() = 0;
@@ -148,6 +157,16 @@ class selection {
 
     virtual query::forward_request::reductions_info get_reductions() const {return {{}, {}};}
 
+    virtual bool is_reducible_with_group_by(const std::vector<sstring>& group_by_columns) const {return false;}
+
+    virtual std::vector<size_t> get_grouped_reduction_layout(const std::vector<sstring>& group_by_columns) const {return {};}
+
+    /**
+     * Checks if all selectors are aggregates of the selected columns, so that rows can be
+     * gathered into column batches and aggregated a batch at a time.
+     */
+    virtual bool supports_columnar_aggregation() const {return false;}
+
     /**
      * Checks that selectors are either all aggregates or that none of them is.
      *
@@ -186,6 +205,9 @@ class result_set_builder {
     const std::vector<size_t> _group_by_cell_indices; ///< Indices in \c current of cells holding GROUP BY values.
     std::vector<bytes_opt> _last_group; ///< Previous row's group: all of GROUP BY column values.
     bool _group_began; ///< Whether a group began being formed.
+    /// If set, rows are gathered here instead of in \c current, and given to the selectors a batch
+    /// at a time (see selection::supports_columnar_aggregation()).
+    std::optional<db::functions::column_batch> _batch;
 public:
     std::optional<std::vector<bytes_opt>> current;
 private:
@@ -219,6 +241,7 @@ class result_set_builder {
         const bool _skip_pk_restrictions;
         const bool _skip_ck_restrictions;
         mutable bool _current_partition_key_does_not_match = false;
+        mutable bool _current_partition_key_matches = false;
         mutable bool _current_static_row_does_not_match = false;
         mutable uint64_t _rows_dropped = 0;
         mutable uint64_t _remaining;
@@ -378,6 +401,9 @@ class result_set_builder {
     /// Gets output row from _selectors and resets them.
     void flush_selectors();
 
+    /// Gives the rows gathered in _batch to _selectors and clears it.
+    void flush_batch();
+
     /// Updates _last_group from the \c current row.
     void update_last_group();
 };
@@ -17,6 +17,10 @@
 #include "schema_fwd.hh"
 #include "counters.hh"
 
+namespace db::functions {
+class column_batch;
+}
+
 namespace cql3 {
 
 namespace selection {
@@ -43,6 +47,16 @@ class selector : public assignment_testable {
      */
     virtual void add_input(result_set_builder& rs) = 0;
 
+    /**
+     * Add a batch of rows, stored column by column. Only supported by aggregates whose arguments are all
+     * simple selectors (see <code>selector_factories::does_columnar_aggregation()</code>).
+     *
+     * @param batch the rows, with the same columns as <code>result_set_builder::current</code>
+     */
+    virtual void add_input_batch(const db::functions::column_batch& batch) {
+        throw std::runtime_error("selector doesn't support columnar input");
+    }
+
     /**
      * Returns the selector output.
      *
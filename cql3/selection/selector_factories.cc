@@ -55,6 +55,33 @@ std::vector<::shared_ptr<selector>> selector_factories::new_instances() const {
     return r;
 }
 
+bool selector_factories::does_grouped_reduction(const std::vector<sstring>& group_by_columns) const {
+    return does_aggregation() && std::all_of(_factories.cbegin(), _factories.cend(), [&] (const ::shared_ptr<selector::factory>& factory) {
+        if (factory->is_simple_selector_factory()) {
+            return std::find(group_by_columns.begin(), group_by_columns.end(), factory->column_name()) != group_by_columns.end();
+        }
+        return factory->is_reducible_selector_factory() && factory->contains_only_simple_arguments();
+    });
+}
+
+std::vector<size_t> selector_factories::get_grouped_reduction_layout(const std::vector<sstring>& group_by_columns) const {
+    std::vector<size_t> r;
+    r.reserve(_factories.size());
+    size_t next_reduction = group_by_columns.size();
+    for (auto&& f : _factories) {
+        if (f->is_simple_selector_factory()) {
+            auto it = std::find(group_by_columns.begin(), group_by_columns.end(), f->column_name());
+            if (it == group_by_columns.end()) {
+                throw std::runtime_error(format("Column {} is not in GROUP BY", f->column_name()));
+            }
+            r.push_back(std::distance(group_by_columns.begin(), it));
+        } else {
+            r.push_back(next_reduction++);
+        }
+    }
+    return r;
+}
+
 std::vector<sstring> selector_factories::get_column_names() const {
     std::vector<sstring> r;
     r.reserve(_factories.size());
@@ -130,10 +130,38 @@ class selector_factories {
         });
     }
 
+    /**
+     * Whether all selectors are aggregates of the selected columns, with no other processing,
+     * so that rows can be fed to them in column batches (see selector::add_input_batch()).
+     */
+    bool does_columnar_aggregation() const {
+        return !_factories.empty() && _number_of_factories_for_post_processing == 0
+                && std::all_of(_factories.cbegin(), _factories.cend(), [] (const ::shared_ptr<selector::factory>& factory) {
+            return factory->is_aggregate_selector_factory() && factory->contains_only_simple_arguments();
+        });
+    }
+
+    /**
+     * Like does_reduction(), but with GROUP BY: every selector is either a reducible aggregate,
+     * or selects one of the GROUP BY columns, which is the same in all rows of a group.
+     */
+    bool does_grouped_reduction(const std::vector<sstring>& group_by_columns) const;
+
+    /**
+     * For a reduction with GROUP BY, whose result for each group is the values of the GROUP BY
+     * columns followed by the results of get_reductions(), returns the index in such a result
+     * of the output value of each selector.
+     */
+    std::vector<size_t> get_grouped_reduction_layout(const std::vector<sstring>& group_by_columns) const;
+
+    // Selectors of columns have no reduction, they are handled by GROUP BY (see does_grouped_reduction()).
     query::forward_request::reductions_info get_reductions() const {
         std::vector<query::forward_request::reduction_type> types;
         std::vector<query::forward_request::aggregation_info> infos;
         for (const auto& factory: _factories) {
+            if (factory->is_simple_selector_factory()) {
+                continue;
+            }
             auto r = factory->get_reduction();
             if (!r) {
                 throw std::runtime_error(format("Column {} doesn't have reduction type", factory->column_name()));
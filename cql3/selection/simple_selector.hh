@@ -87,6 +87,11 @@ class simple_selector : public selector {
         return _type;
     }
 
+    /// Index of the selected column in result_set_builder::current.
+    uint32_t idx() const {
+        return _idx;
+    }
+
     virtual sstring assignment_testable_source_context() const override {
         return _column_name;
     }
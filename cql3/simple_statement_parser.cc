@@ -0,0 +1,611 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include "cql3/simple_statement_parser.hh"
+#include "cql3/attributes.hh"
+#include "cql3/cf_name.hh"
+#include "cql3/column_identifier.hh"
+#include "cql3/expr/expression.hh"
+#include "cql3/operation_impl.hh"
+#include "cql3/selection/raw_selector.hh"
+#include "cql3/statements/raw/delete_statement.hh"
+#include "cql3/statements/raw/insert_statement.hh"
+#include "cql3/statements/raw/select_statement.hh"
+#include "cql3/statements/raw/update_statement.hh"
+#include "utils/utf8.hh"
+
+namespace cql3 {
+
+using namespace expr;
+using namespace statements;
+
+namespace {
+
+// Lexes the same tokens as the ANTLR lexer of Cql.g for the subset of the
+// language handled here. Whatever isn't in the subset, e.g. comments, bind
+// markers, durations, collection literals or non-ASCII characters outside
+// of strings, makes lexing fail, and the statement is left to the ANTLR parser.
+struct lexeme {
+    enum class kind { word, quoted_name, string, integer, floating_point, uuid, hex, symbol };
+    kind type;
+    // The text of the lexeme, with the quotes of strings and quoted names
+    // removed and their escaped quotes unescaped.
+    sstring text;
+};
+
+bool is_letter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool is_hex(char c) {
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+bool is_word_char(char c) {
+    return is_letter(c) || is_digit(c) || c == '_';
+}
+
+bool is_uuid_at(std::string_view in, size_t pos) {
+    static constexpr std::string_view pattern = "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx";
+    if (in.size() - pos < pattern.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        auto c = in[pos + i];
+        if (pattern[i] == '-' ? c != '-' : !is_hex(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<std::vector<lexeme>> tokenize(std::string_view in) {
+    std::vector<lexeme> tokens;
+    size_t pos = 0;
+    auto at = [&] (size_t p) {
+        return p < in.size() ? in[p] : '\0';
+    };
+    while (pos < in.size()) {
+        char c = in[pos];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            ++pos;
+            continue;
+        }
+        size_t start = pos;
+        if (is_hex(c) && is_uuid_at(in, pos)) {
+            pos += 36;
+            tokens.push_back({lexeme::kind::uuid, sstring(in.substr(start, pos - start))});
+        } else if (is_letter(c)) {
+            while (is_word_char(at(pos))) {
+                ++pos;
+            }
+            tokens.push_back({lexeme::kind::word, sstring(in.substr(start, pos - start))});
+            continue;
+        } else if (c == '0' && (at(pos + 1) == 'x' || at(pos + 1) == 'X')) {
+            pos += 2;
+            while (is_hex(at(pos))) {
+                ++pos;
+            }
+            tokens.push_back({lexeme::kind::hex, sstring(in.substr(start, pos - start))});
+        } else if (is_digit(c) || (c == '-' && is_digit(at(pos + 1)))) {
+            auto type = lexeme::kind::integer;
+            ++pos;
+            while (is_digit(at(pos))) {
+                ++pos;
+            }
+            if (at(pos) == '.') {
+                if (!is_digit(at(pos + 1))) {
+                    return std::nullopt;
+                }
+                type = lexeme::kind::floating_point;
+                ++pos;
+                while (is_digit(at(pos))) {
+                    ++pos;
+                }
+            }
+            if (at(pos) == 'e' || at(pos) == 'E') {
+                auto exp = pos + 1;
+                if (at(exp) == '+' || at(exp) == '-') {
+                    ++exp;
+                }
+                if (!is_digit(at(exp))) {
+                    return std::nullopt;
+                }
+                type = lexeme::kind::floating_point;
+                pos = exp;
+                while (is_digit(at(pos))) {
+                    ++pos;
+                }
+            }
+            tokens.push_back({type, sstring(in.substr(start, pos - start))});
+        } else if (c == '\'' || c == '"') {
+            // Quotes are escaped by doubling them.
+            std::string text;
+            ++pos;
+            while (true) {
+                auto quote = in.find(c, pos);
+                if (quote == std::string_view::npos) {
+                    return std::nullopt;
+                }
+                text.append(in.data() + pos, quote - pos);
+                pos = quote + 1;
+                if (at(pos) != c) {
+                    break;
+                }
+                text.push_back(c);
+                ++pos;
+            }
+            // Leave invalid UTF-8 for the ANTLR lexer to deal with.
+            if ((c == '"' && text.empty()) || !utils::utf8::validate(to_bytes_view(text))) {
+                return std::nullopt;
+            }
+            tokens.push_back({c == '"' ? lexeme::kind::quoted_name : lexeme::kind::string, sstring(text)});
+            continue;
+        } else if (c == '<' || c == '>' || c == '!') {
+            ++pos;
+            if (at(pos) == '=') {
+                ++pos;
+            } else if (c == '!') {
+                return std::nullopt;
+            }
+            tokens.push_back({lexeme::kind::symbol, sstring(in.substr(start, pos - start))});
+            continue;
+        } else if (c == '(' || c == ')' || c == ',' || c == ';' || c == '*' || c == '.' || c == '=') {
+            ++pos;
+            tokens.push_back({lexeme::kind::symbol, sstring(in.substr(start, pos - start))});
+            continue;
+        } else {
+            return std::nullopt;
+        }
+        // Literals which run into a word are durations, identifiers or
+        // something else which isn't handled here.
+        if (is_word_char(at(pos)) || at(pos) == '.') {
+            return std::nullopt;
+        }
+    }
+    return tokens;
+}
+
+// Keywords of Cql.g which can't be used as identifiers, and the tokens
+// which take precedence over identifiers.
+// Must be kept in sync with the grammar.
+const std::unordered_set<std::string_view> reserved_words = {
+    "add", "allow", "alter", "and", "apply", "asc", "authorize", "batch", "begin", "by", "cast",
+    "columnfamily", "create", "default", "delete", "drop", "entries", "false", "from", "full", "grant",
+    "if", "in", "index", "infinity", "insert", "into", "is", "keyspace", "limit", "materialized",
+    "modify", "nan", "norecursive", "not", "null", "of", "on", "or", "order", "primary", "rename",
+    "replace", "revoke", "schema", "scylla_clustering_bound", "scylla_counter_shard_list",
+    "scylla_timeuuid_list_index", "select", "set", "table", "to", "token", "true", "truncate",
+    "unlogged", "unset", "update", "use", "using", "view", "where", "with",
+};
+
+sstring to_lower(std::string_view s) {
+    sstring res(sstring::initialized_later(), s.size());
+    std::transform(s.begin(), s.end(), res.begin(), ::tolower);
+    return res;
+}
+
+class parser {
+    const std::vector<lexeme>& _tokens;
+    size_t _pos = 0;
+public:
+    explicit parser(const std::vector<lexeme>& tokens) : _tokens(tokens) { }
+
+    std::unique_ptr<raw::parsed_statement> parse() {
+        std::unique_ptr<raw::parsed_statement> stmt;
+        if (accept_keyword("select")) {
+            stmt = select_statement();
+        } else if (accept_keyword("insert")) {
+            stmt = insert_statement();
+        } else if (accept_keyword("update")) {
+            stmt = update_statement();
+        } else if (accept_keyword("delete")) {
+            stmt = delete_statement();
+        }
+        if (!stmt) {
+            return nullptr;
+        }
+        while (accept_symbol(";")) {
+        }
+        if (_pos != _tokens.size()) {
+            return nullptr;
+        }
+        stmt->set_bound_variables({});
+        return stmt;
+    }
+private:
+    const lexeme* peek() const {
+        return _pos < _tokens.size() ? &_tokens[_pos] : nullptr;
+    }
+
+    bool is_keyword(std::string_view kw) const {
+        auto t = peek();
+        return t && t->type == lexeme::kind::word && t->text.size() == kw.size()
+                && std::equal(kw.begin(), kw.end(), t->text.begin(), [] (char a, char b) { return a == ::tolower(b); });
+    }
+
+    bool accept_keyword(std::string_view kw) {
+        if (is_keyword(kw)) {
+            ++_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool accept_symbol(std::string_view s) {
+        auto t = peek();
+        if (t && t->type == lexeme::kind::symbol && t->text == s) {
+            ++_pos;
+            return true;
+        }
+        return false;
+    }
+
+    // An unquoted identifier or a quoted name, as a (name, keep_case) pair.
+    std::optional<std::pair<sstring, bool>> name() {
+        auto t = peek();
+        if (!t) {
+            return std::nullopt;
+        }
+        if (t->type == lexeme::kind::quoted_name) {
+            ++_pos;
+            return std::pair(t->text, true);
+        }
+        if (t->type != lexeme::kind::word || reserved_words.contains(to_lower(t->text))) {
+            return std::nullopt;
+        }
+        // The lexer of Cql.g takes e.g. P, PT or P1Y for durations.
+        if (t->text[0] == 'P' && std::all_of(t->text.begin() + 1, t->text.end(), [] (char c) {
+                    return is_digit(c) || std::string_view("YMDTHSW").find(c) != std::string_view::npos; })) {
+            return std::nullopt;
+        }
+        ++_pos;
+        return std::pair(t->text, false);
+    }
+
+    ::shared_ptr<column_identifier::raw> cident() {
+        auto n = name();
+        if (!n) {
+            return nullptr;
+        }
+        return ::make_shared<column_identifier::raw>(std::move(n->first), n->second);
+    }
+
+    std::optional<cf_name> column_family_name() {
+        auto first = name();
+        if (!first) {
+            return std::nullopt;
+        }
+        cf_name cf;
+        if (accept_symbol(".")) {
+            auto second = name();
+            if (!second) {
+                return std::nullopt;
+            }
+            cf.set_keyspace(first->first, first->second);
+            cf.set_column_family(second->first, second->second);
+        } else {
+            cf.set_column_family(first->first, first->second);
+        }
+        return cf;
+    }
+
+    std::optional<expression> term() {
+        auto t = peek();
+        if (!t) {
+            return std::nullopt;
+        }
+        std::optional<expression> e;
+        switch (t->type) {
+        case lexeme::kind::string:
+            e = untyped_constant{untyped_constant::string, t->text};
+            break;
+        case lexeme::kind::integer:
+            e = untyped_constant{untyped_constant::integer, t->text};
+            break;
+        case lexeme::kind::floating_point:
+            e = untyped_constant{untyped_constant::floating_point, t->text};
+            break;
+        case lexeme::kind::uuid:
+            e = untyped_constant{untyped_constant::uuid, t->text};
+            break;
+        case lexeme::kind::hex:
+            e = untyped_constant{untyped_constant::hex, t->text};
+            break;
+        case lexeme::kind::word:
+            if (is_keyword("true") || is_keyword("false")) {
+                e = untyped_constant{untyped_constant::boolean, t->text};
+            } else if (is_keyword("null")) {
+                e = make_untyped_null();
+            }
+            break;
+        case lexeme::kind::quoted_name:
+        case lexeme::kind::symbol:
+            break;
+        }
+        if (e) {
+            ++_pos;
+        }
+        return e;
+    }
+
+    std::optional<expression> relation() {
+        auto c = cident();
+        if (!c) {
+            return std::nullopt;
+        }
+        auto t = peek();
+        if (!t || t->type != lexeme::kind::symbol) {
+            return std::nullopt;
+        }
+        oper_t op;
+        if (t->text == "=") {
+            op = oper_t::EQ;
+        } else if (t->text == "<") {
+            op = oper_t::LT;
+        } else if (t->text == "<=") {
+            op = oper_t::LTE;
+        } else if (t->text == ">") {
+            op = oper_t::GT;
+        } else if (t->text == ">=") {
+            op = oper_t::GTE;
+        } else if (t->text == "!=") {
+            op = oper_t::NEQ;
+        } else {
+            return std::nullopt;
+        }
+        ++_pos;
+        auto value = term();
+        if (!value) {
+            return std::nullopt;
+        }
+        return binary_operator(unresolved_identifier{std::move(c)}, op, std::move(*value));
+    }
+
+    std::optional<expression> where_clause() {
+        std::vector<expression> terms;
+        do {
+            auto r = relation();
+            if (!r) {
+                return std::nullopt;
+            }
+            terms.push_back(std::move(*r));
+        } while (accept_keyword("and"));
+        return conjunction{std::move(terms)};
+    }
+
+    std::unique_ptr<raw::select_statement> select_statement() {
+        if (is_keyword("json") || is_keyword("distinct")) {
+            return nullptr;
+        }
+        std::vector<::shared_ptr<selection::raw_selector>> sclause;
+        if (!accept_symbol("*")) {
+            do {
+                auto c = cident();
+                if (!c) {
+                    return nullptr;
+                }
+                sclause.push_back(::make_shared<selection::raw_selector>(unresolved_identifier{std::move(c)}, nullptr));
+            } while (accept_symbol(","));
+        }
+        if (!accept_keyword("from")) {
+            return nullptr;
+        }
+        auto cf = column_family_name();
+        if (!cf) {
+            return nullptr;
+        }
+        expression wclause = conjunction{};
+        if (accept_keyword("where")) {
+            auto w = where_clause();
+            if (!w) {
+                return nullptr;
+            }
+            wclause = std::move(*w);
+        }
+        std::optional<expression> limit;
+        if (accept_keyword("limit")) {
+            auto t = peek();
+            if (!t || t->type != lexeme::kind::integer) {
+                return nullptr;
+            }
+            limit = untyped_constant{untyped_constant::integer, t->text};
+            ++_pos;
+        }
+        bool allow_filtering = false;
+        if (accept_keyword("allow")) {
+            if (!accept_keyword("filtering")) {
+                return nullptr;
+            }
+            allow_filtering = true;
+        }
+        bool bypass_cache = false;
+        if (accept_keyword("bypass")) {
+            if (!accept_keyword("cache")) {
+                return nullptr;
+            }
+            bypass_cache = true;
+        }
+        auto params = make_lw_shared<raw::select_statement::parameters>(raw::select_statement::parameters::orderings_type{},
+                false, allow_filtering, raw::select_statement::parameters::statement_subtype::REGULAR, bypass_cache);
+        return std::make_unique<raw::select_statement>(std::move(*cf), std::move(params),
+                std::move(sclause), std::move(wclause), std::move(limit), std::nullopt,
+                std::vector<::shared_ptr<column_identifier::raw>>{}, std::make_unique<attributes::raw>());
+    }
+
+    std::unique_ptr<raw::insert_statement> insert_statement() {
+        if (!accept_keyword("into")) {
+            return nullptr;
+        }
+        auto cf = column_family_name();
+        if (!cf || !accept_symbol("(")) {
+            return nullptr;
+        }
+        std::vector<::shared_ptr<column_identifier::raw>> column_names;
+        do {
+            auto c = cident();
+            if (!c) {
+                return nullptr;
+            }
+            column_names.push_back(std::move(c));
+        } while (accept_symbol(","));
+        if (!accept_symbol(")") || !accept_keyword("values") || !accept_symbol("(")) {
+            return nullptr;
+        }
+        std::vector<expression> values;
+        do {
+            auto v = term();
+            if (!v) {
+                return nullptr;
+            }
+            values.push_back(std::move(*v));
+        } while (accept_symbol(","));
+        if (!accept_symbol(")")) {
+            return nullptr;
+        }
+        bool if_not_exists = false;
+        if (accept_keyword("if")) {
+            if (!accept_keyword("not") || !accept_keyword("exists")) {
+                return nullptr;
+            }
+            if_not_exists = true;
+        }
+        return std::make_unique<raw::insert_statement>(std::move(*cf), std::make_unique<attributes::raw>(),
+                std::move(column_names), std::move(values), if_not_exists);
+    }
+
+    std::unique_ptr<raw::update_statement> update_statement() {
+        auto cf = column_family_name();
+        if (!cf || !accept_keyword("set")) {
+            return nullptr;
+        }
+        std::vector<std::pair<::shared_ptr<column_identifier::raw>, std::unique_ptr<operation::raw_update>>> operations;
+        do {
+            auto c = cident();
+            if (!c || !accept_symbol("=")) {
+                return nullptr;
+            }
+            auto v = term();
+            if (!v) {
+                return nullptr;
+            }
+            operations.emplace_back(std::move(c), std::make_unique<operation::set_value>(std::move(*v)));
+        } while (accept_symbol(","));
+        if (!accept_keyword("where")) {
+            return nullptr;
+        }
+        auto wclause = where_clause();
+        if (!wclause) {
+            return nullptr;
+        }
+        return std::make_unique<raw::update_statement>(std::move(*cf), std::make_unique<attributes::raw>(),
+                std::move(operations), std::move(*wclause), raw::modification_statement::conditions_vector{}, false);
+    }
+
+    std::unique_ptr<raw::delete_statement> delete_statement() {
+        std::vector<std::unique_ptr<operation::raw_deletion>> column_deletions;
+        if (!is_keyword("from")) {
+            do {
+                auto c = cident();
+                if (!c) {
+                    return nullptr;
+                }
+                column_deletions.push_back(std::make_unique<operation::column_deletion>(std::move(c)));
+            } while (accept_symbol(","));
+        }
+        if (!accept_keyword("from")) {
+            return nullptr;
+        }
+        auto cf = column_family_name();
+        if (!cf || !accept_keyword("where")) {
+            return nullptr;
+        }
+        auto wclause = where_clause();
+        if (!wclause) {
+            return nullptr;
+        }
+        return std::make_unique<raw::delete_statement>(std::move(*cf), std::make_unique<attributes::raw>(),
+                std::move(column_deletions), std::move(*wclause), raw::modification_statement::conditions_vector{}, false);
+    }
+};
+
+}
+
+std::unique_ptr<raw::parsed_statement> try_parse_simple_statement(std::string_view query) {
+    auto tokens = tokenize(query);
+    if (!tokens) {
+        return nullptr;
+    }
+    return parser(*tokens).parse();
+}
+
+std::optional<normalized_statement> normalize_simple_statement(std::string_view query) {
+    auto tokens = tokenize(query);
+    if (!tokens) {
+        return std::nullopt;
+    }
+    normalized_statement normalized;
+    std::string text;
+    std::string kinds;
+    auto replace = [&] (untyped_constant::type_class type, char kind, sstring& value) {
+        text += '?';
+        kinds += kind;
+        normalized.values.push_back(untyped_constant{type, std::move(value)});
+    };
+    for (auto& t : *tokens) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        switch (t.type) {
+        case lexeme::kind::word:
+        case lexeme::kind::symbol:
+            text += t.text;
+            break;
+        case lexeme::kind::quoted_name:
+            text += '"';
+            for (auto c : t.text) {
+                text += c;
+                if (c == '"') {
+                    text += c;
+                }
+            }
+            text += '"';
+            break;
+        case lexeme::kind::string:
+            replace(untyped_constant::string, 's', t.text);
+            break;
+        case lexeme::kind::integer:
+            replace(untyped_constant::integer, 'i', t.text);
+            break;
+        case lexeme::kind::floating_point:
+            replace(untyped_constant::floating_point, 'f', t.text);
+            break;
+        case lexeme::kind::uuid:
+            replace(untyped_constant::uuid, 'u', t.text);
+            break;
+        case lexeme::kind::hex:
+            replace(untyped_constant::hex, 'h', t.text);
+            break;
+        }
+    }
+    normalized.key = format("{}\n{}", kinds, text);
+    normalized.query = sstring(text);
+    return normalized;
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "cql3/expr/expression.hh"
+
+namespace cql3 {
+
+namespace statements::raw {
+class parsed_statement;
+}
+
+// A hand-written parser for the most common shapes of unprepared statements,
+// which spend most of their parsing time in the generated ANTLR lexer and
+// parser:
+//
+//   SELECT (* | c1, ..., cn) FROM [ks.]cf [WHERE rel AND ...] [LIMIT n]
+//          [ALLOW FILTERING] [BYPASS CACHE]
+//   INSERT INTO [ks.]cf (c1, ..., cn) VALUES (v1, ..., vn) [IF NOT EXISTS]
+//   UPDATE [ks.]cf SET c1 = v1, ..., cn = vn WHERE rel AND ...
+//   DELETE [c1, ..., cn] FROM [ks.]cf WHERE rel AND ...
+//
+// where a relation is a column compared to a value with =, <, <=, >, >= or
+// !=, and values are literal constants or null.
+//
+// Returns the same raw statement the ANTLR parser would, or nullptr if the
+// statement is not of one of these shapes, in which case it has to be parsed
+// by the ANTLR parser, which also reports the syntax errors.
+std::unique_ptr<statements::raw::parsed_statement> try_parse_simple_statement(std::string_view query);
+
+// A statement with its constants, except true, false and null, replaced by
+// bind markers, so that statements differing only in their constants can
+// share a prepared statement.
+struct normalized_statement {
+    // The statement, with bind markers instead of the constants.
+    sstring query;
+    // Identifies the statement: its query and the kinds of the constants
+    // which were replaced. Constants of other kinds may not be accepted in
+    // place of the replaced ones, e.g. a string as a LIMIT.
+    sstring key;
+    // The replaced constants, in the order of their markers.
+    std::vector<expr::untyped_constant> values;
+};
+
+// Normalizes a statement which lexes like the statements handled by
+// try_parse_simple_statement. The statement may still turn out not to be of
+// one of the handled shapes, which has to be checked with
+// try_parse_simple_statement before its normalized query is prepared. This
+// only needs to be done once for a key.
+std::optional<normalized_statement> normalize_simple_statement(std::string_view query);
+
+}
@@ -127,11 +127,17 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
     if (auto caching_options = get_caching_options(); caching_options && !caching_options->enabled() && !db.features().per_table_caching) {
         throw exceptions::configuration_exception(KW_CACHING + " can't contain \"'enabled':false\" unless whole cluster supports it");
     }
+    if (auto caching_options = get_caching_options(); caching_options && caching_options->eviction_priority() && !db.features().cache_eviction_priority) {
+        throw exceptions::configuration_exception(KW_CACHING + " can't contain 'eviction_priority' unless whole cluster supports it");
+    }
 
     auto cdc_options = get_cdc_options(schema_extensions);
     if (cdc_options && cdc_options->enabled() && !db.features().cdc) {
         throw exceptions::configuration_exception("CDC not supported by the cluster");
     }
+    if (cdc_options && cdc_options->blind_inserts() && !db.features().cdc_blind_inserts) {
+        throw exceptions::configuration_exception("CDC option 'blind_inserts' is not supported yet by the whole cluster");
+    }
 
     auto per_partition_rate_limit_options = get_per_partition_rate_limit_options(schema_extensions);
     if (per_partition_rate_limit_options && !db.features().typed_errors_in_read_rpc) {
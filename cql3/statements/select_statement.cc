@@ -19,6 +19,7 @@
 #include "service/broadcast_tables/experimental/lang.hh"
 #include "transport/messages/result_message.hh"
 #include "cql3/functions/as_json_function.hh"
+#include "cql3/functions/aggregate_fcts.hh"
 #include "cql3/selection/selection.hh"
 #include "cql3/util.hh"
 #include "cql3/restrictions/statement_restrictions.hh"
@@ -184,6 +185,29 @@ select_statement::select_statement(schema_ptr schema,
     _opts.set_if<query::partition_slice::option::bypass_cache>(_parameters->bypass_cache());
     _opts.set_if<query::partition_slice::option::distinct>(_parameters->is_distinct());
     _opts.set_if<query::partition_slice::option::reversed>(_is_reversed);
+
+    if (_selection->contains_static_columns()) {
+        _static_columns.reserve(_selection->get_column_count());
+    }
+    _regular_columns.reserve(_selection->get_column_count());
+    for (auto&& col : _selection->get_columns()) {
+        if (col->is_static()) {
+            _static_columns.push_back(col->id);
+        } else if (col->is_regular()) {
+            _regular_columns.push_back(col->id);
+        }
+    }
+
+    // Nonpure functions (e.g. now()) are evaluated on each execution, like bind variables.
+    const auto& ck_restrictions = _restrictions->get_clustering_columns_restrictions();
+    if (!expr::contains_bind_marker(ck_restrictions)
+            && !expr::find_in_expression<expr::function_call>(ck_restrictions, [] (const expr::function_call&) { return true; })) {
+        try {
+            _clustering_bounds = get_clustering_bounds(query_options::DEFAULT);
+        } catch (...) {
+            // Leave the error to be reported by execution.
+        }
+    }
 }
 
 db::timeout_clock::duration select_statement::get_timeout(const service::client_state& state, const query_options& options) const {
@@ -227,31 +251,8 @@ const sstring& select_statement::column_family() const {
     return _schema->cf_name();
 }
 
-query::partition_slice
-select_statement::make_partition_slice(const query_options& options) const
-{
-    query::column_id_vector static_columns;
-    query::column_id_vector regular_columns;
-
-    if (_selection->contains_static_columns()) {
-        static_columns.reserve(_selection->get_column_count());
-    }
-
-    regular_columns.reserve(_selection->get_column_count());
-
-    for (auto&& col : _selection->get_columns()) {
-        if (col->is_static()) {
-            static_columns.push_back(col->id);
-        } else if (col->is_regular()) {
-            regular_columns.push_back(col->id);
-        }
-    }
-
-    if (_parameters->is_distinct()) {
-        return query::partition_slice({ query::clustering_range::make_open_ended_both_sides() },
-            std::move(static_columns), {}, _opts, nullptr);
-    }
-
+std::vector<query::clustering_range>
+select_statement::get_clustering_bounds(const query_options& options) const {
     auto bounds =_restrictions->get_clustering_bounds(options);
     if (bounds.size() > 1) {
         auto comparer = position_in_partition::less_compare(*_schema);
@@ -262,10 +263,24 @@ select_statement::make_partition_slice(const query_options& options) const
     }
     if (_is_reversed) {
         std::reverse(bounds.begin(), bounds.end());
+    }
+    return bounds;
+}
+
+query::partition_slice
+select_statement::make_partition_slice(const query_options& options) const
+{
+    if (_parameters->is_distinct()) {
+        return query::partition_slice({ query::clustering_range::make_open_ended_both_sides() },
+            _static_columns, {}, _opts, nullptr);
+    }
+
+    auto bounds = _clustering_bounds ? *_clustering_bounds : get_clustering_bounds(options);
+    if (_is_reversed) {
         ++_stats.reverse_queries;
     }
     return query::partition_slice(std::move(bounds),
-        std::move(static_columns), std::move(regular_columns), _opts, nullptr, get_per_partition_limit(options));
+        _static_columns, _regular_columns, _opts, nullptr, get_per_partition_limit(options));
 }
 
 uint64_t select_statement::do_get_limit(const query_options& options,
@@ -412,9 +427,12 @@ select_statement::do_execute(query_processor& qp,
                 cql3::selection::result_set_builder(*_selection, now,
                         *_group_by_cell_indices), std::move(p),
                 [this, page_size, now, timeout](auto& builder, std::unique_ptr<service::pager::query_pager>& p) {
+                    // Tests lower the internal page size to exercise paging,
+                    // keep it fixed for them.
+                    const bool adaptive = internal_paging_size == DEFAULT_INTERNAL_PAGING_SIZE;
                     return utils::result_do_until([&p] {return p->is_exhausted();},
-                            [&p, &builder, page_size, now, timeout] {
-                                return p->fetch_page_result(builder, page_size, now, timeout);
+                            [&p, &builder, page_size, adaptive, now, timeout] {
+                                return p->fetch_page_result(builder, adaptive ? p->adaptive_page_size(page_size) : page_size, now, timeout);
                             }
                     ).then(wrap_result_to_error_message([this, &p, &builder] {
                         return builder.with_thread_if_needed([this, &p, &builder] {
@@ -678,20 +696,40 @@ indexed_table_select_statement::do_execute_base_query(
         }
         next_iteration_size = std::min<size_t>({next_iteration_size, keys.size() - already_done, max_base_table_query_concurrency});
         auto key_it_end = key_it + next_iteration_size;
-        auto command = ::make_lw_shared<query::read_command>(*cmd);
+
+        // The rows of a partition follow each other in the posting list, so
+        // those in clustering order are read by a single query of the partition,
+        // rather than by one query per row.
+        struct partition_rows {
+            const dht::decorated_key* partition;
+            std::vector<query::clustering_range> row_ranges;
+            const clustering_key_prefix* last_clustering = nullptr;
+        };
+        std::vector<partition_rows> partitions;
+        clustering_key_prefix::less_compare ck_less(*_schema);
+        for (auto it = key_it; it != key_it_end; ++it) {
+            if (!partitions.empty() && it->clustering && !cmd->slice.is_reversed()) {
+                auto& last = partitions.back();
+                if (last.last_clustering && last.partition->equal(*_schema, it->partition) && ck_less(*last.last_clustering, it->clustering)) {
+                    last.row_ranges.push_back(query::clustering_range::make_singular(it->clustering));
+                    last.last_clustering = &it->clustering;
+                    continue;
+                }
+            }
+            auto& rows = partitions.emplace_back(partition_rows{&it->partition});
+            if (it->clustering) {
+                rows.row_ranges.push_back(query::clustering_range::make_singular(it->clustering));
+                rows.last_clustering = &it->clustering;
+            }
+        }
 
         query::result_merger oneshot_merger(cmd->get_row_limit(), query::max_partitions);
-        coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>> rresult = co_await utils::result_map_reduce(key_it, key_it_end, coroutine::lambda([&] (auto& key)
+        coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>> rresult = co_await utils::result_map_reduce(partitions.begin(), partitions.end(), coroutine::lambda([&] (partition_rows& rows)
                 -> future<coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>>> {
             auto command = ::make_lw_shared<query::read_command>(*cmd);
-            // for each partition, read just one clustering row (TODO: can
-            // get all needed rows of one partition at once.)
-            command->slice._row_ranges.clear();
-            if (key.clustering) {
-                command->slice._row_ranges.push_back(query::clustering_range::make_singular(key.clustering));
-            }
+            command->slice._row_ranges = std::move(rows.row_ranges);
             coordinator_result<service::storage_proxy::coordinator_query_result> rqr
-                    = co_await qp.proxy().query_result(_schema, command, {dht::partition_range::make_singular(key.partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()});
+                    = co_await qp.proxy().query_result(_schema, command, {dht::partition_range::make_singular(*rows.partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()});
             if (!rqr.has_value()) {
                 co_return std::move(rqr).as_failure();
             }
@@ -1434,6 +1472,8 @@ class parallelized_select_statement : public select_statement {
         std::unique_ptr<cql3::attributes> attrs
     );
 
+    static std::vector<sstring> group_by_column_names(const selection::selection& selection, const std::vector<size_t>& group_by_cell_indices);
+
 private:
     virtual future<::shared_ptr<cql_transport::messages::result_message>> do_execute(
         query_processor& qp,
@@ -1501,6 +1541,12 @@ parallelized_select_statement::parallelized_select_statement(
 ) {
 }
 
+std::vector<sstring> parallelized_select_statement::group_by_column_names(const selection::selection& selection, const std::vector<size_t>& group_by_cell_indices) {
+    return boost::copy_range<std::vector<sstring>>(group_by_cell_indices | boost::adaptors::transformed([&] (size_t idx) {
+        return selection.get_columns()[idx]->name_as_text();
+    }));
+}
+
 future<::shared_ptr<cql_transport::messages::result_message>>
 parallelized_select_statement::do_execute(
     query_processor& qp,
@@ -1551,6 +1597,8 @@ parallelized_select_statement::do_execute(
     auto timeout_duration = get_timeout(state.get_client_state(), options);
     auto timeout = lowres_system_clock::now() + timeout_duration;
     auto reductions = _selection->get_reductions();
+    auto group_by_columns = group_by_column_names(*_selection, *_group_by_cell_indices);
+    auto limit = get_limit(options);
 
     query::forward_request req = {
         .reduction_types = reductions.types,
@@ -1559,13 +1607,29 @@ parallelized_select_statement::do_execute(
         .cl = options.get_consistency(),
         .timeout = timeout,
         .aggregation_infos = reductions.infos,
+        .group_by_column_names = group_by_columns,
     };
 
     // dispatch execution of this statement to other nodes
-    return qp.forwarder().dispatch(req, state.get_trace_state()).then([this] (query::forward_result res) {
+    return qp.forwarder().dispatch(req, state.get_trace_state()).then([this, group_by_columns = std::move(group_by_columns), limit] (query::forward_result res) {
         auto meta = make_shared<metadata>(*_selection->get_result_metadata());
         auto rs = std::make_unique<result_set>(std::move(meta));
-        rs->add_row(res.query_results);
+        if (has_group_by()) {
+            // A group's result has the GROUP BY columns first, rearrange it
+            // to match the selection.
+            auto layout = _selection->get_grouped_reduction_layout(group_by_columns);
+            for (auto& group : res.grouped_results) {
+                std::vector<bytes_opt> row;
+                row.reserve(layout.size());
+                for (auto idx : layout) {
+                    row.push_back(group[idx]);
+                }
+                rs->add_row(std::move(row));
+            }
+            rs->trim(limit);
+        } else {
+            rs->add_row(res.query_results);
+        }
         update_stats_rows_read(rs->size());
         return shared_ptr<cql_transport::messages::result_message>(
             make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs)))
@@ -1682,6 +1746,17 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
     auto prepared_attrs = _attrs->prepare(db, keyspace(), column_family());
     prepared_attrs->fill_prepare_context(ctx);
 
+    // Nodes which don't know the approximate aggregates can't compute their
+    // partial results. Only valid for selections which are counts or reducible.
+    auto forwarded_functions_are_supported = [&] {
+        if (db.features().approximate_aggregates) {
+            return true;
+        }
+        auto infos = selection->get_reductions().infos;
+        return std::none_of(infos.begin(), infos.end(), [] (const query::forward_request::aggregation_info& info) {
+            return functions::aggregate_fcts::is_approximate_aggregate(info.name);
+        });
+    };
     // Used to determine if an execution of this statement can be parallelized
     // using `forward_service`.
     auto can_be_forwarded = [&] {
@@ -1691,10 +1766,32 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
                 (db.features().parallelized_aggregation && selection->is_count())
                 || (db.features().uda_native_parallelized_aggregation && selection->is_reducible())
             )
+            && forwarded_functions_are_supported()
             && !restrictions->need_filtering()  // No filtering
             && group_by_cell_indices->empty()   // No GROUP BY
             && db.get_config().enable_parallelized_aggregation();
     };
+    // GROUP BY queries can be parallelized too, as long as each group lies
+    // within a single partition, which is the case unless a partition key
+    // column is omitted from GROUP BY (being restricted by equality, in which
+    // case there is only one partition to read anyway).
+    auto can_be_forwarded_with_group_by = [&] {
+        if (group_by_cell_indices->empty()) {
+            return false;
+        }
+        auto group_by_columns = parallelized_select_statement::group_by_column_names(*selection, *group_by_cell_indices);
+        auto has_whole_partition_key = std::all_of(schema->partition_key_columns().begin(), schema->partition_key_columns().end(), [&] (const column_definition& def) {
+            return std::find(group_by_columns.begin(), group_by_columns.end(), def.name_as_text()) != group_by_columns.end();
+        });
+        return db.features().group_by_parallelized_aggregation
+            && selection->is_reducible_with_group_by(group_by_columns)
+            && forwarded_functions_are_supported()
+            && has_whole_partition_key
+            && !restrictions->need_filtering()  // No filtering
+            && !_per_partition_limit            // PER PARTITION LIMIT limits groups of the partition
+            && !ordering_comparator             // Groups are returned in ring order
+            && db.get_config().enable_parallelized_aggregation();
+    };
 
     if (_parameters->is_prune_materialized_view()) {
         stmt = ::make_shared<cql3::statements::prune_materialized_view_statement>(
@@ -1725,7 +1822,7 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
                 prepare_limit(db, ctx, _per_partition_limit),
                 stats,
                 std::move(prepared_attrs));
-    } else if (can_be_forwarded()) {
+    } else if (can_be_forwarded() || can_be_forwarded_with_group_by()) {
         stmt = parallelized_select_statement::prepare(
             schema,
             ctx.bound_variables_size(),
@@ -77,6 +77,11 @@ class select_statement : public cql_statement {
     ordering_comparator_type _ordering_comparator;
 
     query::partition_slice::option_set _opts;
+    // The parts of the partition slice which don't depend on the bound values, computed once
+    // so that executing a prepared statement doesn't have to.
+    query::column_id_vector _static_columns;
+    query::column_id_vector _regular_columns;
+    std::optional<std::vector<query::clustering_range>> _clustering_bounds; ///< Unset if the bounds depend on the bound values.
     cql_stats& _stats;
     const ks_selector _ks_sel;
     bool _range_scan = false;
@@ -135,7 +140,14 @@ protected :
 
     const sstring& column_family() const;
 
+    const schema_ptr& get_schema() const {
+        return _schema;
+    }
+
     query::partition_slice make_partition_slice(const query_options& options) const;
+private:
+    std::vector<query::clustering_range> get_clustering_bounds(const query_options& options) const;
+public:
 
     const ::shared_ptr<const restrictions::statement_restrictions> get_restrictions() const;
 
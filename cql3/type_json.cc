@@ -17,6 +17,7 @@
 #include "types/user.hh"
 #include "types/listlike_partial_deserializing_iterator.hh"
 #include "utils/managed_bytes.hh"
+#include "bytes_ostream.hh"
 #include "exceptions/exceptions.hh"
 #include <limits>
 #include <utility>
@@ -342,195 +343,190 @@ template <typename T> static T compose_value(const integer_type_impl<T>& t, byte
     return read_be<T>(reinterpret_cast<const char*>(bv.data()));
 }
 
-static sstring to_json_string_aux(const map_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
+static void write(bytes_ostream& out, std::string_view s) {
+    out.write(s.data(), s.size());
+}
 
-    out << '{';
+static void to_json_aux(const map_type_impl& t, bytes_view bv, bytes_ostream& out) {
+    write(out, "{");
     auto size = read_collection_size(bv);
     for (int i = 0; i < size; ++i) {
         auto kb = read_collection_key(bv);
         auto vb = read_collection_value_nonnull(bv);
 
         if (i > 0) {
-            out << ", ";
+            write(out, ", ");
         }
 
         // Valid keys in JSON map must be quoted strings
         sstring string_key = to_json_string(*t.get_keys_type(), kb);
         bool is_unquoted = string_key.empty() || string_key[0] != '"';
         if (is_unquoted) {
-            out << '"';
+            write(out, "\"");
         }
-        out << string_key;
+        write(out, string_key);
         if (is_unquoted) {
-            out << '"';
+            write(out, "\"");
         }
-        out << ": ";
-        out << to_json_string(*t.get_values_type(), vb);
+        write(out, ": ");
+        to_json(*t.get_values_type(), vb, out);
     }
-    out << '}';
-    return out.str();
+    write(out, "}");
 }
 
-static sstring to_json_string_aux(const set_type_impl& t, bytes_view bv) {
+static void to_json_aux(const listlike_collection_type_impl& t, bytes_view bv, bytes_ostream& out) {
     using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
     bool first = true;
-    out << '[';
+    write(out, "[");
     managed_bytes_view mbv(bv);
     std::for_each(llpdi::begin(mbv), llpdi::end(mbv), [&first, &out, &t] (const managed_bytes_view_opt& e) {
         if (first) {
             first = false;
         } else {
-            out << ", ";
+            write(out, ", ");
         }
         if (e) {
-            out << to_json_string(*t.get_elements_type(), *e);
+            to_json(*t.get_elements_type(), *e, out);
         } else {
             // Impossible in sets, but let's not insist here.
-            out << "null";
-        }
-    });
-    out << ']';
-    return out.str();
-}
-
-static sstring to_json_string_aux(const list_type_impl& t, bytes_view bv) {
-    using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
-    bool first = true;
-    out << '[';
-    managed_bytes_view mbv(bv);
-    std::for_each(llpdi::begin(mbv), llpdi::end(mbv), [&first, &out, &t] (const managed_bytes_view_opt& e) {
-        if (first) {
-            first = false;
-        } else {
-            out << ", ";
-        }
-        if (e) {
-            out << to_json_string(*t.get_elements_type(), *e);
-        } else {
-            out << "null";
+            write(out, "null");
         }
     });
-    out << ']';
-    return out.str();
+    write(out, "]");
 }
 
-static sstring to_json_string_aux(const tuple_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '[';
+static void to_json_aux(const tuple_type_impl& t, bytes_view bv, bytes_ostream& out) {
+    write(out, "[");
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            write(out, ", ");
         }
         if (*vi) {
-            // TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            to_json(**ti, **vi, out);
         } else {
-            out << "null";
+            write(out, "null");
         }
         ++ti;
         ++vi;
     }
 
-    out << ']';
-    return out.str();
+    write(out, "]");
 }
 
-static sstring to_json_string_aux(const user_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '{';
+static void to_json_aux(const user_type_impl& t, bytes_view bv, bytes_ostream& out) {
+    write(out, "{");
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     int i = 0;
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            write(out, ", ");
         }
-        out << quote_json_string(t.field_name_as_string(i)) << ": ";
+        write(out, quote_json_string(t.field_name_as_string(i)));
+        write(out, ": ");
         if (*vi) {
-            //TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            to_json(**ti, **vi, out);
         } else {
-            out << "null";
+            write(out, "null");
         }
         ++ti;
         ++i;
         ++vi;
     }
 
-    out << '}';
-    return out.str();
+    write(out, "}");
 }
 
 namespace {
-struct to_json_string_visitor {
+struct to_json_visitor {
     bytes_view bv;
-    sstring operator()(const reversed_type_impl& t) { return to_json_string(*t.underlying_type(), bv); }
-    template <typename T> sstring operator()(const integer_type_impl<T>& t) { return to_sstring(compose_value(t, bv)); }
-    template <typename T> sstring operator()(const floating_type_impl<T>& t) {
+    bytes_ostream& out;
+
+    void operator()(const reversed_type_impl& t) { to_json(*t.underlying_type(), bv, out); }
+    template <typename T> void operator()(const integer_type_impl<T>& t) {
+        // Formatted in place, as integers are the most common values.
+        char buf[std::numeric_limits<T>::digits10 + 3];
+        auto end = fmt::format_to(buf, "{}", int64_t(compose_value(t, bv)));
+        out.write(buf, end - buf);
+    }
+    template <typename T> void operator()(const floating_type_impl<T>& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
         T d = value_cast<T>(v);
         if (std::isnan(d) || std::isinf(d)) {
-            return "null";
-        }
-        return to_sstring(d);
-    }
-    sstring operator()(const uuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const inet_addr_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const string_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const bytes_type_impl& t) { return quote_json_string("0x" + t.to_string(bv)); }
-    sstring operator()(const boolean_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const timestamp_date_base_class& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const timeuuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const map_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const set_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const list_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const tuple_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const user_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const simple_date_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const time_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const empty_type_impl& t) { return "null"; }
-    sstring operator()(const duration_type_impl& t) {
+            write(out, "null");
+            return;
+        }
+        write(out, to_sstring(d));
+    }
+    void operator()(const uuid_type_impl& t) { write(out, quote_json_string(t.to_string(bv))); }
+    void operator()(const inet_addr_type_impl& t) { write(out, quote_json_string(t.to_string(bv))); }
+    void operator()(const string_type_impl& t) { write(out, quote_json_string(t.to_string(bv))); }
+    void operator()(const bytes_type_impl& t) { write(out, quote_json_string("0x" + t.to_string(bv))); }
+    void operator()(const boolean_type_impl& t) { write(out, t.to_string(bv)); }
+    void operator()(const timestamp_date_base_class& t) { write(out, quote_json_string(t.to_string(bv))); }
+    void operator()(const timeuuid_type_impl& t) { write(out, quote_json_string(t.to_string(bv))); }
+    void operator()(const map_type_impl& t) { to_json_aux(t, bv, out); }
+    void operator()(const set_type_impl& t) { to_json_aux(t, bv, out); }
+    void operator()(const list_type_impl& t) { to_json_aux(t, bv, out); }
+    void operator()(const tuple_type_impl& t) { to_json_aux(t, bv, out); }
+    void operator()(const user_type_impl& t) { to_json_aux(t, bv, out); }
+    void operator()(const simple_date_type_impl& t) { write(out, quote_json_string(t.to_string(bv))); }
+    void operator()(const time_type_impl& t) { write(out, t.to_string(bv)); }
+    void operator()(const empty_type_impl& t) { write(out, "null"); }
+    void operator()(const duration_type_impl& t) {
         auto v = t.deserialize(bv);
         if (v.is_null()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
-        return quote_json_string(t.to_string(bv));
+        write(out, quote_json_string(t.to_string(bv)));
     }
-    sstring operator()(const counter_type_impl& t) {
+    void operator()(const counter_type_impl& t) {
         // It will be called only from cql3 layer while processing query results.
-        return to_json_string(*counter_cell_view::total_value_type(), bv);
+        to_json(*counter_cell_view::total_value_type(), bv, out);
     }
-    sstring operator()(const decimal_type_impl& t) {
+    void operator()(const decimal_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<big_decimal>(v).to_string();
+        write(out, value_cast<big_decimal>(v).to_string());
     }
-    sstring operator()(const varint_type_impl& t) {
+    void operator()(const varint_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<utils::multiprecision_int>(v).str();
+        write(out, value_cast<utils::multiprecision_int>(v).str());
     }
 };
 }
 
+void to_json(const abstract_type& t, bytes_view bv, bytes_ostream& out) {
+    visit(t, to_json_visitor{bv, out});
+}
+
+void to_json(const abstract_type& t, const managed_bytes_view& mbv, bytes_ostream& out) {
+    with_linearized(mbv, [&] (bytes_view bv) {
+        to_json(t, bv, out);
+    });
+}
+
 sstring to_json_string(const abstract_type& t, bytes_view bv) {
-    return visit(t, to_json_string_visitor{bv});
+    bytes_ostream out;
+    to_json(t, bv, out);
+    auto linearized = out.linearize();
+    return sstring(reinterpret_cast<const char*>(linearized.data()), linearized.size());
 }
 
 sstring to_json_string(const abstract_type& t, const managed_bytes_view& mbv) {
-    return visit(t, to_json_string_visitor{linearized(mbv)});
+    return with_linearized(mbv, [&] (bytes_view bv) {
+        return to_json_string(t, bv);
+    });
 }
@@ -8,10 +8,17 @@
 
 #pragma once
 
+#include "bytes_ostream.hh"
 #include "types.hh"
 #include "utils/rjson.hh"
 
 bytes from_json_object(const abstract_type &t, const rjson::value& value);
+
+// Appends the JSON representation of a value to out, without building
+// intermediate strings for the elements of collections.
+void to_json(const abstract_type& t, bytes_view bv, bytes_ostream& out);
+void to_json(const abstract_type& t, const managed_bytes_view& bv, bytes_ostream& out);
+
 sstring to_json_string(const abstract_type &t, bytes_view bv);
 sstring to_json_string(const abstract_type &t, const managed_bytes_view& bv);
 
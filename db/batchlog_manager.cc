@@ -10,6 +10,7 @@
 
 #include <chrono>
 #include <exception>
+#include <unordered_map>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/do_with.hh>
 #include <seastar/core/semaphore.hh>
@@ -63,18 +64,11 @@ future<> db::batchlog_manager::do_batch_log_replay() {
         auto gate_holder = bm._gate.hold();
         auto sem_units = co_await get_units(bm._sem, 1);
 
-        auto dest = bm._cpu++ % smp::count;
-        blogger.debug("Batchlog replay on shard {}: starts", dest);
-        if (dest == 0) {
-            co_await bm.replay_all_failed_batches();
-        } else {
-            co_await bm.container().invoke_on(dest, [] (auto& bm) {
-                return with_gate(bm._gate, [&bm] {
-                    return bm.replay_all_failed_batches();
-                });
-            });
-        }
-        blogger.debug("Batchlog replay on shard {}: done", dest);
+        blogger.debug("Batchlog replay: starts");
+        co_await bm.container().invoke_on_all([] (auto& bm) {
+            return bm.replay_all_failed_batches();
+        });
+        blogger.debug("Batchlog replay: done");
     });
 }
 
@@ -106,8 +100,7 @@ future<> db::batchlog_manager::start() {
     // it in parallel on each shard. It will just overlap/interfere.  To
     // simplify syncing between batchlog_replay_loop and user initiated replay operations,
     // we use the _sem on shard zero only. Replaying batchlog can
-    // generate a lot of work, so we distrute the real work on all cpus with
-    // round-robin scheduling.
+    // generate a lot of work, so every cpu replays a part of the token ring.
     if (this_shard_id() == 0) {
         _started = batchlog_replay_loop();
     }
@@ -152,29 +145,30 @@ future<> db::batchlog_manager::replay_all_failed_batches() {
 
     // rate limit is in bytes per second. Uses Double.MAX_VALUE if disabled (set to 0 in cassandra.yaml).
     // max rate is scaled by the number of nodes in the cluster (same as for HHOM - see CASSANDRA-5272).
-    auto throttle = _replay_rate / _qp.proxy().get_token_metadata_ptr()->count_normal_token_owners();
+    // All shards replay at the same time, so each gets its share of it.
+    auto throttle = _replay_rate / _qp.proxy().get_token_metadata_ptr()->count_normal_token_owners() / smp::count;
     auto limiter = make_lw_shared<utils::rate_limiter>(throttle);
 
-    auto batch = [this, limiter](const cql3::untyped_result_set::row& row) {
+    auto batch = [this, limiter](const cql3::untyped_result_set::row& row) -> future<replay_status> {
         auto written_at = row.get_as<db_clock::time_point>("written_at");
         auto id = row.get_as<utils::UUID>("id");
         // enough time for the actual write + batchlog entry mutation delivery (two separate requests).
         auto timeout = get_batch_log_timeout();
         if (db_clock::now() < written_at + timeout) {
             blogger.debug("Skipping replay of {}, too fresh", id);
-            return make_ready_future<>();
+            return make_ready_future<replay_status>(replay_status::skipped);
         }
 
         // check version of serialization format
         if (!row.has("version")) {
             blogger.warn("Skipping logged batch because of unknown version");
-            return make_ready_future<>();
+            return make_ready_future<replay_status>(replay_status::skipped);
         }
 
         auto version = row.get_as<int32_t>("version");
         if (version != netw::messaging_service::current_version) {
             blogger.warn("Skipping logged batch because of incorrect version");
-            return make_ready_future<>();
+            return make_ready_future<replay_status>(replay_status::skipped);
         }
 
         auto data = row.get_blob("data");
@@ -188,23 +182,30 @@ future<> db::batchlog_manager::replay_all_failed_batches() {
         }
 
         auto size = data.size();
-
-        return map_reduce(*fms, [this, written_at] (canonical_mutation& fm) {
-            return system_keyspace::get_truncated_at(fm.column_family_id()).then([written_at, &fm] (db_clock::time_point t) ->
-                    std::optional<std::reference_wrapper<canonical_mutation>> {
-                if (written_at > t) {
-                    return { std::ref(fm) };
-                } else {
-                    return {};
-                }
+        // A batch usually modifies many partitions of few tables, so look up
+        // the truncation time of each table only once.
+        auto truncated_at = make_lw_shared<std::unordered_map<table_id, db_clock::time_point>>();
+        return do_for_each(*fms, [truncated_at] (canonical_mutation& fm) {
+            auto cf_id = fm.column_family_id();
+            if (truncated_at->contains(cf_id)) {
+                return make_ready_future<>();
+            }
+            return system_keyspace::get_truncated_at(cf_id).then([truncated_at, cf_id] (db_clock::time_point t) {
+                truncated_at->emplace(cf_id, t);
             });
-        },
-        std::vector<mutation>(),
-        [this] (std::vector<mutation> mutations, std::optional<std::reference_wrapper<canonical_mutation>> fm) {
-            if (fm) {
-                schema_ptr s = _qp.db().find_schema(fm.value().get().column_family_id());
-                mutations.emplace_back(fm.value().get().to_mutation(s));
+        }).then([this, written_at, fms, truncated_at] {
+            std::vector<mutation> mutations;
+            mutations.reserve(fms->size());
+            for (auto& fm : *fms) {
+                auto cf_id = fm.column_family_id();
+                if (written_at > truncated_at->at(cf_id)) {
+                    schema_ptr s = _qp.db().find_schema(cf_id);
+                    mutations.emplace_back(fm.to_mutation(s));
+                }
             }
+            // Send the mutations in token order, so those going to the same
+            // replicas are sent together.
+            std::ranges::sort(mutations, std::less<>(), [] (const mutation& m) { return m.token(); });
             return mutations;
         }).then([this, id, limiter, written_at, size, fms] (std::vector<mutation> mutations) {
             if (mutations.empty()) {
@@ -242,71 +243,93 @@ future<> db::batchlog_manager::replay_all_failed_batches() {
                 // See below, we use retry on write failure.
                 return _qp.proxy().mutate(mutations, db::consistency_level::ALL, db::no_timeout, nullptr, empty_service_permit(), db::allow_per_partition_rate_limit::no);
             });
-        }).then_wrapped([this, id](future<> batch_result) {
+        }).then_wrapped([id](future<> batch_result) {
             try {
                 batch_result.get();
             } catch (data_dictionary::no_such_keyspace& ex) {
                 // should probably ignore and drop the batch
             } catch (...) {
-                blogger.warn("Replay failed (will retry): {}", std::current_exception());
+                blogger.warn("Replay of {} failed (will retry): {}", id, std::current_exception());
                 // timeout, overload etc.
                 // Do _not_ remove the batch, assuning we got a node write error.
                 // Since we don't have hints (which origin is satisfied with),
                 // we have to resort to keeping this batch to next lap.
-                return make_ready_future<>();
+                return replay_status::failed;
             }
-            // delete batch
-            auto schema = _qp.db().find_schema(system_keyspace::NAME, system_keyspace::BATCHLOG);
-            auto key = partition_key::from_singular(*schema, id);
-            mutation m(schema, key);
-            auto now = service::client_state(service::client_state::internal_tag()).get_timestamp();
-            m.partition().apply_delete(*schema, clustering_key_prefix::make_empty(), tombstone(now, gc_clock::now()));
-            return _qp.proxy().mutate_locally(m, tracing::trace_state_ptr(), db::commitlog::force_sync::no);
+            return replay_status::replayed;
         });
     };
 
-    return seastar::with_gate(_gate, [this, batch = std::move(batch)] {
-        blogger.debug("Started replayAllFailedBatches (cpu {})", this_shard_id());
-
-        typedef ::shared_ptr<cql3::untyped_result_set> page_ptr;
-        sstring query = format("SELECT id, data, written_at, version FROM {}.{} LIMIT {:d}", system_keyspace::NAME, system_keyspace::BATCHLOG, page_size);
-        return _qp.execute_internal(query, cql3::query_processor::cache_internal::yes).then([this, batch = std::move(batch)](page_ptr page) {
-            return do_with(std::move(page), [this, batch = std::move(batch)](page_ptr & page) mutable {
-                return repeat([this, &page, batch = std::move(batch)]() mutable {
-                    if (page->empty()) {
-                        return make_ready_future<stop_iteration>(stop_iteration::yes);
-                    }
-                    auto id = page->back().get_as<utils::UUID>("id");
-                    return parallel_for_each(*page, batch).then([this, &page, id]() {
-                        if (page->size() < page_size) {
-                            return make_ready_future<stop_iteration>(stop_iteration::yes); // we've exhausted the batchlog, next query would be empty.
-                        }
-                        sstring query = format("SELECT id, data, written_at, version FROM {}.{} WHERE token(id) > token(?) LIMIT {:d}",
-                                system_keyspace::NAME,
-                                system_keyspace::BATCHLOG,
-                                page_size);
-                        return _qp.execute_internal(query, {id}, cql3::query_processor::cache_internal::yes).then([&page](auto res) {
-                                    page = std::move(res);
-                                    return make_ready_future<stop_iteration>(stop_iteration::no);
-                                });
-                    });
-                });
-            });
-        }).then([this] {
-        // TODO FIXME : cleanup()
-#if 0
-            ColumnFamilyStore cfs = Keyspace.open(SystemKeyspace.NAME).getColumnFamilyStore(SystemKeyspace.BATCHLOG);
-            cfs.forceBlockingFlush();
-            Collection<Descriptor> descriptors = new ArrayList<>();
-            for (SSTableReader sstr : cfs.getSSTables())
-            descriptors.add(sstr.descriptor);
-            if (!descriptors.isEmpty()) // don't pollute the logs if there is nothing to compact.
-            CompactionManager.instance.submitUserDefined(cfs, descriptors, Integer.MAX_VALUE).get();
+    auto gate_holder = _gate.hold();
 
-#endif
+    // Each shard replays the batches of its share of the token ring, so a
+    // large batchlog is replayed by all of them at once.
+    auto [first_token, last_token] = replay_token_range(this_shard_id(), smp::count);
+    blogger.debug("Started replayAllFailedBatches (cpu {}, tokens ({}, {}])", this_shard_id(), first_token, last_token);
+
+    auto schema = _qp.db().find_schema(system_keyspace::NAME, system_keyspace::BATCHLOG);
+    sstring query = format("SELECT id, data, written_at, version, token(id) AS t FROM {}.{} WHERE token(id) > ? AND token(id) <= ? LIMIT {:d}",
+            system_keyspace::NAME, system_keyspace::BATCHLOG, page_size);
+    while (!_stop.abort_requested()) {
+        auto page = co_await _qp.execute_internal(query, {first_token, last_token}, cql3::query_processor::cache_internal::yes);
+        if (page->empty()) {
+            break;
+        }
+        first_token = page->back().get_as<int64_t>("t");
 
-        }).then([this] {
-            blogger.debug("Finished replayAllFailedBatches");
+        // The batches replayed successfully are removed from the batchlog
+        // together, once the whole page is done.
+        std::vector<mutation> replayed;
+        size_t failed = 0;
+        co_await max_concurrent_for_each(*page, _replay_concurrency, [&] (const cql3::untyped_result_set::row& row) -> future<> {
+            auto id = row.get_as<utils::UUID>("id");
+            switch (co_await batch(row)) {
+            case replay_status::replayed: {
+                mutation m(schema, partition_key::from_singular(*schema, id));
+                auto now = service::client_state(service::client_state::internal_tag()).get_timestamp();
+                m.partition().apply_delete(*schema, clustering_key_prefix::make_empty(), tombstone(now, gc_clock::now()));
+                replayed.push_back(std::move(m));
+                break;
+            }
+            case replay_status::failed:
+                ++failed;
+                break;
+            case replay_status::skipped:
+                break;
+            }
         });
-    });
+        _total_batches_replayed += replayed.size();
+        if (!replayed.empty()) {
+            co_await _qp.proxy().mutate_locally(std::move(replayed), tracing::trace_state_ptr());
+        }
+
+        // Back off when the replicas can't keep up with the replay, and
+        // speed up again once they do.
+        if (failed) {
+            _replay_concurrency = std::max<size_t>(_replay_concurrency / 2, 1);
+        } else {
+            _replay_concurrency = std::min<size_t>(_replay_concurrency * 2, page_size);
+        }
+        blogger.debug("Replayed a page of {} batches, {} failed, concurrency is now {}", page->size(), failed, _replay_concurrency);
+
+        if (page->size() < page_size) {
+            break; // we've exhausted the batchlog, next query would be empty.
+        }
+    }
+
+    blogger.debug("Finished replayAllFailedBatches");
+}
+
+std::pair<int64_t, int64_t> db::batchlog_manager::replay_token_range(unsigned shard, unsigned shard_count) {
+    // The tokens are int64_t's, above the minimum token, which is
+    // std::numeric_limits<int64_t>::min(). The range of each shard starts
+    // after the end of the previous one.
+    const uint64_t span = std::numeric_limits<uint64_t>::max() / shard_count;
+    auto bound = [&] (unsigned i) {
+        if (i == shard_count) {
+            return std::numeric_limits<int64_t>::max();
+        }
+        return static_cast<int64_t>(static_cast<uint64_t>(std::numeric_limits<int64_t>::min()) + i * span);
+    };
+    return {bound(shard), bound(shard + 1)};
 }
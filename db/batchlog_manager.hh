@@ -48,6 +48,14 @@ class batchlog_manager : public peering_sharded_service<batchlog_manager> {
 
     using clock_type = lowres_clock;
 
+    enum class replay_status {
+        // The batch was written to its replicas, or doesn't need to be.
+        replayed,
+        // The batch is kept for the next replay.
+        skipped,
+        failed,
+    };
+
     struct stats {
         uint64_t write_attempts = 0;
     } _stats;
@@ -62,7 +70,9 @@ class batchlog_manager : public peering_sharded_service<batchlog_manager> {
     std::chrono::milliseconds _delay;
     semaphore _sem{1};
     seastar::gate _gate;
-    unsigned _cpu = 0;
+    // The number of batches this shard replays at the same time. Halved
+    // when replays fail and doubled when a page replays fine, up to page_size.
+    size_t _replay_concurrency = page_size;
     seastar::abort_source _stop;
 
     future<> replay_all_failed_batches();
@@ -84,6 +94,10 @@ class batchlog_manager : public peering_sharded_service<batchlog_manager> {
         return _total_batches_replayed;
     }
     db_clock::duration get_batch_log_timeout() const;
+
+    // The range of tokens, (first, second], whose batches the given shard
+    // replays. The ranges of all shards cover the token ring.
+    static std::pair<int64_t, int64_t> replay_token_range(unsigned shard, unsigned shard_count);
 private:
     future<> batchlog_replay_loop();
 };
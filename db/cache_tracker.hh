@@ -10,6 +10,8 @@
 
 #include "utils/lru.hh"
 #include "utils/logalloc.hh"
+#include "utils/frequency_sketch.hh"
+#include "dht/token.hh"
 #include "partition_version.hh"
 #include "mutation_cleaner.hh"
 
@@ -36,6 +38,26 @@ class cache_tracker final {
     friend class cache::read_context;
     friend class cache::autoupdating_underlying_reader;
     friend class cache::cache_flat_mutation_reader;
+    // Decides which partitions missing in cache are populated by reads.
+    enum class admission_policy {
+        // Every partition read is populated.
+        all,
+        // A partition is populated only when read again shortly after a miss
+        // (TinyLFU-like, with a frequency sketch of recent accesses), and
+        // range scans bypass cache. Reads touching data only once, like
+        // full scans, don't evict the working set.
+        frequency,
+    };
+    // Decides which rows are evicted first.
+    enum class eviction_policy {
+        // Least recently used first.
+        lru,
+        // Least recently used first, but rows read since they last came to
+        // the front of the LRU are spared once ("second chance", like CLOCK).
+        // Rows read only once, like by scans, are evicted before those read
+        // repeatedly, even if more recently used.
+        second_chance,
+    };
     struct stats {
         uint64_t partition_hits;
         uint64_t partition_misses;
@@ -66,6 +88,9 @@ class cache_tracker final {
         uint64_t pinned_dirty_memory_overload;
         uint64_t range_tombstone_reads;
         uint64_t row_tombstone_reads;
+        uint64_t partition_admissions;
+        uint64_t partition_rejections;
+        uint64_t range_scan_bypasses;
 
         uint64_t active_reads() const {
             return reads - reads_done;
@@ -79,6 +104,9 @@ class cache_tracker final {
     mutation_cleaner _garbage;
     mutation_cleaner _memtable_cleaner;
     mutation_application_stats& _app_stats;
+    admission_policy _admission_policy = admission_policy::all;
+    eviction_policy _eviction_policy = eviction_policy::lru;
+    std::optional<utils::frequency_sketch> _access_sketch;
 private:
     void setup_metrics();
 public:
@@ -88,10 +116,14 @@ class cache_tracker final {
     ~cache_tracker();
     void clear();
     void touch(rows_entry&);
+    // Like touch(rows_entry&) and insert(rows_entry&), also applying
+    // the eviction priority of the table the entry belongs to.
+    void touch(rows_entry&, const schema&);
     void insert(cache_entry&);
     void insert(partition_entry&) noexcept;
     void insert(partition_version&) noexcept;
     void insert(rows_entry&) noexcept;
+    void insert(rows_entry&, const schema&) noexcept;
     void remove(rows_entry&) noexcept;
     void clear_continuity(cache_entry& ce) noexcept;
     void on_partition_erase() noexcept;
@@ -120,6 +152,21 @@ class cache_tracker final {
     const stats& get_stats() const noexcept { return _stats; }
     void set_compaction_scheduling_group(seastar::scheduling_group);
     lru& get_lru() { return _lru; }
+
+    void set_admission_policy(admission_policy) noexcept;
+    admission_policy get_admission_policy() const noexcept { return _admission_policy; }
+    void set_eviction_policy(eviction_policy p) noexcept { _eviction_policy = p; }
+    eviction_policy get_eviction_policy() const noexcept { return _eviction_policy; }
+    // Records a read of a partition present in cache, for the admission policy.
+    void on_access(dht::token t) noexcept {
+        if (_access_sketch) {
+            _access_sketch->increment(uint64_t(t.raw()));
+        }
+    }
+    // Records a read of a partition missing in cache.
+    // Returns true iff the read should populate cache with the partition.
+    bool admit(dht::token t) noexcept;
+    void on_range_scan_bypass() noexcept { ++_stats.range_scan_bypasses; }
 };
 
 inline
@@ -12,6 +12,7 @@
 #include <sys/stat.h>
 #include <malloc.h>
 #include <regex>
+#include <cmath>
 #include <filesystem>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/adaptor/reversed.hpp>
@@ -36,6 +37,7 @@
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/net/byteorder.hh>
+#include <seastar/core/byteorder.hh>
 #include <seastar/util/defer.hh>
 
 #include "seastarx.hh"
@@ -53,6 +55,7 @@
 #include "commitlog_extensions.hh"
 #include "service/priority_manager.hh"
 #include "serializer.hh"
+#include "utils/fragment_range.hh"
 
 #include <boost/range/numeric.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -60,6 +63,8 @@
 #include "checked-file-impl.hh"
 #include "utils/disk-error-handler.hh"
 
+#include <lz4.h>
+
 static logging::logger clogger("commitlog");
 
 using namespace std::chrono_literals;
@@ -104,10 +109,14 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     c.commitlog_total_space_in_mb = cfg.commitlog_total_space_in_mb() >= 0 ? cfg.commitlog_total_space_in_mb() : (shard_available_memory * smp::count) >> 20;
     c.commitlog_segment_size_in_mb = cfg.commitlog_segment_size_in_mb();
     c.commitlog_sync_period_in_ms = cfg.commitlog_sync_period_in_ms();
-    c.mode = cfg.commitlog_sync() == "batch" ? sync_mode::BATCH : sync_mode::PERIODIC;
+    c.mode = cfg.commitlog_sync() == "batch" || cfg.commitlog_sync() == "group" ? sync_mode::BATCH : sync_mode::PERIODIC;
+    if (cfg.commitlog_sync() == "group") {
+        c.commitlog_sync_group_window_in_us = cfg.commitlog_sync_group_window_in_us();
+    }
     c.extensions = &cfg.extensions();
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
     c.allow_going_over_size_limit = !cfg.commitlog_use_hard_size_limit();
+    c.use_compression = cfg.commitlog_use_compression();
 
     if (cfg.commitlog_flush_threshold_in_mb() >= 0) {
         c.commitlog_flush_threshold_in_mb = cfg.commitlog_flush_threshold_in_mb();
@@ -379,6 +388,12 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         uint64_t requests_blocked_memory = 0;
         uint64_t blocked_on_new_segment = 0;
         uint64_t active_allocations = 0;
+        uint64_t group_commits = 0;
+        uint64_t group_commit_writes = 0;
+        uint64_t entries_compressed = 0;
+        uint64_t bytes_saved_by_compression = 0;
+        uint64_t segment_allocation_waits = 0;
+        uint64_t segment_allocation_wait_us = 0;
     };
 
     class scope_increment_counter {
@@ -416,6 +431,24 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         _flush_semaphore.signal();
         --totals.pending_flushes;
     }
+
+    // Moving average of file flush latency, used to size the group commit window.
+    std::chrono::microseconds flush_latency{0};
+
+    void update_flush_latency(std::chrono::steady_clock::duration d) noexcept {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(d);
+        flush_latency = flush_latency.count() ? (flush_latency * 7 + us) / 8 : us;
+    }
+    // How long a batch mode write which would initiate a flush waits for others
+    // to join it. Waiting for a fraction of a flush lets writes which arrive in
+    // the meantime share it, at a small cost in latency. A lone writer has
+    // no one to wait for, so it flushes right away.
+    std::chrono::microseconds group_commit_window() const noexcept {
+        if (!cfg.commitlog_sync_group_window_in_us || totals.active_allocations <= 1) {
+            return std::chrono::microseconds(0);
+        }
+        return std::min(std::chrono::microseconds(cfg.commitlog_sync_group_window_in_us), flush_latency / 2);
+    }
     segment_manager(config c);
     ~segment_manager() {
         clogger.trace("Commitlog {} disposed", cfg.commit_log_location);
@@ -508,7 +541,13 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     replay_position _flush_position;
     timer<clock_type> _timer;
     future<> replenish_reserve();
+    void adjust_reserve_to_write_rate();
     future<> _reserve_replenisher;
+    // Moving averages of the time it takes to allocate a segment, and of the
+    // time between segments being taken from the reserve.
+    std::chrono::duration<double, std::micro> _avg_segment_allocation_time{0};
+    std::chrono::duration<double, std::micro> _avg_segment_use_interval{0};
+    std::optional<std::chrono::steady_clock::time_point> _last_segment_use;
     future<> _background_sync;
     seastar::gate _gate;
     uint64_t _new_counter = 0;
@@ -695,6 +734,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
 
     uint64_t _num_allocs = 0;
 
+    // Flush of the current group commit, joined by batch mode writes until it starts.
+    std::optional<shared_future<with_clock<db::timeout_clock>>> _group_commit;
+
     std::unordered_set<table_schema_version> _known_schema_versions;
 
     friend std::ostream& operator<<(std::ostream&, const segment&);
@@ -731,6 +773,13 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     static constexpr size_t descriptor_header_size = 5 * sizeof(uint32_t);
     static constexpr uint32_t segment_magic = ('S'<<24) |('C'<< 16) | ('L' << 8) | 'C';
     static constexpr uint32_t multi_entry_size_magic = 0xffffffff;
+    // Set in the size of a compressed entry (segment_version_3). The data of
+    // a compressed entry is the size of the entry, followed by the entry
+    // compressed with lz4. The checksum covers the compressed data.
+    static constexpr uint32_t compressed_entry_flag = 0x80000000;
+    // Larger entries are not compressed, so that neither compressing nor
+    // decompressing them needs large contiguous buffers.
+    static constexpr size_t max_compressed_entry_size = 128 * 1024;
 
     // The commit log (chained) sync marker/header size in bytes (int: length + int: checksum [segmentId, position])
     static constexpr size_t sync_marker_size = 2 * sizeof(uint32_t);
@@ -908,7 +957,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         }
 
         try {
+            auto start = std::chrono::steady_clock::now();
             co_await _file.flush();
+            _segment_manager->update_flush_latency(std::chrono::steady_clock::now() - start);
             // TODO: retry/ignore/fail/stop - optional behaviour in origin.
             // we fast-fail the whole commit.
             _flush_pos = std::max(pos, _flush_pos);
@@ -1067,6 +1118,14 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         co_return me;
     }
 
+    future<> group_commit(std::chrono::microseconds window) {
+        auto me = shared_from_this();
+        co_await seastar::sleep(window);
+        // Writes from now on start a new group.
+        _group_commit.reset();
+        co_await sync();
+    }
+
     future<sseg_ptr> batch_cycle(timeout_clock::time_point timeout) {
         /**
          * For batch mode we force a write "immediately".
@@ -1075,11 +1134,27 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
          *
          * This has the benefit of allowing several allocations to
          * queue up in a single buffer.
+         *
+         * With group commit, the write and flush are additionally delayed
+         * by a short window, so that concurrent writers share them.
          */
         auto me = shared_from_this();
         auto fp = _file_pos;
         try {
             co_await _pending_ops.wait_for_pending(timeout);
+            if (fp == _file_pos && (_group_commit || _segment_manager->cfg.commitlog_sync_group_window_in_us)) {
+                if (!_group_commit) {
+                    auto window = _segment_manager->group_commit_window();
+                    if (window.count()) {
+                        ++_segment_manager->totals.group_commits;
+                        _group_commit.emplace(group_commit(window));
+                    }
+                }
+                if (_group_commit) {
+                    ++_segment_manager->totals.group_commit_writes;
+                    co_await _group_commit->get_future(timeout);
+                }
+            }
             if (fp != _file_pos) {
                 // some other request already wrote this buffer.
                 // If so, wait for the operation at our intended file offset
@@ -1118,6 +1193,67 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         });
     }
 
+    // An entry serialized ahead of being written, so that it can be compressed.
+    struct serialized_entry {
+        bytes data;
+        bool compressed;
+    };
+
+    // Serializes and compresses the entries of a write, if the segment allows
+    // compressed entries. Entries which lz4 does not make smaller are kept as
+    // they are. Entries which are not serialized ahead are returned disengaged.
+    std::vector<std::optional<serialized_entry>> compress_entries(entry_writer& writer, size_t size) {
+        std::vector<std::optional<serialized_entry>> ret(writer.num_entries);
+        if (_desc.ver < descriptor::segment_version_3) {
+            return ret;
+        }
+        for (size_t entry = 0; entry < writer.num_entries; ++entry) {
+            auto entry_size = writer.num_entries == 1 ? size : writer.size(*this, entry);
+            if (entry_size > max_compressed_entry_size) {
+                continue;
+            }
+            auto buf = fragmented_temporary_buffer::allocate_to_fit(entry_size);
+            auto entry_out = buf.get_ostream();
+            writer.write(*this, entry_out, entry);
+            ret[entry] = with_linearized(fragmented_temporary_buffer::view(buf), [] (bytes_view in) {
+                auto bound = LZ4_compressBound(in.size());
+                bytes out(bytes::initialized_later(), sizeof(uint32_t) + bound);
+                auto dst = reinterpret_cast<char*>(out.data());
+                write_be<uint32_t>(dst, in.size());
+                auto len = LZ4_compress_default(reinterpret_cast<const char*>(in.data()), dst + sizeof(uint32_t), in.size(), bound);
+                if (len <= 0 || sizeof(uint32_t) + len >= in.size()) {
+                    return serialized_entry{bytes(in), false};
+                }
+                out.resize(sizeof(uint32_t) + len);
+                return serialized_entry{std::move(out), true};
+            });
+        }
+        return ret;
+    }
+
+    // Decompresses the data of a compressed entry. Returns a disengaged
+    // optional if the data is malformed.
+    static std::optional<fragmented_temporary_buffer> decompress_entry(const fragmented_temporary_buffer& buf) {
+        return with_linearized(fragmented_temporary_buffer::view(buf), [] (bytes_view in) -> std::optional<fragmented_temporary_buffer> {
+            if (in.size() < sizeof(uint32_t)) {
+                return std::nullopt;
+            }
+            auto size = read_be<uint32_t>(reinterpret_cast<const char*>(in.data()));
+            if (size > max_compressed_entry_size) {
+                return std::nullopt;
+            }
+            in.remove_prefix(sizeof(uint32_t));
+            temporary_buffer<char> out(size);
+            auto len = LZ4_decompress_safe(reinterpret_cast<const char*>(in.data()), out.get_write(), in.size(), size);
+            if (len < 0 || size_t(len) != size) {
+                return std::nullopt;
+            }
+            std::vector<temporary_buffer<char>> fragments;
+            fragments.push_back(std::move(out));
+            return fragmented_temporary_buffer(std::move(fragments), size);
+        });
+    }
+
     enum class write_result {
         ok,
         must_sync,
@@ -1163,6 +1299,18 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             throw std::runtime_error("commitlog: Cannot add data to a closed segment");
         }
 
+        auto serialized = compress_entries(writer, size);
+        size_t saved = 0;
+        for (size_t entry = 0; entry < writer.num_entries; ++entry) {
+            if (serialized[entry] && serialized[entry]->compressed) {
+                auto entry_size = writer.num_entries == 1 ? size : writer.size(*this, entry);
+                saved += entry_size - serialized[entry]->data.size();
+                ++_segment_manager->totals.entries_compressed;
+            }
+        }
+        _segment_manager->totals.bytes_saved_by_compression += saved;
+        buf_memory -= saved;
+
         buf_memory -= permit.release();
         _segment_manager->account_memory_usage(buf_memory);
 
@@ -1182,17 +1330,21 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         if (writer.num_entries > 1) {
             mecrc.emplace();
             write<uint32_t>(out, multi_entry_size_magic);
-            write<uint32_t>(out, s);
+            write<uint32_t>(out, s - saved);
             mecrc->process(multi_entry_size_magic);
-            mecrc->process(uint32_t(s));
+            mecrc->process(uint32_t(s - saved));
             write<uint32_t>(out, mecrc->checksum());
         }
 
         for (size_t entry = 0; entry < writer.num_entries; ++entry) {
             replay_position rp(_desc.id, position());
             auto id = writer.id(entry);
-            auto entry_size = writer.num_entries == 1 ? size : writer.size(*this, entry);
-            auto es = entry_size + entry_overhead_size;
+            auto& se = serialized[entry];
+            auto entry_size = se ? se->data.size() : writer.num_entries == 1 ? size : writer.size(*this, entry);
+            uint32_t es = entry_size + entry_overhead_size;
+            if (se && se->compressed) {
+                es |= compressed_entry_flag;
+            }
 
             _cf_dirty[id]++; // increase use count for cf.
 
@@ -1201,16 +1353,21 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             crc32_nbo crc;
 
             write<uint32_t>(out, es);
-            crc.process(uint32_t(es));
+            crc.process(es);
             write<uint32_t>(out, crc.checksum());
 
             // actual data
-            auto entry_out = out.write_substream(entry_size);
-            auto entry_data = entry_out.to_input_stream();
-            writer.write(*this, entry_out, entry);
-            entry_data.with_stream([&] (auto data_str) {
-                crc.process_fragmented(ser::buffer_view<typename std::vector<temporary_buffer<char>>::iterator>(data_str));
-            });
+            if (se) {
+                out.write(reinterpret_cast<const char*>(se->data.data()), se->data.size());
+                crc.process_bytes(se->data.data(), se->data.size());
+            } else {
+                auto entry_out = out.write_substream(entry_size);
+                auto entry_data = entry_out.to_input_stream();
+                writer.write(*this, entry_out, entry);
+                entry_data.with_stream([&] (auto data_str) {
+                    crc.process_fragmented(ser::buffer_view<typename std::vector<temporary_buffer<char>>::iterator>(data_str));
+                });
+            }
 
             auto checksum = crc.checksum();
             write<uint32_t>(out, checksum);
@@ -1402,6 +1559,29 @@ size_t db::commitlog::segment_manager::max_request_controller_units() const {
     return max_mutation_size + db::commitlog::segment::default_size;
 }
 
+static void update_moving_average(std::chrono::duration<double, std::micro>& avg, std::chrono::steady_clock::duration sample) {
+    static constexpr double alpha = 0.2;
+    if (avg.count() == 0) {
+        avg = sample;
+    } else {
+        avg = avg * (1 - alpha) + std::chrono::duration<double, std::micro>(sample) * alpha;
+    }
+}
+
+// Grows the reserve to the number of segments the writes use up while a
+// segment is being allocated, so that they need not wait for one.
+void db::commitlog::segment_manager::adjust_reserve_to_write_rate() {
+    if (_avg_segment_use_interval.count() <= 0) {
+        return;
+    }
+    auto needed = size_t(std::ceil(_avg_segment_allocation_time / _avg_segment_use_interval)) + 1;
+    auto target = std::min<size_t>(needed, cfg.max_reserve_segments);
+    if (_reserve_segments.max_size() < target && (totals.total_size_on_disk + max_size) <= max_disk_size) {
+        _reserve_segments.set_max_size(target);
+        clogger.debug("Increased segment reserve count to {} to keep up with the write rate", target);
+    }
+}
+
 future<> db::commitlog::segment_manager::replenish_reserve() {
     while (!_shutdown) {
         co_await _reserve_segments.not_full();
@@ -1415,7 +1595,9 @@ future<> db::commitlog::segment_manager::replenish_reserve() {
             // trust that flush logic will absolutely free up an existing 
             // segment (because colocation stuff etc), so always allow a new
             // file if needed. That and performance stuff...
+            auto start = std::chrono::steady_clock::now();
             auto s = co_await allocate_segment();
+            update_moving_average(_avg_segment_allocation_time, std::chrono::steady_clock::now() - start);
             auto ret = _reserve_segments.push(std::move(s));
             if (!ret) {
                 clogger.error("Segment reserve is full! Ignoring and trying to continue, but shouldn't happen");
@@ -1579,6 +1761,35 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
 
         sm::make_gauge("active_allocations", totals.active_allocations,
                        sm::description("Current number of active allocations.")),
+
+        sm::make_counter("group_commits", totals.group_commits,
+                       sm::description("Counts number of group commits, i.e. flushes whose start was delayed for concurrent writes to join them.")),
+
+        sm::make_counter("group_commit_writes", totals.group_commit_writes,
+                       sm::description("Counts number of writes which were made durable by a group commit. "
+                                       "Divide this value by \"group_commits\" to get the average size of a group.")),
+
+        sm::make_gauge("reserve_segments", [this] { return _reserve_segments.size(); },
+                       sm::description("Holds the current number of segments allocated ahead of being used.")),
+
+        sm::make_gauge("recycled_segments", [this] { return _recycled_segments.size(); },
+                       sm::description("Holds the current number of segment files waiting to be reused.")),
+
+        sm::make_counter("segment_allocation_waits", totals.segment_allocation_waits,
+                       sm::description("Counts number of times writes had to wait for a segment to be allocated. "
+                                       "A non-zero value indicates that the segment reserve does not keep up with the write rate.")),
+
+        sm::make_counter("segment_allocation_wait_us", totals.segment_allocation_wait_us,
+                       sm::description("Counts the total time, in microseconds, writes waited for a segment to be allocated.")),
+
+        sm::make_counter("entries_compressed", totals.entries_compressed,
+                       sm::description("Counts number of entries which were written compressed.")),
+
+        sm::make_counter("bytes_saved_by_compression", totals.bytes_saved_by_compression,
+                       sm::description("Counts number of bytes which compressing entries saved from being written.")),
+
+        sm::make_gauge("group_commit_window", [this] { return std::min(cfg.commitlog_sync_group_window_in_us, uint64_t(flush_latency.count() / 2)); },
+                       sm::description("Holds the current group commit window in microseconds, derived from the observed flush latency.")),
     });
 }
 
@@ -1768,7 +1979,7 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
 
 future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment() {
     for (;;) {
-        descriptor d(next_id(), cfg.fname_prefix);
+        descriptor d(next_id(), cfg.fname_prefix, cfg.use_compression ? descriptor::segment_version_3 : descriptor::segment_version_2);
         auto dst = filename(d);
         auto flags = open_flags::wo;
         if (cfg.use_o_dsync) {
@@ -1817,6 +2028,12 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
 
     ++_new_counter;
 
+    auto now = std::chrono::steady_clock::now();
+    if (_last_segment_use) {
+        update_moving_average(_avg_segment_use_interval, now - *_last_segment_use);
+    }
+    _last_segment_use = now;
+
     if (_reserve_segments.empty()) {        
         // don't increase reserve count if we are at max, or we would go over disk limit. 
         if (_reserve_segments.max_size() < cfg.max_reserve_segments && (totals.total_size_on_disk + max_size) <= max_disk_size) {
@@ -1831,7 +2048,14 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
         }
     }
 
+    adjust_reserve_to_write_rate();
+
+    auto wait = _reserve_segments.empty();
     auto s = co_await _reserve_segments.pop_eventually();
+    if (wait) {
+        ++totals.segment_allocation_waits;
+        totals.segment_allocation_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - now).count();
+    }
     _segments.push_back(s);
     _segments.back()->reset_sync_time();
     co_return s;
@@ -2785,6 +3009,12 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
                 co_return;
             }
 
+            bool compressed = false;
+            if (d.ver >= descriptor::segment_version_3 && (size & segment::compressed_entry_flag)) {
+                compressed = true;
+                size &= ~segment::compressed_entry_flag;
+            }
+
             if (size < 3 * sizeof(uint32_t) || checksum != crc.checksum()) {
                 auto slack = next - pos;
                 if (size != 0) {
@@ -2817,6 +3047,16 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, seastar::io_priority
                 co_return;
             }
 
+            if (compressed) {
+                auto decompressed = segment::decompress_entry(buf);
+                if (!decompressed) {
+                    clogger.debug("Segment entry at {} cannot be decompressed. Skipping {} bytes", rp, size);
+                    corrupt_size += size;
+                    co_return;
+                }
+                buf = std::move(*decompressed);
+            }
+
             co_await pf({std::move(buf), rp}, checksum);
         }
 
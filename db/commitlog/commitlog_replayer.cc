@@ -15,6 +15,8 @@
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/as_future.hh>
 
 #include "commitlog.hh"
 #include "commitlog_replayer.hh"
@@ -81,7 +83,24 @@ class db::commitlog_replayer::impl {
         return _column_mappings.stop();
     }
 
-    future<> process(stats*, commitlog::buffer_and_replay_position buf_rp) const;
+    // An entry read from a segment, to be applied on the shard which owns it.
+    struct replay_entry {
+        commitlog_entry_reader cer;
+        const column_mapping* cm;
+        replay_position rp;
+    };
+    // Entries are sent to their shards in batches, rather than one by one,
+    // so that reading segments does not wait for a round trip per entry.
+    struct replay_batch {
+        std::vector<replay_entry> entries;
+        size_t bytes = 0;
+    };
+    static constexpr size_t max_batch_entries = 128;
+    static constexpr size_t max_batch_bytes = 1 << 20;
+
+    future<> process(stats*, std::vector<replay_batch>* batches, commitlog::buffer_and_replay_position buf_rp) const;
+    future<> apply_batch(stats*, unsigned shard, replay_batch batch) const;
+    future<stats> apply_entries(replica::database& db, std::vector<replay_entry>& entries) const;
     future<stats> recover(sstring file, const sstring& fname_prefix) const;
 
     typedef std::unordered_map<table_id, replay_position> rp_map;
@@ -185,31 +204,33 @@ db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix)
 
     if (rp.id < gp.id) {
         rlogger.debug("skipping replay of fully-flushed {}", file);
-        return make_ready_future<stats>();
+        co_return stats();
     }
     position_type p = 0;
     if (rp.id == gp.id) {
         p = gp.pos;
     }
 
-    auto s = make_lw_shared<stats>();
+    stats s;
+    std::vector<replay_batch> batches(smp::count);
     auto& exts = _db.local().extensions();
 
-    return db::commitlog::read_log_file(file, fname_prefix, service::get_local_commitlog_priority(),
-            std::bind(&impl::process, this, s.get(), std::placeholders::_1),
-            p, &exts).then_wrapped([s](future<> f) {
-        try {
-            f.get();
-        } catch (commitlog::segment_data_corruption_error& e) {
-            s->corrupt_bytes += e.bytes();
-        } catch (...) {
-            throw;
+    try {
+        co_await db::commitlog::read_log_file(file, fname_prefix, service::get_local_commitlog_priority(),
+                std::bind(&impl::process, this, &s, &batches, std::placeholders::_1),
+                p, &exts);
+    } catch (commitlog::segment_data_corruption_error& e) {
+        s.corrupt_bytes += e.bytes();
+    }
+    for (unsigned shard = 0; shard < batches.size(); ++shard) {
+        if (!batches[shard].entries.empty()) {
+            co_await apply_batch(&s, shard, std::move(batches[shard]));
         }
-        return make_ready_future<stats>(*s);
-    });
+    }
+    co_return s;
 }
 
-future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_replay_position buf_rp) const {
+future<> db::commitlog_replayer::impl::process(stats* s, std::vector<replay_batch>* batches, commitlog::buffer_and_replay_position buf_rp) const {
     auto&& buf = buf_rp.buffer;
     auto&& rp = buf_rp.position;
     try {
@@ -246,8 +267,59 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
 
         const auto& schema = *_db.local().find_column_family(uuid).schema();
         auto shard = fm.shard_of(schema);
-        return _db.invoke_on(shard, [this, cer = std::move(cer), &src_cm, rp, shard, s] (replica::database& db) mutable -> future<> {
-            auto& fm = cer.mutation();
+        auto& batch = (*batches)[shard];
+        batch.bytes += fm.representation().size();
+        batch.entries.push_back(replay_entry{std::move(cer), &src_cm, rp});
+        if (batch.entries.size() < max_batch_entries && batch.bytes < max_batch_bytes) {
+            return make_ready_future<>();
+        }
+        return apply_batch(s, shard, std::exchange(batch, {}));
+    } catch (replica::no_such_column_family&) {
+        // No such CF now? Origin just ignores this.
+    } catch (...) {
+        s->invalid_mutations++;
+        // TODO: write mutation to file like origin.
+        rlogger.warn("error replaying: {}", std::current_exception());
+    }
+
+    return make_ready_future<>();
+}
+
+future<> db::commitlog_replayer::impl::apply_batch(stats* s, unsigned shard, replay_batch batch) const {
+    return _db.invoke_on(shard, [this, entries = std::move(batch.entries)] (replica::database& db) mutable {
+        return do_with(std::move(entries), [this, &db] (std::vector<replay_entry>& entries) {
+            return apply_entries(db, entries);
+        });
+    }).then([s] (stats applied) {
+        *s += applied;
+    });
+}
+
+future<db::commitlog_replayer::impl::stats>
+db::commitlog_replayer::impl::apply_entries(replica::database& db, std::vector<replay_entry>& entries) const {
+    stats s;
+    // Consecutive mutations of a table at its current schema version are
+    // applied to the memtable in bulk.
+    std::vector<const frozen_mutation*> bulk;
+    schema_ptr bulk_schema;
+    auto apply_bulk = [&] () -> future<> {
+        if (bulk.empty()) {
+            co_return;
+        }
+        auto f = co_await coroutine::as_future(db.apply_in_memory(bulk, bulk_schema, {}, db::no_timeout));
+        if (f.failed()) {
+            s.invalid_mutations += bulk.size();
+            rlogger.warn("error replaying: {}", f.get_exception());
+        } else {
+            s.applied_mutations += bulk.size();
+        }
+        bulk.clear();
+    };
+
+    for (auto& e : entries) {
+        auto& fm = e.cer.mutation();
+        std::exception_ptr ex;
+        try {
             // TODO: might need better verification that the deserialized mutation
             // is schema compatible. My guess is that just applying the mutation
             // will not do this.
@@ -255,11 +327,11 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
 
             if (rlogger.is_enabled(logging::log_level::debug)) {
                 rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
-                        cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
+                        cf.schema()->ks_name(), cf.schema()->cf_name(), e.rp);
             }
             if (const auto err = validation::is_cql_key_invalid(*cf.schema(), fm.key()); err) {
                 throw std::runtime_error(fmt::format("found entry with invalid key {} at {} v={} {}:{} at {}: {}.", fm.key(), fm.column_family_id(),
-                        fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), rp, *err));
+                        fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), e.rp, *err));
             }
             // Removed forwarding "new" RP. Instead give none/empty.
             // This is what origin does, and it should be fine.
@@ -267,39 +339,33 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
             // their "replay_position" attribute will be empty, which is
             // lower than anything the new session will produce.
             if (cf.schema()->version() != fm.schema_version()) {
+                co_await apply_bulk();
                 auto& local_cm = _column_mappings.local().map;
-                auto cm_it = local_cm.try_emplace(fm.schema_version(), src_cm).first;
+                auto cm_it = local_cm.try_emplace(fm.schema_version(), *e.cm).first;
                 const column_mapping& cm = cm_it->second;
                 mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
                 converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
                 fm.partition().accept(cm, v);
-                return do_with(std::move(m), [&db, &cf] (const mutation& m) {
-                    return db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
-                });
+                co_await db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
+                s.applied_mutations++;
             } else {
-                return do_with(std::move(cer).mutation(), [&](const frozen_mutation& m) {
-                    return db.apply_in_memory(m, cf.schema(), db::rp_handle(), db::no_timeout);
-                });
-            }
-        }).then_wrapped([s] (future<> f) {
-            try {
-                f.get();
-                s->applied_mutations++;
-            } catch (...) {
-                s->invalid_mutations++;
-                // TODO: write mutation to file like origin.
-                rlogger.warn("error replaying: {}", std::current_exception());
+                if (bulk_schema != cf.schema()) {
+                    co_await apply_bulk();
+                    bulk_schema = cf.schema();
+                }
+                bulk.push_back(&fm);
             }
-        });
-    } catch (replica::no_such_column_family&) {
-        // No such CF now? Origin just ignores this.
-    } catch (...) {
-        s->invalid_mutations++;
-        // TODO: write mutation to file like origin.
-        rlogger.warn("error replaying: {}", std::current_exception());
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        if (ex) {
+            s.invalid_mutations++;
+            // TODO: write mutation to file like origin.
+            rlogger.warn("error replaying: {}", ex);
+        }
     }
-
-    return make_ready_future<>();
+    co_await apply_bulk();
+    co_return s;
 }
 
 db::commitlog_replayer::commitlog_replayer(seastar::sharded<replica::database>& db)
@@ -328,11 +394,15 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
     rlogger.info("Replaying {}", join(", ", files));
 
     // pre-compute work per shard already.
+    // Segments are spread evenly over the shards, regardless of the shard
+    // which wrote them, so that all shards take part in replaying even if
+    // the shard count changed. Each segment holds the column mappings of its
+    // entries, and entries are sent to their owning shards anyway, so any
+    // shard can replay any segment.
     auto map = ::make_lw_shared<shard_file_map>();
+    unsigned next_shard = 0;
     for (auto& f : files) {
-        commitlog::descriptor d(f, fname_prefix);
-        replay_position p = d;
-        map->emplace(p.shard_id() % smp::count, std::move(f));
+        map->emplace(next_shard++ % smp::count, std::move(f));
     }
 
     return do_with(std::move(fname_prefix), [this, map] (sstring& fname_prefix) {
@@ -281,8 +281,13 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "If set to higher than 0, ignore the controller's output and set the memtable shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_static_shares(this, "compaction_static_shares", liveness::LiveUpdate, value_status::Used, 0,
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
+    , compaction_foreground_read_latency_target_us(this, "compaction_foreground_read_latency_target_us", liveness::LiveUpdate, value_status::Used, 0,
+        "If set to higher than 0, the compaction controller lowers the shares of compaction while the average latency of disk reads of user queries, in microseconds, exceeds this target. The shares are lowered in proportion to the excess latency, but not below those of an empty backlog. Has no effect when compaction_static_shares is set.")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
         "If set to true, enforce the min_threshold option for compactions strictly. If false (default), Scylla may decide to compact even if below min_threshold")
+    , offstrategy_compaction_max_fan_in(this, "offstrategy_compaction_max_fan_in", liveness::LiveUpdate, value_status::Used, 0,
+        "The maximum number of SSTables merged at once by off-strategy compaction of repair and streaming output, if higher than the max_threshold of the table. Merging more SSTables at once reshapes a large set in fewer rounds, so it is rewritten fewer times, at the cost of the memory of a reader per SSTable."
+        " 0 means that the max_threshold of the table is used.")
     /* Initialization properties */
     /* The minimal properties needed for configuring a cluster. */
     , cluster_name(this, "cluster_name", value_status::Used, "",
@@ -309,7 +314,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The directory where hints files are stored if hinted handoff is enabled.")
     , view_hints_directory(this, "view_hints_directory", value_status::Used, "",
         "The directory where materialized-view updates are stored while a view replica is unreachable.")
-    , saved_caches_directory(this, "saved_caches_directory", value_status::Unused, "",
+    , saved_caches_directory(this, "saved_caches_directory", value_status::Used, "",
         "The directory location where table key and row caches are stored.")
     /* Commonly used properties */
     /* Properties most frequently used when configuring Scylla. */
@@ -414,6 +419,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\n"
         "\tperiodic : Used with commitlog_sync_period_in_ms (Default: 10000 - 10 seconds ) to control how often the commit log is synchronized to disk. Periodic syncs are acknowledged immediately.\n"
         "\tbatch : Used with commitlog_sync_batch_window_in_ms (Default: disabled **) to control how long Scylla waits for other writes before performing a sync. When using this method, writes are not acknowledged until fsynced to disk.\n"
+        "\tgroup : Like batch, but concurrent writes are grouped into a single write and sync, delayed by at most commitlog_sync_group_window_in_us. Writes are not acknowledged until fsynced to disk.\n"
         "Related information: Durability")
     , commitlog_segment_size_in_mb(this, "commitlog_segment_size_in_mb", value_status::Used, 64,
         "Sets the size of the individual commitlog file segments. A commitlog segment may be archived, deleted, or recycled after all its data has been flushed to SSTables. This amount of data can potentially include commitlog segments from every table in the system. The default size is usually suitable for most commitlog archiving, but if you want a finer granularity, 8 or 16 MB is reasonable. See Commit log archive configuration.\n"
@@ -424,6 +430,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     /* Note: does not exist on the listing page other than in above comment, wtf? */
     , commitlog_sync_batch_window_in_ms(this, "commitlog_sync_batch_window_in_ms", value_status::Used, 10000,
         "Controls how long the system waits for other writes before performing a sync in \"batch\" mode.")
+    , commitlog_sync_group_window_in_us(this, "commitlog_sync_group_window_in_us", value_status::Used, 1000,
+        "Upper bound of how long a write waits for concurrent writes to share its sync in \"group\" mode. The actual wait adapts to the observed sync latency.")
     , commitlog_total_space_in_mb(this, "commitlog_total_space_in_mb", value_status::Used, -1,
         "Total space used for commitlogs. If the used space goes above this value, Scylla rounds up to the next nearest segment multiple and flushes memtables to disk for the oldest commitlog segments, removing those log segments. This reduces the amount of data to replay on startup, and prevents infrequently-updated tables from indefinitely keeping commitlog segments. A small total commitlog space tends to cause more flush activity on less-active tables.\n"
         "Related information: Configuring memtable throughput")
@@ -436,6 +444,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Whether or not to use O_DSYNC mode for commitlog segments IO. Can improve commitlog latency on some file systems.\n")
     , commitlog_use_hard_size_limit(this, "commitlog_use_hard_size_limit", value_status::Used, false,
         "Whether or not to use a hard size limit for commitlog disk usage. Default is false. Enabling this can cause latency spikes, whereas the default can lead to occasional disk usage peaks.\n")
+    , commitlog_use_compression(this, "commitlog_use_compression", value_status::Used, false,
+        "Whether or not to compress commitlog entries with LZ4. Compression trades CPU for less commitlog disk bandwidth, which pays off for large, compressible mutations. "
+        "Commitlog segments written with compression cannot be replayed by versions which do not support it.")
     /* Compaction settings */
     /* Related information: Configuring compaction */
     , compaction_preheat_key_cache(this, "compaction_preheat_key_cache", value_status::Unused, true,
@@ -473,8 +484,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Granularity of the index of rows within a partition. For huge rows, decrease this setting to improve seek time. If you use key cache, be careful not to make this setting too large because key cache will be overwhelmed. If you're unsure of the size of the rows, it's best to use the default setting.")
     , column_index_auto_scale_threshold_in_kb(this, "column_index_auto_scale_threshold_in_kb", liveness::LiveUpdate, value_status::Used, 10240,
         "Auto-reduce the promoted index granularity by half when reaching this threshold, to prevent promoted index bloating due to partitions with too many rows. Set to 0 to disable this feature.")
-    , index_summary_capacity_in_mb(this, "index_summary_capacity_in_mb", value_status::Unused, 0,
-        "Fixed memory pool size in MB for SSTable index summaries. If the memory usage of all index summaries exceeds this limit, any SSTables with low read rates shrink their index summaries to meet this limit. This is a best-effort process. In extreme conditions, Cassandra may need to use more than this amount of memory.")
+    , index_summary_capacity_in_mb(this, "index_summary_capacity_in_mb", value_status::Used, 0,
+        "Fixed memory pool size in MB for SSTable index summaries, divided evenly among shards. SSTables opened when the pool is exhausted keep only a part of their summary in memory, and read larger pages of their index, which are cached and evictable. This is a best-effort process: the pages of an index never span more than max_index_interval partitions, so more memory may be used. 0 means unlimited.")
     , index_summary_resize_interval_in_minutes(this, "index_summary_resize_interval_in_minutes", value_status::Unused, 60,
         "How frequently index summaries should be re-sampled. This is done periodically to redistribute memory from the fixed-size pool to SSTables proportional their recent read rates. To disable, set to -1. This leaves existing index summaries at their current sampling level.")
     , reduce_cache_capacity_to(this, "reduce_cache_capacity_to", value_status::Invalid, .6,
@@ -535,12 +546,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , key_cache_size_in_mb(this, "key_cache_size_in_mb", value_status::Unused, 100,
         "A global cache setting for tables. It is the maximum size of the key cache in memory. To disable set to 0.\n"
         "Related information: nodetool setcachecapacity.")
-    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Unused, 0,
-        "Number of keys from the row cache to save.")
+    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Used, 100000,
+        "Number of keys from the row cache to save, per table and shard.")
     , row_cache_size_in_mb(this, "row_cache_size_in_mb", value_status::Unused, 0,
         "Maximum size of the row cache in memory. Row cache can save more time than key_cache_size_in_mb, but is space-intensive because it contains the entire row. Use the row cache only for hot rows or static rows. If you reduce the size, you may not get you hottest keys loaded on start up.")
-    , row_cache_save_period(this, "row_cache_save_period", value_status::Unused, 0,
-        "Duration in seconds that rows are saved in cache. Caches are saved to saved_caches_directory.")
+    , row_cache_save_period(this, "row_cache_save_period", value_status::Used, 0,
+        "Period in seconds, at which the keys of the partitions in the row cache are saved to saved_caches_directory, to be read back into the cache on startup. 0 disables saving.")
     , memory_allocator(this, "memory_allocator", value_status::Invalid, "NativeAllocator",
         "The off-heap memory allocator. In addition to caches, this property affects storage engine meta data. Supported values:\n"
         "\tNativeAllocator\n"
@@ -565,6 +576,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The maximum number of tombstones a query can scan before aborting.")
     , query_tombstone_page_limit(this, "query_tombstone_page_limit", liveness::LiveUpdate, value_status::Used, 10000,
         "The number of tombstones after which a query cuts a page, even if not full or even empty.")
+    , query_page_target_size_in_bytes(this, "query_page_target_size_in_bytes", liveness::LiveUpdate, value_status::Used, uint64_t(1) << 20,
+        "The approximate size of the pages read by queries whose page size is picked by the coordinator, like aggregations and unpaged filtering queries. "
+        "The number of rows per page is derived from the average row size recently observed for the table. Set to 0 to page by a fixed number of rows.")
+    , query_page_target_size_in_bytes_for_batch(this, "query_page_target_size_in_bytes_for_batch", liveness::LiveUpdate, value_status::Used, uint64_t(4) << 20,
+        "Like query_page_target_size_in_bytes, for the queries of the batch workload type, which favor throughput over latency. "
+        "Also raises the size at which the pages of their paged queries are cut, up to max_memory_for_unlimited_query_hard_limit.")
     /* Network timeout settings */
     , range_request_timeout_in_ms(this, "range_request_timeout_in_ms", value_status::Used, 10000,
         "The time in milliseconds that the coordinator waits for sequential or index scans to complete.")
@@ -603,8 +620,16 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\tall: All traffic is compressed.\n"
         "\tdc : Traffic between data centers is compressed.\n"
         "\tnone : No compression.")
+    , internode_compression_zstd(this, "internode_compression_zstd", value_status::Used, false,
+        "Compress traffic between data centers with zstd rather than lz4, when internode_compression enables it. zstd compresses better, at a higher CPU cost. Nodes which don't support zstd keep using lz4.")
+    , internode_shard_aware_connections(this, "internode_shard_aware_connections", value_status::Used, false,
+        "Send writes and reads to the shard of the replica which owns their data, and their responses to the shard which waits for them, through connections to that shard, rather than to any shard of the node, which then hands them over. Each shard then keeps a connection to each shard of each node it talks to. Streaming then also sends the data of each shard of the receiver on a stream of its own.")
     , inter_dc_tcp_nodelay(this, "inter_dc_tcp_nodelay", value_status::Used, false,
         "Enable or disable tcp_nodelay for inter-data center communication. When disabled larger, but fewer, network packets are sent. This reduces overhead from the TCP protocol itself. However, if cross data-center responses are blocked, it will increase latency.")
+    , enable_mutation_rpc_coalescing(this, "enable_mutation_rpc_coalescing", liveness::LiveUpdate, value_status::Used, true,
+        "Send the writes coordinated by a shard to the same replica, and their acknowledgements, in a single message when they are issued within mutation_rpc_coalescing_window_in_us of each other. Takes effect once all nodes support it.")
+    , mutation_rpc_coalescing_window_in_us(this, "mutation_rpc_coalescing_window_in_us", liveness::LiveUpdate, value_status::Used, 0,
+        "How long, in microseconds, writes and their acknowledgements wait for others to the same node to be sent with. With 0, only those issued before the reactor polls again are coalesced, which adds no latency.")
     , streaming_socket_timeout_in_ms(this, "streaming_socket_timeout_in_ms", value_status::Unused, 0,
         "Enable or disable socket timeout for streaming operations. When a timeout occurs during streaming, streaming is retried from the start of the current file. Avoid setting this value too low, as it can result in a significant amount of data re-streaming.")
     /* Native transport (CQL Binary Protocol) */
@@ -658,12 +683,18 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "This boolean controls whether the replicas for read query will be choosen based on cache hit ratio")
     /* Advanced fault detection settings */
     /* Settings to handle poorly performing or failing nodes. */
-    , dynamic_snitch_badness_threshold(this, "dynamic_snitch_badness_threshold", value_status::Unused, 0,
-        "Sets the performance threshold for dynamically routing requests away from a poorly performing node. A value of 0.2 means Cassandra continues to prefer the static snitch values until the node response time is 20% worse than the best performing node. Until the threshold is reached, incoming client requests are statically routed to the closest replica (as determined by the snitch). Having requests consistently routed to a given replica can help keep a working set of data hot when read repair is less than 1.")
-    , dynamic_snitch_reset_interval_in_ms(this, "dynamic_snitch_reset_interval_in_ms", value_status::Unused, 60000,
-        "Time interval in milliseconds to reset all node scores, which allows a bad node to recover.")
+    , dynamic_snitch_badness_threshold(this, "dynamic_snitch_badness_threshold", liveness::LiveUpdate, value_status::Used, 0.1,
+        "Sets the performance threshold for dynamically routing reads away from a poorly performing replica. A value of 0.2 means Scylla continues to prefer the static snitch values until the replica response time is 20% worse than the best performing equally close replica. Until the threshold is reached, reads are statically routed to the closest replica (as determined by the snitch). Having requests consistently routed to a given replica can help keep a working set of data hot when read repair is less than 1. A negative value disables dynamic routing.")
+    , dynamic_snitch_reset_interval_in_ms(this, "dynamic_snitch_reset_interval_in_ms", liveness::LiveUpdate, value_status::Used, 60000,
+        "Time interval in milliseconds after which a replica's response time is forgotten if it was not updated, which allows a bad replica to recover.")
+    , fast_failure_detection_threshold_in_ms(this, "fast_failure_detection_threshold_in_ms", value_status::Used, 300,
+        "Time in milliseconds without a response to the direct failure detector's pings after which a node is suspected, and reads prefer other replicas over it, long before it is marked down. Nodes whose requests fail or time out are pinged more often, so they are suspected sooner. Needs Raft cluster management. 0 disables it.")
     , dynamic_snitch_update_interval_in_ms(this, "dynamic_snitch_update_interval_in_ms", value_status::Unused, 100,
         "The time interval for how often the snitch calculates node scores. Because score calculation is CPU intensive, be careful when reducing this interval.")
+    , background_read_repair_queue_size(this, "background_read_repair_queue_size", liveness::LiveUpdate, value_status::Used, 10000,
+        "Maximum number of partitions waiting for a background read repair on each shard. Background repairs are written a batch at a time, in the streaming scheduling group, and the repairs of a partition found inconsistent by several reads in the meantime are merged. Repairs which don't fit in the queue are dropped. 0 writes background repairs immediately, like foreground ones.")
+    , background_read_repair_batch_size(this, "background_read_repair_batch_size", liveness::LiveUpdate, value_status::Used, 128,
+        "Maximum number of partitions repaired by a single batch of background read repairs. The next batch is written once the previous one completes.")
     , hinted_handoff_enabled(this, "hinted_handoff_enabled", value_status::Used, db::config::hinted_handoff_enabled_type(db::config::hinted_handoff_enabled_type::enabled_for_all_tag()),
         "Enable or disable hinted handoff. To enable per data center, add data center list. For example: hinted_handoff_enabled: DC1,DC2. A hint indicates that the write needs to be replayed to an unavailable node. "
         "Related information: About hinted handoff writes")
@@ -676,6 +707,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Related information: Failure detection and recovery")
     , max_hints_delivery_threads(this, "max_hints_delivery_threads", value_status::Invalid, 2,
         "Number of threads with which to deliver hints. In multiple data-center deployments, consider increasing this number because cross data-center handoff is generally slower.")
+    , hinted_handoff_replay_batch_size(this, "hinted_handoff_replay_batch_size", liveness::LiveUpdate, value_status::Used, 0,
+        "Number of hints read from a hints file which are replayed together. The hints of the same partition in a batch are merged into a single mutation, and the batch is sent to each shard of the destination in a single message, once all nodes support it. Batches shrink as the view update backlog of the destination grows. 0 (the default) replays the hints one by one.")
+    , enable_hinted_handoff_compaction(this, "enable_hinted_handoff_compaction", liveness::LiveUpdate, value_status::Used, false,
+        "Compact the hints files waiting for a node to come back, merging the hints of the same partition, so that hints superseded by newer ones of the same cells don't take space and replay time.")
     , batchlog_replay_throttle_in_kb(this, "batchlog_replay_throttle_in_kb", value_status::Unused, 1024,
         "Total maximum throttle. Throttling is reduced proportionally to the number of nodes in the cluster.")
     /* Request scheduler properties */
@@ -795,6 +830,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , override_decommission(this, "override_decommission", value_status::Used, false, "Set true to force a decommissioned node to join the cluster")
     , enable_repair_based_node_ops(this, "enable_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, true, "Set true to use enable repair based node operations instead of streaming based")
     , allowed_repair_based_node_ops(this, "allowed_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, "replace", "A comma separated list of node operations which are allowed to enable repair based node operations. The operations can be bootstrap, replace, removenode, decommission and rebuild")
+    , enable_file_based_streaming(this, "enable_file_based_streaming", liveness::LiveUpdate, value_status::Used, false,
+        "Send the sstables whose whole token range is streamed by bootstrap, replace, removenode, decommission and rebuild as files, rather than reading and writing their mutations. The other sstables, and the memtables, are streamed as mutations. Takes effect once all nodes support it.")
     , ring_delay_ms(this, "ring_delay_ms", value_status::Used, 30 * 1000, "Time a node waits to hear from other nodes before joining the ring in milliseconds. Same as -Dcassandra.ring_delay_ms in cassandra.")
     , shadow_round_ms(this, "shadow_round_ms", value_status::Used, 300 * 1000, "The maximum gossip shadow round time. Can be used to reduce the gossip feature check time during node boot up.")
     , fd_max_interval_ms(this, "fd_max_interval_ms", value_status::Used, 2 * 1000, "The maximum failure_detector interval time in milliseconds. Interval larger than the maximum will be ignored. Larger cluster may need to increase the default.")
@@ -806,12 +843,18 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , experimental(this, "experimental", value_status::Used, false, "[Deprecated] Set to true to unlock all experimental features (except 'raft' feature, which should be enabled explicitly via 'experimental-features' option). Please use 'experimental-features', instead.")
     , experimental_features(this, "experimental_features", value_status::Used, {}, experimental_features_help_string())
     , lsa_reclamation_step(this, "lsa_reclamation_step", value_status::Used, 1, "Minimum number of segments to reclaim in a single step")
+    , lsa_background_reclaim_free_memory_threshold(this, "lsa_background_reclaim_free_memory_threshold", value_status::Used, 60'000'000,
+        "Amount of free memory, in bytes, per shard, which LSA reclaims in the background ahead of allocations, at a low priority. Allocations which find less free memory have to wait for it to be reclaimed.")
     , prometheus_port(this, "prometheus_port", value_status::Used, 9180, "Prometheus port, set to zero to disable")
     , prometheus_address(this, "prometheus_address", value_status::Used, {/* listen_address */}, "Prometheus listening address, defaulting to listen_address if not explicitly set")
     , prometheus_prefix(this, "prometheus_prefix", value_status::Used, "scylla", "Set the prefix of the exported Prometheus metrics. Changing this will break Scylla's dashboard compatibility, do not change unless you know what you are doing.")
     , abort_on_lsa_bad_alloc(this, "abort_on_lsa_bad_alloc", value_status::Used, false, "Abort when allocation in LSA region fails")
     , murmur3_partitioner_ignore_msb_bits(this, "murmur3_partitioner_ignore_msb_bits", value_status::Used, default_murmur3_partitioner_ignore_msb_bits, "Number of most siginificant token bits to ignore in murmur3 partitioner; increase for very large clusters")
     , unspooled_dirty_soft_limit(this, "unspooled_dirty_soft_limit", value_status::Used, 0.6, "Soft limit of unspooled dirty memory expressed as a portion of the hard limit")
+    , unspooled_dirty_throttle_start(this, "unspooled_dirty_throttle_start", value_status::Used, 1.0, "Portion of the hard limit of unspooled dirty memory above which writes are delayed, increasingly so as the hard limit is approached, instead of being blocked when it is reached. 1 disables the delays.")
+    , unspooled_dirty_max_throttle_delay_in_ms(this, "unspooled_dirty_max_throttle_delay_in_ms", value_status::Used, 10, "Delay of writes when unspooled dirty memory is at the hard limit, see unspooled_dirty_throttle_start.")
+    , memtable_max_concurrent_flushes(this, "memtable_max_concurrent_flushes", value_status::Used, 1, "Maximum number of memtables written to sstables concurrently, per shard. Increase on disks fast enough to take more than one flush at a time.")
+    , memtable_flush_parallelism(this, "memtable_flush_parallelism", liveness::LiveUpdate, value_status::Used, 1, "Maximum number of sstables a single memtable is written to concurrently, each holding a contiguous token range of it. Only memtables of at least 64MB per sstable are split. Increase on disks fast enough to take more than one sstable writer at a time.")
     , sstable_summary_ratio(this, "sstable_summary_ratio", value_status::Used, 0.0005, "Enforces that 1 byte of summary is written for every N (2000 by default) "
         "bytes written to data file. Value must be between 0 and 1.")
     , large_memory_allocation_warning_threshold(this, "large_memory_allocation_warning_threshold", value_status::Used, size_t(1) << 20, "Warn about memory allocations above this size; set to zero to disable")
@@ -823,9 +866,18 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
+    , view_update_hint_backlog_threshold(this, "view_update_hint_backlog_threshold", liveness::LiveUpdate, value_status::Used, 0,
+        "The view update backlog of a view replica, as a fraction of its maximum, above which asynchronous view updates to it are written "
+        "to the local hints for views, to be delivered in the background, instead of being held in memory until the replica acknowledges them. "
+        "This keeps the backlog of the base replica, and the latency of base writes, flat while view replicas are slow, at the cost of "
+        "the view lagging behind by at least the hints flush period. 0 disables it.")
+    , view_building_concurrency(this, "view_building_concurrency", liveness::LiveUpdate, value_status::Used, 4,
+        "The number of base partitions whose view updates each shard generates and propagates concurrently while building views.")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Unused, true, "Enable SSTables 'mc' format to be used as the default file format.  Deprecated, please use \"sstable_format\" instead.")
     , enable_sstables_md_format(this, "enable_sstables_md_format", value_status::Unused, true, "Enable SSTables 'md' format to be used as the default file format.  Deprecated, please use \"sstable_format\" instead.")
     , sstable_format(this, "sstable_format", value_status::Used, "me", "Default sstable file format", {"md", "me"})
+    , enable_sstables_split_block_filter(this, "enable_sstables_split_block_filter", value_status::Used, false, "Write bloom filters of new SSTables as split block bloom filters, which probe a single cache line per key."
+        " Such SSTables cannot be read by versions which don't support it, nor by Cassandra.")
     , enable_dangerous_direct_import_of_cassandra_counters(this, "enable_dangerous_direct_import_of_cassandra_counters", value_status::Used, false, "Only turn this option on if you want to import tables from Cassandra containing counters, and you are SURE that no counters in that table were created in a version earlier than Cassandra 2.1."
         " It is not enough to have ever since upgraded to newer versions of Cassandra. If you EVER used a version earlier than 2.1 in the cluster where these SSTables come from, DO NOT TURN ON THIS OPTION! You will corrupt your data. You have been warned.")
     , enable_shard_aware_drivers(this, "enable_shard_aware_drivers", value_status::Used, true, "Enable native transport drivers to use connection-per-shard for better performance")
@@ -847,6 +899,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
             "Start serializing reads after their collective memory consumption goes above $normal_limit * $multiplier.")
     , reader_concurrency_semaphore_kill_limit_multiplier(this, "reader_concurrency_semaphore_kill_limit_multiplier", liveness::LiveUpdate, value_status::Used, 4,
             "Start killing reads after their collective memory consumption goes above $normal_limit * $multiplier.")
+    , reader_concurrency_semaphore_deadline_shedding(this, "reader_concurrency_semaphore_deadline_shedding", liveness::LiveUpdate, value_status::Used, true,
+            "Reject user reads waiting for admission, whose remaining time until their timeout is shorter than the recent duration of reads of their table, "
+            "instead of admitting reads which are unlikely to complete in time.")
     , twcs_max_window_count(this, "twcs_max_window_count", liveness::LiveUpdate, value_status::Used, 50,
             "The maximum number of compaction windows allowed when making use of TimeWindowCompactionStrategy. A setting of 0 effectively disables the restriction.")
     , initial_sstable_loading_concurrency(this, "initial_sstable_loading_concurrency", value_status::Used, 4u,
@@ -863,17 +918,53 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Time period in seconds after which unused schema versions will be evicted from the local schema registry cache. Default is 1 second.")
     , max_concurrent_requests_per_shard(this, "max_concurrent_requests_per_shard",liveness::LiveUpdate, value_status::Used, std::numeric_limits<uint32_t>::max(),
         "Maximum number of concurrent requests a single shard can handle before it starts shedding extra load. By default, no requests will be shed.")
+    , max_concurrent_requests_per_connection(this, "max_concurrent_requests_per_connection", liveness::LiveUpdate, value_status::Used, 1024,
+        "Maximum number of requests a single CQL connection can have in flight. Once reached, no more requests are read off the connection until some complete, so the client is pushed back on instead of being shed. "
+        "A connection is also limited to a quarter of the memory available to the CQL transport.")
     , cdc_dont_rewrite_streams(this, "cdc_dont_rewrite_streams", value_status::Used, false,
             "Disable rewriting streams from cdc_streams_descriptions to cdc_streams_descriptions_v2. Should not be necessary, but the procedure is expensive and prone to failures; this config option is left as a backdoor in case some user requires manual intervention.")
     , strict_allow_filtering(this, "strict_allow_filtering", liveness::LiveUpdate, value_status::Used, strict_allow_filtering_default(), "Match Cassandra in requiring ALLOW FILTERING on slow queries. Can be true, false, or warn. When false, Scylla accepts some slow queries even without ALLOW FILTERING that Cassandra rejects. Warn is same as false, but with warning.")
     , reversed_reads_auto_bypass_cache(this, "reversed_reads_auto_bypass_cache", liveness::LiveUpdate, value_status::Used, false,
             "Bypass in-memory data cache (the row cache) when performing reversed queries.")
+    , cache_admission_policy(this, "cache_admission_policy", liveness::LiveUpdate, value_status::Used, "all",
+            "Which partitions missing in the in-memory data cache (the row cache) are added to it by reads. "
+            "all: every partition read. frequency: only partitions read again shortly after missing in cache, and range scans bypass the cache, "
+            "so that scans of data which is rarely read don't evict frequently read partitions.", {"all", "frequency"})
+    , cache_eviction_policy(this, "cache_eviction_policy", liveness::LiveUpdate, value_status::Used, "lru",
+            "Which rows of the in-memory data cache (the row cache) are evicted first. "
+            "lru: the least recently used. second_chance: the least recently used, but rows read again since they were last considered "
+            "for eviction are spared once, so that rows read only once, like by scans, are evicted before those read repeatedly.", {"lru", "second_chance"})
     , enable_optimized_reversed_reads(this, "enable_optimized_reversed_reads", liveness::LiveUpdate, value_status::Used, true,
             "Use a new optimized algorithm for performing reversed reads.")
     , enable_cql_config_updates(this, "enable_cql_config_updates", liveness::LiveUpdate, value_status::Used, true,
             "Make the system.config table UPDATEable")
     , enable_parallelized_aggregation(this, "enable_parallelized_aggregation", liveness::LiveUpdate, value_status::Used, true,
             "Use on a new, parallel algorithm for performing aggregate queries.")
+    , auto_prepare_statements(this, "auto_prepare_statements", liveness::LiveUpdate, value_status::Used, false,
+            "Execute simple unprepared statements as prepared statements, with their constants replaced by bind markers, "
+            "so that statements differing only in their constants are parsed and prepared once. "
+            "The prepared statements share the prepared statements cache with the statements prepared by clients.")
+    , tracing_backend(this, "tracing_backend", value_status::Used, "trace_keyspace_helper",
+            "Where the tracing sessions are recorded. The available backends are:\n"
+            "\n"
+            "\ttrace_keyspace_helper : Writes the sessions to the tables of the system_traces keyspace.\n"
+            "\ttrace_ring_helper : Keeps the most recent sessions of each shard in memory, in a compact form. "
+            "This is much cheaper than writing them to system_traces, so a larger fraction of the requests can be traced. "
+            "The sessions can be read with the /storage_service/tracing/recent_sessions REST API."
+            , {"trace_keyspace_helper", "trace_ring_helper"})
+    , hot_partitions_sampling_period(this, "hot_partitions_sampling_period", liveness::LiveUpdate, value_status::Used, 100,
+            "Track the hottest partitions of each table all the time, by sampling one of every this many reads and writes on each shard. "
+            "The hottest partitions of the last minute can be read with the /column_family/hot_partitions REST API. "
+            "0 disables the tracking.")
+    , write_path_profiling_period(this, "write_path_profiling_period", liveness::LiveUpdate, value_status::Used, 0,
+            "Time the stages of one of every this many writes on each shard: CDC augmentation and replication on the coordinator, "
+            "and view updates, commitlog and memtable apply on the replica. "
+            "The timings can be read with the /storage_proxy/write_path_profile REST API. "
+            "0 disables the profiling.")
+    , counter_update_coalescing_window_in_us(this, "counter_update_coalescing_window_in_us", liveness::LiveUpdate, value_status::Used, 0,
+            "Delay counter updates on the leader replica by up to this many microseconds, and merge the increments of a partition made "
+            "meanwhile into a single read-modify-write. This relieves hot counters, whose updates are otherwise serialized on the counter "
+            "cell locks, at the cost of this much latency for each counter update. 0 disables the coalescing.")
     , alternator_port(this, "alternator_port", value_status::Used, 0, "Alternator API port")
     , alternator_https_port(this, "alternator_https_port", value_status::Used, 0, "Alternator API HTTPS port")
     , alternator_address(this, "alternator_address", value_status::Used, "0.0.0.0", "Alternator API listening address")
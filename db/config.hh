@@ -141,7 +141,9 @@ class config : public utils::config_file {
     named_value<bool> auto_adjust_flush_quota;
     named_value<float> memtable_flush_static_shares;
     named_value<float> compaction_static_shares;
+    named_value<uint32_t> compaction_foreground_read_latency_target_us;
     named_value<bool> compaction_enforce_min_threshold;
+    named_value<uint32_t> offstrategy_compaction_max_fan_in;
     named_value<sstring> cluster_name;
     named_value<sstring> listen_address;
     named_value<sstring> listen_interface;
@@ -177,11 +179,13 @@ class config : public utils::config_file {
     named_value<uint32_t> commitlog_segment_size_in_mb;
     named_value<uint32_t> commitlog_sync_period_in_ms;
     named_value<uint32_t> commitlog_sync_batch_window_in_ms;
+    named_value<uint32_t> commitlog_sync_group_window_in_us;
     named_value<int64_t> commitlog_total_space_in_mb;
     named_value<bool> commitlog_reuse_segments; // unused. retained for upgrade compat
     named_value<int64_t> commitlog_flush_threshold_in_mb;
     named_value<bool> commitlog_use_o_dsync;
     named_value<bool> commitlog_use_hard_size_limit;
+    named_value<bool> commitlog_use_compression;
     named_value<bool> compaction_preheat_key_cache;
     named_value<uint32_t> concurrent_compactors;
     named_value<uint32_t> in_memory_compaction_limit_in_mb;
@@ -229,6 +233,8 @@ class config : public utils::config_file {
     named_value<uint32_t> tombstone_warn_threshold;
     named_value<uint32_t> tombstone_failure_threshold;
     named_value<uint64_t> query_tombstone_page_limit;
+    named_value<uint64_t> query_page_target_size_in_bytes;
+    named_value<uint64_t> query_page_target_size_in_bytes_for_batch;
     named_value<uint32_t> range_request_timeout_in_ms;
     named_value<uint32_t> read_request_timeout_in_ms;
     named_value<uint32_t> counter_write_request_timeout_in_ms;
@@ -240,7 +246,11 @@ class config : public utils::config_file {
     named_value<uint32_t> internode_send_buff_size_in_bytes;
     named_value<uint32_t> internode_recv_buff_size_in_bytes;
     named_value<sstring> internode_compression;
+    named_value<bool> internode_compression_zstd;
+    named_value<bool> internode_shard_aware_connections;
     named_value<bool> inter_dc_tcp_nodelay;
+    named_value<bool> enable_mutation_rpc_coalescing;
+    named_value<uint32_t> mutation_rpc_coalescing_window_in_us;
     named_value<uint32_t> streaming_socket_timeout_in_ms;
     named_value<bool> start_native_transport;
     named_value<uint16_t> native_transport_port;
@@ -261,12 +271,17 @@ class config : public utils::config_file {
     named_value<bool> cache_hit_rate_read_balancing;
     named_value<double> dynamic_snitch_badness_threshold;
     named_value<uint32_t> dynamic_snitch_reset_interval_in_ms;
+    named_value<uint32_t> fast_failure_detection_threshold_in_ms;
     named_value<uint32_t> dynamic_snitch_update_interval_in_ms;
+    named_value<uint32_t> background_read_repair_queue_size;
+    named_value<uint32_t> background_read_repair_batch_size;
     named_value<hinted_handoff_enabled_type> hinted_handoff_enabled;
     named_value<uint32_t> max_hinted_handoff_concurrency;
     named_value<uint32_t> hinted_handoff_throttle_in_kb;
     named_value<uint32_t> max_hint_window_in_ms;
     named_value<uint32_t> max_hints_delivery_threads;
+    named_value<uint32_t> hinted_handoff_replay_batch_size;
+    named_value<bool> enable_hinted_handoff_compaction;
     named_value<uint32_t> batchlog_replay_throttle_in_kb;
     named_value<sstring> request_scheduler;
     named_value<sstring> request_scheduler_id;
@@ -303,6 +318,7 @@ class config : public utils::config_file {
     named_value<bool> override_decommission;
     named_value<bool> enable_repair_based_node_ops;
     named_value<sstring> allowed_repair_based_node_ops;
+    named_value<bool> enable_file_based_streaming;
     named_value<uint32_t> ring_delay_ms;
     named_value<uint32_t> shadow_round_ms;
     named_value<uint32_t> fd_max_interval_ms;
@@ -314,12 +330,17 @@ class config : public utils::config_file {
     named_value<bool> experimental;
     named_value<std::vector<enum_option<experimental_features_t>>> experimental_features;
     named_value<size_t> lsa_reclamation_step;
+    named_value<size_t> lsa_background_reclaim_free_memory_threshold;
     named_value<uint16_t> prometheus_port;
     named_value<sstring> prometheus_address;
     named_value<sstring> prometheus_prefix;
     named_value<bool> abort_on_lsa_bad_alloc;
     named_value<unsigned> murmur3_partitioner_ignore_msb_bits;
     named_value<double> unspooled_dirty_soft_limit;
+    named_value<double> unspooled_dirty_throttle_start;
+    named_value<uint32_t> unspooled_dirty_max_throttle_delay_in_ms;
+    named_value<uint32_t> memtable_max_concurrent_flushes;
+    named_value<uint32_t> memtable_flush_parallelism;
     named_value<double> sstable_summary_ratio;
     named_value<size_t> large_memory_allocation_warning_threshold;
     named_value<bool> enable_deprecated_partitioners;
@@ -328,9 +349,12 @@ class config : public utils::config_file {
     named_value<bool> enable_sstable_key_validation;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
+    named_value<double> view_update_hint_backlog_threshold;
+    named_value<uint32_t> view_building_concurrency;
     named_value<bool> enable_sstables_mc_format;
     named_value<bool> enable_sstables_md_format;
     named_value<sstring> sstable_format;
+    named_value<bool> enable_sstables_split_block_filter;
     named_value<bool> enable_dangerous_direct_import_of_cassandra_counters;
     named_value<bool> enable_shard_aware_drivers;
     named_value<bool> enable_ipv6_dns_lookup;
@@ -341,6 +365,7 @@ class config : public utils::config_file {
     named_value<uint64_t> max_memory_for_unlimited_query_hard_limit;
     named_value<uint32_t> reader_concurrency_semaphore_serialize_limit_multiplier;
     named_value<uint32_t> reader_concurrency_semaphore_kill_limit_multiplier;
+    named_value<bool> reader_concurrency_semaphore_deadline_shedding;
     named_value<uint32_t> twcs_max_window_count;
     named_value<unsigned> initial_sstable_loading_concurrency;
     named_value<bool> enable_3_1_0_compatibility_mode;
@@ -350,12 +375,20 @@ class config : public utils::config_file {
     named_value<unsigned> user_defined_function_contiguous_allocation_limit_bytes;
     named_value<uint32_t> schema_registry_grace_period;
     named_value<uint32_t> max_concurrent_requests_per_shard;
+    named_value<uint32_t> max_concurrent_requests_per_connection;
     named_value<bool> cdc_dont_rewrite_streams;
     named_value<tri_mode_restriction> strict_allow_filtering;
     named_value<bool> reversed_reads_auto_bypass_cache;
+    named_value<sstring> cache_admission_policy;
+    named_value<sstring> cache_eviction_policy;
     named_value<bool> enable_optimized_reversed_reads;
     named_value<bool> enable_cql_config_updates;
     named_value<bool> enable_parallelized_aggregation;
+    named_value<bool> auto_prepare_statements;
+    named_value<sstring> tracing_backend;
+    named_value<uint32_t> hot_partitions_sampling_period;
+    named_value<uint32_t> write_path_profiling_period;
+    named_value<uint32_t> counter_update_coalescing_window_in_us;
 
     named_value<uint16_t> alternator_port;
     named_value<uint16_t> alternator_https_port;
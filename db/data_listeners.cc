@@ -114,6 +114,83 @@ toppartitions_data_listener::localize(const global_top_k::results& r) {
     return n;
 }
 
+hot_partitions_data_listener::hot_partitions_data_listener(replica::database& db, utils::updateable_value<uint32_t> sampling_period)
+        : _db(db)
+        , _sampling_period(std::move(sampling_period))
+        , _window_start(clock::now())
+        , _current(std::make_unique<window>()) {
+    _db.data_listeners().install(this);
+}
+
+hot_partitions_data_listener::~hot_partitions_data_listener() {
+    _db.data_listeners().uninstall(this);
+}
+
+hot_partitions_data_listener::window& hot_partitions_data_listener::current_window() {
+    auto now = clock::now();
+    if (now - _window_start >= window_duration) {
+        // A window with no samples is as complete as any other.
+        auto previous = std::exchange(_current, std::make_unique<window>());
+        _previous = now - _window_start >= 2 * window_duration ? std::make_unique<window>() : std::move(previous);
+        _window_start = now;
+    }
+    return *_current;
+}
+
+flat_mutation_reader_v2 hot_partitions_data_listener::on_read(const schema_ptr& s, const dht::partition_range& range,
+        const query::partition_slice& slice, flat_mutation_reader_v2&& rd) {
+    auto period = _sampling_period();
+    if (!period || ++_reads % period) {
+        return std::move(rd);
+    }
+    return make_filtering_reader(std::move(rd), [zis = this->weak_from_this(), s, period] (const dht::decorated_key& dk) {
+        // The read may outlive the listener.
+        if (zis) {
+            zis->current_window().reads.append(toppartitions_item_key{s, dk}, period);
+        }
+        return true;
+    });
+}
+
+void hot_partitions_data_listener::on_write(const schema_ptr& s, const frozen_mutation& m) {
+    auto period = _sampling_period();
+    if (!period || ++_writes % period) {
+        return;
+    }
+    auto& w = current_window();
+    auto key = toppartitions_item_key{s, m.decorated_key(*s)};
+    auto kbytes = std::min<uint64_t>((uint64_t(m.representation().size()) * period + 1023) / 1024, std::numeric_limits<unsigned>::max());
+    w.writes.append(key, period);
+    w.write_kbytes.append(std::move(key), kbytes);
+}
+
+hot_partitions_data_listener::results hot_partitions_data_listener::get_results(table_id id) {
+    current_window();
+    auto& w = _previous ? *_previous : *_current;
+    auto of_table = [id] (const top_k& top) {
+        top_k::results res;
+        for (auto& r : top.top(capacity)) {
+            if (r.item.schema->id() == id) {
+                res.push_back(r);
+            }
+        }
+        return toppartitions_data_listener::globalize(std::move(res));
+    };
+    return results{of_table(w.reads), of_table(w.writes), of_table(w.write_kbytes)};
+}
+
+future<hot_partitions> get_hot_partitions(distributed<replica::database>& db, table_id id) {
+    using results = hot_partitions_data_listener::results;
+    return db.map_reduce0([id] (replica::database& db) {
+        return make_foreign(std::make_unique<results>(db.get_hot_partitions().get_results(id)));
+    }, hot_partitions{}, [] (hot_partitions res, foreign_ptr<std::unique_ptr<results>> shard_res) {
+        res.reads.append(toppartitions_data_listener::localize(shard_res->reads));
+        res.writes.append(toppartitions_data_listener::localize(shard_res->writes));
+        res.write_kbytes.append(toppartitions_data_listener::localize(shard_res->write_kbytes));
+        return res;
+    });
+}
+
 toppartitions_query::toppartitions_query(distributed<replica::database>& xdb, std::unordered_set<std::tuple<sstring, sstring>, utils::tuple_hash>&& table_filters,
         std::unordered_set<sstring>&& keyspace_filters, std::chrono::milliseconds duration, size_t list_size, size_t capacity)
         : _xdb(xdb), _table_filters(std::move(table_filters)), _keyspace_filters(std::move(keyspace_filters)), _duration(duration), _list_size(list_size), _capacity(capacity),
@@ -12,11 +12,13 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/weak_ptr.hh>
+#include <seastar/core/lowres_clock.hh>
 
 #include "utils/hash.hh"
 #include "schema_fwd.hh"
 #include "readers/flat_mutation_reader_v2.hh"
 #include "utils/top_k.hh"
+#include "utils/updateable_value.hh"
 #include "schema_registry.hh"
 
 #include <vector>
@@ -138,6 +140,62 @@ class toppartitions_data_listener : public data_listener, public weakly_referenc
     future<> stop();
 };
 
+// Tracks the hottest partitions of the shard all the time, unlike
+// toppartitions_data_listener, which only tracks them for the duration of a
+// toppartitions query. To keep the overhead low, only one of every
+// sampling_period reads and writes is tracked, with its count scaled by the
+// period. The partitions are tracked over windows of window_duration, and
+// the results are those of the last complete window.
+class hot_partitions_data_listener : public data_listener, public weakly_referencable<hot_partitions_data_listener> {
+public:
+    using top_k = toppartitions_data_listener::top_k;
+    using clock = lowres_clock;
+    static constexpr auto window_duration = std::chrono::minutes(1);
+    static constexpr size_t capacity = 256;
+
+    struct window {
+        top_k reads{capacity};
+        top_k writes{capacity};
+        // In KiB, of the mutations written.
+        top_k write_kbytes{capacity};
+    };
+private:
+    replica::database& _db;
+    utils::updateable_value<uint32_t> _sampling_period;
+    uint64_t _reads = 0;
+    uint64_t _writes = 0;
+    clock::time_point _window_start;
+    std::unique_ptr<window> _current;
+    std::unique_ptr<window> _previous;
+private:
+    window& current_window();
+public:
+    hot_partitions_data_listener(replica::database& db, utils::updateable_value<uint32_t> sampling_period);
+    ~hot_partitions_data_listener();
+
+    virtual flat_mutation_reader_v2 on_read(const schema_ptr& s, const dht::partition_range& range,
+            const query::partition_slice& slice, flat_mutation_reader_v2&& rd) override;
+
+    virtual void on_write(const schema_ptr& s, const frozen_mutation& m) override;
+
+    // The hottest partitions of the table on this shard, in the last
+    // complete window.
+    struct results {
+        toppartitions_data_listener::global_top_k::results reads;
+        toppartitions_data_listener::global_top_k::results writes;
+        toppartitions_data_listener::global_top_k::results write_kbytes;
+    };
+    results get_results(table_id id);
+};
+
+// The hottest partitions of the table on all shards.
+struct hot_partitions {
+    toppartitions_data_listener::top_k reads;
+    toppartitions_data_listener::top_k writes;
+    toppartitions_data_listener::top_k write_kbytes;
+};
+future<hot_partitions> get_hot_partitions(distributed<replica::database>& db, table_id id);
+
 class toppartitions_query {
     distributed<replica::database>& _xdb;
     std::unordered_set<std::tuple<sstring, sstring>, utils::tuple_hash> _table_filters;
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "function.hh"
+#include "column_batch.hh"
 #include <optional>
 
 namespace db {
@@ -67,6 +68,24 @@ class aggregate_function : public virtual function {
          */
         virtual void add_input(const std::vector<opt_bytes>& values) = 0;
 
+        /**
+         * Adds a batch of rows to this aggregate. Equivalent to calling
+         * <code>add_input()</code> for each row.
+         *
+         * @param args the values of the arguments, one column per argument,
+         * each holding <code>rows</code> values.
+         * @param rows the number of rows in the batch.
+         */
+        virtual void add_input_batch(const std::vector<const column_vector*>& args, size_t rows) {
+            std::vector<opt_bytes> values(args.size());
+            for (size_t row = 0; row < rows; ++row) {
+                for (size_t i = 0; i < args.size(); ++i) {
+                    values[i] = args[i]->get(row);
+                }
+                add_input(values);
+            }
+        }
+
         /**
          * Computes and returns the aggregate current value.
          *
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "bytes.hh"
+#include "utils/fragment_range.hh"
+
+namespace db {
+namespace functions {
+
+/**
+ * The values of a column in a batch of rows.
+ *
+ * Values are stored back to back in a single buffer, with a bitmap of the
+ * nulls, so that adding a value doesn't allocate (once the buffers have grown
+ * to fit a batch), and aggregates can process a whole column in a tight loop.
+ */
+class column_vector {
+    std::vector<int8_t> _data;
+    // Value i spans [_offsets[i], _offsets[i + 1]) of _data.
+    std::vector<uint32_t> _offsets{0};
+    std::vector<uint64_t> _null_bitmap;
+    size_t _null_count = 0;
+private:
+    static constexpr size_t bits_per_word = 64;
+
+    void add_slot() {
+        if (size() % bits_per_word == 0) {
+            _null_bitmap.push_back(0);
+        }
+        _offsets.push_back(_data.size());
+    }
+public:
+    size_t size() const noexcept {
+        return _offsets.size() - 1;
+    }
+
+    size_t null_count() const noexcept {
+        return _null_count;
+    }
+
+    bool is_null(size_t i) const noexcept {
+        return _null_bitmap[i / bits_per_word] & (uint64_t(1) << (i % bits_per_word));
+    }
+
+    // All non-null values, back to back. When the column has no nulls and all
+    // its values have the same size, value i starts at i times that size.
+    bytes_view values() const noexcept {
+        return bytes_view(_data.data(), _data.size());
+    }
+
+    // The value of row i, which must not be null.
+    bytes_view operator[](size_t i) const noexcept {
+        return bytes_view(_data.data() + _offsets[i], _offsets[i + 1] - _offsets[i]);
+    }
+
+    bytes_opt get(size_t i) const {
+        if (is_null(i)) {
+            return std::nullopt;
+        }
+        return bytes((*this)[i]);
+    }
+
+    void push_back(bytes_view v) {
+        _data.insert(_data.end(), v.begin(), v.end());
+        add_slot();
+    }
+
+    template <FragmentedView View>
+    void push_back(View v) {
+        for (bytes_view frag : fragment_range(v)) {
+            _data.insert(_data.end(), frag.begin(), frag.end());
+        }
+        add_slot();
+    }
+
+    void push_null() {
+        add_slot();
+        _null_bitmap.back() |= uint64_t(1) << ((size() - 1) % bits_per_word);
+        ++_null_count;
+    }
+
+    // Keeps the allocated buffers around for the next batch.
+    void clear() noexcept {
+        _data.clear();
+        _offsets.resize(1);
+        _null_bitmap.clear();
+        _null_count = 0;
+    }
+};
+
+/**
+ * A batch of rows, stored column by column.
+ *
+ * Rows are added one cell at a time, in column order, after start_row().
+ */
+class column_batch {
+    std::vector<column_vector> _columns;
+    size_t _rows = 0;
+    size_t _next_column = 0;
+public:
+    // Number of rows after which a batch is handed over for processing.
+    static constexpr size_t max_rows = 1024;
+
+    explicit column_batch(size_t columns) : _columns(columns) {}
+
+    size_t rows() const noexcept {
+        return _rows;
+    }
+
+    bool full() const noexcept {
+        return _rows >= max_rows;
+    }
+
+    const column_vector& column(size_t idx) const noexcept {
+        return _columns[idx];
+    }
+
+    void start_row() noexcept {
+        ++_rows;
+        _next_column = 0;
+    }
+
+    template <typename Value>
+    void add(Value v) {
+        _columns[_next_column++].push_back(std::move(v));
+    }
+
+    void add_null() {
+        _columns[_next_column++].push_null();
+    }
+
+    void clear() noexcept {
+        for (auto& c : _columns) {
+            c.clear();
+        }
+        _rows = 0;
+        _next_column = 0;
+    }
+};
+
+}
+}
@@ -15,6 +15,9 @@
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/coroutine/as_future.hh>
+#include <seastar/util/defer.hh>
 #include <boost/range/adaptors.hpp>
 #include "utils/div_ceil.hh"
 #include "db/extensions.hh"
@@ -80,6 +83,15 @@ void manager::register_metrics(const sstring& group_name) {
         sm::make_counter("discarded", _stats.discarded,
                         sm::description("Number of hints that were discarded during sending (too old, schema changed, etc.).")),
 
+        sm::make_counter("merged", _stats.merged,
+                        sm::description("Number of hints that were merged into another hint of the same partition before sending.")),
+
+        sm::make_counter("compacted", _stats.compacted,
+                        sm::description("Number of hints that were dropped by the compaction of hints files, because they were merged with newer hints of the same partition or were too old.")),
+
+        sm::make_counter("compacted_files", _stats.compacted_files,
+                        sm::description("Number of hints files that were replaced by the compaction of hints files.")),
+
         sm::make_counter("corrupted_files", _stats.corrupted_files,
                         sm::description("Number of hints files that were discarded during sending because the file was corrupted.")),
 
@@ -833,6 +845,11 @@ void manager::end_point_hints_manager::sender::start() {
             try {
                 flush_maybe().get();
                 send_hints_maybe();
+                try {
+                    compact_segments_maybe();
+                } catch (...) {
+                    manager_logger.warn("Failed to compact hints files of {}: {}. Keeping them as they are.", end_point_key(), std::current_exception());
+                }
 
                 // If we got here means that either there are no more hints to send or we failed to send hints we have.
                 // In both cases it makes sense to wait a little before continuing.
@@ -901,13 +918,7 @@ future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<s
             // We just need to account in the ctx that sending of this hint has failed.
             if (!f.failed()) {
                 ctx_ptr->on_hint_send_success(rp);
-                auto new_bound = ctx_ptr->get_replayed_bound();
-                // Segments from other shards are replayed first and are considered to be "before" replay position 0.
-                // Update the sent upper bound only if it is a local segment.
-                if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
-                    _sent_upper_bound_rp = new_bound;
-                    notify_replay_waiters();
-                }
+                on_hints_replayed(*ctx_ptr);
             } else {
                 ctx_ptr->on_hint_send_failure(rp);
             }
@@ -919,11 +930,157 @@ future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<s
     });
 }
 
+size_t manager::end_point_hints_manager::sender::replay_batch_size() const {
+    size_t batch_size = _db.get_config().hinted_handoff_replay_batch_size();
+    if (batch_size == 0) {
+        return 0;
+    }
+    auto backlog = std::min(_proxy.get_backlog_of(end_point_key()).relative_size(), 1.0f);
+    return std::max(size_t(1), size_t(batch_size * (1 - backlog)));
+}
+
+future<> manager::end_point_hints_manager::sender::send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    auto hints = std::exchange(ctx_ptr->pending_hints, {});
+    if (hints.empty()) {
+        co_return;
+    }
+    if ((!draining() && ctx_ptr->segment_replay_failed) || !can_send()) {
+        for (auto& h : hints) {
+            ctx_ptr->on_hint_send_failure(h.rp);
+        }
+        co_return;
+    }
+
+    size_t size = 0;
+    for (auto& h : hints) {
+        size += h.buf.size_bytes();
+    }
+    auto f = co_await coroutine::as_future(_resource_manager.get_send_units_for(size));
+    if (f.failed()) {
+        manager_logger.trace("send_hint_batch(): Hmmm. Something bad had happend: {}", f.get_exception());
+        for (auto& h : hints) {
+            ctx_ptr->on_hint_send_failure(h.rp);
+        }
+        co_return;
+    }
+
+    // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
+    (void)with_gate(ctx_ptr->file_send_gate, [this, ctx_ptr, hints = std::move(hints), secs_since_file_mod, &fname] () mutable {
+        return do_send_hint_batch(std::move(ctx_ptr), std::move(hints), secs_since_file_mod, fname);
+    }).finally([units = f.get0()] {});
+}
+
+future<> manager::end_point_hints_manager::sender::do_send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, std::vector<pending_hint> hints, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    // The hints of a partition, merged, and the positions they were read from.
+    struct partition_hints {
+        mutation m;
+        std::vector<db::replay_position> rps;
+    };
+    std::vector<partition_hints> partitions;
+    // The partitions of each table, in token order.
+    std::unordered_map<table_schema_version, std::map<dht::decorated_key, size_t, dht::decorated_key::less_comparator>> partitions_of_table;
+    partitions.reserve(hints.size());
+
+    for (auto& h : hints) {
+        try {
+            auto m = get_mutation(ctx_ptr, h.buf);
+            gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
+
+            // The hint is too old - drop it. See send_one_hint().
+            if (gc_clock::now().time_since_epoch() - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
+                ctx_ptr->on_hint_send_success(h.rp);
+                continue;
+            }
+
+            auto& table_partitions = partitions_of_table.try_emplace(m.s->version(), dht::decorated_key::less_comparator(m.s)).first->second;
+            auto dk = m.fm.decorated_key(*m.s);
+            auto it = table_partitions.find(dk);
+            if (it == table_partitions.end()) {
+                table_partitions.emplace(std::move(dk), partitions.size());
+                partitions.push_back(partition_hints{m.fm.unfreeze(m.s), {h.rp}});
+            } else {
+                // Cells are reconciled by their timestamps, so the merged
+                // mutation has the same effect as applying the hints one by one.
+                auto& p = partitions[it->second];
+                p.m.apply(m.fm.unfreeze(m.s));
+                p.rps.push_back(h.rp);
+                ++this->shard_stats().merged;
+            }
+
+        // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
+        } catch (replica::no_such_column_family& e) {
+            manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
+            ++this->shard_stats().discarded;
+            ctx_ptr->on_hint_send_success(h.rp);
+        } catch (replica::no_such_keyspace& e) {
+            manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
+            ++this->shard_stats().discarded;
+            ctx_ptr->on_hint_send_success(h.rp);
+        } catch (no_column_mapping& e) {
+            manager_logger.debug("send_hints(): {} at {}: {}", fname, h.rp, e.what());
+            ++this->shard_stats().discarded;
+            ctx_ptr->on_hint_send_success(h.rp);
+        } catch (...) {
+            manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, h.rp, std::current_exception());
+            ctx_ptr->on_hint_send_failure(h.rp);
+        }
+        co_await coroutine::maybe_yield();
+    }
+    hints.clear();
+    on_hints_replayed(*ctx_ptr);
+
+    std::vector<partition_hints*> sorted_partitions;
+    sorted_partitions.reserve(partitions.size());
+    for (auto& [version, table_partitions] : partitions_of_table) {
+        for (auto& [dk, idx] : table_partitions) {
+            sorted_partitions.push_back(&partitions[idx]);
+        }
+    }
+
+    co_await coroutine::parallel_for_each(sorted_partitions, [this, &ctx_ptr] (partition_hints* p) {
+        auto s = p->m.schema();
+        return futurize_invoke([this, p, s = std::move(s)] {
+            return this->send_one_mutation(frozen_mutation_and_schema{freeze(p->m), std::move(s)});
+        }).then_wrapped([this, p, &ctx_ptr] (future<> f) {
+            if (f.failed()) {
+                manager_logger.trace("send_hint_batch(): failed to send to {}: {}", end_point_key(), f.get_exception());
+                for (auto& rp : p->rps) {
+                    ctx_ptr->on_hint_send_failure(rp);
+                }
+            } else {
+                this->shard_stats().sent += p->rps.size();
+                for (auto& rp : p->rps) {
+                    ctx_ptr->on_hint_send_success(rp);
+                }
+                on_hints_replayed(*ctx_ptr);
+            }
+        });
+    });
+}
+
+void manager::end_point_hints_manager::sender::on_hints_replayed(const send_one_file_ctx& ctx) noexcept {
+    if (!ctx.advances_replayed_bound) {
+        return;
+    }
+    auto new_bound = ctx.get_replayed_bound();
+    // Segments from other shards are replayed first and are considered to be "before" replay position 0.
+    // Update the sent upper bound only if it is a local segment.
+    if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
+        _sent_upper_bound_rp = new_bound;
+        notify_replay_waiters();
+    }
+}
+
 void manager::end_point_hints_manager::sender::notify_replay_waiters() noexcept {
     if (!_foreign_segments_to_replay.empty()) {
         manager_logger.trace("[{}] notify_replay_waiters(): not notifying because there are still {} foreign segments to replay", end_point_key(), _foreign_segments_to_replay.size());
         return;
     }
+    // Compacted segments hold hints from below the replayed bound.
+    if (!_compacted_segments_to_replay.empty()) {
+        manager_logger.trace("[{}] notify_replay_waiters(): not notifying because there are still {} compacted segments to replay", end_point_key(), _compacted_segments_to_replay.size());
+        return;
+    }
 
     manager_logger.trace("[{}] notify_replay_waiters(): replay position upper bound was updated to {}", end_point_key(), _sent_upper_bound_rp);
     while (!_replay_waiters.empty() && _replay_waiters.begin()->first < _sent_upper_bound_rp) {
@@ -947,7 +1104,7 @@ void manager::end_point_hints_manager::sender::dismiss_replay_waiters() noexcept
 
 future<> manager::end_point_hints_manager::sender::wait_until_hints_are_replayed_up_to(abort_source& as, db::replay_position up_to_rp) {
     manager_logger.debug("[{}] wait_until_hints_are_replayed_up_to(): entering with target {}", end_point_key(), up_to_rp);
-    if (_foreign_segments_to_replay.empty() && up_to_rp < _sent_upper_bound_rp) {
+    if (_foreign_segments_to_replay.empty() && _compacted_segments_to_replay.empty() && up_to_rp < _sent_upper_bound_rp) {
         manager_logger.debug("[{}] wait_until_hints_are_replayed_up_to(): hints were already replayed above the point ({} < {})", end_point_key(), up_to_rp, _sent_upper_bound_rp);
         return make_ready_future<>();
     }
@@ -1029,6 +1186,11 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
     timespec last_mod = get_last_file_modification(fname).get0();
     gc_clock::duration secs_since_file_mod = std::chrono::seconds(last_mod.tv_sec);
     lw_shared_ptr<send_one_file_ctx> ctx_ptr = make_lw_shared<send_one_file_ctx>(_last_schema_ver_to_column_mapping);
+    if (auto it = _compacted_segments_mod_time.find(fname); it != _compacted_segments_mod_time.end()) {
+        // The hints of a compacted segment are as old as the oldest segment it was written from.
+        secs_since_file_mod = it->second;
+        ctx_ptr->advances_replayed_bound = false;
+    }
 
     try {
         commitlog::read_log_file(fname, manager::FILENAME_PREFIX, service::get_local_streaming_priority(), [this, secs_since_file_mod, &fname, ctx_ptr] (commitlog::buffer_and_replay_position buf_rp) -> future<> {
@@ -1062,6 +1224,13 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
                     //   hints in a segment".
                     co_await sleep(std::chrono::milliseconds(100));
                     continue;
+                } else if (auto batch_size = replay_batch_size()) {
+                    ctx_ptr->mark_hint_as_in_progress(rp);
+                    ctx_ptr->pending_hints.push_back(pending_hint{std::move(buf), rp});
+                    if (ctx_ptr->pending_hints.size() >= batch_size) {
+                        co_await send_hint_batch(ctx_ptr, secs_since_file_mod, fname);
+                    }
+                    break;
                 } else {
                     co_await send_one_hint(ctx_ptr, std::move(buf), rp, secs_since_file_mod, fname);
                     break;
@@ -1077,6 +1246,9 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
         ctx_ptr->segment_replay_failed = true;
     }
 
+    // send the rest of the last batch, or fail it if the segment replay failed
+    send_hint_batch(ctx_ptr, secs_since_file_mod, fname).get();
+
     // wait till all background hints sending is complete
     ctx_ptr->file_send_gate.close().get();
 
@@ -1101,6 +1273,7 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
         auto p = _ep_manager.get_or_load().get0();
         return p->delete_segments({ fname });
     }).get();
+    _compacted_segments_mod_time.erase(fname);
 
     // clear the replay position - we are going to send the next segment...
     _last_not_complete_rp = replay_position();
@@ -1114,6 +1287,9 @@ const sstring* manager::end_point_hints_manager::sender::name_of_current_segment
     if (!_foreign_segments_to_replay.empty()) {
         return &_foreign_segments_to_replay.front();
     }
+    if (!_compacted_segments_to_replay.empty()) {
+        return &_compacted_segments_to_replay.front();
+    }
     if (!_segments_to_replay.empty()) {
         return &_segments_to_replay.front();
     }
@@ -1123,6 +1299,8 @@ const sstring* manager::end_point_hints_manager::sender::name_of_current_segment
 void manager::end_point_hints_manager::sender::pop_current_segment() {
     if (!_foreign_segments_to_replay.empty()) {
         _foreign_segments_to_replay.pop_front();
+    } else if (!_compacted_segments_to_replay.empty()) {
+        _compacted_segments_to_replay.pop_front();
     } else if (!_segments_to_replay.empty()) {
         _segments_to_replay.pop_front();
     }
@@ -1167,6 +1345,149 @@ void manager::end_point_hints_manager::sender::send_hints_maybe() noexcept {
     manager_logger.trace("send_hints(): we handled {} segments", replayed_segments_count);
 }
 
+// Runs in the seastar::async context
+void manager::end_point_hints_manager::sender::compact_segments_maybe() {
+    if (!_db.get_config().enable_hinted_handoff_compaction() || stopping() || draining()
+            || (replay_allowed() && can_send()) || _segments_to_replay.size() < _min_segments_to_compact) {
+        return;
+    }
+    // The current segment was partially replayed, and its replay position would not survive the compaction.
+    if (_foreign_segments_to_replay.empty() && _last_not_complete_rp != replay_position()) {
+        return;
+    }
+
+    std::vector<sstring> candidates;
+    candidates.reserve(_compacted_segments_to_replay.size() + _segments_to_replay.size());
+    std::copy(_compacted_segments_to_replay.begin(), _compacted_segments_to_replay.end(), std::back_inserter(candidates));
+    std::copy(_segments_to_replay.begin(), _segments_to_replay.end(), std::back_inserter(candidates));
+    std::vector<uint64_t> sizes;
+    sizes.reserve(candidates.size());
+    uint64_t total_size = 0;
+    for (auto& seg : candidates) {
+        sizes.push_back(io_check(file_size, seg).get0());
+        total_size += sizes.back();
+    }
+
+    // The merged hints are held in memory, within the memory budget of hints sending.
+    auto units = _resource_manager.get_send_units_for(total_size).get0();
+    std::vector<sstring> sources;
+    uint64_t sources_size = 0;
+    for (size_t i = 0; i < candidates.size() && sources_size + sizes[i] <= units.count(); ++i) {
+        sources_size += sizes[i];
+        sources.push_back(std::move(candidates[i]));
+    }
+    const size_t compacted_sources = std::min(sources.size(), _compacted_segments_to_replay.size());
+    if (sources.size() < 2 || sources.size() == compacted_sources) {
+        return;
+    }
+
+    std::unordered_map<table_schema_version, column_mapping> column_mappings;
+    auto ctx_ptr = make_lw_shared<send_one_file_ctx>(column_mappings);
+    std::unordered_map<table_schema_version, std::map<dht::decorated_key, mutation, dht::decorated_key::less_comparator>> partitions;
+    std::optional<gc_clock::duration> oldest_mod;
+    uint64_t hints_read = 0;
+    uint64_t partitions_count = 0;
+    for (auto& fname : sources) {
+        gc_clock::duration secs_since_file_mod;
+        if (auto it = _compacted_segments_mod_time.find(fname); it != _compacted_segments_mod_time.end()) {
+            secs_since_file_mod = it->second;
+        } else {
+            secs_since_file_mod = std::chrono::seconds(get_last_file_modification(fname).get0().tv_sec);
+        }
+        oldest_mod = std::min(oldest_mod.value_or(secs_since_file_mod), secs_since_file_mod);
+
+        commitlog::read_log_file(fname, manager::FILENAME_PREFIX, service::get_local_streaming_priority(), [&] (commitlog::buffer_and_replay_position buf_rp) {
+            ++hints_read;
+            try {
+                auto m = get_mutation(ctx_ptr, buf_rp.buffer);
+                // The hint is too old - drop it. See send_one_hint().
+                if (gc_clock::now().time_since_epoch() - secs_since_file_mod > m.s->gc_grace_seconds() - manager::hints_flush_period) {
+                    return make_ready_future<>();
+                }
+                auto& table_partitions = partitions.try_emplace(m.s->version(), dht::decorated_key::less_comparator(m.s)).first->second;
+                auto dk = m.fm.decorated_key(*m.s);
+                auto it = table_partitions.find(dk);
+                if (it == table_partitions.end()) {
+                    table_partitions.emplace(std::move(dk), m.fm.unfreeze(m.s));
+                    ++partitions_count;
+                } else {
+                    // Cells superseded by the newer ones of this hint are dropped.
+                    it->second.apply(m.fm.unfreeze(m.s));
+                }
+            // The hint would be discarded by the replay too.
+            } catch (replica::no_such_column_family&) {
+            } catch (replica::no_such_keyspace&) {
+            } catch (no_column_mapping&) {
+            }
+            return make_ready_future<>();
+        }, 0, &_db.extensions()).get();
+
+        if (stopping() || (replay_allowed() && can_send())) {
+            // Replay the segments as they are instead.
+            return;
+        }
+    }
+
+    if (partitions_count == hints_read) {
+        // Nothing to drop, wait for more segments before trying again.
+        _min_segments_to_compact = _segments_to_replay.size() * 2;
+        manager_logger.debug("[{}] compact_segments_maybe(): no hint of {} segments can be dropped", end_point_key(), sources.size());
+        return;
+    }
+
+    // Write the merged hints to a segment of their own, and replace the compacted segments with it. The
+    // exclusive lock keeps new hints off that segment.
+    _file_update_mutex.lock().get();
+    auto unlock = defer([this] () noexcept { _file_update_mutex.unlock(); });
+    auto close_store = [this] {
+        if (auto store = std::exchange(_ep_manager._hints_store_anchor, nullptr)) {
+            store->shutdown().finally([store] {
+                return store->release();
+            }).get();
+        }
+    };
+
+    close_store();
+    std::set<db::segment_id_type> segment_ids;
+    {
+        auto store = _ep_manager.get_or_load().get0();
+        for (auto& table_partitions : partitions | boost::adaptors::map_values) {
+            for (auto& m : table_partitions | boost::adaptors::map_values) {
+                auto fm = freeze(m);
+                commitlog_entry_writer cew(m.schema(), fm, db::commitlog::force_sync::no);
+                auto rp = store->add_entry(m.schema()->id(), cew, db::timeout_clock::now() + _shard_manager.hint_file_write_timeout).get0().release();
+                segment_ids.insert(rp.id);
+                if (_ep_manager._last_written_rp < rp) {
+                    _ep_manager._last_written_rp = rp;
+                }
+                thread::maybe_yield();
+            }
+        }
+    }
+    close_store();
+    _ep_manager.get_or_load().get0()->delete_segments(sources).get();
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        _compacted_segments_mod_time.erase(sources[i]);
+        if (i < compacted_sources) {
+            _compacted_segments_to_replay.pop_front();
+        } else {
+            _segments_to_replay.pop_front();
+        }
+    }
+    for (auto id : segment_ids) {
+        auto name = format("{}/{}", _ep_manager._hints_dir.native(), db::commitlog::descriptor(id, manager::FILENAME_PREFIX).filename());
+        _compacted_segments_mod_time.emplace(name, *oldest_mod);
+        _compacted_segments_to_replay.push_back(std::move(name));
+    }
+    _min_segments_to_compact = 2;
+
+    shard_stats().compacted += hints_read - partitions_count;
+    shard_stats().compacted_files += sources.size();
+    manager_logger.debug("[{}] compact_segments_maybe(): compacted {} hints of {} segments into {} hints of {} segments",
+            end_point_key(), hints_read, sources.size(), partitions_count, segment_ids.size());
+}
+
 static future<> scan_for_hints_dirs(const sstring& hints_directory, std::function<future<> (fs::path dir, directory_entry de, unsigned shard_id)> f) {
     return lister::scan_dir(hints_directory, lister::dir_entry_types::of<directory_entry_type::directory>(), [f = std::move(f)] (fs::path dir, directory_entry de) mutable {
         unsigned shard_id;
@@ -74,6 +74,9 @@ class manager {
         uint64_t dropped = 0;
         uint64_t sent = 0;
         uint64_t discarded = 0;
+        uint64_t merged = 0;
+        uint64_t compacted = 0;
+        uint64_t compacted_files = 0;
         uint64_t corrupted_files = 0;
     };
 
@@ -108,6 +111,12 @@ class manager {
                 state::ep_state_left_the_ring,
                 state::draining>>;
 
+            // A hint read from a file, waiting for the rest of its batch.
+            struct pending_hint {
+                fragmented_temporary_buffer buf;
+                db::replay_position rp;
+            };
+
             struct send_one_file_ctx {
                 send_one_file_ctx(std::unordered_map<table_schema_version, column_mapping>& last_schema_ver_to_column_mapping)
                     : schema_ver_to_column_mapping(last_schema_ver_to_column_mapping)
@@ -117,7 +126,11 @@ class manager {
                 std::optional<db::replay_position> first_failed_rp;
                 std::optional<db::replay_position> last_succeeded_rp;
                 std::set<db::replay_position> in_progress_rps;
+                // Hints of the next batch. They are in progress already.
+                std::vector<pending_hint> pending_hints;
                 bool segment_replay_failed = false;
+                // Hints of compacted segments are replayed out of the order of their replay positions.
+                bool advances_replayed_bound = true;
 
                 void mark_hint_as_in_progress(db::replay_position rp);
                 void on_hint_send_success(db::replay_position rp) noexcept;
@@ -131,6 +144,13 @@ class manager {
             std::list<sstring> _segments_to_replay;
             // Segments to replay which were not created on this shard but were moved during rebalancing
             std::list<sstring> _foreign_segments_to_replay;
+            // Segments written by the compaction of other segments. They are replayed after the foreign segments,
+            // and before the local ones.
+            std::list<sstring> _compacted_segments_to_replay;
+            // The modification time of the oldest segment each compacted segment was written from.
+            std::unordered_map<sstring, gc_clock::duration> _compacted_segments_mod_time;
+            // The number of local segments which have to accumulate before the next compaction attempt.
+            size_t _min_segments_to_compact = 2;
             replay_position _last_not_complete_rp;
             replay_position _sent_upper_bound_rp;
             std::unordered_map<table_schema_version, column_mapping> _last_schema_ver_to_column_mapping;
@@ -183,7 +203,7 @@ class manager {
 
             /// \brief Check if there are still unsent segments.
             /// \return TRUE if there are still unsent segments.
-            bool have_segments() const noexcept { return !_segments_to_replay.empty() || !_foreign_segments_to_replay.empty(); };
+            bool have_segments() const noexcept { return !_segments_to_replay.empty() || !_foreign_segments_to_replay.empty() || !_compacted_segments_to_replay.empty(); };
 
             /// \brief Sets the sent_upper_bound_rp marker to indicate that the hints were replayed _up to_ given position.
             void rewind_sent_replay_position_to(db::replay_position rp);
@@ -244,6 +264,29 @@ class manager {
             /// \return future that resolves when next hint may be sent
             future<> send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
 
+            /// \brief The number of hints to replay together, 0 if hints are replayed one by one.
+            ///
+            /// Batches shrink as the view update backlog of the destination grows, so that
+            /// fewer hints are in the air while it is busy applying them.
+            size_t replay_batch_size() const;
+
+            /// \brief Send the pending hints of the file as a single batch.
+            ///  - Hints of the same partition are merged into a single mutation.
+            ///  - Partitions are sent in token order, and the storage_proxy coalesces
+            ///    those of the same shard of the destination into a single message.
+            ///  - The batch reserves the send units of all of its hints.
+            ///
+            /// \param ctx_ptr shared pointer to the file sending context
+            /// \param secs_since_file_mod last modification time stamp (in seconds since Epoch) of the current hints file
+            /// \param fname name of the hints file the hints were read from
+            /// \return future that resolves when next hint may be read
+            future<> send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+            future<> do_send_hint_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, std::vector<pending_hint> hints, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+            /// \brief Advance the replayed upper bound after hints of the file were sent.
+            void on_hints_replayed(const send_one_file_ctx& ctx) noexcept;
+
             /// \brief Send all hint from a single file and delete it after it has been successfully sent.
             /// Send all hints from the given file. If we failed to send the current segment we will pick up in the next
             /// iteration from where we left in this one.
@@ -252,6 +295,16 @@ class manager {
             /// \return TRUE if file has been successfully sent
             bool send_one_file(const sstring& fname);
 
+            /// \brief Compact the segments waiting for the destination Node to come back.
+            ///
+            /// Once enough local segments accumulate, merges the hints of the waiting local and compacted segments
+            /// per partition, within the memory budget of hints sending, and writes them to a segment of their own,
+            /// which replaces them. Cells of a hint superseded by newer ones of another hint are dropped, and so
+            /// are the hints too old to be replayed.
+            ///
+            /// The segments are left as they are if the compaction drops nothing.
+            void compact_segments_maybe();
+
             /// \brief Checks if we can still send hints.
             /// \return TRUE if the destination Node is either ALIVE or has left the ring (e.g. after decommission or removenode).
             bool can_send() noexcept;
@@ -7,6 +7,8 @@
  */
 
 #include <seastar/core/print.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include "db/system_keyspace.hh"
 #include "db/large_data_handler.hh"
 #include "sstables/sstables.hh"
@@ -59,7 +61,9 @@ future<> large_data_handler::stop() {
         return make_ready_future<>();
     }
     _running = false;
-    return _sem.wait(max_concurrency);
+    return flush_records().then([this] {
+        return _sem.wait(max_concurrency);
+    });
 }
 
 void large_data_handler::plug_system_keyspace(db::system_keyspace& sys_ks) noexcept {
@@ -156,14 +160,46 @@ future<> cql_table_large_data_handler::try_record(std::string_view large_table,
     const auto sstable_name = large_data_handler::sst_filename(sst);
     std::string pk_str = key_to_str(partition_key.to_partition_key(s), s);
     auto timestamp = db_clock::now();
+
+    auto key = record_key(sstring(large_table), ks_name, cf_name, sstable_name, sstring(pk_str), sstring(extra_path));
+    if (!_pending_records.contains(key) && _pending_records.size() >= max_pending_records) {
+        ++_stats.records_dropped;
+        large_data_logger.debug("Dropping the record of large {} {}/{}: {}{} ({} bytes) in {}, too many records are pending",
+                desc, ks_name, cf_name, pk_str, extra_path, size, sstable_name);
+        return make_ready_future<>();
+    }
     large_data_logger.warn("Writing large {} {}/{}: {}{} ({} bytes) to {}", desc, ks_name, cf_name, pk_str, extra_path, size, sstable_name);
-    return _sys_ks->execute_cql(req, ks_name, cf_name, sstable_name, size, pk_str, timestamp, args...)
-            .discard_result()
-            .handle_exception([ks_name, cf_name, large_table, sstable_name] (std::exception_ptr ep) {
-                large_data_logger.warn("Failed to add a record to system.large_{}s: ks = {}, table = {}, sst = {} exception = {}",
-                        large_table, ks_name, cf_name, sstable_name, ep);
-            })
-            .finally([ p = _sys_ks ] {});
+    _pending_records.insert_or_assign(std::move(key), [sys_ks = _sys_ks, req, ks_name, cf_name, large_table = sstring(large_table), sstable_name, size, pk_str, timestamp, ...args = data_value(args)] {
+        return sys_ks->execute_cql(req, ks_name, cf_name, sstable_name, size, pk_str, timestamp, args...)
+                .discard_result()
+                .handle_exception([ks_name, cf_name, large_table, sstable_name] (std::exception_ptr ep) {
+                    large_data_logger.warn("Failed to add a record to system.large_{}s: ks = {}, table = {}, sst = {} exception = {}",
+                            large_table, ks_name, cf_name, sstable_name, ep);
+                })
+                .finally([sys_ks] {});
+    });
+    if (!_flushing) {
+        _flushing = true;
+        // Let the records made by the same task be written together.
+        _flushed = yield().then([this] {
+            return write_pending_records();
+        });
+    }
+    return make_ready_future<>();
+}
+
+future<> cql_table_large_data_handler::write_pending_records() const {
+    while (!_pending_records.empty()) {
+        auto records = std::exchange(_pending_records, {});
+        co_await max_concurrent_for_each(records, max_concurrent_writes, [] (auto& record) {
+            return record.second();
+        });
+    }
+    _flushing = false;
+}
+
+future<> cql_table_large_data_handler::flush_records() {
+    return _flushed.get_future();
 }
 
 future<> cql_table_large_data_handler::record_large_partitions(const sstables::sstable& sst, const sstables::key& key, uint64_t partition_size, uint64_t rows) const {
@@ -219,6 +255,12 @@ future<> cql_table_large_data_handler::record_large_rows(const sstables::sstable
 
 future<> cql_table_large_data_handler::delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view large_table_name) const {
     assert(_sys_ks);
+    // Records of the sstable which were not written yet would outlive the
+    // deletion.
+    std::erase_if(_pending_records, [&] (const auto& record) {
+        const auto& [large_table, ks_name, cf_name, sst, pk, path] = record.first;
+        return sst == sstable_name && ks_name == s.ks_name() && cf_name == s.cf_name() && format("large_{}s", large_table) == large_table_name;
+    });
     const sstring req =
             format("DELETE FROM system.{} WHERE keyspace_name = ? AND table_name = ? AND sstable_name = ?",
                     large_table_name);
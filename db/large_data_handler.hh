@@ -9,6 +9,9 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
+#include <seastar/core/shared_future.hh>
+#include <seastar/util/noncopyable_function.hh>
 #include "schema_fwd.hh"
 #include "system_keyspace.hh"
 #include "sstables/shared_sstable.hh"
@@ -27,6 +30,7 @@ class large_data_handler {
 public:
     struct stats {
         int64_t partitions_bigger_than_threshold = 0; // number of large partition updates exceeding threshold_bytes
+        int64_t records_dropped = 0; // number of records not written because too many were pending
     };
 
 private:
@@ -61,10 +65,8 @@ class large_data_handler {
     uint64_t _rows_count_threshold;
     uint64_t _collection_elements_count_threshold;
 
-private:
     mutable large_data_handler::stats _stats;
 
-protected:
     seastar::shared_ptr<db::system_keyspace> _sys_ks;
 
 public:
@@ -76,6 +78,12 @@ class large_data_handler {
     void start();
     future<> stop();
 
+    // Waits for the records made so far to be written, if they are written
+    // in the background.
+    virtual future<> flush_records() {
+        return make_ready_future<>();
+    }
+
     future<bool> maybe_record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, uint64_t row_size) {
         assert(running());
@@ -155,6 +163,20 @@ class cql_table_large_data_handler : public large_data_handler {
     threshold_updater _cell_threshold_mb_updater;
     threshold_updater _rows_count_threshold_updater;
     threshold_updater _collection_elements_count_threshold_updater;
+
+    // Records are buffered and written in the background, so that writing an
+    // sstable never waits for them. A record of the same partition, row or
+    // cell of the same sstable is written once, however many times it is
+    // made before it is written. Records made while max_pending_records are
+    // waiting to be written are dropped.
+    static constexpr size_t max_pending_records = 1024;
+    static constexpr size_t max_concurrent_writes = 16;
+    // The large data table, keyspace, table, sstable, partition key, and
+    // the path of the row or cell in the partition.
+    using record_key = std::tuple<sstring, sstring, sstring, sstring, sstring, sstring>;
+    mutable std::map<record_key, noncopyable_function<future<> ()>> _pending_records;
+    mutable bool _flushing = false;
+    mutable shared_future<> _flushed{make_ready_future<>()};
 public:
     explicit cql_table_large_data_handler(gms::feature_service& feat,
             utils::updateable_value<uint32_t> partition_threshold_mb,
@@ -163,6 +185,8 @@ class cql_table_large_data_handler : public large_data_handler {
             utils::updateable_value<uint32_t> rows_count_threshold,
             utils::updateable_value<uint32_t> collection_elements_count_threshold);
 
+    virtual future<> flush_records() override;
+
 protected:
     virtual future<> record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const override;
     virtual future<> delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view large_table_name) const override;
@@ -177,6 +201,8 @@ class cql_table_large_data_handler : public large_data_handler {
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const;
 
 private:
+    future<> write_pending_records() const;
+
     template <typename... Args>
     future<> try_record(std::string_view large_table, const sstables::sstable& sst,  const sstables::key& partition_key, int64_t size,
             std::string_view desc, std::string_view extra_path, const std::vector<sstring> &extra_fields, Args&&... args) const;
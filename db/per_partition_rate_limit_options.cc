@@ -17,6 +17,8 @@ namespace db {
 
 const char* per_partition_rate_limit_options::max_writes_per_second_key = "max_writes_per_second";
 const char* per_partition_rate_limit_options::max_reads_per_second_key = "max_reads_per_second";
+const char* per_partition_rate_limit_options::max_table_writes_per_second_key = "max_table_writes_per_second";
+const char* per_partition_rate_limit_options::max_table_reads_per_second_key = "max_table_reads_per_second";
 
 per_partition_rate_limit_options::per_partition_rate_limit_options(std::map<sstring, sstring> map) {
     auto handle_uint32_arg = [&] (const char* key) -> std::optional<uint32_t> {
@@ -41,6 +43,8 @@ per_partition_rate_limit_options::per_partition_rate_limit_options(std::map<sstr
 
     _max_writes_per_second = handle_uint32_arg(max_writes_per_second_key);
     _max_reads_per_second = handle_uint32_arg(max_reads_per_second_key);
+    _max_table_writes_per_second = handle_uint32_arg(max_table_writes_per_second_key);
+    _max_table_reads_per_second = handle_uint32_arg(max_table_reads_per_second_key);
 
     if (!map.empty()) {
         throw exceptions::configuration_exception(format(
@@ -57,6 +61,12 @@ std::map<sstring, sstring> per_partition_rate_limit_options::to_map() const {
     if (_max_reads_per_second) {
         ret.insert_or_assign(max_reads_per_second_key, std::to_string(*_max_reads_per_second));
     }
+    if (_max_table_writes_per_second) {
+        ret.insert_or_assign(max_table_writes_per_second_key, std::to_string(*_max_table_writes_per_second));
+    }
+    if (_max_table_reads_per_second) {
+        ret.insert_or_assign(max_table_reads_per_second_key, std::to_string(*_max_table_reads_per_second));
+    }
     return ret;
 }
 
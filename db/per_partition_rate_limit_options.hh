@@ -23,10 +23,16 @@ class per_partition_rate_limit_options final {
 private:
     static const char* max_writes_per_second_key;
     static const char* max_reads_per_second_key;
+    static const char* max_table_writes_per_second_key;
+    static const char* max_table_reads_per_second_key;
 
 private:
     std::optional<uint32_t> _max_writes_per_second;
     std::optional<uint32_t> _max_reads_per_second;
+    // Limits on all operations of the table, enforced by each coordinator
+    // node on the operations it coordinates.
+    std::optional<uint32_t> _max_table_writes_per_second;
+    std::optional<uint32_t> _max_table_reads_per_second;
 
 public:
     per_partition_rate_limit_options() = default;
@@ -44,6 +50,16 @@ class per_partition_rate_limit_options final {
         std::abort(); // compiler will error before we reach here
     }
 
+    inline std::optional<uint32_t> get_max_table_ops_per_second(operation_type op_type) const {
+        switch (op_type) {
+        case operation_type::write:
+            return _max_table_writes_per_second;
+        case operation_type::read:
+            return _max_table_reads_per_second;
+        }
+        std::abort(); // compiler will error before we reach here
+    }
+
     inline void set_max_writes_per_second(std::optional<uint32_t> v) {
         _max_writes_per_second = v;
     }
@@ -59,6 +75,22 @@ class per_partition_rate_limit_options final {
     inline std::optional<uint32_t> get_max_reads_per_second() const {
         return _max_reads_per_second;
     }
+
+    inline void set_max_table_writes_per_second(std::optional<uint32_t> v) {
+        _max_table_writes_per_second = v;
+    }
+
+    inline std::optional<uint32_t> get_max_table_writes_per_second() const {
+        return _max_table_writes_per_second;
+    }
+
+    inline void set_max_table_reads_per_second(std::optional<uint32_t> v) {
+        _max_table_reads_per_second = v;
+    }
+
+    inline std::optional<uint32_t> get_max_table_reads_per_second() const {
+        return _max_table_reads_per_second;
+    }
 };
 
 }
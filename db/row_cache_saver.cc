@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/file.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/with_scheduling_group.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/util/short_streams.hh>
+
+#include "checked-file-impl.hh"
+#include "db/row_cache_saver.hh"
+#include "log.hh"
+#include "readers/flat_mutation_reader_v2.hh"
+#include "replica/database.hh"
+#include "utils/disk-error-handler.hh"
+
+namespace db {
+
+static logging::logger cslogger("row_cache_saver");
+
+// A saved cache is a sequence of partition keys, each prefixed by its
+// length, as a little-endian 32-bit integer.
+static constexpr size_t key_length_size = sizeof(uint32_t);
+
+row_cache_saver::row_cache_saver(replica::database& db, config cfg)
+        : _db(db)
+        , _cfg(std::move(cfg)) {
+    namespace sm = seastar::metrics;
+    _metrics.add_group("cache", {
+        sm::make_gauge("warmup_partitions_total", [this] { return _stats.warmup_keys_total; },
+                       sm::description("Number of partitions found in the saved cache, to be read into the cache on startup.")),
+        sm::make_counter("warmup_partitions_loaded", [this] { return _stats.warmup_keys_loaded; },
+                       sm::description("Number of partitions from the saved cache read into the cache since startup.")),
+        sm::make_counter("key_saves", [this] { return _stats.saves; },
+                       sm::description("Number of times the keys of the cache were saved.")),
+    });
+}
+
+std::filesystem::path row_cache_saver::file_path(const replica::table& t, unsigned shard) const {
+    auto& s = *t.schema();
+    return _cfg.directory / fmt::format("{}-{}-{}-{}.keys", s.ks_name(), s.cf_name(), s.id(), shard);
+}
+
+future<> row_cache_saver::start() {
+    _warmup = with_scheduling_group(_cfg.sched_group, [this] {
+        return warm_up();
+    });
+    if (_cfg.save_period.count() > 0 && _cfg.keys_to_save > 0) {
+        _saver = with_scheduling_group(_cfg.sched_group, [this] {
+            return save_periodically();
+        });
+    }
+    return make_ready_future<>();
+}
+
+future<> row_cache_saver::stop() {
+    _as.request_abort();
+    co_await std::exchange(_warmup, make_ready_future<>());
+    co_await std::exchange(_saver, make_ready_future<>());
+    if (_cfg.save_period.count() > 0 && _cfg.keys_to_save > 0) {
+        try {
+            co_await save();
+        } catch (...) {
+            cslogger.warn("Failed to save the row cache on shutdown: {}", std::current_exception());
+        }
+    }
+    co_await _gate.close();
+}
+
+future<> row_cache_saver::save_periodically() {
+    while (!_as.abort_requested()) {
+        try {
+            co_await sleep_abortable(_cfg.save_period, _as);
+        } catch (const sleep_aborted&) {
+            co_return;
+        }
+        try {
+            co_await save();
+        } catch (...) {
+            cslogger.warn("Failed to save the row cache: {}", std::current_exception());
+        }
+    }
+}
+
+future<> row_cache_saver::save() {
+    auto holder = _gate.hold();
+    co_await io_check([dir = _cfg.directory.native()] { return recursive_touch_directory(dir); });
+    for (auto& t : _db.get_non_system_column_families()) {
+        if (t->async_gate().is_closed()) {
+            continue;
+        }
+        auto table_holder = t->async_gate().hold();
+        co_await save(*t);
+    }
+    ++_stats.saves;
+}
+
+future<> row_cache_saver::save(replica::table& t) {
+    auto keys = co_await t.get_row_cache().cached_partition_keys(_cfg.keys_to_save);
+    auto path = file_path(t, this_shard_id());
+    if (keys.empty()) {
+        co_await remove_file(path.native()).handle_exception([] (std::exception_ptr) { });
+        co_return;
+    }
+
+    // Write to a temporary file, so that a crash leaves the previous save intact.
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+    auto f = co_await open_checked_file_dma(general_disk_error_handler, tmp_path.native(), open_flags::wo | open_flags::create | open_flags::truncate);
+    auto out = co_await make_file_output_stream(std::move(f));
+    std::exception_ptr ex;
+    try {
+        for (auto& dk : keys) {
+            auto key = to_bytes(dk.key().representation());
+            char length[key_length_size];
+            write_le<uint32_t>(length, key.size());
+            co_await out.write(length, sizeof(length));
+            co_await out.write(reinterpret_cast<const char*>(key.data()), key.size());
+        }
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+    if (ex) {
+        co_await coroutine::return_exception_ptr(std::move(ex));
+    }
+    co_await io_check(rename_file, tmp_path.native(), path.native());
+    cslogger.debug("Saved {} keys of {}.{}", keys.size(), t.schema()->ks_name(), t.schema()->cf_name());
+}
+
+future<> row_cache_saver::warm_up() {
+    auto holder = _gate.hold();
+    for (auto& t : _db.get_non_system_column_families()) {
+        if (_as.abort_requested()) {
+            break;
+        }
+        if (t->async_gate().is_closed()) {
+            continue;
+        }
+        auto table_holder = t->async_gate().hold();
+        try {
+            co_await warm_up(*t);
+        } catch (...) {
+            cslogger.warn("Failed to warm up the row cache of {}.{}: {}", t->schema()->ks_name(), t->schema()->cf_name(), std::current_exception());
+        }
+    }
+    _stats.warmup_done = true;
+    if (_stats.warmup_keys_total) {
+        cslogger.info("Read {} of {} saved partitions into the row cache", _stats.warmup_keys_loaded, _stats.warmup_keys_total);
+    }
+}
+
+future<> row_cache_saver::warm_up(replica::table& t) {
+    auto path = file_path(t, this_shard_id());
+    if (!co_await file_exists(path.native())) {
+        co_return;
+    }
+    auto f = co_await open_checked_file_dma(general_disk_error_handler, path.native(), open_flags::ro);
+    auto in = make_file_input_stream(std::move(f));
+    auto buf = co_await util::read_entire_stream_contiguous(in);
+    co_await in.close();
+
+    auto s = t.schema();
+    std::vector<dht::decorated_key> keys;
+    for (size_t pos = 0; pos + key_length_size <= buf.size();) {
+        auto length = read_le<uint32_t>(buf.data() + pos);
+        pos += key_length_size;
+        if (length > buf.size() - pos) {
+            cslogger.warn("Saved cache {} is truncated", path.native());
+            break;
+        }
+        auto pk = partition_key::from_bytes(bytes_view(reinterpret_cast<const int8_t*>(buf.data() + pos), length));
+        pos += length;
+        auto dk = dht::decorate_key(*s, std::move(pk));
+        // The shard count may have changed since the save.
+        if (dht::shard_of(*s, dk.token()) == this_shard_id()) {
+            keys.push_back(std::move(dk));
+        }
+        co_await coroutine::maybe_yield();
+    }
+    _stats.warmup_keys_total += keys.size();
+
+    for (auto& dk : keys) {
+        if (_as.abort_requested()) {
+            co_return;
+        }
+        auto range = dht::partition_range::make_singular(dk);
+        auto permit = co_await _db.obtain_reader_permit(t, "row_cache_warmup", db::no_timeout);
+        auto reader = t.make_reader_v2(s, std::move(permit), range, s->full_slice());
+        std::exception_ptr ex;
+        try {
+            co_await reader.consume_pausable([] (mutation_fragment_v2) {
+                return stop_iteration::no;
+            });
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await reader.close();
+        if (ex) {
+            co_await coroutine::return_exception_ptr(std::move(ex));
+        }
+        ++_stats.warmup_keys_loaded;
+    }
+}
+
+}
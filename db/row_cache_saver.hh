@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/sharded.hh>
+
+#include "replica/database_fwd.hh"
+#include "seastarx.hh"
+
+namespace db {
+
+// Saves the keys of the partitions in the row cache of user tables, and reads
+// them back into the cache on startup, so that a restarted node doesn't serve
+// from a cold cache until the workload warms it up again.
+//
+// Each shard saves the keys it caches, up to keys_to_save per table, every
+// save_period, to a file of its own in the saved caches directory. On startup,
+// each shard reads the partitions of its file which it still owns, in the
+// background, in the given scheduling group.
+class row_cache_saver : public peering_sharded_service<row_cache_saver> {
+public:
+    struct config {
+        std::filesystem::path directory;
+        // Zero disables saving.
+        std::chrono::seconds save_period;
+        uint32_t keys_to_save;
+        scheduling_group sched_group;
+    };
+
+    struct stats {
+        // Partitions found in the saved caches of this shard.
+        uint64_t warmup_keys_total = 0;
+        // Partitions read into the cache so far.
+        uint64_t warmup_keys_loaded = 0;
+        bool warmup_done = false;
+        uint64_t saves = 0;
+    };
+private:
+    replica::database& _db;
+    config _cfg;
+    stats _stats;
+    abort_source _as;
+    gate _gate;
+    future<> _warmup = make_ready_future<>();
+    future<> _saver = make_ready_future<>();
+    seastar::metrics::metric_groups _metrics;
+private:
+    std::filesystem::path file_path(const replica::table& t, unsigned shard) const;
+
+    future<> save(replica::table& t);
+    future<> warm_up(replica::table& t);
+    future<> warm_up();
+    future<> save_periodically();
+public:
+    row_cache_saver(replica::database& db, config cfg);
+
+    // Starts warming up the cache from the saved keys, and saving them periodically.
+    future<> start();
+    // Saves the keys one last time.
+    future<> stop();
+
+    // Saves the keys of all user tables.
+    future<> save();
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+};
+
+}
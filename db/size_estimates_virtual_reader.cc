@@ -22,6 +22,7 @@
 #include "range.hh"
 #include "mutation_fragment.hh"
 #include "sstables/sstables.hh"
+#include "sstables/hyperloglog.hh"
 #include "replica/database.hh"
 
 #include "db/size_estimates_virtual_reader.hh"
@@ -159,8 +160,40 @@ static dht::partition_range as_ring_position_range(dht::token_range& r) {
     return dht::partition_range(std::move(start_bound), std::move(end_bound), r.is_singular());
 }
 
+/**
+ * Returns the fraction of the partitions of the given sstables which are distinct,
+ * according to their cardinality estimators, or 1 if it can't be estimated.
+ */
+static double distinct_partitions_ratio(const std::vector<sstables::shared_sstable>& sstables) {
+    if (sstables.size() < 2) {
+        return 1.0;
+    }
+    try {
+        std::optional<hll::HyperLogLog> all;
+        double sum = 0;
+        for (auto&& sstable : sstables) {
+            auto& elements = sstable->get_compaction_metadata().cardinality.elements;
+            auto cardinality = std::vector<uint8_t>(elements.begin(), elements.end());
+            auto hll = hll::HyperLogLog::from_bytes(cardinality.data(), cardinality.size());
+            sum += hll.estimate();
+            if (all) {
+                all->merge(hll);
+            } else {
+                all = std::move(hll);
+            }
+        }
+        return sum > 0 ? std::min(1.0, all->estimate() / sum) : 1.0;
+    } catch (...) {
+        // Missing compaction metadata, or an unsupported format.
+        return 1.0;
+    }
+}
+
 /**
  * Add a new range_estimates for the specified range, considering the sstables associated with `cf`.
+ *
+ * The partitions of a range are counted once per sstable they are in, so the count is
+ * scaled down by the fraction of the partitions of the sstables which are distinct.
  */
 static system_keyspace::range_estimates estimate(const replica::column_family& cf, const token_range& r) {
     int64_t count{0};
@@ -175,10 +208,13 @@ static system_keyspace::range_estimates estimate(const replica::column_family& c
         [&] (auto&& rng) { ranges.push_back(std::move(rng)); });
     for (auto&& r : ranges) {
         auto rp_range = as_ring_position_range(r);
-        for (auto&& sstable : cf.select_sstables(rp_range)) {
-            count += sstable->estimated_keys_for_range(r);
+        auto sstables = cf.select_sstables(rp_range);
+        int64_t range_count = 0;
+        for (auto&& sstable : sstables) {
+            range_count += sstable->estimated_keys_for_range(r);
             hist.merge(sstable->get_stats_metadata().estimated_partition_size);
         }
+        count += range_count * distinct_partitions_ratio(sstables);
     }
     return {cf.schema(), r.start, r.end, count, count > 0 ? hist.mean() : 0};
 }
@@ -11,14 +11,79 @@
  */
 
 #include <boost/range/adaptors.hpp>
+#include <boost/range/join.hpp>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include "db/snapshot-ctl.hh"
 #include "replica/database.hh"
+#include "service/priority_manager.hh"
+#include "sstables/sstables.hh"
+#include "checked-file-impl.hh"
+#include "utils/lister.hh"
 
 namespace db {
 
+static logging::logger backup_log("backup");
+
+class snapshot_ctl::backup_module : public tasks::task_manager::module {
+    seastar::abort_source _as;
+public:
+    explicit backup_module(tasks::task_manager& tm) noexcept : module(tm, "backup") {}
+
+    seastar::abort_source& abort_source() noexcept override {
+        return _as;
+    }
+
+    future<> stop() noexcept override {
+        _as.request_abort();
+        auto tasks = boost::copy_range<std::vector<tasks::task_manager::task_ptr>>(_tasks | boost::adaptors::map_values);
+        co_await coroutine::parallel_for_each(tasks, [] (tasks::task_manager::task_ptr& task) {
+            return task->abort();
+        });
+        co_await module::stop();
+    }
+};
+
+class snapshot_ctl::backup_task_impl : public tasks::task_manager::task::impl {
+    snapshot_ctl& _snap_ctl;
+    sstring _destination;
+public:
+    backup_task_impl(tasks::task_manager::module_ptr module, snapshot_ctl& snap_ctl, sstring ks_name, sstring tag, sstring destination) noexcept
+        : tasks::task_manager::task::impl(module, tasks::task_id::create_random_id(), module->new_sequence_number(), std::move(ks_name), "", std::move(tag), tasks::task_id::create_null_id())
+        , _snap_ctl(snap_ctl)
+        , _destination(std::move(destination))
+    {
+        _status.progress_units = "bytes";
+    }
+
+    virtual std::string type() const override {
+        return "backup";
+    }
+
+    virtual tasks::is_abortable is_abortable() const noexcept override {
+        return tasks::is_abortable::yes;
+    }
+protected:
+    virtual future<> run() override {
+        return _snap_ctl.do_backup(_status.keyspace, _status.entity, _destination, _progress, _as);
+    }
+};
+
+snapshot_ctl::snapshot_ctl(sharded<replica::database>& db, tasks::task_manager& tm)
+    : _db(db)
+    , _backup_module(seastar::make_shared<backup_module>(tm))
+{
+    tm.register_module("backup", _backup_module);
+}
+
+future<> snapshot_ctl::stop() {
+    co_await _backup_module->stop();
+    co_await _ops.close();
+}
+
 future<> snapshot_ctl::check_snapshot_not_exist(sstring ks_name, sstring name, std::optional<std::vector<sstring>> filter) {
     auto& ks = _db.local().find_keyspace(ks_name);
     return parallel_for_each(ks.metadata()->cf_meta_data(), [this, ks_name = std::move(ks_name), name = std::move(name), filter = std::move(filter)] (auto& pair) {
@@ -120,6 +185,143 @@ snapshot_ctl::get_snapshot_details() {
     }));
 }
 
+future<tasks::task_id> snapshot_ctl::start_backup(sstring ks_name, sstring tag, sstring destination) {
+    if (ks_name.empty()) {
+        throw std::runtime_error("You must supply a keyspace name");
+    }
+    if (tag.empty()) {
+        throw std::runtime_error("You must supply a snapshot name.");
+    }
+    if (destination.empty()) {
+        throw std::runtime_error("You must supply a backup destination");
+    }
+    _db.local().find_keyspace(ks_name);
+
+    co_return co_await container().invoke_on(0, [ks_name = std::move(ks_name), tag = std::move(tag), destination = std::move(destination)] (snapshot_ctl& snap) mutable -> future<tasks::task_id> {
+        auto task_impl = std::make_unique<backup_task_impl>(snap._backup_module, snap, std::move(ks_name), std::move(tag), std::move(destination));
+        auto task = co_await snap._backup_module->make_task(std::move(task_impl));
+        task->start();
+        co_return task->id();
+    });
+}
+
+// The number of files copied in parallel by a backup.
+static constexpr size_t backup_parallelism = 4;
+static constexpr size_t backup_chunk_size = 128 * 1024;
+
+struct backup_file {
+    fs::path source;
+    fs::path destination;
+    uint64_t size;
+};
+
+// Copies the file to a temporary file next to its destination, which is
+// renamed once complete, so that a file found in the destination is never
+// a partial copy.
+static future<> copy_backup_file(const backup_file& bf, tasks::task_manager::task::progress& progress, abort_source& as) {
+    auto tmp = bf.destination.native() + ".tmp";
+    auto dir = bf.destination.parent_path().native();
+    co_await io_check([&dir] { return recursive_touch_directory(dir); });
+
+    file_input_stream_options in_options;
+    in_options.buffer_size = backup_chunk_size;
+    in_options.read_ahead = 2;
+    in_options.io_priority_class = service::get_local_streaming_priority();
+    file_output_stream_options out_options;
+    out_options.buffer_size = backup_chunk_size;
+    out_options.write_behind = 2;
+    out_options.io_priority_class = service::get_local_streaming_priority();
+
+    auto in = make_file_input_stream(co_await open_checked_file_dma(general_disk_error_handler, bf.source.native(), open_flags::ro), 0, in_options);
+    std::optional<output_stream<char>> out;
+    std::exception_ptr ex;
+    try {
+        out = co_await make_file_output_stream(co_await open_checked_file_dma(general_disk_error_handler, tmp, open_flags::wo | open_flags::create | open_flags::truncate), out_options);
+        for (;;) {
+            auto buf = co_await in.read();
+            if (buf.empty()) {
+                break;
+            }
+            as.check();
+            co_await out->write(buf.get(), buf.size());
+            progress.completed += buf.size();
+        }
+        co_await out->flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await in.close();
+    if (out) {
+        co_await out->close();
+    }
+    if (ex) {
+        co_await remove_file(tmp).handle_exception([] (std::exception_ptr) {});
+        co_await coroutine::return_exception_ptr(std::move(ex));
+    }
+    co_await io_check(rename_file, tmp, bf.destination.native());
+    co_await io_check(sync_directory, dir);
+}
+
+future<> snapshot_ctl::do_backup(sstring ks_name, sstring tag, sstring destination, tasks::task_manager::task::progress& progress, abort_source& as) {
+    co_await with_scheduling_group(_db.local().get_streaming_scheduling_group(), [&] {
+        return run_snapshot_list_operation(coroutine::lambda([&] () -> future<> {
+            auto& db = _db.local();
+            // sstable files, and the files describing the snapshot, which are
+            // copied last, so that a snapshot's manifest is only in the
+            // destination once all its sstables are.
+            std::vector<backup_file> files;
+            std::vector<backup_file> metadata;
+            uint64_t skipped = 0;
+            auto schemas = boost::copy_range<std::vector<schema_ptr>>(db.find_keyspace(ks_name).metadata()->cf_meta_data() | boost::adaptors::map_values);
+            for (auto& schema : schemas) {
+                auto table_dir = fs::path(db.find_column_family(schema).dir());
+                auto snapshot_dir = table_dir / sstables::snapshots_dir / tag.c_str();
+                if (!co_await file_exists(snapshot_dir.native())) {
+                    continue;
+                }
+                auto backup_dir = fs::path(destination.c_str()) / ks_name.c_str() / table_dir.filename();
+                std::vector<sstring> names;
+                co_await lister::scan_dir(snapshot_dir, lister::dir_entry_types::of<directory_entry_type::regular>(), [&names] (fs::path, directory_entry de) {
+                    names.push_back(de.name);
+                    return make_ready_future<>();
+                });
+                for (auto& name : names) {
+                    auto size = co_await io_check(file_size, (snapshot_dir / name.c_str()).native());
+                    // The manifest and schema describe this snapshot. sstable
+                    // files never change once written, so one already in the
+                    // destination with the same size is a complete copy.
+                    if (name == "manifest.json" || name == "schema.cql") {
+                        metadata.push_back({snapshot_dir / name.c_str(), backup_dir / sstables::snapshots_dir / tag.c_str() / name.c_str(), size});
+                    } else {
+                        auto dst = backup_dir / name.c_str();
+                        if (co_await file_exists(dst.native()) && co_await file_size(dst.native()) == size) {
+                            skipped += size;
+                            continue;
+                        }
+                        files.push_back({snapshot_dir / name.c_str(), std::move(dst), size});
+                    }
+                }
+            }
+            if (metadata.empty()) {
+                throw std::runtime_error(format("Keyspace {}: snapshot {} does not exist.", ks_name, tag));
+            }
+
+            for (auto& f : boost::range::join(files, metadata)) {
+                progress.total += f.size;
+            }
+            backup_log.info("Backing up snapshot {} of keyspace {} to {}: copying {} files, {} bytes, skipping {} bytes already in the destination",
+                    tag, ks_name, destination, files.size() + metadata.size(), uint64_t(progress.total), skipped);
+            co_await max_concurrent_for_each(files, backup_parallelism, [&] (const backup_file& f) {
+                return copy_backup_file(f, progress, as);
+            });
+            co_await max_concurrent_for_each(metadata, backup_parallelism, [&] (const backup_file& f) {
+                return copy_backup_file(f, progress, as);
+            });
+            backup_log.info("Backed up snapshot {} of keyspace {} to {}", tag, ks_name, destination);
+        }));
+    });
+}
+
 future<int64_t> snapshot_ctl::true_snapshots_size() {
     co_return co_await run_snapshot_list_operation(coroutine::lambda([this] () -> future<int64_t> {
         int64_t total = 0;
@@ -19,6 +19,7 @@
 #include "replica/database_fwd.hh"
 #include <seastar/core/gate.hh>
 #include <seastar/core/rwlock.hh>
+#include "tasks/task_manager.hh"
 
 using namespace seastar;
 
@@ -37,11 +38,9 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
 
         bool operator==(const snapshot_details&) const = default;
     };
-    explicit snapshot_ctl(sharded<replica::database>& db) : _db(db) {}
+    snapshot_ctl(sharded<replica::database>& db, tasks::task_manager& tm);
 
-    future<> stop() {
-        return _ops.close();
-    }
+    future<> stop();
 
     /**
      * Takes the snapshot for all keyspaces. A snapshot name must be specified.
@@ -88,8 +87,31 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
     future<std::unordered_map<sstring, std::vector<snapshot_details>>> get_snapshot_details();
 
     future<int64_t> true_snapshots_size();
+
+    /**
+     * Starts copying the snapshot with the given tag of the given keyspace to
+     * the destination directory, typically a mount of an object store. Each
+     * table's files go to <destination>/<keyspace>/<table directory>, as in
+     * the data directory, with the manifest and schema of the snapshot in
+     * its snapshots/<tag> subdirectory.
+     *
+     * sstable files already in the destination, e.g. copied by the backup of
+     * an earlier snapshot, are not copied again, so backing up successive
+     * snapshots only copies the sstables written in between.
+     *
+     * The copying runs as a task of the "backup" task manager module, in the
+     * streaming scheduling group, so it is throttled by
+     * stream_io_throughput_mb_per_sec.
+     *
+     * @return the id of the backup task
+     */
+    future<tasks::task_id> start_backup(sstring ks_name, sstring tag, sstring destination);
 private:
+    class backup_module;
+    class backup_task_impl;
+
     sharded<replica::database>& _db;
+    shared_ptr<backup_module> _backup_module;
     seastar::rwlock _lock;
     seastar::gate _ops;
 
@@ -103,6 +125,7 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
 
     future<> do_take_snapshot(sstring tag, std::vector<sstring> keyspace_names, skip_flush sf = skip_flush::no);
     future<> do_take_column_family_snapshot(sstring ks_name, std::vector<sstring> tables, sstring tag, snap_views, skip_flush sf = skip_flush::no);
+    future<> do_backup(sstring ks_name, sstring tag, sstring destination, tasks::task_manager::task::progress& progress, abort_source& as);
 };
 
 }
@@ -175,11 +175,13 @@ schema_ptr system_keyspace::batchlog() {
         utf8_type,
         // comment
         "in-progress paxos proposals"
-        // FIXME: the original Java code also had:
-        // operations on resulting CFMetaData:
-        //    .compactionStrategyClass(LeveledCompactionStrategy.class);
        );
        builder.set_gc_grace_seconds(0);
+       // Each round overwrites the state of its key, and pruning and TTLs
+       // delete it, so keep the number of sstables a read of a key has to
+       // merge bounded, and purge expired state early.
+       builder.set_compaction_strategy(sstables::compaction_strategy_type::leveled);
+       builder.set_compaction_strategy_options({{"tombstone_threshold", "0.1"}, {"tombstone_compaction_interval", "3600"}});
        builder.with_version(generate_schema_version(builder.uuid()));
        builder.set_wait_for_sync_to_commitlog(true);
        return builder.build(schema_builder::compact_storage::no);
@@ -1969,7 +1971,11 @@ class token_ring_table : public streaming_virtual_table {
                 boost::sort(range._endpoint_details, endpoint_details_cmp());
 
                 for (const dht::endpoint_details& detail : range._endpoint_details) {
-                    clustering_row cr(make_clustering_key(range._start_token, detail._host));
+                    auto ck = make_clustering_key(range._start_token, detail._host);
+                    if (!contains_row(qr, dk, ck)) {
+                        continue;
+                    }
+                    clustering_row cr(std::move(ck));
                     set_cell(cr.cells(), "end_token", sstring(range._end_token));
                     set_cell(cr.cells(), "dc", sstring(detail._datacenter));
                     set_cell(cr.cells(), "rack", sstring(detail._rack));
@@ -2095,6 +2101,94 @@ class snapshots_table : public streaming_virtual_table {
     }
 };
 
+class reads_resource_usage_table : public streaming_virtual_table {
+    distributed<replica::database>& _db;
+public:
+    explicit reads_resource_usage_table(distributed<replica::database>& db)
+            : streaming_virtual_table(build_schema())
+            , _db(db)
+    {
+        _shard_aware = true;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "reads_resource_usage");
+        return schema_builder(system_keyspace::NAME, "reads_resource_usage", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("reads", long_type)
+            .with_column("cpu_time_us", long_type)
+            .with_column("disk_reads", long_type)
+            .with_column("disk_bytes_read", long_type)
+            .set_comment("Resources used by the completed reads of each table on this node, since startup, summed over all shards.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    dht::decorated_key make_partition_key(const sstring& name) {
+        return dht::decorate_key(*_s, partition_key::from_single_value(*_s, data_value(name).serialize_nonnull()));
+    }
+
+    clustering_key make_clustering_key(const sstring& table_name) {
+        return clustering_key::from_single_value(*_s, data_value(table_name).serialize_nonnull());
+    }
+
+    future<> execute(reader_permit permit, result_collector& result, const query_restrictions& qr) override {
+        using usage_map = reader_concurrency_semaphore::resource_usage_by_table_type;
+        auto usage = co_await _db.map_reduce0([] (replica::database& db) {
+            return db.get_reads_resource_usage();
+        }, usage_map{}, [] (usage_map acc, const usage_map& shard_usage) {
+            for (const auto& [id, table_usage] : shard_usage) {
+                acc[id] += table_usage;
+            }
+            return acc;
+        });
+
+        struct keyspace_usage {
+            dht::decorated_key key;
+            std::map<sstring, reader_concurrency_semaphore::table_resource_usage> tables;
+        };
+        std::map<sstring, keyspace_usage> keyspaces;
+        auto& db = _db.local();
+        for (const auto& [id, table_usage] : usage) {
+            if (!db.column_family_exists(id)) {
+                continue;
+            }
+            auto s = db.find_schema(id);
+            auto it = keyspaces.find(s->ks_name());
+            if (it == keyspaces.end()) {
+                auto dk = make_partition_key(s->ks_name());
+                if (!this_shard_owns(dk) || !contains_key(qr.partition_range(), dk)) {
+                    continue;
+                }
+                it = keyspaces.emplace(s->ks_name(), keyspace_usage{std::move(dk), {}}).first;
+            }
+            it->second.tables.emplace(s->cf_name(), table_usage);
+        }
+
+        std::vector<keyspace_usage*> sorted_keyspaces;
+        for (auto& [_, ks] : keyspaces) {
+            sorted_keyspaces.push_back(&ks);
+        }
+        boost::sort(sorted_keyspaces, [less = dht::ring_position_less_comparator(*_s)] (const keyspace_usage* l, const keyspace_usage* r) {
+            return less(l->key, r->key);
+        });
+
+        for (auto* ks : sorted_keyspaces) {
+            co_await result.emit_partition_start(ks->key);
+            for (const auto& [table_name, table_usage] : ks->tables) {
+                clustering_row cr(make_clustering_key(table_name));
+                set_cell(cr.cells(), "reads", int64_t(table_usage.reads));
+                set_cell(cr.cells(), "cpu_time_us", int64_t(table_usage.usage.cpu_time.count()));
+                set_cell(cr.cells(), "disk_reads", int64_t(table_usage.usage.disk_reads));
+                set_cell(cr.cells(), "disk_bytes_read", int64_t(table_usage.usage.disk_bytes_read));
+                co_await result.emit_row(std::move(cr));
+            }
+            co_await result.emit_partition_end();
+        }
+    }
+};
+
 class protocol_servers_table : public memtable_filling_virtual_table {
 private:
     service::storage_service& _ss;
@@ -2530,6 +2624,7 @@ class clients_table : public streaming_virtual_table {
             .with_column("ssl_enabled", boolean_type)
             .with_column("ssl_protocol", utf8_type)
             .with_column("username", utf8_type)
+            .with_column("cross_shard_requests", long_type)
             .with_version(system_keyspace::generate_schema_version(id))
             .build();
     }
@@ -2636,6 +2731,9 @@ class clients_table : public streaming_virtual_table {
                     set_cell(cr.cells(), "ssl_protocol", *cd.ssl_protocol);
                 }
                 set_cell(cr.cells(), "username", cd.username ? *cd.username : sstring("anonymous"));
+                if (cd.cross_shard_requests) {
+                    set_cell(cr.cells(), "cross_shard_requests", *cd.cross_shard_requests);
+                }
                 co_await result.emit_row(std::move(cr));
             }
             co_await result.emit_partition_end();
@@ -2780,6 +2878,7 @@ void register_virtual_tables(distributed<replica::database>& dist_db, distribute
     add_table(std::make_unique<cluster_status_table>(ss, gossiper));
     add_table(std::make_unique<token_ring_table>(db, ss));
     add_table(std::make_unique<snapshots_table>(dist_db));
+    add_table(std::make_unique<reads_resource_usage_table>(dist_db));
     add_table(std::make_unique<protocol_servers_table>(ss));
     add_table(std::make_unique<runtime_info_table>(dist_db, ss));
     add_table(std::make_unique<versions_table>());
@@ -15,6 +15,52 @@ row_locker::row_locker(schema_ptr s)
     : _schema(s)
     , _two_level_locks(1, decorated_key_hash(), decorated_key_equals_comparator(this))
 {
+    _free_partition_locks.reserve(max_free_lock_entries);
+    _free_row_locks.reserve(max_free_lock_entries);
+}
+
+row_locker::two_level_locks_type::iterator row_locker::get_partition_lock(const dht::decorated_key& pk) {
+    auto i = _two_level_locks.find(pk);
+    if (i != _two_level_locks.end()) {
+        return i;
+    }
+    if (_free_partition_locks.empty()) {
+        return _two_level_locks.try_emplace(pk, this).first;
+    }
+    auto nh = std::move(_free_partition_locks.back());
+    _free_partition_locks.pop_back();
+    nh.key() = pk;
+    return _two_level_locks.insert(std::move(nh)).position;
+}
+
+row_locker::two_level_lock::row_locks_type::iterator row_locker::get_row_lock(two_level_lock& partition, const clustering_key_prefix& cpk) {
+    auto i = partition._row_locks.find(cpk);
+    if (i != partition._row_locks.end()) {
+        return i;
+    }
+    if (_free_row_locks.empty()) {
+        return partition._row_locks.try_emplace(cpk).first;
+    }
+    auto nh = std::move(_free_row_locks.back());
+    _free_row_locks.pop_back();
+    nh.key() = cpk;
+    return partition._row_locks.insert(std::move(nh)).position;
+}
+
+void row_locker::erase_partition_lock(two_level_locks_type::iterator i) noexcept {
+    if (_free_partition_locks.size() < max_free_lock_entries) {
+        _free_partition_locks.push_back(_two_level_locks.extract(i));
+    } else {
+        _two_level_locks.erase(i);
+    }
+}
+
+void row_locker::erase_row_lock(two_level_lock& partition, two_level_lock::row_locks_type::iterator i) noexcept {
+    if (_free_row_locks.size() < max_free_lock_entries) {
+        _free_row_locks.push_back(partition._row_locks.extract(i));
+    } else {
+        partition._row_locks.erase(i);
+    }
 }
 
 void row_locker::upgrade(schema_ptr new_schema) {
@@ -70,7 +116,12 @@ future<row_locker::lock_holder>
 row_locker::lock_pk(const dht::decorated_key& pk, bool exclusive, db::timeout_clock::time_point timeout, stats& stats) {
     mylog.debug("taking {} lock on entire partition {}", (exclusive ? "exclusive" : "shared"), pk);
     auto tracker = latency_stats_tracker(exclusive ? stats.exclusive_partition : stats.shared_partition);
-    auto i = _two_level_locks.try_emplace(pk, this).first;
+    auto i = get_partition_lock(pk);
+    // Uncontended locks are taken without waiting for a future.
+    if (exclusive ? i->second._partition_lock.try_write_lock() : i->second._partition_lock.try_read_lock()) {
+        tracker.lock_acquired();
+        return make_ready_future<lock_holder>(lock_holder(this, &i->first, exclusive));
+    }
     auto f = exclusive ? i->second._partition_lock.write_lock(timeout) : i->second._partition_lock.read_lock(timeout);
     // Note: we rely on the fact that &i->first, the pointer to a key, never
     // becomes invalid (as long as the item is actually in the hash table),
@@ -85,17 +136,34 @@ future<row_locker::lock_holder>
 row_locker::lock_ck(const dht::decorated_key& pk, const clustering_key_prefix& cpk, bool exclusive, db::timeout_clock::time_point timeout, stats& stats) {
     mylog.debug("taking shared lock on partition {}, and {} lock on row {} in it", pk, (exclusive ? "exclusive" : "shared"), cpk);
     auto tracker = latency_stats_tracker(exclusive ? stats.exclusive_row : stats.shared_row);
-    auto ck = cpk;
     // Create a two-level lock entry for the partition if it doesn't exist already.
-    auto i = _two_level_locks.try_emplace(pk, this).first;
+    auto i = get_partition_lock(pk);
+    // Uncontended locks are taken without waiting for a future.
+    if (i->second._partition_lock.try_read_lock()) {
+        auto j = i->second._row_locks.end();
+        try {
+            j = get_row_lock(i->second, cpk);
+        } catch (...) {
+            unlock(&i->first, false, nullptr, false);
+            throw;
+        }
+        if (exclusive ? j->second.try_write_lock() : j->second.try_read_lock()) {
+            tracker.lock_acquired();
+            return make_ready_future<lock_holder>(lock_holder(this, &i->first, &j->first, exclusive));
+        }
+        // The row is locked, so is its partition, which keeps the entries
+        // alive while we wait below.
+        i->second._partition_lock.read_unlock();
+    }
+    auto ck = cpk;
     // The two-level lock entry we've just created is guaranteed to be kept alive as long as it's locked.
     // Initiating read locking in the background below ensures that even if the two-level lock is currently
     // write-locked, releasing the write-lock will synchronously engage any waiting
     // locks and will keep the entry alive.
     future<lock_type::holder> lock_partition = i->second._partition_lock.hold_read_lock(timeout);
-    return lock_partition.then([this, pk = &i->first, row_locks = &i->second._row_locks, ck = std::move(ck), exclusive, tracker = std::move(tracker), timeout] (auto lock1) mutable {
+    return lock_partition.then([this, pk = &i->first, partition = &i->second, ck = std::move(ck), exclusive, tracker = std::move(tracker), timeout] (auto lock1) mutable {
         // Create a row_lock entry if it doesn't exist already.
-        auto j = row_locks->try_emplace(std::move(ck), lock_type()).first;
+        auto j = get_row_lock(*partition, ck);
         auto* cpk = &j->first;
         auto& row_lock = j->second;
         // Like to the two-level lock entry above, the row_lock entry we've just created
@@ -169,7 +237,7 @@ row_locker::unlock(const dht::decorated_key* pk, bool partition_exclusive,
             }
             if (!lock.locked()) {
                 mylog.debug("Erasing lock object for row {} in partition {}", *cpk, *pk);
-                pli->second._row_locks.erase(rli);
+                erase_row_lock(pli->second, rli);
             }
         }
         mylog.debug("releasing {} lock for entire partition {}", (partition_exclusive ? "exclusive" : "shared"), *pk);
@@ -181,7 +249,7 @@ row_locker::unlock(const dht::decorated_key* pk, bool partition_exclusive,
         }
         if (!lock.locked()) {
             mylog.debug("Erasing lock object for partition {}", *pk);
-            _two_level_locks.erase(pli);
+            erase_partition_lock(pli);
         }
      }
 }
@@ -25,6 +25,7 @@
 
 #include <seastar/core/future-util.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 
 #include "replica/database.hh"
@@ -263,6 +264,8 @@ void stats::register_stats() {
                     {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_failed_remote", view_updates_failed_remote, ms::description("Number of updates (mutations) that failed to be pushed to remote view replicas"),
                     {_cf_label, _ks_label}),
+            ms::make_total_operations("view_updates_hinted", view_updates_hinted, ms::description("Number of updates (mutations) for remote view replicas with a large backlog written to the hints for views instead of being sent"),
+                    {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_pushed_local", view_updates_pushed_local, ms::description("Number of updates (mutations) pushed to local view replicas"),
                     {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_failed_local", view_updates_failed_local, ms::description("Number of updates (mutations) that failed to be pushed to local view replicas"),
@@ -329,13 +332,42 @@ bool may_be_affected_by(const schema& base, const view_info& view, const dht::de
     return clustering_prefix_matches(base, view, key.key(), update.key());
 }
 
+bool may_be_changed_by(const schema& base, const view_and_base& view, const deletable_row& update) {
+    // The liveness of the entries of a view with a regular base column in
+    // its key is that of the column, so an update which touches no column of
+    // the view and none the view filters on can't change the view entry of
+    // the row, whatever the row was before it.
+    //
+    // When the view key is made of base key columns only, every base column
+    // keeps the view entry alive, those not selected through virtual columns,
+    // so any update may change the view.
+    const view_info& vf = *view.view->view_info();
+    if (!view.base->has_base_non_pk_columns_in_view_pk || vf.has_computed_column_depending_on_base_non_primary_key()) {
+        return true;
+    }
+    if (update.deleted_at()) {
+        return true;
+    }
+    const auto& filtered_columns = vf.select_statement().get_restrictions()->get_non_pk_restriction();
+    bool changed = false;
+    update.cells().for_each_cell_until([&] (column_id id, const atomic_cell_or_collection&) {
+        const column_definition& cdef = base.regular_column_at(id);
+        changed = view.view->get_column_definition(cdef.name())
+                || boost::algorithm::any_of(filtered_columns | boost::adaptors::map_keys, [&cdef] (const column_definition* filtered) {
+                    return filtered->name() == cdef.name();
+                });
+        return stop_iteration(changed);
+    });
+    return changed;
+}
+
 static bool update_requires_read_before_write(const schema& base,
         const std::vector<view_and_base>& views,
         const dht::decorated_key& key,
         const rows_entry& update) {
     for (auto&& v : views) {
         view_info& vf = *v.view->view_info();
-        if (may_be_affected_by(base, vf, key, update)) {
+        if (may_be_affected_by(base, vf, key, update) && may_be_changed_by(base, v, update.row())) {
             return true;
         }
     }
@@ -1600,6 +1632,47 @@ static future<> apply_to_remote_endpoints(gms::inet_address target, inet_address
             allow_hints);
 }
 
+// Writes the update to the hints for views, instead of sending it, for the
+// targets with a view update backlog above view_update_hint_backlog_threshold,
+// and removes those it was written for from the targets.
+//
+// A slow view replica holds the memory of the updates sent to it until it
+// acknowledges them, growing the backlog of this node, which in turn delays
+// the base writes. Hints are written to disk and delivered in the background,
+// in batches merged per partition, so the base writes don't wait on the
+// replica, only the view lags behind.
+static void hint_to_slow_endpoints(std::optional<gms::inet_address>& target, inet_address_vector_topology_change& pending_endpoints,
+        const frozen_mutation_and_schema& mut, db::view::stats& stats, tracing::trace_state_ptr tr_state) {
+    auto& proxy = service::get_local_storage_proxy();
+    auto threshold = proxy.local_db().get_config().view_update_hint_backlog_threshold();
+    if (threshold <= 0) {
+        return;
+    }
+    auto is_slow = [&proxy, threshold] (gms::inet_address ep) {
+        return proxy.get_backlog_of(ep).relative_size() >= threshold;
+    };
+    inet_address_vector_topology_change slow_endpoints;
+    if (target && is_slow(*target)) {
+        slow_endpoints.push_back(*target);
+    }
+    boost::copy(pending_endpoints | boost::adaptors::filtered(is_slow), std::back_inserter(slow_endpoints));
+    if (slow_endpoints.empty()) {
+        return;
+    }
+    auto not_hinted = proxy.hint_view_update(mut, slow_endpoints, tr_state);
+    auto was_hinted = [&] (gms::inet_address ep) {
+        return std::find(slow_endpoints.begin(), slow_endpoints.end(), ep) != slow_endpoints.end()
+                && std::find(not_hinted.begin(), not_hinted.end(), ep) == not_hinted.end();
+    };
+    stats.view_updates_hinted += slow_endpoints.size() - not_hinted.size();
+    tracing::trace(tr_state, "Wrote view update for {}.{} to hints for {} of the {} view replicas with a large backlog",
+            mut.s->ks_name(), mut.s->cf_name(), slow_endpoints.size() - not_hinted.size(), slow_endpoints.size());
+    std::erase_if(pending_endpoints, was_hinted);
+    if (target && was_hinted(*target)) {
+        target.reset();
+    }
+}
+
 static bool should_update_synchronously(const schema& s) {
     auto tag_opt = db::find_tag(s, db::SYNCHRONOUS_VIEW_UPDATES_TAG_KEY);
     if (!tag_opt.has_value()) {
@@ -1697,6 +1770,10 @@ future<> mutate_MV(
             target_endpoint.reset();
         }
 
+        if (!apply_update_synchronously) {
+            hint_to_slow_endpoints(target_endpoint, remote_endpoints, mut, stats, tr_state);
+        }
+
         // If target endpoint is not engaged, but there are remote endpoints,
         // one of the remote endpoints should become a primary target
         if (!target_endpoint && !remote_endpoints.empty()) {
@@ -2197,7 +2274,11 @@ void view_builder::on_drop_view(const sstring& ks_name, const sstring& view_name
 }
 
 future<> view_builder::do_build_step() {
-    return seastar::async([this] {
+    // Building views is background work, like streaming, so it gets the
+    // share of the maintenance scheduling group.
+    thread_attributes attr;
+    attr.sched_group = _db.get_streaming_scheduling_group();
+    return seastar::async(std::move(attr), [this] {
         exponential_backoff_retry r(1s, 1min);
         while (!_base_to_build_step.empty() && !_as.abort_requested()) {
             auto units = get_units(_sem, 1).get0();
@@ -2232,6 +2313,36 @@ future<> view_builder::do_build_step() {
     });
 }
 
+// The view updates of the partitions read by a build step are generated and
+// propagated concurrently, so that the step doesn't wait on a round trip to
+// the view replicas for each of them. Their memory is bounded by the view
+// update concurrency semaphore, as for any view update.
+struct view_builder::concurrent_flushes {
+    semaphore sem;
+    gate pending;
+    // The first failure, which fails the whole step.
+    std::exception_ptr ex;
+
+    explicit concurrent_flushes(size_t concurrency)
+            : sem(std::max<size_t>(concurrency, 1)) {
+    }
+
+    future<> populate_views(lw_shared_ptr<replica::column_family> base, std::vector<view_and_base> views, dht::token token,
+            flat_mutation_reader_v2 reader, gc_clock::time_point now, semaphore_units<> units) {
+        auto holder = pending.hold();
+        std::exception_ptr f_ex;
+        try {
+            co_await base->populate_views(std::move(views), token, std::move(reader), now);
+        } catch (...) {
+            f_ex = std::current_exception();
+        }
+        co_await reader.close();
+        if (f_ex && !ex) {
+            ex = std::move(f_ex);
+        }
+    }
+};
+
 // Called in the context of a seastar::thread.
 class view_builder::consumer {
 public:
@@ -2263,6 +2374,7 @@ class view_builder::consumer {
 private:
     view_builder& _builder;
     build_step& _step;
+    concurrent_flushes& _flushes;
     built_views _built_views;
     gc_clock::time_point _now;
     std::vector<view_ptr> _views_to_build;
@@ -2278,9 +2390,10 @@ class view_builder::consumer {
     // beyond our limit on mutation size (by default 32 MB).
     size_t _fragments_memory_usage = 0;
 public:
-    consumer(view_builder& builder, build_step& step, gc_clock::time_point now)
+    consumer(view_builder& builder, build_step& step, concurrent_flushes& flushes, gc_clock::time_point now)
             : _builder(builder)
             , _step(step)
+            , _flushes(flushes)
             , _built_views{step}
             , _now(now) {
         if (!step.current_key.key().is_empty(*_step.reader.schema())) {
@@ -2379,20 +2492,19 @@ class view_builder::consumer {
         inject_failure("view_builder_flush_fragments");
         _builder._as.check();
         if (!_fragments.empty()) {
+            auto units = get_units(_flushes.sem, 1).get0();
+            if (_flushes.ex) {
+                std::rethrow_exception(_flushes.ex);
+            }
             _fragments.emplace_front(*_step.reader.schema(), _builder._permit, partition_start(_step.current_key, tombstone()));
             auto base_schema = _step.base->schema();
             auto views = with_base_info_snapshot(_views_to_build);
             auto reader = make_flat_mutation_reader_from_fragments(_step.reader.schema(), _builder._permit, std::move(_fragments));
-            auto close_reader = defer([&reader] { reader.close().get(); });
             reader.upgrade_schema(base_schema);
-            _step.base->populate_views(
-                    std::move(views),
-                    _step.current_token(),
-                    std::move(reader),
-                    _now).get();
-            close_reader.cancel();
             _fragments.clear();
             _fragments_memory_usage = 0;
+            // The flush may outlive the consumer, but not the build step, which waits for it.
+            (void)_flushes.populate_views(_step.base, std::move(views), _step.current_token(), std::move(reader), _now, std::move(units));
         }
     }
 
@@ -2434,8 +2546,32 @@ void view_builder::execute(build_step& step, exponential_backoff_retry r) {
             step.pslice,
             batch_size,
             query::max_partitions);
-    auto consumer = compact_for_query_v2<view_builder::consumer>(compaction_state, view_builder::consumer{*this, step, now});
-    auto built = step.reader.consume_in_thread(std::move(consumer));
+    // If one of the concurrent flushes fails, the partitions of the step which
+    // were read after it needn't have failed, so the step is restarted from
+    // where it began. Rebuilding the view rows of a partition is idempotent.
+    auto start_key = step.current_key;
+    auto start_build_status = step.build_status;
+    concurrent_flushes flushes(_db.get_config().view_building_concurrency());
+    std::optional<consumer::built_views> built;
+    std::exception_ptr ex;
+    try {
+        auto consumer = compact_for_query_v2<view_builder::consumer>(compaction_state, view_builder::consumer{*this, step, flushes, now});
+        built.emplace(step.reader.consume_in_thread(std::move(consumer)));
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    flushes.pending.close().get();
+    if (flushes.ex) {
+        if (built) {
+            built->release();
+        }
+        step.current_key = std::move(start_key);
+        step.build_status = std::move(start_build_status);
+        std::rethrow_exception(ex ? ex : flushes.ex);
+    }
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
     if (auto ds = std::move(*compaction_state).detach_state()) {
         if (ds->current_tombstone) {
             step.reader.unpop_mutation_fragment(mutation_fragment_v2(*step.reader.schema(), step.reader.permit(), std::move(*ds->current_tombstone)));
@@ -2446,11 +2582,11 @@ void view_builder::execute(build_step& step, exponential_backoff_retry r) {
     _as.check();
 
     std::vector<future<>> bookkeeping_ops;
-    bookkeeping_ops.reserve(built.views.size() + step.build_status.size());
-    for (auto& [view, first_token, _] : built.views) {
+    bookkeeping_ops.reserve(built->views.size() + step.build_status.size());
+    for (auto& [view, first_token, _] : built->views) {
         bookkeeping_ops.push_back(maybe_mark_view_as_built(view, first_token));
     }
-    built.release();
+    built->release();
     for (auto& [view, _, next_token] : step.build_status) {
         if (next_token) {
             bookkeeping_ops.push_back(
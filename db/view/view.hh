@@ -146,6 +146,20 @@ bool partition_key_matches(const schema& base, const view_info& view, const dht:
  */
 bool may_be_affected_by(const schema& base, const view_info& view, const dht::decorated_key& key, const rows_entry& update);
 
+/**
+ * Whether the provided update of a base row may change the view entry of the row,
+ * whatever the row held before the update.
+ *
+ * A false return means the existing row needn't be read to compute the view updates
+ * for this row.
+ *
+ * @param base the base table schema.
+ * @param view the view and its base-dependent info.
+ * @param update the base table update being applied to the row.
+ * @return false if the update can't change the view entry of the row, true otherwise.
+ */
+bool may_be_changed_by(const schema& base, const view_and_base& view, const deletable_row& update);
+
 /**
  * Whether a given base row matches the view filter (and thus if the view should have a corresponding entry).
  *
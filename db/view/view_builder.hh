@@ -228,6 +228,7 @@ class view_builder final : public service::migration_listener::only_view_notific
     void setup_metrics();
 
     struct consumer;
+    struct concurrent_flushes;
 };
 
 }
@@ -14,6 +14,8 @@
 #include "readers/forwardable_v2.hh"
 #include "readers/slicing_filtering.hh"
 
+#include <algorithm>
+
 namespace db {
 
 void virtual_table::set_cell(row& cr, const bytes& column_name, data_value value) {
@@ -35,6 +37,16 @@ bool virtual_table::contains_key(const dht::partition_range& pr, const dht::deco
     return pr.contains(dk, dht::ring_position_comparator(*_s));
 }
 
+bool virtual_table::contains_row(const query_restrictions& qr, const dht::decorated_key& dk, const clustering_key_prefix& ck) const {
+    if (qr.slice().is_reversed()) {
+        return true;
+    }
+    clustering_key_prefix::prefix_equal_tri_compare cmp(*_s);
+    return std::ranges::any_of(qr.slice().row_ranges(*_s, dk.key()), [&] (const query::clustering_range& r) {
+        return r.contains(ck, cmp);
+    });
+}
+
 mutation_source memtable_filling_virtual_table::as_mutation_source() {
     return mutation_source([this] (schema_ptr s,
         reader_permit permit,
@@ -54,6 +66,24 @@ mutation_source memtable_filling_virtual_table::as_mutation_source() {
 
         auto units = make_lw_shared<my_units>(permit.consume_memory(0));
 
+        // Refers to the range and slice kept alive by populate below.
+        struct my_query_restrictions : public query_restrictions {
+            const dht::partition_range& _range;
+            const query::partition_slice& _slice;
+
+            my_query_restrictions(const dht::partition_range& range, const query::partition_slice& slice)
+                : _range(range)
+                , _slice(slice)
+            { }
+
+            const dht::partition_range& partition_range() const override {
+                return _range;
+            }
+            const query::partition_slice& slice() const override {
+                return _slice;
+            }
+        };
+
         auto populate = [this, mt = make_lw_shared<replica::memtable>(schema()), s, units, range, slice, pc, trace_state, fwd, fwd_mr] () mutable {
             auto mutation_sink = [units, mt] (mutation m) mutable {
                 mt->apply(m);
@@ -61,7 +91,9 @@ mutation_source memtable_filling_virtual_table::as_mutation_source() {
                 units->memory_used = mt->occupancy().used_space();
             };
 
-            return execute(mutation_sink).then([this, mt, s, units, &range, &slice, &pc, &trace_state, &fwd, &fwd_mr] () {
+            auto qr = std::make_unique<my_query_restrictions>(range, slice);
+            auto f = execute(mutation_sink, *qr);
+            return f.then([this, mt, s, units, qr = std::move(qr), &range, &slice, &pc, &trace_state, &fwd, &fwd_mr] () {
                 auto rd = mt->as_data_source().make_reader_v2(s, units->units.permit(), range, slice, pc, trace_state, fwd, fwd_mr);
 
                 if (!_shard_aware) {
@@ -108,12 +140,14 @@ mutation_source streaming_virtual_table::as_mutation_source() {
             // Valid until handle.is_terminated(), which is set to true when the
             // queue_reader dies.
             const dht::partition_range* pr;
+            const query::partition_slice* ps;
             mutation_reader::forwarding fwd_mr;
 
-            my_result_collector(schema_ptr s, reader_permit p, const dht::partition_range* pr, queue_reader_handle_v2&& handle)
+            my_result_collector(schema_ptr s, reader_permit p, const dht::partition_range* pr, const query::partition_slice* ps, queue_reader_handle_v2&& handle)
                 : result_collector(s, p)
                 , handle(std::move(handle))
                 , pr(pr)
+                , ps(ps)
             { }
 
             // result_collector
@@ -128,10 +162,16 @@ mutation_source streaming_virtual_table::as_mutation_source() {
                 }
                 return *pr;
             }
+            const query::partition_slice& slice() const override {
+                if (handle.is_terminated()) {
+                    throw std::runtime_error("read abandoned");
+                }
+                return *ps;
+            }
         };
 
         auto reader_and_handle = make_queue_reader_v2(s, permit);
-        auto consumer = std::make_unique<my_result_collector>(s, permit, &pr, std::move(reader_and_handle.second));
+        auto consumer = std::make_unique<my_result_collector>(s, permit, &pr, &query_slice, std::move(reader_and_handle.second));
         auto f = execute(permit, *consumer, *consumer);
 
         // It is safe to discard this future because:
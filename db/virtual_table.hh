@@ -10,6 +10,7 @@
 
 #include "readers/filtering.hh"
 #include "replica/memtable.hh"
+#include "query-request.hh"
 #include "schema.hh"
 #include "replica/database_fwd.hh"
 
@@ -35,8 +36,16 @@ class virtual_table {
     class query_restrictions {
     public:
         virtual const dht::partition_range& partition_range() const = 0;
+        // As passed to the mutation source, so reversed for reversed queries.
+        virtual const query::partition_slice& slice() const = 0;
     };
 
+protected:
+    // Whether the row is selected by the clustering restrictions of the query.
+    // Always true for reversed queries.
+    bool contains_row(const query_restrictions&, const dht::decorated_key&, const clustering_key_prefix&) const;
+
+public:
     explicit virtual_table(schema_ptr s) : _s(std::move(s)) {}
     virtual ~virtual_table() = default;
 
@@ -56,6 +65,7 @@ class memtable_filling_virtual_table : public virtual_table {
 
     // Override one of these execute() overloads.
     // The handler is always allowed to produce more data than implied by the query_restrictions.
+    // Skipping the partitions and rows the query doesn't select saves filling the memtable with them.
     virtual future<> execute(std::function<void(mutation)> mutation_sink) { return make_ready_future<>(); }
     virtual future<> execute(std::function<void(mutation)> mutation_sink, const query_restrictions&) { return execute(mutation_sink); }
 
@@ -100,7 +110,9 @@ class result_collector {
 //
 //  - avoid emitting partitions for which this_shard_owns() returns false.
 //
-//  - avoid emitting partitions which fall outside result_collector::partition_range().
+//  - avoid emitting partitions which fall outside query_restrictions::partition_range().
+//
+//  - avoid emitting rows for which contains_row() returns false.
 //
 class streaming_virtual_table : public virtual_table {
 public:
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "db/write_path_profiler.hh"
+
+namespace db {
+
+std::string_view to_string(write_stage stage) {
+    switch (stage) {
+    case write_stage::cdc_augmentation: return "cdc_augmentation";
+    case write_stage::replication: return "replication";
+    case write_stage::view_updates: return "view_updates";
+    case write_stage::commitlog: return "commitlog";
+    case write_stage::memtable: return "memtable";
+    }
+    abort();
+}
+
+write_path_profiler::write_path_profiler(utils::updateable_value<uint32_t> sampling_period)
+        : _sampling_period(std::move(sampling_period)) {
+}
+
+void write_path_profiler::record(write_stage stage, clock::duration d) {
+    _histograms[size_t(stage)].add(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string_view>
+
+#include "utils/estimated_histogram.hh"
+#include "utils/updateable_value.hh"
+
+namespace db {
+
+// The stages of the write path which are timed by write_path_profiler.
+// The first two are timed on the coordinator, by storage_proxy, and the
+// others on the replica, by replica::database.
+enum class write_stage {
+    cdc_augmentation,
+    // From sending the mutations to the replicas until the consistency
+    // level is reached.
+    replication,
+    view_updates,
+    commitlog,
+    // Includes waiting for dirty memory and LSA reclamation.
+    memtable,
+};
+
+constexpr size_t write_stage_count = size_t(write_stage::memtable) + 1;
+
+std::string_view to_string(write_stage stage);
+
+// Times the stages of one of every sampling_period writes of the shard, and
+// aggregates the timings of each stage into a histogram, in microseconds.
+// The writes which are not sampled only pay for incrementing a counter.
+class write_path_profiler {
+public:
+    using clock = std::chrono::steady_clock;
+    using histograms = std::array<utils::estimated_histogram, write_stage_count>;
+
+    // Times the stages of a single write. Each stage takes the time since
+    // the end of the previous one, or since the timer was started. A timer
+    // of a write which is not sampled records nothing.
+    class timer {
+        write_path_profiler* _profiler = nullptr;
+        clock::time_point _last;
+    public:
+        timer() = default;
+        explicit timer(write_path_profiler& profiler) : _profiler(&profiler), _last(clock::now()) {}
+
+        explicit operator bool() const {
+            return _profiler;
+        }
+
+        void end_stage(write_stage stage) {
+            if (_profiler) {
+                auto now = clock::now();
+                _profiler->record(stage, now - _last);
+                _last = now;
+            }
+        }
+
+        // Restarts timing without recording, so that the time since the
+        // previous stage is not attributed to the next one.
+        void skip() {
+            if (_profiler) {
+                _last = clock::now();
+            }
+        }
+    };
+private:
+    utils::updateable_value<uint32_t> _sampling_period;
+    uint64_t _writes = 0;
+    histograms _histograms;
+public:
+    explicit write_path_profiler(utils::updateable_value<uint32_t> sampling_period);
+
+    timer sample() {
+        auto period = _sampling_period();
+        if (!period || ++_writes % period) {
+            return timer();
+        }
+        return timer(*this);
+    }
+
+    void record(write_stage stage, clock::duration d);
+
+    const histograms& get_histograms() const {
+        return _histograms;
+    }
+};
+
+}
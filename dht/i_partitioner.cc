@@ -159,6 +159,12 @@ std::ostream& operator<<(std::ostream& out, ring_position_view pos) {
     return out << "}";
 }
 
+void i_partitioner::get_tokens(const schema& s, std::span<const partition_key_view> keys, std::span<token> tokens) const {
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tokens[i] = get_token(s, keys[i]);
+    }
+}
+
 std::ostream& operator<<(std::ostream& out, const i_partitioner& p) {
     out << "{partitioner name = " << p.name();
     return out << "}";
@@ -16,6 +16,7 @@
 #include "keys.hh"
 #include "utils/managed_bytes.hh"
 #include <memory>
+#include <span>
 #include <random>
 #include <utility>
 #include <vector>
@@ -149,6 +150,11 @@ class i_partitioner {
     virtual token get_token(const schema& s, partition_key_view key) const = 0;
     virtual token get_token(const sstables::key_view& key) const = 0;
 
+    // Computes the token of each of the keys into the corresponding element
+    // of tokens, which must be at least as long. Partitioners which can
+    // compute many tokens faster than one by one override it.
+    virtual void get_tokens(const schema& s, std::span<const partition_key_view> keys, std::span<token> tokens) const;
+
     // FIXME: token.tokenFactory
     //virtual token.tokenFactory gettokenFactory() = 0;
 
@@ -637,6 +643,10 @@ inline token get_token(const schema& s, partition_key_view key) {
     return s.get_partitioner().get_token(s, key);
 }
 
+inline void get_tokens(const schema& s, std::span<const partition_key_view> keys, std::span<token> tokens) {
+    s.get_partitioner().get_tokens(s, keys, tokens);
+}
+
 dht::partition_range to_partition_range(dht::token_range);
 dht::partition_range_vector to_partition_ranges(const dht::token_range_vector& ranges, utils::can_yield can_yield = utils::can_yield::no);
 
@@ -44,14 +44,59 @@ murmur3_partitioner::get_token(const sstables::key_view& key) const {
     });
 }
 
+std::optional<bytes_view>
+murmur3_partitioner::contiguous_legacy_form(const schema& s, partition_key_view key) {
+    if (!s.partition_key_type()->is_singular()) {
+        return std::nullopt;
+    }
+    managed_bytes_view component = *key.begin();
+    if (component.current_fragment().size() != component.size_bytes()) {
+        return std::nullopt;
+    }
+    return component.current_fragment();
+}
+
 token
 murmur3_partitioner::get_token(const schema& s, partition_key_view key) const {
+    if (auto v = contiguous_legacy_form(s, key)) {
+        return get_token(*v);
+    }
     std::array<uint64_t, 2> hash;
     auto&& legacy = key.legacy_form(s);
     utils::murmur_hash::hash3_x64_128(legacy.begin(), legacy.size(), 0, hash);
     return get_token(hash[0]);
 }
 
+void
+murmur3_partitioner::get_tokens(const schema& s, std::span<const partition_key_view> keys, std::span<token> tokens) const {
+    constexpr size_t batch_size = 64;
+    std::array<bytes_view, batch_size> views;
+    std::array<size_t, batch_size> indexes;
+    std::array<std::array<uint64_t, 2>, batch_size> hashes;
+
+    size_t n = 0;
+    auto flush = [&] {
+        utils::murmur_hash::hash3_x64_128(std::span<const bytes_view>(views.data(), n), 0, hashes);
+        for (size_t j = 0; j < n; ++j) {
+            tokens[indexes[j]] = get_token(hashes[j][0]);
+        }
+        n = 0;
+    };
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto v = contiguous_legacy_form(s, keys[i]);
+        if (!v) {
+            tokens[i] = get_token(s, keys[i]);
+            continue;
+        }
+        views[n] = *v;
+        indexes[n] = i;
+        if (++n == batch_size) {
+            flush();
+        }
+    }
+    flush();
+}
+
 using registry = class_registrator<i_partitioner, murmur3_partitioner>;
 static registry registrator("org.apache.cassandra.dht.Murmur3Partitioner");
 static registry registrator_short_name("Murmur3Partitioner");
@@ -10,6 +10,7 @@
 
 #include "i_partitioner.hh"
 #include "bytes.hh"
+#include <optional>
 #include <vector>
 
 namespace dht {
@@ -20,7 +21,12 @@ class murmur3_partitioner final : public i_partitioner {
     virtual const sstring name() const override { return "org.apache.cassandra.dht.Murmur3Partitioner"; }
     virtual token get_token(const schema& s, partition_key_view key) const override;
     virtual token get_token(const sstables::key_view& key) const override;
+    virtual void get_tokens(const schema& s, std::span<const partition_key_view> keys, std::span<token> tokens) const override;
 private:
+    // The legacy form of a key of a single column is the column's value, so
+    // when that is contiguous it can be hashed directly rather than through
+    // the legacy_compound_view iterator.
+    static std::optional<bytes_view> contiguous_legacy_form(const schema& s, partition_key_view key);
     token get_token(bytes_view key) const;
     token get_token(uint64_t value) const;
 };
@@ -23,7 +23,7 @@ struct noop_hasher {
 };
 
 class digester final {
-    std::variant<noop_hasher, md5_hasher, xx_hasher, legacy_xx_hasher_without_null_digest> _impl;
+    std::variant<noop_hasher, md5_hasher, xx_hasher, legacy_xx_hasher_without_null_digest, xxh3_hasher> _impl;
 
 public:
     explicit digester(digest_algorithm algo) {
@@ -34,6 +34,9 @@ class digester final {
         case digest_algorithm::xxHash:
             _impl = xx_hasher();
             break;
+        case digest_algorithm::xxHash3:
+            _impl = xxh3_hasher();
+            break;
         case digest_algorithm::legacy_xxHash_without_null_digest:
             _impl = legacy_xx_hasher_without_null_digest();
             break;
@@ -66,4 +69,9 @@ using using_hash_of_hash = std::negation<std::disjunction<std::is_same<Hasher, m
 template<typename Hasher>
 inline constexpr bool using_hash_of_hash_v = using_hash_of_hash<Hasher>::value;
 
+// The hashes of cells are cached in rows, computed with default_hasher,
+// so digests which use hash of hash must compute the missing ones with it too.
+template<typename Hasher>
+using cell_hasher = std::conditional_t<std::is_same_v<Hasher, xxh3_hasher>, default_hasher, Hasher>;
+
 }
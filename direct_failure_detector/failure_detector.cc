@@ -14,6 +14,7 @@
 #include <seastar/core/sleep.hh>
 #include <seastar/core/on_internal_error.hh>
 #include <seastar/core/condition-variable.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/util/defer.hh>
 
@@ -25,6 +26,11 @@ namespace direct_failure_detector {
 
 static logging::logger logger("direct_failure_detector");
 
+// After `failure_detector::suspect()`, the next `fast_ping_count` pings of the endpoint
+// are sent every `ping_period / fast_ping_divisor`.
+static constexpr unsigned fast_ping_count = 20;
+static constexpr clock::interval_t fast_ping_divisor = 4;
+
 // Each registered listener has a unique address, so we can use it to uniquely identify the listener.
 using listener_id = listener*;
 
@@ -66,6 +72,15 @@ struct endpoint_worker {
     // or the failure detector service is stopped.
     abort_source _as;
 
+    // After `suspect()`, the number of pings which are still sent `fast_ping_divisor` times as often.
+    unsigned _fast_pings_left = 0;
+
+    // Aborts the sleep of `ping_fiber()` between pings, when `suspect()` wants the next ping to start right away.
+    abort_source* _sleep_as = nullptr;
+
+    // Start pinging more often, starting now.
+    void suspect() noexcept;
+
     // When `ping_fiber()` changes the liveness state of an endpoint (`endpoint_liveness::alive`), it signals
     // this condition variable. `notify_fiber()` sleeps on it; on wake up sends a notification and marks
     // that it sent the update (`endpoint_liveness:marked_alive`)
@@ -134,6 +149,9 @@ struct failure_detector::impl {
     // The listeners registered on this shard.
     std::unordered_set<listener*> _registered;
 
+    // Holds the `suspect()` calls made on this shard, which run in the background.
+    seastar::gate _suspect_gate;
+
     // Listeners are unregistered by destroying their `subscription` objects.
     // The unregistering process requires cross-shard operations which we perform on this fiber.
     future<> _destroy_subscriptions = make_ready_future<>();
@@ -466,6 +484,38 @@ void failure_detector::remove_endpoint(pinger::endpoint_id ep) {
     }
 }
 
+void failure_detector::suspect(pinger::endpoint_id ep) {
+    if (!_impl || _impl->_suspect_gate.is_closed()) {
+        return;
+    }
+
+    // Shard 0 knows which shard pings the endpoint.
+    (void)with_gate(_impl->_suspect_gate, [this, ep] {
+        return container().invoke_on(0, [ep] (failure_detector& fd) -> future<> {
+            auto it = fd._impl->_workers.find(ep);
+            if (it == fd._impl->_workers.end()) {
+                co_return;
+            }
+            co_await fd.container().invoke_on(it->second, [ep] (failure_detector& fd) {
+                auto it = fd._impl->_shard_workers.find(ep);
+                if (it != fd._impl->_shard_workers.end()) {
+                    it->second.suspect();
+                }
+            });
+        });
+    }).handle_exception([ep] (std::exception_ptr e) {
+        logger.warn("failed to suspect endpoint {}: {}", ep, e);
+    });
+}
+
+void endpoint_worker::suspect() noexcept {
+    logger.debug("endpoint {} is suspected, pinging it more often", _id);
+    _fast_pings_left = fast_ping_count;
+    if (_sleep_as && !_sleep_as->abort_requested()) {
+        _sleep_as->request_abort();
+    }
+}
+
 // Performs `pinger.ping(...)` but aborts it if `timeout` is reached first or externally aborted (by `as`).
 static future<bool> ping_with_timeout(pinger::endpoint_id id, clock::timepoint_t timeout, abort_source& as, pinger& pinger, clock& c) {
     abort_source timeout_as;
@@ -529,6 +579,10 @@ future<> endpoint_worker::ping_fiber() noexcept {
         bool success = false;
         auto start = clock.now();
         auto next_ping_start = start + _fd._ping_period;
+        if (_fast_pings_left) {
+            --_fast_pings_left;
+            next_ping_start = start + std::max<clock::interval_t>(_fd._ping_period / fast_ping_divisor, 1);
+        }
 
         // A ping should take significantly less time than _ping_period, but we give it a multiple of ping_period before it times out
         // just in case of transient network partitions.
@@ -590,7 +644,26 @@ future<> endpoint_worker::ping_fiber() noexcept {
             _alive_changed.signal();
         }
 
-        co_await clock.sleep_until(next_ping_start, _as);
+        // The sleep is also aborted by `suspect()`, which wants the next ping to start right away.
+        abort_source sleep_as;
+        auto sub = _as.subscribe([&sleep_as] () noexcept {
+            if (!sleep_as.abort_requested()) {
+                sleep_as.request_abort();
+            }
+        });
+        if (!sub) {
+            // `_as` was already aborted.
+            sleep_as.request_abort();
+        }
+        _sleep_as = &sleep_as;
+        auto reset_sleep_as = defer([this] () noexcept { _sleep_as = nullptr; });
+        try {
+            co_await clock.sleep_until(next_ping_start, sleep_as);
+        } catch (sleep_aborted&) {
+            if (_as.abort_requested()) {
+                throw;
+            }
+        }
     }
 }
 
@@ -661,6 +734,11 @@ future<> failure_detector::stop() {
         co_return;
     }
 
+    // Wait for the `suspect()` calls in progress, they may refer to the workers.
+    co_await container().invoke_on_all([] (failure_detector& fd) {
+        return fd._impl->_suspect_gate.close();
+    });
+
     _impl->_endpoint_changed.broken(std::make_exception_ptr(abort_requested_exception{}));
     try {
         co_await std::exchange(_impl->_update_endpoint_fiber, make_ready_future<>());
@@ -691,6 +769,7 @@ future<> failure_detector::stop() {
 
 failure_detector::impl::~impl() {
     assert(_shard_workers.empty());
+    assert(_suspect_gate.is_closed());
     assert(_destroy_subscriptions.available());
     assert(_update_endpoint_fiber.available());
 }
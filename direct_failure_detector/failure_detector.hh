@@ -171,6 +171,14 @@ class failure_detector : public seastar::peering_sharded_service<failure_detecto
     // If the endpoint is considered alive when removed, a final mark_dead notification is sent to all listeners.
     // Run only on shard 0.
     void remove_endpoint(pinger::endpoint_id);
+
+    // Inform the failure detector that there are other signs of this endpoint failing,
+    // e.g. requests sent to it fail or time out.
+    // The endpoint is pinged right away, and then more often than every `ping_period` for a while,
+    // so listeners notice sooner if it's dead, with thresholds of only a few `ping_period`s.
+    // Has no effect if the endpoint is not in the detected set.
+    // Can be called on any shard.
+    void suspect(pinger::endpoint_id);
 };
 
 } // namespace direct_failure_detector
@@ -113,6 +113,26 @@ class feature_service final {
     gms::feature collection_indexing { *this, "COLLECTION_INDEXING"sv };
     gms::feature large_collection_detection { *this, "LARGE_COLLECTION_DETECTION"sv };
     gms::feature secondary_indexes_on_static_columns { *this, "SECONDARY_INDEXES_ON_STATIC_COLUMNS"sv };
+    // Replicas can serve the reads of many partitions in a single READ_DATA_MULTI RPC.
+    gms::feature batched_singular_reads { *this, "BATCHED_SINGULAR_READS"sv };
+    // Replicas accept many writes in a single MUTATION_MULTI RPC, and coordinators
+    // many acknowledgements in a single MUTATION_DONE_MULTI RPC.
+    gms::feature coalesced_mutation_rpcs { *this, "COALESCED_MUTATION_RPCS"sv };
+    // Nodes can run parallelized aggregation queries with GROUP BY.
+    gms::feature group_by_parallelized_aggregation { *this, "GROUP_BY_PARALLELIZED_AGGREGATION"sv };
+    gms::feature approximate_aggregates { *this, "APPROXIMATE_AGGREGATES"sv };
+    // Replicas can compute read digests with query::digest_algorithm::xxHash3.
+    gms::feature xxhash3_digest { *this, "XXHASH3_DIGEST"sv };
+    // Nodes accept the 'eviction_priority' caching option.
+    gms::feature cache_eviction_priority { *this, "CACHE_EVICTION_PRIORITY"sv };
+    // Nodes understand the digest summary of gossip_digest_syn messages.
+    gms::feature gossip_digest_summary { *this, "GOSSIP_DIGEST_SUMMARY"sv };
+    // Nodes accept whole sstables sent by streaming with STREAM_SSTABLE_FILES.
+    gms::feature file_based_streaming { *this, "FILE_BASED_STREAMING"sv };
+    // Nodes accept batches of hints in a single HINT_MUTATION_MULTI message.
+    gms::feature hint_mutation_multi { *this, "HINT_MUTATION_MULTI"sv };
+    // Nodes accept the 'blind_inserts' CDC option.
+    gms::feature cdc_blind_inserts { *this, "CDC_BLIND_INSERTS"sv };
 
 public:
 
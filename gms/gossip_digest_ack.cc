@@ -23,7 +23,15 @@ std::ostream& operator<<(std::ostream& os, const gossip_digest_ack& ack) {
     for (auto& d : ack._map) {
         os << "[" << d.first << "->" << d.second << "]";
     }
-    return os << "}";
+    os << "}";
+    if (!ack._mismatched_summary_buckets.empty()) {
+        os << " mismatched_summary_buckets:{";
+        for (auto b : ack._mismatched_summary_buckets) {
+            os << b << " ";
+        }
+        os << "}";
+    }
+    return os;
 }
 
 } // namespace gms
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <vector>
 #include "utils/serialization.hh"
 #include "gms/gossip_digest.hh"
 #include "gms/inet_address.hh"
@@ -27,13 +28,17 @@ class gossip_digest_ack {
     using inet_address = gms::inet_address;
     utils::chunked_vector<gossip_digest> _digests;
     std::map<inet_address, endpoint_state> _map;
+    // The buckets of the digest summary of the syn message which differ from
+    // those of the receiver, whose endpoints need full digests.
+    std::vector<uint32_t> _mismatched_summary_buckets;
 public:
     gossip_digest_ack() {
     }
 
-    gossip_digest_ack(utils::chunked_vector<gossip_digest> d, std::map<inet_address, endpoint_state> m)
+    gossip_digest_ack(utils::chunked_vector<gossip_digest> d, std::map<inet_address, endpoint_state> m, std::vector<uint32_t> mismatched_summary_buckets = {})
         : _digests(std::move(d))
-        , _map(std::move(m)) {
+        , _map(std::move(m))
+        , _mismatched_summary_buckets(std::move(mismatched_summary_buckets)) {
     }
 
     const utils::chunked_vector<gossip_digest>& get_gossip_digest_list() const {
@@ -48,6 +53,10 @@ class gossip_digest_ack {
         return _map;
     }
 
+    const std::vector<uint32_t>& get_mismatched_summary_buckets() const {
+        return _mismatched_summary_buckets;
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const gossip_digest_ack& ack);
 };
 
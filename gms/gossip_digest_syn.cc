@@ -19,7 +19,11 @@ std::ostream& operator<<(std::ostream& os, const gossip_digest_syn& syn) {
     for (auto& d : syn._digests) {
         os << d << " ";
     }
-    return os << "}";
+    os << "}";
+    if (!syn._digest_summary.empty()) {
+        os << ",summary_buckets:" << syn._digest_summary.size();
+    }
+    return os;
 }
 
 } // namespace gms
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <vector>
 #include <seastar/core/sstring.hh>
 #include "utils/serialization.hh"
 #include "gms/gossip_digest.hh"
@@ -26,14 +27,18 @@ class gossip_digest_syn {
     sstring _cluster_id;
     sstring _partioner;
     utils::chunked_vector<gossip_digest> _digests;
+    // If not empty, _digests holds only a sample of the endpoints, and this a
+    // hash of the states of all of them, per bucket, see gossiper::make_digest_summary().
+    std::vector<uint64_t> _digest_summary;
 public:
     gossip_digest_syn() {
     }
 
-    gossip_digest_syn(sstring id, sstring p, utils::chunked_vector<gossip_digest> digests)
+    gossip_digest_syn(sstring id, sstring p, utils::chunked_vector<gossip_digest> digests, std::vector<uint64_t> digest_summary = {})
         : _cluster_id(std::move(id))
         , _partioner(std::move(p))
-        , _digests(std::move(digests)) {
+        , _digests(std::move(digests))
+        , _digest_summary(std::move(digest_summary)) {
     }
 
     sstring cluster_id() const {
@@ -56,6 +61,10 @@ class gossip_digest_syn {
         return _digests;
     }
 
+    const std::vector<uint64_t>& get_digest_summary() const {
+        return _digest_summary;
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const gossip_digest_syn& syn);
 };
 
@@ -40,6 +40,7 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include "utils/generation-number.hh"
+#include "utils/murmur_hash.hh"
 #include "locator/token_metadata.hh"
 #include "utils/exceptions.hh"
 
@@ -246,7 +247,17 @@ future<> gossiper::do_send_ack_msg(msg_addr from, gossip_digest_syn syn_msg) {
         utils::chunked_vector<gossip_digest> delta_gossip_digest_list;
         std::map<inet_address, endpoint_state> delta_ep_state_map;
         this->examine_gossiper(g_digest_list, delta_gossip_digest_list, delta_ep_state_map);
-        gms::gossip_digest_ack ack_msg(std::move(delta_gossip_digest_list), std::move(delta_ep_state_map));
+        std::vector<uint32_t> mismatched_summary_buckets;
+        auto& summary = syn_msg.get_digest_summary();
+        if (!summary.empty()) {
+            auto local_summary = make_digest_summary(summary.size());
+            for (uint32_t b = 0; b < summary.size(); ++b) {
+                if (summary[b] != local_summary[b]) {
+                    mismatched_summary_buckets.push_back(b);
+                }
+            }
+        }
+        gms::gossip_digest_ack ack_msg(std::move(delta_gossip_digest_list), std::move(delta_ep_state_map), std::move(mismatched_summary_buckets));
         logger.debug("Calling do_send_ack_msg to node {}, syn_msg={}, ack_msg={}", from, syn_msg, ack_msg);
         return _messaging.send_gossip_digest_ack(from, std::move(ack_msg));
     });
@@ -288,6 +299,13 @@ future<> gossiper::handle_ack_msg(msg_addr id, gossip_digest_ack ack_msg) {
     auto g_digest_list = ack_msg.get_gossip_digest_list();
     auto& ep_state_map = ack_msg.get_endpoint_state_map();
 
+    if (!ack_msg.get_mismatched_summary_buckets().empty()) {
+        // Do it in the background, like the sending of syn messages.
+        (void)send_summary_bucket_digests(id, ack_msg.get_mismatched_summary_buckets()).handle_exception([id] (auto ep) {
+            logger.trace("Failed to send the digests of mismatched summary buckets to {}: {}", id, ep);
+        });
+    }
+
     bool count_as_msg_processing = should_count_as_msg_processing(ep_state_map);
     if (count_as_msg_processing) {
         _msg_processing++;
@@ -877,7 +895,7 @@ void gossiper::run() {
             this->make_random_gossip_digest(g_digests);
 
             if (g_digests.size() > 0) {
-                gossip_digest_syn message(get_cluster_name(), get_partitioner_name(), g_digests);
+                gossip_digest_syn message = make_gossip_digest_syn(std::move(g_digests));
 
                 if (_endpoints_to_talk_with.empty()) {
                     std::shuffle(_live_endpoints.begin(), _live_endpoints.end(), _random_engine);
@@ -1072,6 +1090,69 @@ std::set<inet_address> gossiper::get_unreachable_members() const {
     return ret;
 }
 
+int gossiper::get_max_application_state_version(const endpoint_state& state) noexcept {
+    int max_version = 0;
+    for (auto& entry : state.get_application_state_map()) {
+        max_version = std::max(max_version, entry.second.version);
+    }
+    return max_version;
+}
+
+size_t gossiper::digest_summary_bucket(inet_address endpoint, size_t buckets) noexcept {
+    return utils::murmur_hash::hash2_64(endpoint.bytes(), 0) % buckets;
+}
+
+// The hash of a bucket is the sum of those of the endpoints in it, so that it
+// doesn't depend on the order of the endpoints.
+std::vector<uint64_t> gossiper::make_digest_summary(size_t buckets) const {
+    std::vector<uint64_t> summary(buckets);
+    for (auto& [endpoint, state] : _endpoint_state_map) {
+        auto h = utils::murmur_hash::hash2_64(endpoint.bytes(), 0);
+        auto versions = (uint64_t(uint32_t(state.get_heart_beat_state().get_generation())) << 32)
+                | uint32_t(get_max_application_state_version(state));
+        summary[h % buckets] += utils::murmur_hash::fmix(h ^ versions);
+    }
+    return summary;
+}
+
+gossip_digest_syn gossiper::make_gossip_digest_syn(utils::chunked_vector<gossip_digest> g_digests) const {
+    if (g_digests.size() < digest_summary_min_endpoints || !_feature_service.gossip_digest_summary) {
+        return gossip_digest_syn(get_cluster_name(), get_partitioner_name(), std::move(g_digests));
+    }
+    // The digests are shuffled, so the sample is a random one.
+    auto br_addr = get_broadcast_address();
+    auto sample_size = (g_digests.size() + digest_summary_sample_ratio - 1) / digest_summary_sample_ratio;
+    utils::chunked_vector<gossip_digest> sample;
+    sample.reserve(sample_size + 1);
+    for (auto& d : g_digests) {
+        if (sample.size() < sample_size || d.get_endpoint() == br_addr) {
+            sample.push_back(d);
+        }
+    }
+    return gossip_digest_syn(get_cluster_name(), get_partitioner_name(), std::move(sample), make_digest_summary(digest_summary_buckets));
+}
+
+future<> gossiper::send_summary_bucket_digests(msg_addr to, std::vector<uint32_t> buckets) {
+    std::vector<bool> requested(digest_summary_buckets);
+    for (auto b : buckets) {
+        if (b < requested.size()) {
+            requested[b] = true;
+        }
+    }
+    utils::chunked_vector<gossip_digest> digests;
+    for (auto& [endpoint, state] : _endpoint_state_map) {
+        if (requested[digest_summary_bucket(endpoint, requested.size())]) {
+            digests.emplace_back(endpoint, state.get_heart_beat_state().get_generation(), get_max_endpoint_state_version(state));
+        }
+    }
+    if (digests.empty()) {
+        return make_ready_future<>();
+    }
+    gossip_digest_syn message(get_cluster_name(), get_partitioner_name(), std::move(digests));
+    logger.debug("Sending the digests of mismatched summary buckets to {}: {}", to, message);
+    return _messaging.send_gossip_digest_syn(to, std::move(message));
+}
+
 int gossiper::get_max_endpoint_state_version(endpoint_state state) const noexcept {
     int max_version = state.get_heart_beat_state().get_heart_beat_version();
     for (auto& entry : state.get_application_state_map()) {
@@ -281,6 +281,9 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
      */
     int get_max_endpoint_state_version(endpoint_state state) const noexcept;
 
+    // Like get_max_endpoint_state_version(), but ignoring the heartbeat.
+    static int get_max_application_state_version(const endpoint_state& state) noexcept;
+
 
 private:
     /**
@@ -320,6 +323,24 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
      */
     void make_random_gossip_digest(utils::chunked_vector<gossip_digest>& g_digests);
 
+    // With this many endpoints or more, and once the whole cluster supports it,
+    // gossip_digest_syn messages carry a digest of only one in every
+    // digest_summary_sample_ratio endpoints, and of the local one, so that
+    // heartbeats keep propagating. The states of all endpoints are summarized
+    // in digest_summary_buckets hashes, which leave the heartbeats out, and the
+    // receiver asks for the digests of the endpoints of the buckets which differ
+    // from its own. So the size of gossip messages grows with the number of
+    // endpoints whose state changed recently, rather than with the cluster.
+    static constexpr size_t digest_summary_min_endpoints = 64;
+    static constexpr size_t digest_summary_buckets = 64;
+    static constexpr size_t digest_summary_sample_ratio = 8;
+
+    static size_t digest_summary_bucket(inet_address endpoint, size_t buckets) noexcept;
+    std::vector<uint64_t> make_digest_summary(size_t buckets) const;
+    gossip_digest_syn make_gossip_digest_syn(utils::chunked_vector<gossip_digest> g_digests) const;
+    // Sends the digests of all endpoints in the given buckets of the digest summary.
+    future<> send_summary_bucket_digests(msg_addr to, std::vector<uint32_t> buckets);
+
 public:
     /**
      * This method will begin removing an existing endpoint from the cluster by spoofing its state
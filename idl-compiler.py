@@ -371,9 +371,9 @@ void serializer<{name}{self.template_param_names_str}>::skip(Input& buf) {{
             fprintln(cout, f"""  {SIZETYPE} size = {DESERIALIZER}(buf, boost::type<{SIZETYPE}>());
   buf.skip(size - sizeof({SIZETYPE}));""")
         else:
-            for m in get_members(self):
-                full_type = param_view_type(m.type)
-                fprintln(cout, f"  ser::skip(buf, boost::type<{full_type}>());")
+            skip = skip_members("buf", [param_view_type(m.type) for m in get_members(self)])
+            if skip:
+                fprintln(cout, f"  {skip}")
         fprintln(cout, """ });\n}""")
 
 
@@ -830,11 +830,34 @@ def template_params_str(template_params):
     return ", ".join(map(lambda param: param.typename + " " + param.name, template_params))
 
 
+def declare_serialized_members(hout, name, types):
+    '''Declare that a type is serialized as consecutive values of types,
+    so that it has a fixed serialized size if each of them has.
+    '''
+    fprintln(hout, f"""
+template <>
+struct serialized_members<{name}> {{
+  using types = serialized_types<{", ".join(types)}>;
+}};
+""")
+
+
+def skip_members(stream, types):
+    '''Returns a statement skipping consecutive values of types in stream,
+    or an empty string if there are none.
+    '''
+    if not types:
+        return ""
+    return f"ser::skip_members<{', '.join(types)}>({stream}, [] (auto& in, auto t) {{ ser::skip(in, t); }});"
+
+
 def handle_enum(enum, hout, cout):
     '''Generate serializer declarations and definitions for an IDL enum'''
     temp_def = template_params_str(enum.parent_template_params)
     name = enum.ns_qualified_name()
     declare_methods(hout, name, temp_def)
+    if not enum.parent_template_params:
+        declare_serialized_members(hout, name, [enum.underlying_type])
 
     enum.serializer_write_impl(cout)
     enum.serializer_read_impl(cout)
@@ -1448,12 +1471,13 @@ def add_view(cout, cls):
             }}
         """))
 
-    skip = "" if cls.final else "ser::skip(in, boost::type<size_type>());"
+    skipped = [] if cls.final else ["size_type"]
     local_names = {}
     for m in members:
         name = get_member_name(m.name)
         local_names[name] = "this->" + name + "()"
         full_type = param_view_type(m.type)
+        skip = skip_members("in", skipped)
         if m.attribute:
             deflt = m.default_value if m.default_value else param_type(m.type) + "()"
             if deflt in local_names:
@@ -1484,9 +1508,12 @@ def add_view(cout, cls):
                 }}
             """).format(f=DESERIALIZER, **locals()))
 
-        skip = skip + f"\n       ser::skip(in, boost::type<{full_type}>());"
+        skipped.append(full_type)
 
     fprintln(cout, "};")
+    if cls.final and members and not any(m.attribute for m in members):
+        declare_serialized_members(cout, f"{cls.name}_view", skipped)
+    skip = skip_members("in", skipped)
     skip_impl = "auto& in = v;\n       " + skip if cls.final else "v.skip(read_frame_size(v));"
     if skip == "":
         skip_impl = ""
@@ -1571,6 +1598,9 @@ def handle_class(cls, hout, cout):
         elif isinstance(member, EnumDef):
             handle_enum(member, hout, cout)
     declare_methods(hout, full_name, template_params)
+    members = get_members(cls)
+    if cls.final and not template_params and members and not any(m.attribute for m in members):
+        declare_serialized_members(hout, full_name, [param_type(m.type) for m in members])
 
     cls.serializer_write_impl(cout)
     cls.serializer_read_impl(cout)
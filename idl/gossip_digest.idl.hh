@@ -52,11 +52,13 @@ class gossip_digest_syn {
     sstring get_cluster_id();
     sstring get_partioner();
     utils::chunked_vector<gms::gossip_digest> get_gossip_digests();
+    std::vector<uint64_t> get_digest_summary() [[version 5.3]];
 };
 
 class gossip_digest_ack {
     utils::chunked_vector<gms::gossip_digest> get_gossip_digest_list();
     std::map<gms::inet_address, gms::endpoint_state> get_endpoint_state_map();
+    std::vector<uint32_t> get_mismatched_summary_buckets() [[version 5.3]];
 };
 
 class gossip_digest_ack2 {
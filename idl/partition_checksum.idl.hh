@@ -40,6 +40,7 @@ struct get_sync_boundary_response {
 enum class row_level_diff_detect_algorithm : uint8_t {
     send_full_set,
     send_full_set_rpc_stream,
+    send_hash_buckets_rpc_stream,
 };
 
 enum class repair_stream_cmd : uint8_t {
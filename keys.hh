@@ -527,25 +527,17 @@ class prefixable_full_compound : public compound_wrapper<TopLevel, TopLevelView>
     // sorted according to prefix equality ordering.
     struct prefix_equality_less_compare {
         typename PrefixTopLevel::compound prefix_type;
-        typename TopLevel::compound full_type;
 
         prefix_equality_less_compare(const schema& s)
             : prefix_type(PrefixTopLevel::get_compound_type(s))
-            , full_type(TopLevel::get_compound_type(s))
         { }
 
         bool operator()(const TopLevel& k1, const PrefixTopLevel& k2) const {
-            return prefix_equality_tri_compare(prefix_type->types().begin(),
-                full_type->begin(k1), full_type->end(k1),
-                prefix_type->begin(k2), prefix_type->end(k2),
-                tri_compare) < 0;
+            return prefix_type->prefix_equality_tri_compare(k1.representation(), k2.representation()) < 0;
         }
 
         bool operator()(const PrefixTopLevel& k1, const TopLevel& k2) const {
-            return prefix_equality_tri_compare(prefix_type->types().begin(),
-                prefix_type->begin(k1), prefix_type->end(k1),
-                full_type->begin(k2), full_type->end(k2),
-                tri_compare) < 0;
+            return prefix_type->prefix_equality_tri_compare(k1.representation(), k2.representation()) < 0;
         }
     };
 
@@ -609,10 +601,7 @@ class prefix_compound_wrapper : public compound_wrapper<TopLevel, TopLevelView>
         { }
 
         bool operator()(const TopLevel& k1, const TopLevel& k2) const {
-            return prefix_equality_tri_compare(prefix_type->types().begin(),
-                prefix_type->begin(k1.representation()), prefix_type->end(k1.representation()),
-                prefix_type->begin(k2.representation()), prefix_type->end(k2.representation()),
-                tri_compare) < 0;
+            return prefix_type->prefix_equality_tri_compare(k1.representation(), k2.representation()) < 0;
         }
     };
 
@@ -625,10 +614,7 @@ class prefix_compound_wrapper : public compound_wrapper<TopLevel, TopLevelView>
         { }
 
         std::strong_ordering operator()(const TopLevel& k1, const TopLevel& k2) const {
-            return prefix_equality_tri_compare(prefix_type->types().begin(),
-                prefix_type->begin(k1.representation()), prefix_type->end(k1.representation()),
-                prefix_type->begin(k2.representation()), prefix_type->end(k2.representation()),
-                tri_compare);
+            return prefix_type->prefix_equality_tri_compare(k1.representation(), k2.representation());
         }
     };
 };
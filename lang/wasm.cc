@@ -34,31 +34,53 @@ context::context(wasmtime::Engine& engine_ptr, std::string name, instance_cache*
 
 static constexpr size_t WASM_PAGE_SIZE = 64 * 1024;
 
-static void init_abstract_arg(const abstract_type& t, const bytes_opt& param, wasmtime::ValVec& argv, wasmtime::Store& store, wasmtime::Instance& instance) {
+static uint32_t get_abi(wasm_instance& inst) {
+    if (!inst.abi) {
+        inst.abi = wasmtime::get_abi(*inst.instance, *inst.store, *inst.memory);
+    }
+    return *inst.abi;
+}
+
+static wasmtime::Func& get_malloc_func(wasm_instance& inst) {
+    if (!inst.malloc_func) {
+        inst.malloc_func = wasmtime::create_func(*inst.instance, *inst.store, "_scylla_malloc");
+        inst.free_func = wasmtime::create_func(*inst.instance, *inst.store, "_scylla_free");
+    }
+    return **inst.malloc_func;
+}
+
+static wasmtime::Func& get_free_func(wasm_instance& inst) {
+    if (!inst.free_func) {
+        inst.free_func = wasmtime::create_func(*inst.instance, *inst.store, "_scylla_free");
+    }
+    return **inst.free_func;
+}
+
+static void init_abstract_arg(const abstract_type& t, const bytes_opt& param, wasmtime::ValVec& argv, wasm_instance& inst) {
         // set up exported memory's underlying buffer,
         // `memory` is required to be exported in the WebAssembly module
-        auto memory = wasmtime::get_memory(instance, store);
+        auto& store = *inst.store;
+        auto& memory = inst.memory;
         size_t mem_size = memory->size(store) * WASM_PAGE_SIZE;
         if (param && param->size() > std::numeric_limits<int32_t>::max()) {
             throw wasm::exception(format("Serialized parameter is too large: {} > {}", param->size(), std::numeric_limits<int32_t>::max()));
         }
         int32_t serialized_size = param ? param->size() : 0;
         if (param) {
-            switch (uint32_t abi_ver = wasmtime::get_abi(instance, store, *memory)) {
+            switch (uint32_t abi_ver = get_abi(inst)) {
                 case 1: {
                     auto pre_grow = memory->grow(store, 1 + (serialized_size - 1) / WASM_PAGE_SIZE);
                     mem_size = pre_grow * WASM_PAGE_SIZE;
                     break;
                 }
                 case 2: {
-                    auto malloc_func = wasmtime::create_func(instance, store, "_scylla_malloc");
-                    wasmtime::create_func(instance, store, "_scylla_free");
+                    auto& malloc_func = get_malloc_func(inst);
                     auto argv = wasmtime::get_val_vec();
                     argv->push_i32(serialized_size);
                     auto rets = wasmtime::get_val_vec();
                     rets->push_i32(0);
 
-                    auto fut = wasmtime::get_func_future(store, *malloc_func, *argv, *rets);
+                    auto fut = wasmtime::get_func_future(store, malloc_func, *argv, *rets);
                     // The future only calls malloc, which should complete quickly enough to not need yielding.
                     while (!fut->resume());
                     auto val = rets->pop_val();
@@ -83,8 +105,7 @@ static void init_abstract_arg(const abstract_type& t, const bytes_opt& param, wa
 struct init_arg_visitor {
     const bytes_opt& param;
     wasmtime::ValVec& argv;
-    wasmtime::Store& store;
-    wasmtime::Instance& instance;
+    wasm_instance& inst;
 
     void operator()(const boolean_type_impl&) {
         auto dv = boolean_type->deserialize(*param);
@@ -119,26 +140,24 @@ struct init_arg_visitor {
         if (!param) {
             on_internal_error(wasm_logger, "init_arg_visitor does not accept null values");
         }
-        init_abstract_arg(t, param, argv, store, instance);
+        init_abstract_arg(t, param, argv, inst);
     }
 };
 
 struct init_nullable_arg_visitor {
     const bytes_opt& param;
     wasmtime::ValVec& argv;
-    wasmtime::Store& store;
-    wasmtime::Instance& instance;
+    wasm_instance& inst;
 
     void operator()(const abstract_type& t) {
-        init_abstract_arg(t, param, argv, store, instance);
+        init_abstract_arg(t, param, argv, inst);
     }
 };
 
 
 struct from_val_visitor {
     const wasmtime::Val& val;
-    wasmtime::Store& store;
-    wasmtime::Instance& instance;
+    wasm_instance& inst;
 
     bytes_opt operator()(const boolean_type_impl&) {
         expect_kind(wasmtime::ValKind::I32);
@@ -171,8 +190,8 @@ struct from_val_visitor {
 
     bytes_opt operator()(const abstract_type& t) {
         expect_kind(wasmtime::ValKind::I64);
-        auto memory = wasmtime::get_memory(instance, store);
-        uint8_t* mem_base = memory->data(store);
+        auto& store = *inst.store;
+        uint8_t* mem_base = inst.memory->data(store);
         uint8_t* data = mem_base + (val.i64() & 0xffffffff);
         int32_t ret_size = val.i64() >> 32;
         if (ret_size == -1) {
@@ -180,12 +199,12 @@ struct from_val_visitor {
         }
         bytes_opt ret = t.decompose(t.deserialize(bytes_view(reinterpret_cast<int8_t*>(data), ret_size)));
 
-        if (wasmtime::get_abi(instance, store, *memory) == 2) {
-            auto free_func = wasmtime::create_func(instance, store, "_scylla_free");
+        if (get_abi(inst) == 2) {
+            auto& free_func = get_free_func(inst);
             auto argv = wasmtime::get_val_vec();
             argv->push_i32((int32_t)val.i64());
             auto rets = wasmtime::get_val_vec();
-            auto free_fut = wasmtime::get_func_future(store, *free_func, *argv, *rets);
+            auto free_fut = wasmtime::get_func_future(store, free_func, *argv, *rets);
             // The future only calls free, which should complete quickly enough to not need yielding.
             while (!free_fut->resume());
         }
@@ -224,8 +243,9 @@ void precompile(context& ctx, const std::vector<sstring>& arg_names, std::string
         throw wasm::exception(e.what());
     }
 }
-seastar::future<bytes_opt> run_script(context& ctx, wasmtime::Store& store, wasmtime::Instance& instance, wasmtime::Func& func, const std::vector<data_type>& arg_types, const std::vector<bytes_opt>& params, data_type return_type, bool allow_null_input) {
+seastar::future<bytes_opt> run_script(context& ctx, wasm_instance& inst, const std::vector<data_type>& arg_types, const std::vector<bytes_opt>& params, data_type return_type, bool allow_null_input) {
     wasm_logger.debug("Running function {}", ctx.function_name);
+    auto& store = *inst.store;
 
     rust::Box<wasmtime::ValVec> argv = wasmtime::get_val_vec();
     for (size_t i = 0; i < arg_types.size(); ++i) {
@@ -234,9 +254,9 @@ seastar::future<bytes_opt> run_script(context& ctx, wasmtime::Store& store, wasm
         // If nulls are allowed, each type will be passed indirectly
         // as a struct {bool is_null; int32_t serialized_size, char[] serialized_buf}
         if (allow_null_input) {
-            visit(type, init_nullable_arg_visitor{param, *argv, store, instance});
+            visit(type, init_nullable_arg_visitor{param, *argv, inst});
         } else if (param) {
-            visit(type, init_arg_visitor{param, *argv, store, instance});
+            visit(type, init_arg_visitor{param, *argv, inst});
         } else {
             co_await coroutine::return_exception(wasm::exception(format("Function {} cannot be called on null values", ctx.function_name)));
         }
@@ -244,7 +264,7 @@ seastar::future<bytes_opt> run_script(context& ctx, wasmtime::Store& store, wasm
     auto rets = wasmtime::get_val_vec();
     rets->push_i32(0);
 
-    auto fut = wasmtime::get_func_future(store, func, *argv, *rets);
+    auto fut = wasmtime::get_func_future(store, *inst.func, *argv, *rets);
     bool stop = false;
     while (!stop) {
         std::exception_ptr eptr;
@@ -276,9 +296,9 @@ seastar::future<bytes_opt> run_script(context& ctx, wasmtime::Store& store, wasm
     if (allow_null_input) {
         // Force calling the default method for abstract_type, which checks for nulls
         // and expects a serialized input
-        co_return from_val_visitor{*result, store, instance}(static_cast<const abstract_type&>(*return_type));
+        co_return from_val_visitor{*result, inst}(static_cast<const abstract_type&>(*return_type));
     } else {
-        co_return visit(*return_type, from_val_visitor{*result, store, instance});
+        co_return visit(*return_type, from_val_visitor{*result, inst});
     }
 }
 
@@ -288,7 +308,7 @@ seastar::future<bytes_opt> run_script(const db::functions::function_name& name,
     bytes_opt ret;
     try {
         func_inst = ctx.cache->get(name, arg_types, ctx).get0();
-        ret = wasm::run_script(ctx, *func_inst->instance->store, *func_inst->instance->instance, *func_inst->instance->func, arg_types, params, return_type, allow_null_input).get0();
+        ret = wasm::run_script(ctx, *func_inst->instance, arg_types, params, return_type, allow_null_input).get0();
     } catch (const wasm::instance_corrupting_exception& e) {
         func_inst->instance = std::nullopt;
         ex = std::current_exception();
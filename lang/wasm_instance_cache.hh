@@ -37,6 +37,12 @@ struct wasm_instance {
     rust::Box<wasmtime::Func> func;
     rust::Box<wasmtime::Memory> memory;
     module_handle mh;
+    // The exports used for passing serialized values, looked up once per instance
+    // instead of for each value. They are looked up on first use, because modules
+    // which only take and return values of types passed directly need not export them.
+    std::optional<uint32_t> abi;
+    std::optional<rust::Box<wasmtime::Func>> malloc_func;
+    std::optional<rust::Box<wasmtime::Func>> free_func;
 };
 
 // For each UDF full name and a scheduling group, we store a wasmtime instance
@@ -63,9 +63,8 @@ sstring abstract_replication_strategy::to_qualified_class_name(std::string_view
 }
 
 inet_address_vector_replica_set abstract_replication_strategy::get_natural_endpoints(const token& search_token, const effective_replication_map& erm) const {
-    const token& key_token = erm.get_token_metadata_ptr()->first_token(search_token);
-    auto res = erm.get_replication_map().find(key_token);
-    return res->second;
+    auto idx = erm.get_token_metadata_ptr()->first_token_index(search_token);
+    return erm.get_replication_map()[idx];
 }
 
 inet_address_vector_replica_set effective_replication_map::get_natural_endpoints_without_node_being_replaced(const token& search_token) const {
@@ -261,11 +260,12 @@ abstract_replication_strategy::get_address_ranges(const token_metadata& tm, inet
 future<std::unordered_map<dht::token_range, inet_address_vector_replica_set>>
 effective_replication_map::get_range_addresses() const {
     const token_metadata& tm = *_tmptr;
+    const auto& sorted_tokens = tm.sorted_tokens();
     std::unordered_map<dht::token_range, inet_address_vector_replica_set> ret;
-    for (const auto& [t, eps] : _replication_map) {
-        dht::token_range_vector ranges = tm.get_primary_ranges_for(t);
+    for (size_t i = 0; i < _replication_map.size(); ++i) {
+        dht::token_range_vector ranges = tm.get_primary_ranges_for(sorted_tokens[i]);
         for (auto& r : ranges) {
-            ret.emplace(r, eps);
+            ret.emplace(r, _replication_map[i]);
         }
         co_await coroutine::maybe_yield();
     }
@@ -312,12 +312,12 @@ future<mutable_effective_replication_map_ptr> calculate_effective_replication_ma
         if (rs->natural_endpoints_depend_on_token()) {
             for (const auto &t : sorted_tokens) {
                 auto eps = co_await rs->calculate_natural_endpoints(t, *tmptr);
-                replication_map.emplace(t, eps.get_vector());
+                replication_map.push_back(eps.get_vector());
             }
         } else {
             auto eps = co_await rs->calculate_natural_endpoints(sorted_tokens.front(), *tmptr);
-            for (const auto &t : sorted_tokens) {
-                replication_map.emplace(t, eps.get_vector());
+            for (size_t i = 0; i < sorted_tokens.size(); ++i) {
+                replication_map.push_back(eps.get_vector());
                 co_await coroutine::maybe_yield();
             }
         }
@@ -329,9 +329,10 @@ future<mutable_effective_replication_map_ptr> calculate_effective_replication_ma
 
 future<replication_map> effective_replication_map::clone_endpoints_gently() const {
     replication_map cloned_endpoints;
+    cloned_endpoints.reserve(_replication_map.size());
 
-    for (auto& i : _replication_map) {
-        cloned_endpoints.emplace(i.first, i.second);
+    for (auto& eps : _replication_map) {
+        cloned_endpoints.push_back(eps);
         co_await coroutine::maybe_yield();
     }
 
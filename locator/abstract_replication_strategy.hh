@@ -44,7 +44,10 @@ using can_yield = utils::can_yield;
 
 using replication_strategy_config_options = std::map<sstring, sstring>;
 
-using replication_map = std::unordered_map<token, inet_address_vector_replica_set>;
+// The replicas of each of the token_metadata's sorted_tokens(), at the same
+// index, so that finding the replicas of a token takes only the binary search
+// for its index.
+using replication_map = std::vector<inet_address_vector_replica_set>;
 
 using endpoint_set = utils::basic_sequenced_set<inet_address, inet_address_vector_replica_set>;
 
@@ -93,16 +93,16 @@ class topology {
      */
     void sort_by_proximity(inet_address address, inet_address_vector_replica_set& addresses) const;
 
-private:
-    // default constructor for cloning purposes
-    topology() = default;
-
     /**
      * compares two endpoints in relation to the target endpoint, returning as
      * Comparator.compare would
      */
     int compare_endpoints(const inet_address& address, const inet_address& a1, const inet_address& a2) const;
 
+private:
+    // default constructor for cloning purposes
+    topology() = default;
+
     /** multi-map: DC -> endpoints in that DC */
     std::unordered_map<sstring,
                        std::unordered_set<inet_address>>
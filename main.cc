@@ -55,6 +55,7 @@
 #include "message/messaging_service.hh"
 #include "db/sstables-format-selector.hh"
 #include "db/snapshot-ctl.hh"
+#include "db/row_cache_saver.hh"
 #include "cql3/query_processor.hh"
 #include <seastar/net/dns.hh>
 #include <seastar/core/io_queue.hh>
@@ -530,6 +531,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     std::optional<utils::directories> dirs = {};
     sharded<gms::feature_service> feature_service;
     sharded<db::snapshot_ctl> snapshot_ctl;
+    sharded<db::row_cache_saver> row_cache_saver;
     sharded<netw::messaging_service> messaging;
     sharded<cql3::query_processor> qp;
     sharded<db::batchlog_manager> bm;
@@ -661,6 +663,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 st_cfg.abort_on_lsa_bad_alloc = cfg->abort_on_lsa_bad_alloc();
                 st_cfg.lsa_reclamation_step = cfg->lsa_reclamation_step();
                 st_cfg.background_reclaim_sched_group = background_reclaim_scheduling_group;
+                st_cfg.background_reclaim_free_memory_threshold = cfg->lsa_background_reclaim_free_memory_threshold();
                 st_cfg.sanitizer_report_backtrace = cfg->sanitizer_report_backtrace();
                 logalloc::shard_tracker().configure(st_cfg);
             }).get();
@@ -796,7 +799,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             // });
 
             supervisor::notify("creating tracing");
-            tracing::tracing::create_tracing("trace_keyspace_helper").get();
+            tracing::tracing::create_tracing(cfg->tracing_backend()).get();
             auto destroy_tracing = defer_verbose_shutdown("tracing instance", [] {
                 tracing::tracing::tracing_instance().stop().get();
             });
@@ -852,6 +855,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             } else if (compress_what == "dc") {
                 mscfg.compress = netw::messaging_service::compress_what::dc;
             }
+            mscfg.zstd_across_dc = cfg->internode_compression_zstd();
+            mscfg.shard_aware_connections = cfg->internode_shard_aware_connections();
 
             if (encrypt == "all") {
                 mscfg.encrypt = netw::messaging_service::encrypt_what::all;
@@ -1035,6 +1040,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                     .available_memory = dbcfg.available_memory,
                     .static_shares = cfg->compaction_static_shares,
                     .throughput_mb_per_sec = cfg->compaction_throughput_mb_per_sec,
+                    .foreground_read_latency_target_us = cfg->compaction_foreground_read_latency_target_us,
+                    .offstrategy_max_fan_in = cfg->offstrategy_compaction_max_fan_in,
                 };
             });
             cm.start(std::move(get_cm_cfg), std::ref(stop_signal.as_sharded_abort_source())).get();
@@ -1085,6 +1092,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             spcfg.write_smp_service_group = create_smp_service_group(storage_proxy_smp_service_group_config).get0();
             spcfg.hints_write_smp_service_group = create_smp_service_group(storage_proxy_smp_service_group_config).get0();
             spcfg.write_ack_smp_service_group = create_smp_service_group(storage_proxy_smp_service_group_config).get0();
+            spcfg.background_read_repair_scheduling_group = dbcfg.streaming_scheduling_group;
             static db::view::node_update_backlog node_backlog(smp::count, 10ms);
             scheduling_group_key_config storage_proxy_stats_cfg =
                     make_scheduling_group_key_config<service::storage_proxy_stats::stats>();
@@ -1176,6 +1184,13 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 }
             }
 
+            // Must be done before group0 adds endpoints to the failure detector.
+            proxy.invoke_on_all([threshold = service::direct_fd_clock::base::duration{std::chrono::milliseconds{cfg->fast_failure_detection_threshold_in_ms()}}.count()] (service::storage_proxy& proxy) {
+                return proxy.start_fast_failure_detection(fd.local(), threshold);
+            }).get();
+            auto stop_fast_failure_detection = defer_verbose_shutdown("fast failure detection", [&proxy] {
+                proxy.invoke_on_all(&service::storage_proxy::stop_fast_failure_detection).get();
+            });
 
             group0_client.init().get();
 
@@ -1524,7 +1539,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 api::unset_server_authorization_cache(ctx).get();
             });
 
-            snapshot_ctl.start(std::ref(db)).get();
+            snapshot_ctl.start(std::ref(db), std::ref(task_manager)).get();
             auto stop_snapshot_ctl = defer_verbose_shutdown("snapshots", [&snapshot_ctl] {
                 snapshot_ctl.stop().get();
             });
@@ -1567,6 +1582,24 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
 
             //FIXME: discarded future
             (void)api::set_server_cache(ctx);
+
+            supervisor::notify("starting row cache saver");
+            row_cache_saver.start(std::ref(db), sharded_parameter([&] {
+                return db::row_cache_saver::config{
+                    .directory = std::filesystem::path(cfg->saved_caches_directory()),
+                    .save_period = std::chrono::seconds(cfg->row_cache_save_period()),
+                    .keys_to_save = cfg->row_cache_keys_to_save(),
+                    .sched_group = maintenance_scheduling_group,
+                };
+            })).get();
+            row_cache_saver.invoke_on_all(&db::row_cache_saver::start).get();
+            auto stop_row_cache_saver = defer_verbose_shutdown("row cache saver", [&row_cache_saver] {
+                row_cache_saver.stop().get();
+            });
+            api::set_server_row_cache_saver(ctx, row_cache_saver).get();
+            auto stop_row_cache_saver_api = defer_verbose_shutdown("row cache saver API", [&ctx] {
+                api::unset_server_row_cache_saver(ctx).get();
+            });
             startlog.info("Waiting for gossip to settle before accepting client requests...");
             gossiper.local().wait_for_gossip_to_settle().get();
             api::set_server_gossip_settle(ctx, gossiper).get();
@@ -1750,6 +1783,8 @@ static main_func_type lookup_main_func(std::string_view name) {
         {"perf-row-cache-update", perf::scylla_row_cache_update_main},
         {"perf-simple-query", perf::scylla_simple_query_main},
         {"perf-sstable", perf::scylla_sstable_main},
+        {"perf-compaction-strategy", perf::scylla_compaction_strategy_main},
+        {"perf-compaction", perf::scylla_compaction_main},
     };
     auto found = std::ranges::find_if(funcs, [name] (auto& name_and_func) {
         return name_and_func.first == name;
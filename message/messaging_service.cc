@@ -26,6 +26,7 @@
 #include "db/config.hh"
 #include "db/view/view_update_backlog.hh"
 #include "dht/i_partitioner.hh"
+#include "schema.hh"
 #include "range.hh"
 #include "frozen_schema.hh"
 #include "repair/repair.hh"
@@ -38,6 +39,7 @@
 #include "digest_algorithm.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "cache_temperature.hh"
 #include "raft/raft.hh"
 #include "service/raft/group0_fwd.hh"
@@ -104,8 +106,11 @@
 #include <seastar/rpc/lz4_compressor.hh>
 #include <seastar/rpc/lz4_fragmented_compressor.hh>
 #include <seastar/rpc/multi_algo_compressor_factory.hh>
+#include <seastar/core/metrics.hh>
+#include "message/zstd_rpc_compressor.hh"
 #include "partition_range_compat.hh"
 #include <boost/range/adaptor/filtered.hpp>
+#include <random>
 #include <boost/range/adaptor/indirected.hpp>
 #include "frozen_mutation.hh"
 #include "streaming/stream_manager.hh"
@@ -135,13 +140,22 @@ static rpc::multi_algo_compressor_factory compressor_factory {
     &lz4_fragmented_compressor_factory,
     &lz4_compressor_factory,
 };
+static zstd_rpc_compressor::factory zstd_compressor_factory;
+// Offered by clients across data centers, when zstd is enabled, and accepted
+// by servers. Servers pick the first algorithm of the client which they
+// support, so connections from nodes which don't offer zstd keep using lz4.
+static rpc::multi_algo_compressor_factory zstd_compressor_factory_chain {
+    &zstd_compressor_factory,
+    &lz4_fragmented_compressor_factory,
+    &lz4_compressor_factory,
+};
 
 struct messaging_service::rpc_protocol_server_wrapper : public rpc_protocol::server { using rpc_protocol::server::server; };
 
 constexpr int32_t messaging_service::current_version;
 
 // Count of connection types that are not associated with any tenant
-const size_t PER_SHARD_CONNECTION_COUNT = 2;
+const size_t PER_SHARD_CONNECTION_COUNT = 3;
 // Counts per tenant connection types
 const size_t PER_TENANT_CONNECTION_COUNT = 3;
 
@@ -183,6 +197,9 @@ void messaging_service::foreach_client(std::function<void(const msg_addr& id, co
         for (auto i = _clients[idx].cbegin(); i != _clients[idx].cend(); i++) {
             f(i->first, i->second);
         }
+        for (auto i = _shard_clients[idx].cbegin(); i != _shard_clients[idx].cend(); i++) {
+            f(i->first, i->second);
+        }
     }
 }
 
@@ -277,7 +294,7 @@ void messaging_service::do_start_listen() {
     bool listen_to_bc = _cfg.listen_on_broadcast_address && _cfg.ip != utils::fb_utilities::get_broadcast_address();
     rpc::server_options so;
     if (_cfg.compress != compress_what::none) {
-        so.compressor_factory = &compressor_factory;
+        so.compressor_factory = _cfg.zstd_across_dc ? &zstd_compressor_factory_chain : &compressor_factory;
     }
     so.load_balancing_algorithm = server_socket::load_balancing_algorithm::port;
 
@@ -368,11 +385,27 @@ messaging_service::messaging_service(config cfg, scheduling_config scfg, std::sh
     , _rpc(new rpc_protocol_wrapper(serializer { }))
     , _credentials_builder(credentials ? std::make_unique<seastar::tls::credentials_builder>(*credentials) : nullptr)
     , _clients(PER_SHARD_CONNECTION_COUNT + scfg.statement_tenants.size() * PER_TENANT_CONNECTION_COUNT)
+    , _shard_clients(_clients.size())
     , _scheduling_config(scfg)
     , _scheduling_info_for_connection_index(initial_scheduling_info())
 {
     _rpc->set_logger(&rpc_logger);
 
+    if (_cfg.zstd_across_dc) {
+        namespace sm = seastar::metrics;
+        auto& stats = zstd_rpc_compressor::shard_stats();
+        _metrics.add_group("messaging_service", {
+            sm::make_counter("zstd_compressed_bytes_in", [&stats] { return stats.bytes_compressed_in; },
+                           sm::description("Number of bytes of sent messages compressed with zstd, before compression.")),
+            sm::make_counter("zstd_compressed_bytes_out", [&stats] { return stats.bytes_compressed_out; },
+                           sm::description("Number of bytes of sent messages compressed with zstd, after compression.")),
+            sm::make_counter("zstd_decompressed_bytes_in", [&stats] { return stats.bytes_decompressed_in; },
+                           sm::description("Number of bytes of received messages decompressed with zstd, before decompression.")),
+            sm::make_counter("zstd_decompressed_bytes_out", [&stats] { return stats.bytes_decompressed_out; },
+                           sm::description("Number of bytes of received messages decompressed with zstd, after decompression.")),
+        });
+    }
+
     // this initialization should be done before any handler registration
     // this is because register_handler calls to: scheduling_group_for_verb
     // which in turn relies on _connection_index_for_tenant to be initialized.
@@ -427,14 +460,17 @@ future<> messaging_service::stop_nontls_server() {
 }
 
 future<> messaging_service::stop_client() {
-    return parallel_for_each(_clients, [] (auto& m) {
-        return parallel_for_each(m, [] (std::pair<const msg_addr, shard_info>& c) {
-            mlogger.info("Stopping client for address: {}", c.first);
-            return c.second.rpc_client->stop().then([addr = c.first] {
-                mlogger.info("Stopping client for address: {} - Done", addr);
+    auto stop_clients = [] (std::vector<clients_map>& clients) {
+        return parallel_for_each(clients, [] (auto& m) {
+            return parallel_for_each(m, [] (std::pair<const msg_addr, shard_info>& c) {
+                mlogger.info("Stopping client for address: {}", c.first);
+                return c.second.rpc_client->stop().then([addr = c.first] {
+                    mlogger.info("Stopping client for address: {} - Done", addr);
+                });
             });
         });
-    });
+    };
+    return when_all_succeed(stop_clients(_clients), stop_clients(_shard_clients)).discard_result();
 }
 
 future<> messaging_service::shutdown() {
@@ -514,35 +550,48 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
         // DO NOT move GOSSIP_ verbs outside this group.
         static_assert(TOPOLOGY_INDEPENDENT_IDX == 0);
         return 0;
+    // Verbs which carry the data of streaming, repair and hints, in bulk.
+    case messaging_verb::UNUSED__STREAM_MUTATION:
+    case messaging_verb::STREAM_MUTATION_FRAGMENTS:
+    case messaging_verb::STREAM_SSTABLE_FILES:
+    case messaging_verb::REPAIR_GET_FULL_ROW_HASHES:
+    case messaging_verb::REPAIR_GET_ROW_DIFF:
+    case messaging_verb::REPAIR_PUT_ROW_DIFF:
+    case messaging_verb::REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM:
+    case messaging_verb::REPAIR_PUT_ROW_DIFF_WITH_RPC_STREAM:
+    case messaging_verb::REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM:
+    case messaging_verb::REPAIR_GET_FULL_ROW_HASHES_IN_BUCKETS:
+    case messaging_verb::HINT_MUTATION:
+    case messaging_verb::HINT_MUTATION_MULTI:
+        return 1;
+    // Verbs which control streaming, repair and node operations. They are
+    // small, and each of them can hold back a whole operation, so they
+    // have a connection of their own, not to queue behind the bulk verbs.
+    // Servers which don't know its isolation cookie run them in the
+    // default scheduling group, see scheduling_group_for_isolation_cookie().
     case messaging_verb::PREPARE_MESSAGE:
     case messaging_verb::PREPARE_DONE_MESSAGE:
-    case messaging_verb::UNUSED__STREAM_MUTATION:
     case messaging_verb::STREAM_MUTATION_DONE:
     case messaging_verb::COMPLETE_MESSAGE:
     case messaging_verb::REPLICATION_FINISHED:
     case messaging_verb::UNUSED__REPAIR_CHECKSUM_RANGE:
-    case messaging_verb::STREAM_MUTATION_FRAGMENTS:
     case messaging_verb::REPAIR_ROW_LEVEL_START:
     case messaging_verb::REPAIR_ROW_LEVEL_STOP:
-    case messaging_verb::REPAIR_GET_FULL_ROW_HASHES:
     case messaging_verb::REPAIR_GET_COMBINED_ROW_HASH:
     case messaging_verb::REPAIR_GET_SYNC_BOUNDARY:
-    case messaging_verb::REPAIR_GET_ROW_DIFF:
-    case messaging_verb::REPAIR_PUT_ROW_DIFF:
+    case messaging_verb::REPAIR_GET_ROW_HASH_BUCKETS:
     case messaging_verb::REPAIR_GET_ESTIMATED_PARTITIONS:
     case messaging_verb::REPAIR_SET_ESTIMATED_PARTITIONS:
     case messaging_verb::REPAIR_GET_DIFF_ALGORITHMS:
-    case messaging_verb::REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM:
-    case messaging_verb::REPAIR_PUT_ROW_DIFF_WITH_RPC_STREAM:
-    case messaging_verb::REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM:
     case messaging_verb::REPAIR_UPDATE_SYSTEM_TABLE:
     case messaging_verb::REPAIR_FLUSH_HINTS_BATCHLOG:
     case messaging_verb::NODE_OPS_CMD:
-    case messaging_verb::HINT_MUTATION:
-        return 1;
+        return 2;
     case messaging_verb::CLIENT_ID:
     case messaging_verb::MUTATION:
+    case messaging_verb::MUTATION_MULTI:
     case messaging_verb::READ_DATA:
+    case messaging_verb::READ_DATA_MULTI:
     case messaging_verb::READ_MUTATION_DATA:
     case messaging_verb::READ_DIGEST:
     case messaging_verb::DEFINITIONS_UPDATE:
@@ -568,12 +617,13 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::RAFT_ADD_ENTRY:
     case messaging_verb::RAFT_MODIFY_CONFIG:
     case messaging_verb::DIRECT_FD_PING:
-        return 2;
+        return 3;
     case messaging_verb::MUTATION_DONE:
+    case messaging_verb::MUTATION_DONE_MULTI:
     case messaging_verb::MUTATION_FAILED:
-        return 3;
-    case messaging_verb::FORWARD_REQUEST:
         return 4;
+    case messaging_verb::FORWARD_REQUEST:
+        return 5;
     case messaging_verb::LAST:
         return -1; // should never happen
     }
@@ -622,6 +672,7 @@ messaging_service::initial_scheduling_info() const {
     auto sched_infos = std::vector<scheduling_info_for_connection_index>({
         { _scheduling_config.gossip, "gossip" },
         { _scheduling_config.streaming, "streaming", },
+        { _scheduling_config.streaming, "streaming-control", },
     });
 
     sched_infos.reserve(sched_infos.size() +
@@ -712,12 +763,96 @@ gms::inet_address messaging_service::get_public_endpoint_for(const gms::inet_add
     return i != _preferred_to_endpoint.end() ? i->second : ip;
 }
 
+// Verbs whose requests are served by a specific shard of the receiving node,
+// the one which owns their token or the one which they respond to.
+static constexpr bool is_shard_routed(messaging_verb verb) {
+    switch (verb) {
+    case messaging_verb::MUTATION:
+    case messaging_verb::MUTATION_MULTI:
+    case messaging_verb::MUTATION_DONE:
+    case messaging_verb::MUTATION_DONE_MULTI:
+    case messaging_verb::MUTATION_FAILED:
+    case messaging_verb::READ_DATA:
+    case messaging_verb::READ_MUTATION_DATA:
+    case messaging_verb::READ_DIGEST:
+    // Streaming sends the partitions of each shard of the receiver on a stream of their own.
+    case messaging_verb::STREAM_MUTATION_FRAGMENTS:
+    // Hints are replayed in batches of the partitions of each shard of the receiver.
+    case messaging_verb::HINT_MUTATION_MULTI:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Picks a random local port from which connections are handled by the given
+// shard of a node with shard_count shards, since servers assign connections
+// to shards by the remote port (see server_socket::load_balancing_algorithm::port).
+static uint16_t port_for_shard(unsigned shard, unsigned shard_count) {
+    static constexpr unsigned first_port = 32768;
+    static constexpr unsigned last_port = 60999;
+    static thread_local std::default_random_engine engine{std::random_device{}()};
+    std::uniform_int_distribution<unsigned> dist((first_port + shard_count - 1) / shard_count, (last_port - shard) / shard_count);
+    return dist(engine) * shard_count + shard;
+}
+
+void messaging_service::set_peer_sharding(gms::inet_address ep, unsigned shard_count, unsigned sharding_ignore_msb_bits) {
+    auto it = _peer_sharders.find(ep);
+    if (it != _peer_sharders.end()) {
+        if (it->second.shard_count() == shard_count && it->second.sharding_ignore_msb() == sharding_ignore_msb_bits) {
+            return;
+        }
+        _peer_sharders.erase(it);
+        // The connections may be to shards which don't exist anymore, or own other tokens.
+        for (auto& c : _shard_clients) {
+            find_and_remove_shard_clients(c, msg_addr(ep), [] (const auto&) { return true; });
+        }
+    }
+    _peer_sharders.emplace(ep, dht::sharder(shard_count, sharding_ignore_msb_bits));
+}
+
+msg_addr messaging_service::shard_addr(gms::inet_address ep, const schema& s, const dht::token& t) const {
+    // Tables sharded differently, e.g. which live on shard 0 only, are served by shard 0.
+    if (!_cfg.shard_aware_connections || s.get_sharder().shard_count() == 1) {
+        return msg_addr(ep);
+    }
+    auto it = _peer_sharders.find(ep);
+    if (it == _peer_sharders.end()) {
+        return msg_addr(ep);
+    }
+    return msg_addr(ep, it->second.shard_of(t));
+}
+
+const dht::sharder* messaging_service::peer_sharder(gms::inet_address ep) const {
+    if (!_cfg.shard_aware_connections) {
+        return nullptr;
+    }
+    auto it = _peer_sharders.find(ep);
+    return it == _peer_sharders.end() ? nullptr : &it->second;
+}
+
+std::optional<unsigned> messaging_service::connection_shard(messaging_verb verb, msg_addr id) const {
+    if (!_cfg.shard_aware_connections || !is_shard_routed(verb)) {
+        return std::nullopt;
+    }
+    auto it = _peer_sharders.find(id.addr);
+    if (it == _peer_sharders.end() || id.cpu_id >= it->second.shard_count()) {
+        return std::nullopt;
+    }
+    return id.cpu_id;
+}
+
 shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::get_rpc_client(messaging_verb verb, msg_addr id) {
     assert(!_shutting_down);
     auto idx = get_rpc_client_idx(verb);
-    auto it = _clients[idx].find(id);
+    auto target_shard = connection_shard(verb, id);
+    if (!target_shard) {
+        id.cpu_id = 0;
+    }
+    auto& clients = target_shard ? _shard_clients[idx] : _clients[idx];
+    auto it = clients.find(id);
 
-    if (it != _clients[idx].end()) {
+    if (it != clients.end()) {
         auto c = it->second.rpc_client;
         if (!c->error()) {
             return c;
@@ -725,12 +860,15 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
         // The 'dead_only' it should be true, because we're interested in
         // dropping the errored socket, but since it's errored anyway (the
         // above if) it's false to save unneeded second c->error() call
-        find_and_remove_client(_clients[idx], id, [] (const auto&) { return true; });
+        find_and_remove_client(clients, id, [] (const auto&) { return true; });
     }
 
     auto broadcast_address = utils::fb_utilities::get_broadcast_address();
     bool listen_to_bc = _cfg.listen_on_broadcast_address && _cfg.ip != broadcast_address;
     auto laddr = socket_address(listen_to_bc ? broadcast_address : _cfg.ip, 0);
+    // If the port is taken, connecting fails, and the next attempt picks another one.
+    auto client_laddr = !target_shard ? laddr :
+            socket_address(listen_to_bc ? broadcast_address : _cfg.ip, port_for_shard(*target_shard, _peer_sharders.at(id.addr).shard_count()));
 
     std::optional<bool> topology_status;
     auto has_topology = [&] {
@@ -804,7 +942,8 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
     // send keepalive messages each minute if connection is idle, drop connection after 10 failures
     opts.keepalive = std::optional<net::tcp_keepalive_params>({60s, 60s, 10});
     if (must_compress) {
-        opts.compressor_factory = &compressor_factory;
+        auto use_zstd = _cfg.zstd_across_dc && idx != TOPOLOGY_INDEPENDENT_IDX && has_topology() && !is_same_dc(id.addr);
+        opts.compressor_factory = use_zstd ? &zstd_compressor_factory_chain : &compressor_factory;
     }
     opts.tcp_nodelay = must_tcp_nodelay;
     opts.reuseaddr = true;
@@ -812,9 +951,9 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
 
     auto client = must_encrypt ?
                     ::make_shared<rpc_protocol_client_wrapper>(_rpc->protocol(), std::move(opts),
-                                    remote_addr, laddr, _credentials) :
+                                    remote_addr, client_laddr, _credentials) :
                     ::make_shared<rpc_protocol_client_wrapper>(_rpc->protocol(), std::move(opts),
-                                    remote_addr, laddr);
+                                    remote_addr, client_laddr);
 
     // Remember if we had the peer's topology information when creating the client;
     // if not, we shall later drop the client and create a new one after we learn the peer's
@@ -823,7 +962,7 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
     // are independent of topology, so there's no point in dropping it later after we learn
     // the topology (so we always set `topology_ignored` to `false` in that case).
     bool topology_ignored = idx != TOPOLOGY_INDEPENDENT_IDX && topology_status.has_value() && *topology_status == false;
-    auto res = _clients[idx].emplace(id, shard_info(std::move(client), topology_ignored));
+    auto res = clients.emplace(id, shard_info(std::move(client), topology_ignored));
     assert(res.second);
     it = res.first;
     uint32_t src_cpu_id = this_shard_id();
@@ -862,19 +1001,44 @@ void messaging_service::find_and_remove_client(clients_map& clients, msg_addr id
     }
 }
 
+template <typename Fn>
+requires std::is_invocable_r_v<bool, Fn, const messaging_service::shard_info&>
+void messaging_service::find_and_remove_shard_clients(clients_map& clients, msg_addr id, Fn&& filter) {
+    std::vector<msg_addr> ids;
+    for (auto& [client_id, info] : clients) {
+        if (client_id.addr == id.addr) {
+            ids.push_back(client_id);
+        }
+    }
+    for (auto& client_id : ids) {
+        find_and_remove_client(clients, client_id, filter);
+    }
+}
+
 void messaging_service::remove_error_rpc_client(messaging_verb verb, msg_addr id) {
-    find_and_remove_client(_clients[get_rpc_client_idx(verb)], id, [] (const auto& s) { return s.rpc_client->error(); });
+    auto idx = get_rpc_client_idx(verb);
+    auto target_shard = connection_shard(verb, id);
+    if (!target_shard) {
+        id.cpu_id = 0;
+    }
+    find_and_remove_client(target_shard ? _shard_clients[idx] : _clients[idx], id, [] (const auto& s) { return s.rpc_client->error(); });
 }
 
 void messaging_service::remove_rpc_client(msg_addr id) {
     for (auto& c : _clients) {
-        find_and_remove_client(c, id, [] (const auto&) { return true; });
+        find_and_remove_client(c, msg_addr(id.addr), [] (const auto&) { return true; });
+    }
+    for (auto& c : _shard_clients) {
+        find_and_remove_shard_clients(c, id, [] (const auto&) { return true; });
     }
 }
 
 void messaging_service::remove_rpc_client_with_ignored_topology(msg_addr id) {
     for (auto& c : _clients) {
-        find_and_remove_client(c, id, [] (const auto& s) { return s.topology_ignored; });
+        find_and_remove_client(c, msg_addr(id.addr), [] (const auto& s) { return s.topology_ignored; });
+    }
+    for (auto& c : _shard_clients) {
+        find_and_remove_shard_clients(c, id, [] (const auto& s) { return s.topology_ignored; });
     }
 }
 
@@ -911,6 +1075,35 @@ future<> messaging_service::unregister_stream_mutation_fragments() {
     return unregister_handler(messaging_verb::STREAM_MUTATION_FRAGMENTS);
 }
 
+rpc::sink<int32_t> messaging_service::make_sink_for_stream_sstable_files(rpc::source<sstring, bytes, streaming::stream_sstable_files_cmd>& source) {
+    return source.make_sink<netw::serializer, int32_t>();
+}
+
+future<std::tuple<rpc::sink<sstring, bytes, streaming::stream_sstable_files_cmd>, rpc::source<int32_t>>>
+messaging_service::make_sink_and_source_for_stream_sstable_files(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, sstring sstable_version, streaming::stream_reason reason, msg_addr id) {
+    using value_type = std::tuple<rpc::sink<sstring, bytes, streaming::stream_sstable_files_cmd>, rpc::source<int32_t>>;
+    if (is_shutting_down()) {
+        return make_exception_future<value_type>(rpc::closed_error());
+    }
+    auto rpc_client = get_rpc_client(messaging_verb::STREAM_SSTABLE_FILES, id);
+    return rpc_client->make_stream_sink<netw::serializer, sstring, bytes, streaming::stream_sstable_files_cmd>().then([this, plan_id, schema_id, cf_id, sstable_version = std::move(sstable_version), reason, rpc_client] (rpc::sink<sstring, bytes, streaming::stream_sstable_files_cmd> sink) mutable {
+        auto rpc_handler = rpc()->make_client<rpc::source<int32_t> (streaming::plan_id, table_schema_version, table_id, sstring, streaming::stream_reason, rpc::sink<sstring, bytes, streaming::stream_sstable_files_cmd>)>(messaging_verb::STREAM_SSTABLE_FILES);
+        return rpc_handler(*rpc_client, plan_id, schema_id, cf_id, sstable_version, reason, sink).then_wrapped([sink, rpc_client] (future<rpc::source<int32_t>> source) mutable {
+            return (source.failed() ? sink.close() : make_ready_future<>()).then([sink = std::move(sink), source = std::move(source)] () mutable {
+                return make_ready_future<value_type>(value_type(std::move(sink), source.get0()));
+            });
+        });
+    });
+}
+
+void messaging_service::register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_schema_version schema_id, table_id cf_id, sstring sstable_version, streaming::stream_reason reason, rpc::source<sstring, bytes, streaming::stream_sstable_files_cmd> source)>&& func) {
+    register_handler(this, messaging_verb::STREAM_SSTABLE_FILES, std::move(func));
+}
+
+future<> messaging_service::unregister_stream_sstable_files() {
+    return unregister_handler(messaging_verb::STREAM_SSTABLE_FILES);
+}
+
 template<class SinkType, class SourceType>
 future<std::tuple<rpc::sink<SinkType>, rpc::source<SourceType>>>
 do_make_sink_source(messaging_verb verb, uint32_t repair_meta_id, shared_ptr<messaging_service::rpc_protocol_client_wrapper> rpc_client, std::unique_ptr<messaging_service::rpc_protocol_wrapper>& rpc) {
@@ -1190,6 +1383,28 @@ future<repair_hash_set> messaging_service::send_repair_get_full_row_hashes(msg_a
     return send_message<future<repair_hash_set>>(this, messaging_verb::REPAIR_GET_FULL_ROW_HASHES, std::move(id), repair_meta_id);
 }
 
+// Wrapper for REPAIR_GET_ROW_HASH_BUCKETS
+void messaging_service::register_repair_get_row_hash_buckets(std::function<future<std::vector<repair_hash>> (const rpc::client_info& cinfo, uint32_t repair_meta_id, uint32_t nr_buckets)>&& func) {
+    register_handler(this, messaging_verb::REPAIR_GET_ROW_HASH_BUCKETS, std::move(func));
+}
+future<> messaging_service::unregister_repair_get_row_hash_buckets() {
+    return unregister_handler(messaging_verb::REPAIR_GET_ROW_HASH_BUCKETS);
+}
+future<std::vector<repair_hash>> messaging_service::send_repair_get_row_hash_buckets(msg_addr id, uint32_t repair_meta_id, uint32_t nr_buckets) {
+    return send_message<future<std::vector<repair_hash>>>(this, messaging_verb::REPAIR_GET_ROW_HASH_BUCKETS, std::move(id), repair_meta_id, nr_buckets);
+}
+
+// Wrapper for REPAIR_GET_FULL_ROW_HASHES_IN_BUCKETS
+void messaging_service::register_repair_get_full_row_hashes_in_buckets(std::function<future<repair_hash_set> (const rpc::client_info& cinfo, uint32_t repair_meta_id, uint32_t nr_buckets, std::vector<uint32_t> buckets)>&& func) {
+    register_handler(this, messaging_verb::REPAIR_GET_FULL_ROW_HASHES_IN_BUCKETS, std::move(func));
+}
+future<> messaging_service::unregister_repair_get_full_row_hashes_in_buckets() {
+    return unregister_handler(messaging_verb::REPAIR_GET_FULL_ROW_HASHES_IN_BUCKETS);
+}
+future<repair_hash_set> messaging_service::send_repair_get_full_row_hashes_in_buckets(msg_addr id, uint32_t repair_meta_id, uint32_t nr_buckets, std::vector<uint32_t> buckets) {
+    return send_message<future<repair_hash_set>>(this, messaging_verb::REPAIR_GET_FULL_ROW_HASHES_IN_BUCKETS, std::move(id), repair_meta_id, nr_buckets, std::move(buckets));
+}
+
 // Wrapper for REPAIR_GET_COMBINED_ROW_HASH
 void messaging_service::register_repair_get_combined_row_hash(std::function<future<get_combined_row_hash_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func) {
     register_handler(this, messaging_verb::REPAIR_GET_COMBINED_ROW_HASH, std::move(func));
@@ -27,11 +27,14 @@
 #include <optional>
 #include <absl/container/btree_set.h>
 #include <seastar/net/tls.hh>
+#include <seastar/core/metrics_registration.hh>
+#include "dht/token-sharding.hh"
 
 // forward declarations
 namespace streaming {
     class prepare_message;
     enum class stream_mutation_fragments_cmd : uint8_t;
+    enum class stream_sstable_files_cmd : uint8_t;
 }
 
 namespace gms {
@@ -180,7 +183,14 @@ enum class messaging_verb : int32_t {
     FORWARD_REQUEST = 61,
     GET_GROUP0_UPGRADE_STATE = 62,
     DIRECT_FD_PING = 63,
-    LAST = 64,
+    READ_DATA_MULTI = 64,
+    MUTATION_MULTI = 65,
+    MUTATION_DONE_MULTI = 66,
+    REPAIR_GET_ROW_HASH_BUCKETS = 67,
+    REPAIR_GET_FULL_ROW_HASHES_IN_BUCKETS = 68,
+    STREAM_SSTABLE_FILES = 69,
+    HINT_MUTATION_MULTI = 70,
+    LAST = 71,
 };
 
 } // namespace netw
@@ -217,7 +227,19 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
 
     using msg_addr = netw::msg_addr;
     using inet_address = gms::inet_address;
-    using clients_map = std::unordered_map<msg_addr, shard_info, msg_addr::hash>;
+    // Unlike msg_addr::hash and equality, tells apart the connections to
+    // different shards of a node.
+    struct client_key_hash {
+        size_t operator()(const msg_addr& id) const noexcept {
+            return msg_addr::hash()(id) ^ id.cpu_id;
+        }
+    };
+    struct client_key_equal {
+        bool operator()(const msg_addr& x, const msg_addr& y) const noexcept {
+            return x.addr == y.addr && x.cpu_id == y.cpu_id;
+        }
+    };
+    using clients_map = std::unordered_map<msg_addr, shard_info, client_key_hash, client_key_equal>;
 
     // This should change only if serialization format changes
     static constexpr int32_t current_version = 0;
@@ -267,6 +289,13 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
         compress_what compress = compress_what::none;
         tcp_nodelay_what tcp_nodelay = tcp_nodelay_what::all;
         bool listen_on_broadcast_address = false;
+        // Compress connections across data centers with zstd rather than lz4,
+        // when they are compressed at all and the peer supports it.
+        bool zstd_across_dc = false;
+        // Open connections to the shard of a node which a request is for,
+        // for the verbs which are served by a specific shard, so that the
+        // receiving shard doesn't have to hand them over to it.
+        bool shard_aware_connections = false;
         size_t rpc_memory_limit = 1'000'000;
     };
 
@@ -297,6 +326,7 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     };
 private:
     config _cfg;
+    seastar::metrics::metric_groups _metrics;
     locator::shared_token_metadata* _token_metadata = nullptr;
     // map: Node broadcast address -> Node internal IP, and the reversed mapping, for communication within the same data center
     std::unordered_map<gms::inet_address, gms::inet_address> _preferred_ip_cache, _preferred_to_endpoint;
@@ -305,7 +335,12 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     ::shared_ptr<seastar::tls::server_credentials> _credentials;
     std::unique_ptr<seastar::tls::credentials_builder> _credentials_builder;
     std::array<std::unique_ptr<rpc_protocol_server_wrapper>, 2> _server_tls;
+    // Per node, keyed by msg_addr with a zero cpu_id.
     std::vector<clients_map> _clients;
+    // Per shard of a node, for shard-aware connections.
+    std::vector<clients_map> _shard_clients;
+    // The sharding of the nodes, as far as it is known.
+    std::unordered_map<gms::inet_address, dht::sharder> _peer_sharders;
     uint64_t _dropped_messages[static_cast<int32_t>(messaging_verb::LAST)] = {};
     bool _shutting_down = false;
     connection_drop_signal_t _connection_dropped;
@@ -336,6 +371,15 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     void cache_preferred_ip(gms::inet_address ep, gms::inet_address ip);
     gms::inet_address get_public_endpoint_for(const gms::inet_address&) const;
 
+    // Sets the sharding of a node, as learned through gossip, for shard-aware connections.
+    void set_peer_sharding(gms::inet_address ep, unsigned shard_count, unsigned sharding_ignore_msb_bits);
+    // Returns the address of the shard of ep which owns t, in a table with schema s,
+    // if shard-aware connections are enabled and the sharding of ep is known,
+    // and of shard 0 otherwise.
+    msg_addr shard_addr(gms::inet_address ep, const schema& s, const dht::token& t) const;
+    // Returns the sharding of ep, if shard-aware connections are enabled and it is known.
+    const dht::sharder* peer_sharder(gms::inet_address ep) const;
+
     future<> unregister_handler(messaging_verb verb);
 
     // Wrapper for PREPARE_MESSAGE verb
@@ -357,6 +401,14 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     rpc::sink<int32_t> make_sink_for_stream_mutation_fragments(rpc::source<frozen_mutation_fragment, rpc::optional<streaming::stream_mutation_fragments_cmd>>& source);
     future<std::tuple<rpc::sink<frozen_mutation_fragment, streaming::stream_mutation_fragments_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_mutation_fragments(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, uint64_t estimated_partitions, streaming::stream_reason reason, msg_addr id);
 
+    // Wrapper for STREAM_SSTABLE_FILES
+    // The sender sends the components of a single sstable, each a sequence of chunks of
+    // (component name, data). The receiver replies with a status code, like STREAM_MUTATION_FRAGMENTS.
+    void register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_schema_version schema_id, table_id cf_id, sstring sstable_version, streaming::stream_reason reason, rpc::source<sstring, bytes, streaming::stream_sstable_files_cmd> source)>&& func);
+    future<> unregister_stream_sstable_files();
+    rpc::sink<int32_t> make_sink_for_stream_sstable_files(rpc::source<sstring, bytes, streaming::stream_sstable_files_cmd>& source);
+    future<std::tuple<rpc::sink<sstring, bytes, streaming::stream_sstable_files_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_sstable_files(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, sstring sstable_version, streaming::stream_reason reason, msg_addr id);
+
     // Wrapper for REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM
     future<std::tuple<rpc::sink<repair_hash_with_cmd>, rpc::source<repair_row_on_wire_with_cmd>>> make_sink_and_source_for_repair_get_row_diff_with_rpc_stream(uint32_t repair_meta_id, msg_addr id);
     rpc::sink<repair_row_on_wire_with_cmd> make_sink_for_repair_get_row_diff_with_rpc_stream(rpc::source<repair_hash_with_cmd>& source);
@@ -388,6 +440,16 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> unregister_repair_get_full_row_hashes();
     future<repair_hash_set> send_repair_get_full_row_hashes(msg_addr id, uint32_t repair_meta_id);
 
+    // Wrapper for REPAIR_GET_ROW_HASH_BUCKETS
+    void register_repair_get_row_hash_buckets(std::function<future<std::vector<repair_hash>> (const rpc::client_info& cinfo, uint32_t repair_meta_id, uint32_t nr_buckets)>&& func);
+    future<> unregister_repair_get_row_hash_buckets();
+    future<std::vector<repair_hash>> send_repair_get_row_hash_buckets(msg_addr id, uint32_t repair_meta_id, uint32_t nr_buckets);
+
+    // Wrapper for REPAIR_GET_FULL_ROW_HASHES_IN_BUCKETS
+    void register_repair_get_full_row_hashes_in_buckets(std::function<future<repair_hash_set> (const rpc::client_info& cinfo, uint32_t repair_meta_id, uint32_t nr_buckets, std::vector<uint32_t> buckets)>&& func);
+    future<> unregister_repair_get_full_row_hashes_in_buckets();
+    future<repair_hash_set> send_repair_get_full_row_hashes_in_buckets(msg_addr id, uint32_t repair_meta_id, uint32_t nr_buckets, std::vector<uint32_t> buckets);
+
     // Wrapper for REPAIR_GET_COMBINED_ROW_HASH
     void register_repair_get_combined_row_hash(std::function<future<get_combined_row_hash_response> (const rpc::client_info& cinfo, uint32_t repair_meta_id, std::optional<repair_sync_boundary> common_sync_boundary)>&& func);
     future<> unregister_repair_get_combined_row_hash();
@@ -503,6 +565,12 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     template <typename Fn>
     requires std::is_invocable_r_v<bool, Fn, const shard_info&>
     void find_and_remove_client(clients_map& clients, msg_addr id, Fn&& filter);
+    // Removes the connections to any shard of id.addr which pass the filter.
+    template <typename Fn>
+    requires std::is_invocable_r_v<bool, Fn, const shard_info&>
+    void find_and_remove_shard_clients(clients_map& clients, msg_addr id, Fn&& filter);
+    // The shard of id a connection for verb should be to, if it should be shard-aware.
+    std::optional<unsigned> connection_shard(messaging_verb verb, msg_addr id) const;
     void do_start_listen();
 
     bool topology_known_for(inet_address) const;
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/byteorder.hh>
+
+#include <zstd.h>
+
+#include "message/zstd_rpc_compressor.hh"
+
+namespace netw {
+
+static const sstring zstd_rpc_compressor_name = "ZSTD";
+
+// Bounds the memory of the contexts of a connection; zstd would use windows
+// of up to a few MiB for large messages otherwise, on both ends.
+static constexpr int max_window_log = 17;
+
+// Size of the fragments of compressed and decompressed messages.
+static constexpr size_t max_chunk_size = 128 * 1024;
+
+static constexpr size_t size_header_size = sizeof(uint32_t);
+
+thread_local zstd_rpc_compressor::stats zstd_rpc_compressor::_shard_stats;
+
+static size_t check_zstd(size_t ret, const char* op) {
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(format("zstd_rpc_compressor: {} failed: {}", op, ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+template <typename Buf, typename Func>
+static void for_each_fragment(Buf& buf, Func func) {
+    if (auto* b = std::get_if<temporary_buffer<char>>(&buf.bufs)) {
+        func(*b);
+    } else {
+        for (auto& b : std::get<std::vector<temporary_buffer<char>>>(buf.bufs)) {
+            func(b);
+        }
+    }
+}
+
+void zstd_rpc_compressor::cctx_deleter::operator()(ZSTD_CCtx_s* cctx) const noexcept {
+    ZSTD_freeCCtx(cctx);
+}
+
+void zstd_rpc_compressor::dctx_deleter::operator()(ZSTD_DCtx_s* dctx) const noexcept {
+    ZSTD_freeDCtx(dctx);
+}
+
+zstd_rpc_compressor::zstd_rpc_compressor()
+        : _cctx(ZSTD_createCCtx())
+        , _dctx(ZSTD_createDCtx()) {
+    if (!_cctx || !_dctx) {
+        throw std::bad_alloc();
+    }
+    check_zstd(ZSTD_CCtx_setParameter(_cctx.get(), ZSTD_c_compressionLevel, compression_level), "setting the compression level");
+    check_zstd(ZSTD_CCtx_setParameter(_cctx.get(), ZSTD_c_windowLog, max_window_log), "setting the window size");
+}
+
+rpc::snd_buf zstd_rpc_compressor::compress(size_t head_space, rpc::snd_buf data) {
+    const size_t size = data.size;
+    check_zstd(ZSTD_CCtx_reset(_cctx.get(), ZSTD_reset_session_only), "resetting the compression context");
+    check_zstd(ZSTD_CCtx_setPledgedSrcSize(_cctx.get(), size), "setting the message size");
+
+    const size_t bound = ZSTD_compressBound(size);
+    std::vector<temporary_buffer<char>> chunks;
+    chunks.emplace_back(std::min(head_space + size_header_size + bound, max_chunk_size));
+    write_le<uint32_t>(chunks.back().get_write() + head_space, size);
+    ZSTD_outBuffer out{chunks.back().get_write(), chunks.back().size(), head_space + size_header_size};
+    size_t produced = 0;
+    auto next_chunk = [&] {
+        produced += out.pos - (chunks.size() == 1 ? head_space + size_header_size : 0);
+        chunks.emplace_back(std::clamp(bound - std::min(bound, produced), size_t(64), max_chunk_size));
+        out = ZSTD_outBuffer{chunks.back().get_write(), chunks.back().size(), 0};
+    };
+
+    for_each_fragment(data, [&] (temporary_buffer<char>& fragment) {
+        ZSTD_inBuffer in{fragment.get(), fragment.size(), 0};
+        while (in.pos < in.size) {
+            if (out.pos == out.size) {
+                next_chunk();
+            }
+            check_zstd(ZSTD_compressStream2(_cctx.get(), &out, &in, ZSTD_e_continue), "compressing");
+        }
+    });
+    ZSTD_inBuffer in{nullptr, 0, 0};
+    while (true) {
+        if (out.pos == out.size) {
+            next_chunk();
+        }
+        if (!check_zstd(ZSTD_compressStream2(_cctx.get(), &out, &in, ZSTD_e_end), "compressing")) {
+            break;
+        }
+    }
+    chunks.back().trim(out.pos);
+
+    size_t compressed_size = 0;
+    for (auto& c : chunks) {
+        compressed_size += c.size();
+    }
+    _shard_stats.bytes_compressed_in += size;
+    _shard_stats.bytes_compressed_out += compressed_size - head_space;
+
+    if (chunks.size() == 1) {
+        return rpc::snd_buf(std::move(chunks.front()));
+    }
+    rpc::snd_buf ret;
+    ret.size = compressed_size;
+    ret.bufs = std::move(chunks);
+    return ret;
+}
+
+rpc::rcv_buf zstd_rpc_compressor::decompress(rpc::rcv_buf data) {
+    if (data.size < size_header_size) {
+        throw std::runtime_error(format("zstd_rpc_compressor: message of {} bytes is too short", data.size));
+    }
+    check_zstd(ZSTD_DCtx_reset(_dctx.get(), ZSTD_reset_session_only), "resetting the decompression context");
+
+    // The size header may span fragments.
+    char header[size_header_size];
+    size_t header_pos = 0;
+    const size_t size = [&] {
+        for_each_fragment(data, [&] (temporary_buffer<char>& fragment) {
+            auto n = std::min(fragment.size(), size_header_size - header_pos);
+            std::copy_n(fragment.get(), n, header + header_pos);
+            header_pos += n;
+        });
+        return read_le<uint32_t>(header);
+    }();
+
+    std::vector<temporary_buffer<char>> chunks;
+    size_t produced = 0;
+    ZSTD_outBuffer out{nullptr, 0, 0};
+    auto next_chunk = [&] {
+        produced += out.pos;
+        if (produced == size) {
+            throw std::runtime_error(format("zstd_rpc_compressor: message is larger than its declared {} bytes", size));
+        }
+        chunks.emplace_back(std::min(size - produced, max_chunk_size));
+        out = ZSTD_outBuffer{chunks.back().get_write(), chunks.back().size(), 0};
+    };
+
+    size_t to_skip = size_header_size;
+    size_t ret = 1;
+    for_each_fragment(data, [&] (temporary_buffer<char>& fragment) {
+        auto skip = std::min(to_skip, fragment.size());
+        to_skip -= skip;
+        ZSTD_inBuffer in{fragment.get() + skip, fragment.size() - skip, 0};
+        while (in.pos < in.size) {
+            if (out.pos == out.size) {
+                next_chunk();
+            }
+            ret = check_zstd(ZSTD_decompressStream(_dctx.get(), &out, &in), "decompressing");
+        }
+    });
+    // Flush what zstd still holds, if it ran out of output space.
+    while (ret) {
+        if (out.pos != out.size) {
+            throw std::runtime_error("zstd_rpc_compressor: message is truncated");
+        }
+        next_chunk();
+        ZSTD_inBuffer in{nullptr, 0, 0};
+        ret = check_zstd(ZSTD_decompressStream(_dctx.get(), &out, &in), "decompressing");
+    }
+    produced += out.pos;
+    if (produced != size) {
+        throw std::runtime_error(format("zstd_rpc_compressor: message has {} bytes, but declared {}", produced, size));
+    }
+    if (!chunks.empty()) {
+        chunks.back().trim(out.pos);
+    }
+
+    _shard_stats.bytes_decompressed_in += data.size;
+    _shard_stats.bytes_decompressed_out += size;
+
+    if (chunks.size() <= 1) {
+        return rpc::rcv_buf(chunks.empty() ? temporary_buffer<char>() : std::move(chunks.front()));
+    }
+    rpc::rcv_buf rb;
+    rb.size = size;
+    rb.bufs = std::move(chunks);
+    return rb;
+}
+
+sstring zstd_rpc_compressor::name() const {
+    return zstd_rpc_compressor_name;
+}
+
+const sstring& zstd_rpc_compressor::factory::supported() const {
+    return zstd_rpc_compressor_name;
+}
+
+std::unique_ptr<rpc::compressor> zstd_rpc_compressor::factory::negotiate(sstring feature, bool is_server) const {
+    if (feature != zstd_rpc_compressor_name) {
+        return nullptr;
+    }
+    return std::make_unique<zstd_rpc_compressor>();
+}
+
+}
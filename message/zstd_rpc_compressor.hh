@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/rpc/rpc_types.hh>
+
+#include "seastarx.hh"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+namespace netw {
+
+// RPC compressor using zstd, for connections over slow links, where its
+// better compression ratio is worth its higher CPU cost, e.g. between data
+// centers. Each connection has its own compression and decompression
+// contexts, and messages are compressed independently of each other.
+//
+// A compressed message starts with the size of the uncompressed message,
+// as a little-endian 32-bit integer, followed by a zstd frame.
+class zstd_rpc_compressor final : public rpc::compressor {
+    struct cctx_deleter {
+        void operator()(ZSTD_CCtx_s* cctx) const noexcept;
+    };
+    struct dctx_deleter {
+        void operator()(ZSTD_DCtx_s* dctx) const noexcept;
+    };
+    std::unique_ptr<ZSTD_CCtx_s, cctx_deleter> _cctx;
+    std::unique_ptr<ZSTD_DCtx_s, dctx_deleter> _dctx;
+public:
+    static constexpr int compression_level = 3;
+
+    static thread_local struct stats {
+        // Sizes of sent messages, before and after compression.
+        uint64_t bytes_compressed_in = 0;
+        uint64_t bytes_compressed_out = 0;
+        // Sizes of received messages, before and after decompression.
+        uint64_t bytes_decompressed_in = 0;
+        uint64_t bytes_decompressed_out = 0;
+    } _shard_stats;
+
+    class factory final : public rpc::compressor::factory {
+    public:
+        virtual const sstring& supported() const override;
+        virtual std::unique_ptr<rpc::compressor> negotiate(sstring feature, bool is_server) const override;
+    };
+
+    zstd_rpc_compressor();
+
+    virtual rpc::snd_buf compress(size_t head_space, rpc::snd_buf data) override;
+    virtual rpc::rcv_buf decompress(rpc::rcv_buf data) override;
+    virtual sstring name() const override;
+
+    static const stats& shard_stats() { return _shard_stats; }
+};
+
+}
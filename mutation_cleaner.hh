@@ -16,6 +16,13 @@
 class mutation_cleaner;
 
 class mutation_cleaner_impl final {
+    // Snapshots whose version chain, counted from the newest version down to the
+    // version of the snapshot, is at least this long belong to partitions which
+    // are both read and updated heavily. Their versions are merged before those
+    // of other snapshots so that reads of such partitions don't have to walk
+    // many versions.
+    static constexpr unsigned long_version_chain = 4;
+
     using snapshot_list = boost::intrusive::slist<partition_snapshot,
         boost::intrusive::member_hook<partition_snapshot, boost::intrusive::slist_member_hook<>, &partition_snapshot::_cleaner_hook>,
                 boost::intrusive::cache_last<true>>;
@@ -91,7 +98,11 @@ void mutation_cleaner_impl::merge_and_destroy(partition_snapshot& ps) noexcept {
         // The snapshot must not be reachable by partitino_entry::read() after this,
         // which is ensured by slide_to_oldest() == stop_iteration::no.
         ps.migrate(&_region, _cleaner);
-        _worker_state->snapshots.push_back(ps);
+        if (ps.newer_versions_count(long_version_chain) >= long_version_chain) {
+            _worker_state->snapshots.push_front(ps);
+        } else {
+            _worker_state->snapshots.push_back(ps);
+        }
         _worker_state->cv.signal();
     }
 }
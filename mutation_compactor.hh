@@ -141,7 +141,8 @@ class compact_mutation_state {
     uint64_t _row_limit{};
     uint32_t _partition_limit{};
     uint64_t _partition_row_limit{};
-    tombstone_gc_state _tombstone_gc_state;
+    // Taken once, partitions are compacted in token order.
+    tombstone_gc_state::table_snapshot _tombstone_gc_state;
 
     tombstone _partition_tombstone;
 
@@ -244,7 +245,7 @@ class compact_mutation_state {
             return _gc_before.value();
         } else {
             if (_dk) {
-                _gc_before = _tombstone_gc_state.get_gc_before_for_key(_schema.shared_from_this(), *_dk, _query_time);
+                _gc_before = _tombstone_gc_state.get_gc_before_for_key(*_dk, _query_time);
                 return _gc_before.value();
             } else {
                 return gc_clock::time_point::min();
@@ -277,7 +278,7 @@ class compact_mutation_state {
         , _row_limit(limit)
         , _partition_limit(partition_limit)
         , _partition_row_limit(_slice.options.contains(query::partition_slice::option::distinct) ? 1 : slice.partition_row_limit())
-        , _tombstone_gc_state(nullptr)
+        , _tombstone_gc_state(tombstone_gc_state(nullptr).snapshot_for_table(s.shared_from_this()))
         , _last_dk({dht::token(), partition_key::make_empty()})
         , _last_pos(position_in_partition::for_partition_end())
         , _validator("mutation_compactor for read", _schema, mutation_fragment_stream_validation_level::token)
@@ -293,7 +294,7 @@ class compact_mutation_state {
         , _get_max_purgeable(std::move(get_max_purgeable))
         , _can_gc([this] (tombstone t) { return can_gc(t); })
         , _slice(s.full_slice())
-        , _tombstone_gc_state(gc_state)
+        , _tombstone_gc_state(gc_state.snapshot_for_table(s.shared_from_this()))
         , _last_dk({dht::token(), partition_key::make_empty()})
         , _last_pos(position_in_partition::for_partition_end())
         , _collector(std::make_unique<mutation_compactor_garbage_collector>(_schema))
@@ -859,7 +859,7 @@ void appending_hash<row>::operator()(Hasher& h, const row& cells, const schema&
                 if (cell_and_hash->hash) {
                     feed_hash(h, *cell_and_hash->hash);
                 } else {
-                    Hasher cellh;
+                    query::cell_hasher<Hasher> cellh;
                     feed_hash(cellh, cell_and_hash->cell.as_atomic_cell(def), def);
                     feed_hash(h, cellh.finalize_uint64());
                 }
@@ -873,7 +873,7 @@ void appending_hash<row>::operator()(Hasher& h, const row& cells, const schema&
                 if (cell_and_hash->hash) {
                     feed_hash(h, *cell_and_hash->hash);
                 } else {
-                    Hasher cellh;
+                    query::cell_hasher<Hasher> cellh;
                     feed_hash(cellh, cm, def);
                     feed_hash(h, cellh.finalize_uint64());
                 }
@@ -1558,6 +1558,51 @@ rows_entry::rows_entry(rows_entry&& o) noexcept
 {
 }
 
+uint64_t rows_entry::key_prefix(position_in_partition_view pos) noexcept {
+    switch (pos.region()) {
+    case partition_region::partition_start:
+    case partition_region::static_row:
+        return 0;
+    case partition_region::partition_end:
+        return std::numeric_limits<uint64_t>::max();
+    case partition_region::clustered:
+        break;
+    }
+
+    managed_bytes_view v = pos.has_key() ? pos.key().representation() : managed_bytes_view();
+    if (v.empty()) {
+        return pos.get_bound_weight() == bound_weight::after_all_prefixed ? std::numeric_limits<uint64_t>::max() : 0;
+    }
+
+    // The key is serialized by compound_type, each component as its length,
+    // a big endian uint16_t, followed by its bytes.
+    std::array<uint8_t, sizeof(uint16_t) + sizeof(uint64_t)> buf{};
+    size_t n = 0;
+    while (n < buf.size() && !v.empty()) {
+        auto frag = v.current_fragment();
+        auto len = std::min(frag.size(), buf.size() - n);
+        std::copy_n(frag.begin(), len, buf.begin() + n);
+        n += len;
+        v.remove_prefix(len);
+    }
+
+    size_t size = (size_t(buf[0]) << 8) | buf[1];
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < sizeof(uint64_t); i++) {
+        prefix = (prefix << 8) | (i < size ? buf[sizeof(uint16_t) + i] : 0);
+    }
+    return prefix;
+}
+
+bool rows_entry::tri_compare::prefix_ordered(const schema& s) noexcept {
+    if (s.clustering_key_size() == 0) {
+        return false;
+    }
+    // Reversed types are different objects, so they are excluded too.
+    auto& t = s.clustering_column_at(0).type;
+    return t == bytes_type || t == utf8_type || t == ascii_type;
+}
+
 void rows_entry::replace_with(rows_entry&& o) noexcept {
     swap(o);
     _row = std::move(o._row);
@@ -2580,9 +2625,13 @@ stop_iteration mutation_cleaner_impl::merge_some() noexcept {
         return stop_iteration::yes;
     }
     partition_snapshot& snp = _worker_state->snapshots.front();
+    _worker_state->snapshots.pop_front();
     if (merge_some(snp) == stop_iteration::yes) {
-        _worker_state->snapshots.pop_front();
         lw_shared_ptr<partition_snapshot>::dispose(&snp);
+    } else {
+        // Let other snapshots make progress before continuing with this one, so that
+        // merging of a large partition doesn't hold back the versions of small, hot ones.
+        _worker_state->snapshots.push_back(snp);
     }
     return stop_iteration::no;
 }
@@ -19,6 +19,7 @@
 #include <seastar/util/optimized_optional.hh>
 
 #include "schema_fwd.hh"
+#include "caching_options.hh"
 #include "tombstone.hh"
 #include "keys.hh"
 #include "position_in_partition.hh"
@@ -912,7 +913,13 @@ class rows_entry final : public evictable {
         // Marks a dummy entry which is after_all_clustered_rows() position.
         // Needed so that eviction, which can't use comparators, can check if it's dealing with it.
         bool _last_dummy : 1;
-        flags() : _before_ck(0), _after_ck(0), _continuous(true), _dummy(false), _last_dummy(false) { }
+        // See spare_from_eviction().
+        uint8_t _eviction_priority : 2;
+        uint8_t _times_spared : 2;
+        // Read since it was last spared, see cache_tracker::eviction_policy::second_chance.
+        bool _referenced : 1;
+        flags() : _before_ck(0), _after_ck(0), _continuous(true), _dummy(false), _last_dummy(false)
+                , _eviction_priority(0), _times_spared(0), _referenced(false) { }
     } _flags{};
 public:
     struct last_dummy_tag {};
@@ -963,6 +970,16 @@ class rows_entry final : public evictable {
     position_in_partition_view position() const {
         return position_in_partition_view(partition_region::clustered, bound_weight(_flags._after_ck - _flags._before_ck), &_key);
     }
+    // The first 8 bytes of the first clustering key component, big endian and
+    // padded with zeroes, the positions before and after all keys getting the
+    // smallest and the greatest prefix. Follows the order of the positions
+    // when the first clustering column is compared as bytes, see
+    // tri_compare::key_prefix(). Keeping it in the rows tree's nodes lets the
+    // lookups skip most of the key comparisons.
+    static uint64_t key_prefix(position_in_partition_view pos) noexcept;
+    uint64_t key_prefix() const noexcept {
+        return key_prefix(position());
+    }
 
     is_continuous continuous() const { return is_continuous(_flags._continuous); }
     void set_continuous(bool value) { _flags._continuous = value; }
@@ -971,6 +988,20 @@ class rows_entry final : public evictable {
     bool is_last_dummy() const { return _flags._last_dummy; }
     void set_dummy(bool value) { _flags._dummy = value; }
     void set_dummy(is_dummy value) { _flags._dummy = bool(value); }
+    // Sets the priority of the table, see caching_options::eviction_priority().
+    // Like a touch, also gives back the chances to be spared already used up.
+    void set_eviction_priority(unsigned p) noexcept {
+        _flags._eviction_priority = std::min(p, caching_options::max_eviction_priority);
+        _flags._times_spared = 0;
+    }
+    unsigned eviction_priority() const noexcept { return _flags._eviction_priority; }
+    void set_referenced() noexcept { _flags._referenced = true; }
+    bool referenced() const noexcept { return _flags._referenced; }
+    // An entry is spared once if referenced, and then as many times as its
+    // eviction priority, before it's evicted, unless accessed in between.
+    // The priority of a table thus scales the share of the cache its rows
+    // get, without partitioning the LRU.
+    bool spare_from_eviction() noexcept override;
     void replace_with(rows_entry&& other) noexcept;
 
     void apply(row_tombstone t) {
@@ -984,7 +1015,21 @@ class rows_entry final : public evictable {
     }
     struct tri_compare {
         position_in_partition::tri_compare _c;
-        explicit tri_compare(const schema& s) : _c(s) {}
+        bool _prefix_ordered;
+        explicit tri_compare(const schema& s) : _c(s), _prefix_ordered(prefix_ordered(s)) {}
+
+        // Whether the key prefixes follow the order of the positions.
+        static bool prefix_ordered(const schema& s) noexcept;
+
+        std::optional<uint64_t> key_prefix(const rows_entry& e) const noexcept {
+            return _prefix_ordered ? std::make_optional(e.key_prefix()) : std::nullopt;
+        }
+        std::optional<uint64_t> key_prefix(const clustering_key& key) const noexcept {
+            return key_prefix(position_in_partition_view::for_key(key));
+        }
+        std::optional<uint64_t> key_prefix(position_in_partition_view p) const noexcept {
+            return _prefix_ordered ? std::make_optional(rows_entry::key_prefix(p)) : std::nullopt;
+        }
 
         std::strong_ordering operator()(const rows_entry& e1, const rows_entry& e2) const {
             return _c(e1.position(), e2.position());
@@ -121,9 +121,15 @@ collection_mutation read_collection_cell(const abstract_type& type, ser::collect
 template<typename Visitor>
 void read_and_visit_row(ser::row_view rv, const column_mapping& cm, column_kind kind, Visitor&& visitor)
 {
+    // The columns of the row are looked up once, rather than by kind for
+    // each of its cells.
+    auto columns = cm.columns_of(kind);
     for (auto&& cv : rv.columns()) {
         auto id = cv.id();
-        auto& col = cm.column_at(kind, id);
+        if (id >= columns.size()) [[unlikely]] {
+            throw std::out_of_range(format("{} column id {:d} >= {:d}", kind == column_kind::regular_column ? "regular" : "static", id, columns.size()));
+        }
+        auto& col = columns[id];
 
         class atomic_cell_or_collection_visitor : public boost::static_visitor<> {
             Visitor& _visitor;
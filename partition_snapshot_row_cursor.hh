@@ -55,6 +55,8 @@ class partition_snapshot_row_weakref final {
     bool valid(partition_snapshot& snp) { return snp.get_change_mark() == _change_mark; }
     // Call only when valid.
     bool is_in_latest_version() const { return _in_latest; }
+    // Call only when valid.
+    mutation_partition::rows_type::iterator iterator() const { return _it; }
     // Brings the object back to validity and returns true iff the snapshot contains the row.
     // When not pointing at a row, returns false.
     bool refresh(partition_snapshot& snp) {
@@ -179,6 +181,16 @@ class partition_snapshot_row_cursor final {
             }
             return false;
         }
+        if (_heap.size() == 1) {
+            // Fast path for single-version snapshots, there is nothing to merge with.
+            memory::on_alloc_point();
+            _dummy = bool(_heap.back().it->dummy());
+            _continuous |= bool(_heap.back().continuous);
+            _current_row.push_back(_heap.back());
+            _heap.pop_back();
+            _position = position_in_partition(_current_row[0].it->position());
+            return true;
+        }
         version_heap_less_compare heap_less(*this);
         position_in_partition::equal_compare eq(*_snp.schema());
         do {
@@ -535,7 +547,7 @@ class partition_snapshot_row_cursor final {
             auto latest_i = get_iterator_in_latest_version();
             rows_entry& latest = *latest_i;
             if (_snp.at_latest_version()) {
-                _snp.tracker()->touch(latest);
+                _snp.tracker()->touch(latest, _schema);
             }
             return {latest, false};
         } else {
@@ -558,14 +570,14 @@ class partition_snapshot_row_cursor final {
                 rows_entry::tri_compare cmp(*_snp.schema());
                 auto res = rows.insert(std::move(e), cmp);
                 if (res.second) {
-                    _snp.tracker()->insert(re);
+                    _snp.tracker()->insert(re, _schema);
                 }
                 return {*res.first, res.second};
             } else {
                 auto latest_i = get_iterator_in_latest_version();
                 e->set_continuous(latest_i && latest_i->continuous());
                 rows.insert_before(latest_i, std::move(e));
-                _snp.tracker()->insert(re);
+                _snp.tracker()->insert(re, _schema);
                 return {re, true};
             }
         }
@@ -606,7 +618,7 @@ class partition_snapshot_row_cursor final {
         auto e = alloc_strategy_unique_ptr<rows_entry>(current_allocator().construct<rows_entry>(_schema, pos, is_dummy(!pos.is_clustering_row()),
             is_continuous(latest_i && latest_i->continuous())));
         auto e_i = rows.insert_before(latest_i, std::move(e));
-        _snp.tracker()->insert(*e_i);
+        _snp.tracker()->insert(*e_i, _schema);
         return ensure_result{*e_i, true};
     }
 
@@ -617,7 +629,7 @@ class partition_snapshot_row_cursor final {
         // could result violate ordering invariant for the LRU, which states that older versions
         // must be evicted first. Needed to keep the snapshot consistent.
         if (_snp.at_latest_version() && is_in_latest_version()) {
-            _snp.tracker()->touch(*get_iterator_in_latest_version());
+            _snp.tracker()->touch(*get_iterator_in_latest_version(), _schema);
         }
     }
 
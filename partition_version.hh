@@ -380,6 +380,16 @@ class partition_snapshot : public enable_lw_shared_from_this<partition_snapshot>
 
     unsigned version_count();
 
+    // Returns the number of versions newer than the version of this snapshot,
+    // counting no further than limit.
+    unsigned newer_versions_count(unsigned limit) const noexcept {
+        unsigned count = 0;
+        for (auto v = version()->prev(); v && count < limit; v = v->prev()) {
+            ++count;
+        }
+        return count;
+    }
+
     bool at_latest_version() const {
         return _entry != nullptr;
     }
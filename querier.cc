@@ -240,6 +240,7 @@ void querier_cache::insert_querier(
 
     tracing::trace(trace_state, "Caching querier with key {}", key);
 
+    q.on_pause();
     auto& sem = q.permit().semaphore();
 
     auto irh = sem.register_inactive_read(querier_utils::get_reader(q));
@@ -276,6 +277,9 @@ void querier_cache::insert_querier(
     };
 
     sem.set_notify_handler(irh, std::move(notify_handler), ttl);
+    if (auto pause = it->second->expected_pause()) {
+        sem.set_expected_pause(irh, *pause);
+    }
     querier_utils::set_inactive_read_handle(*it->second, std::move(irh));
     cleanup_index.cancel();
     cleanup_irh.cancel();
@@ -329,6 +333,8 @@ std::optional<Querier> querier_cache::lookup_querier(
     reader_opt->set_timeout(timeout);
     querier_utils::set_reader(q, std::move(*reader_opt));
     --stats.population;
+    ++stats.resumes;
+    stats.resumed_pause_ms += std::chrono::duration_cast<std::chrono::milliseconds>(q.on_resume()).count();
 
     const auto can_be_used = can_be_used_for_page(q, s, ranges.front(), slice);
     if (can_be_used == can_use::yes) {
@@ -69,6 +69,9 @@ class querier_base {
     std::variant<flat_mutation_reader_v2, reader_concurrency_semaphore::inactive_read_handle> _reader;
     dht::partition_ranges_view _query_ranges;
     querier_config _qr_config;
+    lowres_clock::time_point _paused_at;
+    // Moving average of the pauses between the pages of the query.
+    std::optional<lowres_clock::duration> _expected_pause;
 
 public:
     querier_base(reader_permit permit, lw_shared_ptr<const dht::partition_range> range,
@@ -120,6 +123,25 @@ class querier_base {
         return _permit.consumed_resources().memory;
     }
 
+    // To be called when the querier is saved at the end of a page.
+    void on_pause() noexcept {
+        _paused_at = lowres_clock::now();
+    }
+
+    // To be called when the querier is looked up for the next page.
+    // Returns how long the querier was paused for.
+    lowres_clock::duration on_resume() noexcept {
+        const auto pause = lowres_clock::now() - _paused_at;
+        _expected_pause = _expected_pause ? (*_expected_pause * 3 + pause) / 4 : pause;
+        return pause;
+    }
+
+    // How long the querier is expected to be paused for, based on the pauses
+    // between its previous pages. Unknown before the first resume.
+    std::optional<lowres_clock::duration> expected_pause() const noexcept {
+        return _expected_pause;
+    }
+
     future<> close() noexcept;
 };
 
@@ -183,6 +205,7 @@ class querier : public querier_base {
                     cstats.clustering_rows.live,
                     cstats.clustering_rows.dead,
                     cstats.range_tombstones);
+            tracing::trace(trace_ptr, "Read resource usage so far: {}", _permit.resource_usage());
             auto dead = cstats.static_rows.dead + cstats.clustering_rows.dead + cstats.range_tombstones;
             if (_qr_config.tombstone_warn_threshold > 0 && dead >= _qr_config.tombstone_warn_threshold) {
                 auto live = cstats.static_rows.live + cstats.clustering_rows.live;
@@ -309,6 +332,10 @@ class querier_cache {
         uint64_t resource_based_evictions = 0;
         // The number of queriers currently in the cache.
         uint64_t population = 0;
+        // The number of queriers found in the cache, to serve the next page.
+        uint64_t resumes = 0;
+        // The total time the resumed queriers spent in the cache, in milliseconds.
+        uint64_t resumed_pause_ms = 0;
     };
 
     using index = std::unordered_multimap<query_id, std::unique_ptr<querier_base>>;
@@ -403,6 +403,11 @@ struct forward_request {
     db::consistency_level cl;
     lowres_system_clock::time_point timeout;
     std::optional<std::vector<aggregation_info>> aggregation_infos;
+    // Names of the GROUP BY columns, in the order of the clause. They always
+    // include the whole partition key, so every group lies within a single
+    // partition. If not empty, the result has a row per group, see
+    // forward_result::grouped_results.
+    std::vector<sstring> group_by_column_names;
 };
 
 std::ostream& operator<<(std::ostream& out, const forward_request& r);
@@ -412,6 +417,10 @@ std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_i
 struct forward_result {
     // vector storing query result for each selected column
     std::vector<bytes_opt> query_results;
+    // For requests with GROUP BY (query_results is empty then): a row per
+    // group, made of the values of the GROUP BY columns followed by the
+    // result of each reduction.
+    std::vector<std::vector<bytes_opt>> grouped_results;
 
     struct printer {
         const std::vector<::shared_ptr<db::functions::aggregate_function>> functions;
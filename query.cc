@@ -95,6 +95,9 @@ std::ostream& operator<<(std::ostream& out, const forward_request& r) {
     if(r.aggregation_infos) {
         out << ", aggregation_infos=[" << join(",", r.aggregation_infos.value()) << "]";
     }
+    if (!r.group_by_column_names.empty()) {
+        out << ", group_by=[" << join(",", r.group_by_column_names) << "]";
+    }
     return out << ", cmd=" << r.cmd
         << ", pr=" << r.pr
         << ", cl=" << r.cl
@@ -414,6 +417,9 @@ foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
 }
 
 std::ostream& operator<<(std::ostream& out, const query::forward_result::printer& p) {
+    if (!p.res.grouped_results.empty()) {
+        return out << "[" << p.res.grouped_results.size() << " groups]";
+    }
     if (p.functions.size() != p.res.query_results.size()) {
         return out << "[malformed forward_result (" << p.res.query_results.size()
             << " results, " << p.functions.size() << " aggregates)]";
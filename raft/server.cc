@@ -152,6 +152,10 @@ class server_impl : public rpc_server, public server {
         uint64_t sm_load_snapshot = 0;
         uint64_t truncate_persisted_log = 0;
         uint64_t persisted_log_entries = 0;
+        // Calls to store_log_entries(), each storing all the entries
+        // appended since the previous one, and the time spent in them.
+        uint64_t persisted_log_entry_batches = 0;
+        uint64_t persisted_log_entries_latency_us = 0;
         uint64_t queue_entries_for_apply = 0;
         uint64_t applied_entries = 0;
         uint64_t snapshots_taken = 0;
@@ -963,10 +967,14 @@ future<> server_impl::io_fiber(index_t last_stable) {
 
                 // Combine saving and truncating into one call?
                 // will require persistence to keep track of last idx
+                auto store_start = std::chrono::steady_clock::now();
                 co_await _persistence->store_log_entries(entries);
 
                 last_stable = (*entries.crbegin())->idx;
                 _stats.persisted_log_entries += entries.size();
+                _stats.persisted_log_entry_batches++;
+                _stats.persisted_log_entries_latency_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - store_start).count();
             }
 
             // Update RPC server address mappings. Add servers which are joining
@@ -1530,6 +1538,10 @@ void server_impl::register_metrics() {
              sm::description("how many times log was truncated on storage"), {server_id_label(_id)}),
         sm::make_total_operations("persisted_log_entries", _stats.persisted_log_entries,
              sm::description("how many log entries were persisted"), {server_id_label(_id)}),
+        sm::make_total_operations("persisted_log_entry_batches", _stats.persisted_log_entry_batches,
+             sm::description("how many times log entries were persisted, all the entries appended since the previous time at once"), {server_id_label(_id)}),
+        sm::make_counter("persisted_log_entries_latency_us", _stats.persisted_log_entries_latency_us,
+             sm::description("total time spent persisting log entries, in microseconds"), {server_id_label(_id)}),
         sm::make_total_operations("queue_entries_for_apply", _stats.queue_entries_for_apply,
              sm::description("how many log entries were queued to be applied"), {server_id_label(_id)}),
         sm::make_total_operations("applied_entries", _stats.applied_entries,
@@ -347,6 +347,26 @@ range_tombstone_list::upper_slice(const schema& s, position_in_partition_view af
 }
 
 
+std::optional<range_tombstone_list::range_tombstones_type::iterator>
+range_tombstone_list::disjoint_insert_position(const schema& s, const range_tombstone& rt) {
+    position_in_partition::tri_compare cmp(s);
+    auto it = _tombstones.upper_bound(rt.position(), pos_order_by_end{s});
+    if (it != _tombstones.end()) {
+        auto c = cmp(it->position(), rt.end_position());
+        if (c < 0 || (c == 0 && it->tombstone().tomb == rt.tomb)) {
+            return std::nullopt;
+        }
+    }
+    if (it != _tombstones.begin()) {
+        auto prev = std::prev(it);
+        // prev->end_position() <= rt.position() by the choice of it.
+        if (prev->tombstone().tomb == rt.tomb && cmp(prev->end_position(), rt.position()) == 0) {
+            return std::nullopt;
+        }
+    }
+    return it;
+}
+
 range_tombstone_list::iterator
 range_tombstone_list::erase(const_iterator a, const_iterator b) {
     return _tombstones.erase_and_dispose(a, b, current_deleter<range_tombstone_entry>());
@@ -442,9 +462,18 @@ stop_iteration range_tombstone_list::apply_monotonically(const schema& s, range_
     auto del = current_deleter<range_tombstone_entry>();
     auto it = list.begin();
     while (it != list.end()) {
-        // FIXME: Optimize by stealing the entry
-        apply_monotonically(s, it->tombstone());
-        it = list._tombstones.erase_and_dispose(it, del);
+        auto next = std::next(it);
+        if (auto pos = disjoint_insert_position(s, it->tombstone())) {
+            // Tombstones which don't overlap with any of ours, like the separate
+            // time range deletions of a partition, are moved over without copying.
+            range_tombstone_entry& rt = *it;
+            list._tombstones.erase(it);
+            _tombstones.insert_before(*pos, rt);
+        } else {
+            apply_monotonically(s, it->tombstone());
+            list._tombstones.erase_and_dispose(it, del);
+        }
+        it = next;
         if (preemptible && need_preempt()) {
             return stop_iteration::no;
         }
@@ -459,7 +488,17 @@ void range_tombstone_list::apply_monotonically(const schema& s, const range_tomb
 }
 
 void range_tombstone_list::apply_monotonically(const schema& s, const range_tombstone& rt) {
-    // FIXME: Optimize given this has relaxed exception guarantees.
+    position_in_partition::less_compare less(s);
+    if (!less(rt.position(), rt.end_position())) {
+        return;
+    }
+    if (auto pos = disjoint_insert_position(s, rt)) {
+        // Nothing is erased, so there is nothing which would have to be restored on failure.
+        auto e = construct_range_tombstone_entry(rt);
+        _tombstones.insert_before(*pos, *e);
+        e.release();
+        return;
+    }
     // Note that apply() doesn't have monotonic guarantee because it doesn't restore erased entries.
     reverter rev(s, *this);
     apply_reversibly(s, rt.start, rt.start_kind, rt.end, rt.end_kind, rt.tomb, rev);
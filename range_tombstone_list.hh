@@ -14,6 +14,7 @@
 #include "utils/preempt.hh"
 #include "utils/chunked_vector.hh"
 #include <iosfwd>
+#include <optional>
 #include <variant>
 
 class position_in_partition_view;
@@ -294,4 +295,8 @@ class range_tombstone_list final {
                      reverter& rev);
 
     range_tombstones_type::iterator find(const schema& s, const range_tombstone_entry& rt);
+
+    // Returns the position before which rt can be linked as is, without being
+    // split or merged with any of the tombstones in this list, if there is one.
+    std::optional<range_tombstones_type::iterator> disjoint_insert_position(const schema& s, const range_tombstone& rt);
 };
@@ -26,6 +26,11 @@ std::ostream& operator<<(std::ostream& os , const reader_resources& r) {
     return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const reader_resource_usage& u) {
+    fmt::print(os, "{}us cpu, {} disk read(s) of {} byte(s)", u.cpu_time.count(), u.disk_reads, u.disk_bytes_read);
+    return os;
+}
+
 reader_permit::resource_units::resource_units(reader_permit permit, reader_resources res, already_consumed_tag)
     : _permit(std::move(permit)), _resources(res) {
 }
@@ -93,8 +98,21 @@ class reader_permit::impl
     size_t _requested_memory = 0;
     std::optional<shared_future<>> _memory_future;
     uint64_t _oom_kills = 0;
+    std::optional<db::timeout_clock::time_point> _admission_time;
+    bool _was_inactive = false;
+    reader_resource_usage _usage;
+    // Since when the permit is active/used, if it is.
+    std::chrono::steady_clock::time_point _used_since;
 
 private:
+    void set_state(reader_permit::state st) noexcept {
+        if (_state == reader_permit::state::active_used && st != reader_permit::state::active_used) {
+            _usage.cpu_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _used_since);
+        } else if (_state != reader_permit::state::active_used && st == reader_permit::state::active_used) {
+            _used_since = std::chrono::steady_clock::now();
+        }
+        _state = st;
+    }
     void on_permit_used() {
         _semaphore.on_permit_used();
         _marked_as_used = true;
@@ -113,19 +131,19 @@ class reader_permit::impl
     }
     void on_permit_active() {
         if (_used_branches) {
-            _state = reader_permit::state::active_used;
+            set_state(reader_permit::state::active_used);
             on_permit_used();
             if (_blocked_branches) {
-                _state = reader_permit::state::active_blocked;
+                set_state(reader_permit::state::active_blocked);
                 on_permit_blocked();
             }
         } else {
-            _state = reader_permit::state::active_unused;
+            set_state(reader_permit::state::active_unused);
         }
     }
 
     void on_permit_inactive(reader_permit::state st) {
-        _state = st;
+        set_state(st);
         if (_marked_as_blocked) {
             on_permit_unblocked();
         }
@@ -206,6 +224,14 @@ class reader_permit::impl
         return _op_name_view;
     }
 
+    // The time since admission, if the permit was admitted and never paused.
+    std::optional<db::timeout_clock::duration> read_duration() const {
+        if (!_admission_time || _was_inactive) {
+            return std::nullopt;
+        }
+        return db::timeout_clock::now() - *_admission_time;
+    }
+
     reader_permit::state get_state() const {
         return _state;
     }
@@ -224,6 +250,7 @@ class reader_permit::impl
         on_permit_active();
         consume(_base_resources);
         _base_resources_consumed = true;
+        _admission_time = db::timeout_clock::now();
     }
 
     void on_granted_memory() {
@@ -240,6 +267,7 @@ class reader_permit::impl
     void on_register_as_inactive() {
         assert(_state == reader_permit::state::active_unused || _state == reader_permit::state::active_used);
         on_permit_inactive(reader_permit::state::inactive);
+        _was_inactive = true;
     }
 
     void on_unregister_as_inactive() {
@@ -249,7 +277,7 @@ class reader_permit::impl
 
     void on_evicted() {
         assert(_state == reader_permit::state::inactive);
-        _state = reader_permit::state::evicted;
+        set_state(reader_permit::state::evicted);
         if (_base_resources_consumed) {
             signal(_base_resources);
             _base_resources_consumed = false;
@@ -299,10 +327,10 @@ class reader_permit::impl
     void mark_used() noexcept {
         ++_used_branches;
         if (!_marked_as_used && _state == reader_permit::state::active_unused) {
-            _state = reader_permit::state::active_used;
+            set_state(reader_permit::state::active_used);
             on_permit_used();
             if (_blocked_branches && !_marked_as_blocked) {
-                _state = reader_permit::state::active_blocked;
+                set_state(reader_permit::state::active_blocked);
                 on_permit_blocked();
             }
         }
@@ -318,7 +346,7 @@ class reader_permit::impl
             if (_marked_as_blocked) {
                 on_permit_unblocked();
             }
-            _state = reader_permit::state::active_unused;
+            set_state(reader_permit::state::active_unused);
             on_permit_unused();
         }
     }
@@ -326,7 +354,7 @@ class reader_permit::impl
     void mark_blocked() noexcept {
         ++_blocked_branches;
         if (_blocked_branches == 1 && _state == reader_permit::state::active_used) {
-            _state = reader_permit::state::active_blocked;
+            set_state(reader_permit::state::active_blocked);
             on_permit_blocked();
         }
     }
@@ -335,7 +363,7 @@ class reader_permit::impl
         assert(_blocked_branches);
         --_blocked_branches;
         if (_marked_as_blocked && !_blocked_branches) {
-            _state = reader_permit::state::active_used;
+            set_state(reader_permit::state::active_used);
             on_permit_unblocked();
         }
     }
@@ -388,6 +416,19 @@ class reader_permit::impl
         }
     }
 
+    void on_disk_read(size_t bytes) noexcept {
+        ++_usage.disk_reads;
+        _usage.disk_bytes_read += bytes;
+    }
+
+    reader_resource_usage resource_usage() const noexcept {
+        auto usage = _usage;
+        if (_state == reader_permit::state::active_used) {
+            usage.cpu_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _used_since);
+        }
+        return usage;
+    }
+
     bool on_oom_kill() noexcept {
         return !bool(_oom_kills++);
     }
@@ -439,6 +480,10 @@ reader_concurrency_semaphore& reader_permit::semaphore() {
     return _impl->semaphore();
 }
 
+size_t reader_permit::reader_buffer_size(size_t default_size) const noexcept {
+    return _impl->semaphore().reader_buffer_size(default_size);
+}
+
 reader_permit::state reader_permit::get_state() const {
     return _impl->get_state();
 }
@@ -527,6 +572,14 @@ void reader_permit::on_finish_sstable_read() noexcept {
     _impl->on_finish_sstable_read();
 }
 
+void reader_permit::on_disk_read(size_t bytes) noexcept {
+    _impl->on_disk_read(bytes);
+}
+
+reader_resource_usage reader_permit::resource_usage() const noexcept {
+    return _impl->resource_usage();
+}
+
 std::ostream& operator<<(std::ostream& os, reader_permit::state s) {
     switch (s) {
         case reader_permit::state::waiting_for_admission:
@@ -834,6 +887,10 @@ void reader_concurrency_semaphore::set_notify_handler(inactive_read_handle& irh,
     }
 }
 
+void reader_concurrency_semaphore::set_expected_pause(inactive_read_handle& irh, lowres_clock::duration pause) noexcept {
+    irh._irp->expected_pause = pause;
+}
+
 flat_mutation_reader_v2_opt reader_concurrency_semaphore::unregister_inactive_read(inactive_read_handle irh) {
     if (!irh) {
         return {};
@@ -952,6 +1009,40 @@ void reader_concurrency_semaphore::evict(inactive_read& ir, evict_reason reason)
     close_reader(detach_inactive_reader(ir, reason));
 }
 
+// Of the oldest few inactive reads, pick the one which is the least likely
+// to be resumed soon, weighted by the memory it would free: the score of a
+// read is the memory it holds times how long it has been inactive for,
+// relative to how long it is expected to be. Reads with no expectation are
+// assumed to be due. On equal scores, the oldest read goes first, as with
+// plain FIFO eviction. Only a bounded number of reads is looked at, so that
+// picking stays cheap no matter how many reads are inactive.
+reader_concurrency_semaphore::inactive_read& reader_concurrency_semaphore::pick_inactive_read_to_evict() noexcept {
+    static constexpr unsigned max_candidates = 8;
+    const auto now = lowres_clock::now();
+    const auto score = [now] (const inactive_read& ir) {
+        const auto memory = double(ir.reader.permit().consumed_resources().memory + 1);
+        if (!ir.expected_pause) {
+            return memory;
+        }
+        // Add a millisecond, so that reads just registered, or paused for
+        // very short, don't result in a division by zero or huge ratios.
+        const auto ms = [] (lowres_clock::duration d) {
+            return double(std::chrono::duration_cast<std::chrono::milliseconds>(d).count() + 1);
+        };
+        return memory * ms(now - ir.registered_at) / ms(*ir.expected_pause);
+    };
+    auto it = _inactive_reads.begin();
+    auto victim = it;
+    auto victim_score = score(*victim);
+    for (unsigned i = 1; i < max_candidates && ++it != _inactive_reads.end(); ++i) {
+        if (const auto s = score(*it); s > victim_score) {
+            victim = it;
+            victim_score = s;
+        }
+    }
+    return *victim;
+}
+
 void reader_concurrency_semaphore::close_reader(flat_mutation_reader_v2 reader) {
     // It is safe to discard the future since it is waited on indirectly
     // by closing the _close_readers_gate in stop().
@@ -1012,7 +1103,7 @@ void reader_concurrency_semaphore::evict_readers_in_background() {
                 _evicting = false;
                 return make_ready_future<stop_iteration>(stop_iteration::yes);
             }
-            return detach_inactive_reader(_inactive_reads.front(), evict_reason::permit).close().then([] {
+            return detach_inactive_reader(pick_inactive_read_to_evict(), evict_reason::permit).close().then([] {
                 return stop_iteration::no;
             });
         });
@@ -1089,10 +1180,36 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit permit, r
     return make_ready_future<>();
 }
 
+bool reader_concurrency_semaphore::should_shed(const reader_permit& permit) const noexcept {
+    if (!_deadline_shedding() || permit.get_state() != reader_permit::state::waiting_for_admission) {
+        return false;
+    }
+    const auto timeout = permit.timeout();
+    const auto* schema = permit._impl->get_schema();
+    if (timeout == db::no_timeout || !schema) {
+        return false;
+    }
+    auto it = _read_duration_estimates.find(schema->id());
+    return it != _read_duration_estimates.end() && timeout - db::timeout_clock::now() < it->second;
+}
+
+std::optional<db::timeout_clock::duration> reader_concurrency_semaphore::read_duration_estimate(table_id id) const {
+    if (auto it = _read_duration_estimates.find(id); it != _read_duration_estimates.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
 void reader_concurrency_semaphore::maybe_admit_waiters() noexcept {
     auto admit = can_admit::no;
     while (!_wait_list.empty() && (admit = can_admit_read(_wait_list.front().permit)) == can_admit::yes) {
         auto& x = _wait_list.front();
+        if (should_shed(x.permit)) {
+            ++_stats.total_reads_shed_due_to_deadline;
+            x.pr.set_exception(named_semaphore_timed_out(_name));
+            _wait_list.pop_front();
+            continue;
+        }
         try {
             if (x.permit.get_state() == reader_permit::state::waiting_for_memory) {
                 _blessed_permit = x.permit._impl.get();
@@ -1148,6 +1265,27 @@ void reader_concurrency_semaphore::on_permit_created(reader_permit::impl& permit
 }
 
 void reader_concurrency_semaphore::on_permit_destroyed(reader_permit::impl& permit) noexcept {
+    if (auto schema = permit.get_schema()) {
+        try {
+            auto& table_usage = _resource_usage_by_table[schema->id()];
+            ++table_usage.reads;
+            table_usage.usage += permit.resource_usage();
+        } catch (...) {
+            // Usage accounting is best-effort.
+        }
+    }
+    if (auto schema = permit.get_schema(); schema && _deadline_shedding()) {
+        if (auto duration = permit.read_duration()) {
+            try {
+                auto [it, inserted] = _read_duration_estimates.try_emplace(schema->id(), *duration);
+                if (!inserted) {
+                    it->second += (*duration - it->second) / 8;
+                }
+            } catch (...) {
+                // Estimates are best-effort.
+            }
+        }
+    }
     permit.unlink();
     _permit_gate.leave();
     --_stats.current_permits;
@@ -1225,6 +1363,24 @@ void reader_concurrency_semaphore::set_resources(resources r) {
     maybe_admit_waiters();
 }
 
+size_t reader_concurrency_semaphore::reader_buffer_size(size_t default_size) const noexcept {
+    const auto initial = _initial_resources.memory;
+    if (is_unlimited() || initial <= 0) {
+        return default_size;
+    }
+    const auto available = std::max(_resources.memory, ssize_t(0));
+    if (available * 2 < initial) {
+        const auto shrunk = default_size * size_t(available) * 2 / size_t(initial);
+        return std::max(shrunk, std::min(default_size, min_reader_buffer_size));
+    }
+    if (active_reads() <= 1 && available * 4 >= initial * 3) {
+        // Leave most of the memory to readers admitted later.
+        const auto grown = std::min(default_size * max_reader_buffer_growth, size_t(available) / 64);
+        return std::max(grown, default_size);
+    }
+    return default_size;
+}
+
 void reader_concurrency_semaphore::broken(std::exception_ptr ex) {
     if (!ex) {
         ex = std::make_exception_ptr(broken_semaphore{});
@@ -1319,7 +1475,12 @@ class tracking_file_impl : public file_impl {
 
     virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
         return _permit.request_memory(range_size).then([this, offset, range_size, &pc] (reader_permit::resource_units units) {
-            return get_file_impl(_tracked_file)->dma_read_bulk(offset, range_size, pc).then([this, units = std::move(units)] (temporary_buffer<uint8_t> buf) mutable {
+            auto start = std::chrono::steady_clock::now();
+            return get_file_impl(_tracked_file)->dma_read_bulk(offset, range_size, pc).then([this, start, units = std::move(units)] (temporary_buffer<uint8_t> buf) mutable {
+                auto& stats = _permit.semaphore().get_stats();
+                ++stats.disk_read_ios;
+                stats.disk_read_io_latency_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+                _permit.on_disk_read(buf.size());
                 return make_ready_future<temporary_buffer<uint8_t>>(make_tracked_temporary_buffer(std::move(buf), std::move(units)));
             });
         });
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <boost/intrusive/list.hpp>
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
@@ -87,6 +88,9 @@ class reader_concurrency_semaphore {
         uint64_t total_failed_reads = 0;
         // Total number of reads rejected because the admission queue reached its max capacity
         uint64_t total_reads_shed_due_to_overload = 0;
+        // Total number of reads rejected on admission because they were not
+        // expected to complete before their timeout.
+        uint64_t total_reads_shed_due_to_deadline = 0;
         // Total number of reads killed due to the memory consumption reaching the kill limit.
         uint64_t total_reads_killed_due_to_kill_limit = 0;
         // Total number of reads admitted, via all admission paths.
@@ -107,6 +111,10 @@ class reader_concurrency_semaphore {
         uint64_t disk_reads = 0;
         // The number of sstables read currently.
         uint64_t sstables_read = 0;
+        // Total number of reads issued to the disk through tracked files.
+        uint64_t disk_read_ios = 0;
+        // Total latency of the reads issued to the disk, in microseconds.
+        uint64_t disk_read_io_latency_us = 0;
     };
 
     using permit_list_type = bi::list<
@@ -118,6 +126,19 @@ class reader_concurrency_semaphore {
 
     using read_func = noncopyable_function<future<>(reader_permit)>;
 
+    struct table_resource_usage {
+        // The number of reads (permits) of the table.
+        uint64_t reads = 0;
+        reader_resource_usage usage;
+
+        table_resource_usage& operator+=(const table_resource_usage& o) {
+            reads += o.reads;
+            usage += o.usage;
+            return *this;
+        }
+    };
+    using resource_usage_by_table_type = std::unordered_map<table_id, table_resource_usage>;
+
 private:
     struct entry {
         promise<> pr;
@@ -140,6 +161,9 @@ class reader_concurrency_semaphore {
         eviction_notify_handler notify_handler;
         timer<lowres_clock> ttl_timer;
         inactive_read_handle* handle = nullptr;
+        lowres_clock::time_point registered_at = lowres_clock::now();
+        // How long the owner of the read usually pauses it for, if known.
+        std::optional<lowres_clock::duration> expected_pause;
 
         explicit inactive_read(flat_mutation_reader_v2 reader_) noexcept
             : reader(std::move(reader_))
@@ -239,6 +263,12 @@ class reader_concurrency_semaphore {
     size_t _max_queue_length = std::numeric_limits<size_t>::max();
     utils::updateable_value<uint32_t> _serialize_limit_multiplier;
     utils::updateable_value<uint32_t> _kill_limit_multiplier;
+    utils::updateable_value<bool> _deadline_shedding{false};
+    // Per table moving averages of the duration of reads, from admission
+    // until their permit is destroyed, see set_deadline_shedding().
+    std::unordered_map<table_id, db::timeout_clock::duration> _read_duration_estimates;
+    // The resources used by the reads of each table, once they completed.
+    resource_usage_by_table_type _resource_usage_by_table;
     inactive_reads_type _inactive_reads;
     stats _stats;
     permit_list_type _permit_list;
@@ -253,6 +283,8 @@ class reader_concurrency_semaphore {
     void do_detach_inactive_reader(inactive_read&, evict_reason reason) noexcept;
     [[nodiscard]] flat_mutation_reader_v2 detach_inactive_reader(inactive_read&, evict_reason reason) noexcept;
     void evict(inactive_read&, evict_reason reason) noexcept;
+    // Pick the inactive read to evict to free up resources.
+    inactive_read& pick_inactive_read_to_evict() noexcept;
 
     bool has_available_units(const resources& r) const;
 
@@ -303,6 +335,8 @@ class reader_concurrency_semaphore {
 
     future<> execution_loop() noexcept;
 
+    bool should_shed(const reader_permit& permit) const noexcept;
+
     uint64_t get_serialize_limit() const;
     uint64_t get_kill_limit() const;
 
@@ -383,6 +417,13 @@ class reader_concurrency_semaphore {
     /// the inactive_read_handle before calling this function.
     void set_notify_handler(inactive_read_handle& irh, eviction_notify_handler&& handler, std::optional<std::chrono::seconds> ttl);
 
+    /// Set how long the inactive read is expected to stay inactive.
+    ///
+    /// Reads which are expected to be resumed soon are evicted after reads
+    /// which are overdue, or hold more memory. See \ref pick_inactive_read_to_evict().
+    /// The same caveats apply as for \ref set_notify_handler().
+    void set_expected_pause(inactive_read_handle& irh, lowres_clock::duration pause) noexcept;
+
     /// Unregister the previously registered inactive read.
     ///
     /// If the read was not evicted, the inactive read object, passed in to the
@@ -507,6 +548,20 @@ class reader_concurrency_semaphore {
         return _initial_resources - _resources;
     }
 
+    /// Readers buffers are never shrunk below this size.
+    static constexpr size_t min_reader_buffer_size = 1024;
+    /// Buffers of lone readers are grown up to this many times the default.
+    static constexpr size_t max_reader_buffer_growth = 8;
+
+    /// The size readers should fill their buffers to, given \p default_size.
+    ///
+    /// Buffers shrink in proportion to the memory left once less than half
+    /// of the memory of the semaphore is available, so that more readers fit
+    /// before reads have to be queued. A reader which is the only active one
+    /// with most of the memory available, like a lone large scan, grows its
+    /// buffer instead, for fewer round-trips through the reader stack.
+    size_t reader_buffer_size(size_t default_size) const noexcept;
+
     size_t waiters() const {
         return _wait_list.size();
     }
@@ -523,6 +578,25 @@ class reader_concurrency_semaphore {
         _max_queue_length = size;
     }
 
+    /// Shed reads waiting for admission, which are not expected to complete
+    /// before their timeout, instead of admitting them.
+    ///
+    /// A read is expected to take as long as recent reads of its table,
+    /// from their admission to the destruction of their permit, excluding
+    /// reads which were paused (registered as inactive) in between.
+    /// Shed reads fail with the same error as reads timing out in the queue.
+    void set_deadline_shedding(utils::updateable_value<bool> enabled) {
+        _deadline_shedding = std::move(enabled);
+    }
+
+    /// The expected duration of reads of the table, if known.
+    std::optional<db::timeout_clock::duration> read_duration_estimate(table_id id) const;
+
+    /// The resources used by the completed reads of each table, since startup.
+    const resource_usage_by_table_type& resource_usage_by_table() const noexcept {
+        return _resource_usage_by_table;
+    }
+
     uint64_t active_reads() const noexcept {
         return _stats.current_permits - _stats.inactive_reads - waiters();
     }
@@ -63,6 +63,25 @@ inline bool operator==(const reader_resources& a, const reader_resources& b) {
 
 std::ostream& operator<<(std::ostream& os, const reader_resources& r);
 
+/// The resources a read used, so far.
+struct reader_resource_usage {
+    // Time the read spent used and not blocked, i.e. running or ready to run.
+    // An upper bound on the CPU time the read used.
+    std::chrono::microseconds cpu_time{0};
+    // Reads issued to the disk through tracked files, and the bytes they read.
+    uint64_t disk_reads = 0;
+    uint64_t disk_bytes_read = 0;
+
+    reader_resource_usage& operator+=(const reader_resource_usage& o) {
+        cpu_time += o.cpu_time;
+        disk_reads += o.disk_reads;
+        disk_bytes_read += o.disk_bytes_read;
+        return *this;
+    }
+};
+
+std::ostream& operator<<(std::ostream& os, const reader_resource_usage& u);
+
 class reader_concurrency_semaphore;
 
 /// A permit for a specific read.
@@ -135,6 +154,9 @@ class reader_permit {
 
     reader_concurrency_semaphore& semaphore();
 
+    // See reader_concurrency_semaphore::reader_buffer_size().
+    size_t reader_buffer_size(size_t default_size) const noexcept;
+
     state get_state() const;
 
     bool needs_readmission() const;
@@ -170,6 +192,9 @@ class reader_permit {
     void on_start_sstable_read() noexcept;
     void on_finish_sstable_read() noexcept;
 
+    void on_disk_read(size_t bytes) noexcept;
+    reader_resource_usage resource_usage() const noexcept;
+
     uintptr_t id() { return reinterpret_cast<uintptr_t>(_impl.get()); }
 };
 
@@ -277,6 +277,11 @@ class mutation_reader_merger {
     merger_vector<reader_and_fragment> _reader_heap;
     // Readers and their current fragments, belonging to the current
     // partition.
+    // A binary heap takes about as many comparisons per fragment as a
+    // tournament (loser) tree would: popping the winner takes about log2(n),
+    // and pushing the next fragment of the same reader, which usually sorts
+    // after most of the others, about one. Runs of fragments from a single
+    // reader bypass the heap altogether, see the gallop mode.
     merger_vector<reader_and_fragment> _fragment_heap;
     merger_vector<reader_and_last_fragment_kind> _next;
     // Readers that reached EOS.
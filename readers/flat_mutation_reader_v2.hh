@@ -127,6 +127,9 @@ class flat_mutation_reader_v2 final {
         tracked_buffer _buffer;
         size_t _buffer_size = 0;
         bool _close_required = false;
+        // Until set explicitly, the buffer size follows the memory left in
+        // the semaphore, see reader_concurrency_semaphore::reader_buffer_size().
+        bool _adaptive_buffer_size = true;
     protected:
         size_t max_buffer_size_in_bytes = default_max_buffer_size_in_bytes();
 
@@ -507,6 +510,9 @@ class flat_mutation_reader_v2 final {
 
     future<> fill_buffer() {
         _impl->set_close_required();
+        if (_impl->_adaptive_buffer_size) {
+            _impl->max_buffer_size_in_bytes = _impl->_permit.reader_buffer_size(impl::default_max_buffer_size_in_bytes());
+        }
         return _impl->fill_buffer();
     }
 
@@ -587,6 +593,7 @@ class flat_mutation_reader_v2 final {
     void set_timeout(db::timeout_clock::time_point timeout) noexcept { _impl->set_timeout(timeout); }
     void set_max_buffer_size(size_t size) {
         _impl->max_buffer_size_in_bytes = size;
+        _impl->_adaptive_buffer_size = false;
     }
     // Resolves with a pointer to the next fragment in the stream without consuming it from the stream,
     // or nullptr if there are no more fragments.
@@ -47,6 +47,10 @@ class foreign_reader : public flat_mutation_reader_v2::impl {
 
     foreign_unique_ptr<flat_mutation_reader_v2> _reader;
     foreign_unique_ptr<future<>> _read_ahead_future;
+    // The last buffer received from the remote reader, already copied into
+    // ours. Freed on the remote shard by the next operation, instead of
+    // by a message of its own.
+    foreign_unique_ptr<const fragment_buffer> _consumed_buffer;
     streamed_mutation::forwarding _fwd_sm;
 
     // Forward an operation to the reader on the remote shard.
@@ -61,7 +65,10 @@ class foreign_reader : public flat_mutation_reader_v2::impl {
         reader_permit::blocked_guard bg{_permit};
         return smp::submit_to(_reader.get_owner_shard(), [reader = _reader.get(),
                 read_ahead_future = std::exchange(_read_ahead_future, nullptr),
+                consumed_buffer = std::exchange(_consumed_buffer, nullptr),
                 op = std::move(op)] () mutable {
+            // We are on the owner shard, so this frees the buffer in place.
+            consumed_buffer.reset();
             auto exec_op_and_read_ahead = [=] () mutable {
                 // Not really variadic, we expect 0 (void) or 1 parameter.
                 return op().then([=] (auto... result) {
@@ -130,6 +137,7 @@ future<> foreign_reader::fill_buffer() {
             // Need a copy since the mf is on the remote shard.
             push_mutation_fragment(mutation_fragment_v2(*_schema, _permit, mf));
         }
+        _consumed_buffer = std::move(res.buffer);
     });
 }
 
@@ -173,7 +181,9 @@ future<> foreign_reader::close() noexcept {
         return make_ready_future<>();
     }
     return smp::submit_to(_reader.get_owner_shard(),
-            [reader = std::move(_reader), read_ahead_future = std::exchange(_read_ahead_future, nullptr)] () mutable {
+            [reader = std::move(_reader), read_ahead_future = std::exchange(_read_ahead_future, nullptr),
+                    consumed_buffer = std::exchange(_consumed_buffer, nullptr)] () mutable {
+        consumed_buffer.reset();
         auto read_ahead = read_ahead_future ? std::move(*read_ahead_future.get()) : make_ready_future<>();
         return read_ahead.then_wrapped([reader = std::move(reader)] (future<> f) mutable {
             if (f.failed()) {
@@ -1118,6 +1128,163 @@ future<> multishard_combining_reader_v2::close() noexcept {
     });
 }
 
+// See make_multishard_unordered_reader_v2() for description.
+class multishard_unordered_reader_v2 : public flat_mutation_reader_v2::impl {
+    const dht::sharder& _sharder;
+    std::vector<std::unique_ptr<shard_reader_v2>> _shard_readers;
+    // Shards owning a part of the read range, whose readers didn't reach end-of-stream yet.
+    std::vector<shard_id> _shards;
+    // Index into _shards of the shard currently emitting fragments.
+    size_t _current = 0;
+    // Set while a partition is being emitted, the current shard can only be
+    // switched at partition boundaries.
+    bool _in_partition = false;
+
+    void on_partition_range_change(const dht::partition_range& pr);
+    shard_reader_v2& current_reader() {
+        return *_shard_readers[_shards[_current]];
+    }
+    // Moves to the next shard which has fragments ready, if any.
+    bool move_to_ready_shard();
+    void read_ahead_all();
+
+public:
+    multishard_unordered_reader_v2(
+            const dht::sharder& sharder,
+            shared_ptr<reader_lifecycle_policy_v2> lifecycle_policy,
+            schema_ptr s,
+            reader_permit permit,
+            const dht::partition_range& pr,
+            const query::partition_slice& ps,
+            const io_priority_class& pc,
+            tracing::trace_state_ptr trace_state,
+            mutation_reader::forwarding fwd_mr);
+
+    virtual future<> fill_buffer() override;
+    virtual future<> next_partition() override;
+    virtual future<> fast_forward_to(const dht::partition_range& pr) override;
+    virtual future<> fast_forward_to(position_range pr) override;
+    virtual future<> close() noexcept override;
+};
+
+void multishard_unordered_reader_v2::on_partition_range_change(const dht::partition_range& pr) {
+    _shards.clear();
+    _current = 0;
+    _in_partition = false;
+    std::vector<bool> seen(_sharder.shard_count(), false);
+    auto ring_sharder = dht::ring_position_range_sharder(_sharder, pr);
+    for (auto next = ring_sharder.next(*_schema); next && _shards.size() < _sharder.shard_count(); next = ring_sharder.next(*_schema)) {
+        if (!std::exchange(seen[next->shard], true)) {
+            _shards.push_back(next->shard);
+        }
+    }
+}
+
+bool multishard_unordered_reader_v2::move_to_ready_shard() {
+    for (size_t i = 1; i < _shards.size(); ++i) {
+        auto idx = (_current + i) % _shards.size();
+        if (!_shard_readers[_shards[idx]]->is_buffer_empty()) {
+            _current = idx;
+            return true;
+        }
+    }
+    return false;
+}
+
+void multishard_unordered_reader_v2::read_ahead_all() {
+    for (auto shard : _shards) {
+        _shard_readers[shard]->read_ahead();
+    }
+}
+
+multishard_unordered_reader_v2::multishard_unordered_reader_v2(
+        const dht::sharder& sharder,
+        shared_ptr<reader_lifecycle_policy_v2> lifecycle_policy,
+        schema_ptr s,
+        reader_permit permit,
+        const dht::partition_range& pr,
+        const query::partition_slice& ps,
+        const io_priority_class& pc,
+        tracing::trace_state_ptr trace_state,
+        mutation_reader::forwarding fwd_mr)
+    : impl(std::move(s), std::move(permit)), _sharder(sharder) {
+
+    on_partition_range_change(pr);
+
+    _shard_readers.reserve(_sharder.shard_count());
+    for (unsigned i = 0; i < _sharder.shard_count(); ++i) {
+        _shard_readers.emplace_back(std::make_unique<shard_reader_v2>(_schema, _permit, lifecycle_policy, i, pr, ps, pc, trace_state, fwd_mr));
+    }
+    _end_of_stream = _shards.empty();
+}
+
+future<> multishard_unordered_reader_v2::fill_buffer() {
+    return do_until([this] { return is_buffer_full() || is_end_of_stream(); }, [this] {
+        auto& reader = current_reader();
+
+        if (reader.is_buffer_empty()) {
+            if (reader.is_end_of_stream()) {
+                _shards.erase(_shards.begin() + _current);
+                _in_partition = false;
+                if (_shards.empty()) {
+                    _end_of_stream = true;
+                } else {
+                    _current %= _shards.size();
+                    move_to_ready_shard();
+                }
+                return make_ready_future<>();
+            }
+            if (!_in_partition && move_to_ready_shard()) {
+                return make_ready_future<>();
+            }
+            // Keep all shards busy, so that their data is ready by the time we get to them.
+            read_ahead_all();
+            return reader.fill_buffer();
+        }
+
+        while (!reader.is_buffer_empty() && !is_buffer_full()) {
+            auto mf = reader.pop_mutation_fragment();
+            if (mf.is_partition_start()) {
+                _in_partition = true;
+            } else if (mf.is_end_of_partition()) {
+                _in_partition = false;
+            }
+            push_mutation_fragment(std::move(mf));
+        }
+        if (reader.is_buffer_empty()) {
+            reader.read_ahead();
+        }
+        return make_ready_future<>();
+    });
+}
+
+future<> multishard_unordered_reader_v2::next_partition() {
+    clear_buffer_to_next_partition();
+    if (is_buffer_empty() && std::exchange(_in_partition, false)) {
+        return current_reader().next_partition();
+    }
+    return make_ready_future<>();
+}
+
+future<> multishard_unordered_reader_v2::fast_forward_to(const dht::partition_range& pr) {
+    clear_buffer();
+    on_partition_range_change(pr);
+    _end_of_stream = _shards.empty();
+    return parallel_for_each(_shard_readers, [&pr] (std::unique_ptr<shard_reader_v2>& sr) {
+        return sr->fast_forward_to(pr);
+    });
+}
+
+future<> multishard_unordered_reader_v2::fast_forward_to(position_range pr) {
+    return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+}
+
+future<> multishard_unordered_reader_v2::close() noexcept {
+    return parallel_for_each(_shard_readers, [] (std::unique_ptr<shard_reader_v2>& sr) {
+        return sr->close();
+    });
+}
+
 flat_mutation_reader_v2 make_multishard_combining_reader_v2(
         shared_ptr<reader_lifecycle_policy_v2> lifecycle_policy,
         schema_ptr schema,
@@ -1145,3 +1312,31 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
     return make_flat_mutation_reader_v2<multishard_combining_reader_v2>(sharder, std::move(lifecycle_policy), std::move(schema), std::move(permit), pr, ps, pc,
             std::move(trace_state), fwd_mr);
 }
+
+flat_mutation_reader_v2 make_multishard_unordered_reader_v2(
+        shared_ptr<reader_lifecycle_policy_v2> lifecycle_policy,
+        schema_ptr schema,
+        reader_permit permit,
+        const dht::partition_range& pr,
+        const query::partition_slice& ps,
+        const io_priority_class& pc,
+        tracing::trace_state_ptr trace_state,
+        mutation_reader::forwarding fwd_mr) {
+    const dht::sharder& sharder = schema->get_sharder();
+    return make_flat_mutation_reader_v2<multishard_unordered_reader_v2>(sharder, std::move(lifecycle_policy), std::move(schema), std::move(permit), pr, ps, pc,
+            std::move(trace_state), fwd_mr);
+}
+
+flat_mutation_reader_v2 make_multishard_unordered_reader_v2_for_tests(
+        const dht::sharder& sharder,
+        shared_ptr<reader_lifecycle_policy_v2> lifecycle_policy,
+        schema_ptr schema,
+        reader_permit permit,
+        const dht::partition_range& pr,
+        const query::partition_slice& ps,
+        const io_priority_class& pc,
+        tracing::trace_state_ptr trace_state,
+        mutation_reader::forwarding fwd_mr) {
+    return make_flat_mutation_reader_v2<multishard_unordered_reader_v2>(sharder, std::move(lifecycle_policy), std::move(schema), std::move(permit), pr, ps, pc,
+            std::move(trace_state), fwd_mr);
+}
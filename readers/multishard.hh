@@ -138,3 +138,34 @@ flat_mutation_reader_v2 make_multishard_combining_reader_v2_for_tests(
         tracing::trace_state_ptr trace_state = nullptr,
         mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
 
+/// Make a multishard reader for consumers which don't need partitions in ring order.
+///
+/// Like make_multishard_combining_reader_v2(), it reads a range from all
+/// shards that own a subrange in the range, but instead of reading them one at
+/// a time, in token order, all shards are read concurrently. Each shard reader
+/// keeps a read-ahead in flight, and partitions are emitted from whichever
+/// shard has data ready, so a slow shard doesn't stall the others.
+///
+/// Partitions are emitted whole, but their order across shards is unspecified.
+/// Suitable for aggregations, scans and validation, not for consumers which
+/// merge or compare the stream with another one.
+flat_mutation_reader_v2 make_multishard_unordered_reader_v2(
+        shared_ptr<reader_lifecycle_policy_v2> lifecycle_policy,
+        schema_ptr schema,
+        reader_permit permit,
+        const dht::partition_range& pr,
+        const query::partition_slice& ps,
+        const io_priority_class& pc,
+        tracing::trace_state_ptr trace_state = nullptr,
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
+
+flat_mutation_reader_v2 make_multishard_unordered_reader_v2_for_tests(
+        const dht::sharder& sharder,
+        shared_ptr<reader_lifecycle_policy_v2> lifecycle_policy,
+        schema_ptr schema,
+        reader_permit permit,
+        const dht::partition_range& pr,
+        const query::partition_slice& ps,
+        const io_priority_class& pc,
+        tracing::trace_state_ptr trace_state = nullptr,
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
@@ -22,11 +22,13 @@ future<redis_message> command_factory::create_execute(service::storage_proxy& pr
         { "ping", commands::ping },
         { "select", commands::select },
         { "get", commands::get },
+        { "mget", commands::mget },
         { "exists", commands::exists },
         { "ttl", commands::ttl },
         { "strlen", commands::strlen },
         { "set", commands::set },
         { "setex", commands::setex },
+        { "mset", commands::mset },
         { "del", commands::del },
         { "echo", commands::echo },
         { "lolwut", commands::lolwut },
@@ -35,6 +37,10 @@ future<redis_message> command_factory::create_execute(service::storage_proxy& pr
         { "hgetall", commands::hgetall },
         { "hdel", commands::hdel },
         { "hexists", commands::hexists },
+        { "sadd", commands::sadd },
+        { "srem", commands::srem },
+        { "smembers", commands::smembers },
+        { "sismember", commands::sismember },
     };
     auto&& command = _commands.find(req._command);
     if (command != _commands.end()) {
@@ -8,6 +8,7 @@
 
 #include "redis/commands.hh"
 #include <seastar/core/shared_ptr.hh>
+#include <boost/range/irange.hpp>
 #include "redis/request.hh"
 #include "redis/reply.hh"
 #include "types.hh"
@@ -41,7 +42,7 @@ future<redis_message> exists(service::storage_proxy& proxy, request& req, redis:
         throw wrong_arguments_exception(1, req.arguments_size(), req._command);
     }
     return do_with(size_t(0), [&proxy, &options, permit, &req] (size_t& count) {
-        return seastar::do_for_each(req._args, [&proxy, &options, permit, &count] (auto& key) {
+        return seastar::parallel_for_each(req._args, [&proxy, &options, permit, &count] (auto& key) {
             return redis::read_strings(proxy, options, key, permit).then([&count] (lw_shared_ptr<strings_result> result) {
                 if (result->has_result()) {
                     count++;
@@ -53,6 +54,25 @@ future<redis_message> exists(service::storage_proxy& proxy, request& req, redis:
     });
 }
 
+future<redis_message> mget(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 1) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    // The keys are read concurrently, and their values are returned in the
+    // order of the keys.
+    return do_with(std::vector<bytes_opt>(req.arguments_size()), [&proxy, &options, permit, &req] (std::vector<bytes_opt>& values) {
+        return seastar::parallel_for_each(boost::irange<size_t>(0, req.arguments_size()), [&proxy, &options, permit, &req, &values] (size_t i) {
+            return redis::read_strings(proxy, options, req._args[i], permit).then([&values, i] (lw_shared_ptr<strings_result> result) {
+                if (result->has_result()) {
+                    values[i] = std::move(result->result());
+                }
+            });
+        }).then([&values] () {
+            return redis_message::make_strings_list_result(values);
+        });
+    });
+}
+
 future<redis_message> ttl(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
     if (req.arguments_size() != 1) {
         throw wrong_arguments_exception(1, req.arguments_size(), req._command);
@@ -139,6 +159,50 @@ future<redis_message> hexists(service::storage_proxy& proxy, request& req, redis
     });
 }
 
+future<redis_message> sadd(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 2) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    //FIXME: We should return the count of the actually added members.
+    auto members = std::vector<bytes>(req._args.begin() + 1, req._args.end());
+    auto size = members.size();
+    return redis::write_set_members(proxy, options, std::move(req._args[0]), std::move(members), permit).then([size] {
+        return redis_message::number(size);
+    });
+}
+
+future<redis_message> srem(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 2) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    //FIXME: We should return the count of the actually removed members.
+    auto members = std::vector<bytes>(req._args.begin() + 1, req._args.end());
+    auto size = members.size();
+    return redis::delete_set_members(proxy, options, std::move(req._args[0]), std::move(members), permit).then([size] {
+        return redis_message::number(size);
+    });
+}
+
+future<redis_message> smembers(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() != 1) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    return redis::read_set_members(proxy, options, req._args[0], permit).then([] (auto result) {
+        // An empty array if the key does not exist
+        std::vector<bytes_opt> members(std::make_move_iterator(result->begin()), std::make_move_iterator(result->end()));
+        return redis_message::make_strings_list_result(members);
+    });
+}
+
+future<redis_message> sismember(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() != 2) {
+        throw wrong_arguments_exception(2, req.arguments_size(), req._command);
+    }
+    return redis::read_set_members(proxy, options, req._args[0], req._args[1], permit).then([] (auto result) {
+        return redis_message::number(result->empty() ? 0 : 1);
+    });
+}
+
 future<redis_message> set(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
     if (req.arguments_size() != 2 && req.arguments_size() != 4) {
         throw invalid_arguments_exception(req._command);
@@ -172,6 +236,20 @@ future<redis_message> setex(service::storage_proxy& proxy, request& req, redis::
     });
 }
 
+future<redis_message> mset(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() == 0 || req.arguments_size() % 2 != 0) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    std::vector<std::pair<bytes, bytes>> keys_and_data;
+    keys_and_data.reserve(req.arguments_size() / 2);
+    for (size_t i = 0; i < req.arguments_size(); i += 2) {
+        keys_and_data.emplace_back(std::move(req._args[i]), std::move(req._args[i + 1]));
+    }
+    return redis::write_strings(proxy, options, std::move(keys_and_data), permit).then([] {
+        return redis_message::ok();
+    });
+}
+
 future<redis_message> del(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
     if (req.arguments_size() == 0) {
         throw wrong_number_of_arguments_exception(req._command);
@@ -71,6 +71,17 @@ future<> write_strings(service::storage_proxy& proxy, redis::redis_options& opti
     return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
 }
 
+future<> write_strings(service::storage_proxy& proxy, redis::redis_options& options, std::vector<std::pair<bytes, bytes>>&& keys_and_data, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+    std::vector<mutation> mutations;
+    mutations.reserve(keys_and_data.size());
+    for (auto& [key, data] : keys_and_data) {
+        mutations.push_back(make_mutation(proxy, options, std::move(key), std::move(data), 0));
+    }
+    auto write_consistency_level = options.get_write_consistency_level();
+    return proxy.mutate(std::move(mutations), write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
+}
+
 
 mutation make_tombstone(service::storage_proxy& proxy, const redis_options& options, const sstring& cf_name, const bytes& key) {
     auto schema = get_schema(proxy, options.get_keyspace_name(), cf_name);
@@ -110,4 +121,30 @@ future<> delete_fields(service::storage_proxy& proxy, redis::redis_options& opti
     return proxy.mutate(mutations, write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
 }
 
+future<> write_set_members(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<bytes>&& members, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::SETs);
+    // The hidden, empty valued column of the dense table keeps the rows alive.
+    const column_definition& column = schema->regular_column_at(0);
+    auto m = mutation(schema, partition_key::from_single_value(*schema, key));
+    for (auto& member : members) {
+        auto ckey = clustering_key::from_single_value(*schema, member);
+        m.set_clustered_cell(ckey, column, make_cell(schema, *column.type, bytes_view()));
+    }
+    auto write_consistency_level = options.get_write_consistency_level();
+    return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
+}
+
+future<> delete_set_members(service::storage_proxy& proxy, redis::redis_options& options, bytes&& key, std::vector<bytes>&& members, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::SETs);
+    auto m = mutation(schema, partition_key::from_single_value(*schema, key));
+    auto t = tombstone { api::new_timestamp(), gc_clock::now() };
+    for (auto& member : members) {
+        m.partition().apply_delete(*schema, clustering_key::from_single_value(*schema, member), t);
+    }
+    auto write_consistency_level = options.get_write_consistency_level();
+    return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
+}
+
 }
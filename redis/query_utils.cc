@@ -164,4 +164,60 @@ future<lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_prox
     });
 }
 
+class set_members_result_builder {
+    lw_shared_ptr<std::vector<bytes>> _data;
+public:
+    explicit set_members_result_builder(lw_shared_ptr<std::vector<bytes>> data)
+        : _data(data)
+    {
+    }
+    void accept_new_partition(const partition_key& key, uint32_t row_count) {}
+    void accept_new_partition(uint32_t row_count) {}
+    void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row)
+    {
+        for (auto&& v : key.explode()) {
+            _data->push_back(std::move(v));
+        }
+    }
+    void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {}
+    void accept_partition_end(const query::result_row_view& static_row) {}
+};
+
+future<lw_shared_ptr<std::vector<bytes>>> read_set_members(service::storage_proxy& proxy, const redis_options& options, const bytes& key, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::SETs);
+
+    auto ps = partition_slice_builder(*schema)
+        .build();
+    return query_set_members(proxy, options, key, permit, schema, ps);
+}
+future<lw_shared_ptr<std::vector<bytes>>> read_set_members(service::storage_proxy& proxy, const redis_options& options, const bytes& key, const bytes& member, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::SETs);
+    auto ckey = clustering_key::from_single_value(*schema, member);
+    auto clustering_range = query::clustering_range::make_singular(ckey);
+
+    auto ps = partition_slice_builder(*schema)
+        .with_range(std::move(clustering_range))
+        .build();
+    return query_set_members(proxy, options, key, permit, schema, ps);
+}
+
+future<lw_shared_ptr<std::vector<bytes>>> query_set_members(service::storage_proxy& proxy, const redis_options& options, const bytes& key, service_permit permit, schema_ptr schema, query::partition_slice ps) {
+    const auto max_result_size = proxy.get_max_result_size(ps);
+    const auto max_tombstones = proxy.get_tombstone_limit();
+    query::read_command cmd(schema->id(), schema->version(), ps, max_result_size, max_tombstones, query::row_limit::max, query::partition_limit(1), gc_clock::now(), std::nullopt, query_id::create_null_id(), query::is_first_page::no);
+    auto pkey = partition_key::from_single_value(*schema, key);
+    auto partition_range = dht::partition_range::make_singular(dht::decorate_key(*schema, std::move(pkey)));
+    dht::partition_range_vector partition_ranges;
+    partition_ranges.emplace_back(std::move(partition_range));
+    auto read_consistency_level = options.get_read_consistency_level();
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_read_timeout();
+    return proxy.query(schema, make_lw_shared<query::read_command>(std::move(cmd)), std::move(partition_ranges), read_consistency_level, {timeout, permit, service::client_state::for_internal_calls()}).then([ps, schema] (auto qr) {
+        return query::result_view::do_with(*qr.query_result, [&] (query::result_view v) {
+            auto pd = make_lw_shared<std::vector<bytes>>();
+            v.consume(ps, set_members_result_builder(pd));
+            return pd;
+        });
+    });
+}
+
 }
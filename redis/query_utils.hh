@@ -42,4 +42,9 @@ seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(serv
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, const bytes&, service_permit);
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> query_hashes(service::storage_proxy&, const redis_options&, const bytes&, service_permit, schema_ptr, query::partition_slice);
 
+// Reads the members of a set, or only the given member.
+seastar::future<seastar::lw_shared_ptr<std::vector<bytes>>> read_set_members(service::storage_proxy&, const redis_options&, const bytes&, service_permit);
+seastar::future<seastar::lw_shared_ptr<std::vector<bytes>>> read_set_members(service::storage_proxy&, const redis_options&, const bytes&, const bytes&, service_permit);
+seastar::future<seastar::lw_shared_ptr<std::vector<bytes>>> query_set_members(service::storage_proxy&, const redis_options&, const bytes&, service_permit, schema_ptr, query::partition_slice);
+
 }
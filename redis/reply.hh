@@ -68,6 +68,19 @@ class redis_message final {
         }
         return make_ready_future<redis_message>(m);
     }
+    // An array of strings, in which missing strings are nil.
+    static seastar::future<redis_message> make_strings_list_result(std::vector<bytes_opt>& results) {
+        auto m = make_lw_shared<scattered_message<char>> ();
+        m->append(fmt::format("*{}\r\n", results.size()));
+        for (auto& r : results) {
+            if (r) {
+                write_bytes(m, *r);
+            } else {
+                m->append_static("$-1\r\n");
+            }
+        }
+        return make_ready_future<redis_message>(m);
+    }
     static seastar::future<redis_message> make_strings_result(bytes result) {
         auto m = make_lw_shared<scattered_message<char>> ();
         write_bytes(m, result);
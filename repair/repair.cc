@@ -39,6 +39,7 @@
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/core/sleep.hh>
 
 #include <cfloat>
@@ -123,6 +124,8 @@ std::ostream& operator<<(std::ostream& out, row_level_diff_detect_algorithm algo
         return out << "send_full_set";
     case row_level_diff_detect_algorithm::send_full_set_rpc_stream:
         return out << "send_full_set_rpc_stream";
+    case row_level_diff_detect_algorithm::send_hash_buckets_rpc_stream:
+        return out << "send_hash_buckets_rpc_stream";
     };
     return out << "unknown";
 }
@@ -897,45 +900,85 @@ static future<tasks::task_manager::task_ptr> start_repair_task(tasks::task_manag
     co_return task;
 }
 
+// The estimated number of partitions of each of the ranges in the table on this shard.
+static future<std::vector<uint64_t>> estimate_partitions_in_ranges(replica::database& db, table_id table_id, const dht::token_range_vector& ranges) {
+    std::vector<uint64_t> estimates(ranges.size(), 0);
+    lw_shared_ptr<const sstables::sstable_list> sstables;
+    try {
+        sstables = db.find_column_family(table_id).get_sstables();
+    } catch (replica::no_such_column_family&) {
+        co_return estimates;
+    }
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        for (auto& sst : *sstables) {
+            estimates[i] += sst->estimated_keys_for_range(ranges[i]);
+        }
+        co_await coroutine::maybe_yield();
+    }
+    co_return estimates;
+}
+
 future<> shard_repair_task_impl::do_repair_ranges() {
-    // Repair tables in the keyspace one after another
     assert(table_names().size() == table_ids.size());
-    for (int idx = 0; idx < table_ids.size(); idx++) {
-        auto table_id = table_ids[idx];
-        auto table_name = table_names()[idx];
-        // repair all the ranges in limited parallelism
-        rlogger.info("repair[{}]: Started to repair {} out of {} tables in keyspace={}, table={}, table_id={}, repair_reason={}",
-                id.uuid(), idx + 1, table_ids.size(), _status.keyspace, table_name, table_id, _reason);
-        co_await coroutine::parallel_for_each(ranges, [this, table_id] (auto&& range) {
-            return with_semaphore(rs.get_repair_module().range_parallelism_semaphore(), 1, [this, &range, table_id] {
-                return repair_range(range, table_id).then([this] {
-                    if (_reason == streaming::stream_reason::bootstrap) {
-                        rs.get_metrics().bootstrap_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::replace) {
-                        rs.get_metrics().replace_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::rebuild) {
-                        rs.get_metrics().rebuild_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::decommission) {
-                        rs.get_metrics().decommission_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::removenode) {
-                        rs.get_metrics().removenode_finished_ranges++;
-                    } else if (_reason == streaming::stream_reason::repair) {
-                        rs.get_metrics().repair_finished_ranges_sum++;
-                        nr_ranges_finished++;
-                    }
-                    rlogger.debug("repair[{}]: node ops progress bootstrap={}, replace={}, rebuild={}, decommission={}, removenode={}, repair={}",
-                        id.uuid(),
-                        rs.get_metrics().bootstrap_finished_percentage(),
-                        rs.get_metrics().replace_finished_percentage(),
-                        rs.get_metrics().rebuild_finished_percentage(),
-                        rs.get_metrics().decommission_finished_percentage(),
-                        rs.get_metrics().removenode_finished_percentage(),
-                        rs.get_metrics().repair_finished_percentage());
-                });
-            });
-        });
 
-        if (_reason != streaming::stream_reason::repair) {
+    // The ranges of all the tables are repaired together, in limited parallelism,
+    // the largest ones first. The large tables get the parallelism the small ones
+    // leave unused, and the repair doesn't end waiting for the last few large
+    // ranges of a table, with the rest of the parallelism idle.
+    struct range_to_repair {
+        size_t table_idx;
+        const dht::token_range* range;
+        uint64_t estimated_partitions;
+    };
+    std::vector<range_to_repair> ranges_to_repair;
+    ranges_to_repair.reserve(ranges_size());
+    std::vector<size_t> ranges_left(table_ids.size(), ranges.size());
+    for (size_t idx = 0; idx < table_ids.size(); idx++) {
+        auto estimates = co_await estimate_partitions_in_ranges(db.local(), table_ids[idx], ranges);
+        uint64_t table_estimated_partitions = 0;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            ranges_to_repair.push_back(range_to_repair{idx, &ranges[i], estimates[i]});
+            table_estimated_partitions += estimates[i];
+        }
+        rlogger.info("repair[{}]: Started to repair {} out of {} tables in keyspace={}, table={}, table_id={}, estimated_partitions={}, repair_reason={}",
+                id.uuid(), idx + 1, table_ids.size(), _status.keyspace, table_names()[idx], table_ids[idx], table_estimated_partitions, _reason);
+    }
+    // Stable, so that ranges of the same size stay in token order.
+    std::stable_sort(ranges_to_repair.begin(), ranges_to_repair.end(), [] (const range_to_repair& a, const range_to_repair& b) {
+        return a.estimated_partitions > b.estimated_partitions;
+    });
+
+    co_await coroutine::parallel_for_each(ranges_to_repair, [this, &ranges_left] (const range_to_repair& r) {
+        auto table_id = table_ids[r.table_idx];
+        return with_semaphore(rs.get_repair_module().range_parallelism_semaphore(), 1, [this, &r, table_id] {
+            return repair_range(*r.range, table_id).then([this] {
+                if (_reason == streaming::stream_reason::bootstrap) {
+                    rs.get_metrics().bootstrap_finished_ranges++;
+                } else if (_reason == streaming::stream_reason::replace) {
+                    rs.get_metrics().replace_finished_ranges++;
+                } else if (_reason == streaming::stream_reason::rebuild) {
+                    rs.get_metrics().rebuild_finished_ranges++;
+                } else if (_reason == streaming::stream_reason::decommission) {
+                    rs.get_metrics().decommission_finished_ranges++;
+                } else if (_reason == streaming::stream_reason::removenode) {
+                    rs.get_metrics().removenode_finished_ranges++;
+                } else if (_reason == streaming::stream_reason::repair) {
+                    rs.get_metrics().repair_finished_ranges_sum++;
+                    nr_ranges_finished++;
+                }
+                rlogger.debug("repair[{}]: node ops progress bootstrap={}, replace={}, rebuild={}, decommission={}, removenode={}, repair={}",
+                    id.uuid(),
+                    rs.get_metrics().bootstrap_finished_percentage(),
+                    rs.get_metrics().replace_finished_percentage(),
+                    rs.get_metrics().rebuild_finished_percentage(),
+                    rs.get_metrics().decommission_finished_percentage(),
+                    rs.get_metrics().removenode_finished_percentage(),
+                    rs.get_metrics().repair_finished_percentage());
+            });
+        }).then([this, &r, &ranges_left, table_id] {
+            if (--ranges_left[r.table_idx] || _reason == streaming::stream_reason::repair) {
+                return;
+            }
             try {
                 auto& table = db.local().find_column_family(table_id);
                 rlogger.debug("repair[{}]: Trigger off-strategy compaction for keyspace={}, table={}",
@@ -944,8 +987,8 @@ future<> shard_repair_task_impl::do_repair_ranges() {
             } catch (replica::no_such_column_family&) {
                 // Ignore dropped table
             }
-        }
-    }
+        });
+    });
     co_return;
 }
 
@@ -81,6 +81,10 @@ enum class repair_state : uint16_t {
     get_full_row_hashes_with_rpc_stream_finished,
     get_full_row_hashes_started,
     get_full_row_hashes_finished,
+    get_row_hash_buckets_started,
+    get_row_hash_buckets_finished,
+    get_full_row_hashes_in_buckets_started,
+    get_full_row_hashes_in_buckets_finished,
     get_row_diff_started,
     get_row_diff_finished,
     put_row_diff_with_rpc_stream_started,
@@ -205,6 +209,7 @@ static const std::vector<row_level_diff_detect_algorithm>& suportted_diff_detect
     static std::vector<row_level_diff_detect_algorithm> _algorithms = {
         row_level_diff_detect_algorithm::send_full_set,
         row_level_diff_detect_algorithm::send_full_set_rpc_stream,
+        row_level_diff_detect_algorithm::send_hash_buckets_rpc_stream,
     };
     return _algorithms;
 };
@@ -444,19 +449,6 @@ class repair_writer_impl : public repair_writer::impl {
     }
 
     virtual future<> wait_for_writer_done() override;
-
-private:
-    static sstables::offstrategy is_offstrategy_supported(streaming::stream_reason reason) {
-        static const std::unordered_set<streaming::stream_reason> operations_supported = {
-            streaming::stream_reason::bootstrap,
-            streaming::stream_reason::replace,
-            streaming::stream_reason::removenode,
-            streaming::stream_reason::decommission,
-            streaming::stream_reason::repair,
-            streaming::stream_reason::rebuild,
-        };
-        return sstables::offstrategy(operations_supported.contains(reason));
-    }
 };
 
 future<> repair_writer::write_start_and_mf(lw_shared_ptr<const decorated_key_with_hash> dk, mutation_fragment mf) {
@@ -504,7 +496,7 @@ void repair_writer_impl::create_writer(lw_shared_ptr<repair_writer> w) {
     }
     replica::table& t = _db.local().find_column_family(_schema->id());
     _writer_done = mutation_writer::distribute_reader_and_consume_on_shards(_schema, std::move(_queue_reader),
-            streaming::make_streaming_consumer(sstables::repair_origin, _db, _sys_dist_ks, _view_update_generator, _estimated_partitions, _reason, is_offstrategy_supported(_reason)),
+            streaming::make_streaming_consumer(sstables::repair_origin, _db, _sys_dist_ks, _view_update_generator, _estimated_partitions, _reason),
     t.stream_in_progress()).then([w] (uint64_t partitions) {
         rlogger.debug("repair_writer: keyspace={}, table={}, managed to write partitions={} to sstable",
             w->schema()->ks_name(), w->schema()->cf_name(), partitions);
@@ -754,6 +746,10 @@ class repair_meta {
     std::list<repair_row> _row_buf;
     // Contains rows we are working on to sync between peers
     std::list<repair_row> _working_row_buf;
+    // Rows after those of _row_buf, read from disk in the background while
+    // the rows of _working_row_buf are synced, and the repair memory they use
+    std::optional<future<std::tuple<std::list<repair_row>, size_t>>> _read_ahead;
+    semaphore_units<> _read_ahead_units;
     // Combines all the repair_hash in _working_row_buf
     repair_hash _working_row_buf_combined_hash;
     // Tracks the last sync boundary
@@ -811,6 +807,22 @@ class repair_meta {
         return is_rpc_stream_supported(_algo);
     }
 
+    // Working row bufs with fewer rows exchange their full set of hashes.
+    static constexpr size_t min_rows_for_row_hash_buckets = 256;
+    static constexpr size_t rows_per_row_hash_bucket = 16;
+    static constexpr size_t max_row_hash_buckets = 4096;
+
+    // Returns the number of buckets to split the hashes of the rows in
+    // _working_row_buf into, to exchange only the hashes of the buckets which
+    // differ between nodes, or 0 to exchange the full set of hashes.
+    uint32_t row_hash_buckets() const {
+        if (_algo != row_level_diff_detect_algorithm::send_hash_buckets_rpc_stream
+                || _working_row_buf.size() < min_rows_for_row_hash_buckets) {
+            return 0;
+        }
+        return std::min(_working_row_buf.size() / rows_per_row_hash_bucket, max_row_hash_buckets);
+    }
+
 public:
     repair_meta(
             repair_service& rs,
@@ -910,7 +922,9 @@ class repair_meta {
         // move to background.  waited on via _stopped->get_future.
         when_all_succeed(std::move(gate_future), std::move(f1), std::move(f2), std::move(f3)).discard_result().finally([this] {
             return _repair_writer->wait_for_writer_done().finally([this] {
-                return close().then([this] {
+                return drop_read_ahead().then([this] {
+                    return close();
+                }).then([this] {
                     return clear_gently();
                 });
             });
@@ -945,6 +959,36 @@ class repair_meta {
         });
     }
 
+    static uint32_t row_hash_bucket(const repair_hash& hash, uint32_t nr_buckets) {
+        return hash.hash % nr_buckets;
+    }
+
+    // Get the combined hashes of the rows in _working_row_buf, by bucket
+    future<std::vector<repair_hash>>
+    working_row_hash_buckets(uint32_t nr_buckets) {
+        return do_with(std::vector<repair_hash>(nr_buckets), [this, nr_buckets] (std::vector<repair_hash>& buckets) {
+            return do_for_each(_working_row_buf, [&buckets, nr_buckets] (repair_row& r) mutable {
+                buckets[row_hash_bucket(r.hash(), nr_buckets)].add(r.hash());
+            }).then([&buckets] () mutable {
+                return std::move(buckets);
+            });
+        });
+    }
+
+    // Get a list of row hashes in _working_row_buf, within the given buckets
+    future<repair_hash_set>
+    working_row_hashes_in_buckets(uint32_t nr_buckets, std::vector<bool> in_buckets) {
+        return do_with(repair_hash_set(), std::move(in_buckets), [this, nr_buckets] (repair_hash_set& hashes, std::vector<bool>& in_buckets) {
+            return do_for_each(_working_row_buf, [&hashes, &in_buckets, nr_buckets] (repair_row& r) mutable {
+                if (in_buckets[row_hash_bucket(r.hash(), nr_buckets)]) {
+                    hashes.emplace(r.hash());
+                }
+            }).then([&hashes] () mutable {
+                return std::move(hashes);
+            });
+        });
+    }
+
     std::pair<std::optional<repair_sync_boundary>, bool>
     get_common_sync_boundary(bool zero_rows,
             std::vector<repair_sync_boundary>& sync_boundaries,
@@ -1118,6 +1162,48 @@ class repair_meta {
         co_return ret;
     }
 
+    // Starts reading the rows after those of _row_buf in the background, so
+    // that the next round doesn't wait for the disk, if there is repair memory
+    // to spare for them.
+    void start_read_ahead() {
+        if (_read_ahead || _gate.is_closed()) {
+            return;
+        }
+        auto units = try_get_units(_rs.memory_sem(), _max_row_buf_size);
+        if (!units) {
+            return;
+        }
+        _read_ahead_units = std::move(*units);
+        _read_ahead = with_gate(_gate, [this] {
+            return row_buf_size().then([this] (size_t cur_size) {
+                return read_rows_from_disk(cur_size);
+            });
+        });
+    }
+
+    future<std::tuple<std::list<repair_row>, size_t>>
+    take_read_ahead() {
+        if (!_read_ahead) {
+            return make_ready_future<std::tuple<std::list<repair_row>, size_t>>();
+        }
+        auto f = std::move(*_read_ahead);
+        _read_ahead.reset();
+        return f.finally([units = std::move(_read_ahead_units)] { });
+    }
+
+    future<> drop_read_ahead() noexcept {
+        return take_read_ahead().discard_result().handle_exception([] (std::exception_ptr) { });
+    }
+
+    // Like read_rows_from_disk(), starting with the rows read ahead, if any.
+    future<std::tuple<std::list<repair_row>, size_t>>
+    read_rows(size_t cur_size) {
+        auto [rows, rows_size] = co_await take_read_ahead();
+        auto [new_rows, new_rows_size] = co_await read_rows_from_disk(cur_size + rows_size);
+        rows.splice(rows.end(), new_rows);
+        co_return std::tuple<std::list<repair_row>, size_t>(std::move(rows), rows_size + new_rows_size);
+    }
+
     future<> clear_row_buf() {
         return utils::clear_gently(_row_buf);
     }
@@ -1144,7 +1230,7 @@ class repair_meta {
       return f.then([this, sb = std::move(skipped_sync_boundary)] () mutable {
        return clear_working_row_buf().then([this, sb = sb] () mutable {
         return row_buf_size().then([this, sb = std::move(sb)] (size_t cur_size) {
-            return read_rows_from_disk(cur_size).then_unpack([this, sb = std::move(sb)] (std::list<repair_row> new_rows, size_t new_rows_size) mutable {
+            return read_rows(cur_size).then_unpack([this, sb = std::move(sb)] (std::list<repair_row> new_rows, size_t new_rows_size) mutable {
                 size_t new_rows_nr = new_rows.size();
                 _row_buf.splice(_row_buf.end(), new_rows);
                 return row_buf_csum().then([this, new_rows_size, new_rows_nr, sb = std::move(sb)] (repair_hash row_buf_combined_hash) {
@@ -1462,6 +1548,99 @@ class repair_meta {
         });
     }
 
+    // RPC API
+    // Return the combined hashes of the rows in _working_row_buf, by bucket
+    future<std::vector<repair_hash>>
+    get_row_hash_buckets(gms::inet_address remote_node, uint32_t nr_buckets) {
+        if (remote_node == _myip) {
+            return get_row_hash_buckets_handler(nr_buckets);
+        }
+        return _messaging.send_repair_get_row_hash_buckets(msg_addr(remote_node),
+                _repair_meta_id, nr_buckets).then([this] (std::vector<repair_hash> buckets) {
+            stats().rpc_call_nr++;
+            stats().rx_hashes_nr += buckets.size();
+            _metrics.rx_hashes_nr += buckets.size();
+            return buckets;
+        });
+    }
+
+    // RPC handler
+    future<std::vector<repair_hash>>
+    get_row_hash_buckets_handler(uint32_t nr_buckets) {
+        return with_gate(_gate, [this, nr_buckets] {
+            if (nr_buckets == 0) {
+                throw std::runtime_error("get_row_hash_buckets: No buckets");
+            }
+            return working_row_hash_buckets(nr_buckets);
+        });
+    }
+
+    // RPC API
+    // Return the hashes of the rows in _working_row_buf, within the given buckets
+    future<repair_hash_set>
+    get_full_row_hashes_in_buckets(gms::inet_address remote_node, uint32_t nr_buckets, std::vector<uint32_t> buckets) {
+        if (remote_node == _myip) {
+            return get_full_row_hashes_in_buckets_handler(nr_buckets, std::move(buckets));
+        }
+        return _messaging.send_repair_get_full_row_hashes_in_buckets(msg_addr(remote_node),
+                _repair_meta_id, nr_buckets, std::move(buckets)).then([this, remote_node] (repair_hash_set hashes) {
+            rlogger.debug("Got hashes in buckets from peer={}, nr_hashes={}", remote_node, hashes.size());
+            _metrics.rx_hashes_nr += hashes.size();
+            stats().rx_hashes_nr += hashes.size();
+            stats().rpc_call_nr++;
+            return hashes;
+        });
+    }
+
+    // RPC handler
+    future<repair_hash_set>
+    get_full_row_hashes_in_buckets_handler(uint32_t nr_buckets, std::vector<uint32_t> buckets) {
+        return with_gate(_gate, [this, nr_buckets, buckets = std::move(buckets)] {
+            std::vector<bool> in_buckets(nr_buckets);
+            for (auto b : buckets) {
+                if (b >= nr_buckets) {
+                    throw std::runtime_error(format("get_full_row_hashes_in_buckets: Bucket {} out of {} buckets", b, nr_buckets));
+                }
+                in_buckets[b] = true;
+            }
+            return working_row_hashes_in_buckets(nr_buckets, std::move(in_buckets));
+        });
+    }
+
+    // Return the hashes of the rows in the working row buf of remote_node, like
+    // get_full_row_hashes(), but only fetch the hashes of the buckets whose
+    // combined hash differs from the local one: the rows of the other buckets
+    // are the same as the local ones. Must run inside a seastar thread.
+    repair_hash_set
+    get_full_row_hashes_by_buckets_in_thread(gms::inet_address remote_node, uint32_t nr_buckets) {
+        auto peer_buckets = get_row_hash_buckets(remote_node, nr_buckets).get0();
+        if (peer_buckets.size() != nr_buckets) {
+            throw std::runtime_error(format("get_row_hash_buckets: Got {} buckets from peer={}, expected {}", peer_buckets.size(), remote_node, nr_buckets));
+        }
+        auto local_buckets = working_row_hash_buckets(nr_buckets).get0();
+        std::vector<bool> same_buckets(nr_buckets);
+        std::vector<uint32_t> diff_buckets;
+        for (uint32_t b = 0; b < nr_buckets; ++b) {
+            if (peer_buckets[b] == local_buckets[b]) {
+                same_buckets[b] = true;
+            } else {
+                diff_buckets.push_back(b);
+            }
+        }
+        rlogger.debug("get_full_row_hashes_by_buckets: peer={}, buckets={}, diff_buckets={}", remote_node, nr_buckets, diff_buckets.size());
+        repair_hash_set hashes;
+        if (!diff_buckets.empty()) {
+            hashes = get_full_row_hashes_in_buckets(remote_node, nr_buckets, std::move(diff_buckets)).get0();
+        }
+        for (auto& r : _working_row_buf) {
+            if (same_buckets[row_hash_bucket(r.hash(), nr_buckets)]) {
+                hashes.emplace(r.hash());
+            }
+            thread::maybe_yield();
+        }
+        return hashes;
+    }
+
     // RPC API
     // Return the combined hashes of the current working row buf
     future<get_combined_row_hash_response>
@@ -1486,7 +1665,12 @@ class repair_meta {
         rlogger.trace("Calling get_combined_row_hash_handler");
         return with_gate(_gate, [this, common_sync_boundary = std::move(common_sync_boundary)] () mutable {
             _cf.update_off_strategy_trigger();
-            return request_row_hashes(common_sync_boundary);
+            return request_row_hashes(common_sync_boundary).then([this] (get_combined_row_hash_response resp) {
+                // The rows of the next round can be read while those of this
+                // one are synced with the peers.
+                start_read_ahead();
+                return resp;
+            });
         });
     }
 
@@ -2239,6 +2423,33 @@ future<> repair_service::init_ms_handlers() {
             });
         }) ;
     });
+    ms.register_repair_get_row_hash_buckets([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id, uint32_t nr_buckets) {
+        auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id, nr_buckets] (repair_service& local_repair) {
+            auto rm = local_repair.get_repair_meta(from, repair_meta_id);
+            rm->set_repair_state_for_local_node(repair_state::get_row_hash_buckets_started);
+            return rm->get_row_hash_buckets_handler(nr_buckets).then([rm] (std::vector<repair_hash> buckets) {
+                rm->set_repair_state_for_local_node(repair_state::get_row_hash_buckets_finished);
+                _metrics.tx_hashes_nr += buckets.size();
+                return buckets;
+            });
+        });
+    });
+    ms.register_repair_get_full_row_hashes_in_buckets([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id,
+            uint32_t nr_buckets, std::vector<uint32_t> buckets) {
+        auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id, nr_buckets, buckets = std::move(buckets)] (repair_service& local_repair) mutable {
+            auto rm = local_repair.get_repair_meta(from, repair_meta_id);
+            rm->set_repair_state_for_local_node(repair_state::get_full_row_hashes_in_buckets_started);
+            return rm->get_full_row_hashes_in_buckets_handler(nr_buckets, std::move(buckets)).then([rm] (repair_hash_set hashes) {
+                rm->set_repair_state_for_local_node(repair_state::get_full_row_hashes_in_buckets_finished);
+                _metrics.tx_hashes_nr += hashes.size();
+                return hashes;
+            });
+        });
+    });
     ms.register_repair_get_combined_row_hash([this] (const rpc::client_info& cinfo, uint32_t repair_meta_id,
             std::optional<repair_sync_boundary> common_sync_boundary) {
         auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
@@ -2374,6 +2585,8 @@ future<> repair_service::uninit_ms_handlers() {
         ms.unregister_repair_put_row_diff_with_rpc_stream(),
         ms.unregister_repair_get_full_row_hashes_with_rpc_stream(),
         ms.unregister_repair_get_full_row_hashes(),
+        ms.unregister_repair_get_row_hash_buckets(),
+        ms.unregister_repair_get_full_row_hashes_in_buckets(),
         ms.unregister_repair_get_combined_row_hash(),
         ms.unregister_repair_get_sync_boundary(),
         ms.unregister_repair_get_row_diff(),
@@ -2641,7 +2854,11 @@ class row_level_repair {
             rlogger.debug("Before master.get_full_row_hashes for node {}, hash_sets={}",
                 node, master.peer_row_hash_sets(node_idx).size());
             // Ask the peer to send the full list hashes in the working row buf.
-            if (master.use_rpc_stream()) {
+            if (auto nr_buckets = master.row_hash_buckets()) {
+                ns.state = repair_state::get_row_hash_buckets_started;
+                master.peer_row_hash_sets(node_idx) = master.get_full_row_hashes_by_buckets_in_thread(node, nr_buckets);
+                ns.state = repair_state::get_full_row_hashes_in_buckets_finished;
+            } else if (master.use_rpc_stream()) {
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_started;
                 master.peer_row_hash_sets(node_idx) = master.get_full_row_hashes_with_rpc_stream(node, node_idx).get0();
                 ns.state = repair_state::get_full_row_hashes_with_rpc_stream_finished;
@@ -22,6 +22,7 @@
 #include <seastar/core/seastar.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/core/sleep.hh>
 #include <seastar/coroutine/as_future.hh>
 #include <seastar/core/reactor.hh>
 #include <seastar/core/metrics.hh>
@@ -307,6 +308,16 @@ class db_user_types_storage : public data_dictionary::dummy_user_types_storage {
     }
 };
 
+static cache_tracker::admission_policy cache_admission_policy_from_string(const sstring& policy) {
+    // Values are validated by the config.
+    return policy == "frequency" ? cache_tracker::admission_policy::frequency : cache_tracker::admission_policy::all;
+}
+
+static cache_tracker::eviction_policy cache_eviction_policy_from_string(const sstring& policy) {
+    // Values are validated by the config.
+    return policy == "second_chance" ? cache_tracker::eviction_policy::second_chance : cache_tracker::eviction_policy::lru;
+}
+
 database::database(const db::config& cfg, database_config dbcfg, service::migration_notifier& mn, gms::feature_service& feat, const locator::shared_token_metadata& stm,
         compaction_manager& cm, sharded<sstables::directory_semaphore>& sst_dir_sem, utils::cross_shard_barrier barrier)
     : _stats(make_lw_shared<db_stats>())
@@ -315,7 +326,12 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _cfg(cfg)
     // Allow system tables a pool of 10 MB memory to write, but never block on other regions.
     , _system_dirty_memory_manager(*this, 10 << 20, cfg.unspooled_dirty_soft_limit(), default_scheduling_group())
-    , _dirty_memory_manager(*this, dbcfg.available_memory * 0.50, cfg.unspooled_dirty_soft_limit(), dbcfg.statement_scheduling_group)
+    , _dirty_memory_manager(*this, dbcfg.available_memory * 0.50, cfg.unspooled_dirty_soft_limit(), dbcfg.statement_scheduling_group,
+            dirty_memory_manager::throttling_config{
+                .throttle_start = cfg.unspooled_dirty_throttle_start(),
+                .max_throttle_delay = std::chrono::milliseconds(cfg.unspooled_dirty_max_throttle_delay_in_ms()),
+                .max_concurrent_flushes = cfg.memtable_max_concurrent_flushes(),
+            })
     , _dbcfg(dbcfg)
     , _flush_sg(backlog_controller::scheduling_group{dbcfg.memtable_scheduling_group, service::get_local_memtable_flush_priority()})
     , _memtable_controller(make_flush_controller(_cfg, _flush_sg, [this, limit = float(_dirty_memory_manager.throttle_threshold())] {
@@ -366,6 +382,8 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _system_sstables_manager(std::make_unique<sstables::sstables_manager>(*_nop_large_data_handler, _cfg, feat, _row_cache_tracker, dbcfg.available_memory, sst_dir_sem.local()))
     , _result_memory_limiter(dbcfg.available_memory / 10)
     , _data_listeners(std::make_unique<db::data_listeners>())
+    , _hot_partitions(std::make_unique<db::hot_partitions_data_listener>(*this, _cfg.hot_partitions_sampling_period))
+    , _write_path_profiler(_cfg.write_path_profiling_period)
     , _mnotifier(mn)
     , _feat(feat)
     , _shared_token_metadata(stm)
@@ -374,18 +392,38 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _stop_barrier(std::move(barrier))
     , _update_memtable_flush_static_shares_action([this, &cfg] { return _memtable_controller.update_static_shares(cfg.memtable_flush_static_shares()); })
     , _memtable_flush_static_shares_observer(cfg.memtable_flush_static_shares.observe(_update_memtable_flush_static_shares_action.make_observer()))
+    , _cache_admission_policy_observer(cfg.cache_admission_policy.observe([this] (const sstring& policy) {
+        _row_cache_tracker.set_admission_policy(cache_admission_policy_from_string(policy));
+    }))
+    , _cache_eviction_policy_observer(cfg.cache_eviction_policy.observe([this] (const sstring& policy) {
+        _row_cache_tracker.set_eviction_policy(cache_eviction_policy_from_string(policy));
+    }))
 {
     assert(dbcfg.available_memory != 0); // Detect misconfigured unit tests, see #7544
 
     local_schema_registry().init(*this); // TODO: we're never unbound.
     setup_metrics();
 
+    _read_concurrency_sem.set_deadline_shedding(_cfg.reader_concurrency_semaphore_deadline_shedding);
     _row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
+    _row_cache_tracker.set_admission_policy(cache_admission_policy_from_string(cfg.cache_admission_policy()));
+    _row_cache_tracker.set_eviction_policy(cache_eviction_policy_from_string(cfg.cache_eviction_policy()));
 
     setup_scylla_memory_diagnostics_producer();
     if (_dbcfg.sstables_format) {
         set_format(*_dbcfg.sstables_format);
     }
+
+    // Feed the compaction controller back with the latency of the disk reads
+    // of user queries, averaged over each of its ticks.
+    _compaction_manager.plug_foreground_read_latency([this, ios = uint64_t(0), latency_us = uint64_t(0)] () mutable -> float {
+        auto& stats = _read_concurrency_sem.get_stats();
+        auto delta_ios = stats.disk_read_ios - ios;
+        auto delta_latency_us = stats.disk_read_io_latency_us - latency_us;
+        ios = stats.disk_read_ios;
+        latency_us = stats.disk_read_io_latency_us;
+        return delta_ios ? float(delta_latency_us) / delta_ios : 0.0f;
+    });
 }
 
 const db::extensions& database::extensions() const {
@@ -504,6 +542,9 @@ database::setup_metrics() {
                        sm::description(seastar::format("Holds the current number of requests blocked due to reaching the memory quota ({}B). "
                                        "Non-zero value indicates that our bottleneck is memory and more specifically - the memory quota allocated for the \"database\" component.", _dirty_memory_manager.throttle_threshold()))),
 
+        sm::make_counter("requests_delayed_memory", [this] { return _dirty_memory_manager.region_group().delayed_requests_counter(); },
+                       sm::description("Counts requests delayed as unspooled dirty memory approaches the memory quota, see unspooled_dirty_throttle_start.")),
+
         sm::make_counter("clustering_filter_count", _cf_stats.clustering_filter_count,
                        sm::description("Counts bloom filter invocations.")),
 
@@ -537,6 +578,10 @@ database::setup_metrics() {
         sm::make_counter("total_writes_rate_limited", _stats->total_writes_rate_limited,
                        sm::description("Counts write operations which were rejected on the replica side because the per-partition limit was reached.")),
 
+        sm::make_counter("counter_updates_coalesced", _stats->counter_updates_coalesced,
+                       sm::description("Counts counter updates which were merged into a pending update of the same partition, "
+                                       "see counter_update_coalescing_window_in_us.")),
+
         sm::make_counter("total_reads", _read_concurrency_sem.get_stats().total_successful_reads,
                        sm::description("Counts the total number of successful user reads on this shard."),
                        {user_label_instance}),
@@ -580,6 +625,13 @@ database::setup_metrics() {
         sm::make_gauge("querier_cache_population", _querier_cache.get_stats().population,
                        sm::description("The number of entries currently in the querier cache.")),
 
+        sm::make_counter("querier_cache_resumes", _querier_cache.get_stats().resumes,
+                       sm::description("Counts querier cache lookups that found a cached querier to resume.")),
+
+        sm::make_counter("querier_cache_resumed_pause_ms", _querier_cache.get_stats().resumed_pause_ms,
+                       sm::description("Counts the time, in milliseconds, resumed queriers spent in the querier cache between pages. "
+                                       "Divided by querier_cache_resumes, it gives the average time between pages.")),
+
         sm::make_counter("sstable_read_queue_overloads", _read_concurrency_sem.get_stats().total_reads_shed_due_to_overload,
                        sm::description("Counts the number of times the sstable read queue was overloaded. "
                                        "A non-zero value indicates that we have to drop read requests because they arrive faster than we can serve them.")),
@@ -614,6 +666,11 @@ database::setup_metrics() {
                                        " When the queue is full, excessive reads are shed to avoid overload."),
                        {user_label_instance}),
 
+        sm::make_counter("reads_shed_due_to_deadline", _read_concurrency_sem.get_stats().total_reads_shed_due_to_deadline,
+                       sm::description("The number of reads shed on admission, because they were not expected to complete before their timeout."
+                                       " See reader_concurrency_semaphore_deadline_shedding."),
+                       {user_label_instance}),
+
         sm::make_gauge("disk_reads", [this] { return _read_concurrency_sem.get_stats().disk_reads; },
                        sm::description("Holds the number of currently active disk read operations. "),
                        {user_label_instance}),
@@ -749,6 +806,7 @@ void database::set_format(sstables::sstable_version_types format) noexcept {
 }
 
 database::~database() {
+    _compaction_manager.unplug_foreground_read_latency();
     _user_types->deactivate();
 }
 
@@ -1265,6 +1323,7 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.enable_metrics_reporting = db_config.enable_keyspace_column_family_metrics();
     cfg.reversed_reads_auto_bypass_cache = db_config.reversed_reads_auto_bypass_cache;
     cfg.enable_optimized_reversed_reads = db_config.enable_optimized_reversed_reads;
+    cfg.memtable_flush_parallelism = db_config.memtable_flush_parallelism;
     cfg.tombstone_warn_threshold = db_config.tombstone_warn_threshold();
     cfg.view_update_concurrency_semaphore = _config.view_update_concurrency_semaphore;
     cfg.view_update_concurrency_semaphore_limit = _config.view_update_concurrency_semaphore_limit;
@@ -1465,6 +1524,21 @@ std::optional<db::rate_limiter::can_proceed> database::account_coordinator_opera
     return _rate_limiter.account_operation(lbl, dht::token::to_int64(token), *table_limit, account_and_enforce_info);
 }
 
+bool database::can_apply_table_rate_limit(const schema& s, db::operation_type op_type) const {
+    return s.per_partition_rate_limit_options().get_max_table_ops_per_second(op_type).has_value()
+            && classify_request(_dbcfg) == request_class::user;
+}
+
+db::rate_limiter::can_proceed database::account_coordinator_operation_to_table_rate_limit(table& tbl,
+        db::per_partition_rate_limit::account_and_enforce account_and_enforce_info,
+        db::operation_type op_type) {
+    uint32_t table_limit = *tbl.schema()->per_partition_rate_limit_options().get_max_table_ops_per_second(op_type);
+    uint64_t shard_limit = std::max<uint64_t>(table_limit / smp::count, 1);
+    db::rate_limiter::label& lbl = tbl.get_table_rate_limiter_label_for_op_type(op_type);
+    // All operations of the table are counted under a single key.
+    return _rate_limiter.account_operation(lbl, 0, shard_limit, account_and_enforce_info);
+}
+
 static db::rate_limiter::can_proceed account_singular_ranges_to_rate_limit(
         db::rate_limiter& limiter, column_family& cf,
         const dht::partition_range_vector& ranges,
@@ -1521,7 +1595,9 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
         querier_opt = _querier_cache.lookup_data_querier(cmd.query_uuid, *s, ranges.front(), cmd.slice, trace_state, timeout);
     }
 
+    auto queued_at = utils::latency_counter::now();
     auto read_func = [&, this] (reader_permit permit) {
+        cf.get_stats().read_admission.mark(utils::latency_counter::now() - queued_at);
         reader_permit::used_guard ug{permit};
         permit.set_max_result_size(max_result_size);
         return cf.query(std::move(s), std::move(permit), cmd, opts, ranges, trace_state, get_result_memory_limiter(),
@@ -1652,6 +1728,16 @@ reader_concurrency_semaphore& database::get_reader_concurrency_semaphore() {
     std::abort();
 }
 
+reader_concurrency_semaphore::resource_usage_by_table_type database::get_reads_resource_usage() const {
+    reader_concurrency_semaphore::resource_usage_by_table_type usage;
+    for (auto* sem : {&_read_concurrency_sem, &_streaming_concurrency_sem, &_system_read_concurrency_sem, &_compaction_concurrency_sem}) {
+        for (const auto& [id, table_usage] : sem->resource_usage_by_table()) {
+            usage[id] += table_usage;
+        }
+    }
+    return usage;
+}
+
 future<reader_permit> database::obtain_reader_permit(table& tbl, const char* const op_name, db::timeout_clock::time_point timeout) {
     return get_reader_concurrency_semaphore().obtain_permit(tbl.schema().get(), op_name, tbl.estimate_read_memory_cost(), timeout);
 }
@@ -1675,11 +1761,8 @@ std::ostream& operator<<(std::ostream& out, const database& db) {
     return out;
 }
 
-future<mutation> database::do_apply_counter_update(column_family& cf, const frozen_mutation& fm, schema_ptr m_schema,
+future<mutation> database::do_apply_counter_update(column_family& cf, mutation m,
                                                    db::timeout_clock::time_point timeout,tracing::trace_state_ptr trace_state) {
-    auto m = fm.unfreeze(m_schema);
-    m.upgrade(cf.schema());
-
     // prepare partition slice
     query::column_id_vector static_columns;
     static_columns.reserve(m.partition().static_row().size());
@@ -1733,6 +1816,69 @@ future<mutation> database::do_apply_counter_update(column_family& cf, const froz
     });
 }
 
+// Increments can be merged in any order. Merging deletions with increments
+// could change which of them wins.
+static bool is_counter_increment(const mutation& m) {
+    const auto& p = m.partition();
+    if (p.partition_tombstone() || !p.row_tombstones().empty()) {
+        return false;
+    }
+    bool all_live = true;
+    auto check_cells = [&] (column_kind kind) {
+        return [&, kind] (column_id id, const atomic_cell_or_collection& c) {
+            all_live &= c.as_atomic_cell(m.schema()->column_at(kind, id)).is_live();
+        };
+    };
+    p.static_row().for_each_cell(check_cells(column_kind::static_column));
+    for (const auto& cr : p.clustered_rows()) {
+        if (cr.row().deleted_at()) {
+            return false;
+        }
+        cr.row().cells().for_each_cell(check_cells(column_kind::regular_column));
+    }
+    return all_live;
+}
+
+future<mutation> database::coalesce_counter_update(column_family& cf, mutation m, db::timeout_clock::time_point timeout,
+        tracing::trace_state_ptr trace_state, std::chrono::microseconds window) {
+    if (!is_counter_increment(m)) {
+        co_return co_await do_apply_counter_update(cf, std::move(m), timeout, std::move(trace_state));
+    }
+    auto key = std::make_pair(cf.schema()->id(), to_bytes(m.key().representation()));
+    auto it = _pending_counter_updates.find(key);
+    if (it != _pending_counter_updates.end() && it->second->m.schema() == m.schema()) {
+        auto pending = it->second;
+        pending->m.apply(m);
+        pending->timeout = std::min(pending->timeout, timeout);
+        ++_stats->counter_updates_coalesced;
+        tracing::trace(trace_state, "Coalesced the counter update with a pending one");
+        co_return co_await pending->result.get_shared_future();
+    }
+
+    auto op = cf.write_in_progress();
+    auto pending = make_lw_shared<pending_counter_update>(std::move(m), timeout);
+    _pending_counter_updates.insert_or_assign(key, pending);
+    tracing::trace(trace_state, "Waiting {}us for counter updates to coalesce with", window.count());
+    co_await sleep(window);
+    it = _pending_counter_updates.find(key);
+    if (it != _pending_counter_updates.end() && it->second == pending) {
+        _pending_counter_updates.erase(it);
+    }
+
+    // The waiters replicate the merged mutation too. Applying it more than
+    // once has no effect, since it carries the new state of the counters'
+    // shards.
+    auto f = co_await coroutine::as_future(do_apply_counter_update(cf, std::move(pending->m), pending->timeout, std::move(trace_state)));
+    if (f.failed()) {
+        auto ex = f.get_exception();
+        pending->result.set_exception(ex);
+        co_await coroutine::return_exception_ptr(std::move(ex));
+    }
+    auto res = f.get();
+    pending->result.set_value(res);
+    co_return res;
+}
+
 future<> memtable_list::flush() {
     if (!may_flush()) {
         return make_ready_future<>();
@@ -1775,6 +1921,18 @@ future<> database::apply_in_memory(const frozen_mutation& m, schema_ptr m_schema
     });
 }
 
+future<> database::apply_in_memory(std::span<const frozen_mutation* const> muts, schema_ptr m_schema, std::vector<db::rp_handle>&& handles, db::timeout_clock::time_point timeout) {
+    auto& cf = find_column_family(muts.front()->column_family_id());
+
+    for (auto* m : muts) {
+        data_listeners().on_write(m_schema, *m);
+    }
+
+    return with_gate(cf.async_gate(), [muts, m_schema = std::move(m_schema), handles = std::move(handles), &cf, timeout] () mutable -> future<> {
+        return cf.apply(muts, std::move(m_schema), std::move(handles), timeout);
+    });
+}
+
 future<> database::apply_in_memory(const mutation& m, column_family& cf, db::rp_handle&& h, db::timeout_clock::time_point timeout) {
     return with_gate(cf.async_gate(), [this, &m, h = std::move(h), &cf, timeout]() mutable -> future<> {
         return cf.apply(m, std::move(h), timeout);
@@ -1793,7 +1951,13 @@ future<mutation> database::apply_counter_update(schema_ptr s, const frozen_mutat
     }
     try {
         auto& cf = find_column_family(m.column_family_id());
-        return do_apply_counter_update(cf, m, s, timeout, std::move(trace_state));
+        auto mut = m.unfreeze(s);
+        mut.upgrade(cf.schema());
+        auto window = std::chrono::microseconds(_cfg.counter_update_coalescing_window_in_us());
+        if (window.count()) {
+            return coalesce_counter_update(cf, std::move(mut), timeout, std::move(trace_state), window);
+        }
+        return do_apply_counter_update(cf, std::move(mut), timeout, std::move(trace_state));
     } catch (no_such_column_family&) {
         dblog.error("Attempting to mutate non-existent table {}", m.column_family_id());
         throw;
@@ -1913,10 +2077,17 @@ future<> database::do_apply_many(const std::vector<frozen_mutation>& muts, db::t
     std::vector<rp_handle> handles = co_await cl->add_entries(std::move(writers), timeout);
 
     // FIXME: Memtable application is not atomic so reads may observe mutations partially applied until restart.
-    for (size_t i = 0; i < muts.size(); ++i) {
-        auto&& cf = find_column_family(muts[i].column_family_id());
+    // Consecutive mutations of the same table and schema are applied as a batch,
+    // which coalesces those of the same partition.
+    for (size_t i = 0; i < muts.size();) {
         auto s = local_schema_registry().get(muts[i].schema_version());
-        co_await apply_in_memory(muts[i], s, std::move(handles[i]), timeout);
+        std::vector<const frozen_mutation*> batch;
+        std::vector<rp_handle> batch_handles;
+        for (; i < muts.size() && muts[i].column_family_id() == s->id() && muts[i].schema_version() == s->version(); ++i) {
+            batch.push_back(&muts[i]);
+            batch_handles.push_back(std::move(handles[i]));
+        }
+        co_await apply_in_memory(batch, s, std::move(batch_handles), timeout);
     }
 }
 
@@ -1947,6 +2118,7 @@ future<> database::do_apply(schema_ptr s, const frozen_mutation& m, tracing::tra
     // so it knows when new writes start being sent to a new view.
     auto op = cf.write_in_progress();
 
+    auto timer = _write_path_profiler.sample();
     row_locker::lock_holder lock;
     if (!cf.views().empty()) {
         auto lock_f = co_await coroutine::as_future(cf.push_view_replica_updates(s, m, timeout, std::move(tr_state), get_reader_concurrency_semaphore()));
@@ -1958,6 +2130,7 @@ future<> database::do_apply(schema_ptr s, const frozen_mutation& m, tracing::tra
             co_await coroutine::return_exception_ptr(std::move(ex));
         }
         lock = lock_f.get();
+        timer.end_stage(db::write_stage::view_updates);
     }
 
     // purposefully manually "inlined" apply_with_commitlog call here to reduce # coroutine
@@ -1968,8 +2141,12 @@ future<> database::do_apply(schema_ptr s, const frozen_mutation& m, tracing::tra
         std::exception_ptr ex;
         try {
             commitlog_entry_writer cew(s, m, sync);
+            utils::latency_counter lc;
+            lc.start();
             auto f_h = co_await coroutine::as_future(cf.commitlog()->add_entry(uuid, cew, timeout));
             if (!f_h.failed()) {
+                cf.get_stats().commitlog_writes.mark(lc.stop());
+                timer.end_stage(db::write_stage::commitlog);
                 h = f_h.get();
             } else {
                 ex = f_h.get_exception();
@@ -1999,6 +2176,7 @@ future<> database::do_apply(schema_ptr s, const frozen_mutation& m, tracing::tra
       }
       co_await coroutine::return_exception_ptr(std::move(ex));
     }
+    timer.end_stage(db::write_stage::memtable);
     // Success, prevent incrementing failure counter
     update_writes_failed.cancel();
 }
@@ -2207,6 +2385,7 @@ future<> database::shutdown() {
     // Closing a table can cause us to find a large partition. Since we want to record that, we have to close
     // system.large_partitions after the regular tables.
     co_await close_tables(database::table_kind::user);
+    co_await _large_data_handler->flush_records();
     co_await close_tables(database::table_kind::system);
     co_await _large_data_handler->stop();
     // Don't shutdown the keyspaces just yet,
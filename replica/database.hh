@@ -60,8 +60,10 @@
 #include "absl-flat_hash_map.hh"
 #include "utils/cross-shard-barrier.hh"
 #include "sstables/generation_type.hh"
+#include "sstables/read_ahead.hh"
 #include "db/rate_limiter.hh"
 #include "db/operation_type.hh"
+#include "db/write_path_profiler.hh"
 #include "utils/serialized_action.hh"
 #include "compaction/compaction_manager.hh"
 #include "utils/disk-error-handler.hh"
@@ -117,6 +119,7 @@ class config;
 class extensions;
 class rp_handle;
 class data_listeners;
+class hot_partitions_data_listener;
 class large_data_handler;
 class system_keyspace;
 class table_selector;
@@ -340,10 +343,17 @@ struct table_stats {
     utils::timed_rate_moving_average_summary_and_histogram cas_prepare{256};
     utils::timed_rate_moving_average_summary_and_histogram cas_accept{256};
     utils::timed_rate_moving_average_summary_and_histogram cas_learn{256};
+    // The phases of the reads and writes, which are part of their latency
+    // above: waiting for the admission of the read by the reader concurrency
+    // semaphore, and adding the write to the commitlog.
+    utils::timed_rate_moving_average_summary_and_histogram read_admission{256};
+    utils::timed_rate_moving_average_summary_and_histogram commitlog_writes{256};
     utils::estimated_histogram estimated_sstable_per_read{35};
     utils::timed_rate_moving_average_and_histogram tombstone_scanned;
     utils::timed_rate_moving_average_and_histogram live_scanned;
     utils::estimated_histogram estimated_coordinator_read;
+    // Shared with the sstables of the table.
+    lw_shared_ptr<sstables::data_read_stats> sstable_data_reads = make_lw_shared<sstables::data_read_stats>();
 };
 
 class table : public enable_lw_shared_from_this<table> {
@@ -376,6 +386,7 @@ class table : public enable_lw_shared_from_this<table> {
         // for easy access from `table` member functions:
         utils::updateable_value<bool> reversed_reads_auto_bypass_cache{false};
         utils::updateable_value<bool> enable_optimized_reversed_reads{true};
+        utils::updateable_value<uint32_t> memtable_flush_parallelism{1};
         // Can be updated by a schema change:
         bool enable_optimized_twcs_queries{true};
         uint32_t tombstone_warn_threshold{0};
@@ -402,6 +413,7 @@ class table : public enable_lw_shared_from_this<table> {
 
     template<typename... Args>
     void do_apply(compaction_group& cg, db::rp_handle&&, Args&&... args);
+    void do_apply(compaction_group& cg, std::span<const frozen_mutation* const> muts, const schema_ptr& m_schema, std::vector<db::rp_handle>&& handles);
 
     lw_shared_ptr<memtable_list> make_memory_only_memtable_list();
     lw_shared_ptr<memtable_list> make_memtable_list(compaction_group& cg);
@@ -444,6 +456,9 @@ class table : public enable_lw_shared_from_this<table> {
     // Labels used to identify writes and reads for this table in the rate_limiter structure.
     db::rate_limiter::label _rate_limiter_label_for_writes;
     db::rate_limiter::label _rate_limiter_label_for_reads;
+    // Labels used to count all writes and reads for this table, for the table-wide limits.
+    db::rate_limiter::label _table_rate_limiter_label_for_writes;
+    db::rate_limiter::label _table_rate_limiter_label_for_reads;
 
     void set_metrics();
     seastar::metrics::metric_groups _metrics;
@@ -467,7 +482,7 @@ class table : public enable_lw_shared_from_this<table> {
 
     double _cached_percentile = -1;
     lowres_clock::time_point _percentile_cache_timestamp;
-    std::chrono::milliseconds _percentile_cache_value;
+    std::optional<std::chrono::microseconds> _percentile_cache_value;
 
     // Phaser used to synchronize with in-progress writes. This is useful for code that,
     // after some modification, needs to ensure that news writes will see it before
@@ -591,7 +606,11 @@ class table : public enable_lw_shared_from_this<table> {
                                         const io_priority_class& pc,
                                         tracing::trace_state_ptr trace_state,
                                         streamed_mutation::forwarding fwd,
-                                        mutation_reader::forwarding fwd_mr) const;
+                                        mutation_reader::forwarding fwd_mr,
+                                        sstables::sstable_filter_type range_filter = {}) const;
+
+    // Returns a filter of the sstables which a range scan of the slice may skip, if any.
+    sstables::sstable_filter_type make_clustering_filter_for_scan(const query::partition_slice& slice) const;
 
     lw_shared_ptr<sstables::sstable_set> make_maintenance_sstable_set() const;
     lw_shared_ptr<sstables::sstable_set> make_compound_sstable_set();
@@ -686,6 +705,11 @@ class table : public enable_lw_shared_from_this<table> {
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
             const dht::partition_range_vector& ranges) const;
 
+    // Like the above, but doesn't read the given sstables, which are
+    // streamed by other means.
+    flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
+            const dht::partition_range_vector& ranges, std::unordered_set<sstables::shared_sstable> excluded) const;
+
     // Single range overload.
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
             const query::partition_slice& slice,
@@ -741,6 +765,16 @@ class table : public enable_lw_shared_from_this<table> {
         std::abort(); // compiler will error if we get here
     }
 
+    db::rate_limiter::label& get_table_rate_limiter_label_for_op_type(db::operation_type op_type) {
+        switch (op_type) {
+        case db::operation_type::write:
+            return _table_rate_limiter_label_for_writes;
+        case db::operation_type::read:
+            return _table_rate_limiter_label_for_reads;
+        }
+        std::abort(); // compiler will error if we get here
+    }
+
     db::rate_limiter::label& get_rate_limiter_label_for_writes() {
         return _rate_limiter_label_for_writes;
     }
@@ -778,6 +812,8 @@ class table : public enable_lw_shared_from_this<table> {
 
     future<> apply(const frozen_mutation& m, schema_ptr m_schema, db::rp_handle&& h, db::timeout_clock::time_point tmo);
     future<> apply(const mutation& m, db::rp_handle&& h, db::timeout_clock::time_point tmo);
+    // Applies mutations of the same schema together, see memtable::apply().
+    future<> apply(std::span<const frozen_mutation* const> muts, schema_ptr m_schema, std::vector<db::rp_handle>&& handles, db::timeout_clock::time_point tmo);
 
     // Returns at most "cmd.limit" rows
     // The saved_querier parameter is an input-output parameter which contains
@@ -1020,7 +1056,10 @@ class table : public enable_lw_shared_from_this<table> {
             std::vector<sstables::shared_sstable>& excluded_sstables) const;
 
     void add_coordinator_read_latency(utils::estimated_histogram::duration latency);
-    std::chrono::milliseconds get_coordinator_read_latency_percentile(double percentile);
+    // Returns the given percentile of recent coordinator read latencies, recomputed
+    // at most once per second, or std::nullopt if there weren't enough recent reads
+    // to estimate it.
+    std::optional<std::chrono::microseconds> get_coordinator_read_latency_percentile(double percentile);
 
     secondary_index::secondary_index_manager& get_index_manager() {
         return _index_manager;
@@ -1279,6 +1318,7 @@ class database : public peering_sharded_service<database> {
         uint64_t total_writes_failed = 0;
         uint64_t total_writes_timedout = 0;
         uint64_t total_writes_rate_limited = 0;
+        uint64_t counter_updates_coalesced = 0;
         uint64_t total_reads = 0;
         uint64_t total_reads_failed = 0;
         uint64_t total_reads_rate_limited = 0;
@@ -1353,6 +1393,18 @@ class database : public peering_sharded_service<database> {
 
     friend db::data_listeners;
     std::unique_ptr<db::data_listeners> _data_listeners;
+    std::unique_ptr<db::hot_partitions_data_listener> _hot_partitions;
+    db::write_path_profiler _write_path_profiler;
+
+    // A counter update of a partition waiting for the coalescing window to
+    // end. The increments of the partition made meanwhile are merged into
+    // it, and share its read-modify-write.
+    struct pending_counter_update {
+        mutation m;
+        db::timeout_clock::time_point timeout;
+        shared_promise<mutation> result;
+    };
+    std::unordered_map<std::pair<table_id, bytes>, lw_shared_ptr<pending_counter_update>, utils::tuple_hash> _pending_counter_updates;
 
     service::migration_notifier& _mnotifier;
     gms::feature_service& _feat;
@@ -1368,6 +1420,8 @@ class database : public peering_sharded_service<database> {
 
     serialized_action _update_memtable_flush_static_shares_action;
     utils::observer<float> _memtable_flush_static_shares_observer;
+    utils::observer<sstring> _cache_admission_policy_observer;
+    utils::observer<sstring> _cache_eviction_policy_observer;
 
 public:
     data_dictionary::database as_data_dictionary() const;
@@ -1377,6 +1431,7 @@ class database : public peering_sharded_service<database> {
     const gms::feature_service& features() const { return _feat; }
     future<> apply_in_memory(const frozen_mutation& m, schema_ptr m_schema, db::rp_handle&&, db::timeout_clock::time_point timeout);
     future<> apply_in_memory(const mutation& m, column_family& cf, db::rp_handle&&, db::timeout_clock::time_point timeout);
+    future<> apply_in_memory(std::span<const frozen_mutation* const> muts, schema_ptr m_schema, std::vector<db::rp_handle>&&, db::timeout_clock::time_point timeout);
 
     wasmtime::Engine& wasm_engine() {
         return *_wasm_engine;
@@ -1405,8 +1460,10 @@ class database : public peering_sharded_service<database> {
     future<> do_apply_many(const std::vector<frozen_mutation>&, db::timeout_clock::time_point timeout);
     future<> apply_with_commitlog(column_family& cf, const mutation& m, db::timeout_clock::time_point timeout);
 
-    future<mutation> do_apply_counter_update(column_family& cf, const frozen_mutation& fm, schema_ptr m_schema, db::timeout_clock::time_point timeout,
+    future<mutation> do_apply_counter_update(column_family& cf, mutation m, db::timeout_clock::time_point timeout,
                                              tracing::trace_state_ptr trace_state);
+    future<mutation> coalesce_counter_update(column_family& cf, mutation m, db::timeout_clock::time_point timeout,
+                                             tracing::trace_state_ptr trace_state, std::chrono::microseconds window);
 
     template<typename Future>
     Future update_write_metrics(Future&& f);
@@ -1547,6 +1604,17 @@ class database : public peering_sharded_service<database> {
             db::per_partition_rate_limit::account_and_enforce account_and_enforce_info,
             db::operation_type op_type);
 
+    /// Checks whether the table-wide rate limit can be applied to the operation or not.
+    bool can_apply_table_rate_limit(const schema& s, db::operation_type op_type) const;
+
+    /// Accounts given operation to the table-wide rate limit of the coordinator.
+    /// This function can be called ONLY when the limit can be applied to the operation (see `can_apply_table_rate_limit`).
+    /// The limit is split evenly between the shards, each of which enforces its part
+    /// on the operations it coordinates.
+    db::rate_limiter::can_proceed account_coordinator_operation_to_table_rate_limit(table& tbl,
+            db::per_partition_rate_limit::account_and_enforce account_and_enforce_info,
+            db::operation_type op_type);
+
     future<std::tuple<lw_shared_ptr<query::result>, cache_temperature>> query(schema_ptr, const query::read_command& cmd, query::result_options opts,
                                                                   const dht::partition_range_vector& ranges, tracing::trace_state_ptr trace_state,
                                                                   db::timeout_clock::time_point timeout, db::per_partition_rate_limit::info rate_limit_info = std::monostate{});
@@ -1690,6 +1758,10 @@ class database : public peering_sharded_service<database> {
         return _querier_cache.get_stats();
     }
 
+    // The resources used by the completed reads of each table on this shard,
+    // summed over all read concurrency semaphores.
+    reader_concurrency_semaphore::resource_usage_by_table_type get_reads_resource_usage() const;
+
     query::querier_cache& get_querier_cache() {
         return _querier_cache;
     }
@@ -1698,6 +1770,15 @@ class database : public peering_sharded_service<database> {
         return {max_memory_pending_view_updates() - _view_update_concurrency_sem.current(), max_memory_pending_view_updates()};
     }
 
+    db::hot_partitions_data_listener& get_hot_partitions() {
+        return *_hot_partitions;
+    }
+
+    // Shared with storage_proxy, which times the coordinator's stages.
+    db::write_path_profiler& get_write_path_profiler() {
+        return _write_path_profiler;
+    }
+
     db::data_listeners& data_listeners() const {
         return *_data_listeners;
     }
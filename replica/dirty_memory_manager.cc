@@ -94,6 +94,16 @@ region_group::moved(logalloc::region* old_address, logalloc::region* new_address
     region_group_binomial_group_sanity_check(_regions);
 }
 
+db::timeout_clock::duration region_group::throttle_delay() const noexcept {
+    const auto start = _cfg.unspooled_throttle_start;
+    const auto limit = unspooled_throttle_threshold();
+    if (_unspooled_total_memory <= start || start >= limit) {
+        return db::timeout_clock::duration::zero();
+    }
+    auto pressure = std::min(double(_unspooled_total_memory - start) / (limit - start), 1.0);
+    return std::chrono::duration_cast<db::timeout_clock::duration>(_cfg.max_throttle_delay * pressure);
+}
+
 bool
 region_group::execution_permitted() noexcept {
     return !under_unspooled_pressure() && !_under_real_pressure;
@@ -193,7 +203,9 @@ future<>
 region_group::shutdown() noexcept {
     _shutdown_requested = true;
     _relief.signal();
-    return std::move(_releaser);
+    return _delayed_requests.close().then([this] {
+        return std::move(_releaser);
+    });
 }
 
 void region_group::on_request_expiry::operator()(std::unique_ptr<allocating_function>& func) noexcept {
@@ -206,15 +218,18 @@ future<flush_permit> flush_permit::reacquire_sstable_write_permit() && {
     return _manager->get_flush_permit(std::move(_background_permit));
 }
 
-dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg)
+dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg,
+        throttling_config throttling)
     : _db(&db)
     , _region_group("memtable (unspooled)", dirty_memory_manager_logalloc::reclaim_config{
             .unspooled_hard_limit = threshold / 2,
             .unspooled_soft_limit = threshold * soft_limit / 2,
             .real_hard_limit = threshold,
+            .unspooled_throttle_start = throttling.throttle_start < 1.0 ? size_t(threshold * throttling.throttle_start / 2) : std::numeric_limits<size_t>::max(),
+            .max_throttle_delay = throttling.max_throttle_delay,
             .start_reclaiming = std::bind_front(&dirty_memory_manager::start_reclaiming, this)
       }, deferred_work_sg)
-    , _flush_serializer(1)
+    , _flush_serializer(std::max(throttling.max_concurrent_flushes, 1u))
     , _waiting_flush(flush_when_needed()) {}
 
 void
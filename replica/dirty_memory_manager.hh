@@ -12,8 +12,10 @@
 #include <boost/heap/binomial_heap.hpp>
 #include <seastar/core/condition-variable.hh>
 #include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/sleep.hh>
 #include "replica/database_fwd.hh"
 #include "utils/logalloc.hh"
 
@@ -92,6 +94,10 @@ struct reclaim_config {
     size_t unspooled_hard_limit = std::numeric_limits<size_t>::max();
     size_t unspooled_soft_limit = unspooled_hard_limit;
     size_t real_hard_limit = std::numeric_limits<size_t>::max();
+    // Above this much unspooled memory, requests are delayed before they run,
+    // by up to max_throttle_delay as unspooled memory approaches the hard limit.
+    size_t unspooled_throttle_start = std::numeric_limits<size_t>::max();
+    db::timeout_clock::duration max_throttle_delay = db::timeout_clock::duration::zero();
     reclaim_start_callback start_reclaiming = [] () noexcept {};
     reclaim_stop_callback stop_reclaiming = [] () noexcept {};
 };
@@ -167,6 +173,9 @@ class region_group : public logalloc::region_listener {
     expiring_fifo<std::unique_ptr<allocating_function>, on_request_expiry, db::timeout_clock> _blocked_requests;
 
     uint64_t _blocked_requests_counter = 0;
+    uint64_t _delayed_requests_counter = 0;
+    // Keeps the group alive for requests sleeping in their throttle delay.
+    gate _delayed_requests;
 
     size_t _unspooled_total_memory = 0;
 
@@ -223,6 +232,13 @@ class region_group : public logalloc::region_listener {
     }
 
     void execute_one();
+
+    // How long a request is delayed before it runs, growing linearly from zero at
+    // the throttle start to max_throttle_delay at the hard limit.
+    db::timeout_clock::duration throttle_delay() const noexcept;
+
+    template <typename Func>
+    futurize_t<std::result_of_t<Func()>> run_or_queue(Func&& func, db::timeout_clock::time_point timeout);
 public:
     size_t unspooled_throttle_threshold() const noexcept {
         return _cfg.unspooled_hard_limit;
@@ -307,6 +323,10 @@ class region_group : public logalloc::region_listener {
     // region_groups.
     //
     // When timeout is reached first, the returned future is resolved with timed_out_error exception.
+    //
+    // Between the throttle start and the hard limit, the function is delayed before it runs, with
+    // the delay growing as memory usage approaches the hard limit, so that writers slow down
+    // gradually rather than all being blocked when the hard limit is reached.
     template <typename Func>
     // We disallow future-returning functions here, because otherwise memory may be available
     // when we start executing it, but no longer available in the middle of the execution.
@@ -325,6 +345,8 @@ class region_group : public logalloc::region_listener {
     size_t blocked_requests() const noexcept;
 
     uint64_t blocked_requests_counter() const noexcept;
+
+    uint64_t delayed_requests_counter() const noexcept;
 private:
     // Returns true if and only if constraints of this group are not violated.
     // That's taking into account any constraints imposed by enclosing (parent) groups.
@@ -401,6 +423,9 @@ class dirty_memory_manager {
     // memtable is totally gone. That means that if we have throttled requests, they will stay
     // throttled for a long time. Even when we have unspooled dirty, that only provides a rough
     // estimate, and we can't release requests that early.
+    //
+    // On disks fast enough to write more than one memtable at a time, more concurrent flushes can
+    // be allowed, so that spooling keeps up with ingest.
     semaphore _flush_serializer;
     // We will accept a new flush before another one ends, once it is done with the data write.
     // That is so we can keep the disk always busy. But there is still some background work that is
@@ -462,7 +487,20 @@ class dirty_memory_manager {
     //
     // We then set the soft limit to 80 % of the unspooled dirty hard limit, which is equal to 40 % of
     // the user-supplied threshold.
-    dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg);
+    //
+    // Throttle Start
+    // --------------
+    // Past the throttle start, also expressed as a portion of the hard limit, writes are delayed,
+    // by up to max_throttle_delay at the hard limit. This slows writers down gradually as flushes
+    // fall behind, instead of blocking all of them at once when the hard limit is hit. A throttle
+    // start of 1 disables the delays.
+    struct throttling_config {
+        double throttle_start = 1.0;
+        db::timeout_clock::duration max_throttle_delay = db::timeout_clock::duration::zero();
+        unsigned max_concurrent_flushes = 1;
+    };
+    dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg,
+            throttling_config throttling = {});
     dirty_memory_manager()
         : _db(nullptr)
         , _region_group("memtable (unspooled)",
@@ -563,6 +601,23 @@ template <typename Func>
 requires (!is_future<std::invoke_result_t<Func>>::value)
 futurize_t<std::result_of_t<Func()>>
 region_group::run_when_memory_available(Func&& func, db::timeout_clock::time_point timeout) {
+    auto delay = throttle_delay();
+    if (delay == db::timeout_clock::duration::zero() || _delayed_requests.is_closed()) {
+        return run_or_queue(std::forward<Func>(func), timeout);
+    }
+    // Past the timeout, the request expires in the queue.
+    delay = std::min(delay, std::max(timeout - db::timeout_clock::now(), db::timeout_clock::duration::zero()));
+    ++_delayed_requests_counter;
+    return with_gate(_delayed_requests, [this, delay, timeout, func = std::forward<Func>(func)] () mutable {
+        return sleep(delay).then([this, timeout, func = std::move(func)] () mutable {
+            return run_or_queue(std::move(func), timeout);
+        });
+    });
+}
+
+template <typename Func>
+futurize_t<std::result_of_t<Func()>>
+region_group::run_or_queue(Func&& func, db::timeout_clock::time_point timeout) {
     bool blocked = 
         !_blocked_requests.empty()
         || under_unspooled_pressure()
@@ -592,6 +647,12 @@ region_group::blocked_requests_counter() const noexcept {
     return _blocked_requests_counter;
 }
 
+inline
+uint64_t
+region_group::delayed_requests_counter() const noexcept {
+    return _delayed_requests_counter;
+}
+
 }
 
 extern thread_local dirty_memory_manager default_dirty_memory_manager;
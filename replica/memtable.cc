@@ -15,6 +15,8 @@
 #include "readers/empty_v2.hh"
 #include "readers/forwardable_v2.hh"
 
+#include <numeric>
+
 namespace replica {
 
 static flat_mutation_reader_v2 make_partition_snapshot_flat_reader_from_snp_schema(
@@ -620,9 +622,9 @@ class flush_reader final : public flat_mutation_reader_v2::impl, private iterato
     flat_mutation_reader_v2_opt _partition_reader;
     flush_memory_accounter _flushed_memory;
 public:
-    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m)
+    flush_reader(schema_ptr s, reader_permit permit, lw_shared_ptr<memtable> m, const dht::partition_range& range)
         : impl(s, std::move(permit))
-        , iterator_reader(std::move(s), m, query::full_partition_range)
+        , iterator_reader(std::move(s), m, range)
         , _flushed_memory(*m)
     {}
     flush_reader(const flush_reader&) = delete;
@@ -744,14 +746,41 @@ memtable::make_flat_reader_opt(schema_ptr s,
 }
 
 flat_mutation_reader_v2
-memtable::make_flush_reader(schema_ptr s, reader_permit permit, const io_priority_class& pc) {
+memtable::make_flush_reader(schema_ptr s, reader_permit permit, const io_priority_class& pc, const dht::partition_range& range) {
     if (!_merged_into_cache) {
-        return make_flat_mutation_reader_v2<flush_reader>(std::move(s), std::move(permit), shared_from_this());
+        return make_flat_mutation_reader_v2<flush_reader>(std::move(s), std::move(permit), shared_from_this(), range);
     } else {
         auto& full_slice = s->full_slice();
         return make_flat_mutation_reader_v2<scanning_reader>(std::move(s), shared_from_this(), std::move(permit),
-                      query::full_partition_range, full_slice, pc, mutation_reader::forwarding::no);
+                      range, full_slice, pc, mutation_reader::forwarding::no);
+    }
+}
+
+dht::partition_range_vector
+memtable::split_for_flush(unsigned n) const {
+    if (n <= 1 || nr_partitions < n) {
+        return {query::full_partition_range};
+    }
+
+    // Tokens are hashes, so splitting the span evenly gives ranges with
+    // about the same amount of data.
+    uint64_t first = partitions.begin()->key().token().raw();
+    uint64_t last = std::prev(partitions.end())->key().token().raw();
+    uint64_t step = (last - first) / n;
+    if (step == 0) {
+        return {query::full_partition_range};
+    }
+
+    dht::partition_range_vector ranges;
+    ranges.reserve(n);
+    std::optional<dht::partition_range::bound> start;
+    for (unsigned i = 1; i < n; i++) {
+        auto pos = dht::ring_position::ending_at(dht::token::from_int64(int64_t(first + step * i)));
+        ranges.emplace_back(start, dht::partition_range::bound(pos, true));
+        start = dht::partition_range::bound(std::move(pos), false);
     }
+    ranges.emplace_back(std::move(start), std::nullopt);
+    return ranges;
 }
 
 void
@@ -803,6 +832,49 @@ memtable::apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_han
     update(std::move(h));
 }
 
+void
+memtable::apply(std::span<const frozen_mutation* const> muts, const schema_ptr& m_schema, std::vector<db::rp_handle>&& handles) {
+    std::vector<dht::decorated_key> keys;
+    keys.reserve(muts.size());
+    for (auto* m : muts) {
+        keys.push_back(m->decorated_key(*m_schema));
+    }
+    // Group mutations of the same partition, keeping their relative order.
+    std::vector<size_t> order(muts.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys, less = dht::decorated_key::less_comparator(m_schema)] (size_t a, size_t b) {
+        return less(keys[a], keys[b]);
+    });
+
+    with_allocator(allocator(), [&, this] {
+        for (auto first = order.begin(); first != order.end();) {
+            auto last = std::find_if(first + 1, order.end(), [&] (size_t i) { return !keys[i].equal(*m_schema, keys[*first]); });
+            _allocating_section(*this, [&, this] {
+                auto& p = find_or_create_partition(keys[*first]);
+                mutation_partition mp(m_schema);
+                for (auto it = first; it != last; ++it) {
+                    if (it == first) {
+                        partition_builder pb(*m_schema, mp);
+                        muts[*it]->partition().accept(*m_schema, pb);
+                        _stats_collector.update(*m_schema, mp);
+                        continue;
+                    }
+                    mutation_partition next(m_schema);
+                    partition_builder pb(*m_schema, next);
+                    muts[*it]->partition().accept(*m_schema, pb);
+                    _stats_collector.update(*m_schema, next);
+                    mp.apply(*m_schema, std::move(next), _table_stats.memtable_app_stats);
+                }
+                p.apply(region(), cleaner(), *_schema, std::move(mp), *m_schema, _table_stats.memtable_app_stats);
+            });
+            first = last;
+        }
+    });
+    for (auto& h : handles) {
+        update(std::move(h));
+    }
+}
+
 logalloc::occupancy_stats memtable::occupancy() const noexcept {
     return logalloc::region::occupancy();
 }
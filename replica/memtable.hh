@@ -10,6 +10,7 @@
 
 #include <map>
 #include <memory>
+#include <span>
 #include <iosfwd>
 #include "replica/database_fwd.hh"
 #include "dht/i_partitioner.hh"
@@ -190,6 +191,11 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     void apply(const mutation& m, db::rp_handle&& = {});
     // The mutation is upgraded to current schema.
     void apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle&& = {});
+    // Applies a batch of mutations of the same schema, upgraded to current schema.
+    // Mutations of the same partition are merged and applied together, with a single
+    // partition lookup and allocating section, which makes bursts of small writes to
+    // the same partition cheaper. handles[i] is the replay position handle of muts[i].
+    void apply(std::span<const frozen_mutation* const> muts, const schema_ptr& m_schema, std::vector<db::rp_handle>&& handles);
     void evict_entry(memtable_entry& e, mutation_cleaner& cleaner) noexcept;
 
     static memtable& from_region(logalloc::region& r) noexcept {
@@ -266,7 +272,14 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
         return make_flat_reader(s, std::move(permit), range, full_slice);
     }
 
-    flat_mutation_reader_v2 make_flush_reader(schema_ptr, reader_permit permit, const io_priority_class& pc);
+    // The range must be alive as long as the reader is.
+    flat_mutation_reader_v2 make_flush_reader(schema_ptr, reader_permit permit, const io_priority_class& pc,
+                                              const dht::partition_range& range = query::full_partition_range);
+
+    // Splits the token span of the memtable's partitions into at most n
+    // contiguous ranges, which can be flushed in parallel, each into its own
+    // sstables. Returns a single full range if the memtable can't be split.
+    dht::partition_range_vector split_for_flush(unsigned n) const;
 
     mutation_source as_data_source();
 
@@ -73,7 +73,8 @@ table::make_sstable_reader(schema_ptr s,
                                    const io_priority_class& pc,
                                    tracing::trace_state_ptr trace_state,
                                    streamed_mutation::forwarding fwd,
-                                   mutation_reader::forwarding fwd_mr) const {
+                                   mutation_reader::forwarding fwd_mr,
+                                   sstables::sstable_filter_type range_filter) const {
     // CAVEAT: if make_sstable_reader() is called on a single partition
     // we want to optimize and read exactly this partition. As a
     // consequence, fast_forward_to() will *NOT* work on the result,
@@ -88,10 +89,40 @@ table::make_sstable_reader(schema_ptr s,
                 _stats.estimated_sstable_per_read, pr, slice, pc, std::move(trace_state), fwd, fwd_mr);
     } else {
         return sstables->make_local_shard_sstable_reader(std::move(s), std::move(permit), pr, slice, pc,
-                std::move(trace_state), fwd, fwd_mr);
+                std::move(trace_state), fwd, fwd_mr, sstables::default_read_monitor_generator(), std::move(range_filter));
     }
 }
 
+// Range scans select sstables by token range only, so the sstables with
+// no data in the clustering ranges of the slice, according to their min/max
+// clustering metadata, are skipped here. Single-partition reads do that in
+// filter_sstable_for_reader_by_ck(), for the compaction strategies which ask
+// for it; for scans the check is paid once per sstable, so it's always done.
+//
+// Partitions which have no rows in the ranges are then missing from the
+// output of the scan instead of being emitted empty, so readers which
+// populate the cache must not use the filter (see #3552).
+sstables::sstable_filter_type table::make_clustering_filter_for_scan(const query::partition_slice& slice) const {
+    // Static rows and reversed ranges are not tracked by the metadata.
+    if (!_schema->clustering_key_size() || slice.static_columns.size() || slice.is_reversed()) {
+        return {};
+    }
+    auto ranges = slice.get_all_ranges();
+    if (ranges.size() == 1 && ranges[0].is_full()) {
+        return {};
+    }
+    auto& stats = *_config.cf_stats;
+    stats.clustering_filter_count++;
+    return [ranges = std::move(ranges), &stats] (const sstables::sstable& sst) {
+        ++stats.sstables_checked_by_clustering_filter;
+        if (sst.may_contain_rows(ranges)) {
+            ++stats.surviving_sstables_after_clustering_filter;
+            return true;
+        }
+        return false;
+    };
+}
+
 lw_shared_ptr<sstables::sstable_set> compaction_group::make_compound_sstable_set() {
     return make_lw_shared(sstables::make_compound_sstable_set(_t.schema(), { _main_sstables, _maintenance_sstables }));
 }
@@ -237,13 +268,20 @@ table::make_reader_v2(schema_ptr s,
         readers.reserve(memtable_count + 1);
     });
 
-    const auto bypass_cache = slice.options.contains(query::partition_slice::option::bypass_cache);
+    auto bypass_cache = slice.options.contains(query::partition_slice::option::bypass_cache);
+    if (cache_enabled() && !bypass_cache && !query::is_single_partition(range)
+            && _cache.get_cache_tracker().get_admission_policy() == cache_tracker::admission_policy::frequency) {
+        // Keep scans from evicting the working set, see cache_tracker::admission_policy.
+        _cache.get_cache_tracker().on_range_scan_bypass();
+        bypass_cache = true;
+    }
     if (cache_enabled() && !bypass_cache && !(reversed && _config.reversed_reads_auto_bypass_cache())) {
         if (auto reader_opt = _cache.make_reader_opt(s, permit, range, slice, pc, std::move(trace_state), fwd, fwd_mr)) {
             readers.emplace_back(std::move(*reader_opt));
         }
     } else {
-        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr));
+        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr,
+                make_clustering_filter_for_scan(slice)));
     }
 
     auto rd = make_combined_reader(s, permit, std::move(readers), fwd, fwd_mr);
@@ -292,6 +330,33 @@ table::make_streaming_reader(schema_ptr s, reader_permit permit,
     return make_flat_multi_range_reader(s, std::move(permit), std::move(source), ranges, slice, pc, nullptr, mutation_reader::forwarding::no);
 }
 
+flat_mutation_reader_v2
+table::make_streaming_reader(schema_ptr s, reader_permit permit,
+                           const dht::partition_range_vector& ranges, std::unordered_set<sstables::shared_sstable> excluded) const {
+    auto& slice = s->full_slice();
+    auto& pc = service::get_local_streaming_priority();
+
+    auto source = mutation_source([this, excluded = make_lw_shared(std::move(excluded))] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
+                                      const io_priority_class& pc, tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr) {
+        std::vector<flat_mutation_reader_v2> readers;
+        add_memtables_to_reader_list(readers, s, permit, range, slice, pc, trace_state, fwd, fwd_mr, [&] (size_t memtable_count) {
+            readers.reserve(memtable_count + 1);
+        });
+        // The sstable set is filtered for each range, as the sstables may
+        // change between ranges.
+        auto effective_sstables = make_lw_shared(_compaction_strategy.make_sstable_set(_schema));
+        _sstables->for_each_sstable([&excluded, &effective_sstables] (const sstables::shared_sstable& sst) mutable {
+            if (!excluded->contains(sst)) {
+                effective_sstables->insert(sst);
+            }
+        });
+        readers.emplace_back(make_sstable_reader(s, permit, std::move(effective_sstables), range, slice, pc, std::move(trace_state), fwd, fwd_mr));
+        return make_combined_reader(s, std::move(permit), std::move(readers), fwd, fwd_mr);
+    });
+
+    return make_flat_multi_range_reader(s, std::move(permit), std::move(source), ranges, slice, pc, nullptr, mutation_reader::forwarding::no);
+}
+
 flat_mutation_reader_v2 table::make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
         const query::partition_slice& slice, mutation_reader::forwarding fwd_mr) const {
     const auto& pc = service::get_local_streaming_priority();
@@ -433,6 +498,7 @@ compaction_group::do_add_sstable(lw_shared_ptr<sstables::sstable_set> sstables,
     // allow in-progress reads to continue using old list
     auto new_sstables = make_lw_shared<sstables::sstable_set>(*sstables);
     new_sstables->insert(sstable);
+    sstable->set_data_read_stats(_t.get_stats().sstable_data_reads);
     if (backlog_tracker) {
         table::add_sstable_to_backlog_tracker(get_backlog_tracker(), sstable);
     }
@@ -809,6 +875,10 @@ table::seal_active_memtable(compaction_group& cg, flush_permit&& flush_permit) n
     // FIXME: provide back-pressure to upper layers
 }
 
+// The least amount of memtable data worth its own sstable writer when
+// the memtable is flushed in parallel.
+static constexpr uint64_t parallel_flush_min_size = 64 << 20;
+
 future<>
 table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtable> old, sstable_write_permit&& permit) {
     auto try_flush = [this, old = std::move(old), permit = make_lw_shared(std::move(permit)), &cg] () mutable -> future<> {
@@ -828,7 +898,11 @@ table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtabl
         auto metadata = mutation_source_metadata{};
         metadata.min_timestamp = old->get_min_timestamp();
         metadata.max_timestamp = old->get_max_timestamp();
-        auto estimated_partitions = _compaction_strategy.adjust_partition_estimate(metadata, old->partition_count());
+        // Large memtables are split into contiguous token ranges, each written
+        // concurrently into its own sstables, so that the flush isn't bound by
+        // the throughput of a single writer.
+        auto ranges = old->split_for_flush(std::min<uint64_t>(old->occupancy().used_space() / parallel_flush_min_size, _config.memtable_flush_parallelism()));
+        auto estimated_partitions = _compaction_strategy.adjust_partition_estimate(metadata, old->partition_count()) / ranges.size();
 
         if (!_async_gate.is_closed()) {
             co_await _compaction_manager.maybe_wait_for_sstable_count_reduction(cg.as_table_state());
@@ -856,10 +930,13 @@ table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtabl
           co_await coroutine::return_exception_ptr(std::move(ex));
         });
 
-        auto f = consumer(old->make_flush_reader(
-            old->schema(),
-            compaction_concurrency_semaphore().make_tracking_only_permit(old->schema().get(), "try_flush_memtable_to_sstable()", db::no_timeout),
-            service::get_local_memtable_flush_priority()));
+        auto f = parallel_for_each(ranges, [this, old, &consumer] (const dht::partition_range& range) {
+            return consumer(old->make_flush_reader(
+                old->schema(),
+                compaction_concurrency_semaphore().make_tracking_only_permit(old->schema().get(), "try_flush_memtable_to_sstable()", db::no_timeout),
+                service::get_local_memtable_flush_priority(),
+                range));
+        });
 
         // Switch back to default scheduling group for post-flush actions, to avoid them being staved by the memtable flush
         // controller. Cache update does not affect the input of the memtable cpu controller, so it can be subject to
@@ -938,6 +1015,8 @@ void table::set_metrics() {
                 ms::make_gauge("live_disk_space", ms::description("Live disk space used"), _stats.live_disk_space_used)(cf)(ks),
                 ms::make_gauge("total_disk_space", ms::description("Total disk space used"), _stats.total_disk_space_used)(cf)(ks),
                 ms::make_gauge("live_sstable", ms::description("Live sstable count"), _stats.live_sstable_count)(cf)(ks),
+                ms::make_counter("sstable_data_bytes_read", [this] { return _stats.sstable_data_reads->bytes_read; }, ms::description("Number of bytes read from the data files of sstables, including read ahead"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("sstable_data_bytes_consumed", [this] { return _stats.sstable_data_reads->bytes_consumed; }, ms::description("Number of bytes read from the data files of sstables which were handed over to readers, the rest was read ahead and dropped"))(cf)(ks).set_skip_when_empty(),
                 ms::make_gauge("pending_compaction", ms::description("Estimated number of compactions pending for this column family"), _stats.pending_compactions)(cf)(ks),
                 ms::make_gauge("pending_sstable_deletions",
                         ms::description("Number of tasks waiting to delete sstables from a table"),
@@ -976,6 +1055,8 @@ void table::set_metrics() {
                     ms::make_histogram("cas_prepare_latency", ms::description("CAS prepare round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_prepare.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
                     ms::make_histogram("cas_propose_latency", ms::description("CAS accept round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_accept.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
                     ms::make_histogram("cas_commit_latency", ms::description("CAS learn round latency histogram"), [this] {return to_metrics_histogram(_stats.cas_learn.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
+                    ms::make_histogram("read_admission_latency", ms::description("Histogram of the time reads wait to be admitted by the reader concurrency semaphore"), [this] {return to_metrics_histogram(_stats.read_admission.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
+                    ms::make_histogram("commitlog_write_latency", ms::description("Histogram of the time writes take to be added to the commitlog"), [this] {return to_metrics_histogram(_stats.commitlog_writes.histogram());})(cf)(ks).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
                     ms::make_gauge("cache_hit_rate", ms::description("Cache hit rate"), [this] {return float(_global_cache_hit_rate);})(cf)(ks)
             });
         }
@@ -1779,11 +1860,33 @@ future<db::replay_position> table::discard_sstables(db_clock::time_point truncat
         tlogger.debug("cleaning out row cache");
     }));
     rebuild_statistics();
-    co_await coroutine::parallel_for_each(p->remove, [this, p] (pruner::removed_sstable& r) {
+    // Staging sstables live in a different directory than the others.
+    std::unordered_map<sstring, std::vector<sstables::shared_sstable>> removed_per_dir;
+    for (auto& r : p->remove) {
         if (r.enable_backlog_tracker) {
             remove_sstable_from_backlog_tracker(r.cg.get_backlog_tracker(), r.sst);
         }
-        return sstables::sstable_directory::delete_atomically({r.sst});
+        removed_per_dir[std::filesystem::path(r.sst->get_filename()).parent_path().native()].push_back(r.sst);
+    }
+    // The deletion is durable once it is in the pending delete log, so
+    // truncate doesn't wait for the sstables to be unlinked. The log is
+    // written once per directory rather than once per sstable.
+    co_await coroutine::parallel_for_each(removed_per_dir, [this] (auto& dir_and_sstables) -> future<> {
+        auto ssts = std::move(dir_and_sstables.second);
+        sstring pending_delete_log;
+        try {
+            pending_delete_log = co_await sstables::sstable_directory::write_pending_delete_log(ssts);
+        } catch (...) {
+            tlogger.warn("Error while writing the pending delete log of {} truncated sstables: {}. Deleting them in the foreground.",
+                    ssts.size(), std::current_exception());
+            co_return co_await sstables::sstable_directory::unlink_pending_delete(std::move(ssts), {});
+        }
+        // If the table is stopped before, the log is replayed on restart.
+        (void)seastar::try_with_gate(_sstable_deletion_gate, [ssts = std::move(ssts), pending_delete_log = std::move(pending_delete_log)] () mutable {
+            return sstables::sstable_directory::unlink_pending_delete(std::move(ssts), std::move(pending_delete_log));
+        }).handle_exception([] (std::exception_ptr ep) {
+            tlogger.warn("Failed to delete truncated sstables: {}. They will be deleted on restart.", ep);
+        });
     });
     co_return p->rp;
 }
@@ -2159,6 +2262,51 @@ future<> table::apply(const frozen_mutation& m, schema_ptr m_schema, db::rp_hand
 
 template void table::do_apply(compaction_group& cg, db::rp_handle&&, const frozen_mutation&, const schema_ptr&);
 
+void table::do_apply(compaction_group& cg, std::span<const frozen_mutation* const> muts, const schema_ptr& m_schema, std::vector<db::rp_handle>&& handles) {
+    if (_async_gate.is_closed()) {
+        on_internal_error(tlogger, "Table async_gate is closed");
+    }
+
+    utils::latency_counter lc;
+    _stats.writes.set_latency(lc);
+    db::replay_position highest_rp;
+    for (auto& h : handles) {
+        db::replay_position rp = h;
+        check_valid_rp(rp);
+        highest_rp = std::max(highest_rp, rp);
+    }
+    try {
+        cg.memtables()->active_memtable().apply(muts, m_schema, std::move(handles));
+        _highest_rp = std::max(_highest_rp, highest_rp);
+    } catch (...) {
+        _failed_counter_applies_to_memtable++;
+        throw;
+    }
+    _stats.writes.mark(lc);
+}
+
+future<> table::apply(std::span<const frozen_mutation* const> muts, schema_ptr m_schema, std::vector<db::rp_handle>&& handles, db::timeout_clock::time_point timeout) {
+    if (_virtual_writer) [[unlikely]] {
+        for (auto* m : muts) {
+            co_await (*_virtual_writer)(*m);
+        }
+        co_return;
+    }
+
+    co_await dirty_memory_region_group().run_when_memory_available([&] {
+        if (_compaction_groups.size() == 1) {
+            do_apply(*_compaction_groups.front(), muts, m_schema, std::move(handles));
+            return;
+        }
+        // Mutations of the same partition belong to the same compaction group, so
+        // coalescing would only work within groups. Not worth it, given that many
+        // compaction groups are used only with many partitions.
+        for (size_t i = 0; i < muts.size(); ++i) {
+            do_apply(compaction_group_for_key(muts[i]->key(), m_schema), std::move(handles[i]), *muts[i], m_schema);
+        }
+    }, timeout);
+}
+
 future<>
 write_memtable_to_sstable(flat_mutation_reader_v2 reader,
                           memtable& mt, sstables::shared_sstable sst,
@@ -2370,12 +2518,18 @@ void table::add_coordinator_read_latency(utils::estimated_histogram::duration la
     _stats.estimated_coordinator_read.add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
 }
 
-std::chrono::milliseconds table::get_coordinator_read_latency_percentile(double percentile) {
+std::optional<std::chrono::microseconds> table::get_coordinator_read_latency_percentile(double percentile) {
     if (_cached_percentile != percentile || lowres_clock::now() - _percentile_cache_timestamp > 1s) {
         _percentile_cache_timestamp = lowres_clock::now();
         _cached_percentile = percentile;
-        _percentile_cache_value = std::max(_stats.estimated_coordinator_read.percentile(percentile) / 1000, int64_t(1)) * 1ms;
-        _stats.estimated_coordinator_read *= 0.9; // decay values a little to give new data points more weight
+        // The percentile is meaningful only if at least one sample is expected above it.
+        auto& h = _stats.estimated_coordinator_read;
+        if (h.count() * (1 - percentile) >= 1) {
+            _percentile_cache_value = std::max(h.percentile(percentile), int64_t(1)) * 1us;
+        } else {
+            _percentile_cache_value = std::nullopt;
+        }
+        h *= 0.9; // decay values a little to give new data points more weight
     }
     return _percentile_cache_value;
 }
@@ -11,6 +11,8 @@
 #include <seastar/core/do_with.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/metrics.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/util/defer.hh>
 #include "replica/memtable.hh"
 #include <chrono>
@@ -100,11 +102,16 @@ cache_tracker::setup_metrics() {
         sm::make_counter("partition_hits", sm::description("number of partitions needed by reads and found in cache"), _stats.partition_hits),
         sm::make_counter("partition_misses", sm::description("number of partitions needed by reads and missing in cache"), _stats.partition_misses),
         sm::make_counter("partition_insertions", sm::description("total number of partitions added to cache"), _stats.partition_insertions),
+        sm::make_counter("partition_admissions", sm::description("total number of partitions missing in cache which reads were allowed to populate by the admission policy"), _stats.partition_admissions),
+        sm::make_counter("partition_rejections", sm::description("total number of partitions missing in cache which reads were not allowed to populate by the admission policy"), _stats.partition_rejections),
+        sm::make_counter("range_scan_bypasses", sm::description("total number of range scans which bypassed cache due to the admission policy"), _stats.range_scan_bypasses),
         sm::make_counter("row_hits", sm::description("total number of rows needed by reads and found in cache"), _stats.row_hits),
         sm::make_counter("dummy_row_hits", sm::description("total number of dummy rows touched by reads in cache"), _stats.dummy_row_hits),
         sm::make_counter("row_misses", sm::description("total number of rows needed by reads and missing in cache"), _stats.row_misses),
         sm::make_counter("row_insertions", sm::description("total number of rows added to cache"), _stats.row_insertions),
         sm::make_counter("row_evictions", sm::description("total number of rows evicted from cache"), _stats.row_evictions),
+        sm::make_counter("row_evictions_spared", sm::description("total number of times an entry was spared from eviction, due to the eviction policy or the eviction priority of its table"),
+                         [this] { return _lru.spared(); }),
         sm::make_counter("row_removals", sm::description("total number of invalidated rows"), _stats.row_removals),
         sm::make_counter("rows_dropped_by_tombstones", _app_stats.rows_dropped_by_tombstones, sm::description("Number of rows dropped in cache by a tombstone write")),
         sm::make_counter("rows_compacted_with_tombstones", _app_stats.rows_compacted_with_tombstones, sm::description("Number of rows scanned during write of a tombstone for the purpose of compaction in cache")),
@@ -161,6 +168,43 @@ void cache_tracker::touch(rows_entry& e) {
         _lru.remove(e);
     }
     _lru.add(e);
+    if (_eviction_policy == eviction_policy::second_chance) {
+        e.set_referenced();
+    }
+}
+
+void cache_tracker::touch(rows_entry& e, const schema& s) {
+    e.set_eviction_priority(s.caching_options().eviction_priority());
+    touch(e);
+}
+
+void cache_tracker::insert(rows_entry& e, const schema& s) noexcept {
+    e.set_eviction_priority(s.caching_options().eviction_priority());
+    insert(e);
+}
+
+void cache_tracker::set_admission_policy(admission_policy p) noexcept {
+    _admission_policy = p;
+    if (p == admission_policy::frequency) {
+        if (!_access_sketch) {
+            // Enough for tracking a working set of a few million partitions with a ~1MB sketch.
+            _access_sketch.emplace(1 << 21);
+        }
+    } else {
+        _access_sketch.reset();
+    }
+}
+
+bool cache_tracker::admit(dht::token t) noexcept {
+    bool admitted = true;
+    if (_access_sketch) {
+        auto hash = uint64_t(t.raw());
+        // The partition was missed at least once recently, so is likely to be read again.
+        admitted = _access_sketch->estimate(hash) > 0;
+        _access_sketch->increment(hash);
+    }
+    ++(admitted ? _stats.partition_admissions : _stats.partition_rejections);
+    return admitted;
 }
 
 void cache_tracker::insert(cache_entry& entry) {
@@ -747,12 +791,18 @@ row_cache::make_reader_opt(schema_ptr s,
                 cache_entry& e = *i;
                 upgrade_entry(e);
                 on_partition_hit();
+                _tracker.on_access(pos.token());
                 return e.read(*this, make_context());
             } else if (i->continuous()) {
                 return {};
             } else {
                 tracing::trace(trace_state, "Range {} not found in cache", range);
                 on_partition_miss();
+                if (!_tracker.admit(pos.token())) {
+                    tracing::trace(trace_state, "Partition not admitted to cache, reading from underlying");
+                    return snapshot_of(pos).snapshot.make_reader_v2(s, std::move(permit), range, slice, pc, std::move(trace_state),
+                            streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+                }
                 return make_flat_mutation_reader_v2<single_partition_populating_reader>(*this, make_context());
             }
         });
@@ -1084,6 +1134,33 @@ void row_cache::touch(const dht::decorated_key& dk) {
  });
 }
 
+future<std::vector<dht::decorated_key>> row_cache::cached_partition_keys(size_t max_keys) {
+    std::vector<dht::decorated_key> keys;
+    std::optional<dht::decorated_key> last;
+    dht::ring_position_comparator cmp(*_schema);
+    bool done = false;
+    while (!done && keys.size() < max_keys) {
+        _read_section(_tracker.region(), [&] {
+            auto i = last ? _partitions.upper_bound(*last, cmp) : _partitions.begin();
+            while (i != _partitions.end() && keys.size() < max_keys) {
+                if (!i->is_dummy_entry()) {
+                    keys.push_back(i->key());
+                }
+                ++i;
+                if (need_preempt()) {
+                    break;
+                }
+            }
+            done = i == _partitions.end();
+        });
+        if (!keys.empty()) {
+            last = keys.back();
+        }
+        co_await coroutine::maybe_yield();
+    }
+    co_return keys;
+}
+
 void row_cache::unlink_from_lru(const dht::decorated_key& dk) {
     _read_section(_tracker.region(), [&] {
         auto i = _partitions.find(dk, dht::ring_position_comparator(*_schema));
@@ -1262,6 +1339,25 @@ void rows_entry::on_evicted() noexcept {
     on_evicted(*current_tracker);
 }
 
+bool rows_entry::spare_from_eviction() noexcept {
+    if (!_flags._referenced && _flags._times_spared >= _flags._eviction_priority) {
+        return false;
+    }
+    // Moving an entry of an older version behind those of newer versions
+    // would break the "older versions are evicted first" rule.
+    mutation_partition::rows_type::iterator it(this);
+    partition_version& pv = partition_version::container_of(mutation_partition::container_of(*it.owning_tree()));
+    if (!pv.is_referenced_from_entry()) {
+        return false;
+    }
+    if (_flags._referenced) {
+        _flags._referenced = false;
+    } else {
+        ++_flags._times_spared;
+    }
+    return true;
+}
+
 flat_mutation_reader_v2 cache_entry::read(row_cache& rc, read_context& reader) {
     auto source_and_phase = rc.snapshot_of(_key);
     reader.enter_partition(_key, source_and_phase.snapshot, source_and_phase.phase);
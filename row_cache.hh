@@ -421,6 +421,10 @@ class row_cache final {
     // Moves given partition to the front of LRU if present in cache.
     void touch(const dht::decorated_key&);
 
+    // Returns the keys of up to max_keys cached partitions, in ring order.
+    // Defers between partitions, so the keys reflect no single state of the cache.
+    future<std::vector<dht::decorated_key>> cached_partition_keys(size_t max_keys);
+
     // Detaches current contents of given partition from LRU, so
     // that they are not evicted by memory reclaimer.
     void unlink_from_lru(const dht::decorated_key&);
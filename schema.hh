@@ -10,6 +10,7 @@
 
 #include <functional>
 #include <optional>
+#include <span>
 #include <unordered_map>
 #include <boost/range/iterator_range.hpp>
 #include <boost/range/join.hpp>
@@ -450,6 +451,12 @@ class column_mapping {
         assert(kind == column_kind::regular_column || kind == column_kind::static_column);
         return kind == column_kind::regular_column ? regular_column_at(id) : static_column_at(id);
     }
+    // The static or the regular columns, indexed by their column ids.
+    std::span<const column_mapping_entry> columns_of(column_kind kind) const {
+        assert(kind == column_kind::regular_column || kind == column_kind::static_column);
+        auto columns = std::span<const column_mapping_entry>(_columns);
+        return kind == column_kind::regular_column ? columns.subspan(_n_static) : columns.first(_n_static);
+    }
     const column_mapping_entry& static_column_at(column_id id) const {
         if (id >= _n_static) {
             throw std::out_of_range(format("static column id {:d} >= {:d}", id, _n_static));
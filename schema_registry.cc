@@ -93,6 +93,14 @@ frozen_schema schema_registry::get_frozen(table_schema_version v) const {
     return get_entry(v).frozen();
 }
 
+std::optional<frozen_schema> schema_registry::get_frozen_or_null(table_schema_version v) const {
+    auto i = _entries.find(v);
+    if (i == _entries.end() || i->second->_state != schema_registry_entry::state::LOADED) {
+        return std::nullopt;
+    }
+    return i->second->frozen();
+}
+
 future<schema_ptr> schema_registry::get_or_load(table_schema_version v, const async_schema_loader& loader) {
     auto i = _entries.find(v);
     if (i == _entries.end()) {
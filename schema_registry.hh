@@ -135,6 +135,10 @@ class schema_registry {
     // or loading is in progress.
     frozen_schema get_frozen(table_schema_version) const;
 
+    // Looks up schema version or returns a disengaged optional when not found
+    // or loading is in progress.
+    std::optional<frozen_schema> get_frozen_or_null(table_schema_version) const;
+
     // Attempts to add given schema to the registry. If the registry already
     // knows about the schema, returns existing entry, otherwise returns back
     // the schema which was passed as argument. Users should prefer to use the
@@ -11,6 +11,7 @@
 #include <unordered_set>
 #include <list>
 #include <array>
+#include <chrono>
 #include <seastar/core/sstring.hh>
 #include <unordered_map>
 #include <optional>
@@ -203,6 +204,70 @@ inline void serialize_integral(Output& output, T data) {
 template<typename T>
 struct serializer;
 
+template<typename... Ts>
+struct serialized_types {};
+
+// The types of the values a value of T is serialized as, in order, for the
+// types serialized as a fixed sequence of values, such as the final classes
+// and the enums of the IDL. Declared by the IDL compiler.
+template<typename T>
+struct serialized_members {};
+
+// The size of the serialized values of T, if it is the same for all of
+// them, and 0 otherwise. Values of a fixed size are skipped without being
+// read.
+template<typename T>
+struct fixed_serialized_size : std::integral_constant<size_t, 0> {};
+
+// The size of consecutive serialized values of the types Ts, if all of them
+// have a fixed size, and 0 otherwise.
+template<typename... Ts>
+constexpr size_t fixed_serialized_size_of = ((fixed_serialized_size<Ts>::value != 0) && ...)
+        ? (fixed_serialized_size<Ts>::value + ... + 0) : 0;
+
+template<typename T>
+requires std::is_integral_v<T>
+struct fixed_serialized_size<T> : std::integral_constant<size_t, sizeof(T)> {};
+
+template<typename T, typename Ratio>
+struct fixed_serialized_size<std::chrono::duration<T, Ratio>> : fixed_serialized_size<T> {};
+
+template<typename Clock, typename Duration>
+struct fixed_serialized_size<std::chrono::time_point<Clock, Duration>> : fixed_serialized_size<uint64_t> {};
+
+template<typename... Ts>
+struct fixed_serialized_size<serialized_types<Ts...>> : std::integral_constant<size_t, fixed_serialized_size_of<Ts...>> {};
+
+// Evaluated when first used, so the types of the members only have to be
+// complete by then.
+template<typename T>
+requires requires { typename serialized_members<T>::types; }
+struct fixed_serialized_size<T> : fixed_serialized_size<typename serialized_members<T>::types> {};
+
+// Skips consecutive serialized values of the types Ts. Each run of values
+// of a fixed size is skipped at once, with a single bounds check. The other
+// values are skipped with skip_one(in, boost::type<T>()), so that the
+// caller can provide the overloads which are visible to it.
+template<typename... Ts, typename Input, typename SkipOne>
+inline void skip_members(Input& in, SkipOne&& skip_one) {
+    size_t fixed = 0;
+    auto skip_member = [&] <typename T> (boost::type<T> t) {
+        if constexpr (fixed_serialized_size<T>::value != 0) {
+            fixed += fixed_serialized_size<T>::value;
+        } else {
+            if (fixed) {
+                in.skip(fixed);
+                fixed = 0;
+            }
+            skip_one(in, t);
+        }
+    };
+    (skip_member(boost::type<Ts>()), ...);
+    if (fixed) {
+        in.skip(fixed);
+    }
+}
+
 template<typename T>
 struct integral_serializer {
     template<typename Input>
@@ -215,7 +280,7 @@ struct integral_serializer {
     }
     template<typename Input>
     static void skip(Input& v) {
-        read(v);
+        v.skip(sizeof(T));
     }
 };
 
@@ -230,7 +295,7 @@ template<> struct serializer<bool> {
     }
     template <typename Input>
     static void skip(Input& i) {
-        read(i);
+        i.skip(sizeof(uint8_t));
     }
 
 };
@@ -60,10 +60,20 @@ class forward_aggregates {
 private:
     std::vector<::shared_ptr<db::functions::aggregate_function>> _funcs;
     std::vector<std::unique_ptr<db::functions::aggregate_function::aggregate>> _aggrs;
-
+    schema_ptr _schema;
+    // Number of GROUP BY columns, which precede the aggregates in grouped results.
+    size_t _group_by_columns;
+    // Position of each partition key column among the GROUP BY columns.
+    std::vector<size_t> _partition_key_positions;
+
+    void reduce(std::vector<bytes_opt>& acc, std::vector<bytes_opt>&& other, size_t offset);
+    void finalize(std::vector<bytes_opt>& acc, size_t offset);
+    void sort_groups(std::vector<std::vector<bytes_opt>>& groups) const;
 public:
     forward_aggregates(const query::forward_request& request);
     void merge(query::forward_result& result, query::forward_result&& other);
+    // Computes the final values of the aggregates. Groups are put in ring
+    // order, in which a regular query would return them.
     void finalize(query::forward_result& result);
 
     template<typename Func>
@@ -82,7 +92,10 @@ class forward_aggregates {
     }
 };
 
-forward_aggregates::forward_aggregates(const query::forward_request& request) {
+forward_aggregates::forward_aggregates(const query::forward_request& request)
+    : _schema(local_schema_registry().get(request.cmd.schema_version))
+    , _group_by_columns(request.group_by_column_names.size())
+{
     _funcs = get_functions(request);
     std::vector<std::unique_ptr<db::functions::aggregate_function::aggregate>> aggrs;
 
@@ -90,9 +103,74 @@ forward_aggregates::forward_aggregates(const query::forward_request& request) {
         aggrs.push_back(func->new_aggregate());
     }
     _aggrs = std::move(aggrs);
+
+    if (_group_by_columns) {
+        for (const auto& def : _schema->partition_key_columns()) {
+            auto it = std::find(request.group_by_column_names.begin(), request.group_by_column_names.end(), def.name_as_text());
+            if (it == request.group_by_column_names.end()) {
+                throw std::runtime_error(format("GROUP BY of forward_request doesn't include partition key column {}", def.name_as_text()));
+            }
+            _partition_key_positions.push_back(std::distance(request.group_by_column_names.begin(), it));
+        }
+    }
+}
+
+void forward_aggregates::reduce(std::vector<bytes_opt>& acc, std::vector<bytes_opt>&& other, size_t offset) {
+    for (size_t i = 0; i < _aggrs.size(); i++) {
+        _aggrs[i]->set_accumulator(acc[offset + i]);
+        _aggrs[i]->reduce(std::move(other[offset + i]));
+        acc[offset + i] = _aggrs[i]->get_accumulator();
+    }
+}
+
+void forward_aggregates::finalize(std::vector<bytes_opt>& acc, size_t offset) {
+    for (size_t i = 0; i < _aggrs.size(); i++) {
+        _aggrs[i]->set_accumulator(acc[offset + i]);
+        acc[offset + i] = _aggrs[i]->compute();
+    }
+}
+
+void forward_aggregates::sort_groups(std::vector<std::vector<bytes_opt>>& groups) const {
+    std::vector<std::pair<dht::decorated_key, size_t>> keys;
+    keys.reserve(groups.size());
+    for (size_t i = 0; i < groups.size(); i++) {
+        std::vector<bytes> exploded;
+        exploded.reserve(_partition_key_positions.size());
+        for (auto pos : _partition_key_positions) {
+            if (!groups[i][pos]) {
+                on_internal_error(flogger, "forward_aggregates::sort_groups(): group with null partition key column");
+            }
+            exploded.push_back(*groups[i][pos]);
+        }
+        keys.emplace_back(dht::decorate_key(*_schema, partition_key::from_exploded(*_schema, exploded)), i);
+    }
+    // All groups of a partition come from the same shard, in clustering
+    // order, so a stable sort keeps them in the right order.
+    std::stable_sort(keys.begin(), keys.end(), [less = dht::decorated_key::less_comparator(_schema)] (const auto& a, const auto& b) {
+        return less(a.first, b.first);
+    });
+    std::vector<std::vector<bytes_opt>> sorted;
+    sorted.reserve(groups.size());
+    for (auto& [key, i] : keys) {
+        sorted.push_back(std::move(groups[i]));
+    }
+    groups = std::move(sorted);
 }
 
 void forward_aggregates::merge(query::forward_result &result, query::forward_result&& other) {
+    if (_group_by_columns) {
+        // Every group lies within a single partition, hence on a single
+        // shard, so the groups of different results are disjoint.
+        for (auto& group : other.grouped_results) {
+            if (group.size() != _group_by_columns + _aggrs.size()) {
+                on_internal_error(flogger, format("forward_aggregates::merge(): group has {} columns, expected {}",
+                        group.size(), _group_by_columns + _aggrs.size()));
+            }
+            result.grouped_results.push_back(std::move(group));
+        }
+        return;
+    }
+
     if (result.query_results.empty()) {
         result.query_results = std::move(other.query_results);
         return;
@@ -111,14 +189,18 @@ void forward_aggregates::merge(query::forward_result &result, query::forward_res
         );
     }
 
-    for (size_t i = 0; i < _aggrs.size(); i++) {
-        _aggrs[i]->set_accumulator(result.query_results[i]);
-        _aggrs[i]->reduce(std::move(other.query_results[i]));
-        result.query_results[i] = _aggrs[i]->get_accumulator();
-    }
+    reduce(result.query_results, std::move(other.query_results), 0);
 }
 
 void forward_aggregates::finalize(query::forward_result &result) {
+    if (_group_by_columns) {
+        for (auto& group : result.grouped_results) {
+            finalize(group, _group_by_columns);
+        }
+        sort_groups(result.grouped_results);
+        return;
+    }
+
     if (result.query_results.size() != _aggrs.size()) {
         on_internal_error(
             flogger,
@@ -129,10 +211,7 @@ void forward_aggregates::finalize(query::forward_result &result) {
         );
     }
 
-    for (size_t i = 0; i < _aggrs.size(); i++) {
-        _aggrs[i]->set_accumulator(result.query_results[i]);
-        result.query_results[i] = _aggrs[i]->compute();
-    }
+    finalize(result.query_results, 0);
 }
 
 static std::vector<::shared_ptr<db::functions::aggregate_function>> get_functions(const query::forward_request& request) {
@@ -319,6 +398,13 @@ static shared_ptr<cql3::selection::selection> mock_selection(
         return make_shared<cql3::selection::raw_selector>(fc_expr, column_identifier);
     };
 
+    // GROUP BY columns are selected first, see forward_result::grouped_results.
+    for (const auto& name : request.group_by_column_names) {
+        auto column_identifier = make_shared<cql3::column_identifier>(name, false);
+        auto selectable = cql3::expr::unresolved_identifier{make_shared<cql3::column_identifier_raw>(name, false)};
+        raw_selectors.emplace_back(make_shared<cql3::selection::raw_selector>(std::move(selectable), std::move(column_identifier)));
+    }
+
     for (size_t i = 0; i < request.reduction_types.size(); i++) {
         auto info = (request.aggregation_infos) ? std::optional(request.aggregation_infos->at(i)) : std::nullopt;
         raw_selectors.emplace_back(mock_singular_selection(functions[i], request.reduction_types[i], info));
@@ -407,10 +493,19 @@ future<query::forward_result> forward_service::execute_on_this_shard(
         cql3::query_options::specific_options::DEFAULT
     );
 
+    std::vector<size_t> group_by_cell_indices;
+    for (const auto& name : req.group_by_column_names) {
+        auto def = schema->get_column_definition(to_bytes(name));
+        if (!def) {
+            throw std::runtime_error(format("Unknown GROUP BY column {}", name));
+        }
+        group_by_cell_indices.push_back(selection->index_of(*def));
+    }
+
     auto rs_builder = cql3::selection::result_set_builder(
         *selection,
         now,
-        std::vector<size_t>() // Represents empty GROUP BY indices.
+        std::move(group_by_cell_indices)
     );
 
     // We serve up to 256 ranges at a time to avoid allocating a huge vector for ranges
@@ -454,6 +549,20 @@ future<query::forward_result> forward_service::execute_on_this_shard(
     co_return co_await rs_builder.with_thread_if_needed([&req, &rs_builder, reductions = req.reduction_types, tr_state = std::move(tr_state)] {
         auto rs = rs_builder.build();
         auto& rows = rs->rows();
+        if (!req.group_by_column_names.empty()) {
+            query::forward_result res;
+            res.grouped_results.reserve(rows.size());
+            for (auto& row : rows) {
+                if (row.size() != req.group_by_column_names.size() + reductions.size()) {
+                    flogger.error("aggregation result column count does not match requested column count");
+                    throw std::runtime_error("aggregation result column count does not match requested column count");
+                }
+                res.grouped_results.push_back(row);
+            }
+            tracing::trace(tr_state, "On shard execution result is {} groups", res.grouped_results.size());
+            flogger.debug("on shard execution result is {} groups", res.grouped_results.size());
+            return res;
+        }
         if (rows.size() != 1) {
             flogger.error("aggregation result row count != 1");
             throw std::runtime_error("aggregation result row count != 1");
@@ -41,6 +41,13 @@ class storage_proxy;
 //   5. `dispatch` merges results from all coordinators and returns merged
 //      result.
 //
+// Queries with GROUP BY are executed the same way, except that results consist
+// of a row per group instead of a single row. Each group lies within a single
+// partition (GROUP BY always includes the whole partition key), so groups
+// produced by different shards never overlap, and merging results amounts to
+// concatenating them. `dispatch` finalizes the aggregates of each group and
+// puts groups back in ring order.
+//
 // Splitting query into sub-queries in is implemented as:
 //   a. Partition ranges of the original query are split into a sequence of
 //      vnodes.
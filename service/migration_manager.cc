@@ -287,9 +287,7 @@ future<> migration_manager::do_merge_schema_from(netw::messaging_service::msg_ad
             rpc::tuple<std::vector<frozen_mutation>, rpc::optional<std::vector<canonical_mutation>>> frozen_and_canonical_mutations) {
         auto&& [mutations, canonical_mutations] = frozen_and_canonical_mutations;
         if (canonical_mutations) {
-            return do_with(std::move(*canonical_mutations), [this, id] (std::vector<canonical_mutation>& mutations) {
-                return this->merge_schema_from(id, mutations);
-            });
+            return this->merge_schema_from(id, std::move(*canonical_mutations));
         }
         return do_with(std::move(mutations), [this, id] (auto&& mutations) {
             return this->merge_schema_from(id, mutations);
@@ -343,6 +341,34 @@ future<> migration_manager::merge_schema_from(netw::messaging_service::msg_addr
     return db::schema_tables::merge_schema(_sys_ks, proxy.container(), _feat, std::move(mutations));
 }
 
+future<> migration_manager::merge_schema_from(netw::messaging_service::msg_addr src, std::vector<canonical_mutation>&& canonical_mutations) {
+    mlogger.debug("Applying schema mutations from {}", src);
+    auto cms = std::move(canonical_mutations);
+    const auto& db = _storage_proxy.get_db().local();
+
+    if (_as.abort_requested()) {
+        co_await coroutine::return_exception(abort_requested_exception());
+    }
+
+    std::vector<mutation> mutations;
+    mutations.reserve(cms.size());
+    // Convert from the back, so that each canonical mutation can be freed right away.
+    while (!cms.empty()) {
+        schema_ptr s;
+        try {
+            s = db.find_column_family(cms.back().column_family_id()).schema();
+        } catch (replica::no_such_column_family& e) {
+            mlogger.error("Error while applying schema mutations from {}: {}", src, e);
+            throw std::runtime_error(fmt::format("Error while applying schema mutations: {}", e));
+        }
+        mutations.emplace_back(cms.back().to_mutation(s));
+        cms.pop_back();
+        co_await coroutine::maybe_yield();
+    }
+    std::reverse(mutations.begin(), mutations.end());
+    co_await db::schema_tables::merge_schema(_sys_ks, _storage_proxy.container(), _feat, std::move(mutations));
+}
+
 future<> migration_manager::merge_schema_from(netw::messaging_service::msg_addr src, const std::vector<frozen_mutation>& mutations)
 {
     if (_as.abort_requested()) {
@@ -1044,31 +1070,71 @@ future<> migration_manager::maybe_sync(const schema_ptr& s, netw::messaging_serv
 
 // Returns schema of given version, either from cache or from remote node identified by 'from'.
 // Doesn't affect current node's schema in any way.
-static future<schema_ptr> get_schema_definition(table_schema_version v, netw::messaging_service::msg_addr dst, netw::messaging_service& ms, service::storage_proxy& storage_proxy) {
-    return local_schema_registry().get_or_load(v, [&ms, &storage_proxy, dst] (table_schema_version v) {
-        mlogger.debug("Requesting schema {} from {}", v, dst);
-        return ms.send_get_schema_version(dst, v).then([&storage_proxy] (frozen_schema s) {
-            auto& proxy = storage_proxy.container();
-            // Since the latest schema version is always present in the schema registry
-            // we only happen to query already outdated schema version, which is
-            // referenced by the incoming request.
-            // That means the column mapping for the schema should always be inserted
-            // with TTL (refresh TTL in case column mapping already existed prior to that).
-            auto us = s.unfreeze(db::schema_ctxt(proxy));
-            // if this is a view - we might need to fix it's schema before registering it.
-            if (us->is_view()) {
-                auto& db = proxy.local().local_db();
-                schema_ptr base_schema = db.find_schema(us->view_info()->base_id());
-                auto fixed_view = db::schema_tables::maybe_fix_legacy_secondary_index_mv_schema(db, view_ptr(us), base_schema,
-                        db::schema_tables::preserve_version::yes);
-                if (fixed_view) {
-                    us = fixed_view;
-                }
-            }
-            return db::schema_tables::store_column_mapping(proxy, us, true).then([us] {
-                return frozen_schema{us};
+// Schema registries are per shard, but a version one shard learned about is
+// usually needed by the others soon after. Looking it up on the other shards
+// of this node is much cheaper than fetching it from another node.
+static future<std::optional<frozen_schema>> find_schema_on_other_shards(table_schema_version v) {
+    for (unsigned shard = 0; shard < smp::count; ++shard) {
+        if (shard == this_shard_id()) {
+            continue;
+        }
+        auto fs = co_await smp::submit_to(shard, [v] {
+            return local_schema_registry().get_frozen_or_null(v);
+        });
+        if (fs) {
+            co_return fs;
+        }
+    }
+    co_return std::nullopt;
+}
+
+// Loads a version fetched from another node into the registries of the other
+// shards, so that requests using it there don't have to fetch it too.
+static future<> push_schema_to_other_shards(table_schema_version v, const frozen_schema& fs) {
+    try {
+        co_await smp::invoke_on_others([v, &fs] {
+            local_schema_registry().get_or_load(v, [&fs] (table_schema_version) {
+                return fs;
             });
         });
+    } catch (...) {
+        mlogger.warn("Failed to load schema {} on other shards: {}", v, std::current_exception());
+    }
+}
+
+static future<frozen_schema> fetch_schema_definition(table_schema_version v, netw::messaging_service::msg_addr dst, netw::messaging_service& ms, service::storage_proxy& storage_proxy) {
+    if (auto fs = co_await find_schema_on_other_shards(v)) {
+        mlogger.debug("Found schema {} on another shard", v);
+        co_return std::move(*fs);
+    }
+    mlogger.debug("Requesting schema {} from {}", v, dst);
+    auto s = co_await ms.send_get_schema_version(dst, v);
+    auto& proxy = storage_proxy.container();
+    // Since the latest schema version is always present in the schema registry
+    // we only happen to query already outdated schema version, which is
+    // referenced by the incoming request.
+    // That means the column mapping for the schema should always be inserted
+    // with TTL (refresh TTL in case column mapping already existed prior to that).
+    auto us = s.unfreeze(db::schema_ctxt(proxy));
+    // if this is a view - we might need to fix it's schema before registering it.
+    if (us->is_view()) {
+        auto& db = proxy.local().local_db();
+        schema_ptr base_schema = db.find_schema(us->view_info()->base_id());
+        auto fixed_view = db::schema_tables::maybe_fix_legacy_secondary_index_mv_schema(db, view_ptr(us), base_schema,
+                db::schema_tables::preserve_version::yes);
+        if (fixed_view) {
+            us = fixed_view;
+        }
+    }
+    co_await db::schema_tables::store_column_mapping(proxy, us, true);
+    frozen_schema fs{us};
+    co_await push_schema_to_other_shards(v, fs);
+    co_return fs;
+}
+
+static future<schema_ptr> get_schema_definition(table_schema_version v, netw::messaging_service::msg_addr dst, netw::messaging_service& ms, service::storage_proxy& storage_proxy) {
+    return local_schema_registry().get_or_load(v, [&ms, &storage_proxy, dst] (table_schema_version v) {
+        return fetch_schema_definition(v, dst, ms, storage_proxy);
     }).then([&storage_proxy] (schema_ptr s) {
         // If this is a view so this schema also needs a reference to the base
         // table.
@@ -95,6 +95,9 @@ class migration_manager : public seastar::async_sharded_service<migration_manage
     // Merge mutations received from src.
     // Keep mutations alive around whole async operation.
     future<> merge_schema_from(netw::msg_addr src, const std::vector<canonical_mutation>& mutations);
+    // Takes the mutations and frees each of them once converted, so that a
+    // large schema, e.g. a group 0 snapshot, isn't held twice in memory.
+    future<> merge_schema_from(netw::msg_addr src, std::vector<canonical_mutation>&& mutations);
     // Deprecated. The canonical mutation should be used instead.
     future<> merge_schema_from(netw::msg_addr src, const std::vector<frozen_mutation>& mutations);
 
@@ -40,6 +40,7 @@ class paging_state final {
     uint32_t _rows_fetched_for_last_partition_high_bits;
     bound_weight _ck_weight = bound_weight::equal;
     partition_region _region = partition_region::partition_start;
+    uint32_t _concurrency_factor = 0;
 
 public:
     // IDL ctor
@@ -53,7 +54,8 @@ class paging_state final {
             uint32_t remaining_ext,
             uint32_t rows_fetched_for_last_partition_high_bits,
             bound_weight ck_weight,
-            partition_region region);
+            partition_region region,
+            uint32_t concurrency_factor);
 
     paging_state(partition_key pk,
             position_in_partition_view pos,
@@ -74,6 +76,10 @@ class paging_state final {
         _region = partition_region::clustered;
     }
 
+    void set_concurrency_factor(uint32_t concurrency_factor) {
+        _concurrency_factor = concurrency_factor;
+    }
+
     void set_remaining(uint64_t remaining) {
         _remaining_low_bits = static_cast<uint32_t>(remaining);
         _remaining_high_bits = static_cast<uint32_t>(remaining >> 32);
@@ -180,6 +186,19 @@ class paging_state final {
         return _query_read_repair_decision;
     }
 
+    /**
+     * The number of vnode ranges read concurrently by the last round of the
+     * last page of a partition range scan.
+     *
+     * Lets the next page start at the concurrency that was found to be
+     * needed to fill a page, instead of ramping it up from 1 again.
+     * 0 means unknown, e.g. the paging_state was created by an older
+     * coordinator.
+     */
+    uint32_t get_concurrency_factor() const {
+        return _concurrency_factor;
+    }
+
     static lw_shared_ptr<paging_state> deserialize(bytes_opt bytes);
     bytes_opt serialize() const;
 };
@@ -75,6 +75,7 @@ class query_pager {
     paging_state::replicas_per_token_range _last_replicas;
     std::optional<db::read_repair_decision> _query_read_repair_decision;
     uint64_t _rows_fetched_for_last_partition = 0;
+    uint32_t _concurrency_factor = 0;
     stats _stats;
 public:
     query_pager(service::storage_proxy& p, schema_ptr s, shared_ptr<const cql3::selection::selection> selection,
@@ -84,6 +85,23 @@ class query_pager {
                 dht::partition_range_vector ranges);
     virtual ~query_pager() {}
 
+    /**
+     * The approximate size, in bytes, of the pages this pager aims for.
+     * Batch workloads get larger pages than interactive ones.
+     */
+    uint64_t page_target_size() const;
+
+    /**
+     * The number of rows of the paged table which fill a page of about
+     * page_target_size() bytes, according to the average size of the rows
+     * this shard recently read from the table. To be used by callers which
+     * pick the page size themselves, instead of default_page_size, so their
+     * pages are neither tiny for narrow rows nor cut short by the memory
+     * limit for wide ones. Returns default_page_size while no rows of the
+     * table were read yet.
+     */
+    uint32_t adaptive_page_size(uint32_t default_page_size) const;
+
     /**
      * Fetches the next page.
      *
@@ -13,7 +13,10 @@
 #include "cql3/selection/selection.hh"
 #include "cql3/query_options.hh"
 #include "cql3/restrictions/statement_restrictions.hh"
+#include "db/config.hh"
+#include "gms/feature_service.hh"
 #include "log.hh"
+#include "replica/database.hh"
 #include "service/storage_proxy.hh"
 #include "to_string.hh"
 #include "utils/result_combinators.hh"
@@ -35,6 +38,43 @@ struct noop_visitor {
     uint64_t accept_partition_end(const query::result_row_view& static_row) { return 0; }
 };
 
+// The average size of the rows recently read from each table by the pagers
+// of this shard, as the coordinator received them.
+class row_size_tracker {
+    // Forget the tables once there are more than that, so dropped tables
+    // don't accumulate.
+    static constexpr size_t max_tables = 1024;
+    std::unordered_map<table_id, uint64_t> _average_row_size;
+public:
+    void update(table_id id, uint64_t bytes, uint64_t rows) {
+        if (!rows) {
+            return;
+        }
+        const uint64_t row_size = std::max<uint64_t>(bytes / rows, 1);
+        auto it = _average_row_size.find(id);
+        if (it == _average_row_size.end()) {
+            if (_average_row_size.size() >= max_tables) {
+                _average_row_size.clear();
+            }
+            _average_row_size.emplace(id, row_size);
+            return;
+        }
+        // An exponential moving average, so it follows changes of the
+        // table's rows, without being thrown off by a single page.
+        it->second = std::max<uint64_t>((it->second * 3 + row_size) / 4, 1);
+    }
+
+    std::optional<uint64_t> average_row_size(table_id id) const {
+        auto it = _average_row_size.find(id);
+        if (it == _average_row_size.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+};
+
+static thread_local row_size_tracker row_sizes;
+
 static bool has_clustering_keys(const schema& s, const query::read_command& cmd) {
     return s.clustering_key_size() > 0
             && !cmd.slice.options.contains<query::partition_slice::option::distinct>();
@@ -67,7 +107,16 @@ future<result<service::storage_proxy::coordinator_query_result>> query_pager::do
     _cmd->slice.options.set<query::partition_slice::option::allow_short_read>();
     // Override this, to make sure we use the value appropriate for paging
     // (with allow_short_read set).
-    _cmd->max_result_size = _proxy->get_max_result_size(_cmd->slice);
+    auto max_size = _proxy->get_max_result_size(_cmd->slice);
+    // Replicas only honor a page size distinct from the memory limits once
+    // the whole cluster knows about it.
+    if (_proxy->features().separate_page_size_and_safety_limit) {
+        auto target = std::min(page_target_size(), max_size.hard_limit);
+        if (target > max_size.get_page_size()) {
+            max_size = query::max_result_size(std::max(max_size.soft_limit, target), max_size.hard_limit, target);
+        }
+    }
+    _cmd->max_result_size = max_size;
 
     if (!_last_pkey && state) {
         _max = state->get_remaining();
@@ -77,6 +126,7 @@ future<result<service::storage_proxy::coordinator_query_result>> query_pager::do
         _last_replicas = state->get_last_replicas();
         _query_read_repair_decision = state->get_query_read_repair_decision();
         _rows_fetched_for_last_partition = state->get_rows_fetched_for_last_partition();
+        _concurrency_factor = state->get_concurrency_factor();
     }
 
     _cmd->is_first_page = query::is_first_page(!_query_uuid);
@@ -183,7 +233,28 @@ future<result<service::storage_proxy::coordinator_query_result>> query_pager::do
             std::move(command),
             std::move(ranges),
             _options.get_consistency(),
-            {timeout, _state.get_permit(), _state.get_client_state(), _state.get_trace_state(), std::move(_last_replicas), _query_read_repair_decision});
+            {timeout, _state.get_permit(), _state.get_client_state(), _state.get_trace_state(), std::move(_last_replicas), _query_read_repair_decision, _concurrency_factor});
+}
+
+uint64_t query_pager::page_target_size() const {
+    auto& cfg = _proxy->get_db().local().get_config();
+    if (_state.get_client_state().get_workload_type() == service::client_state::workload_type::batch) {
+        return cfg.query_page_target_size_in_bytes_for_batch();
+    }
+    return cfg.query_page_target_size_in_bytes();
+}
+
+uint32_t query_pager::adaptive_page_size(uint32_t default_page_size) const {
+    // Don't let tiny rows make up pages so long that building them, or
+    // skipping over their tombstones, stalls.
+    static constexpr uint64_t max_page_size_factor = 16;
+
+    auto target = page_target_size();
+    auto row_size = row_sizes.average_row_size(_schema->id());
+    if (!target || !row_size) {
+        return default_page_size;
+    }
+    return std::clamp<uint64_t>(target / *row_size, 1, uint64_t(default_page_size) * max_page_size_factor);
 }
 
 future<> query_pager::fetch_page(cql3::selection::result_set_builder& builder, uint32_t page_size, gc_clock::time_point now, db::timeout_clock::time_point timeout) {
@@ -195,6 +266,7 @@ future<result<>> query_pager::fetch_page_result(cql3::selection::result_set_buil
     return do_fetch_page(page_size, now, timeout).then(utils::result_wrap([this, &builder, page_size, now] (service::storage_proxy::coordinator_query_result qr) {
         _last_replicas = std::move(qr.last_replicas);
         _query_read_repair_decision = qr.read_repair_decision;
+        _concurrency_factor = qr.concurrency_factor;
         return builder.with_thread_if_needed([this, &builder, page_size, now, qr = std::move(qr)] () mutable -> result<> {
             handle_result(cql3::selection::result_set_builder::visitor(builder, *_schema, *_selection),
                           std::move(qr.query_result), page_size, now);
@@ -231,6 +303,7 @@ future<result<cql3::result_generator>> query_pager::fetch_page_generator_result(
     return do_fetch_page(page_size, now, timeout).then(utils::result_wrap([this, page_size, now, &stats] (service::storage_proxy::coordinator_query_result qr) -> future<result<cql3::result_generator>> {
         _last_replicas = std::move(qr.last_replicas);
         _query_read_repair_decision = qr.read_repair_decision;
+        _concurrency_factor = qr.concurrency_factor;
         handle_result(noop_visitor(), qr.query_result, page_size, now);
         return make_ready_future<result<cql3::result_generator>>(cql3::result_generator(_schema, std::move(qr.query_result), _cmd, _selection, stats));
     }));
@@ -254,6 +327,7 @@ class filtering_query_pager : public query_pager {
         return do_fetch_page(page_size, now, timeout).then(utils::result_wrap([this, &builder, page_size, now] (service::storage_proxy::coordinator_query_result qr) {
             _last_replicas = std::move(qr.last_replicas);
             _query_read_repair_decision = qr.read_repair_decision;
+            _concurrency_factor = qr.concurrency_factor;
             qr.query_result->ensure_counts();
             _stats.rows_read_total += *qr.query_result->row_count();
             return builder.with_thread_if_needed([&builder, this, query_result = std::move(qr.query_result), page_size, now] () mutable -> result<> {
@@ -303,6 +377,7 @@ class ghost_row_deleting_query_pager : public service::pager::query_pager {
         return do_fetch_page(page_size, now, timeout).then(utils::result_wrap([this, &builder, page_size, now] (service::storage_proxy::coordinator_query_result qr) {
             _last_replicas = std::move(qr.last_replicas);
             _query_read_repair_decision = qr.read_repair_decision;
+            _concurrency_factor = qr.concurrency_factor;
             qr.query_result->ensure_counts();
             return seastar::async([this, query_result = std::move(qr.query_result), page_size, now] () mutable -> result<> {
                 handle_result(db::view::delete_ghost_rows_visitor{_proxy, _state, view_ptr(_schema), _timeout_duration},
@@ -381,6 +456,7 @@ void query_pager::handle_result(
             update_slice(*_last_pkey);
         }
 
+        row_sizes.update(_schema->id(), results->buf().size(), v.total_rows);
         row_count = v.total_rows - v.dropped_rows;
         _max = _max - row_count;
         _exhausted = (v.total_rows < page_size && !results->is_short_read() && v.dropped_rows == 0) || _max == 0;
@@ -404,6 +480,7 @@ void query_pager::handle_result(
         }
     } else {
         row_count = results->row_count() ? *results->row_count() : std::get<1>(view.count_partitions_and_rows());
+        row_sizes.update(_schema->id(), results->buf().size(), row_count);
         _max = _max - row_count;
         _exhausted = (row_count < page_size && !results->is_short_read()) || _max == 0;
 
@@ -428,7 +505,9 @@ void query_pager::handle_result(
 }
 
 lw_shared_ptr<const paging_state> query_pager::state() const {
-    return make_lw_shared<paging_state>(_last_pkey.value_or(partition_key::make_empty()), _last_pos, _exhausted ? 0 : _max, _cmd->query_uuid, _last_replicas, _query_read_repair_decision, _rows_fetched_for_last_partition);
+    auto state = make_lw_shared<paging_state>(_last_pkey.value_or(partition_key::make_empty()), _last_pos, _exhausted ? 0 : _max, _cmd->query_uuid, _last_replicas, _query_read_repair_decision, _rows_fetched_for_last_partition);
+    state->set_concurrency_factor(_concurrency_factor);
+    return state;
 }
 
 }
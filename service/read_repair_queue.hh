@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "db/consistency_level_type.hh"
+#include "dht/token.hh"
+#include "gms/inet_address.hh"
+#include "locator/abstract_replication_strategy.hh"
+#include "mutation.hh"
+#include "schema.hh"
+
+namespace service {
+
+// Background read repairs waiting to be written.
+//
+// Repairs are queued per partition, and the repairs of a partition which is
+// found inconsistent by many reads before its repair is written are merged,
+// so that it is repaired once. The number of queued partitions is bounded;
+// repairs which don't fit are dropped, as background repairs are best-effort.
+class read_repair_queue {
+public:
+    using diffs_type = std::unordered_map<gms::inet_address, std::optional<mutation>>;
+
+    struct entry {
+        locator::effective_replication_map_ptr ermp;
+        db::consistency_level cl;
+        // The mutation each replica is missing, if any.
+        diffs_type diffs;
+    };
+
+    struct stats {
+        uint64_t queued = 0;
+        uint64_t merged = 0;
+        uint64_t dropped = 0;
+    };
+private:
+    using key_type = std::pair<table_id, dht::token>;
+    // Entries of partitions sharing a token are kept apart.
+    std::map<key_type, std::vector<entry>> _entries;
+    size_t _size = 0;
+    stats _stats;
+private:
+    static const mutation* any_mutation(const diffs_type& diffs) {
+        for (auto& [ep, m] : diffs) {
+            if (m) {
+                return &*m;
+            }
+        }
+        return nullptr;
+    }
+
+    static void merge(entry& e, entry&& other) {
+        for (auto& [ep, m] : other.diffs) {
+            if (!m) {
+                continue;
+            }
+            auto& dst = e.diffs[ep];
+            if (dst) {
+                dst->apply(std::move(*m));
+            } else {
+                dst = std::move(m);
+            }
+        }
+        // The newer replication map has the current replicas.
+        e.ermp = std::move(other.ermp);
+        e.cl = other.cl;
+    }
+public:
+    // Queues the repair of a single partition, unless max_size partitions
+    // are already queued. Returns false if the repair was dropped.
+    bool push(entry e, size_t max_size) {
+        auto m = any_mutation(e.diffs);
+        if (!m) {
+            return true;
+        }
+        auto& s = *m->schema();
+        auto& dk = m->decorated_key();
+        auto [it, inserted] = _entries.try_emplace(key_type(s.id(), dk.token()));
+        for (auto& queued : it->second) {
+            auto queued_m = any_mutation(queued.diffs);
+            if (queued_m && queued_m->decorated_key().equal(s, dk)) {
+                merge(queued, std::move(e));
+                ++_stats.merged;
+                return true;
+            }
+        }
+        if (_size >= max_size) {
+            if (inserted) {
+                _entries.erase(it);
+            }
+            ++_stats.dropped;
+            return false;
+        }
+        it->second.push_back(std::move(e));
+        ++_size;
+        ++_stats.queued;
+        return true;
+    }
+
+    // Removes and returns the repairs of up to max_partitions partitions.
+    std::vector<entry> pop(size_t max_partitions) {
+        std::vector<entry> ret;
+        while (!_entries.empty() && ret.size() < max_partitions) {
+            auto it = _entries.begin();
+            for (auto& e : it->second) {
+                ret.push_back(std::move(e));
+            }
+            _size -= it->second.size();
+            _entries.erase(it);
+        }
+        return ret;
+    }
+
+    void clear() noexcept {
+        _entries.clear();
+        _size = 0;
+    }
+
+    // Number of queued partitions.
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    const struct stats& get_stats() const noexcept {
+        return _stats;
+    }
+};
+
+}
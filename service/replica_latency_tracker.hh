@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <seastar/core/lowres_clock.hh>
+
+#include "gms/inet_address.hh"
+#include "inet_address_vectors.hh"
+#include "utils/small_vector.hh"
+#include "seastarx.hh"
+
+namespace service {
+
+// Tracks how fast replicas respond to the reads this shard coordinates, so
+// that the fastest of equally close replicas can be preferred (a "dynamic
+// snitch").
+//
+// A replica's score is the exponentially-weighted moving average of its
+// response latency, multiplied by the number of requests to it which are
+// still in flight plus one, so that a replica which stalls is avoided before
+// its requests time out. Lower is better. Latencies which were not updated
+// for a reset interval are forgotten, so that a replica which was slow gets
+// tried again.
+class replica_latency_tracker {
+public:
+    using clock_type = lowres_clock;
+    // Weight of the newest sample in the moving average.
+    static constexpr double alpha = 0.25;
+
+    struct replica_state {
+        double latency_us = 0;
+        unsigned inflight = 0;
+        // Time of the last latency sample, if any.
+        std::optional<clock_type::time_point> last_update;
+        // The replica didn't answer the failure detector's pings for a while.
+        bool suspected = false;
+        // Time the replica's failure was last reported to the failure detector.
+        std::optional<clock_type::time_point> last_failure_report;
+    };
+private:
+    std::unordered_map<gms::inet_address, replica_state> _replicas;
+private:
+    static bool expired(const replica_state& r, clock_type::time_point now, clock_type::duration reset_interval) noexcept {
+        return !r.last_update || now - *r.last_update > reset_interval;
+    }
+
+    void add_sample(replica_state& r, double latency_us, clock_type::time_point now, clock_type::duration reset_interval) noexcept {
+        if (expired(r, now, reset_interval)) {
+            r.latency_us = latency_us;
+        } else {
+            r.latency_us += alpha * (latency_us - r.latency_us);
+        }
+        r.last_update = now;
+    }
+
+    replica_state& finish_request(gms::inet_address ep) {
+        auto& r = _replicas[ep];
+        if (r.inflight) {
+            --r.inflight;
+        }
+        return r;
+    }
+public:
+    void on_request_sent(gms::inet_address ep) {
+        ++_replicas[ep].inflight;
+    }
+
+    void on_response(gms::inet_address ep, std::chrono::microseconds latency, clock_type::duration reset_interval) {
+        add_sample(finish_request(ep), latency.count(), clock_type::now(), reset_interval);
+    }
+
+    // A failed request is accounted for only if it took longer than usual
+    // (e.g. timed out), so that failing fast doesn't make a replica look fast.
+    void on_failure(gms::inet_address ep, std::chrono::microseconds latency, clock_type::duration reset_interval) {
+        auto& r = finish_request(ep);
+        auto now = clock_type::now();
+        if (expired(r, now, reset_interval) || latency.count() > r.latency_us) {
+            add_sample(r, latency.count(), now, reset_interval);
+        }
+    }
+
+    // Replicas with no recent latency samples score 0, so they are tried first.
+    double score(gms::inet_address ep, clock_type::duration reset_interval) const {
+        auto it = _replicas.find(ep);
+        if (it == _replicas.end() || expired(it->second, clock_type::now(), reset_interval)) {
+            return 0;
+        }
+        return it->second.latency_us * (1 + it->second.inflight);
+    }
+
+    // Orders each run of consecutive endpoints for which equally_close() holds
+    // by score, but only if the first endpoint of the run scores worse than the
+    // best one by more than badness_threshold (e.g. 0.1 for 10%). This keeps
+    // requests going to the same replicas, whose caches are warm, as long as
+    // they perform similarly.
+    template <typename EquallyClose>
+    requires std::is_invocable_r_v<bool, EquallyClose, gms::inet_address, gms::inet_address>
+    void sort_by_score(inet_address_vector_replica_set& eps, double badness_threshold, clock_type::duration reset_interval, EquallyClose equally_close) const {
+        auto first = eps.begin();
+        while (first != eps.end()) {
+            auto last = std::next(first);
+            while (last != eps.end() && equally_close(*first, *last)) {
+                ++last;
+            }
+            if (std::distance(first, last) > 1) {
+                utils::small_vector<std::pair<gms::inet_address, double>, 3> scored;
+                for (auto it = first; it != last; ++it) {
+                    scored.emplace_back(*it, score(*it, reset_interval));
+                }
+                auto best = std::min_element(scored.begin(), scored.end(), [] (const auto& a, const auto& b) {
+                    return a.second < b.second;
+                })->second;
+                if (scored.front().second > best * (1 + badness_threshold)) {
+                    std::stable_sort(scored.begin(), scored.end(), [] (const auto& a, const auto& b) {
+                        return a.second < b.second;
+                    });
+                    std::transform(scored.begin(), scored.end(), first, [] (const auto& p) { return p.first; });
+                }
+            }
+            first = last;
+        }
+    }
+
+    void set_suspected(gms::inet_address ep, bool suspected) {
+        if (suspected) {
+            _replicas[ep].suspected = true;
+        } else if (auto it = _replicas.find(ep); it != _replicas.end()) {
+            it->second.suspected = false;
+        }
+    }
+
+    bool is_suspected(gms::inet_address ep) const {
+        auto it = _replicas.find(ep);
+        return it != _replicas.end() && it->second.suspected;
+    }
+
+    // Moves the suspected endpoints after all the others, keeping the order
+    // of each group.
+    void move_suspected_last(inet_address_vector_replica_set& eps) const {
+        if (std::any_of(eps.begin(), eps.end(), [this] (gms::inet_address ep) { return is_suspected(ep); })) {
+            std::stable_partition(eps.begin(), eps.end(), [this] (gms::inet_address ep) { return !is_suspected(ep); });
+        }
+    }
+
+    // Whether a failed request to the replica should be reported to the
+    // failure detector, at most once per interval.
+    bool should_report_failure(gms::inet_address ep, clock_type::duration interval) {
+        auto& r = _replicas[ep];
+        auto now = clock_type::now();
+        if (r.last_failure_report && now - *r.last_failure_report < interval) {
+            return false;
+        }
+        r.last_failure_report = now;
+        return true;
+    }
+
+    void forget(gms::inet_address ep) {
+        _replicas.erase(ep);
+    }
+
+    const std::unordered_map<gms::inet_address, replica_state>& replicas() const noexcept {
+        return _replicas;
+    }
+};
+
+}
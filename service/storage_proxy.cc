@@ -76,6 +76,8 @@
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/coroutine/as_future.hh>
 #include <seastar/coroutine/all.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/timer.hh>
 #include "locator/abstract_replication_strategy.hh"
 #include "service/paxos/cas_request.hh"
 #include "mutation_partition_view.hh"
@@ -147,6 +149,107 @@ static future<rpc::tuple<Elements..., replica::exception_variant>> encode_replic
 // sending and receiving RPCs, checking the state of other nodes (e.g. by accessing gossiper state), fetching schema.
 //
 // The object is uniquely owned by `storage_proxy`, its lifetime is bounded by the lifetime of `storage_proxy`.
+// Coalesces the one-way messages sent to the same destination within a short
+// window, so that they are sent in a single RPC message rather than one each.
+//
+// Items are queued until the window, started by the first of them, expires,
+// or until max_items of them are queued for a destination. The window can be
+// zero, in which case only the items queued before the reactor polls again,
+// e.g. the writes of the same batch statement, are coalesced.
+//
+// Messages are sent in the scheduling group of the coalescer, so that they use
+// the connection of its tenant.
+template <typename Item>
+class rpc_coalescer {
+public:
+    struct batch {
+        std::vector<Item> items;
+        // The latest timeout of the items.
+        storage_proxy::clock_type::time_point timeout = storage_proxy::clock_type::time_point::min();
+    };
+    using send_fn = noncopyable_function<future<> (netw::msg_addr, batch)>;
+
+    static constexpr size_t max_items = 128;
+private:
+    struct pending {
+        batch b;
+        shared_promise<> sent;
+    };
+    // msg_addr equality ignores the shard, but messages to different shards
+    // of the same node must not be coalesced.
+    struct addr_hash {
+        size_t operator()(const netw::msg_addr& a) const noexcept {
+            return netw::msg_addr::hash()(a) ^ a.cpu_id;
+        }
+    };
+    struct addr_equal {
+        bool operator()(const netw::msg_addr& a, const netw::msg_addr& b) const noexcept {
+            return a.addr == b.addr && a.cpu_id == b.cpu_id;
+        }
+    };
+    using pending_map = std::unordered_map<netw::msg_addr, pending, addr_hash, addr_equal>;
+    pending_map _pending;
+    send_fn _send;
+    scheduling_group _sg;
+    timer<> _timer;
+    gate _gate;
+private:
+    void flush(typename pending_map::iterator it) {
+        auto addr = it->first;
+        auto p = std::move(it->second);
+        _pending.erase(it);
+        (void)with_gate(_gate, [this, addr, p = std::move(p)] () mutable {
+            return with_scheduling_group(_sg, [this, addr, b = std::move(p.b)] () mutable {
+                return futurize_invoke(_send, addr, std::move(b));
+            }).then_wrapped([sent = std::move(p.sent)] (future<> f) mutable {
+                if (f.failed()) {
+                    sent.set_exception(f.get_exception());
+                } else {
+                    sent.set_value();
+                }
+            });
+        });
+    }
+
+    void flush_all() {
+        while (!_pending.empty()) {
+            flush(_pending.begin());
+        }
+    }
+public:
+    rpc_coalescer(scheduling_group sg, send_fn send)
+        : _send(std::move(send))
+        , _sg(sg)
+        , _timer([this] { flush_all(); })
+    { }
+
+    scheduling_group sched_group() const noexcept {
+        return _sg;
+    }
+
+    // Resolves once the message holding the item was sent.
+    future<> send(netw::msg_addr addr, Item item, storage_proxy::clock_type::time_point timeout, std::chrono::microseconds window) {
+        auto it = _pending.try_emplace(addr).first;
+        auto& b = it->second.b;
+        b.items.push_back(std::move(item));
+        b.timeout = std::max(b.timeout, timeout);
+        auto f = it->second.sent.get_shared_future();
+        if (b.items.size() >= max_items) {
+            flush(it);
+        } else if (!_timer.armed()) {
+            _timer.arm(window);
+        }
+        return f;
+    }
+
+    // Sends the queued items. No items may be sent afterwards.
+    future<> stop() {
+        _timer.cancel();
+        flush_all();
+        return _gate.close();
+    }
+};
+
 //
 // The presence of this object indicates that `storage_proxy` is able to perform remote queries.
 // Without it only local queries are available.
@@ -159,6 +262,85 @@ class storage_proxy::remote {
     netw::connection_drop_slot_t _connection_dropped;
     netw::connection_drop_registration_t _condrop_registration;
 
+    struct pending_mutation {
+        frozen_mutation fm;
+        storage_proxy::response_id_type response_id;
+    };
+    // Per scheduling group.
+    std::vector<std::unique_ptr<rpc_coalescer<pending_mutation>>> _mutation_coalescers;
+    std::vector<std::unique_ptr<rpc_coalescer<storage_proxy::response_id_type>>> _mutation_done_coalescers;
+    std::vector<std::unique_ptr<rpc_coalescer<pending_mutation>>> _hint_mutation_coalescers;
+    bool _coalescers_stopped = false;
+
+    bool coalesce_writes() const {
+        return !_coalescers_stopped && _sp.features().coalesced_mutation_rpcs
+                && _sp._db.local().get_config().enable_mutation_rpc_coalescing();
+    }
+
+    // Hints are replayed in batches, so they don't wait for a window, but
+    // only for the other hints of their batch.
+    bool coalesce_hints() const {
+        return !_coalescers_stopped && _sp.features().hint_mutation_multi
+                && _sp._db.local().get_config().hinted_handoff_replay_batch_size() > 0;
+    }
+
+    std::chrono::microseconds coalescing_window() const {
+        return std::chrono::microseconds(_sp._db.local().get_config().mutation_rpc_coalescing_window_in_us());
+    }
+
+    template <typename Item>
+    rpc_coalescer<Item>& coalescer_for(std::vector<std::unique_ptr<rpc_coalescer<Item>>>& coalescers, auto make_send_fn) {
+        auto sg = current_scheduling_group();
+        for (auto& c : coalescers) {
+            if (c->sched_group() == sg) {
+                return *c;
+            }
+        }
+        return *coalescers.emplace_back(std::make_unique<rpc_coalescer<Item>>(sg, make_send_fn()));
+    }
+
+    static std::pair<std::vector<frozen_mutation>, std::vector<uint64_t>> split_batch(rpc_coalescer<pending_mutation>::batch& b) {
+        std::vector<frozen_mutation> fms;
+        std::vector<uint64_t> response_ids;
+        fms.reserve(b.items.size());
+        response_ids.reserve(b.items.size());
+        for (auto& m : b.items) {
+            fms.push_back(std::move(m.fm));
+            response_ids.push_back(m.response_id);
+        }
+        return {std::move(fms), std::move(response_ids)};
+    }
+
+    rpc_coalescer<pending_mutation>& mutation_coalescer() {
+        return coalescer_for(_mutation_coalescers, [this] {
+            return [this] (netw::msg_addr addr, rpc_coalescer<pending_mutation>::batch b) {
+                auto [fms, response_ids] = split_batch(b);
+                return ser::storage_proxy_rpc_verbs::send_mutation_multi(&_ms, std::move(addr), b.timeout,
+                        std::move(fms), utils::fb_utilities::get_broadcast_address(), this_shard_id(), std::move(response_ids));
+            };
+        });
+    }
+
+    rpc_coalescer<pending_mutation>& hint_mutation_coalescer() {
+        return coalescer_for(_hint_mutation_coalescers, [this] {
+            return [this] (netw::msg_addr addr, rpc_coalescer<pending_mutation>::batch b) {
+                auto [fms, response_ids] = split_batch(b);
+                return ser::storage_proxy_rpc_verbs::send_hint_mutation_multi(&_ms, std::move(addr), b.timeout,
+                        std::move(fms), utils::fb_utilities::get_broadcast_address(), this_shard_id(), std::move(response_ids));
+            };
+        });
+    }
+
+    rpc_coalescer<storage_proxy::response_id_type>& mutation_done_coalescer() {
+        return coalescer_for(_mutation_done_coalescers, [this] {
+            return [this] (netw::msg_addr addr, rpc_coalescer<storage_proxy::response_id_type>::batch b) {
+                auto shard = addr.cpu_id;
+                return ser::storage_proxy_rpc_verbs::send_mutation_done_multi(&_ms, std::move(addr),
+                        shard, std::move(b.items), _sp.get_view_update_backlog());
+            };
+        });
+    }
+
 public:
     remote(storage_proxy& sp, netw::messaging_service& ms, gms::gossiper& g)
         : _sp(sp), _ms(ms), _gossiper(g)
@@ -171,11 +353,15 @@ class storage_proxy::remote {
 
         ser::storage_proxy_rpc_verbs::register_counter_mutation(&_ms, std::bind_front(&remote::handle_counter_mutation, this));
         ser::storage_proxy_rpc_verbs::register_mutation(&_ms, std::bind_front(&remote::receive_mutation_handler, this, sp->_write_smp_service_group));
+        ser::storage_proxy_rpc_verbs::register_mutation_multi(&_ms, std::bind_front(&remote::handle_mutation_multi, this, sp->_write_smp_service_group));
         ser::storage_proxy_rpc_verbs::register_hint_mutation(&_ms, [this, sp] <typename... Args>(Args&&... args) { return receive_mutation_handler(sp->_hints_write_smp_service_group, std::forward<Args>(args)..., std::monostate()); });
+        ser::storage_proxy_rpc_verbs::register_hint_mutation_multi(&_ms, std::bind_front(&remote::handle_mutation_multi, this, sp->_hints_write_smp_service_group));
         ser::storage_proxy_rpc_verbs::register_paxos_learn(&_ms, std::bind_front(&remote::handle_paxos_learn, this));
         ser::storage_proxy_rpc_verbs::register_mutation_done(&_ms, std::bind_front(&remote::handle_mutation_done, this));
+        ser::storage_proxy_rpc_verbs::register_mutation_done_multi(&_ms, std::bind_front(&remote::handle_mutation_done_multi, this));
         ser::storage_proxy_rpc_verbs::register_mutation_failed(&_ms, std::bind_front(&remote::handle_mutation_failed, this));
         ser::storage_proxy_rpc_verbs::register_read_data(&_ms, std::bind_front(&remote::handle_read_data, this));
+        ser::storage_proxy_rpc_verbs::register_read_data_multi(&_ms, std::bind_front(&remote::handle_read_data_multi, this));
         ser::storage_proxy_rpc_verbs::register_read_mutation_data(&_ms, std::bind_front(&remote::handle_read_mutation_data, this));
         ser::storage_proxy_rpc_verbs::register_read_digest(&_ms, std::bind_front(&remote::handle_read_digest, this));
         ser::storage_proxy_rpc_verbs::register_truncate(&_ms, std::bind_front(&remote::handle_truncate, this));
@@ -186,6 +372,16 @@ class storage_proxy::remote {
     }
 
     future<> uninit_messaging_service() {
+        _coalescers_stopped = true;
+        for (auto& c : _mutation_coalescers) {
+            co_await c->stop();
+        }
+        for (auto& c : _mutation_done_coalescers) {
+            co_await c->stop();
+        }
+        for (auto& c : _hint_mutation_coalescers) {
+            co_await c->stop();
+        }
         co_await ser::storage_proxy_rpc_verbs::unregister(&_ms);
         _mm = nullptr;
     }
@@ -198,10 +394,29 @@ class storage_proxy::remote {
         return _gossiper.is_alive(ep);
     }
 
+    // The address of the shard of ep which owns t, so that requests for it
+    // are sent on a connection to that shard, if connections are shard-aware.
+    netw::msg_addr replica_addr(gms::inet_address ep, const schema& s, const dht::token& t) const {
+        return _ms.shard_addr(ep, s, t);
+    }
+
+    netw::msg_addr replica_addr(gms::inet_address ep, const schema& s, const dht::partition_range& pr) const {
+        if (pr.is_singular()) {
+            return replica_addr(ep, s, pr.start()->value().token());
+        }
+        return netw::msg_addr{ep, 0};
+    }
+
     future<> send_mutation(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, std::optional<tracing::trace_info> trace_info,
             frozen_mutation m, inet_address_vector_replica_set&& forward, gms::inet_address reply_to, unsigned shard,
             storage_proxy::response_id_type response_id, db::per_partition_rate_limit::info rate_limit_info) {
+        // Only the writes coordinated by this shard are coalesced, and only
+        // those which carry nothing but the mutation.
+        if (forward.empty() && !trace_info && std::holds_alternative<std::monostate>(rate_limit_info)
+                && reply_to == utils::fb_utilities::get_broadcast_address() && shard == this_shard_id() && coalesce_writes()) {
+            return mutation_coalescer().send(std::move(addr), pending_mutation{std::move(m), response_id}, timeout, coalescing_window());
+        }
         return ser::storage_proxy_rpc_verbs::send_mutation(
                 &_ms, std::move(addr), timeout,
                 std::move(m), std::move(forward), std::move(reply_to), shard,
@@ -213,6 +428,9 @@ class storage_proxy::remote {
             frozen_mutation m, inet_address_vector_replica_set&& forward, gms::inet_address reply_to, unsigned shard,
             storage_proxy::response_id_type response_id, db::per_partition_rate_limit::info rate_limit_info) {
         tracing::trace(tr_state, "Sending a hint to /{}", addr.addr);
+        if (forward.empty() && !tr_state && reply_to == utils::fb_utilities::get_broadcast_address() && shard == this_shard_id() && coalesce_hints()) {
+            return hint_mutation_coalescer().send(std::move(addr), pending_mutation{std::move(m), response_id}, timeout, std::chrono::microseconds(0));
+        }
         return ser::storage_proxy_rpc_verbs::send_hint_mutation(
                 &_ms, std::move(addr), timeout,
                 std::move(m), std::move(forward), std::move(reply_to), shard,
@@ -232,6 +450,9 @@ class storage_proxy::remote {
             netw::msg_addr addr, tracing::trace_state_ptr tr_state,
             unsigned shard, uint64_t response_id, db::view::update_backlog backlog) {
         tracing::trace(tr_state, "Sending mutation_done to /{}", addr.addr);
+        if (coalesce_writes()) {
+            return mutation_done_coalescer().send(std::move(addr), response_id, storage_proxy::clock_type::time_point::max(), coalescing_window());
+        }
         return ser::storage_proxy_rpc_verbs::send_mutation_done(
                 &_ms, std::move(addr),
                 shard, response_id, std::move(backlog));
@@ -276,6 +497,26 @@ class storage_proxy::remote {
         co_return rpc::tuple{make_foreign(::make_lw_shared<query::result>(std::move(result))), hit_rate.value_or(cache_temperature::invalid())};
     }
 
+    // Reads each of the singular partition ranges separately, as READ_DATA would, in a single RPC.
+    future<rpc::tuple<std::vector<query::result>, cache_temperature>>
+    send_read_data_multi(
+            netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
+            const query::read_command& cmd, dht::partition_range_vector prs,
+            query::digest_algorithm digest_algo, bool only_digest) {
+        tracing::trace(tr_state, "read_data_multi: sending a message with {} partition ranges to /{}", prs.size(), addr.addr);
+        auto&& [results, hit_rate, exception] =
+            co_await ser::storage_proxy_rpc_verbs::send_read_data_multi(&_ms, addr, timeout, cmd, prs, digest_algo, only_digest);
+        if (exception) {
+            co_await coroutine::return_exception_ptr(exception.into_exception_ptr());
+        }
+        if (results.size() != prs.size()) {
+            co_await coroutine::return_exception(std::runtime_error(format("read_data_multi: got {} results for {} partition ranges from /{}", results.size(), prs.size(), addr.addr)));
+        }
+
+        tracing::trace(tr_state, "read_data_multi: got response from /{}", addr.addr);
+        co_return rpc::tuple{std::move(results), hit_rate};
+    }
+
     future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>>
     send_read_digest(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
@@ -516,6 +757,22 @@ class storage_proxy::remote {
                 });
     }
 
+    // Applies, and acknowledges, each of the mutations as MUTATION would.
+    future<rpc::no_wait_type> handle_mutation_multi(
+            smp_service_group smp_grp, const rpc::client_info& cinfo, rpc::opt_time_point t,
+            std::vector<frozen_mutation> fms, gms::inet_address reply_to, unsigned shard,
+            std::vector<storage_proxy::response_id_type> response_ids) {
+        if (fms.size() != response_ids.size()) {
+            slogger.warn("Got mutation_multi with {} mutations but {} response ids from {}#{}", fms.size(), response_ids.size(), reply_to, shard);
+            co_return netw::messaging_service::no_wait();
+        }
+        co_await coroutine::parallel_for_each(fms, [&] (frozen_mutation& fm) {
+            auto response_id = response_ids[&fm - fms.data()];
+            return receive_mutation_handler(smp_grp, cinfo, t, std::move(fm), {}, reply_to, shard, response_id, std::nullopt, std::nullopt).discard_result();
+        });
+        co_return netw::messaging_service::no_wait();
+    }
+
     future<rpc::no_wait_type> handle_paxos_learn(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
             paxos::proposal decision, inet_address_vector_replica_set forward, gms::inet_address reply_to, unsigned shard,
@@ -549,6 +806,20 @@ class storage_proxy::remote {
         });
     }
 
+    future<rpc::no_wait_type> handle_mutation_done_multi(
+            const rpc::client_info& cinfo,
+            unsigned shard, std::vector<storage_proxy::response_id_type> response_ids, db::view::update_backlog backlog) {
+        auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        _sp.get_stats().replica_cross_shard_ops += shard != this_shard_id();
+        return _sp.container().invoke_on(shard, _sp._write_ack_smp_service_group,
+                [from, response_ids = std::move(response_ids), backlog] (storage_proxy& sp) mutable {
+            for (auto response_id : response_ids) {
+                sp.got_response(response_id, from, backlog);
+            }
+            return netw::messaging_service::no_wait();
+        });
+    }
+
     future<rpc::no_wait_type> handle_mutation_failed(
             const rpc::client_info& cinfo,
             unsigned shard, storage_proxy::response_id_type response_id, size_t num_failed,
@@ -610,6 +881,45 @@ class storage_proxy::remote {
         co_return co_await encode_replica_exception_for_rpc(p->features(), std::move(f), [] { return std::make_tuple(foreign_ptr(make_lw_shared<query::result>()), cache_temperature::invalid()); });
     }
 
+    future<rpc::tuple<std::vector<query::result>, cache_temperature, replica::exception_variant>>
+    handle_read_data_multi(
+            const rpc::client_info& cinfo, rpc::opt_time_point t,
+            query::read_command cmd1, dht::partition_range_vector prs,
+            query::digest_algorithm da, bool only_digest) {
+        tracing::trace_state_ptr trace_state_ptr;
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        if (cmd1.trace_info) {
+            trace_state_ptr = tracing::tracing::get_local_tracing_instance().create_session(*cmd1.trace_info);
+            tracing::begin(trace_state_ptr);
+            tracing::trace(trace_state_ptr, "read_data_multi: message with {} partition ranges received from /{}", prs.size(), src_addr.addr);
+        }
+        if (!cmd1.max_result_size) {
+            auto& cfg = _sp.local_db().get_config();
+            cmd1.max_result_size.emplace(cfg.max_memory_for_unlimited_query_soft_limit(), cfg.max_memory_for_unlimited_query_hard_limit());
+        }
+
+        shared_ptr<storage_proxy> p = _sp.shared_from_this();
+        auto cmd = make_lw_shared<query::read_command>(std::move(cmd1));
+        if (only_digest) {
+            p->get_stats().replica_digest_reads += prs.size();
+        } else {
+            p->get_stats().replica_data_reads += prs.size();
+        }
+        auto src_ip = src_addr.addr;
+        schema_ptr s = co_await get_schema_for_read(cmd->schema_version, std::move(src_addr));
+        if (!std::all_of(prs.begin(), prs.end(), std::mem_fn(&dht::partition_range::is_singular))) {
+            throw std::runtime_error("READ_DATA_MULTI called with non-singular range");
+        }
+        query::result_options opts;
+        opts.digest_algo = da;
+        opts.request = only_digest ? query::result_request::only_digest
+                : da == query::digest_algorithm::none ? query::result_request::only_result : query::result_request::result_and_digest;
+        auto timeout = t ? *t : db::no_timeout;
+        auto f = co_await coroutine::as_future(p->query_result_local_multi(std::move(s), cmd, prs, opts, trace_state_ptr, timeout));
+        tracing::trace(trace_state_ptr, "read_data_multi handling is done, sending a response to /{}", src_ip);
+        co_return co_await encode_replica_exception_for_rpc(p->features(), std::move(f), [] { return std::make_tuple(std::vector<query::result>(), cache_temperature::invalid()); });
+    }
+
     future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature, replica::exception_variant>>
     handle_read_mutation_data(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
@@ -802,6 +1112,7 @@ class storage_proxy::remote {
         for (auto&& cf : _sp._db.local().get_non_system_column_families()) {
             cf->drop_hit_rate(addr);
         }
+        _sp.report_replica_failure(addr);
     }
 };
 
@@ -812,6 +1123,9 @@ using fbu = utils::fb_utilities;
 
 static inline
 query::digest_algorithm digest_algorithm(service::storage_proxy& proxy) {
+    if (proxy.features().xxhash3_digest) {
+        return query::digest_algorithm::xxHash3;
+    }
     return proxy.features().digest_for_null_values
             ? query::digest_algorithm::xxHash
             : query::digest_algorithm::legacy_xxHash_without_null_digest;
@@ -870,6 +1184,25 @@ static result<db::per_partition_rate_limit::info> choose_rate_limit_info(
     return enforce_info;
 }
 
+// Enforces the table-wide rate limit on the coordinator, before any work is
+// sent to the replicas.
+static result<> check_table_rate_limit(
+        replica::database& db,
+        db::operation_type op_type,
+        const schema_ptr& s,
+        tracing::trace_state_ptr tr_state) {
+    db::per_partition_rate_limit::account_and_enforce enforce_info{
+        .random_variable = random_variable_for_rate_limit(),
+    };
+    auto& cf = db.find_column_family(s);
+    if (db.account_coordinator_operation_to_table_rate_limit(cf, enforce_info, op_type) == db::rate_limiter::can_proceed::no) {
+        slogger.trace("Table rate limiting: coordinator rejected");
+        tracing::trace(tr_state, "Table rate limiting: coordinator rejected");
+        return coordinator_exception_container(exceptions::rate_limit_exception(s->ks_name(), s->cf_name(), op_type, true));
+    }
+    return bo::success();
+}
+
 static inline db::per_partition_rate_limit::info adjust_rate_limit_for_local_operation(
         const db::per_partition_rate_limit::info& info) {
     if (std::holds_alternative<db::per_partition_rate_limit::account_only>(info)) {
@@ -946,7 +1279,7 @@ class per_destination_mutation : public mutation_holder {
         auto m = _mutations[ep];
         if (m) {
             tracing::trace(tr_state, "Sending a mutation to /{}", ep);
-            return sp.remote().send_mutation(netw::messaging_service::msg_addr{ep, 0}, timeout, tracing::make_trace_info(tr_state),
+            return sp.remote().send_mutation(sp.remote().replica_addr(ep, *_schema, _token), timeout, tracing::make_trace_info(tr_state),
                     *m, std::move(forward), utils::fb_utilities::get_broadcast_address(), this_shard_id(),
                     response_id, rate_limit_info);
         }
@@ -972,11 +1305,13 @@ class per_destination_mutation : public mutation_holder {
 class shared_mutation : public mutation_holder {
 protected:
     lw_shared_ptr<const frozen_mutation> _mutation;
+    dht::token _token;
 public:
     explicit shared_mutation(frozen_mutation_and_schema&& fm_a_s)
             : _mutation(make_lw_shared<const frozen_mutation>(std::move(fm_a_s.fm))) {
         _size = _mutation->representation().size();
         _schema = std::move(fm_a_s.s);
+        _token = dht::get_token(*_schema, _mutation->key());
     }
     explicit shared_mutation(const mutation& m) : shared_mutation(frozen_mutation_and_schema{freeze(m), m.schema()}) {
     }
@@ -992,7 +1327,7 @@ class shared_mutation : public mutation_holder {
             storage_proxy::response_id_type response_id, storage_proxy::clock_type::time_point timeout,
             tracing::trace_state_ptr tr_state, db::per_partition_rate_limit::info rate_limit_info) override {
         tracing::trace(tr_state, "Sending a mutation to /{}", ep);
-        return sp.remote().send_mutation(netw::messaging_service::msg_addr{ep, 0}, timeout, tracing::make_trace_info(tr_state),
+        return sp.remote().send_mutation(sp.remote().replica_addr(ep, *_schema, _token), timeout, tracing::make_trace_info(tr_state),
                 *_mutation, std::move(forward), utils::fb_utilities::get_broadcast_address(), this_shard_id(),
                 response_id, rate_limit_info);
     }
@@ -1021,7 +1356,7 @@ class hint_mutation : public shared_mutation {
             storage_proxy::response_id_type response_id, storage_proxy::clock_type::time_point timeout,
             tracing::trace_state_ptr tr_state, db::per_partition_rate_limit::info rate_limit_info) override {
         return sp.remote().send_hint_mutation(
-                netw::messaging_service::msg_addr{ep, 0}, timeout, tr_state,
+                sp.remote().replica_addr(ep, *_schema, _token), timeout, tr_state,
                 *_mutation, std::move(forward), utils::fb_utilities::get_broadcast_address(), this_shard_id(), response_id, rate_limit_info);
     }
 };
@@ -1112,6 +1447,9 @@ class paxos_response_handler : public enable_shared_from_this<paxos_response_han
     void set_cl_for_learn(db::consistency_level cl) {
         _cl_for_learn = cl;
     }
+    db::consistency_level cl_for_learn() const {
+        return _cl_for_learn;
+    }
     // this is called with an id of a replica that replied to learn request
     // adn returns true when quorum of such requests are accumulated
     bool learned(gms::inet_address ep);
@@ -2567,6 +2905,10 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("how many times paxos prune was done after successful cas operation"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
 
+        sm::make_total_operations("cas_background_learn", cas_background_learn,
+                       sm::description("how many times paxos learn was not waited for, since its consistency level was ANY"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_total_operations("cas_dropped_prune", cas_coordinator_dropped_prune,
                        sm::description("how many times a coordinator did not perfom prune after cas"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
@@ -2721,12 +3063,21 @@ storage_proxy::storage_proxy(distributed<replica::database>& db, gms::gossiper&
     , _remote(std::make_unique<struct remote>(*this, ms, gossiper))
     , _background_write_throttle_threahsold(cfg.available_memory / 10)
     , _mutate_stage{"storage_proxy_mutate", &storage_proxy::do_mutate}
+    , _background_read_repair_scheduling_group(cfg.background_read_repair_scheduling_group)
     , _max_view_update_backlog(max_view_update_backlog)
     , _view_update_handlers_list(std::make_unique<view_update_handlers_list>()) {
     namespace sm = seastar::metrics;
     _metrics.add_group(storage_proxy_stats::COORDINATOR_STATS_CATEGORY, {
         sm::make_queue_length("current_throttled_writes", [this] { return _throttled_writes.size(); },
                        sm::description("number of currently throttled write requests")),
+        sm::make_queue_length("background_read_repair_backlog", [this] { return _background_read_repairs.size(); },
+                       sm::description("number of partitions waiting for a background read repair")),
+        sm::make_total_operations("background_read_repairs_queued", [this] { return _background_read_repairs.get_stats().queued; },
+                       sm::description("number of partitions queued for a background read repair")),
+        sm::make_total_operations("background_read_repairs_merged", [this] { return _background_read_repairs.get_stats().merged; },
+                       sm::description("number of background read repairs merged with an already queued repair of the same partition")),
+        sm::make_total_operations("background_read_repairs_dropped", [this] { return _background_read_repairs.get_stats().dropped; },
+                       sm::description("number of background read repairs dropped because the queue was full")),
     });
 
     slogger.trace("hinted DCs: {}", cfg.hinted_handoff_enabled.to_configuration_string());
@@ -2887,6 +3238,13 @@ storage_proxy::create_write_response_handler_helper(schema_ptr s, const dht::tok
     std::partition_copy(all.begin(), all.end(), std::back_inserter(live_endpoints),
             std::back_inserter(dead_endpoints), std::bind_front(&storage_proxy::is_alive, this));
 
+    if (allow_limit && _db.local().can_apply_table_rate_limit(*s, db::operation_type::write)) {
+        auto r = check_table_rate_limit(_db.local(), db::operation_type::write, s, tr_state);
+        if (!r) {
+            return std::move(r).as_failure();
+        }
+    }
+
     db::per_partition_rate_limit::info rate_limit_info;
     if (allow_limit && _db.local().can_apply_per_partition_rate_limit(*s, db::operation_type::write)) {
         auto r_rate_limit_info = choose_rate_limit_info(_db.local(), coordinator_in_replica_set, db::operation_type::write, s, token, tr_state);
@@ -3275,15 +3633,30 @@ future<> storage_proxy::mutate(std::vector<mutation> mutations, db::consistency_
             .then(utils::result_into_future<result<>>);
 }
 
+// Ends the stage of the write when f resolves. Writes which are not sampled
+// do not pay for the continuation.
+static future<result<>> end_write_stage(db::write_path_profiler::timer timer, db::write_stage stage, future<result<>> f) {
+    if (!timer) {
+        return f;
+    }
+    return f.finally([timer, stage] () mutable {
+        timer.end_stage(stage);
+    });
+}
+
 future<result<>> storage_proxy::mutate_result(std::vector<mutation> mutations, db::consistency_level cl, clock_type::time_point timeout, tracing::trace_state_ptr tr_state, service_permit permit, db::allow_per_partition_rate_limit allow_limit, bool raw_counters) {
+    auto timer = _db.local().get_write_path_profiler().sample();
     if (_cdc && _cdc->needs_cdc_augmentation(mutations)) {
-        return _cdc->augment_mutation_call(timeout, std::move(mutations), tr_state, cl).then([this, cl, timeout, tr_state, permit = std::move(permit), raw_counters, cdc = _cdc->shared_from_this(), allow_limit](std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>&& t) mutable {
+        return _cdc->augment_mutation_call(timeout, std::move(mutations), tr_state, cl).then([this, cl, timeout, tr_state, permit = std::move(permit), raw_counters, cdc = _cdc->shared_from_this(), allow_limit, timer](std::tuple<std::vector<mutation>, lw_shared_ptr<cdc::operation_result_tracker>>&& t) mutable {
             auto mutations = std::move(std::get<0>(t));
             auto tracker = std::move(std::get<1>(t));
-            return _mutate_stage(this, std::move(mutations), cl, timeout, std::move(tr_state), std::move(permit), raw_counters, allow_limit, std::move(tracker));
+            timer.end_stage(db::write_stage::cdc_augmentation);
+            return end_write_stage(timer, db::write_stage::replication,
+                    _mutate_stage(this, std::move(mutations), cl, timeout, std::move(tr_state), std::move(permit), raw_counters, allow_limit, std::move(tracker)));
         });
     }
-    return _mutate_stage(this, std::move(mutations), cl, timeout, std::move(tr_state), std::move(permit), raw_counters, allow_limit, nullptr);
+    return end_write_stage(timer, db::write_stage::replication,
+            _mutate_stage(this, std::move(mutations), cl, timeout, std::move(tr_state), std::move(permit), raw_counters, allow_limit, nullptr));
 }
 
 future<result<>> storage_proxy::do_mutate(std::vector<mutation> mutations, db::consistency_level cl, clock_type::time_point timeout, tracing::trace_state_ptr tr_state, service_permit permit, bool raw_counters, db::allow_per_partition_rate_limit allow_limit, lw_shared_ptr<cdc::operation_result_tracker> cdc_tracker) {
@@ -3569,11 +3942,18 @@ mutation storage_proxy::get_batchlog_mutation_for(const std::vector<mutation>& m
     auto timestamp = api::new_timestamp();
     auto data = [this, &mutations] {
         std::vector<canonical_mutation> fm(mutations.begin(), mutations.end());
-        bytes_ostream out;
+        // Serialize straight into the cell value, rather than into a
+        // bytes_ostream, which would have to be linearized and then copied.
+        seastar::measuring_output_stream measure;
+        for (auto& m : fm) {
+            ser::serialize(measure, m);
+        }
+        bytes data(bytes::initialized_later(), measure.size());
+        seastar::simple_output_stream out(reinterpret_cast<char*>(data.begin()), data.size());
         for (auto& m : fm) {
             ser::serialize(out, m);
         }
-        return to_bytes(out.linearize());
+        return data;
     }();
 
     mutation m(schema, key);
@@ -3831,6 +4211,17 @@ void storage_proxy::send_to_live_endpoints(storage_proxy::response_id_type respo
     }
 }
 
+inet_address_vector_topology_change storage_proxy::hint_view_update(const frozen_mutation_and_schema& fm_a_s,
+        inet_address_vector_topology_change targets, tracing::trace_state_ptr tr_state) {
+    auto fm = make_lw_shared<const frozen_mutation>(fm_a_s.fm);
+    std::erase_if(targets, [&] (gms::inet_address ep) {
+        return _hints_for_views_manager.can_hint_for(ep)
+                && !_hints_for_views_manager.too_many_in_flight_hints_for(ep)
+                && _hints_for_views_manager.store_hint(ep, fm_a_s.s, fm, tr_state);
+    });
+    return targets;
+}
+
 // returns number of hints stored
 template<typename Range>
 size_t storage_proxy::hint_to_dead_endpoints(std::unique_ptr<mutation_holder>& mh, const Range& targets, db::write_type type, tracing::trace_state_ptr tr_state) noexcept
@@ -3853,6 +4244,59 @@ future<result<>> storage_proxy::schedule_repair(locator::effective_replication_m
     return mutate_internal(diffs | boost::adaptors::map_values | boost::adaptors::transformed([ermp] (auto& v) { return read_repair_mutation{std::move(v), ermp}; }), cl, false, std::move(trace_state), std::move(permit));
 }
 
+future<result<>> storage_proxy::queue_background_repair(locator::effective_replication_map_ptr ermp, std::unordered_map<dht::token, std::unordered_map<gms::inet_address, std::optional<mutation>>> diffs, db::consistency_level cl, tracing::trace_state_ptr trace_state,
+                                        service_permit permit) {
+    auto max_size = _db.local().get_config().background_read_repair_queue_size();
+    if (max_size == 0 || _background_read_repair_gate.is_closed()) {
+        return schedule_repair(std::move(ermp), std::move(diffs), cl, std::move(trace_state), std::move(permit));
+    }
+    size_t dropped = 0;
+    for (auto& [token, diff] : diffs) {
+        dropped += !_background_read_repairs.push(read_repair_queue::entry{ermp, cl, std::move(diff)}, max_size);
+    }
+    tracing::trace(trace_state, "Queued background read repair of {} partitions, {} dropped", diffs.size() - dropped, dropped);
+    if (!_flushing_background_read_repairs && !_background_read_repairs.empty()) {
+        _flushing_background_read_repairs = true;
+        // Waited on indirectly, by drain_on_shutdown().
+        (void)with_gate(_background_read_repair_gate, [this] {
+            return with_scheduling_group(_background_read_repair_scheduling_group, [this] {
+                return flush_background_repairs();
+            });
+        }).finally([this] {
+            _flushing_background_read_repairs = false;
+        });
+    }
+    return make_ready_future<result<>>(bo::success());
+}
+
+future<> storage_proxy::flush_background_repairs() {
+    while (!_background_read_repairs.empty()) {
+        auto batch_size = std::max<size_t>(1, _db.local().get_config().background_read_repair_batch_size());
+        auto batch = _background_read_repairs.pop(batch_size);
+        // Repairs can be written by a single mutate_internal() call only if they have the same consistency level.
+        std::stable_sort(batch.begin(), batch.end(), [] (const read_repair_queue::entry& a, const read_repair_queue::entry& b) {
+            return a.cl < b.cl;
+        });
+        for (auto first = batch.begin(); first != batch.end();) {
+            auto cl = first->cl;
+            auto last = std::find_if(first, batch.end(), [cl] (const read_repair_queue::entry& e) { return e.cl != cl; });
+            auto mutations = boost::copy_range<std::vector<read_repair_mutation>>(boost::make_iterator_range(first, last)
+                    | boost::adaptors::transformed([] (read_repair_queue::entry& e) {
+                return read_repair_mutation{std::move(e.diffs), std::move(e.ermp)};
+            }));
+            first = last;
+            try {
+                auto res = co_await mutate_internal(std::move(mutations), cl, false, nullptr, empty_service_permit());
+                if (!res) {
+                    slogger.debug("Background read repair failed: {}", res.assume_error());
+                }
+            } catch (...) {
+                slogger.debug("Background read repair failed: {}", std::current_exception());
+            }
+        }
+    }
+}
+
 class abstract_read_resolver {
 protected:
     enum class error_kind : uint8_t {
@@ -4569,6 +5013,72 @@ class data_read_resolver : public abstract_read_resolver {
     }
 };
 
+// Coalesces the data and digest requests, which the read executors of a single
+// multi-partition query (e.g. SELECT ... WHERE pk IN (...)) send to the same
+// replica, into one READ_DATA_MULTI RPC per replica.
+//
+// Requests are collected while the executors are started, and sent by send().
+// Requests made afterwards (speculative retries, read repair) are sent as usual.
+class read_data_batcher {
+public:
+    using data_result = rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>;
+private:
+    struct request {
+        dht::partition_range range;
+        promise<data_result> result;
+    };
+    // Requests are batched per replica and kind of result.
+    using batch_key = std::tuple<gms::inet_address, query::digest_algorithm, bool /* only_digest */>;
+
+    shared_ptr<storage_proxy> _proxy;
+    lw_shared_ptr<query::read_command> _cmd;
+    storage_proxy::clock_type::time_point _timeout;
+    tracing::trace_state_ptr _trace_state;
+    std::map<batch_key, std::vector<request>> _batches;
+    bool _open = true;
+public:
+    read_data_batcher(shared_ptr<storage_proxy> proxy, lw_shared_ptr<query::read_command> cmd, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr trace_state)
+        : _proxy(std::move(proxy))
+        , _cmd(std::move(cmd))
+        , _timeout(timeout)
+        , _trace_state(std::move(trace_state))
+    { }
+
+    bool can_batch(const lw_shared_ptr<query::read_command>& cmd, storage_proxy::clock_type::time_point timeout) const noexcept {
+        return _open && cmd == _cmd && timeout == _timeout;
+    }
+
+    future<data_result> add(gms::inet_address ep, const dht::partition_range& pr, query::digest_algorithm da, bool only_digest) {
+        auto& requests = _batches[batch_key(ep, da, only_digest)];
+        requests.push_back(request{pr, promise<data_result>()});
+        return requests.back().result.get_future();
+    }
+
+    void send() {
+        _open = false;
+        for (auto& [key, requests] : _batches) {
+            auto& [ep, da, only_digest] = key;
+            auto prs = boost::copy_range<dht::partition_range_vector>(requests | boost::adaptors::transformed(std::mem_fn(&request::range)));
+            // Waited on indirectly, through the futures of the requests
+            (void)_proxy->remote().send_read_data_multi(netw::messaging_service::msg_addr{ep, 0}, _timeout, _trace_state, *_cmd, std::move(prs), da, only_digest).then_wrapped(
+                    [requests = std::move(requests), cmd = _cmd, proxy = _proxy] (future<rpc::tuple<std::vector<query::result>, cache_temperature>> f) mutable {
+                if (f.failed()) {
+                    auto ex = f.get_exception();
+                    for (auto& r : requests) {
+                        r.result.set_exception(ex);
+                    }
+                    return;
+                }
+                auto&& [results, hit_rate] = f.get();
+                for (size_t i = 0; i < requests.size(); ++i) {
+                    requests[i].result.set_value(data_result(make_foreign(make_lw_shared<query::result>(std::move(results[i]))), hit_rate));
+                }
+            });
+        }
+        _batches.clear();
+    }
+};
+
 class abstract_read_executor : public enable_shared_from_this<abstract_read_executor> {
 protected:
     using targets_iterator = inet_address_vector_replica_set::iterator;
@@ -4594,8 +5104,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     tracing::trace_state_ptr _trace_state;
     lw_shared_ptr<replica::column_family> _cf;
     bool _foreground = true;
+    // Whether reconcile() is a background check of the digests, so nobody waits for its repair.
+    bool _background_repair = false;
     service_permit _permit; // holds admission permit until operation completes
     db::per_partition_rate_limit::info _rate_limit_info;
+    lw_shared_ptr<read_data_batcher> _batcher;
 
 private:
     void on_read_resolved() noexcept {
@@ -4608,6 +5121,21 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         return _effective_replication_map_ptr->get_topology();
     }
 
+    void on_replica_request_sent(gms::inet_address ep) {
+        _proxy->get_replica_latencies().on_request_sent(ep);
+    }
+
+    void on_replica_response(gms::inet_address ep, latency_clock::time_point start, bool failed) {
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(latency_clock::now() - start);
+        auto& tracker = _proxy->get_replica_latencies();
+        if (failed) {
+            tracker.on_failure(ep, latency, _proxy->replica_latency_reset_interval());
+            _proxy->report_replica_failure(ep);
+        } else {
+            tracker.on_response(ep, latency, _proxy->replica_latency_reset_interval());
+        }
+    }
+
 public:
     abstract_read_executor(schema_ptr s, lw_shared_ptr<replica::column_family> cf, shared_ptr<storage_proxy> proxy,
             locator::effective_replication_map_ptr ermp,
@@ -4625,6 +5153,12 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         _proxy->get_stats().foreground_reads -= int(_foreground);
     }
 
+    // Lets the remote data and digest requests of the executor be sent together
+    // with those of other executors of the same query.
+    void set_batcher(lw_shared_ptr<read_data_batcher> batcher) noexcept {
+        _batcher = std::move(batcher);
+    }
+
     /// Targets that were successfully ised for data and/or digest requests.
     ///
     /// Only filled after the request is finished, call only after
@@ -4640,9 +5174,13 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
             tracing::trace(_trace_state, "read_mutation_data: querying locally");
             return _proxy->query_mutations_locally(_schema, cmd, _partition_range, timeout, _trace_state);
         } else {
-            return _proxy->remote().send_read_mutation_data(netw::messaging_service::msg_addr{ep, 0}, timeout, _trace_state, *cmd, _partition_range);
+            return _proxy->remote().send_read_mutation_data(_proxy->remote().replica_addr(ep, *_schema, _partition_range), timeout, _trace_state, *cmd, _partition_range);
         }
     }
+    // Per-partition rate limiting decisions are per partition, so such requests are not batched.
+    bool can_batch(clock_type::time_point timeout) const noexcept {
+        return _batcher && _batcher->can_batch(_cmd, timeout) && std::holds_alternative<std::monostate>(_rate_limit_info);
+    }
     future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> make_data_request(gms::inet_address ep, clock_type::time_point timeout, bool want_digest) {
         ++_proxy->get_stats().data_read_attempts.get_ep_stat(get_topology(), ep);
         auto opts = want_digest
@@ -4651,8 +5189,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         if (fbu::is_me(ep)) {
             tracing::trace(_trace_state, "read_data: querying locally");
             return _proxy->query_result_local(_schema, _cmd, _partition_range, opts, _trace_state, timeout, adjust_rate_limit_for_local_operation(_rate_limit_info));
+        } else if (can_batch(timeout)) {
+            return _batcher->add(ep, _partition_range, opts.digest_algo, false);
         } else {
-            return _proxy->remote().send_read_data(netw::messaging_service::msg_addr{ep, 0}, timeout, _trace_state, *_cmd, _partition_range, opts.digest_algo, _rate_limit_info);
+            return _proxy->remote().send_read_data(_proxy->remote().replica_addr(ep, *_schema, _partition_range), timeout, _trace_state, *_cmd, _partition_range, opts.digest_algo, _rate_limit_info);
         }
     }
     future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> make_digest_request(gms::inet_address ep, clock_type::time_point timeout) {
@@ -4661,17 +5201,24 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
             tracing::trace(_trace_state, "read_digest: querying locally");
             return _proxy->query_result_local_digest(_schema, _cmd, _partition_range, _trace_state,
                         timeout, digest_algorithm(*_proxy), adjust_rate_limit_for_local_operation(_rate_limit_info));
+        } else if (can_batch(timeout)) {
+            return _batcher->add(ep, _partition_range, digest_algorithm(*_proxy), true).then([] (read_data_batcher::data_result result_and_hit_rate) {
+                auto&& [result, hit_rate] = result_and_hit_rate;
+                return rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>(*result->digest(), result->last_modified(), hit_rate, result->last_position());
+            });
         } else {
             tracing::trace(_trace_state, "read_digest: sending a message to /{}", ep);
-            return _proxy->remote().send_read_digest(netw::messaging_service::msg_addr{ep, 0}, timeout, _trace_state, *_cmd, _partition_range, digest_algorithm(*_proxy), _rate_limit_info);
+            return _proxy->remote().send_read_digest(_proxy->remote().replica_addr(ep, *_schema, _partition_range), timeout, _trace_state, *_cmd, _partition_range, digest_algorithm(*_proxy), _rate_limit_info);
         }
     }
     void make_mutation_data_requests(lw_shared_ptr<query::read_command> cmd, data_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            on_replica_request_sent(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_mutation_data_request(cmd, ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> f) {
                 std::exception_ptr ex;
+                on_replica_response(ep, start, f.failed());
                 try {
                   if (!f.failed()) {
                     auto v = f.get0();
@@ -4695,9 +5242,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_data_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout, bool want_digest) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            on_replica_request_sent(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
                 std::exception_ptr ex;
+                on_replica_response(ep, start, f.failed());
                 try {
                   if (!f.failed()) {
                     auto v = f.get0();
@@ -4722,9 +5271,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     void make_digest_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            on_replica_request_sent(ep);
             // Waited on indirectly, shared_from_this keeps `this` alive
             (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> f) {
                 std::exception_ptr ex;
+                on_replica_response(ep, start, f.failed());
                 try {
                   if (!f.failed()) {
                     auto v = f.get0();
@@ -4802,7 +5353,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     // trigger repair multiple times and to prevent quorum read to return an old value, even after a quorum
                     // another read had returned a newer value (but the newer value had not yet been sent to the other replicas)
                     // Waited on indirectly.
-                    (void)_proxy->schedule_repair(_effective_replication_map_ptr, data_resolver->get_diffs_for_repair(), _cl, _trace_state, _permit).then(utils::result_wrap([this, result = std::move(result)] () mutable {
+                    auto repair = _background_repair
+                            ? _proxy->queue_background_repair(_effective_replication_map_ptr, data_resolver->get_diffs_for_repair(), _cl, _trace_state, _permit)
+                            : _proxy->schedule_repair(_effective_replication_map_ptr, data_resolver->get_diffs_for_repair(), _cl, _trace_state, _permit);
+                    (void)std::move(repair).then(utils::result_wrap([this, result = std::move(result)] () mutable {
                         _result_promise.set_value(std::move(result));
                         return make_ready_future<::result<>>(bo::success());
                     })).then_wrapped([this, exec] (future<::result<>>&& f) {
@@ -4941,6 +5495,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                 if (background_repair_check && !digest_resolver->digests_match()) {
                     exec->_proxy->get_stats().read_repair_repaired_background++;
                     exec->_result_promise = promise<result<foreign_ptr<lw_shared_ptr<query::result>>>>();
+                    exec->_background_repair = true;
                     exec->reconcile(exec->_cl, timeout);
                     return exec->_result_promise.get_future().then(utils::result_discard_value<result<foreign_ptr<lw_shared_ptr<query::result>>>>);
                 } else {
@@ -5003,7 +5558,8 @@ class always_speculating_read_executor : public abstract_read_executor {
 
 // this executor sends request to an additional replica after some time below timeout
 class speculating_read_executor : public abstract_read_executor {
-    timer<storage_proxy::clock_type> _speculate_timer;
+    // Speculation delays are often way below the lowres_clock resolution.
+    timer<seastar::steady_clock_type> _speculate_timer;
 public:
     using abstract_read_executor::abstract_read_executor;
     virtual void make_requests(digest_resolver_ptr resolver, storage_proxy::clock_type::time_point timeout) override {
@@ -5024,9 +5580,14 @@ class speculating_read_executor : public abstract_read_executor {
             }
         });
         auto& sr = _schema->speculative_retry();
-        auto t = (sr.get_type() == speculative_retry::type::PERCENTILE) ?
-            std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2)) :
-            std::chrono::milliseconds(unsigned(sr.get_value()));
+        std::chrono::microseconds t;
+        if (sr.get_type() == speculative_retry::type::PERCENTILE) {
+            // Until there are enough reads to estimate the percentile, speculate only for really slow ones.
+            auto max_delay = std::chrono::microseconds(std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms() / 2));
+            t = std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()).value_or(max_delay), max_delay);
+        } else {
+            t = std::chrono::microseconds(int64_t(sr.get_value() * 1000));
+        }
         _speculate_timer.arm(t);
 
         // if CL + RR result in covering all replicas, getReadExecutor forces AlwaysSpeculating.  So we know
@@ -5117,6 +5678,15 @@ result<::shared_ptr<abstract_read_executor>> storage_proxy::get_read_executor(lw
     size_t block_for = db::block_for(*erm, cl);
     auto p = shared_from_this();
 
+    if (cmd->allow_limit && _db.local().can_apply_table_rate_limit(*schema, db::operation_type::read)) {
+        auto r = check_table_rate_limit(_db.local(), db::operation_type::read, schema, trace_state);
+        if (!r) {
+            slogger.debug("Read was rate limited");
+            get_stats().read_rate_limited_by_coordinator.mark();
+            return std::move(r).as_failure();
+        }
+    }
+
     db::per_partition_rate_limit::info rate_limit_info;
     if (cmd->allow_limit && _db.local().can_apply_per_partition_rate_limit(*schema, db::operation_type::read)) {
         auto r_rate_limit_info = choose_rate_limit_info(_db.local(), !is_read_non_local, db::operation_type::read, schema, token, trace_state);
@@ -5198,6 +5768,31 @@ storage_proxy::query_result_local(schema_ptr s, lw_shared_ptr<query::read_comman
     }
 }
 
+future<rpc::tuple<std::vector<query::result>, cache_temperature>>
+storage_proxy::query_result_local_multi(schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range_vector& prs, query::result_options opts,
+                                        tracing::trace_state_ptr trace_state, storage_proxy::clock_type::time_point timeout) {
+    std::vector<future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>> futures;
+    futures.reserve(prs.size());
+    for (auto& pr : prs) {
+        futures.push_back(query_result_local(s, cmd, pr, opts, trace_state, timeout, std::monostate()));
+    }
+    auto results_and_hit_rates = co_await when_all_succeed(futures.begin(), futures.end());
+
+    std::vector<query::result> results;
+    results.reserve(results_and_hit_rates.size());
+    auto hit_rate = cache_temperature::invalid();
+    for (auto& [r, ht] : results_and_hit_rates) {
+        // The result may belong to another shard, together with the memory
+        // tracker accounting for it, which must be released there. So copy
+        // the contents, instead of moving the result here.
+        results.emplace_back(bytes_ostream(r->buf()), r->digest(), r->last_modified(), r->is_short_read(),
+                r->row_count_low_bits(), r->partition_count(), r->row_count_high_bits(), r->last_position());
+        hit_rate = ht;
+        co_await coroutine::maybe_yield();
+    }
+    co_return rpc::tuple(std::move(results), hit_rate);
+}
+
 void storage_proxy::handle_read_error(std::variant<exceptions::coordinator_exception_container, std::exception_ptr> failure, bool range) {
     // All errors are handled, it's OK to discard the result.
     (void)utils::result_try([&] () -> result<> {
@@ -5313,7 +5908,19 @@ storage_proxy::query_singular(lw_shared_ptr<query::read_command> cmd,
             };
             query::result_merger merger(cmd->get_row_limit(), cmd->partition_limit);
             merger.reserve(exec.size());
-            result = co_await utils::result_map_reduce(exec.begin(), exec.end(), std::move(mapper), std::move(merger));
+            lw_shared_ptr<read_data_batcher> batcher;
+            if (_features.batched_singular_reads) {
+                batcher = make_lw_shared<read_data_batcher>(p, cmd, timeout, query_options.trace_state);
+                for (auto& [rex, token_range] : exec) {
+                    rex->set_batcher(batcher);
+                }
+            }
+            // All executors send their initial requests before the first one yields.
+            auto f = utils::result_map_reduce(exec.begin(), exec.end(), std::move(mapper), std::move(merger));
+            if (batcher) {
+                batcher->send();
+            }
+            result = co_await std::move(f);
         }
     } catch(...) {
         handle_read_error(std::current_exception(), false);
@@ -5546,7 +6153,7 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
                     used_replicas.emplace(std::move(r), replica_ids);
                 }
             }
-            return make_ready_future<::result<query_partition_key_range_concurrent_result>>(query_partition_key_range_concurrent_result{std::move(results), std::move(used_replicas)});
+            return make_ready_future<::result<query_partition_key_range_concurrent_result>>(query_partition_key_range_concurrent_result{std::move(results), std::move(used_replicas), uint32_t(concurrency_factor)});
         } else {
             cmd->set_row_limit(remaining_row_count);
             cmd->partition_limit = remaining_partition_count;
@@ -5573,10 +6180,15 @@ storage_proxy::query_partition_key_range(lw_shared_ptr<query::read_command> cmd,
     // (which can be expensive in clusters with vnodes)
     auto merge_tokens = !ks.get_replication_strategy().natural_endpoints_depend_on_token();
 
+    // The concurrency factor comes from the paging state, which is supplied by
+    // the client, so don't trust it to be sane. There are never more vnode
+    // ranges to read than tokens, plus one for each wrap-around.
+    const size_t max_concurrency_factor = erm->get_token_metadata().sorted_tokens().size() + partition_ranges.size();
+    int concurrency_factor = std::max<size_t>(1, std::min<size_t>(query_options.concurrency_factor, max_concurrency_factor));
+
     query_ranges_to_vnodes_generator ranges_to_vnodes(erm->get_token_metadata_ptr(), schema, std::move(partition_ranges), merge_tokens);
 
     int result_rows_per_range = 0;
-    int concurrency_factor = 1;
 
     std::vector<foreign_ptr<lw_shared_ptr<query::result>>> results;
 
@@ -5619,7 +6231,9 @@ storage_proxy::query_partition_key_range(lw_shared_ptr<query::read_command> cmd,
             merger(std::move(r));
         }
 
-        return make_ready_future<::result<coordinator_query_result>>(coordinator_query_result(merger.get(), std::move(used_replicas)));
+        coordinator_query_result ret(merger.get(), std::move(used_replicas));
+        ret.concurrency_factor = result.concurrency_factor;
+        return make_ready_future<::result<coordinator_query_result>>(std::move(ret));
     }));
 }
 
@@ -5925,6 +6539,24 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
                 // The majority (aka a QUORUM) has promised the coordinator to
                 // accept the action associated with the computed ballot.
                 // Apply the mutation.
+                if (handler->cl_for_learn() == db::consistency_level::ANY) {
+                    // The decision is chosen once a quorum accepted it, and with ANY the
+                    // client doesn't care how many replicas learn it before it is told,
+                    // so don't make it wait for another round trip. This is also the
+                    // case of the empty decision of a condition which is not met.
+                    // The handler holds the storage_proxy, so stop() waits for it.
+                    ++get_stats().cas_background_learn;
+                    (void)handler->learn_decision(std::move(proposal)).then_wrapped([handler] (future<> f) {
+                        try {
+                            f.get();
+                        } catch (...) {
+                            paxos::paxos_state::logger.debug("CAS[{}] background learn failed: {}", handler->id(), std::current_exception());
+                        }
+                    });
+                    paxos::paxos_state::logger.debug("CAS[{}] successful, learning the decision in the background", handler->id());
+                    tracing::trace(handler->tr_state, "CAS successful, learning the decision in the background");
+                    break;
+                }
                 try {
                   co_await handler->learn_decision(std::move(proposal));
                 } catch (unavailable_exception& e) {
@@ -5999,12 +6631,86 @@ void storage_proxy::sort_endpoints_by_proximity(const locator::topology& topo, i
     }
 }
 
+replica_latency_tracker::clock_type::duration storage_proxy::replica_latency_reset_interval() const {
+    return std::chrono::milliseconds(_db.local().get_config().dynamic_snitch_reset_interval_in_ms());
+}
+
+void storage_proxy::sort_endpoints_by_latency(const locator::topology& topo, inet_address_vector_replica_set& eps) const {
+    auto badness_threshold = _db.local().get_config().dynamic_snitch_badness_threshold();
+    if (badness_threshold < 0) {
+        return;
+    }
+    auto my_address = utils::fb_utilities::get_broadcast_address();
+    _replica_latencies.sort_by_score(eps, badness_threshold, replica_latency_reset_interval(), [&] (gms::inet_address a, gms::inet_address b) {
+        return topo.compare_endpoints(my_address, a, b) == 0;
+    });
+}
+
 inet_address_vector_replica_set storage_proxy::get_live_sorted_endpoints(const locator::effective_replication_map& erm, const dht::token& token) const {
     auto eps = get_live_endpoints(erm, token);
     sort_endpoints_by_proximity(erm.get_topology(), eps);
+    sort_endpoints_by_latency(erm.get_topology(), eps);
+    _replica_latencies.move_suspected_last(eps);
     return eps;
 }
 
+class storage_proxy::fast_failure_listener : public direct_failure_detector::listener {
+    storage_proxy& _sp;
+
+    void set_suspected(direct_failure_detector::pinger::endpoint_id id, bool suspected) {
+        // Raft server IDs are host IDs.
+        auto ep = _sp.get_token_metadata_ptr()->get_endpoint_for_host_id(locator::host_id(id));
+        if (!ep) {
+            return;
+        }
+        slogger.debug("{} replica {}", suspected ? "Suspecting" : "No longer suspecting", *ep);
+        _sp._replica_latencies.set_suspected(*ep, suspected);
+    }
+public:
+    explicit fast_failure_listener(storage_proxy& sp) : _sp(sp) {}
+
+    virtual future<> mark_alive(direct_failure_detector::pinger::endpoint_id id) override {
+        set_suspected(id, false);
+        return make_ready_future<>();
+    }
+
+    virtual future<> mark_dead(direct_failure_detector::pinger::endpoint_id id) override {
+        set_suspected(id, true);
+        return make_ready_future<>();
+    }
+};
+
+future<> storage_proxy::start_fast_failure_detection(direct_failure_detector::failure_detector& fd, direct_failure_detector::clock::interval_t threshold) {
+    if (!threshold) {
+        co_return;
+    }
+    _fast_failure_listener = std::make_unique<fast_failure_listener>(*this);
+    _fast_failure_subscription.emplace(co_await fd.register_listener(*_fast_failure_listener, threshold));
+    _direct_fd = &fd;
+}
+
+void storage_proxy::stop_fast_failure_detection() noexcept {
+    _direct_fd = nullptr;
+    _fast_failure_subscription.reset();
+}
+
+void storage_proxy::report_replica_failure(gms::inet_address ep) {
+    // A replica's requests tend to fail together, there's no point in
+    // bothering the failure detector again while it's still pinging the
+    // replica more often after the previous report.
+    static constexpr auto report_interval = std::chrono::milliseconds(500);
+
+    if (!_direct_fd || ep == utils::fb_utilities::get_broadcast_address()) {
+        return;
+    }
+    if (!_replica_latencies.should_report_failure(ep, report_interval)) {
+        return;
+    }
+    if (auto id = get_token_metadata_ptr()->get_host_id_if_known(ep)) {
+        _direct_fd->suspect(id->uuid());
+    }
+}
+
 bool storage_proxy::is_alive(const gms::inet_address& ep) const {
     return _remote->is_alive(ep);
 }
@@ -6222,6 +6928,7 @@ void storage_proxy::on_join_cluster(const gms::inet_address& endpoint) {};
 void storage_proxy::on_leave_cluster(const gms::inet_address& endpoint) {
     _hints_manager.drain_for(endpoint);
     _hints_for_views_manager.drain_for(endpoint);
+    _replica_latencies.forget(endpoint);
 }
 
 void storage_proxy::on_up(const gms::inet_address& endpoint) {};
@@ -6254,6 +6961,9 @@ future<> storage_proxy::drain_on_shutdown() {
     // and writing them down with plain futures is error-prone.
     return async([this] {
         retire_view_response_handlers([] (const abstract_write_response_handler&) { return true; });
+        // Background repairs are best-effort, don't hold shutdown for the queued ones.
+        _background_read_repairs.clear();
+        _background_read_repair_gate.close().get();
         _hints_resource_manager.stop().get();
     });
 }
@@ -30,12 +30,16 @@
 #include "db/hints/host_filter.hh"
 #include "utils/small_vector.hh"
 #include "service/endpoint_lifecycle_subscriber.hh"
+#include "service/replica_latency_tracker.hh"
+#include "service/read_repair_queue.hh"
 #include <seastar/core/circular_buffer.hh>
+#include <seastar/core/gate.hh>
 #include "exceptions/exceptions.hh"
 #include "exceptions/coordinator_result.hh"
 #include "replica/exceptions.hh"
 #include "locator/host_id.hh"
 #include "dht/token_range_endpoints.hh"
+#include "direct_failure_detector/failure_detector.hh"
 
 class reconcilable_result;
 class frozen_mutation_and_schema;
@@ -77,6 +81,7 @@ namespace paxos {
 class abstract_write_response_handler;
 class paxos_response_handler;
 class abstract_read_executor;
+class read_data_batcher;
 class mutation_holder;
 class view_update_write_response_handler;
 class client_state;
@@ -89,6 +94,8 @@ using replicas_per_token_range = std::unordered_map<dht::token_range, std::vecto
 struct query_partition_key_range_concurrent_result {
     std::vector<foreign_ptr<lw_shared_ptr<query::result>>> result;
     replicas_per_token_range replicas;
+    // The number of vnode ranges read concurrently by the last round.
+    uint32_t concurrency_factor = 1;
 };
 
 struct view_update_backlog_timestamped {
@@ -103,6 +110,9 @@ struct storage_proxy_coordinator_query_result {
     foreign_ptr<lw_shared_ptr<query::result>> query_result;
     replicas_per_token_range last_replicas;
     db::read_repair_decision read_repair_decision;
+    // Set by partition range scans, for the next page to start at, see
+    // paging_state::get_concurrency_factor(). 0 if not applicable.
+    uint32_t concurrency_factor = 0;
 
     storage_proxy_coordinator_query_result(foreign_ptr<lw_shared_ptr<query::result>> query_result,
             replicas_per_token_range last_replicas = {},
@@ -137,6 +147,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
         // they need a separate smp_service_group to prevent an ABBA deadlock
         // with writes.
         smp_service_group write_ack_smp_service_group = default_smp_service_group();
+        // Background read repairs are written in this group, to limit their impact on
+        // the foreground workload.
+        scheduling_group background_read_repair_scheduling_group = default_scheduling_group();
     };
 private:
 
@@ -173,19 +186,23 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
         tracing::trace_state_ptr trace_state = nullptr;
         replicas_per_token_range preferred_replicas;
         std::optional<db::read_repair_decision> read_repair_decision;
+        // Initial concurrency of partition range scans, 0 to ramp it up from 1.
+        uint32_t concurrency_factor;
 
         coordinator_query_options(clock_type::time_point timeout,
                 service_permit permit_,
                 client_state& client_state_,
                 tracing::trace_state_ptr trace_state = nullptr,
                 replicas_per_token_range preferred_replicas = { },
-                std::optional<db::read_repair_decision> read_repair_decision = { })
+                std::optional<db::read_repair_decision> read_repair_decision = { },
+                uint32_t concurrency_factor = 0)
             : _timeout(timeout)
             , permit(std::move(permit_))
             , cstate(client_state_)
             , trace_state(std::move(trace_state))
             , preferred_replicas(std::move(preferred_replicas))
-            , read_repair_decision(read_repair_decision) {
+            , read_repair_decision(read_repair_decision)
+            , concurrency_factor(concurrency_factor) {
         }
 
         clock_type::time_point timeout(storage_proxy& sp) const {
@@ -269,6 +286,17 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             bool,
             db::allow_per_partition_rate_limit,
             lw_shared_ptr<cdc::operation_result_tracker>> _mutate_stage;
+    replica_latency_tracker _replica_latencies;
+    // Marks the replicas which don't answer the direct failure detector's
+    // pings as suspected in _replica_latencies.
+    class fast_failure_listener;
+    std::unique_ptr<fast_failure_listener> _fast_failure_listener;
+    std::optional<direct_failure_detector::subscription> _fast_failure_subscription;
+    direct_failure_detector::failure_detector* _direct_fd = nullptr;
+    scheduling_group _background_read_repair_scheduling_group;
+    read_repair_queue _background_read_repairs;
+    bool _flushing_background_read_repairs = false;
+    seastar::gate _background_read_repair_gate;
     db::view::node_update_backlog& _max_view_update_backlog;
     std::unordered_map<gms::inet_address, view_update_backlog_timestamped> _view_update_backlogs;
 
@@ -327,6 +355,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     bool hints_enabled(db::write_type type) const noexcept;
     db::hints::manager& hints_manager_for(db::write_type type);
     void sort_endpoints_by_proximity(const locator::topology& topo, inet_address_vector_replica_set& eps) const;
+    // Orders equally close endpoints by how fast they respond (see replica_latency_tracker).
+    void sort_endpoints_by_latency(const locator::topology& topo, inet_address_vector_replica_set& eps) const;
     inet_address_vector_replica_set get_live_sorted_endpoints(const locator::effective_replication_map& erm, const dht::token& token) const;
     bool is_alive(const gms::inet_address&) const;
     db::read_repair_decision new_read_repair_decision(const schema& s);
@@ -345,6 +375,11 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
                                                                            tracing::trace_state_ptr trace_state,
                                                                            clock_type::time_point timeout,
                                                                            db::per_partition_rate_limit::info rate_limit_info);
+    // Queries each of the singular partition ranges separately, as query_result_local() would.
+    future<rpc::tuple<std::vector<query::result>, cache_temperature>> query_result_local_multi(schema_ptr, lw_shared_ptr<query::read_command> cmd, const dht::partition_range_vector& prs,
+                                                                                              query::result_options opts,
+                                                                                              tracing::trace_state_ptr trace_state,
+                                                                                              clock_type::time_point timeout);
     future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> query_result_local_digest(
             schema_ptr,
             lw_shared_ptr<query::read_command> cmd,
@@ -388,6 +423,11 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     future<result<>> mutate_begin(unique_response_handler_vector ids, db::consistency_level cl, tracing::trace_state_ptr trace_state, std::optional<clock_type::time_point> timeout_opt = { });
     future<result<>> mutate_end(future<result<>> mutate_result, utils::latency_counter, write_stats& stats, tracing::trace_state_ptr trace_state);
     future<result<>> schedule_repair(locator::effective_replication_map_ptr ermp, std::unordered_map<dht::token, std::unordered_map<gms::inet_address, std::optional<mutation>>> diffs, db::consistency_level cl, tracing::trace_state_ptr trace_state, service_permit permit);
+    // Like schedule_repair(), but for repairs nobody waits for: the repairs are queued and
+    // written in batches by flush_background_repairs(), so the returned future is ready
+    // right away (unless the queue is disabled).
+    future<result<>> queue_background_repair(locator::effective_replication_map_ptr ermp, std::unordered_map<dht::token, std::unordered_map<gms::inet_address, std::optional<mutation>>> diffs, db::consistency_level cl, tracing::trace_state_ptr trace_state, service_permit permit);
+    future<> flush_background_repairs();
     bool need_throttle_writes() const;
     void unthrottle();
     void handle_read_error(std::variant<exceptions::coordinator_exception_container, std::exception_ptr> failure, bool range);
@@ -422,8 +462,6 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
 
     void maybe_update_view_backlog_of(gms::inet_address, std::optional<db::view::update_backlog>);
 
-    db::view::update_backlog get_backlog_of(gms::inet_address) const;
-
     template<typename Range>
     future<> mutate_counters(Range&& mutations, db::consistency_level cl, tracing::trace_state_ptr tr_state, service_permit permit, clock_type::time_point timeout);
 
@@ -577,6 +615,15 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     // and use different RPC verb.
     future<> send_hint_to_endpoint(frozen_mutation_and_schema fm_a_s, gms::inet_address target);
 
+    // Stores a view update as a hint to each of the targets, to be delivered
+    // by the hints manager for views. Returns the targets it couldn't be
+    // stored for.
+    inet_address_vector_topology_change hint_view_update(const frozen_mutation_and_schema& fm_a_s,
+            inet_address_vector_topology_change targets, tracing::trace_state_ptr tr_state);
+
+    // The view update backlog last reported by ep.
+    db::view::update_backlog get_backlog_of(gms::inet_address ep) const;
+
     /**
      * Performs the truncate operatoin, which effectively deletes all data from
      * the column family cfname
@@ -664,6 +711,29 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
         return _cdc_stats;
     }
 
+    replica_latency_tracker& get_replica_latencies() noexcept {
+        return _replica_latencies;
+    }
+
+    const replica_latency_tracker& get_replica_latencies() const noexcept {
+        return _replica_latencies;
+    }
+
+    // Latency samples older than this are ignored by replica_latency_tracker.
+    replica_latency_tracker::clock_type::duration replica_latency_reset_interval() const;
+
+    // Makes reads prefer other replicas over the ones which didn't answer the
+    // direct failure detector's pings for `threshold`, long before gossip
+    // marks them down. Does nothing if `threshold` is 0.
+    // Must be called on all shards before endpoints are added to the failure detector.
+    future<> start_fast_failure_detection(direct_failure_detector::failure_detector& fd, direct_failure_detector::clock::interval_t threshold);
+    void stop_fast_failure_detection() noexcept;
+
+    // Reports a sign of the replica failing, e.g. a failed or timed out
+    // request, or a dropped connection, so the failure detector pings it
+    // more often.
+    void report_replica_failure(gms::inet_address ep);
+
     scheduling_group_key get_stats_key() const {
         return _stats_key;
     }
@@ -676,6 +746,7 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     virtual void on_down(const gms::inet_address& endpoint) override;
 
     friend class abstract_read_executor;
+    friend class read_data_batcher;
     friend class abstract_write_response_handler;
     friend class speculating_read_executor;
     friend class view_update_backlog_broker;
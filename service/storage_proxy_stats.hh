@@ -110,6 +110,8 @@ struct write_stats {
     uint64_t cas_prune = 0;
     uint64_t cas_coordinator_dropped_prune = 0;
     uint64_t cas_replica_dropped_prune = 0;
+    // Paxos learns which the client doesn't wait for
+    uint64_t cas_background_learn = 0;
 
 
     std::chrono::microseconds last_mv_flow_control_delay; // delay added for MV flow control in the last request
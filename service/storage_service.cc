@@ -1204,6 +1204,9 @@ future<> storage_service::on_change(inet_address endpoint, application_state sta
             slogger.debug("Ignoring state change for dead or unknown endpoint: {}", endpoint);
             co_return;
         }
+        if (state == application_state::SHARD_COUNT || state == application_state::IGNORE_MSB_BITS) {
+            co_await update_peer_sharding(endpoint);
+        }
         if (get_token_metadata().is_normal_token_owner(endpoint)) {
             slogger.debug("endpoint={} on_change:     updating system.peers table", endpoint);
             co_await do_update_system_peers_table(endpoint, state, value);
@@ -1217,6 +1220,22 @@ future<> storage_service::on_change(inet_address endpoint, application_state sta
     }
 }
 
+future<> storage_service::update_peer_sharding(inet_address ep) {
+    auto shard_count = _gossiper.get_application_state_ptr(ep, application_state::SHARD_COUNT);
+    if (!shard_count) {
+        co_return;
+    }
+    auto ignore_msb = _gossiper.get_application_state_ptr(ep, application_state::IGNORE_MSB_BITS);
+    unsigned count = std::stoi(shard_count->value);
+    unsigned msb = ignore_msb ? std::stoi(ignore_msb->value) : 0;
+    if (!count) {
+        co_return;
+    }
+    co_await _messaging.invoke_on_all([ep, count, msb] (auto& local_ms) {
+        local_ms.set_peer_sharding(ep, count, msb);
+    });
+}
+
 future<> storage_service::maybe_reconnect_to_preferred_ip(inet_address ep, inet_address local_ip) {
     if (!_snitch.local()->prefer_local()) {
         co_return;
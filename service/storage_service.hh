@@ -590,6 +590,7 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
     future<std::unordered_multimap<dht::token_range, inet_address>> get_changed_ranges_for_leaving(locator::effective_replication_map_ptr erm, inet_address endpoint);
 
     future<> maybe_reconnect_to_preferred_ip(inet_address ep, inet_address local_ip);
+    future<> update_peer_sharding(inet_address ep);
 public:
 
     sstring get_release_version();
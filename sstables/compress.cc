@@ -14,6 +14,8 @@
 #include <seastar/core/bitops.hh>
 #include <seastar/core/byteorder.hh>
 #include <seastar/core/fstream.hh>
+#include <seastar/core/do_with.hh>
+#include <seastar/core/loop.hh>
 
 #include "../compress.hh"
 #include "compress.hh"
@@ -22,6 +24,7 @@
 #include "segmented_compress_params.hh"
 #include "utils/class_registrator.hh"
 #include "reader_permit.hh"
+#include "read_ahead.hh"
 
 namespace sstables {
 
@@ -298,7 +301,12 @@ void compression::set_compressor(compressor_ptr c) {
             if (p.first != compression_parameters::SSTABLE_COMPRESSION) {
                 auto& k = p.first;
                 auto& v = p.second;
-                options.elements.push_back({bytes(k.begin(), k.end()), bytes(v.begin(), v.end())});
+                // Options already set are kept, a compressor replacing the one
+                // set earlier (see with_dictionary()) only adds to them.
+                auto key = bytes(k.begin(), k.end());
+                if (std::none_of(options.elements.begin(), options.elements.end(), [&key] (const option& o) { return o.key.value == key; })) {
+                    options.elements.push_back({std::move(key), bytes(v.begin(), v.end())});
+                }
             }
         }
     }
@@ -346,7 +354,8 @@ class compressed_file_data_source_impl : public data_source_impl {
     uint64_t _end_pos;
 public:
     compressed_file_data_source_impl(file f, sstables::compression* cm,
-                uint64_t pos, size_t len, file_input_stream_options options, reader_permit permit)
+                uint64_t pos, size_t len, file_input_stream_options options, reader_permit permit,
+                lw_shared_ptr<sstables::data_read_stats> stats)
             : _compression_metadata(cm)
             , _offsets(_compression_metadata->offsets.get_accessor())
             , _compression(*cm)
@@ -371,10 +380,10 @@ class compressed_file_data_source_impl : public data_source_impl {
         // and open a file_input_stream to read that range.
         auto start = _compression_metadata->locate(_beg_pos, _offsets);
         auto end = _compression_metadata->locate(_end_pos - 1, _offsets);
-        _input_stream = make_file_input_stream(std::move(f),
+        _input_stream = sstables::make_adaptive_file_input_stream(std::move(f),
                 start.chunk_start,
                 end.chunk_start + end.chunk_len - start.chunk_start,
-                std::move(options));
+                std::move(options), std::move(stats));
         _underlying_pos = start.chunk_start;
         _pos = _beg_pos;
     }
@@ -449,9 +458,10 @@ requires ChecksumUtils<ChecksumType>
 class compressed_file_data_source : public data_source {
 public:
     compressed_file_data_source(file f, sstables::compression* cm,
-            uint64_t offset, size_t len, file_input_stream_options options, reader_permit permit)
+            uint64_t offset, size_t len, file_input_stream_options options, reader_permit permit,
+            lw_shared_ptr<sstables::data_read_stats> stats)
         : data_source(std::make_unique<compressed_file_data_source_impl<ChecksumType>>(
-                std::move(f), cm, offset, len, std::move(options), std::move(permit)))
+                std::move(f), cm, offset, len, std::move(options), std::move(permit), std::move(stats)))
         {}
 };
 
@@ -459,10 +469,10 @@ template <typename ChecksumType>
 requires ChecksumUtils<ChecksumType>
 inline input_stream<char> make_compressed_file_input_stream(
         file f, sstables::compression *cm, uint64_t offset, size_t len,
-        file_input_stream_options options, reader_permit permit)
+        file_input_stream_options options, reader_permit permit, lw_shared_ptr<sstables::data_read_stats> stats)
 {
     return input_stream<char>(compressed_file_data_source<ChecksumType>(
-            std::move(f), cm, offset, len, std::move(options), std::move(permit)));
+            std::move(f), cm, offset, len, std::move(options), std::move(permit), std::move(stats)));
 }
 
 // For SSTables 2.x (formats 'ka' and 'la'), the full checksum is a combination of checksums of compressed chunks.
@@ -485,6 +495,14 @@ class compressed_file_data_sink_impl : public data_sink_impl {
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
+    // Chunks held back until the compressor is given a chance to build
+    // a dictionary from them, see compressor::dictionary_sample_size().
+    std::vector<temporary_buffer<char>> _samples;
+    size_t _sampled = 0;
+    size_t _sample_size = 0;
+    // Chunks are compressed into this buffer, which is reused, as _out copies
+    // the data written to it. This saves a large allocation per chunk.
+    temporary_buffer<char> _compressed;
 public:
     compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
             : _out(std::move(out))
@@ -492,14 +510,55 @@ class compressed_file_data_sink_impl : public data_sink_impl {
             , _offsets(_compression_metadata->offsets.get_writer())
             , _compression(lc)
             , _full_checksum(ChecksumType::init_checksum())
+            , _sample_size(_compression ? _compression.compressor()->dictionary_sample_size() : 0)
     {}
 
     virtual future<> put(net::packet data) override { abort(); }
     virtual future<> put(temporary_buffer<char> buf) override {
+        if (_sampled < _sample_size) {
+            _sampled += buf.size();
+            _samples.push_back(std::move(buf));
+            if (_sampled < _sample_size) {
+                return make_ready_future<>();
+            }
+            return flush_samples();
+        }
+        return put_chunk(std::move(buf));
+    }
+    virtual future<> close() override {
+        return flush_samples().then([this] {
+            return _out.close();
+        });
+    }
+
+    virtual size_t buffer_size() const noexcept override {
+        return _compression_metadata->uncompressed_chunk_length();
+    }
+private:
+    future<> flush_samples() {
+        if (!std::exchange(_sample_size, 0)) {
+            return make_ready_future<>();
+        }
+        // Nothing was written yet, so all chunks can be compressed with the dictionary.
+        if (auto c = _compression.compressor()->with_dictionary(_samples)) {
+            _compression_metadata->set_compressor(c);
+            _compression = sstables::local_compression(std::move(c));
+        }
+        return do_with(std::exchange(_samples, {}), [this] (std::vector<temporary_buffer<char>>& samples) {
+            return do_for_each(samples, [this] (temporary_buffer<char>& buf) {
+                return put_chunk(std::move(buf));
+            });
+        });
+    }
+
+    future<> put_chunk(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
-        temporary_buffer<char> compressed(output_len + 4);
+        if (_compressed.size() < output_len + 4) {
+            _compressed = temporary_buffer<char>(output_len + 4);
+        }
+        auto& compressed = _compressed;
 
         // compress flushed data.
         auto len = _compression.compress(buf.get(), buf.size(), compressed.get_write(), output_len);
@@ -530,17 +589,7 @@ class compressed_file_data_sink_impl : public data_sink_impl {
 
         _compression_metadata->set_full_checksum(_full_checksum);
 
-        compressed.trim(len + 4);
-
-        auto f = _out.write(compressed.get(), compressed.size());
-        return f.then([compressed = std::move(compressed)] {});
-    }
-    virtual future<> close() override {
-        return _out.close();
-    }
-
-    virtual size_t buffer_size() const noexcept override {
-        return _compression_metadata->uncompressed_chunk_length();
+        return _out.write(compressed.get(), len + 4);
     }
 };
 
@@ -574,15 +623,15 @@ inline output_stream<char> make_compressed_file_output_stream(output_stream<char
 
 input_stream<char> sstables::make_compressed_file_k_l_format_input_stream(file f,
         sstables::compression* cm, uint64_t offset, size_t len,
-        class file_input_stream_options options, reader_permit permit)
+        class file_input_stream_options options, reader_permit permit, lw_shared_ptr<data_read_stats> stats)
 {
-    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options), std::move(permit));
+    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options), std::move(permit), std::move(stats));
 }
 
 input_stream<char> sstables::make_compressed_file_m_format_input_stream(file f,
         sstables::compression *cm, uint64_t offset, size_t len,
-        class file_input_stream_options options, reader_permit permit) {
-    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options), std::move(permit));
+        class file_input_stream_options options, reader_permit permit, lw_shared_ptr<data_read_stats> stats) {
+    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options), std::move(permit), std::move(stats));
 }
 
 output_stream<char> sstables::make_compressed_file_m_format_output_stream(output_stream<char> out,
@@ -44,6 +44,7 @@
 
 #include "types.hh"
 #include "sstables/types.hh"
+#include "sstables/read_ahead.hh"
 #include "checksum_utils.hh"
 #include "../compress.hh"
 
@@ -371,13 +372,17 @@ compressor_ptr get_sstable_compressor(const compression&);
 // are open streams on it. This should happen naturally on a higher level -
 // as long as we have *sstables* work in progress, we need to keep the whole
 // sstable alive, and the compression metadata is only a part of it.
+//
+// The compressed chunks are read with make_adaptive_file_input_stream().
 input_stream<char> make_compressed_file_k_l_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options, reader_permit permit);
+                class file_input_stream_options options, reader_permit permit,
+                lw_shared_ptr<data_read_stats> stats = {});
 
 input_stream<char> make_compressed_file_m_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options, reader_permit permit);
+                class file_input_stream_options options, reader_permit permit,
+                lw_shared_ptr<data_read_stats> stats = {});
 
 output_stream<char> make_compressed_file_m_format_output_stream(output_stream<char> out,
                 sstables::compression* cm,
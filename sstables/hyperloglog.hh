@@ -76,6 +76,19 @@ static inline size_t size_unsigned_var_int(unsigned int value) {
     return size;
 }
 
+// Returns false if the buffer ends before the value.
+static inline bool read_unsigned_var_int(unsigned int& value, const uint8_t*& from, const uint8_t* end) {
+    value = 0;
+    for (unsigned shift = 0; from != end && shift < 32; shift += 7) {
+        auto b = *from++;
+        value |= unsigned(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static inline size_t write_unsigned_var_int(unsigned int value, uint8_t* to) {
     size_t size = 0;
     while ((value & 0xFFFFFF80) != 0L) {
@@ -128,11 +141,33 @@ class HyperLogLog {
         alphaMM_ = alpha * m_ * m_;
     }
 
-    static HyperLogLog from_bytes(temporary_buffer<uint8_t> bytes) {
-        // FIXME: implement class that creates a HyperLogLog from an array of bytes.
-        // This will useful if we need to work with the cardinality data from the
-        // compaction metadata.
-        abort();
+    /**
+     * Creates a HyperLogLog from the serialized form written by get_bytes(),
+     * e.g. the cardinality of the compaction metadata of an sstable.
+     *
+     * @exception std::invalid_argument the bytes are malformed, or hold the
+     *            sparse format, which isn't supported.
+     */
+    static HyperLogLog from_bytes(const uint8_t* bytes, size_t size) {
+        auto end = bytes + size;
+        if (size < sizeof(int32_t) || read_be<int32_t>(reinterpret_cast<const char*>(bytes)) != -2) {
+            throw std::invalid_argument("unsupported cardinality version");
+        }
+        bytes += sizeof(int32_t);
+        unsigned p, sp, type, register_size;
+        if (!read_unsigned_var_int(p, bytes, end) || !read_unsigned_var_int(sp, bytes, end)
+                || !read_unsigned_var_int(type, bytes, end) || !read_unsigned_var_int(register_size, bytes, end)) {
+            throw std::invalid_argument("truncated cardinality");
+        }
+        if (type != 0) {
+            throw std::invalid_argument("sparse cardinality format is not supported");
+        }
+        if (p < 4 || p > 16 || register_size != (1u << p) || size_t(end - bytes) < register_size) {
+            throw std::invalid_argument("malformed cardinality registers");
+        }
+        HyperLogLog ret(p);
+        std::copy_n(bytes, register_size, ret.M_.begin());
+        return ret;
     }
 
     /**
@@ -164,7 +199,7 @@ class HyperLogLog {
     /*
      * Calculate the size of buffer returned by get_bytes().
      */
-    size_t get_bytes_size() {
+    size_t get_bytes_size() const {
         size_t size = 0;
         size += sizeof(int); // version
         size += size_unsigned_var_int(b_); // p; register width = b_.
@@ -175,7 +210,7 @@ class HyperLogLog {
         return size;
     }
 
-    temporary_buffer<uint8_t> get_bytes() {
+    temporary_buffer<uint8_t> get_bytes() const {
         // FIXME: add support to SPARSE format.
         static constexpr int version = 2;
 
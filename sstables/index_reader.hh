@@ -335,7 +335,8 @@ std::unique_ptr<clustered_index_cursor> promoted_index::make_cursor(shared_sstab
         return std::make_unique<mc::bsearch_clustered_cursor>(*sst->get_schema(),
             _promoted_index_start, _promoted_index_size,
             promoted_index_cache_metrics, permit,
-            *ck_values_fixed_lengths, cached_file_ptr, options.io_priority_class, _num_blocks, trace_state);
+            *ck_values_fixed_lengths, cached_file_ptr, options.io_priority_class, _num_blocks, trace_state,
+            caching ? sst->_promoted_index_cache.get() : nullptr);
     }
 
     auto file = make_tracked_index_file(*sst, permit, std::move(trace_state), caching);
@@ -504,8 +505,8 @@ class index_reader {
         auto loader = [this, &bound] (uint64_t summary_idx) -> future<index_list> {
             auto& summary = _sstable->get_summary();
             uint64_t position = summary.entries[summary_idx].position;
-            uint64_t quantity = downsampling::get_effective_index_interval_after_index(summary_idx, summary.header.sampling_level,
-                summary.header.min_index_interval);
+            uint64_t quantity = downsampling::get_effective_index_interval_after_index(summary_idx * summary.page_factor,
+                summary.header.sampling_level, summary.header.min_index_interval) * summary.page_factor;
 
             uint64_t end;
             if (summary_idx + 1 >= summary.header.size) {
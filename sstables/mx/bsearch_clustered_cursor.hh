@@ -11,6 +11,7 @@
 #include "sstables/index_entry.hh"
 #include "sstables/column_translation.hh"
 #include "sstables/promoted_index_blocks_reader.hh"
+#include "sstables/mx/promoted_index_cache.hh"
 #include "parsers.hh"
 #include "schema.hh"
 #include "utils/cached_file.hh"
@@ -168,6 +169,10 @@ class cached_promoted_index {
     reader_permit _permit;
     cached_file::stream _stream;
     logalloc::allocating_section _as;
+    // Shared with other readers of the sstable, can be nullptr.
+    promoted_index_cache* _shared_cache;
+    // Some block starts were parsed since they were last shared.
+    bool _unshared_starts = false;
 private:
     // Feeds the stream into the consumer until the consumer is satisfied.
     // Does not give unconsumed data back to the stream.
@@ -216,6 +221,7 @@ class cached_promoted_index {
             auto mem_before = block.memory_usage();
             block.start.emplace(_clustering_parser.get_and_reset());
             _metrics.used_bytes += block.memory_usage() - mem_before;
+            _unshared_starts = true;
         });
     }
 
@@ -232,6 +238,7 @@ class cached_promoted_index {
             block.data_file_offset = _block_parser.offset();
             block.width = _block_parser.width();
             _metrics.used_bytes += block.memory_usage() - mem_before;
+            _unshared_starts = true;
         });
     }
 
@@ -242,16 +249,28 @@ class cached_promoted_index {
             ++_metrics.hits_l0;
             return make_ready_future<promoted_index_block*>(const_cast<promoted_index_block*>(&*i));
         }
+        if (auto shared = _shared_cache ? _shared_cache->find(_promoted_index_start, idx) : std::nullopt) {
+            ++_metrics.hits_l0;
+            auto block = emplace_block(i, idx, shared->offset);
+            auto mem_before = block->memory_usage();
+            block->start.emplace(std::move(shared->start));
+            _metrics.used_bytes += block->memory_usage() - mem_before;
+            return make_ready_future<promoted_index_block*>(block);
+        }
         ++_metrics.misses_l0;
         return read_block_offset(idx, trace_state).then([this, idx, hint = i] (pi_offset_type offset) {
-            auto i = this->_blocks.emplace_hint(hint, idx, offset);
-            _metrics.used_bytes += sizeof(promoted_index_block);
-            ++_metrics.block_count;
-            ++_metrics.populations;
-            return const_cast<promoted_index_block*>(&*i);
+            return emplace_block(hint, idx, offset);
         });
     }
 
+    promoted_index_block* emplace_block(block_set_type::iterator hint, pi_index_type idx, pi_offset_type offset) {
+        auto i = _blocks.emplace_hint(hint, idx, offset);
+        _metrics.used_bytes += sizeof(promoted_index_block);
+        ++_metrics.block_count;
+        ++_metrics.populations;
+        return const_cast<promoted_index_block*>(&*i);
+    }
+
     void erase_range(block_set_type::iterator begin, block_set_type::iterator end) {
         while (begin != end) {
             --_metrics.block_count;
@@ -269,7 +288,8 @@ class cached_promoted_index {
             column_values_fixed_lengths cvfl,
             cached_file& f,
             io_priority_class pc,
-            pi_index_type blocks_count)
+            pi_index_type blocks_count,
+            promoted_index_cache* shared_cache = nullptr)
         : _blocks(block_comparator{s})
         , _s(s)
         , _promoted_index_start(promoted_index_start)
@@ -282,6 +302,7 @@ class cached_promoted_index {
         , _clustering_parser(s, permit, cvfl, true)
         , _block_parser(s, permit, std::move(cvfl))
         , _permit(std::move(permit))
+        , _shared_cache(shared_cache)
     { }
 
     ~cached_promoted_index() {
@@ -340,6 +361,25 @@ class cached_promoted_index {
         return make_ready_future<std::optional<uint64_t>>(block.data_file_offset);
     }
 
+    // Makes the block starts parsed so far available to other readers of the partition.
+    // Sharing is best-effort, so allocation failures are ignored.
+    void share_block_starts() noexcept {
+        if (!_shared_cache || !std::exchange(_unshared_starts, false)) {
+            return;
+        }
+        try {
+            std::vector<promoted_index_cache::block_start> starts;
+            for (auto&& b : _blocks) {
+                if (b.start) {
+                    starts.push_back({b.index, b.offset, *b.start});
+                }
+            }
+            _shared_cache->insert(_promoted_index_start, starts);
+        } catch (...) {
+            sstlog.debug("Failed to share promoted index blocks: {}", std::current_exception());
+        }
+    }
+
     // Invalidates information about blocks with smaller indexes than a given block.
     void invalidate_prior(promoted_index_block* block, tracing::trace_state_ptr trace_state) {
         erase_range(_blocks.begin(), _blocks.lower_bound(block->index));
@@ -359,6 +399,11 @@ class cached_promoted_index {
 ///
 /// N = number of index entries
 ///
+/// Once positioned, the cursor searches forward from its current block with
+/// an exponential search, so a lookup costs O(log(D)), D being the number of
+/// blocks skipped. Walking a partition with many clustering ranges hence costs
+/// O(R * log(N / R)) rather than O(R * log(N)), R being the number of ranges.
+///
 class bsearch_clustered_cursor : public clustered_index_cursor {
     using pi_offset_type = cached_promoted_index::pi_offset_type;
     using pi_index_type = cached_promoted_index::pi_index_type;
@@ -374,6 +419,8 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
 
     // Used internally by advance_to_upper_bound() to avoid allocating state.
     pi_index_type _upper_idx;
+    pi_index_type _gallop_step;
+    bool _galloping;
 
     // Points to the upper bound of the cursor.
     std::optional<position_in_partition> _current_pos;
@@ -382,11 +429,12 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
 private:
     // Advances the cursor to the nearest block whose start position is > pos.
     //
-    // upper_idx should be the index of the block which is known to have start position > pos.
-    // upper_idx can be set to _blocks_count if no such entry is known.
+    // When gallop is true, the upper bound is first looked for close to the
+    // current block, probing blocks at exponentially growing distances from it,
+    // then bisected between the last two probes.
     //
     // Async calls must be serialized.
-    future<> advance_to_upper_bound(position_in_partition_view pos) {
+    future<> advance_to_upper_bound(position_in_partition_view pos, bool gallop) {
         // Binary search over blocks.
         //
         // Post conditions:
@@ -406,13 +454,35 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
         // Eventually _current_idx will reach _upper_idx.
 
         _upper_idx = _blocks_count;
+        _gallop_step = 1;
+        _galloping = gallop;
         return repeat([this, pos] {
+            if (_galloping && _current_idx < _upper_idx) {
+                auto probe = std::min<pi_index_type>(_current_idx + _gallop_step - 1, _upper_idx - 1);
+                _gallop_step *= 2;
+                if (probe == _upper_idx - 1) {
+                    _galloping = false;
+                }
+                sstlog.trace("mc_bsearch_clustered_cursor {}: galloping from [{}], probe={}", fmt::ptr(this), _current_idx, probe);
+                return _promoted_index.get_block_with_start(probe, _trace_state).then([this, probe, pos] (promoted_index_block* block) {
+                    position_in_partition::less_compare less(_s);
+                    if (less(pos, *block->start)) {
+                        _current_pos = *block->start;
+                        _upper_idx = probe;
+                        _galloping = false;
+                    } else {
+                        _current_idx = probe + 1;
+                    }
+                    return stop_iteration::no;
+                });
+            }
             if (_current_idx >= _upper_idx) {
                 if (_current_idx == _blocks_count) {
                     _current_pos = position_in_partition::after_all_clustered_rows();
                 }
                 tracing::trace(_trace_state, "mc_bsearch_clustered_cursor: bisecting done, current=[{}] .start={}", _current_idx, _current_pos);
                 sstlog.trace("mc_bsearch_clustered_cursor {}: bisecting done, current=[{}] .start={}", fmt::ptr(this), _current_idx, _current_pos);
+                _promoted_index.share_block_starts();
                 return make_ready_future<stop_iteration>(stop_iteration::yes);
             }
 
@@ -444,7 +514,8 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             seastar::shared_ptr<cached_file> f,
             io_priority_class pc,
             pi_index_type blocks_count,
-            tracing::trace_state_ptr trace_state)
+            tracing::trace_state_ptr trace_state,
+            promoted_index_cache* shared_cache = nullptr)
         : _s(s)
         , _blocks_count(blocks_count)
         , _cached_file(std::move(f))
@@ -456,7 +527,8 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             std::move(cvfl),
             *_cached_file,
             pc,
-            blocks_count)
+            blocks_count,
+            shared_cache)
         , _trace_state(std::move(trace_state))
     { }
 
@@ -466,6 +538,9 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
         sstlog.trace("mc_bsearch_clustered_cursor {}: advance_to({}), _current_pos={}, _current_idx={}, cached={}",
             fmt::ptr(this), pos, _current_pos, _current_idx, _promoted_index.file().cached_bytes());
 
+        // Gallop only once positioned, so that the first lookup in the
+        // partition doesn't cost more than a plain binary search.
+        const bool gallop = bool(_current_pos);
         if (_current_pos) {
             if (less(pos, *_current_pos)) {
                 sstlog.trace("mc_bsearch_clustered_cursor {}: same block", fmt::ptr(this));
@@ -474,7 +549,7 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             ++_current_idx;
         }
 
-        return advance_to_upper_bound(pos).then([this] {
+        return advance_to_upper_bound(pos, gallop).then([this] {
             if (_current_idx == 0) {
                 sstlog.trace("mc_bsearch_clustered_cursor {}: same block", fmt::ptr(this));
                 return make_ready_future<std::optional<skip_info>>(std::nullopt);
@@ -532,7 +607,7 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
     // If the block existed and advancing was successful (i.e. we weren't already at this block),
     // returns `skip_info` describing this block. Otherwise returns nullopt.
     future<std::optional<skip_info>> advance_past(position_in_partition_view pos) {
-        return advance_to_upper_bound(pos).then([this] {
+        return advance_to_upper_bound(pos, bool(_current_pos)).then([this] {
             if (_current_idx == _blocks_count) {
                 return make_ready_future<std::optional<skip_info>>(std::nullopt);
             }
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+
+#include "position_in_partition.hh"
+#include "utils/bptree.hh"
+#include "utils/logalloc.hh"
+#include "utils/lru.hh"
+#include "utils/managed_vector.hh"
+
+namespace sstables::mc {
+
+// Associative cache of promoted index position -> starts of promoted index blocks,
+// for the partitions of a single sstable, shared by all its readers on this shard.
+//
+// Clustering positions are located by binary search over the blocks of the
+// promoted index of a partition, so readers of the same partition parse the
+// starts of the same blocks, at least on the first levels of the search.
+// The starts are kept here once parsed, so that readers which open later on
+// a hot partition find them without reading and parsing them again.
+//
+// Entries are allocated in LSA and linked in the LRU of the cache_tracker.
+// Lookups copy the data out, so no entry is referenced outside the cache.
+class promoted_index_cache {
+public:
+    // Position of the promoted index of a partition in the index file.
+    using key_type = uint64_t;
+    using pi_index_type = uint32_t;
+    using pi_offset_type = uint32_t;
+
+    struct block_start {
+        pi_index_type index;
+        pi_offset_type offset;
+        position_in_partition start;
+
+        size_t external_memory_usage() const {
+            return start.external_memory_usage();
+        }
+    };
+
+    // Bounds the memory of a single partition.
+    static constexpr size_t max_blocks_per_partition = 64;
+private:
+    // Allocated inside LSA
+    class entry : public evictable {
+    public:
+        promoted_index_cache* _parent;
+        key_type _key;
+        // Sorted by index.
+        managed_vector<block_start> _blocks;
+        size_t _size_in_allocator = sizeof(entry);
+    public:
+        entry(promoted_index_cache* parent, key_type key)
+                : _parent(parent)
+                , _key(key)
+        { }
+
+        entry(entry&&) noexcept = default;
+
+        void on_evicted() noexcept override;
+
+        size_t size_in_allocator() const { return _size_in_allocator; }
+        key_type key() const { return _key; }
+    };
+public:
+    static thread_local struct stats {
+        uint64_t hits = 0; // Number of block starts found in the cache
+        uint64_t populations = 0; // Number of block starts inserted
+        uint64_t evictions = 0; // Number of partitions evicted
+        uint64_t used_bytes = 0; // Number of bytes entries occupy in memory
+    } _shard_stats;
+
+    struct key_less_comparator {
+        bool operator()(key_type lhs, key_type rhs) const noexcept {
+            return lhs < rhs;
+        }
+    };
+private:
+    using cache_type = bplus::tree<key_type, entry, key_less_comparator, 8, bplus::key_search::linear>;
+    cache_type _cache;
+    logalloc::region& _region;
+    logalloc::allocating_section _as;
+    lru& _lru;
+
+    static auto block_less() {
+        return [] (const block_start& b, pi_index_type idx) { return b.index < idx; };
+    }
+public:
+    promoted_index_cache(lru& lru_, logalloc::region& r)
+            : _cache(key_less_comparator())
+            , _region(r)
+            , _lru(lru_)
+    { }
+
+    ~promoted_index_cache() {
+        with_allocator(_region.allocator(), [&] {
+            _cache.clear_and_dispose([this] (entry* e) noexcept {
+                _lru.remove(*e);
+                on_evicted(*e);
+            });
+        });
+    }
+
+    promoted_index_cache(promoted_index_cache&&) = delete;
+    promoted_index_cache(const promoted_index_cache&) = delete;
+
+    // Returns a copy of the start of block idx of the promoted index at key, if cached.
+    std::optional<block_start> find(key_type key, pi_index_type idx) {
+        return _as(_region, [&] () -> std::optional<block_start> {
+            auto i = _cache.lower_bound(key);
+            if (i == _cache.end() || i->_key != key) {
+                return std::nullopt;
+            }
+            auto& blocks = i->_blocks;
+            auto b = std::lower_bound(blocks.begin(), blocks.end(), idx, block_less());
+            if (b == blocks.end() || b->index != idx) {
+                return std::nullopt;
+            }
+            _lru.touch(*i);
+            ++_shard_stats.hits;
+            return block_start{b->index, b->offset, b->start};
+        });
+    }
+
+    // Adds the given block starts, sorted by index, to those cached for the
+    // promoted index at key, up to max_blocks_per_partition.
+    void insert(key_type key, const std::vector<block_start>& new_blocks) {
+        if (new_blocks.empty()) {
+            return;
+        }
+        _as(_region, [&] {
+            with_allocator(_region.allocator(), [&] {
+                auto i = _cache.lower_bound(key);
+                if (i == _cache.end() || i->_key != key) {
+                    i = _cache.emplace(key, this, key).first;
+                    _lru.add(*i);
+                    _shard_stats.used_bytes += i->size_in_allocator();
+                }
+                entry& e = *i;
+                _lru.touch(e);
+
+                // Merge into a copy, so that the entry stays intact if an allocation fails.
+                managed_vector<block_start> merged;
+                merged.reserve(std::min(e._blocks.size() + new_blocks.size(), max_blocks_per_partition));
+                size_t size = sizeof(entry);
+                size_t added = 0;
+                auto old_it = e._blocks.begin();
+                auto new_it = new_blocks.begin();
+                while (merged.size() < max_blocks_per_partition && (old_it != e._blocks.end() || new_it != new_blocks.end())) {
+                    const block_start* b;
+                    if (new_it == new_blocks.end() || (old_it != e._blocks.end() && old_it->index <= new_it->index)) {
+                        if (new_it != new_blocks.end() && old_it->index == new_it->index) {
+                            ++new_it;
+                        }
+                        b = &*old_it++;
+                    } else {
+                        b = &*new_it++;
+                        ++added;
+                    }
+                    merged.push_back(block_start{b->index, b->offset, b->start});
+                    size += sizeof(block_start) + b->external_memory_usage();
+                }
+                e._blocks = std::move(merged);
+                _shard_stats.used_bytes += size - e._size_in_allocator;
+                _shard_stats.populations += added;
+                e._size_in_allocator = size;
+            });
+        });
+    }
+
+    void on_evicted(entry& e) {
+        _shard_stats.used_bytes -= e.size_in_allocator();
+        ++_shard_stats.evictions;
+    }
+
+    static const stats& shard_stats() { return _shard_stats; }
+
+    // Evicts all entries.
+    future<> evict_gently() {
+        auto i = _cache.begin();
+        while (i != _cache.end()) {
+            with_allocator(_region.allocator(), [&] {
+                _lru.remove(*i);
+                on_evicted(*i);
+                i = i.erase(key_less_comparator());
+            });
+            if (need_preempt() && i != _cache.end()) {
+                auto key = i->key();
+                co_await coroutine::maybe_yield();
+                i = _cache.lower_bound(key);
+            }
+        }
+    }
+};
+
+inline
+void promoted_index_cache::entry::on_evicted() noexcept {
+    _parent->on_evicted(*this);
+    cache_type::iterator it(this);
+    it.erase(key_less_comparator());
+}
+
+}
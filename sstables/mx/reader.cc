@@ -389,6 +389,13 @@ class mp_row_consumer_m {
         return mp_row_consumer_m::row_processing_result::do_proceed;
     }
 
+    // Tells whether consume_column() and consume_counter_column() use the
+    // value of a cell written at the given timestamp. Cells of columns which
+    // are missing from the current schema or were dropped since are discarded.
+    bool is_cell_value_needed(const column_translation::column_info& column_info, api::timestamp_type timestamp) const {
+        return column_info.id && timestamp > get_column_definition(column_info.id).dropped_at();
+    }
+
     proceed consume_column(const column_translation::column_info& column_info,
                                    bytes_view cell_path,
                                    fragmented_temporary_buffer::view value,
@@ -1085,6 +1092,19 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
             }
             if (!_column_flags.has_value()) {
                 _column_value = fragmented_temporary_buffer();
+            } else if (!_consumer.is_cell_value_needed(get_column_info(), _column_timestamp)) {
+                // Jump over the value instead of gathering it, possibly from
+                // several buffers.
+                _column_value = fragmented_temporary_buffer();
+                if (auto len = get_column_value_length()) {
+                    _u64 = *len;
+                } else {
+                    co_yield read_unsigned_vint(*_processing_data);
+                }
+                auto maybe_skip_bytes = skip(*_processing_data, _u64);
+                if (std::holds_alternative<skip_bytes>(maybe_skip_bytes)) {
+                    co_yield maybe_skip_bytes;
+                }
             } else {
                 read_status status = read_status::waiting;
                 if (auto len = get_column_value_length()) {
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <optional>
+
+#include <seastar/core/align.hh>
+#include <seastar/core/coroutine.hh>
+
+#include "sstables/read_ahead.hh"
+
+namespace sstables {
+
+class adaptive_file_data_source_impl : public data_source_impl {
+    file _file;
+    const io_priority_class _pc;
+    // Position of the next byte to return.
+    uint64_t _pos;
+    const uint64_t _end;
+    read_ahead_controller _read_ahead;
+    lw_shared_ptr<data_read_stats> _stats;
+    // The data starting at _pos, read ahead of the consumer.
+    std::optional<future<temporary_buffer<char>>> _ahead;
+private:
+    future<temporary_buffer<char>> issue_read() {
+        // End reads on an aligned position, so that the next one starts
+        // on one and doesn't read any byte twice.
+        auto alignment = _file.disk_read_dma_alignment();
+        auto read_end = std::min(align_up(_pos + _read_ahead.window(), alignment), _end);
+        auto f = _file.dma_read_bulk<char>(_pos, read_end - _pos, _pc);
+        if (!_stats) {
+            return f;
+        }
+        return f.then([stats = _stats] (temporary_buffer<char> buf) {
+            stats->bytes_read += buf.size();
+            return buf;
+        });
+    }
+
+    future<> drop_ahead() noexcept {
+        if (!_ahead) {
+            return make_ready_future<>();
+        }
+        auto f = std::move(*_ahead);
+        _ahead.reset();
+        return f.discard_result().handle_exception([] (std::exception_ptr) { });
+    }
+public:
+    adaptive_file_data_source_impl(file f, uint64_t pos, size_t len, const file_input_stream_options& options,
+            lw_shared_ptr<data_read_stats> stats)
+        : _file(std::move(f))
+        , _pc(options.io_priority_class)
+        , _pos(pos)
+        , _end(pos + len)
+        , _read_ahead(min_read_ahead_window, options.buffer_size * std::max(options.read_ahead, 1u))
+        , _stats(std::move(stats))
+    { }
+
+    virtual future<temporary_buffer<char>> get() override {
+        if (_pos >= _end) {
+            co_return temporary_buffer<char>();
+        }
+        bool sequential = bool(_ahead);
+        auto f = sequential ? std::move(*_ahead) : issue_read();
+        _ahead.reset();
+        auto buf = co_await std::move(f);
+        if (buf.empty()) {
+            // The file is shorter than expected.
+            _pos = _end;
+            co_return buf;
+        }
+        _pos += buf.size();
+        if (sequential) {
+            _read_ahead.on_sequential_read();
+        }
+        if (_pos < _end) {
+            _ahead = issue_read();
+        }
+        if (_stats) {
+            _stats->bytes_consumed += buf.size();
+        }
+        co_return buf;
+    }
+
+    virtual future<temporary_buffer<char>> skip(uint64_t n) override {
+        auto target = std::min(_pos + n, _end);
+        if (_ahead) {
+            auto buf = co_await std::move(*_ahead);
+            _ahead.reset();
+            if (target - _pos < buf.size()) {
+                // A short skip, within the data read ahead.
+                buf.trim_front(target - _pos);
+                _pos = target;
+                _ahead = make_ready_future<temporary_buffer<char>>(std::move(buf));
+                co_return temporary_buffer<char>();
+            }
+        }
+        _pos = target;
+        _read_ahead.on_skip();
+        co_return temporary_buffer<char>();
+    }
+
+    virtual future<> close() override {
+        return drop_ahead();
+    }
+};
+
+input_stream<char> make_adaptive_file_input_stream(file f, uint64_t pos, size_t len,
+        file_input_stream_options options, lw_shared_ptr<data_read_stats> stats) {
+    return input_stream<char>(data_source(std::make_unique<adaptive_file_data_source_impl>(
+            std::move(f), pos, len, options, std::move(stats))));
+}
+
+}
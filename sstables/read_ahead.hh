@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include <seastar/core/file.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/iostream.hh>
+#include <seastar/core/shared_ptr.hh>
+
+#include "seastarx.hh"
+
+namespace sstables {
+
+// How much of the data read from sstable data files was handed over to
+// their readers. The rest was read ahead and dropped by a skip.
+struct data_read_stats {
+    uint64_t bytes_read = 0;
+    uint64_t bytes_consumed = 0;
+};
+
+// Sizes the reads of a data stream after its access pattern.
+//
+// Reads start small, so that point lookups don't fetch much more than they
+// need, grow geometrically while the stream is consumed sequentially, and
+// shrink back when the consumer skips, as the data read ahead is wasted then.
+class read_ahead_controller {
+    size_t _min_window;
+    size_t _max_window;
+    size_t _window;
+public:
+    read_ahead_controller(size_t min_window, size_t max_window) noexcept
+        : _min_window(min_window)
+        , _max_window(std::max(min_window, max_window))
+        , _window(_min_window)
+    { }
+
+    size_t window() const noexcept {
+        return _window;
+    }
+
+    // The data read ahead was consumed.
+    void on_sequential_read() noexcept {
+        _window = std::min(_window * 2, _max_window);
+    }
+
+    // The consumer skipped past the data read ahead.
+    void on_skip() noexcept {
+        _window = _min_window;
+    }
+};
+
+// Size of the first read of an adaptive stream.
+constexpr size_t min_read_ahead_window = 16 * 1024;
+
+// Like make_file_input_stream(), but the size of reads is picked by a
+// read_ahead_controller, in between min_read_ahead_window and
+// options.buffer_size * options.read_ahead. So that I/O overlaps with
+// consumption, the next read is issued as soon as a buffer is returned.
+//
+// options.dynamic_adjustments is ignored.
+input_stream<char> make_adaptive_file_input_stream(file f, uint64_t pos, size_t len,
+        file_input_stream_options options, lw_shared_ptr<data_read_stats> stats = {});
+
+}
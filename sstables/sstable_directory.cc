@@ -115,7 +115,9 @@ sstable_directory::process_descriptor(sstables::entry_descriptor desc, process_f
     }
 
     auto sst = _manager.make_sstable(_schema, _sstable_dir.native(), desc.generation, desc.version, desc.format, gc_clock::now(), _error_handler_gen);
-    return sst->load(_io_priority).then([this, sst, flags] {
+    sstable_open_config cfg;
+    cfg.load_filter_lazily = true;
+    return sst->load(_io_priority, cfg).then([this, sst, flags] {
         validate(sst, flags);
         if (flags.need_mutate_level) {
             dirlog.trace("Mutating {} to level 0\n", sst->get_filename());
@@ -136,16 +138,17 @@ sstable_directory::process_descriptor(sstables::entry_descriptor desc, process_f
 
 future<>
 sstable_directory::sort_sstable(sstables::shared_sstable sst) {
-    return sst->get_open_info().then([sst, this] (sstables::foreign_sstable_open_info info) {
-        auto shards = sst->get_shards_for_this_sstable();
+    auto shards = sst->get_shards_for_this_sstable();
+    if (shards.size() == 1 && shards[0] == this_shard_id()) {
+        // The common case, which doesn't need a copy of the components for another shard.
+        dirlog.trace("{} identified as a local unshared SSTable", sst->get_filename());
+        _unshared_local_sstables.push_back(sst);
+        return make_ready_future<>();
+    }
+    return sst->get_open_info().then([sst, shards = std::move(shards), this] (sstables::foreign_sstable_open_info info) {
         if (shards.size() == 1) {
-            if (shards[0] == this_shard_id()) {
-                dirlog.trace("{} identified as a local unshared SSTable", sst->get_filename());
-                _unshared_local_sstables.push_back(sst);
-            } else {
-                dirlog.trace("{} identified as a remote unshared SSTable", sst->get_filename());
-                _unshared_remote_sstables[shards[0]].push_back(std::move(info));
-            }
+            dirlog.trace("{} identified as a remote unshared SSTable", sst->get_filename());
+            _unshared_remote_sstables[shards[0]].push_back(std::move(info));
         } else {
             dirlog.trace("{} identified as a shared SSTable", sst->get_filename());
             _shared_sstable_info.push_back(std::move(info));
@@ -474,9 +477,19 @@ sstable_directory::retrieve_shared_sstables() {
 
 future<> sstable_directory::delete_atomically(std::vector<shared_sstable> ssts) {
     if (ssts.empty()) {
-        return make_ready_future<>();
+        co_return;
+    }
+    sstring pending_delete_log;
+    try {
+        pending_delete_log = co_await write_pending_delete_log(ssts);
+    } catch (...) {
+        sstlog.warn("Error while writing the pending delete log: {}. Ignoring.", std::current_exception());
     }
-    return seastar::async([ssts = std::move(ssts)] {
+    co_await unlink_pending_delete(std::move(ssts), std::move(pending_delete_log));
+}
+
+future<sstring> sstable_directory::write_pending_delete_log(const std::vector<shared_sstable>& ssts) {
+    return seastar::async([&ssts] {
         sstring sstdir;
         min_max_tracker<generation_type> gen_tracker;
 
@@ -496,50 +509,52 @@ future<> sstable_directory::delete_atomically(std::vector<shared_sstable> ssts)
         sstring pending_delete_log = format("{}/sstables-{}-{}.log", pending_delete_dir, gen_tracker.min(), gen_tracker.max());
         sstring tmp_pending_delete_log = pending_delete_log + ".tmp";
         sstlog.trace("Writing {}", tmp_pending_delete_log);
-        try {
-            touch_directory(pending_delete_dir).get();
-            auto oflags = open_flags::wo | open_flags::create | open_flags::exclusive;
-            // Create temporary pending_delete log file.
-            auto f = open_file_dma(tmp_pending_delete_log, oflags).get0();
-            // Write all toc names into the log file.
-            auto out = make_file_output_stream(std::move(f), 4096).get0();
-            auto close_out = deferred_close(out);
-
-            for (const auto& sst : ssts) {
-                auto toc = sst->component_basename(component_type::TOC);
-                out.write(toc).get();
-                out.write("\n").get();
-            }
+        touch_directory(pending_delete_dir).get();
+        auto oflags = open_flags::wo | open_flags::create | open_flags::exclusive;
+        // Create temporary pending_delete log file.
+        auto f = open_file_dma(tmp_pending_delete_log, oflags).get0();
+        // Write all toc names into the log file.
+        auto out = make_file_output_stream(std::move(f), 4096).get0();
+        auto close_out = deferred_close(out);
 
-            out.flush().get();
-            close_out.close_now();
+        for (const auto& sst : ssts) {
+            auto toc = sst->component_basename(component_type::TOC);
+            out.write(toc).get();
+            out.write("\n").get();
+        }
 
-            auto dir_f = open_directory(pending_delete_dir).get0();
-            // Once flushed and closed, the temporary log file can be renamed.
-            rename_file(tmp_pending_delete_log, pending_delete_log).get();
+        out.flush().get();
+        close_out.close_now();
 
-            // Guarantee that the changes above reached the disk.
-            dir_f.flush().get();
-            dir_f.close().get();
-            sstlog.debug("{} written successfully.", pending_delete_log);
-        } catch (...) {
-            sstlog.warn("Error while writing {}: {}. Ignoring.", pending_delete_log, std::current_exception());
-        }
+        auto dir_f = open_directory(pending_delete_dir).get0();
+        // Once flushed and closed, the temporary log file can be renamed.
+        rename_file(tmp_pending_delete_log, pending_delete_log).get();
 
-        parallel_for_each(ssts, [] (shared_sstable sst) {
-            return sst->unlink();
-        }).get();
-
-        // Once all sstables are deleted, the log file can be removed.
-        // Note: the log file will be removed also if unlink failed to remove
-        // any sstable and ignored the error.
-        try {
-            remove_file(pending_delete_log).get();
-            sstlog.debug("{} removed.", pending_delete_log);
-        } catch (...) {
-            sstlog.warn("Error removing {}: {}. Ignoring.", pending_delete_log, std::current_exception());
-        }
+        // Guarantee that the changes above reached the disk.
+        dir_f.flush().get();
+        dir_f.close().get();
+        sstlog.debug("{} written successfully.", pending_delete_log);
+        return pending_delete_log;
+    });
+}
+
+future<> sstable_directory::unlink_pending_delete(std::vector<shared_sstable> ssts, sstring pending_delete_log) {
+    co_await parallel_for_each(ssts, [] (shared_sstable sst) {
+        return sst->unlink();
     });
+
+    if (pending_delete_log.empty()) {
+        co_return;
+    }
+    // Once all sstables are deleted, the log file can be removed.
+    // Note: the log file will be removed also if unlink failed to remove
+    // any sstable and ignored the error.
+    try {
+        co_await remove_file(pending_delete_log);
+        sstlog.debug("{} removed.", pending_delete_log);
+    } catch (...) {
+        sstlog.warn("Error removing {}: {}. Ignoring.", pending_delete_log, std::current_exception());
+    }
 }
 
 // FIXME: Go through maybe_delete_large_partitions_entry on recovery
@@ -224,6 +224,13 @@ class sstable_directory {
     //
     // This function only solves the second problem for now.
     static future<> delete_atomically(std::vector<shared_sstable> ssts);
+    // The two steps of delete_atomically(). Once write_pending_delete_log()
+    // resolves, the deletion is durable: if the node goes down before the
+    // sstables are unlinked, replay_pending_delete_log() completes it on
+    // restart. So the sstables may be unlinked in the background.
+    // Like delete_atomically(), both take sstables of a single directory.
+    static future<sstring> write_pending_delete_log(const std::vector<shared_sstable>& ssts);
+    static future<> unlink_pending_delete(std::vector<shared_sstable> ssts, sstring pending_delete_log);
     static future<> replay_pending_delete_log(std::filesystem::path log_file);
 };
 
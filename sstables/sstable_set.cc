@@ -8,14 +8,12 @@
 
 #include <seastar/util/defer.hh>
 
-#include <boost/icl/interval_map.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
 #include <boost/range/algorithm/sort.hpp>
 
 #include "sstables.hh"
 
-#include "compatible_ring_position.hh"
 #include "compaction/compaction_strategy_impl.hh"
 #include "compaction/leveled_compaction_strategy.hh"
 #include "compaction/time_window_compaction_strategy.hh"
@@ -200,77 +198,35 @@ sstable_set::make_incremental_selector() const {
     return incremental_selector(_impl->make_incremental_selector(), *_schema);
 }
 
-partitioned_sstable_set::interval_type partitioned_sstable_set::make_interval(const schema& s, const dht::partition_range& range) {
-    return interval_type::closed(
-            compatible_ring_position_or_view(s, dht::ring_position_view(range.start()->value())),
-            compatible_ring_position_or_view(s, dht::ring_position_view(range.end()->value())));
-}
-
-partitioned_sstable_set::interval_type partitioned_sstable_set::make_interval(const dht::partition_range& range) const {
-    return make_interval(*_schema, range);
-}
-
-partitioned_sstable_set::interval_type partitioned_sstable_set::make_interval(const schema_ptr& s, const sstable& sst) {
-    return interval_type::closed(
-            compatible_ring_position_or_view(s, dht::ring_position(sst.get_first_decorated_key())),
-            compatible_ring_position_or_view(s, dht::ring_position(sst.get_last_decorated_key())));
-}
-
-partitioned_sstable_set::interval_type partitioned_sstable_set::make_interval(const sstable& sst) {
-    return make_interval(_schema, sst);
-}
-
-partitioned_sstable_set::interval_type partitioned_sstable_set::singular(const dht::ring_position& rp) const {
-    // We should use the view here, since this is used for queries.
-    auto rpv = dht::ring_position_view(rp);
-    auto crp = compatible_ring_position_or_view(*_schema, std::move(rpv));
-    return interval_type::closed(crp, crp);
-}
-
-std::pair<partitioned_sstable_set::map_iterator, partitioned_sstable_set::map_iterator>
-partitioned_sstable_set::query(const dht::partition_range& range) const {
-    if (range.start() && range.end()) {
-        return _leveled_sstables.equal_range(make_interval(range));
-    }
-    else if (range.start() && !range.end()) {
-        auto start = singular(range.start()->value());
-        return { _leveled_sstables.lower_bound(start), _leveled_sstables.end() };
-    } else if (!range.start() && range.end()) {
-        auto end = singular(range.end()->value());
-        return { _leveled_sstables.begin(), _leveled_sstables.upper_bound(end) };
-    } else {
-        return { _leveled_sstables.begin(), _leveled_sstables.end() };
-    }
-}
-
 bool partitioned_sstable_set::store_as_unleveled(const shared_sstable& sst) const {
     return _use_level_metadata && sst->get_sstable_level() == 0;
 }
 
-dht::ring_position partitioned_sstable_set::to_ring_position(const compatible_ring_position_or_view& crp) {
-    // Ring position views, representing bounds of sstable intervals are
-    // guaranteed to have key() != nullptr;
-    const auto& pos = crp.position();
-    return dht::ring_position(pos.token(), *pos.key());
+static dht::ring_position_view first_position(const shared_sstable& sst) {
+    return dht::ring_position_view(sst->get_first_decorated_key());
 }
 
-dht::partition_range partitioned_sstable_set::to_partition_range(const interval_type& i) {
-    return dht::partition_range::make(
-            {to_ring_position(i.lower()), boost::icl::is_left_closed(i.bounds())},
-            {to_ring_position(i.upper()), boost::icl::is_right_closed(i.bounds())});
+static dht::ring_position_view last_position(const shared_sstable& sst) {
+    return dht::ring_position_view(sst->get_last_decorated_key());
 }
 
-dht::partition_range partitioned_sstable_set::to_partition_range(const dht::ring_position_view& pos, const interval_type& i) {
-    auto lower_bound = [&] {
-        if (pos.key()) {
-            return dht::partition_range::bound(dht::ring_position(pos.token(), *pos.key()),
-                    pos.is_after_key() == dht::ring_position_view::after_key::no);
-        } else {
-            return dht::partition_range::bound(dht::ring_position(pos.token(), pos.get_token_bound()), true);
-        }
-    }();
-    auto upper_bound = dht::partition_range::bound(to_ring_position(i.lower()), !boost::icl::is_left_closed(i.bounds()));
-    return dht::partition_range::make(std::move(lower_bound), std::move(upper_bound));
+bool partitioned_sstable_set::try_insert_into_run(lw_shared_ptr<leveled_run>& run, const shared_sstable& sst) const {
+    auto cmp = dht::ring_position_comparator(*_schema);
+    auto it = std::partition_point(run->begin(), run->end(), [&] (const shared_sstable& x) {
+        return cmp(first_position(x), first_position(sst)) < 0;
+    });
+    if (it != run->end() && cmp(first_position(*it), last_position(sst)) <= 0) {
+        return false;
+    }
+    if (it != run->begin() && cmp(last_position(*std::prev(it)), first_position(sst)) >= 0) {
+        return false;
+    }
+    auto idx = std::distance(run->begin(), it);
+    if (run.use_count() > 1) {
+        run = make_lw_shared<leveled_run>(*run);
+    }
+    run->insert(run->begin() + idx, sst);
+    return true;
 }
 
 partitioned_sstable_set::partitioned_sstable_set(schema_ptr schema, bool use_level_metadata)
@@ -279,30 +235,33 @@ partitioned_sstable_set::partitioned_sstable_set(schema_ptr schema, bool use_lev
         , _use_level_metadata(use_level_metadata) {
 }
 
-partitioned_sstable_set::partitioned_sstable_set(schema_ptr schema, const std::vector<shared_sstable>& unleveled_sstables, const interval_map_type& leveled_sstables,
+partitioned_sstable_set::partitioned_sstable_set(schema_ptr schema, const std::vector<shared_sstable>& unleveled_sstables, const leveled_runs& leveled_runs,
         const lw_shared_ptr<sstable_list>& all, const std::unordered_map<run_id, sstable_run>& all_runs, bool use_level_metadata)
         : _schema(schema)
         , _unleveled_sstables(unleveled_sstables)
-        , _leveled_sstables(leveled_sstables)
+        , _leveled_runs(leveled_runs)
         , _all(make_lw_shared<sstable_list>(*all))
         , _all_runs(all_runs)
         , _use_level_metadata(use_level_metadata) {
 }
 
 std::unique_ptr<sstable_set_impl> partitioned_sstable_set::clone() const {
-    return std::make_unique<partitioned_sstable_set>(_schema, _unleveled_sstables, _leveled_sstables, _all, _all_runs, _use_level_metadata);
+    return std::make_unique<partitioned_sstable_set>(_schema, _unleveled_sstables, _leveled_runs, _all, _all_runs, _use_level_metadata);
 }
 
 std::vector<shared_sstable> partitioned_sstable_set::select(const dht::partition_range& range) const {
-    auto ipair = query(range);
-    auto b = std::move(ipair.first);
-    auto e = std::move(ipair.second);
-    value_set result;
-    while (b != e) {
-        boost::copy(b++->second, std::inserter(result, result.end()));
-    }
+    auto cmp = dht::ring_position_comparator(*_schema);
+    auto start = dht::ring_position_view::for_range_start(range);
+    auto end = dht::ring_position_view::for_range_end(range);
     auto r = _unleveled_sstables;
-    r.insert(r.end(), result.begin(), result.end());
+    for (auto& run : _leveled_runs) {
+        auto it = std::partition_point(run->begin(), run->end(), [&] (const shared_sstable& sst) {
+            return cmp(last_position(sst), start) < 0;
+        });
+        for (; it != run->end() && cmp(first_position(*it), end) < 0; ++it) {
+            r.push_back(*it);
+        }
+    }
     return r;
 }
 
@@ -332,7 +291,12 @@ void partitioned_sstable_set::insert(shared_sstable sst) {
         _unleveled_sstables.push_back(sst);
     } else {
         _leveled_sstables_change_cnt++;
-        _leveled_sstables.add({make_interval(*sst), value_set({sst})});
+        auto inserted = std::any_of(_leveled_runs.begin(), _leveled_runs.end(), [&] (lw_shared_ptr<leveled_run>& run) {
+            return try_insert_into_run(run, sst);
+        });
+        if (!inserted) {
+            _leveled_runs.push_back(make_lw_shared<leveled_run>(leveled_run{sst}));
+        }
     }
     undo_all_insert.cancel();
     undo_all_runs_insert.cancel();
@@ -343,70 +307,110 @@ void partitioned_sstable_set::erase(shared_sstable sst) {
     _all->erase(sst);
     if (store_as_unleveled(sst)) {
         _unleveled_sstables.erase(std::remove(_unleveled_sstables.begin(), _unleveled_sstables.end(), sst), _unleveled_sstables.end());
-    } else {
-        _leveled_sstables_change_cnt++;
-        _leveled_sstables.subtract({make_interval(*sst), value_set({sst})});
+        return;
+    }
+    _leveled_sstables_change_cnt++;
+    auto cmp = dht::ring_position_comparator(*_schema);
+    for (auto run_it = _leveled_runs.begin(); run_it != _leveled_runs.end(); ++run_it) {
+        auto& run = *run_it;
+        auto it = std::partition_point(run->begin(), run->end(), [&] (const shared_sstable& x) {
+            return cmp(first_position(x), first_position(sst)) < 0;
+        });
+        if (it == run->end() || *it != sst) {
+            continue;
+        }
+        if (run->size() == 1) {
+            _leveled_runs.erase(run_it);
+            return;
+        }
+        auto idx = std::distance(run->begin(), it);
+        if (run.use_count() > 1) {
+            run = make_lw_shared<leveled_run>(*run);
+        }
+        run->erase(run->begin() + idx);
+        return;
     }
 }
 
 class partitioned_sstable_set::incremental_selector : public incremental_selector_impl {
     schema_ptr _schema;
     const std::vector<shared_sstable>& _unleveled_sstables;
-    const interval_map_type& _leveled_sstables;
+    const leveled_runs& _leveled_runs;
     const uint64_t& _leveled_sstables_change_cnt;
     uint64_t _last_known_leveled_sstables_change_cnt;
-    map_iterator _it;
+    // For each run, the position of the first sstable which doesn't end before
+    // the last selected position.
+    std::vector<size_t> _positions;
 private:
-    dht::ring_position_ext next_position(map_iterator it) {
-        if (it == _leveled_sstables.end()) {
-            return dht::ring_position_view::max();
-        } else {
-            auto&& next_position = partitioned_sstable_set::to_ring_position(it->first.lower());
-            return dht::ring_position_ext(next_position, dht::ring_position_ext::after_key(!boost::icl::is_left_closed(it->first.bounds())));
-        }
-    }
-    static bool is_before_interval(const compatible_ring_position_or_view& crp, const interval_type& interval) {
-        if (boost::icl::is_left_closed(interval.bounds())) {
-            return crp < interval.lower();
+    static dht::partition_range::bound to_lower_bound(const dht::ring_position_view& pos) {
+        if (pos.key()) {
+            return dht::partition_range::bound(dht::ring_position(pos.token(), *pos.key()),
+                    pos.is_after_key() == dht::ring_position_view::after_key::no);
         } else {
-            return crp <= interval.lower();
+            return dht::partition_range::bound(dht::ring_position(pos.token(), pos.get_token_bound()), true);
         }
     }
-    void maybe_invalidate_iterator(const compatible_ring_position_or_view& crp) {
-        if (_last_known_leveled_sstables_change_cnt != _leveled_sstables_change_cnt) {
-            _it = _leveled_sstables.lower_bound(interval_type::closed(crp, crp));
+    void maybe_invalidate_positions() {
+        if (_last_known_leveled_sstables_change_cnt != _leveled_sstables_change_cnt || _positions.size() != _leveled_runs.size()) {
+            _positions.assign(_leveled_runs.size(), 0);
             _last_known_leveled_sstables_change_cnt = _leveled_sstables_change_cnt;
         }
     }
 public:
-    incremental_selector(schema_ptr schema, const std::vector<shared_sstable>& unleveled_sstables, const interval_map_type& leveled_sstables,
+    incremental_selector(schema_ptr schema, const std::vector<shared_sstable>& unleveled_sstables, const leveled_runs& leveled_runs,
                          const uint64_t& leveled_sstables_change_cnt)
         : _schema(std::move(schema))
         , _unleveled_sstables(unleveled_sstables)
-        , _leveled_sstables(leveled_sstables)
+        , _leveled_runs(leveled_runs)
         , _leveled_sstables_change_cnt(leveled_sstables_change_cnt)
         , _last_known_leveled_sstables_change_cnt(leveled_sstables_change_cnt)
-        , _it(leveled_sstables.begin()) {
+        , _positions(leveled_runs.size(), 0) {
     }
     virtual std::tuple<dht::partition_range, std::vector<shared_sstable>, dht::ring_position_ext> select(const dht::ring_position_view& pos) override {
-        auto crp = compatible_ring_position_or_view(*_schema, pos);
+        auto cmp = dht::ring_position_comparator(*_schema);
         auto ssts = _unleveled_sstables;
         using namespace dht;
 
-        maybe_invalidate_iterator(crp);
+        maybe_invalidate_positions();
+
+        // The selection holds until the closest bound among all runs: the end
+        // of a selected sstable, or the start of the next sstable of a run.
+        std::optional<partition_range::bound> upper;
+        std::optional<ring_position_ext> next;
+        auto maybe_restrict = [&] (const decorated_key& key, bool after_key) {
+            auto bound = ring_position_view(key, ring_position_view::after_key(after_key));
+            if (!next || cmp(bound, ring_position_view(*next)) < 0) {
+                upper = partition_range::bound(ring_position(key), after_key);
+                next = ring_position_ext(key, ring_position_ext::after_key(after_key));
+            }
+        };
 
-        while (_it != _leveled_sstables.end()) {
-            if (boost::icl::contains(_it->first, crp)) {
-                ssts.insert(ssts.end(), _it->second.begin(), _it->second.end());
-                return std::make_tuple(partitioned_sstable_set::to_partition_range(_it->first), std::move(ssts), next_position(std::next(_it)));
+        for (size_t i = 0; i < _leveled_runs.size(); ++i) {
+            const auto& run = *_leveled_runs[i];
+            auto begin = run.begin();
+            // Positions only move forward, unless the caller goes back.
+            if (_positions[i] > 0 && cmp(last_position(run[_positions[i] - 1]), pos) < 0) {
+                begin += _positions[i];
+            }
+            auto it = std::partition_point(begin, run.end(), [&] (const shared_sstable& sst) {
+                return cmp(last_position(sst), pos) < 0;
+            });
+            _positions[i] = std::distance(run.begin(), it);
+            if (it == run.end()) {
+                continue;
             }
-            // We don't want to skip current interval if pos lies before it.
-            if (is_before_interval(crp, _it->first)) {
-                return std::make_tuple(partitioned_sstable_set::to_partition_range(pos, _it->first), std::move(ssts), next_position(_it));
+            if (cmp(first_position(*it), pos) <= 0) {
+                ssts.push_back(*it);
+                maybe_restrict((*it)->get_last_decorated_key(), true);
+            } else {
+                maybe_restrict((*it)->get_first_decorated_key(), false);
             }
-            _it++;
         }
-        return std::make_tuple(partition_range::make_open_ended_both_sides(), std::move(ssts), ring_position_view::max());
+
+        if (!next) {
+            return std::make_tuple(partition_range::make(to_lower_bound(pos), {}), std::move(ssts), ring_position_view::max());
+        }
+        return std::make_tuple(partition_range::make(to_lower_bound(pos), std::move(upper)), std::move(ssts), std::move(*next));
     }
 };
 
@@ -643,11 +647,11 @@ std::unique_ptr<position_reader_queue> time_series_sstable_set::make_position_re
 }
 
 std::unique_ptr<incremental_selector_impl> partitioned_sstable_set::make_incremental_selector() const {
-    return std::make_unique<incremental_selector>(_schema, _unleveled_sstables, _leveled_sstables, _leveled_sstables_change_cnt);
+    return std::make_unique<incremental_selector>(_schema, _unleveled_sstables, _leveled_runs, _leveled_sstables_change_cnt);
 }
 
 std::unique_ptr<sstable_set_impl> compaction_strategy_impl::make_sstable_set(schema_ptr schema) const {
-    // with use_level_metadata enabled, L0 sstables will not go to interval map, which suits well STCS.
+    // with use_level_metadata enabled, L0 sstables will not go to the leveled runs, which suits well STCS.
     return std::make_unique<partitioned_sstable_set>(schema, true);
 }
 
@@ -684,6 +688,7 @@ class incremental_reader_selector : public reader_selector {
     std::optional<sstable_set::incremental_selector> _selector;
     std::unordered_set<generation_type> _read_sstable_gens;
     sstable_reader_factory_type _fn;
+    sstable_filter_type _filter;
 
     flat_mutation_reader_v2 create_reader(shared_sstable sst) {
         tracing::trace(_trace_state, "Reading partition range {} from sstable {}", *_pr, seastar::value_of([&sst] { return sst->get_filename(); }));
@@ -695,13 +700,15 @@ class incremental_reader_selector : public reader_selector {
             lw_shared_ptr<const sstable_set> sstables,
             const dht::partition_range& pr,
             tracing::trace_state_ptr trace_state,
-            sstable_reader_factory_type fn)
+            sstable_reader_factory_type fn,
+            sstable_filter_type filter = {})
         : reader_selector(s, pr.start() ? pr.start()->value() : dht::ring_position_view::min())
         , _pr(&pr)
         , _sstables(std::move(sstables))
         , _trace_state(std::move(trace_state))
         , _selector(_sstables->make_incremental_selector())
-        , _fn(std::move(fn)) {
+        , _fn(std::move(fn))
+        , _filter(std::move(filter)) {
 
         irclogger.trace("{}: created for range: {} with {} sstables",
                 fmt::ptr(this),
@@ -728,7 +735,9 @@ class incremental_reader_selector : public reader_selector {
                     _selector_position);
 
             readers = boost::copy_range<std::vector<flat_mutation_reader_v2>>(selection.sstables
-                    | boost::adaptors::filtered([this] (auto& sst) { return _read_sstable_gens.emplace(sst->generation()).second; })
+                    | boost::adaptors::filtered([this] (auto& sst) {
+                        return _read_sstable_gens.emplace(sst->generation()).second && (!_filter || _filter(*sst));
+                    })
                     | boost::adaptors::transformed([this] (auto& sst) { return this->create_reader(sst); }));
         } while (!_selector_position.is_max() && readers.empty() && (!pos || dht::ring_position_tri_compare(*_s, *pos, _selector_position) >= 0));
 
@@ -764,16 +773,24 @@ class incremental_reader_selector : public reader_selector {
 // Assumes the given `pos` and `schema` are alive during the function's lifetime.
 static std::predicate<const sstable&> auto
 make_pk_filter(const dht::ring_position& pos, const schema& schema) {
-    return [&pos, key = key::from_partition_key(schema, *pos.key()), cmp = dht::ring_position_comparator(schema)] (const sstable& sst) {
+    // The key is hashed once, rather than once for each sstable.
+    auto hk = utils::make_hashed_key(bytes_view(key::from_partition_key(schema, *pos.key())));
+    return [&pos, hk, cmp = dht::ring_position_comparator(schema)] (const sstable& sst) {
         return cmp(pos, sst.get_first_decorated_key()) >= 0 &&
                cmp(pos, sst.get_last_decorated_key()) <= 0 &&
-               sst.filter_has_key(key);
+               sst.filter_has_key(hk);
     };
 }
 
 // Filter out sstables for reader using bloom filter
 static std::vector<shared_sstable>
 filter_sstable_for_reader_by_pk(std::vector<shared_sstable>&& sstables, const schema& schema, const dht::ring_position& pos) {
+    // Probing filters of many sstables one by one pays a cache miss per sstable
+    // in turn, so start fetching all of them first and let the misses overlap.
+    auto hk = utils::make_hashed_key(bytes_view(key::from_partition_key(schema, *pos.key())));
+    for (auto& sst : sstables) {
+        sst->prefetch_filter(hk);
+    }
     auto filter = [_filter = make_pk_filter(pos, schema)] (const shared_sstable& sst) { return !_filter(*sst); };
     sstables.erase(boost::remove_if(sstables, filter), sstables.end());
     return std::move(sstables);
@@ -1171,7 +1188,8 @@ sstable_set::make_local_shard_sstable_reader(
         tracing::trace_state_ptr trace_state,
         streamed_mutation::forwarding fwd,
         mutation_reader::forwarding fwd_mr,
-        read_monitor_generator& monitor_generator) const
+        read_monitor_generator& monitor_generator,
+        sstable_filter_type filter) const
 {
     auto reader_factory_fn = [s, permit, &slice, &pc, trace_state, fwd, fwd_mr, &monitor_generator]
             (shared_sstable& sst, const dht::partition_range& pr) mutable {
@@ -1180,13 +1198,17 @@ sstable_set::make_local_shard_sstable_reader(
     };
     if (auto sstables = _impl->all(); sstables->size() == 1) [[unlikely]] {
         auto sst = *sstables->begin();
+        if (filter && !filter(*sst)) {
+            return make_empty_flat_reader_v2(std::move(s), std::move(permit));
+        }
         return reader_factory_fn(sst, pr);
     }
     return make_combined_reader(s, std::move(permit), std::make_unique<incremental_reader_selector>(s,
                     shared_from_this(),
                     pr,
                     std::move(trace_state),
-                    std::move(reader_factory_fn)),
+                    std::move(reader_factory_fn),
+                    std::move(filter)),
             fwd,
             fwd_mr);
 }
@@ -15,6 +15,7 @@
 #include "dht/i_partitioner.hh"
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/io_priority_class.hh>
+#include <functional>
 #include <vector>
 
 namespace utils {
@@ -26,6 +27,9 @@ namespace sstables {
 class sstable_set_impl;
 class incremental_selector_impl;
 
+// Returns false for sstables which a reader may skip.
+using sstable_filter_type = std::function<bool(const sstable&)>;
+
 struct sstable_first_key_less_comparator {
     bool operator()(const shared_sstable& s1, const shared_sstable& s2) const;
 };
@@ -133,6 +137,8 @@ class sstable_set : public enable_lw_shared_from_this<sstable_set> {
         read_monitor_generator& rmg = default_read_monitor_generator()) const;
 
     // Filters out mutations that don't belong to the current shard.
+    //
+    // If a filter is given, sstables it rejects are not read.
     flat_mutation_reader_v2 make_local_shard_sstable_reader(
         schema_ptr,
         reader_permit,
@@ -142,7 +148,8 @@ class sstable_set : public enable_lw_shared_from_this<sstable_set> {
         tracing::trace_state_ptr,
         streamed_mutation::forwarding,
         mutation_reader::forwarding,
-        read_monitor_generator& rmg = default_read_monitor_generator()) const;
+        read_monitor_generator& rmg = default_read_monitor_generator(),
+        sstable_filter_type filter = {}) const;
 
     flat_mutation_reader_v2 make_crawling_reader(
             schema_ptr,
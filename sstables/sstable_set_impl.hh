@@ -8,9 +8,6 @@
 
 #pragma once
 
-#include <boost/icl/interval_map.hpp>
-
-#include "compatible_ring_position.hh"
 #include "sstable_set.hh"
 #include "readers/clustering_combined.hh"
 #include "sstables/types_fwd.hh"
@@ -51,41 +48,38 @@ class sstable_set_impl {
 // specialized when sstables are partitioned in the token range space
 // e.g. leveled compaction strategy
 class partitioned_sstable_set : public sstable_set_impl {
-    using value_set = std::unordered_set<shared_sstable>;
-    using interval_map_type = boost::icl::interval_map<compatible_ring_position_or_view, value_set>;
-    using interval_type = interval_map_type::interval_type;
-    using map_iterator = interval_map_type::const_iterator;
+    // Sstables which don't overlap each other, sorted by their first key.
+    using leveled_run = std::vector<shared_sstable>;
+    using leveled_runs = std::vector<lw_shared_ptr<leveled_run>>;
 private:
     schema_ptr _schema;
     std::vector<shared_sstable> _unleveled_sstables;
-    interval_map_type _leveled_sstables;
+    // The leveled sstables, split into runs of disjoint sstables, so that the
+    // sstables overlapping a range are found with a binary search in each run.
+    // With LCS, there are about as many runs as levels.
+    // The runs are shared with the clones of the set and copied when modified,
+    // so cloning the set, like every change of a table's sstables does, only
+    // copies the pointers to the runs.
+    leveled_runs _leveled_runs;
     lw_shared_ptr<sstable_list> _all;
     std::unordered_map<run_id, sstable_run> _all_runs;
-    // Change counter on interval map for leveled sstables which is used by
-    // incremental selector to determine whether or not to invalidate iterators.
+    // Change counter on leveled runs which is used by incremental selector
+    // to determine whether or not to invalidate its positions in the runs.
     uint64_t _leveled_sstables_change_cnt = 0;
     bool _use_level_metadata = false;
 private:
-    static interval_type make_interval(const schema& s, const dht::partition_range& range);
-    interval_type make_interval(const dht::partition_range& range) const;
-    static interval_type make_interval(const schema_ptr& s, const sstable& sst);
-    interval_type make_interval(const sstable& sst);
-    interval_type singular(const dht::ring_position& rp) const;
-    std::pair<map_iterator, map_iterator> query(const dht::partition_range& range) const;
-    // SSTables are stored separately to avoid interval map's fragmentation issue when level 0 falls behind.
+    // SSTables are stored separately to avoid having as many runs as sstables when level 0 falls behind.
     bool store_as_unleveled(const shared_sstable& sst) const;
+    // Inserts sst into run, if it doesn't overlap any of its sstables.
+    bool try_insert_into_run(lw_shared_ptr<leveled_run>& run, const shared_sstable& sst) const;
 public:
-    static dht::ring_position to_ring_position(const compatible_ring_position_or_view& crp);
-    static dht::partition_range to_partition_range(const interval_type& i);
-    static dht::partition_range to_partition_range(const dht::ring_position_view& pos, const interval_type& i);
-
     partitioned_sstable_set(const partitioned_sstable_set&) = delete;
     explicit partitioned_sstable_set(schema_ptr schema, bool use_level_metadata = true);
-    // For cloning the partitioned_sstable_set (makes a deep copy, including *_all)
+    // For cloning the partitioned_sstable_set (makes a deep copy of *_all, shares the leveled runs)
     explicit partitioned_sstable_set(
         schema_ptr schema,
         const std::vector<shared_sstable>& unleveled_sstables,
-        const interval_map_type& leveled_sstables,
+        const leveled_runs& leveled_runs,
         const lw_shared_ptr<sstable_list>& all,
         const std::unordered_map<run_id, sstable_run>& all_runs,
         bool use_level_metadata);
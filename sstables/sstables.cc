@@ -71,6 +71,7 @@
 #include "sstables/random_access_reader.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/partition_index_cache.hh"
+#include "sstables/mx/promoted_index_cache.hh"
 #include "utils/UUID_gen.hh"
 #include "sstables_manager.hh"
 #include <boost/algorithm/string/predicate.hpp>
@@ -585,6 +586,53 @@ inline void write(sstable_version_types v, file_writer& out, const summary& s) {
     write(v, out, s.first_key, s.last_key);
 }
 
+// Keeps only every factor-th entry of the summary in memory.
+static future<> thin_summary(summary& s, unsigned factor) {
+    summary thinned;
+    thinned.header = s.header;
+    thinned.first_key = std::move(s.first_key);
+    thinned.last_key = std::move(s.last_key);
+    thinned.page_factor = s.page_factor * factor;
+    thinned.entries.reserve((s.entries.size() + factor - 1) / factor);
+    for (size_t i = 0; i < s.entries.size(); i += factor) {
+        auto& e = s.entries[i];
+        thinned.entries.push_back({ e.token, thinned.add_summary_data(e.key), e.position });
+        co_await coroutine::maybe_yield();
+    }
+    thinned.header.size = thinned.entries.size();
+    thinned.header.memory_size = thinned.header.size * sizeof(uint32_t);
+    thinned.positions.reserve(thinned.entries.size());
+    for (auto& e : thinned.entries) {
+        thinned.positions.push_back(thinned.header.memory_size);
+        thinned.header.memory_size += e.key.size() + sizeof(e.position);
+    }
+    s = std::move(thinned);
+}
+
+future<> sstable::fit_summary_in_memory() {
+    auto& summary = _components->summary;
+    if (_summary_memory || !summary) {
+        co_return;
+    }
+    auto capacity = _manager.summary_memory_capacity();
+    auto used = _manager.summary_memory_used();
+    auto available = capacity > used ? capacity - used : 0;
+    // Don't let index pages grow past max_index_interval partitions.
+    auto interval = std::max<uint64_t>(1, get_estimated_key_count() / summary.entries.size());
+    auto max_factor = std::max<uint64_t>(1, _schema->max_index_interval() / interval);
+    auto footprint = summary.memory_footprint();
+    unsigned factor = 1;
+    while (footprint / factor > available && factor * 2 <= max_factor) {
+        factor *= 2;
+    }
+    if (factor > 1) {
+        sstlog.debug("Keeping 1 in {} summary entries of {} in memory, {} bytes of summary memory left", factor, get_filename(), available);
+        co_await thin_summary(summary, factor);
+    }
+    _summary_memory = summary.memory_footprint();
+    _manager.account_summary_memory(_summary_memory);
+}
+
 future<summary_entry&> sstable::read_summary_entry(size_t i) {
     // The last one is the boundary marker
     if (i >= (_components->summary.entries.size())) {
@@ -1373,6 +1421,7 @@ future<> sstable::open_or_create_data(open_flags oflags, file_open_options optio
 future<> sstable::open_data(sstable_open_config cfg) noexcept {
     co_await open_or_create_data(open_flags::ro);
     co_await update_info_for_opened_data(cfg);
+    co_await fit_summary_in_memory();
     if (_shards.empty()) {
         _shards = compute_shards_for_this_sstable();
     }
@@ -1462,6 +1511,8 @@ future<> sstable::create_data() noexcept {
 future<> sstable::drop_caches() {
     return _cached_index_file->evict_gently().then([this] {
         return _index_cache->evict_gently();
+    }).then([this] {
+        return _promoted_index_cache->evict_gently();
     });
 }
 
@@ -1474,6 +1525,10 @@ future<> sstable::read_filter(const io_priority_class& pc) {
     return seastar::async([this, &pc] () mutable {
         sstables::filter filter;
         read_simple<component_type::Filter>(filter, pc).get();
+        if (filter.hashes == utils::filter::split_block_bloom_filter::split_block_marker) {
+            _components->filter = utils::filter::create_split_block_filter(std::move(filter.buckets.elements));
+            return;
+        }
         auto nr_bits = filter.buckets.elements.size() * std::numeric_limits<typename decltype(filter.buckets.elements)::value_type>::digits;
         large_bitset bs(nr_bits, std::move(filter.buckets.elements));
         utils::filter_format format = (_version >= sstable_version_types::mc)
@@ -1483,11 +1538,36 @@ future<> sstable::read_filter(const io_priority_class& pc) {
     });
 }
 
+future<> sstable::ensure_filter_is_loaded() {
+    if (std::exchange(_filter_on_disk, false)) {
+        _filter_loading = read_filter(default_priority_class()).handle_exception([this] (std::exception_ptr ep) {
+            sstlog.warn("Couldn't read filter file {}: {}. All keys are considered present.", filename(component_type::Filter), ep);
+        });
+    }
+    return _filter_loading ? _filter_loading->get_future() : make_ready_future<>();
+}
+
+void sstable::load_filter_in_background() const noexcept {
+    // Only called from lookups, which can't wait for the Filter.
+    auto& self = const_cast<sstable&>(*this);
+    try {
+        (void)self.ensure_filter_is_loaded().finally([me = self.shared_from_this()] {});
+    } catch (...) {
+        sstlog.warn("Couldn't start loading filter file {}: {}", filename(component_type::Filter), std::current_exception());
+    }
+}
+
 void sstable::write_filter(const io_priority_class& pc) {
     if (!has_component(component_type::Filter)) {
         return;
     }
 
+    if (auto f = dynamic_cast<utils::filter::split_block_bloom_filter*>(_components->filter.get())) {
+        auto filter_ref = sstables::filter_ref(utils::filter::split_block_bloom_filter::split_block_marker, f->words());
+        write_simple<component_type::Filter>(filter_ref, pc);
+        return;
+    }
+
     auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
@@ -1507,7 +1587,14 @@ future<> sstable::load(const io_priority_class& pc, sstable_open_config cfg) noe
     co_await read_statistics(pc);
     co_await coroutine::all(
             [&] { return read_compression(pc); },
-            [&] { return read_filter(pc); },
+            [&] {
+                if (cfg.load_filter_lazily && has_component(component_type::Filter)) {
+                    _components->filter = std::make_unique<utils::filter::always_present_filter>();
+                    _filter_on_disk = true;
+                    return make_ready_future<>();
+                }
+                return read_filter(pc);
+            },
             [&] { return read_summary(pc); });
     validate_min_max_metadata();
     validate_max_local_deletion_time();
@@ -1530,7 +1617,10 @@ future<> sstable::load(sstables::foreign_sstable_open_info info) noexcept {
 }
 
 future<foreign_sstable_open_info> sstable::get_open_info() & {
-    return _components.copy().then([this] (auto c) mutable {
+    // Other shards get a copy of the components, which must be complete.
+    return ensure_filter_is_loaded().then([this] {
+        return _components.copy();
+    }).then([this] (auto c) mutable {
         return foreign_sstable_open_info{std::move(c), this->get_shards_for_this_sstable(), _data_file.dup(), _index_file.dup(),
             _generation, _version, _format, data_size()};
     });
@@ -2405,12 +2495,11 @@ component_type sstable::component_from_sstring(version_types v, sstring &s) {
 }
 
 input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-        reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history, raw_stream raw) {
+        reader_permit permit, tracing::trace_state_ptr trace_state, raw_stream raw) {
     file_input_stream_options options;
     options.buffer_size = sstable_buffer_size;
     options.io_priority_class = pc;
     options.read_ahead = 4;
-    options.dynamic_adjustments = std::move(history);
 
     file f = make_tracked_file(_data_file, permit);
     if (trace_state) {
@@ -2421,18 +2510,18 @@ input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_prior
     if (_components->compression && raw == raw_stream::no) {
         if (_version >= sstable_version_types::mc) {
              return make_compressed_file_m_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options), permit);
+                pos, len, std::move(options), permit, _data_read_stats);
         } else {
             return make_compressed_file_k_l_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options), permit);
+                pos, len, std::move(options), permit, _data_read_stats);
         }
     }
 
-    return make_file_input_stream(f, pos, len, std::move(options));
+    return make_adaptive_file_input_stream(f, pos, len, std::move(options), _data_read_stats);
 }
 
 future<temporary_buffer<char>> sstable::data_read(uint64_t pos, size_t len, const io_priority_class& pc, reader_permit permit) {
-    return do_with(data_stream(pos, len, pc, std::move(permit), tracing::trace_state_ptr(), {}), [len] (auto& stream) {
+    return do_with(data_stream(pos, len, pc, std::move(permit), tracing::trace_state_ptr()), [len] (auto& stream) {
         return stream.read_exactly(len).finally([&stream] {
             return stream.close();
         });
@@ -2591,7 +2680,7 @@ future<checksum> sstable::read_checksum(io_priority_class pc) {
 future<bool> validate_checksums(shared_sstable sst, reader_permit permit, const io_priority_class& pc) {
     const auto digest = co_await sst->read_digest(pc);
 
-    auto data_stream = sst->data_stream(0, sst->ondisk_data_size(), pc, permit, nullptr, nullptr, sstable::raw_stream::yes);
+    auto data_stream = sst->data_stream(0, sst->ondisk_data_size(), pc, permit, nullptr, sstable::raw_stream::yes);
 
     auto valid = true;
     std::exception_ptr ex;
@@ -2921,9 +3010,17 @@ std::vector<dht::decorated_key> sstable::get_key_samples(const schema& s, const
     auto index_range = get_sample_indexes_for_range(range);
     std::vector<dht::decorated_key> res;
     if (index_range) {
+        std::vector<partition_key> pkeys;
+        pkeys.reserve(index_range->second - index_range->first);
         for (auto idx = index_range->first; idx < index_range->second; ++idx) {
-            auto pkey = _components->summary.entries[idx].get_key().to_partition_key(s);
-            res.push_back(dht::decorate_key(s, std::move(pkey)));
+            pkeys.push_back(_components->summary.entries[idx].get_key().to_partition_key(s));
+        }
+        std::vector<partition_key_view> views(pkeys.begin(), pkeys.end());
+        std::vector<dht::token> tokens(pkeys.size());
+        dht::get_tokens(s, views, tokens);
+        res.reserve(pkeys.size());
+        for (size_t i = 0; i < pkeys.size(); ++i) {
+            res.emplace_back(std::move(tokens[i]), std::move(pkeys[i]));
         }
     }
     return res;
@@ -3050,6 +3147,7 @@ thread_local sstables_stats::stats sstables_stats::_shard_stats;
 thread_local partition_index_cache::stats partition_index_cache::_shard_stats;
 thread_local cached_file::metrics index_page_cache_metrics;
 thread_local mc::cached_promoted_index::metrics promoted_index_cache_metrics;
+thread_local mc::promoted_index_cache::stats mc::promoted_index_cache::_shard_stats;
 static thread_local seastar::metrics::metric_groups metrics;
 
 future<> init_metrics() {
@@ -3103,6 +3201,15 @@ future<> init_metrics() {
         sm::make_gauge("pi_cache_block_count", [] { return promoted_index_cache_metrics.block_count; },
             sm::description("Number of promoted index blocks currently cached")),
 
+        sm::make_counter("pi_shared_cache_hits", [] { return mc::promoted_index_cache::shard_stats().hits; },
+            sm::description("Number of promoted index block starts found in the cache shared by readers")),
+        sm::make_counter("pi_shared_cache_populations", [] { return mc::promoted_index_cache::shard_stats().populations; },
+            sm::description("Number of promoted index block starts inserted into the cache shared by readers")),
+        sm::make_counter("pi_shared_cache_evictions", [] { return mc::promoted_index_cache::shard_stats().evictions; },
+            sm::description("Number of partitions evicted from the promoted index cache shared by readers")),
+        sm::make_gauge("pi_shared_cache_bytes", [] { return mc::promoted_index_cache::shard_stats().used_bytes; },
+            sm::description("Number of bytes used by the promoted index cache shared by readers")),
+
         sm::make_counter("partition_writes", [] { return sstables_stats::get_shard_stats().partition_writes; },
             sm::description("Number of partitions written")),
         sm::make_counter("static_row_writes", [] { return sstables_stats::get_shard_stats().static_row_writes; },
@@ -3194,6 +3301,8 @@ sstable::sstable(schema_ptr schema,
     , _format(f)
     , _index_cache(std::make_unique<partition_index_cache>(
             manager.get_cache_tracker().get_lru(), manager.get_cache_tracker().region()))
+    , _promoted_index_cache(std::make_unique<mc::promoted_index_cache>(
+            manager.get_cache_tracker().get_lru(), manager.get_cache_tracker().region()))
     , _now(now)
     , _read_error_handler(error_handler_gen(sstable_read_error))
     , _write_error_handler(error_handler_gen(sstable_write_error))
@@ -3217,8 +3326,11 @@ void sstable::unused() {
 }
 
 future<> sstable::destroy() {
+    _manager.release_summary_memory(std::exchange(_summary_memory, 0));
     return close_files().finally([this] {
         return _index_cache->evict_gently().then([this] {
+            return _promoted_index_cache->evict_gently();
+        }).then([this] {
             if (_cached_index_file) {
                 return _cached_index_file->evict_gently();
             } else {
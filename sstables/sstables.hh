@@ -17,6 +17,7 @@
 #include <seastar/core/sstring.hh>
 #include <seastar/core/enum.hh>
 #include <seastar/core/shared_ptr.hh>
+#include <seastar/core/shared_future.hh>
 #include <unordered_set>
 #include <unordered_map>
 #include <variant>
@@ -31,6 +32,7 @@
 #include "component_type.hh"
 #include "column_translation.hh"
 #include "stats.hh"
+#include "sstables/read_ahead.hh"
 #include "utils/observable.hh"
 #include "sstables/shareable_components.hh"
 #include "sstables/generation_type.hh"
@@ -55,6 +57,7 @@ extern thread_local utils::updateable_value<bool> global_cache_index_pages;
 
 namespace mc {
 class writer;
+class promoted_index_cache;
 }
 
 namespace mx {
@@ -108,6 +111,8 @@ struct sstable_writer_config {
     run_id run_identifier = run_id::create_random_id();
     size_t summary_byte_cost;
     sstring origin;
+    // Write the bloom filter as a split block bloom filter.
+    bool split_block_filter = false;
 
 private:
     explicit sstable_writer_config() {}
@@ -137,6 +142,9 @@ struct sstable_open_config {
     // false if you want to disable this, to be able to read such sstables.
     // Should only be disabled for diagnostics purposes.
     bool load_first_and_last_position_metadata = true;
+    // Leave the Filter on disk until the first lookup of a key, which starts
+    // loading it in the background. Keys are considered present until then.
+    bool load_filter_lazily = false;
 };
 
 class sstable : public enable_lw_shared_from_this<sstable> {
@@ -372,6 +380,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return filename(component_type::Index);
     }
 
+    // Path of the component of the given name, as listed by all_components().
+    sstring component_filename(sstring component) const {
+        return filename(_storage.prefix(), _schema->ks_name(), _schema->cf_name(), _version, _generation, _format, std::move(component));
+    }
+
     static sstring sst_dir_basename(generation_type gen) {
         return fmt::format("{}.sstable", gen);
     }
@@ -543,9 +556,14 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     run_id _run_identifier;
     utils::observable<sstable&> _on_closed;
 
-    lw_shared_ptr<file_input_stream_history> _single_partition_history = make_lw_shared<file_input_stream_history>();
-    lw_shared_ptr<file_input_stream_history> _partition_range_history = make_lw_shared<file_input_stream_history>();
     lw_shared_ptr<file_input_stream_history> _index_history = make_lw_shared<file_input_stream_history>();
+    // The Filter is yet to be loaded, see sstable_open_config::load_filter_lazily.
+    mutable bool _filter_on_disk = false;
+    std::optional<shared_future<>> _filter_loading;
+    // Accounts the reads of the data file, shared by the sstables of a table.
+    lw_shared_ptr<data_read_stats> _data_read_stats;
+    // Memory of the summary accounted in the manager.
+    uint64_t _summary_memory = 0;
 
     schema_ptr _schema;
     generation_type _generation{0};
@@ -557,6 +575,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     filter_tracker _filter_tracker;
     std::unique_ptr<partition_index_cache> _index_cache;
+    std::unique_ptr<mc::promoted_index_cache> _promoted_index_cache;
 
     enum class mark_for_deletion {
         implicit = -1,
@@ -619,6 +638,14 @@ class sstable : public enable_lw_shared_from_this<sstable> {
             std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin);
 
     future<> read_filter(const io_priority_class& pc);
+    void maybe_load_filter() const noexcept {
+        if (_filter_on_disk) [[unlikely]] {
+            load_filter_in_background();
+        }
+    }
+    void load_filter_in_background() const noexcept;
+    // Loads the Filter, if it was left on disk by load().
+    future<> ensure_filter_is_loaded();
 
     void write_filter(const io_priority_class& pc);
 
@@ -632,6 +659,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // happen if old tools are being used.
     future<> generate_summary(const io_priority_class& pc);
 
+    // Thins the summary if it doesn't fit in the summary memory left on
+    // this shard, and accounts its memory.
+    future<> fit_summary_in_memory();
+
     future<> read_statistics(const io_priority_class& pc);
     void write_statistics(const io_priority_class& pc);
     // Rewrite statistics component by creating a temporary Statistics and
@@ -676,13 +707,14 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // data incrementally as a stream. Knowing in advance the exact amount
     // of bytes to be read using this stream, we can make better choices
     // about the buffer size to read, and where exactly to stop reading
-    // (even when a large buffer size is used).
+    // (even when a large buffer size is used). The size of reads adapts
+    // to how the stream is consumed, see make_adaptive_file_input_stream().
     //
     // When created with `raw_stream::yes`, the sstable data file will be
     // streamed as-is, without decompressing (if compressed).
     using raw_stream = bool_class<class raw_stream_tag>;
     input_stream<char> data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-            reader_permit permit, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history, raw_stream raw = raw_stream::no);
+            reader_permit permit, tracing::trace_state_ptr trace_state, raw_stream raw = raw_stream::no);
 
     // Read exactly the specific byte range from the data file (after
     // uncompression, if the file is compressed). This can be used to read
@@ -762,6 +794,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     }
 
     bool filter_has_key(const key& key) const {
+        maybe_load_filter();
         return _components->filter->is_present(bytes_view(key));
     }
 
@@ -774,9 +807,14 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     future<bool> has_partition_key(const utils::hashed_key& hk, const dht::decorated_key& dk);
 
     bool filter_has_key(utils::hashed_key key) const {
+        maybe_load_filter();
         return _components->filter->is_present(key);
     }
 
+    void prefetch_filter(utils::hashed_key key) const {
+        _components->filter->prefetch(key);
+    }
+
     bool filter_has_key(const schema& s, partition_key_view key) const {
         return filter_has_key(key::from_partition_key(s, key));
     }
@@ -851,6 +889,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // This will change sstable level only in memory.
     void set_sstable_level(uint32_t);
 
+    // Reads of the data file are accounted in stats from now on.
+    void set_data_read_stats(lw_shared_ptr<data_read_stats> stats) noexcept {
+        _data_read_stats = std::move(stats);
+    }
+
     void generate_new_run_identifier() {
         _run_identifier = run_id::create_random_id();
     }
@@ -9,6 +9,7 @@
 #include "log.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/partition_index_cache.hh"
+#include "sstables/mx/promoted_index_cache.hh"
 #include "sstables/sstables.hh"
 #include "db/config.hh"
 #include "gms/feature.hh"
@@ -65,6 +66,7 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
             ? mutation_fragment_stream_validation_level::clustering_key
             : mutation_fragment_stream_validation_level::token;
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
+    cfg.split_block_filter = _db_config.enable_sstables_split_block_filter();
 
     cfg.origin = std::move(origin);
 
@@ -94,6 +96,14 @@ void sstables_manager::remove(sstable* sst) {
     maybe_done();
 }
 
+uint64_t sstables_manager::summary_memory_capacity() const noexcept {
+    auto capacity_in_mb = _db_config.index_summary_capacity_in_mb();
+    if (!capacity_in_mb) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return (uint64_t(capacity_in_mb) << 20) / smp::count;
+}
+
 void sstables_manager::maybe_done() {
     if (_closing && _active.empty() && _undergoing_close.empty()) {
         _done.set_value();
@@ -71,6 +71,9 @@ class sstables_manager {
 
     reader_concurrency_semaphore _sstable_metadata_concurrency_sem;
     directory_semaphore& _dir_semaphore;
+
+    // Memory used by the summaries of the sstables opened on this shard.
+    uint64_t _summary_memory = 0;
 public:
     explicit sstables_manager(db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker&, size_t available_memory, directory_semaphore& dir_sem);
     virtual ~sstables_manager();
@@ -108,6 +111,11 @@ class sstables_manager {
     // sstables have been destroyed.
     future<> close();
     directory_semaphore& dir_semaphore() noexcept { return _dir_semaphore; }
+
+    // Memory the summaries of the sstables of this shard may use,
+    // see index_summary_capacity_in_mb.
+    uint64_t summary_memory_capacity() const noexcept;
+    uint64_t summary_memory_used() const noexcept { return _summary_memory; }
 private:
     void add(sstable* sst);
     // Transition the sstable to the "inactive" state. It has no
@@ -117,6 +125,9 @@ class sstables_manager {
     void remove(sstable* sst);
     void maybe_done();
 
+    void account_summary_memory(uint64_t size) noexcept { _summary_memory += size; }
+    void release_summary_memory(uint64_t size) noexcept { _summary_memory -= size; }
+
     static constexpr size_t max_count_sstable_metadata_concurrent_reads{10};
     // Allow at most 10% of memory to be filled with such reads.
     size_t max_memory_sstable_metadata_concurrent_reads(size_t available_memory) { return available_memory * 0.1; }
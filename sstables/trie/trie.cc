@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+
+#include "sstables/trie/trie.hh"
+
+namespace sstables::trie {
+
+bytes byte_comparable(const dht::token& t) {
+    bytes b(bytes::initialized_later(), sizeof(uint64_t));
+    // Flipping the sign bit makes the unsigned big-endian representation order like the signed token.
+    write_be<uint64_t>(reinterpret_cast<char*>(b.begin()), uint64_t(t.raw()) ^ (uint64_t(1) << 63));
+    return b;
+}
+
+bytes byte_comparable(const dht::decorated_key& dk) {
+    auto token = byte_comparable(dk.token());
+    auto key = to_bytes(dk.key().representation());
+    bytes b(bytes::initialized_later(), token.size() + key.size());
+    std::copy(key.begin(), key.end(), std::copy(token.begin(), token.end(), b.begin()));
+    return b;
+}
+
+uint64_t trie_reader::node::child_pos(size_t idx) const {
+    auto* p = buf.get() + header_size + children + idx * width_of(width_code);
+    uint64_t distance;
+    switch (width_code) {
+    case 0: distance = uint8_t(*p); break;
+    case 1: distance = read_be<uint16_t>(p); break;
+    case 2: distance = read_be<uint32_t>(p); break;
+    default: distance = read_be<uint64_t>(p); break;
+    }
+    if (distance == 0 || distance > this->pos) {
+        throw malformed_sstable_exception(format("trie node at {} has invalid child distance {}", this->pos, distance));
+    }
+    return this->pos - distance;
+}
+
+size_t trie_reader::node::lower_bound(uint8_t b) const {
+    auto* first = reinterpret_cast<const uint8_t*>(buf.get() + header_size);
+    return std::lower_bound(first, first + children, b) - first;
+}
+
+future<trie_reader::node> trie_reader::read_node(uint64_t pos) const {
+    // Nodes never cross page boundaries, so the whole node is in the remainder of the page.
+    if (pos >= _size) {
+        throw malformed_sstable_exception(format("trie node at {} is out of bounds of trie of size {}", pos, _size));
+    }
+    auto len = std::min({max_node_size, page_size - pos % page_size, _size - pos});
+    auto buf = co_await _file.dma_read<char>(pos, len, _pc);
+    if (buf.size() < header_size) {
+        throw malformed_sstable_exception(format("trie node at {} is truncated", pos));
+    }
+    auto width_code = uint8_t(buf[0]) & width_mask;
+    size_t children = read_be<uint16_t>(buf.get() + 1);
+    auto has_payload = uint8_t(buf[0]) & payload_flag;
+    if (children > 256 || buf.size() < node_size(children, width_code, has_payload)) {
+        throw malformed_sstable_exception(format("trie node at {} is malformed: {} children, {} bytes available", pos, children, buf.size()));
+    }
+    co_return node{pos, std::move(buf), width_code, children};
+}
+
+future<uint64_t> trie_reader::edge_payload(node n, bool rightmost) const {
+    while (true) {
+        // A key is smaller than all of its extensions, so the leftmost key stops at the first payload.
+        if (n.has_payload() && (!rightmost || n.children == 0)) {
+            co_return n.payload();
+        }
+        if (n.children == 0) {
+            throw malformed_sstable_exception(format("trie leaf node at {} has no payload", n.pos));
+        }
+        n = co_await read_node(n.child_pos(rightmost ? n.children - 1 : 0));
+    }
+}
+
+future<std::optional<uint64_t>> trie_reader::search(bytes_view key, int direction) const {
+    struct candidate {
+        uint64_t value;
+        // If set, value is the position of a subtree whose edge key is the candidate,
+        // otherwise it's the payload of the candidate itself.
+        bool subtree;
+    };
+    // The deepest candidate is always the best one, as it shares the longest prefix with key.
+    std::optional<candidate> best;
+
+    auto n = co_await read_node(_root);
+    for (size_t depth = 0; ; ++depth) {
+        if (depth == key.size()) {
+            if (n.has_payload()) {
+                co_return n.payload();
+            }
+            // All keys in this subtree are extensions of key, hence greater than it.
+            if (direction > 0) {
+                co_return co_await edge_payload(std::move(n), false);
+            }
+            break;
+        }
+        auto b = uint8_t(key[depth]);
+        auto idx = n.lower_bound(b);
+        auto found = idx < n.children && n.transition(idx) == b;
+        if (direction < 0) {
+            if (idx > 0) {
+                best = candidate{n.child_pos(idx - 1), true};
+            } else if (n.has_payload()) {
+                best = candidate{n.payload(), false};
+            }
+        } else if (direction > 0) {
+            auto right = found ? idx + 1 : idx;
+            if (right < n.children) {
+                best = candidate{n.child_pos(right), true};
+            }
+        }
+        if (!found) {
+            break;
+        }
+        n = co_await read_node(n.child_pos(idx));
+    }
+
+    if (!best) {
+        co_return std::nullopt;
+    }
+    if (!best->subtree) {
+        co_return best->value;
+    }
+    co_return co_await edge_payload(co_await read_node(best->value), direction < 0);
+}
+
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+// Byte-comparable on-disk trie, a building block for trie-based (BTI-like)
+// partition and row indexes.
+//
+// A trie maps byte-comparable keys to 64-bit payloads (typically positions in
+// the data or row index file). It is written in a single pass from keys sorted
+// in lexicographical byte order, and can be queried for an exact match, or for
+// the greatest key which is smaller than or equal to (floor) / the smallest key
+// which is greater than or equal to (ceiling) a given key, one node at a time.
+//
+// On-disk node layout (all integers are big-endian):
+//
+//   u8       header: bits 0-1 = width of child distances (1, 2, 4 or 8 bytes),
+//                    bit 2 = node has a payload
+//   u16      number of children (N), 0..256
+//   u8[N]    transition bytes, in increasing order
+//   uW[N]    distance from the start of this node back to the start of each child
+//   u64      payload, if present
+//
+// Nodes are written in post-order, so every child precedes its parent and the
+// root is the last node in the trie. A node never crosses a page boundary, so
+// every step of a lookup reads at most one page, and the upper levels of the
+// trie, which are shared by all lookups, stay hot in the page cache.
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <concepts>
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/file.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include "bytes.hh"
+#include "dht/i_partitioner.hh"
+#include "sstables/exceptions.hh"
+#include "utils/small_vector.hh"
+#include "seastarx.hh"
+
+namespace sstables::trie {
+
+constexpr size_t page_size = 4096;
+constexpr uint8_t width_mask = 0x3;
+constexpr uint8_t payload_flag = 0x4;
+constexpr size_t header_size = 1 + 2;
+constexpr size_t max_node_size = header_size + 256 + 256 * sizeof(uint64_t) + sizeof(uint64_t);
+
+static_assert(max_node_size <= page_size);
+
+// Returns the smallest width code (0: 1 byte, 1: 2 bytes, 2: 4 bytes, 3: 8 bytes) which can represent v.
+inline uint8_t width_code_for(uint64_t v) noexcept {
+    if (v <= std::numeric_limits<uint8_t>::max()) {
+        return 0;
+    } else if (v <= std::numeric_limits<uint16_t>::max()) {
+        return 1;
+    } else if (v <= std::numeric_limits<uint32_t>::max()) {
+        return 2;
+    }
+    return 3;
+}
+
+inline size_t width_of(uint8_t width_code) noexcept {
+    return size_t(1) << width_code;
+}
+
+inline size_t node_size(size_t children, uint8_t width_code, bool has_payload) noexcept {
+    return header_size + children * (1 + width_of(width_code)) + (has_payload ? sizeof(uint64_t) : 0);
+}
+
+// Encodes a decorated key such that the lexicographical order of the encoded
+// keys matches the ring order: the token, as a big-endian integer with its sign
+// bit flipped, followed by the serialized partition key.
+bytes byte_comparable(const dht::decorated_key& dk);
+
+// Encodes a token, such that it's a prefix of byte_comparable() of all keys owning it.
+bytes byte_comparable(const dht::token& t);
+
+template <typename Output>
+concept TrieOutput = requires (Output& out, const char* buf, size_t n) {
+    out.write(buf, n);
+    { out.offset() } -> std::convertible_to<uint64_t>;
+};
+
+// Builds a trie from keys added in strictly increasing lexicographical order.
+//
+// Memory usage is proportional to the length of the longest key, as nodes are
+// written as soon as no more children can be added to them.
+template <TrieOutput Output>
+class trie_writer {
+    struct pending_node {
+        // transition byte and offset of children which were already written
+        utils::small_vector<std::pair<uint8_t, uint64_t>, 4> children;
+        std::optional<uint64_t> payload;
+    };
+    Output& _out;
+    // _stack[i] is the node reached by the first i bytes of _last_key
+    std::vector<pending_node> _stack;
+    bytes _last_key;
+    bool _empty = true;
+private:
+    void pad_to(uint64_t pos) {
+        static const std::array<char, page_size> zeros{};
+        auto n = pos - _out.offset();
+        _out.write(zeros.data(), n);
+    }
+
+    uint64_t write_node(const pending_node& node) {
+        auto pos = uint64_t(_out.offset());
+        auto min_child = node.children.empty() ? pos : node.children.front().second;
+        auto width_code = width_code_for(pos - min_child);
+        auto size = node_size(node.children.size(), width_code, bool(node.payload));
+        if (pos / page_size != (pos + size - 1) / page_size) {
+            // Move the node to the beginning of next page, so it doesn't cross a page boundary.
+            pos = (pos / page_size + 1) * page_size;
+            width_code = width_code_for(pos - min_child);
+            size = node_size(node.children.size(), width_code, bool(node.payload));
+            pad_to(pos);
+        }
+
+        std::array<char, max_node_size> buf;
+        auto* p = buf.data();
+        *p++ = width_code | (node.payload ? payload_flag : 0);
+        write_be<uint16_t>(p, node.children.size());
+        p += sizeof(uint16_t);
+        for (auto& [transition, offset] : node.children) {
+            *p++ = char(transition);
+        }
+        for (auto& [transition, offset] : node.children) {
+            auto distance = pos - offset;
+            switch (width_code) {
+            case 0: *p = uint8_t(distance); break;
+            case 1: write_be<uint16_t>(p, distance); break;
+            case 2: write_be<uint32_t>(p, distance); break;
+            default: write_be<uint64_t>(p, distance); break;
+            }
+            p += width_of(width_code);
+        }
+        if (node.payload) {
+            write_be<uint64_t>(p, *node.payload);
+            p += sizeof(uint64_t);
+        }
+        _out.write(buf.data(), size);
+        return pos;
+    }
+
+    // Writes all nodes of the current path deeper than depth.
+    void complete_until(size_t depth) {
+        while (_stack.size() > depth + 1) {
+            auto offset = write_node(_stack.back());
+            _stack.pop_back();
+            _stack.back().children.emplace_back(uint8_t(_last_key[_stack.size() - 1]), offset);
+        }
+    }
+public:
+    explicit trie_writer(Output& out)
+        : _out(out)
+        , _stack(1)
+    {}
+
+    void add(bytes_view key, uint64_t payload) {
+        auto mismatch = std::mismatch(key.begin(), key.end(), _last_key.begin(), _last_key.end());
+        auto common_prefix = size_t(std::distance(key.begin(), mismatch.first));
+        if (!_empty && (mismatch.first == key.end() || (mismatch.second != _last_key.end() && uint8_t(*mismatch.first) < uint8_t(*mismatch.second)))) {
+            throw std::invalid_argument("trie_writer: keys must be added in strictly increasing order");
+        }
+        complete_until(common_prefix);
+        _stack.resize(key.size() + 1);
+        _stack.back().payload = payload;
+        _last_key = bytes(key);
+        _empty = false;
+    }
+
+    // Writes the remaining nodes. Returns the position of the root node, which
+    // must be stored by the caller, or std::nullopt if no key was added.
+    std::optional<uint64_t> finish() {
+        if (_empty) {
+            return std::nullopt;
+        }
+        complete_until(0);
+        auto root = write_node(_stack.back());
+        _stack.clear();
+        return root;
+    }
+};
+
+// Reads a trie written by trie_writer. The file is expected to be backed by
+// the page cache (see make_cached_seastar_file()), as lookups read one node at a time.
+class trie_reader {
+    file _file;
+    uint64_t _size;
+    uint64_t _root;
+    const io_priority_class& _pc;
+
+    struct node {
+        uint64_t pos;
+        temporary_buffer<char> buf;
+        uint8_t width_code;
+        size_t children;
+
+        bool has_payload() const {
+            return uint8_t(buf[0]) & payload_flag;
+        }
+        uint64_t payload() const {
+            return read_be<uint64_t>(buf.get() + header_size + children * (1 + width_of(width_code)));
+        }
+        uint8_t transition(size_t idx) const {
+            return uint8_t(buf[header_size + idx]);
+        }
+        uint64_t child_pos(size_t idx) const;
+        // Returns the index of the first child whose transition is not smaller than b.
+        size_t lower_bound(uint8_t b) const;
+    };
+
+    future<node> read_node(uint64_t pos) const;
+    // Returns the payload of the smallest (leftmost) or greatest (rightmost) key in the subtree rooted at n.
+    future<uint64_t> edge_payload(node n, bool rightmost) const;
+    future<std::optional<uint64_t>> search(bytes_view key, int direction) const;
+public:
+    // size is the position of the end of the trie in f, which must not be read past.
+    trie_reader(file f, uint64_t size, uint64_t root, const io_priority_class& pc)
+        : _file(std::move(f))
+        , _size(size)
+        , _root(root)
+        , _pc(pc)
+    {}
+
+    // The key must be kept alive until the returned future resolves.
+
+    // Returns the payload associated with key, if present.
+    future<std::optional<uint64_t>> find(bytes_view key) const {
+        return search(key, 0);
+    }
+
+    // Returns the payload of the greatest key which is smaller than or equal to key, if any.
+    future<std::optional<uint64_t>> find_floor(bytes_view key) const {
+        return search(key, -1);
+    }
+
+    // Returns the payload of the smallest key which is greater than or equal to key, if any.
+    future<std::optional<uint64_t>> find_ceiling(bytes_view key) const {
+        return search(key, 1);
+    }
+};
+
+}
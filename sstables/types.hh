@@ -173,6 +173,12 @@ struct summary_ka {
     disk_string<uint32_t> first_key;
     disk_string<uint32_t> last_key;
 
+    // Number of on-disk entries each of the entries above stands for. It is
+    // greater than 1 when only every n-th entry was kept in memory, in which
+    // case an index page spans the pages of all the entries it stands for.
+    // Not part of the on-disk format.
+    uint32_t page_factor = 1;
+
     // NOTE4: There is a structure written by Cassandra into the end of the Summary
     // file, after the field last_key, that we haven't understand yet, but we know
     // that its content isn't related to the summary itself.
@@ -19,6 +19,8 @@
 #include "readers/mutation_fragment_v1_stream.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "message/messaging_service.hh"
+#include "service/priority_manager.hh"
+#include "utils/fb_utilities.hh"
 
 #include <cfloat>
 
@@ -114,6 +116,59 @@ class send_meta_data {
 
 } // anonymous namespace
 
+// Streaming an sstable whose data all goes to this shard would only parse
+// and rewrite it, so such sstables are moved into the table as they are,
+// after their checksums are verified. This is the case when this node is
+// the only replica of the whole token range of the sstable, or its primary
+// replica if only primary replicas are streamed to, and this shard owns the
+// range. Tables with views are left to streaming, which generates the view
+// updates.
+future<std::vector<sstables::shared_sstable>> sstables_loader::load_owned_sstables(replica::table& table,
+        const locator::effective_replication_map& erm, std::vector<sstables::shared_sstable> sstables,
+        bool primary_replica_only) {
+    if (!table.views().empty() || (!primary_replica_only && erm.get_replication_factor() != 1)) {
+        co_return sstables;
+    }
+    auto local = utils::fb_utilities::get_broadcast_address();
+    auto owned_ranges = dht::token_range::deoverlap(
+            primary_replica_only ? erm.get_primary_ranges(local) : erm.get_ranges(local), dht::token_comparator());
+    auto is_owned = [&] (const sstables::shared_sstable& sst) {
+        auto& shards = sst->get_shards_for_this_sstable();
+        if (shards.size() != 1 || shards.front() != this_shard_id()) {
+            return false;
+        }
+        auto range = dht::token_range::make(sst->get_first_decorated_key().token(), sst->get_last_decorated_key().token());
+        return std::ranges::any_of(owned_ranges, [&] (const dht::token_range& owned) {
+            return owned.contains(range, dht::token_comparator());
+        });
+    };
+    auto it = std::partition(sstables.begin(), sstables.end(), std::not_fn(is_owned));
+    std::vector<sstables::shared_sstable> owned(std::make_move_iterator(it), std::make_move_iterator(sstables.end()));
+    sstables.erase(it, sstables.end());
+    if (owned.empty()) {
+        co_return sstables;
+    }
+
+    auto& pc = service::get_local_streaming_priority();
+    for (auto& sst : owned) {
+        auto permit = co_await _db.local().obtain_reader_permit(table, "sstables_loader::load_owned_sstables()", db::no_timeout);
+        if (!co_await sstables::validate_checksums(sst, std::move(permit), pc)) {
+            throw std::runtime_error(format("load_and_stream: checksum validation of sstable {} failed", sst->get_filename()));
+        }
+    }
+    for (auto& sst : owned) {
+        auto gen = table.calculate_generation_for_new_table();
+        llog.debug("load_and_stream: loading {} into {}, new generation {}", sst->get_filename(), table.dir(), gen);
+        co_await sst->move_to_new_dir(table.dir(), gen);
+        // It may overlap with existing sstables on higher levels.
+        sst->set_sstable_level(0);
+    }
+    co_await table.add_sstables_and_update_cache(owned);
+    llog.info("load_and_stream: ks={}, table={}, loaded {} sstables owned by this shard without streaming",
+            table.schema()->ks_name(), table.schema()->cf_name(), owned.size());
+    co_return sstables;
+}
+
 future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
         ::table_id table_id, std::vector<sstables::shared_sstable> sstables, bool primary_replica_only) {
     const auto full_partition_range = dht::partition_range::make_open_ended_both_sides();
@@ -124,6 +179,8 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
     const auto reason = streaming::stream_reason::repair;
     auto erm = _db.local().find_keyspace(ks_name).get_effective_replication_map();
 
+    sstables = co_await load_owned_sstables(table, *erm, std::move(sstables), primary_replica_only);
+
     size_t nr_sst_total = sstables.size();
     size_t nr_sst_current = 0;
     while (!sstables.empty()) {
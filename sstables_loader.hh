@@ -16,6 +16,11 @@ using namespace seastar;
 
 namespace replica {
 class database;
+class table;
+}
+
+namespace locator {
+class effective_replication_map;
 }
 
 namespace netw { class messaging_service; }
@@ -48,6 +53,12 @@ class sstables_loader : public seastar::peering_sharded_service<sstables_loader>
             table_id, std::vector<sstables::shared_sstable> sstables,
             bool primary_replica_only);
 
+    // Loads the sstables which would be streamed to this shard only right
+    // away, and returns the others.
+    future<std::vector<sstables::shared_sstable>> load_owned_sstables(replica::table& table,
+            const locator::effective_replication_map& erm, std::vector<sstables::shared_sstable> sstables,
+            bool primary_replica_only);
+
 public:
     sstables_loader(sharded<replica::database>& db,
             sharded<db::system_distributed_keyspace>& sys_dist_ks,
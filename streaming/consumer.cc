@@ -18,14 +18,24 @@
 
 namespace streaming {
 
+future<> add_streamed_sstable(lw_shared_ptr<replica::table> cf, sstables::shared_sstable sst,
+        db::view::view_update_generator& vug, bool use_view_update_path) {
+    sstables::sstlog.debug("Enabled automatic off-strategy trigger for table {}.{}",
+            cf->schema()->ks_name(), cf->schema()->cf_name());
+    cf->enable_off_strategy_trigger();
+    co_await cf->add_sstable_and_update_cache(sst, sstables::offstrategy::yes);
+    if (use_view_update_path) {
+        co_await vug.register_staging_sstable(sst, std::move(cf));
+    }
+}
+
 std::function<future<> (flat_mutation_reader_v2)> make_streaming_consumer(sstring origin,
         sharded<replica::database>& db,
         sharded<db::system_distributed_keyspace>& sys_dist_ks,
         sharded<db::view::view_update_generator>& vug,
         uint64_t estimated_partitions,
-        stream_reason reason,
-        sstables::offstrategy offstrategy) {
-    return [&db, &sys_dist_ks, &vug, estimated_partitions, reason, offstrategy, origin = std::move(origin)] (flat_mutation_reader_v2 reader) -> future<> {
+        stream_reason reason) {
+    return [&db, &sys_dist_ks, &vug, estimated_partitions, reason, origin = std::move(origin)] (flat_mutation_reader_v2 reader) -> future<> {
         std::exception_ptr ex;
         try {
             auto cf = db.local().find_column_family(reader.schema()).shared_from_this();
@@ -34,16 +44,9 @@ std::function<future<> (flat_mutation_reader_v2)> make_streaming_consumer(sstrin
             auto metadata = mutation_source_metadata{};
             auto& cs = cf->get_compaction_strategy();
             const auto adjusted_estimated_partitions = cs.adjust_partition_estimate(metadata, estimated_partitions);
-            auto make_interposer_consumer = [&cs, offstrategy] (const mutation_source_metadata& ms_meta, reader_consumer_v2 end_consumer) mutable {
-                // postpone data segregation to off-strategy compaction if enabled
-                if (offstrategy) {
-                    return end_consumer;
-                }
-                return cs.make_interposer_consumer(ms_meta, std::move(end_consumer));
-            };
 
-            auto consumer = make_interposer_consumer(metadata,
-                    [cf = std::move(cf), adjusted_estimated_partitions, use_view_update_path, &vug, origin = std::move(origin), offstrategy, reason] (flat_mutation_reader_v2 reader) {
+            // Data segregation is postponed to off-strategy compaction.
+            auto consumer = [cf = std::move(cf), adjusted_estimated_partitions, use_view_update_path, &vug, origin = std::move(origin)] (flat_mutation_reader_v2 reader) {
                 sstables::shared_sstable sst;
                 try {
                     sst = use_view_update_path ? cf->make_streaming_staging_sstable() : cf->make_streaming_sstable_for_write();
@@ -59,20 +62,10 @@ std::function<future<> (flat_mutation_reader_v2)> make_streaming_consumer(sstrin
                                              cf->get_sstables_manager().configure_writer(origin),
                                              encoding_stats{}, pc).then([sst] {
                     return sst->open_data();
-                }).then([cf, sst, offstrategy, reason, origin] {
-                    if (offstrategy && sstables::repair_origin == origin) {
-                        sstables::sstlog.debug("Enabled automatic off-strategy trigger for table {}.{}",
-                                cf->schema()->ks_name(), cf->schema()->cf_name());
-                        cf->enable_off_strategy_trigger();
-                    }
-                    return cf->add_sstable_and_update_cache(sst, offstrategy);
-                }).then([cf, s, sst, use_view_update_path, &vug]() mutable -> future<> {
-                    if (!use_view_update_path) {
-                        return make_ready_future<>();
-                    }
-                    return vug.local().register_staging_sstable(sst, std::move(cf));
+                }).then([cf, sst, use_view_update_path, &vug] () mutable {
+                    return add_streamed_sstable(std::move(cf), std::move(sst), vug.local(), use_view_update_path);
                 });
-            });
+            };
             co_return co_await consumer(std::move(reader));
         } catch (...) {
             ex = std::current_exception();
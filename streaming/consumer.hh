@@ -11,6 +11,7 @@
 
 namespace replica {
 class database;
+class table;
 }
 
 namespace db {
@@ -22,12 +23,22 @@ class view_update_generator;
 
 namespace streaming {
 
+// Streamed data bypasses the memtables, whatever the reason of the stream. It is
+// written to sstables on the shard which owns it, and the sstables are added to
+// the maintenance set of the table, to be integrated into the main set by
+// off-strategy compaction. The sstables of tables which need view updates
+// are written to the staging directory, and the view_update_generator makes the
+// view updates from them.
 std::function<future<>(flat_mutation_reader_v2)> make_streaming_consumer(sstring origin,
     sharded<replica::database>& db,
     sharded<db::system_distributed_keyspace>& sys_dist_ks,
     sharded<db::view::view_update_generator>& vug,
     uint64_t estimated_partitions,
-    stream_reason reason,
-    sstables::offstrategy offstrategy);
+    stream_reason reason);
+
+// Adds an sstable written by streaming to the maintenance set of the table,
+// and arms the off-strategy compaction trigger of the table.
+future<> add_streamed_sstable(lw_shared_ptr<replica::table> cf, sstables::shared_sstable sst,
+    db::view::view_update_generator& vug, bool use_view_update_path);
 
 }
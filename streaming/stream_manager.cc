@@ -60,6 +60,16 @@ stream_manager::stream_manager(db::config& cfg,
         sm::make_counter("total_outgoing_bytes", [this] { return _total_outgoing_bytes; },
                         sm::description("Total number of bytes sent on this shard.")),
 
+        sm::make_gauge("active_outgoing_streams", [this] { return _stream_stats.active_outgoing_streams; },
+                        sm::description("Number of streams of mutation fragments this shard is sending.")),
+
+        sm::make_gauge("active_incoming_streams", [this] { return _stream_stats.active_incoming_streams; },
+                        sm::description("Number of streams of mutation fragments this shard is receiving.")),
+
+        sm::make_counter("outgoing_stream_wait_us", [this] { return _stream_stats.outgoing_stream_wait_us; },
+                        sm::description("Total time the streams sent by this shard waited for their peers to accept more data, in microseconds. "
+                                        "It grows when the receivers, rather than the reads on this shard, hold back streaming.")),
+
         sm::make_gauge("finished_percentage", [this] { return _finished_percentage[streaming::stream_reason::bootstrap]; },
                 sm::description("Finished percentage of node operation on this shard"), {ops_label_type("bootstrap")}),
 
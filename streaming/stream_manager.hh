@@ -95,6 +95,16 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     std::unordered_map<plan_id, std::unordered_map<gms::inet_address, stream_bytes>> _stream_bytes;
     uint64_t _total_incoming_bytes{0};
     uint64_t _total_outgoing_bytes{0};
+public:
+    // The streams of mutation fragments of this shard.
+    struct stream_stats {
+        uint64_t active_outgoing_streams = 0;
+        uint64_t active_incoming_streams = 0;
+        // Time the outgoing streams waited for the peers to accept more data.
+        uint64_t outgoing_stream_wait_us = 0;
+    };
+private:
+    stream_stats _stream_stats;
     semaphore _mutation_send_limiter{256};
     seastar::metrics::metric_groups _metrics;
     std::unordered_map<streaming::stream_reason, float> _finished_percentage;
@@ -147,6 +157,7 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     }
 
     void update_progress(streaming::plan_id plan_id, gms::inet_address peer, progress_info::direction dir, size_t fm_size);
+    stream_stats& get_stream_stats() noexcept { return _stream_stats; }
     future<> update_all_progress_info();
 
     void remove_progress(streaming::plan_id plan_id);
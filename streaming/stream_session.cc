@@ -31,28 +31,26 @@
 #include "db/view/view_update_checks.hh"
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/adaptor/reversed.hpp>
 #include "../db/view/view_update_generator.hh"
 #include "mutation_source_metadata.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "consumer.hh"
 #include "readers/generating_v2.hh"
+#include "sstables/sstables.hh"
+#include "sstables/sstables_manager.hh"
+#include "sstables/sstable_version.hh"
+#include "checked-file-impl.hh"
+#include "utils/disk-error-handler.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
 
 namespace streaming {
 
 logging::logger sslog("stream_session");
 
-static sstables::offstrategy is_offstrategy_supported(streaming::stream_reason reason) {
-    static const std::unordered_set<streaming::stream_reason> operations_supported = {
-        streaming::stream_reason::bootstrap,
-        streaming::stream_reason::replace,
-        streaming::stream_reason::removenode,
-        streaming::stream_reason::decommission,
-        streaming::stream_reason::repair,
-        streaming::stream_reason::rebuild,
-    };
-    return sstables::offstrategy(operations_supported.contains(reason));
-}
-
 class offstrategy_trigger {
     sharded<replica::database>& _db;
     table_id _id;
@@ -86,6 +84,137 @@ class offstrategy_trigger {
     }
 };
 
+static constexpr size_t sstable_file_write_buffer_size = 128 * 1024;
+
+// Writes the components of an sstable sent with STREAM_SSTABLE_FILES to the
+// directory of the table, or its staging directory when it needs view
+// updates, and adds it to the table on the shard which owns it.
+//
+// The TOC is written as the TemporaryTOC, and renamed when all components
+// were written, so that a crash leaves an sstable which is removed on boot.
+// An sstable which spans several shards of this node is written to them as
+// mutations, and then removed.
+static future<> receive_sstable_files(sharded<stream_manager>& sm, sharded<replica::database>& db,
+        sharded<db::system_distributed_keyspace>& sys_dist_ks, sharded<db::view::view_update_generator>& vug,
+        schema_ptr s, streaming::plan_id plan_id, gms::inet_address from, sstring sstable_version, stream_reason reason,
+        rpc::source<sstring, bytes, stream_sstable_files_cmd> source) {
+    auto cf = db.local().find_column_family(s->id()).shared_from_this();
+    auto version = sstables::from_string(sstable_version);
+    auto format = sstables::sstable_format_types::big;
+    auto use_view_update_path = co_await db::view::check_needs_view_update_path(sys_dist_ks.local(), db.local().get_token_metadata(), *cf, reason);
+    auto dir = cf->dir();
+    if (use_view_update_path) {
+        dir += "/" + sstring(sstables::staging_dir);
+    }
+    auto generation = cf->calculate_generation_for_new_table();
+    auto& component_map = sstables::sstable_version_constants::get_component_map(version);
+    const auto& toc_name = component_map.at(sstables::component_type::TOC);
+    const auto& temporary_toc_name = component_map.at(sstables::component_type::TemporaryTOC);
+    auto component_path = [&] (const sstring& component) {
+        return sstables::sstable::filename(dir, s->ks_name(), s->cf_name(), version, generation, format, component);
+    };
+    auto offstrategy_update = offstrategy_trigger(db, s->id(), plan_id);
+
+    std::unordered_set<sstring> components;
+    std::vector<sstring> written;
+    std::optional<output_stream<char>> out;
+    sstring component;
+    bool got_end_of_stream = false;
+    std::exception_ptr ex;
+    try {
+        file_output_stream_options options;
+        options.buffer_size = sstable_file_write_buffer_size;
+        options.write_behind = 2;
+        options.io_priority_class = service::get_local_streaming_priority();
+        while (auto opt = co_await source()) {
+            auto& [name, data, cmd] = *opt;
+            if (cmd == stream_sstable_files_cmd::error) {
+                throw std::runtime_error("Sender failed");
+            } else if (cmd == stream_sstable_files_cmd::end_of_stream) {
+                got_end_of_stream = true;
+                break;
+            } else if (cmd != stream_sstable_files_cmd::component_data) {
+                throw std::runtime_error("Sender sent wrong cmd");
+            }
+            if (!out || name != component) {
+                if (out) {
+                    co_await out->flush();
+                    co_await out->close();
+                    out.reset();
+                }
+                if (name.empty() || name.find('/') != sstring::npos || name == temporary_toc_name || components.contains(name)) {
+                    throw std::runtime_error(format("Sender sent invalid component {}", name));
+                }
+                if (components.empty() && name != toc_name) {
+                    throw std::runtime_error(format("Sender sent component {} before the TOC", name));
+                }
+                components.insert(name);
+                component = name;
+                auto path = component_path(name == toc_name ? temporary_toc_name : name);
+                written.push_back(path);
+                auto f = co_await open_checked_file_dma(sstable_write_error_handler, path, open_flags::wo | open_flags::create | open_flags::exclusive);
+                out = co_await make_file_output_stream(std::move(f), options);
+            }
+            co_await out->write(reinterpret_cast<const char*>(data.data()), data.size());
+            sm.local().update_progress(plan_id, from, progress_info::direction::IN, data.size());
+            offstrategy_update.update();
+        }
+        if (out) {
+            co_await out->flush();
+            co_await out->close();
+            out.reset();
+        }
+        if (!got_end_of_stream) {
+            throw std::runtime_error("Sender did not send end_of_stream");
+        }
+        if (components.empty()) {
+            throw std::runtime_error("Sender sent no component");
+        }
+        co_await sync_directory(dir);
+        co_await rename_file(component_path(temporary_toc_name), component_path(toc_name));
+        co_await sync_directory(dir);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        if (out) {
+            co_await out->close().handle_exception([] (std::exception_ptr) { });
+        }
+        // The TemporaryTOC goes last, so that what remains after a crash is removed on boot.
+        for (auto& path : boost::adaptors::reverse(written)) {
+            co_await remove_file(path).handle_exception([] (std::exception_ptr) { });
+        }
+        std::rethrow_exception(std::move(ex));
+    }
+
+    auto sst = cf->get_sstables_manager().make_sstable(s, dir, generation, version, format);
+    co_await sst->load();
+    auto shards = sst->get_shards_for_this_sstable();
+    sslog.debug("[Stream #{}] Received sstable {} of ks={}, cf={} from {}, owner_shards={}", plan_id, sst->get_filename(), s->ks_name(), s->cf_name(), from, shards.size());
+    if (shards.size() == 1 && shards[0] == this_shard_id()) {
+        co_await add_streamed_sstable(std::move(cf), std::move(sst), vug.local(), use_view_update_path);
+    } else if (shards.size() == 1) {
+        co_await sst->destroy();
+        sst = {};
+        co_await sm.invoke_on(shards[0], [&db, &vug, id = s->id(), dir, generation, version, format, use_view_update_path] (stream_manager&) -> future<> {
+            auto cf = db.local().find_column_family(id).shared_from_this();
+            auto sst = cf->get_sstables_manager().make_sstable(cf->schema(), dir, generation, version, format);
+            co_await sst->load();
+            co_await add_streamed_sstable(std::move(cf), std::move(sst), vug.local(), use_view_update_path);
+        });
+    } else {
+        auto permit = co_await db.local().obtain_reader_permit(*cf, "stream-sstable-files", db::no_timeout);
+        sst->mark_for_deletion();
+        if (!shards.empty()) {
+            co_await mutation_writer::distribute_reader_and_consume_on_shards(s,
+                    sst->make_reader(s, std::move(permit), query::full_partition_range, s->full_slice(), service::get_local_streaming_priority()),
+                    make_streaming_consumer("streaming", db, sys_dist_ks, vug, sst->get_estimated_key_count(), reason),
+                    cf->stream_in_progress());
+        }
+        co_await sst->destroy();
+    }
+}
+
 void stream_manager::init_messaging_service_handler() {
     auto& ms = _ms.local();
 
@@ -167,12 +296,14 @@ void stream_manager::init_messaging_service_handler() {
             // Make sure the table with cf_id is still present at this point.
             // Close the sink in case the table is dropped.
             auto op = _db.local().find_column_family(cf_id).stream_in_progress();
+            ++_stream_stats.active_incoming_streams;
             //FIXME: discarded future.
             (void)mutation_writer::distribute_reader_and_consume_on_shards(s,
                 make_generating_reader_v1(s, permit, std::move(get_next_mutation_fragment)),
-                make_streaming_consumer("streaming", _db, _sys_dist_ks, _view_update_generator, estimated_partitions, reason, is_offstrategy_supported(reason)),
+                make_streaming_consumer("streaming", _db, _sys_dist_ks, _view_update_generator, estimated_partitions, reason),
                 std::move(op)
-            ).then_wrapped([s, plan_id, from, sink, estimated_partitions] (future<uint64_t> f) mutable {
+            ).then_wrapped([this, s, plan_id, from, sink, estimated_partitions] (future<uint64_t> f) mutable {
+                --_stream_stats.active_incoming_streams;
                 int32_t status = 0;
                 uint64_t received_partitions = 0;
                 if (f.failed()) {
@@ -202,6 +333,43 @@ void stream_manager::init_messaging_service_handler() {
         });
       });
     });
+    ms.register_stream_sstable_files([this] (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_schema_version schema_id, table_id cf_id, sstring sstable_version, stream_reason reason, rpc::source<sstring, bytes, stream_sstable_files_cmd> source) {
+        auto from = netw::messaging_service::get_source(cinfo);
+        sslog.trace("Got stream_sstable_files from {} reason {}", from, int(reason));
+        if (!_sys_dist_ks.local_is_initialized() || !_view_update_generator.local_is_initialized()) {
+            return make_exception_future<rpc::sink<int>>(std::runtime_error(format("Node {} is not fully initialized for streaming, try again later",
+                    utils::fb_utilities::get_broadcast_address())));
+        }
+        return _mm.local().get_schema_for_write(schema_id, from, _ms.local()).then([this, from, plan_id, cf_id, sstable_version = std::move(sstable_version), reason, source] (schema_ptr s) mutable {
+            auto sink = _ms.local().make_sink_for_stream_sstable_files(source);
+          try {
+            // Make sure the table with cf_id is still present at this point.
+            // Close the sink in case the table is dropped.
+            auto op = _db.local().find_column_family(cf_id).stream_in_progress();
+            //FIXME: discarded future.
+            (void)receive_sstable_files(container(), _db, _sys_dist_ks, _view_update_generator, s, plan_id, from.addr, std::move(sstable_version), reason, std::move(source)
+            ).then_wrapped([s, plan_id, from, sink, op = std::move(op)] (future<> f) mutable {
+                int32_t status = 0;
+                if (f.failed()) {
+                    sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (receive phase) for ks={}, cf={}, peer={}: {}",
+                            plan_id, s->ks_name(), s->cf_name(), from.addr, f.get_exception());
+                    status = -1;
+                }
+                return sink(status).finally([sink] () mutable {
+                    return sink.close();
+                });
+            }).handle_exception([s, plan_id, from, sink] (std::exception_ptr ep) {
+                sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (respond phase) for ks={}, cf={}, peer={}: {}",
+                        plan_id, s->ks_name(), s->cf_name(), from.addr, ep);
+            });
+          } catch (...) {
+            return sink.close().then([sink, eptr = std::current_exception()] () -> future<rpc::sink<int>> {
+                return make_exception_future<rpc::sink<int>>(eptr);
+            });
+          }
+            return make_ready_future<rpc::sink<int>>(sink);
+        });
+    });
     ms.register_stream_mutation_done([this] (const rpc::client_info& cinfo, streaming::plan_id plan_id, dht::token_range_vector ranges, table_id cf_id, unsigned dst_cpu_id) {
         const auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return container().invoke_on(dst_cpu_id, [ranges = std::move(ranges), plan_id, cf_id, from] (auto& sm) mutable {
@@ -232,6 +400,7 @@ future<> stream_manager::uninit_messaging_service_handler() {
         ms.unregister_prepare_message(),
         ms.unregister_prepare_done_message(),
         ms.unregister_stream_mutation_fragments(),
+        ms.unregister_stream_sstable_files(),
         ms.unregister_stream_mutation_done(),
         ms.unregister_complete_message()).discard_result();
 }
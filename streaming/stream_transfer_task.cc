@@ -16,6 +16,7 @@
 #include "streaming/stream_manager.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "readers/mutation_fragment_v1_stream.hh"
 #include "mutation_fragment_stream_validator.hh"
 #include "frozen_mutation.hh"
@@ -29,8 +30,16 @@
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_set.hpp>
 #include "sstables/sstables.hh"
+#include "sstables/sstable_version.hh"
 #include "replica/database.hh"
+#include "db/config.hh"
 #include "gms/feature_service.hh"
+#include <boost/algorithm/cxx11/any_of.hpp>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
 
 namespace streaming {
 
@@ -46,6 +55,7 @@ stream_transfer_task::~stream_transfer_task() = default;
 
 struct send_info {
     netw::messaging_service& ms;
+    stream_manager::stream_stats& stats;
     streaming::plan_id plan_id;
     table_id cf_id;
     netw::messaging_service::msg_addr id;
@@ -57,12 +67,17 @@ struct send_info {
     replica::column_family& cf;
     dht::token_range_vector ranges;
     dht::partition_range_vector prs;
+    // Sent as files.
+    std::vector<sstables::shared_sstable> file_sstables;
     mutation_fragment_v1_stream reader;
     noncopyable_function<void(size_t)> update;
-    send_info(netw::messaging_service& ms_, streaming::plan_id plan_id_, replica::table& tbl_, reader_permit permit_,
-              dht::token_range_vector ranges_, netw::messaging_service::msg_addr id_,
+    // The reader doesn't read the excluded sstables, which are sent as files.
+    send_info(netw::messaging_service& ms_, stream_manager::stream_stats& stats_, streaming::plan_id plan_id_, replica::table& tbl_, reader_permit permit_,
+              dht::token_range_vector ranges_, std::vector<sstables::shared_sstable> file_sstables_,
+              const std::unordered_set<sstables::shared_sstable>& excluded, netw::messaging_service::msg_addr id_,
               uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn)
         : ms(ms_)
+        , stats(stats_)
         , plan_id(plan_id_)
         , cf_id(tbl_.schema()->id())
         , id(id_)
@@ -71,7 +86,10 @@ struct send_info {
         , cf(tbl_)
         , ranges(std::move(ranges_))
         , prs(dht::to_partition_ranges(ranges))
-        , reader(cf.make_streaming_reader(cf.schema(), std::move(permit_), prs))
+        , file_sstables(std::move(file_sstables_))
+        , reader(excluded.empty()
+                ? cf.make_streaming_reader(cf.schema(), std::move(permit_), prs)
+                : cf.make_streaming_reader(cf.schema(), std::move(permit_), prs, excluded))
         , update(std::move(update_fn))
     {
     }
@@ -118,6 +136,7 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
     sslog.info("[Stream #{}] Start sending ks={}, cf={}, estimated_partitions={}, with new rpc streaming", si->plan_id, si->cf.schema()->ks_name(), si->cf.schema()->cf_name(), estimated_partitions);
     return si->ms.make_sink_and_source_for_stream_mutation_fragments(si->reader.schema()->version(), si->plan_id, si->cf_id, estimated_partitions, si->reason, si->id).then_unpack([si] (rpc::sink<frozen_mutation_fragment, stream_mutation_fragments_cmd> sink, rpc::source<int32_t> source) mutable {
         auto got_error_from_peer = make_lw_shared<bool>(false);
+        ++si->stats.active_outgoing_streams;
 
         auto source_op = [source, got_error_from_peer, si] () mutable -> future<> {
             return repeat([source, got_error_from_peer, si] () mutable {
@@ -154,7 +173,15 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
                             frozen_mutation_fragment fmf = freeze(*s, *mf);
                             auto size = fmf.representation().size();
                             si->update(size);
-                            return sink(fmf, stream_mutation_fragments_cmd::mutation_fragment_data).then([] { return stop_iteration::no; });
+                            auto f = sink(fmf, stream_mutation_fragments_cmd::mutation_fragment_data);
+                            if (f.available()) {
+                                return f.then([] { return stop_iteration::no; });
+                            }
+                            // The peer holds back the stream.
+                            return f.then([si, start = std::chrono::steady_clock::now()] {
+                                si->stats.outgoing_stream_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+                                return stop_iteration::no;
+                            });
                         } else {
                             if (!validator.on_end_of_stream()) {
                                 return make_exception_future<stop_iteration>(std::runtime_error(format("Stream reader mutation_fragment validator failed on end_of_stream, previous={}, current=end_of_stream",
@@ -176,7 +203,9 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
             });
         }();
 
-        return when_all_succeed(std::move(source_op), std::move(sink_op)).then_unpack([got_error_from_peer, si] {
+        return when_all_succeed(std::move(source_op), std::move(sink_op)).finally([si] {
+            --si->stats.active_outgoing_streams;
+        }).then_unpack([got_error_from_peer, si] {
             if (*got_error_from_peer) {
                 throw std::runtime_error(format("Peer failed to process mutation_fragment peer={}, plan_id={}, cf_id={}", si->id.addr, si->plan_id, si->cf_id));
             }
@@ -186,6 +215,224 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
  });
 }
 
+static bool is_file_streaming_supported(stream_reason reason) {
+    switch (reason) {
+    case stream_reason::bootstrap:
+    case stream_reason::replace:
+    case stream_reason::removenode:
+    case stream_reason::decommission:
+    case stream_reason::rebuild:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Returns the sstables of this shard which hold partitions of the ranges
+// only, so that they can be sent as they are. The ranges are sorted and
+// merged, so such an sstable lies within one of them.
+static std::vector<sstables::shared_sstable> select_sstables_for_file_streaming(const replica::table& tbl, const dht::token_range_vector& ranges) {
+    std::vector<sstables::shared_sstable> selected;
+    auto sstables = tbl.get_sstables();
+    for (auto& sst : *sstables) {
+        // Shared sstables are in the set of each shard which owns them, so
+        // they would be sent more than once. Those of the staging directory
+        // still have to generate view updates here.
+        if (sst->is_shared() || sst->requires_view_building() || sst->is_quarantined()
+                || sst->get_version() < sstables::oldest_writable_sstable_format) {
+            continue;
+        }
+        auto first = sst->get_first_decorated_key().token();
+        auto last = sst->get_last_decorated_key().token();
+        if (boost::algorithm::any_of(ranges, [&] (const dht::token_range& r) {
+            return r.contains(first, dht::token_comparator()) && r.contains(last, dht::token_comparator());
+        })) {
+            selected.push_back(sst);
+        }
+    }
+    return selected;
+}
+
+static constexpr size_t sstable_file_chunk_size = 128 * 1024;
+
+static future<> send_sstable_components(rpc::sink<sstring, bytes, stream_sstable_files_cmd> sink, sstables::shared_sstable sst,
+        const bool& got_error_from_peer, lw_shared_ptr<send_info> si) {
+    // The TOC goes first, like the sstable writer writes it first. The
+    // receiver writes it as the TemporaryTOC, until all components arrived.
+    auto& component_map = sstables::sstable_version_constants::get_component_map(sst->get_version());
+    std::vector<sstring> components{component_map.at(sstables::component_type::TOC)};
+    for (auto& [type, name] : sst->all_components()) {
+        if (type != sstables::component_type::TOC) {
+            components.push_back(name);
+        }
+    }
+
+    std::exception_ptr ex;
+    try {
+        file_input_stream_options options;
+        options.buffer_size = sstable_file_chunk_size;
+        options.read_ahead = 2;
+        options.io_priority_class = service::get_local_streaming_priority();
+        for (auto& name : components) {
+            auto f = co_await open_file_dma(sst->component_filename(name), open_flags::ro);
+            auto in = make_file_input_stream(std::move(f), 0, options);
+            std::exception_ptr read_ex;
+            try {
+                bool sent = false;
+                for (;;) {
+                    auto buf = co_await in.read();
+                    if (got_error_from_peer) {
+                        throw std::runtime_error("Got status error code from peer");
+                    }
+                    // Empty components are sent as an empty chunk, so that the receiver creates them.
+                    if (buf.empty() && sent) {
+                        break;
+                    }
+                    si->update(buf.size());
+                    co_await sink(name, bytes(reinterpret_cast<const int8_t*>(buf.get()), buf.size()), stream_sstable_files_cmd::component_data);
+                    sent = true;
+                    if (buf.empty()) {
+                        break;
+                    }
+                }
+            } catch (...) {
+                read_ex = std::current_exception();
+            }
+            co_await in.close();
+            if (read_ex) {
+                std::rethrow_exception(std::move(read_ex));
+            }
+        }
+        co_await sink(sstring(), bytes(), stream_sstable_files_cmd::end_of_stream);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        // Notify the receiver the sender has failed
+        try {
+            co_await sink(sstring(), bytes(), stream_sstable_files_cmd::error);
+        } catch (...) {
+            sslog.debug("[Stream #{}] Failed to send the error to {}: {}", si->plan_id, si->id.addr, std::current_exception());
+        }
+    }
+    co_await sink.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+static future<> receive_sstable_files_status(rpc::source<int32_t> source, bool& got_error_from_peer, lw_shared_ptr<send_info> si) {
+    // Read until EOS even after an error, so that the source can be destroyed.
+    while (auto status_opt = co_await source()) {
+        auto status = std::get<0>(*status_opt);
+        got_error_from_peer = status == -1;
+        sslog.debug("Got status code from peer={}, plan_id={}, cf_id={}, status={}", si->id.addr, si->plan_id, si->cf_id, status);
+    }
+}
+
+// Sends all components of sst with STREAM_SSTABLE_FILES, rather than its mutations.
+static future<> send_sstable_files(lw_shared_ptr<send_info> si, sstables::shared_sstable sst) {
+    sslog.debug("[Stream #{}] Sending sstable {} of ks={}, cf={} as files to {}", si->plan_id, sst->get_filename(),
+            si->cf.schema()->ks_name(), si->cf.schema()->cf_name(), si->id.addr);
+    auto [sink, source] = co_await si->ms.make_sink_and_source_for_stream_sstable_files(si->cf.schema()->version(), si->plan_id, si->cf_id,
+            sstables::to_string(sst->get_version()), si->reason, si->id);
+    bool got_error_from_peer = false;
+    co_await when_all_succeed(
+            receive_sstable_files_status(std::move(source), got_error_from_peer, si),
+            send_sstable_components(std::move(sink), std::move(sst), got_error_from_peer, si)).discard_result();
+    if (got_error_from_peer) {
+        throw std::runtime_error(format("Peer failed to process sstable files peer={}, plan_id={}, cf_id={}", si->id.addr, si->plan_id, si->cf_id));
+    }
+}
+
+static future<> send_sstables_files(lw_shared_ptr<send_info> si) {
+    if (si->file_sstables.empty()) {
+        co_return;
+    }
+    sslog.info("[Stream #{}] Start sending ks={}, cf={}, sstables={} as files", si->plan_id, si->cf.schema()->ks_name(), si->cf.schema()->cf_name(), si->file_sstables.size());
+    for (auto& sst : si->file_sstables) {
+        co_await send_sstable_files(si, sst);
+    }
+}
+
+using peer_shard_ranges = std::vector<std::pair<netw::messaging_service::msg_addr, dht::token_range_vector>>;
+
+// Splits the ranges by the shard of the peer which owns them, so that each
+// shard of the peer receives its partitions on a stream of its own, and one
+// which is slow to write them holds back its own stream only.
+static future<peer_shard_ranges> split_ranges_by_peer_shard(const netw::messaging_service& ms, const schema& s,
+        netw::messaging_service::msg_addr id, dht::token_range_vector ranges) {
+    auto sharder_ptr = ms.peer_sharder(id.addr);
+    // Tables sharded differently, e.g. which live on shard 0 only, are sent to a single shard.
+    if (!sharder_ptr || sharder_ptr->shard_count() == 1 || s.get_sharder().shard_count() == 1) {
+        co_return peer_shard_ranges{{id, std::move(ranges)}};
+    }
+    // The sharding of the peer may change while yielding.
+    auto sharder = *sharder_ptr;
+    peer_shard_ranges shard_ranges;
+    for (shard_id shard = 0; shard < sharder.shard_count(); ++shard) {
+        dht::token_range_vector ranges_of_shard;
+        for (auto& range : ranges) {
+            auto range_sharder = dht::selective_token_range_sharder(sharder, range, shard);
+            while (auto r = range_sharder.next()) {
+                ranges_of_shard.push_back(std::move(*r));
+            }
+            co_await coroutine::maybe_yield();
+        }
+        if (!ranges_of_shard.empty()) {
+            shard_ranges.emplace_back(netw::messaging_service::msg_addr(id.addr, shard), std::move(ranges_of_shard));
+        }
+    }
+    co_return shard_ranges;
+}
+
+// Number of shards of the peer a shard streams to at the same time.
+static constexpr size_t max_concurrent_peer_shard_streams = 8;
+
+static future<> send_ranges_from_this_shard(stream_manager& sm, streaming::plan_id plan_id, table_id cf_id, netw::messaging_service::msg_addr id,
+        uint32_t dst_cpu_id, dht::token_range_vector ranges, stream_reason reason) {
+    auto& tbl = sm.db().find_column_family(cf_id);
+    std::vector<sstables::shared_sstable> file_sstables;
+    if (is_file_streaming_supported(reason) && sm.db().features().file_based_streaming && sm.db().get_config().enable_file_based_streaming()) {
+        file_sstables = select_sstables_for_file_streaming(tbl, ranges);
+    }
+    const std::unordered_set<sstables::shared_sstable> excluded(file_sstables.begin(), file_sstables.end());
+
+    auto send = [&] (netw::messaging_service::msg_addr dst, dht::token_range_vector dst_ranges, std::vector<sstables::shared_sstable> files) -> future<> {
+        auto permit = co_await sm.db().obtain_reader_permit(tbl, "stream-transfer-task", db::no_timeout);
+        auto si = make_lw_shared<send_info>(sm.ms(), sm.get_stream_stats(), plan_id, tbl, std::move(permit), std::move(dst_ranges), std::move(files), excluded,
+                dst, dst_cpu_id, reason, [&sm, plan_id, addr = id.addr] (size_t sz) {
+            sm.update_progress(plan_id, addr, streaming::progress_info::direction::OUT, sz);
+        });
+        std::exception_ptr ex;
+        try {
+            co_await send_sstables_files(si);
+            if (!si->ranges.empty()) {
+                if (co_await si->has_relevant_range_on_this_shard()) {
+                    co_await send_mutation_fragments(si);
+                } else {
+                    sslog.debug("[Stream #{}] stream_transfer_task: cf_id={}: ignore ranges on shard={}",
+                            plan_id, cf_id, this_shard_id());
+                }
+            }
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await si->reader.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    };
+
+    if (!file_sstables.empty()) {
+        co_await send(id, dht::token_range_vector(), std::move(file_sstables));
+    }
+    auto shard_ranges = co_await split_ranges_by_peer_shard(sm.ms(), *tbl.schema(), id, std::move(ranges));
+    co_await max_concurrent_for_each(shard_ranges, max_concurrent_peer_shard_streams, [&] (auto& sr) {
+        return send(sr.first, std::move(sr.second), {});
+    });
+}
+
 future<> stream_transfer_task::execute() {
     auto plan_id = session->plan_id();
     auto cf_id = this->cf_id;
@@ -196,22 +443,7 @@ future<> stream_transfer_task::execute() {
     auto reason = session->get_reason();
     auto& sm = session->manager();
     return sm.container().invoke_on_all([plan_id, cf_id, id, dst_cpu_id, ranges=this->_ranges, reason] (stream_manager& sm) mutable {
-        auto& tbl = sm.db().find_column_family(cf_id);
-      return sm.db().obtain_reader_permit(tbl, "stream-transfer-task", db::no_timeout).then([&sm, &tbl, plan_id, cf_id, id, dst_cpu_id, ranges=std::move(ranges), reason] (reader_permit permit) mutable {
-        auto si = make_lw_shared<send_info>(sm.ms(), plan_id, tbl, std::move(permit), std::move(ranges), id, dst_cpu_id, reason, [&sm, plan_id, addr = id.addr] (size_t sz) {
-            sm.update_progress(plan_id, addr, streaming::progress_info::direction::OUT, sz);
-        });
-        return si->has_relevant_range_on_this_shard().then([&sm, si, plan_id, cf_id] (bool has_relevant_range_on_this_shard) {
-            if (!has_relevant_range_on_this_shard) {
-                sslog.debug("[Stream #{}] stream_transfer_task: cf_id={}: ignore ranges on shard={}",
-                        plan_id, cf_id, this_shard_id());
-                return make_ready_future<>();
-            }
-            return send_mutation_fragments(std::move(si));
-        }).finally([si] {
-            return si->reader.close();
-        });
-      });
+        return send_ranges_from_this_shard(sm, plan_id, cf_id, id, dst_cpu_id, std::move(ranges), reason);
     }).then([this, plan_id, cf_id, id, &sm] {
         sslog.debug("[Stream #{}] SEND STREAM_MUTATION_DONE to {}, cf_id={}", plan_id, id, cf_id);
         return sm.ms().send_stream_mutation_done(id, plan_id, _ranges,
@@ -37,6 +37,26 @@ def test_update_expression_set_multi(test_table_s):
         ExpressionAttributeValues={':val1': 4})
     assert test_table_s.get_item(Key={'p': p}, ConsistentRead=True)['Item'] == {'p': p, 'x': 4, 'y': 4}
 
+# The same expression strings are typically sent many times, with different
+# ExpressionAttributeNames and ExpressionAttributeValues. Check that each use
+# of the same expression is resolved with the names and values of its own
+# request, and not with those of an earlier one.
+def test_update_expression_reused(test_table_s):
+    p = random_string()
+    expr = 'SET #name = :val1 + :val2'
+    for name, val in [('a', 1), ('b', 2), ('a', 3)]:
+        test_table_s.update_item(Key={'p': p},
+            UpdateExpression=expr,
+            ExpressionAttributeNames={'#name': name},
+            ExpressionAttributeValues={':val1': val, ':val2': 10})
+    assert test_table_s.get_item(Key={'p': p}, ConsistentRead=True)['Item'] == {'p': p, 'a': 13, 'b': 12}
+    # A missing value is still detected when the expression was used before
+    with pytest.raises(ClientError, match='ValidationException'):
+        test_table_s.update_item(Key={'p': p},
+            UpdateExpression=expr,
+            ExpressionAttributeNames={'#name': 'a'},
+            ExpressionAttributeValues={':val1': 1})
+
 # Test that UpdateItem merges the change with a previously existing item -
 # it doesn't outright replace it like PutItem does. This merge is done
 # even if the expression doesn't need to read the old value of the item.
@@ -10,6 +10,8 @@
 
 #include <boost/test/unit_test.hpp>
 #include <utility>
+#include <set>
+#include <thread>
 #include "utils/UUID_gen.hh"
 #include "types.hh"
 
@@ -260,3 +262,40 @@ BOOST_AUTO_TEST_CASE(test_null_uuid) {
     BOOST_CHECK(!uuid.is_null());
     BOOST_CHECK(uuid);
 }
+
+BOOST_AUTO_TEST_CASE(test_time_uuids_of_threads_are_unique) {
+    using utils::UUID, utils::UUID_gen;
+    constexpr int nr_threads = 4;
+    constexpr int nr_uuids = 100000;
+
+    std::vector<std::vector<UUID>> uuids(nr_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nr_threads; t++) {
+        threads.emplace_back([&uuids, t] {
+            auto& v = uuids[t];
+            v.reserve(nr_uuids);
+            for (int i = 0; i < nr_uuids; i++) {
+                v.push_back(UUID_gen::get_time_UUID());
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    std::vector<UUID> all;
+    std::set<int64_t> clock_seqs;
+    for (auto& v : uuids) {
+        // Each thread generates monotonic UUIDs with its own clock sequence
+        for (size_t i = 1; i < v.size(); i++) {
+            BOOST_REQUIRE(v[i].timestamp() > v[i - 1].timestamp());
+            BOOST_REQUIRE_EQUAL(v[i].get_least_significant_bits(), v[0].get_least_significant_bits());
+        }
+        clock_seqs.insert((v[0].get_least_significant_bits() >> 48) & 0x3fff);
+        all.insert(all.end(), v.begin(), v.end());
+    }
+    BOOST_REQUIRE_EQUAL(clock_seqs.size(), nr_threads);
+
+    std::sort(all.begin(), all.end());
+    BOOST_REQUIRE(std::unique(all.begin(), all.end()) == all.end());
+}
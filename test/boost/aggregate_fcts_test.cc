@@ -272,3 +272,58 @@ SEASTAR_TEST_CASE(test_minmax_on_set) {
         }
     });
 }
+
+SEASTAR_TEST_CASE(test_aggregate_approximate_count_distinct) {
+    return do_with_cql_env_thread([&] (auto& e) {
+        e.execute_cql("CREATE TABLE test (a int primary key, b int, t text, s set<int>)").get();
+        for (int i = 0; i < 2000; ++i) {
+            e.execute_cql(format("INSERT INTO test (a, b, t, s) VALUES ({}, {}, 'v{}', {{{}}})", i, i % 1000, i % 10, i % 3)).get();
+        }
+        e.execute_cql("INSERT INTO test (a) VALUES (2000)").get();
+
+        auto msg = e.execute_cql("SELECT approximate_count_distinct(b), approximate_count_distinct(t), approximate_count_distinct(s) FROM test").get0();
+        auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+        BOOST_REQUIRE(rows);
+        const auto& rs = rows->rs().result_set().rows();
+        BOOST_REQUIRE_EQUAL(rs.size(), 1);
+        auto estimate = [&] (size_t i) {
+            return value_cast<int64_t>(long_type->deserialize(*rs.front()[i]));
+        };
+        // Well within the standard error of 1.6%
+        BOOST_REQUIRE_LE(std::abs(estimate(0) - 1000), 50);
+        // Small counts are nearly exact, unless hashes collide
+        BOOST_REQUIRE_LE(std::abs(estimate(1) - 10), 1);
+        BOOST_REQUIRE_LE(std::abs(estimate(2) - 3), 1);
+
+        msg = e.execute_cql("SELECT approximate_count_distinct(b) FROM test WHERE a = 2000").get0();
+        assert_that(msg).is_rows().with_size(1).with_row({{long_type->decompose(int64_t(0))}});
+    });
+}
+
+SEASTAR_TEST_CASE(test_aggregate_approx_percentile) {
+    return do_with_cql_env_thread([&] (auto& e) {
+        e.execute_cql("CREATE TABLE test (a int primary key, b int, c double)").get();
+        for (int i = 1; i <= 1000; ++i) {
+            e.execute_cql(format("INSERT INTO test (a, b, c) VALUES ({}, {}, {})", i, i, i / 10.0)).get();
+        }
+        e.execute_cql("INSERT INTO test (a) VALUES (0)").get();
+
+        auto msg = e.execute_cql("SELECT approx_percentile(b, 0.5), approx_percentile(b, 0.99), approx_percentile(c, 0.9) FROM test").get0();
+        auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+        BOOST_REQUIRE(rows);
+        const auto& rs = rows->rs().result_set().rows();
+        BOOST_REQUIRE_EQUAL(rs.size(), 1);
+        auto estimate = [&] (size_t i) {
+            return value_cast<double>(double_type->deserialize(*rs.front()[i]));
+        };
+        BOOST_REQUIRE_LE(std::abs(estimate(0) - 500), 20);
+        BOOST_REQUIRE_LE(std::abs(estimate(1) - 990), 20);
+        BOOST_REQUIRE_LE(std::abs(estimate(2) - 90), 2);
+
+        // No values, no percentile
+        msg = e.execute_cql("SELECT approx_percentile(b, 0.5) FROM test WHERE a = 0").get0();
+        assert_that(msg).is_rows().with_size(1).with_row({{}});
+
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT approx_percentile(b, 1.5) FROM test").get(), exceptions::invalid_request_exception);
+    });
+}
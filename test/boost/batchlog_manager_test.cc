@@ -14,6 +14,7 @@
 #include <stdint.h>
 
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/cql_assertions.hh"
 
@@ -26,6 +27,7 @@
 #include "service/storage_proxy.hh"
 
 #include "message/messaging_service.hh"
+#include "utils/UUID_gen.hh"
 
 static atomic_cell make_atomic_cell(data_type dt, bytes value) {
     return atomic_cell::make_live(*dt, 0, std::move(value));
@@ -69,3 +71,79 @@ SEASTAR_TEST_CASE(test_execute_batch) {
     });
 }
 
+
+SEASTAR_TEST_CASE(test_replay_batch_of_many_mutations) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto& qp = e.local_qp();
+        e.execute_cql("create table cf1 (p int, c int, r int, PRIMARY KEY (p, c));").get();
+        e.execute_cql("create table cf2 (p int PRIMARY KEY, r int);").get();
+        auto s1 = e.local_db().find_schema("ks", "cf1");
+        auto s2 = e.local_db().find_schema("ks", "cf2");
+
+        std::vector<mutation> mutations;
+        for (int p = 0; p < 10; ++p) {
+            mutation m1(s1, partition_key::from_singular(*s1, p));
+            m1.set_clustered_cell(clustering_key::from_singular(*s1, 0), *s1->get_column_definition("r"),
+                    make_atomic_cell(int32_type, int32_type->decompose(p)));
+            mutations.push_back(std::move(m1));
+            mutation m2(s2, partition_key::from_singular(*s2, p));
+            m2.set_clustered_cell(clustering_key::make_empty(), *s2->get_column_definition("r"),
+                    make_atomic_cell(int32_type, int32_type->decompose(p)));
+            mutations.push_back(std::move(m2));
+        }
+
+        using namespace std::chrono_literals;
+        auto bm = qp.proxy().get_batchlog_mutation_for(mutations, utils::UUID_gen::get_time_UUID(),
+                netw::messaging_service::current_version, db_clock::now() - db_clock::duration(3h));
+        qp.proxy().mutate_locally(bm, tracing::trace_state_ptr(), db::commitlog::force_sync::no).get();
+        e.batchlog_manager().local().do_batch_log_replay().get();
+
+        BOOST_REQUIRE_EQUAL(e.batchlog_manager().local().count_all_batches().get0(), 0);
+        for (auto cf : {"cf1", "cf2"}) {
+            auto rs = qp.execute_internal(format("select r from ks.{}", cf), cql3::query_processor::cache_internal::no).get0();
+            BOOST_REQUIRE_EQUAL(rs->size(), 10);
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_replay_many_batches) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto& qp = e.local_qp();
+        e.execute_cql("create table cf (p int PRIMARY KEY, r int);").get();
+        auto s = e.local_db().find_schema("ks", "cf");
+
+        // More batches than fit in a page of the replay.
+        using namespace std::chrono_literals;
+        const int batches = 300;
+        for (int p = 0; p < batches; ++p) {
+            mutation m(s, partition_key::from_singular(*s, p));
+            m.set_clustered_cell(clustering_key::make_empty(), *s->get_column_definition("r"),
+                    make_atomic_cell(int32_type, int32_type->decompose(p)));
+            auto bm = qp.proxy().get_batchlog_mutation_for({ m }, utils::UUID_gen::get_time_UUID(),
+                    netw::messaging_service::current_version, db_clock::now() - db_clock::duration(3h));
+            qp.proxy().mutate_locally(bm, tracing::trace_state_ptr(), db::commitlog::force_sync::no).get();
+        }
+        BOOST_REQUIRE_EQUAL(e.batchlog_manager().local().count_all_batches().get0(), batches);
+
+        e.batchlog_manager().local().do_batch_log_replay().get();
+
+        BOOST_REQUIRE_EQUAL(e.batchlog_manager().local().count_all_batches().get0(), 0);
+        auto rs = qp.execute_internal("select r from ks.cf", cql3::query_processor::cache_internal::no).get0();
+        BOOST_REQUIRE_EQUAL(rs->size(), batches);
+    });
+}
+
+SEASTAR_THREAD_TEST_CASE(test_replay_token_ranges) {
+    for (unsigned shards : {1u, 2u, 3u, 7u, 64u}) {
+        auto first = db::batchlog_manager::replay_token_range(0, shards);
+        BOOST_REQUIRE_EQUAL(first.first, std::numeric_limits<int64_t>::min());
+        auto last = db::batchlog_manager::replay_token_range(shards - 1, shards);
+        BOOST_REQUIRE_EQUAL(last.second, std::numeric_limits<int64_t>::max());
+        for (unsigned shard = 1; shard < shards; ++shard) {
+            auto prev = db::batchlog_manager::replay_token_range(shard - 1, shards);
+            auto cur = db::batchlog_manager::replay_token_range(shard, shards);
+            BOOST_REQUIRE_EQUAL(prev.second, cur.first);
+            BOOST_REQUIRE_LT(cur.first, cur.second);
+        }
+    }
+}
@@ -203,3 +203,30 @@ BOOST_AUTO_TEST_CASE(test_big_decimal_sub) {
     test_sub("9999999999999999999999999999999999999", "-1.000e0", "10000000000000000000000000000000000000.000");
     test_sub("+10.", "1.e+1", "0");
 }
+
+BOOST_AUTO_TEST_CASE(test_big_decimal_sum) {
+    auto check = [] (std::initializer_list<const char*> values, bool small) {
+        big_decimal expected;
+        big_decimal_sum sum;
+        big_decimal_sum first_half, second_half;
+        size_t i = 0;
+        for (auto v : values) {
+            expected += big_decimal(v);
+            sum += big_decimal(v);
+            (i++ < values.size() / 2 ? first_half : second_half) += big_decimal(v);
+        }
+        first_half += second_half;
+        BOOST_REQUIRE_EQUAL(sum.is_small(), small);
+        for (auto& s : {sum, first_half}) {
+            BOOST_REQUIRE_EQUAL(s.get().unscaled_value(), expected.unscaled_value());
+            BOOST_REQUIRE_EQUAL(s.get().scale(), expected.scale());
+        }
+    };
+    check({}, true);
+    check({"1", "2.5", "-0.125", "1e3", "7.00"}, true);
+    check({"9223372036854775807", "9223372036854775807", "-1.5"}, true);
+    check({"1e-30", "1"}, true);
+    check({"1e-40", "1"}, false);
+    check({"99999999999999999999", "1"}, false);
+    check({"170141183460469231731687303715884105727", "1", "-2"}, false);
+}
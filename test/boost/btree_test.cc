@@ -8,6 +8,8 @@
 
 #include <boost/test/unit_test.hpp>
 #include <fmt/core.h>
+#include <algorithm>
+#include <random>
 
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
@@ -587,3 +589,79 @@ SEASTAR_TEST_CASE(test_exception_safety_of_clone_linear) {
 SEASTAR_TEST_CASE(test_exception_safety_of_clone_large) {
     return test_exception_safety_of_clone(2534);
 }
+
+BOOST_AUTO_TEST_CASE(test_array_search_eq_range) {
+    std::vector<uint64_t> arr = { 0, 1, 1, 1, 5, 5, 9, 1ull << 63, (1ull << 63) + 1, (1ull << 63) + 1, std::numeric_limits<uint64_t>::max() };
+
+    for (unsigned size = 0; size <= arr.size(); size++) {
+        for (uint64_t v : { uint64_t(0), uint64_t(1), uint64_t(2), uint64_t(5), uint64_t(9), uint64_t(10),
+                uint64_t(1ull << 63), (1ull << 63) + 1, std::numeric_limits<uint64_t>::max() - 1, std::numeric_limits<uint64_t>::max() }) {
+            auto [s, e] = utils::array_search_eq_range(v, arr.data(), size);
+            auto es = std::lower_bound(arr.begin(), arr.begin() + size, v) - arr.begin();
+            auto ee = std::upper_bound(arr.begin(), arr.begin() + size, v) - arr.begin();
+            BOOST_REQUIRE_EQUAL(s, es);
+            BOOST_REQUIRE_EQUAL(e, ee);
+        }
+    }
+}
+
+/*
+ * Key with prefixes colliding for every three values, so that the
+ * search has to compare the keys within the narrowed down range.
+ */
+class prefixed_test_key : public tree_test_key_base {
+    member_hook b_hook;
+
+public:
+    uint64_t key_prefix() const noexcept { return uint64_t(int(*this)) / 3; }
+
+    struct tri_compare {
+        test_key_tri_compare _cmp;
+        template <typename A, typename B>
+        std::strong_ordering operator()(const A& a, const B& b) const noexcept { return _cmp(a, b); }
+        std::optional<uint64_t> key_prefix(const prefixed_test_key& k) const noexcept { return k.key_prefix(); }
+        std::optional<uint64_t> key_prefix(const int& k) const noexcept { return uint64_t(k) / 3; }
+    };
+    using test_tree = tree<prefixed_test_key, &prefixed_test_key::b_hook, tri_compare, 4, 5, key_search::both, with_debug::yes>;
+    prefixed_test_key(int nr) noexcept : tree_test_key_base(nr) {}
+    prefixed_test_key(prefixed_test_key&&) = delete;
+};
+
+BOOST_AUTO_TEST_CASE(test_key_prefixes) {
+    prefixed_test_key::test_tree t;
+    prefixed_test_key::tri_compare pcmp;
+    auto deleter = [] (prefixed_test_key* key) noexcept { delete key; };
+    int nkeys = 128;
+
+    std::vector<int> vals;
+    for (int i = 0; i < nkeys; i++) {
+        vals.push_back(2 * i + 1);
+    }
+    std::shuffle(vals.begin(), vals.end(), std::default_random_engine(nkeys));
+
+    auto check = [&] {
+        for (int i = 0; i <= 2 * nkeys; i++) {
+            bool match;
+            auto it = t.lower_bound(i, match, pcmp);
+            auto eit = std::find_if(t.begin(), t.end(), [i] (const prefixed_test_key& k) { return int(k) >= i; });
+            BOOST_REQUIRE(it == eit);
+            BOOST_REQUIRE_EQUAL(match, it != t.end() && int(*it) == i);
+        }
+    };
+
+    // Inserting in random order splits and moves the keys around the nodes
+    for (auto v : vals) {
+        t.insert(std::make_unique<prefixed_test_key>(v), pcmp);
+    }
+    check();
+
+    // ... and so does erasing, merging the nodes back
+    for (int i = 0; i < nkeys / 2; i++) {
+        auto it = t.find(vals[i], pcmp);
+        BOOST_REQUIRE(it != t.end());
+        t.erase_and_dispose(it, deleter);
+    }
+    check();
+
+    t.clear_and_dispose(deleter);
+}
@@ -34,4 +34,15 @@ BOOST_AUTO_TEST_CASE(test_caching_options) {
         sstring in_str = "{\"keys\": \"NONE, }";
         BOOST_REQUIRE_THROW(caching_options::from_sstring(in_str), std::exception);
     }
+    {
+        string_map in_map = { {"eviction_priority", "2"}, {"keys", "ALL"}, {"rows_per_partition", "ALL"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE_EQUAL(co.eviction_priority(), 2);
+        BOOST_REQUIRE(in_map == co.to_map());
+        BOOST_REQUIRE(co != caching_options::from_map({}));
+    }
+    {
+        sstring in_str = "{\"eviction_priority\": \"4\"}";
+        BOOST_REQUIRE_THROW(caching_options::from_sstring(in_str), std::exception);
+    }
 }
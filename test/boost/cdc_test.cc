@@ -1956,6 +1956,34 @@ SEASTAR_THREAD_TEST_CASE(test_postimage_with_no_regular_columns) {
     }).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_blind_inserts) {
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        using oper_ut = std::underlying_type_t<cdc::operation>;
+
+        cquery_nofail(e, "create table ks.t (pk int, ck int, v int, primary key (pk, ck)) with cdc = {'enabled': true, 'preimage': true, 'blind_inserts': true}");
+        BOOST_REQUIRE(e.local_db().find_schema("ks", "t")->cdc_options().blind_inserts());
+
+        // Inserts are not read first, even if the row exists.
+        cquery_nofail(e, "insert into ks.t (pk, ck, v) values (1, 2, 3)");
+        cquery_nofail(e, "insert into ks.t (pk, ck, v) values (1, 2, 4)");
+        // Updates are.
+        cquery_nofail(e, "update ks.t set v = 5 where pk = 1 and ck = 2");
+
+        auto result = get_result(e,
+            {data_type_for<oper_ut>(), int32_type, int32_type, int32_type},
+            "select \"cdc$operation\", pk, ck, v from ks.t_scylla_cdc_log");
+
+        std::vector<std::vector<data_value>> expected = {
+            { oper_ut(cdc::operation::insert), int32_t(1), int32_t(2), int32_t(3) },
+            { oper_ut(cdc::operation::insert), int32_t(1), int32_t(2), int32_t(4) },
+            { oper_ut(cdc::operation::pre_image), int32_t(1), int32_t(2), int32_t(4) },
+            { oper_ut(cdc::operation::update), int32_t(1), int32_t(2), int32_t(5) },
+        };
+
+        BOOST_REQUIRE_EQUAL(expected, result);
+    }).get();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_image_deleted_column) {
     // Test that cdc$deleted_ columns are correctly
     // filled in the pre/post-image rows.
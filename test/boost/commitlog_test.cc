@@ -39,9 +39,11 @@
 #include "service/priority_manager.hh"
 #include "test/lib/exception_utils.hh"
 #include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
 #include "test/lib/data_model.hh"
 #include "test/lib/sstable_utils.hh"
 #include "test/lib/mutation_source_test.hh"
+#include "test/lib/random_utils.hh"
 
 using namespace db;
 
@@ -103,6 +105,38 @@ SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch){
         });
 }
 
+// check that concurrent writes in group commit mode are all made durable
+SEASTAR_TEST_CASE(test_commitlog_written_to_disk_group){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.commitlog_sync_group_window_in_us = 100000;
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        sstring tmp = "hej bubba cow";
+        auto uuid = make_table_id();
+        auto add = [&] {
+            return log.add_mutation(uuid, tmp.size(), db::commitlog::force_sync::no, [&tmp](db::commitlog::output& dst) {
+                dst.write(tmp.data(), tmp.size());
+            });
+        };
+        // Let the commitlog observe some flushes first.
+        for (int i = 0; i < 3; ++i) {
+            co_await add();
+        }
+        auto flushes = log.get_flush_count();
+        constexpr int writes = 64;
+        std::vector<future<rp_handle>> futs;
+        for (int i = 0; i < writes; ++i) {
+            futs.push_back(add());
+        }
+        for (auto& f : futs) {
+            auto h = co_await std::move(f);
+            BOOST_CHECK_NE(h.rp(), db::replay_position());
+        }
+        BOOST_REQUIRE_GT(log.get_flush_count(), flushes);
+        BOOST_REQUIRE_LE(log.get_flush_count() - flushes, writes);
+    });
+}
+
 // check that an entry marked as sync is immediately flushed to a storage
 SEASTAR_TEST_CASE(test_commitlog_written_to_disk_sync){
     commitlog::config cfg;
@@ -659,6 +693,44 @@ SEASTAR_TEST_CASE(test_commitlog_replay_invalid_key){
     });
 }
 
+// Replay sends entries to their shards in batches, and applies them in bulk
+// unless they need to be upgraded to the current schema.
+SEASTAR_TEST_CASE(test_commitlog_replay_batches) {
+    return do_with_cql_env_thread([] (cql_test_env& env) {
+        env.execute_cql("create table t (pk int primary key, v text)").get();
+
+        auto& db = env.local_db();
+        auto& table = db.find_column_family("ks", "t");
+        auto& cl = *table.commitlog();
+
+        auto add_entries = [&] (int first, int last) {
+            auto s = table.schema();
+            for (int i = first; i < last; ++i) {
+                auto md = tests::data_model::mutation_description({ int32_type->decompose(i) });
+                md.add_clustered_cell({}, "v", to_bytes("val"));
+                auto fm = freeze(md.build(s));
+                commitlog_entry_writer cew(s, fm, db::commitlog::force_sync::no);
+                cl.add_entry(s->id(), cew, db::no_timeout).get();
+            }
+        };
+
+        add_entries(0, 300);
+        env.execute_cql("alter table t add w int").get();
+        add_entries(300, 400);
+        cl.sync_all_segments().get();
+
+        {
+            auto paths = cl.get_active_segment_names();
+            BOOST_REQUIRE(!paths.empty());
+            auto rp = db::commitlog_replayer::create_replayer(env.db()).get0();
+            rp.recover(paths, db::commitlog::descriptor::FILENAME_PREFIX).get();
+        }
+
+        auto msg = env.execute_cql("select count(*) from t").get0();
+        assert_that(msg).is_rows().with_rows({{long_type->decompose(int64_t(400))}});
+    });
+}
+
 using namespace std::chrono_literals;
 
 SEASTAR_TEST_CASE(test_commitlog_add_entries) {
@@ -723,6 +795,69 @@ SEASTAR_TEST_CASE(test_commitlog_add_entries) {
     });
 }
 
+SEASTAR_TEST_CASE(test_commitlog_compressed_entries) {
+    commitlog::config cfg;
+    cfg.use_compression = true;
+    return cl_test(cfg, [](commitlog& log) {
+        return seastar::async([&] {
+            auto uuid = make_table_id();
+            // Compressible, incompressible and too large to be compressed.
+            std::vector<bytes> data = {
+                bytes(bytes::initialized_later(), 4096),
+                tests::random::get_bytes(4096),
+                bytes(bytes::initialized_later(), 256 * 1024),
+            };
+            std::fill(data[0].begin(), data[0].end(), 'a');
+            std::fill(data[2].begin(), data[2].end(), 'b');
+
+            std::vector<replay_position> rps;
+            for (auto& d : data) {
+                auto h = log.add_mutation(uuid, d.size(), db::commitlog::force_sync::no, [&d](db::commitlog::output& dst) {
+                    dst.write(reinterpret_cast<const char*>(d.data()), d.size());
+                }).get0();
+                rps.push_back(h.release());
+            }
+
+            std::vector<commitlog_entry_writer> writers;
+            std::vector<frozen_mutation> mutations;
+            random_mutation_generator gen(random_mutation_generator::generate_counters(false));
+            for (auto i = 0; i < 10; ++i) {
+                mutations.emplace_back(gen(1).front());
+            }
+            for (auto& fm : mutations) {
+                writers.emplace_back(gen.schema(), fm, commitlog_entry_writer::force_sync::no);
+            }
+            auto res = log.add_entries(writers, db::timeout_clock::now() + 60s).get0();
+
+            log.sync_all_segments().get();
+            auto segments = log.get_active_segment_names();
+            BOOST_REQUIRE(!segments.empty());
+
+            size_t found = 0;
+            for (auto& seg : segments) {
+                BOOST_REQUIRE_EQUAL(db::commitlog::descriptor(seg).ver, db::commitlog::descriptor::segment_version_3);
+                db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [&](db::commitlog::buffer_and_replay_position buf_rp) {
+                    auto i = std::find(rps.begin(), rps.end(), buf_rp.position);
+                    if (i != rps.end()) {
+                        auto& d = data.at(std::distance(rps.begin(), i));
+                        BOOST_REQUIRE_EQUAL(linearized(fragmented_temporary_buffer::view(buf_rp.buffer)), d);
+                        ++found;
+                    }
+                    auto j = std::find_if(res.begin(), res.end(), [&] (const db::rp_handle& h) { return h.rp() == buf_rp.position; });
+                    if (j != res.end()) {
+                        commitlog_entry_reader r(buf_rp.buffer);
+                        auto& fm = mutations.at(std::distance(res.begin(), j));
+                        BOOST_CHECK_EQUAL(fm.unfreeze(gen.schema()), r.mutation().unfreeze(gen.schema()));
+                        ++found;
+                    }
+                    return make_ready_future<>();
+                }).get();
+            }
+            BOOST_REQUIRE_EQUAL(found, data.size() + mutations.size());
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_commitlog_new_segment_odsync){
     commitlog::config cfg;
     cfg.commitlog_segment_size_in_mb = 1;
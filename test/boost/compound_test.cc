@@ -15,6 +15,7 @@
 #include "test/boost/range_assert.hh"
 #include "schema_builder.hh"
 #include "dht/murmur3_partitioner.hh"
+#include "utils/UUID_gen.hh"
 
 static std::vector<managed_bytes> to_bytes_vec(std::vector<sstring> values) {
     std::vector<managed_bytes> result;
@@ -387,3 +388,72 @@ SEASTAR_THREAD_TEST_CASE(test_prefix_compound_validity) {
     BOOST_REQUIRE_THROW(validate({'\x00', '\x01', 0, '\x00', '\x02', 'a', 'b', '\x00', '\x01', 'a'}), marshal_exception); // to many components
     BOOST_REQUIRE_THROW(validate({'\x00', '\x02', 'a', 'b', '\x00', '\x01', 0}), marshal_exception); // wrong order of components
 }
+
+SEASTAR_THREAD_TEST_CASE(test_component_comparator_matches_type_order) {
+    auto make_values = [] (const data_type& t) {
+        std::vector<bytes> values;
+        values.push_back(bytes());
+        for (int i = 0; i < 100; ++i) {
+            switch (t->without_reversed().get_kind()) {
+            case abstract_type::kind::int32:
+                values.push_back(t->decompose(tests::random::get_int<int32_t>(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
+                break;
+            case abstract_type::kind::long_kind:
+                values.push_back(t->decompose(tests::random::get_int<int64_t>(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max())));
+                break;
+            case abstract_type::kind::timestamp:
+                values.push_back(t->decompose(db_clock::time_point(db_clock::duration(tests::random::get_int<int64_t>(-1000000, 1000000)))));
+                break;
+            case abstract_type::kind::timeuuid:
+                values.push_back(t->decompose(utils::UUID_gen::get_time_UUID()));
+                break;
+            default:
+                values.push_back(t->decompose(tests::random::get_sstring(tests::random::get_int<size_t>(0, 8))));
+                break;
+            }
+        }
+        return values;
+    };
+
+    std::vector<data_type> types = { int32_type, long_type, timestamp_type, utf8_type, bytes_type, timeuuid_type };
+    for (auto t : std::vector<data_type>(types)) {
+        types.push_back(reversed_type_impl::get_instance(t));
+    }
+
+    for (auto& t : types) {
+        component_comparator cmp(t);
+        BOOST_REQUIRE(cmp.get_kind() != component_comparator::kind::generic);
+        auto values = make_values(t);
+        for (auto& v1 : values) {
+            for (auto& v2 : values) {
+                BOOST_REQUIRE(cmp(managed_bytes_view(bytes_view(v1)), managed_bytes_view(bytes_view(v2))) == t->compare(v1, v2));
+            }
+        }
+    }
+    BOOST_REQUIRE(component_comparator(decimal_type).get_kind() == component_comparator::kind::generic);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_compound_prefix_equality_tri_compare) {
+    const auto c = compound_type<allow_prefixes::yes>({int32_type, reversed_type_impl::get_instance(utf8_type)});
+
+    auto key = [&] (std::vector<bytes> components) {
+        return c.serialize_value(components);
+    };
+    auto tri_compare = [&] (const managed_bytes& k1, const managed_bytes& k2) {
+        return c.prefix_equality_tri_compare(managed_bytes_view(k1), managed_bytes_view(k2));
+    };
+
+    auto k1 = key({int32_type->decompose(int32_t(-1)), utf8_type->decompose(sstring("b"))});
+    auto k2 = key({int32_type->decompose(int32_t(1)), utf8_type->decompose(sstring("b"))});
+    auto k3 = key({int32_type->decompose(int32_t(1)), utf8_type->decompose(sstring("a"))});
+    auto p = key({int32_type->decompose(int32_t(1))});
+
+    BOOST_REQUIRE(tri_compare(k1, k2) < 0);
+    BOOST_REQUIRE(tri_compare(k2, k3) < 0);
+    BOOST_REQUIRE(tri_compare(k3, k2) > 0);
+    BOOST_REQUIRE(tri_compare(k2, k2) == 0);
+    // A prefix is equal to all keys it's a prefix of.
+    BOOST_REQUIRE(tri_compare(p, k2) == 0);
+    BOOST_REQUIRE(tri_compare(k3, p) == 0);
+    BOOST_REQUIRE(tri_compare(k1, p) < 0);
+}
@@ -341,3 +341,39 @@ SEASTAR_TEST_CASE(modify_table_with_index) {
                 {{int32_type->decompose(14)}});
     }, db_config_with_auth());
 }
+
+SEASTAR_TEST_CASE(permissions_cache_shared_by_shards) {
+    auto config = db_config_with_auth();
+    config->permissions_validity_in_ms.set(3600000);
+    config->permissions_update_interval_in_ms.set(3600000);
+
+    return do_with_cql_env_thread([](auto&& env) {
+        cquery_nofail(env, "CREATE TABLE t (p int PRIMARY KEY)");
+        create_user_if_not_exists(env, bob);
+        cquery_nofail(env, "GRANT SELECT ON t TO bob");
+
+        auto& auth_service = env.local_auth_service().container();
+        const auto r = auth::make_data_resource("ks", "t");
+        const auto require_permissions = [&auth_service, &r] (auth::permission_set expected) {
+            auth_service.invoke_on_all([r, expected] (auth::service& s) {
+                return s.get_permissions(auth::role_or_anonymous(bob), r).then([expected] (auth::permission_set perms) {
+                    BOOST_REQUIRE_EQUAL(perms.mask(), expected.mask());
+                });
+            }).get();
+        };
+
+        require_permissions(auth::permission_set::of<auth::permission::SELECT>());
+
+        // The cached permissions are kept until the cache is reset.
+        cquery_nofail(env, "GRANT MODIFY ON t TO bob");
+        require_permissions(auth::permission_set::of<auth::permission::SELECT>());
+
+        auth_service.invoke_on(0, [] (auth::service& s) {
+            s.reset_authorization_cache();
+        }).get();
+        auth_service.invoke_on_others([] (auth::service& s) {
+            s.reset_authorization_cache();
+        }).get();
+        require_permissions(auth::permission_set::of<auth::permission::SELECT, auth::permission::MODIFY>());
+    }, config);
+}
@@ -47,7 +47,9 @@ SEASTAR_TEST_CASE(test_large_row_count) {
 
 static void flush(cql_test_env& e) {
     e.db().invoke_on_all([](replica::database& dbi) {
-        return dbi.flush_all_memtables();
+        return dbi.flush_all_memtables().then([&dbi] {
+            return dbi.get_user_sstables_manager().get_large_data_handler().flush_records();
+        });
     }).get();
 }
 
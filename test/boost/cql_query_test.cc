@@ -42,6 +42,7 @@
 #include <regex>
 #include "gms/feature.hh"
 #include "db/query_context.hh"
+#include "db/functions/column_batch.hh"
 #include "service/qos/qos_common.hh"
 #include "utils/UUID_gen.hh"
 
@@ -3761,6 +3762,60 @@ SEASTAR_TEST_CASE(test_aggregate_and_simple_selection_together) {
     });
 }
 
+SEASTAR_TEST_CASE(test_prepared_select_with_constant_clustering_bounds) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "create table t (p int, c int, v int, primary key(p, c))");
+        for (int c = 0; c < 5; c++) {
+            cquery_nofail(e, format("insert into t (p, c, v) values (1, {}, {})", c, c * 10));
+        }
+        auto& stats = e.local_qp().get_cql_stats();
+        auto reverse_queries = stats.reverse_queries;
+        // The clustering bounds and the selected columns are computed once, when preparing.
+        auto id = e.prepare("select c, v from t where p = ? and c in (3, 1, 4) order by c desc").get0();
+        for (int i = 0; i < 2; i++) {
+            auto msg = e.execute_prepared(id, {cql3::raw_value::make_value(I(1))}).get0();
+            assert_that(msg).is_rows().with_rows({{I(4), I(40)}, {I(3), I(30)}, {I(1), I(10)}});
+        }
+        BOOST_REQUIRE_EQUAL(stats.reverse_queries, reverse_queries + 2);
+        // Bounds depending on the bound values are computed on each execution.
+        id = e.prepare("select c from t where p = 1 and c >= ?").get0();
+        assert_that(e.execute_prepared(id, {cql3::raw_value::make_value(I(3))}).get0()).is_rows().with_rows({{I(3)}, {I(4)}});
+        assert_that(e.execute_prepared(id, {cql3::raw_value::make_value(I(4))}).get0()).is_rows().with_rows({{I(4)}});
+    });
+}
+
+SEASTAR_TEST_CASE(test_aggregates_over_column_batches) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "create table t (p int, c int, v int, d double, primary key(p, c))");
+        // More rows than fit in a single batch, with some nulls in v.
+        const int rows = db::functions::column_batch::max_rows * 3 / 2;
+        int64_t count_v = 0;
+        int32_t sum_v = 0, min_v = std::numeric_limits<int32_t>::max(), max_v = std::numeric_limits<int32_t>::min();
+        double sum_d = 0;
+        for (int c = 0; c < rows; c++) {
+            if (c % 7 == 0) {
+                cquery_nofail(e, format("insert into t (p, c, d) values ({}, {}, {})", c % 3, c, c / 2.0));
+            } else {
+                cquery_nofail(e, format("insert into t (p, c, v, d) values ({}, {}, {}, {})", c % 3, c, c, c / 2.0));
+                ++count_v;
+                sum_v += c;
+                min_v = std::min(min_v, c);
+                max_v = std::max(max_v, c);
+            }
+            sum_d += c / 2.0;
+        }
+        require_rows(e, "select count(*), count(v), sum(v), min(v), max(v), avg(v) from t",
+                {{L(rows), L(count_v), I(sum_v), I(min_v), I(max_v), I(sum_v / count_v)}});
+        require_rows(e, "select sum(d), min(d), max(d), avg(d) from t",
+                {{double_type->decompose(sum_d), double_type->decompose(0.0), double_type->decompose((rows - 1) / 2.0),
+                  double_type->decompose(sum_d / rows)}});
+
+        // Empty values aren't nulls.
+        cquery_nofail(e, "insert into t (p, c, v) values (0, -1, blobasint(0x))");
+        require_rows(e, "select count(*), count(v) from t", {{L(rows + 1), L(count_v + 1)}});
+    });
+}
+
 SEASTAR_TEST_CASE(test_alter_type_on_compact_storage_with_no_regular_columns_does_not_crash) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         cquery_nofail(e, "CREATE TYPE my_udf (first text);");
@@ -5001,6 +5056,27 @@ SEASTAR_TEST_CASE(test_counter_column_added_into_non_counter_table) {
     });
 }
 
+SEASTAR_TEST_CASE(test_coalesced_counter_updates) {
+    cql_test_config cfg;
+    cfg.db_config->counter_update_coalescing_window_in_us.set(10000);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, c1 counter, c2 counter, PRIMARY KEY (pk, ck))");
+
+        std::vector<future<shared_ptr<cql_transport::messages::result_message>>> updates;
+        for (int i = 0; i < 10; ++i) {
+            updates.push_back(e.execute_cql(format("UPDATE t SET c1 = c1 + {}, c2 = c2 - 1 WHERE pk = 0 AND ck = {}", i, i % 2)));
+        }
+        // A deletion is not merged with the increments.
+        updates.push_back(e.execute_cql("DELETE c2 FROM t WHERE pk = 1 AND ck = 0"));
+        when_all_succeed(updates.begin(), updates.end()).get();
+
+        assert_that(cquery_nofail(e, "SELECT ck, c1, c2 FROM t WHERE pk = 0")).is_rows().with_rows({
+            {int32_type->decompose(0), long_type->decompose(int64_t(20)), long_type->decompose(int64_t(-5))},
+            {int32_type->decompose(1), long_type->decompose(int64_t(25)), long_type->decompose(int64_t(-5))},
+        });
+    }, std::move(cfg));
+}
+
 SEASTAR_THREAD_TEST_CASE(test_invalid_using_timestamps) {
     do_with_cql_env_thread([] (cql_test_env& e) {
         auto now_nano = std::chrono::duration_cast<std::chrono::nanoseconds>(db_clock::now().time_since_epoch()).count();
@@ -5069,6 +5145,49 @@ SEASTAR_THREAD_TEST_CASE(test_twcs_optimal_query_path) {
     }).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_range_scan_skips_sstables_by_clustering_range) {
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE tbl (pk int, ck int, v int, PRIMARY KEY (pk, ck))").get();
+
+        auto flush = [&] {
+            e.db().invoke_on_all([] (replica::database& db) {
+                return db.flush_all_memtables();
+            }).get();
+        };
+        auto get_stat = [&] (int64_t replica::cf_stats::* stat) {
+            return e.db().map_reduce0([stat] (replica::database& db) {
+                return db.find_column_family("ks", "tbl").cf_stats()->*stat;
+            }, int64_t(0), std::plus<int64_t>()).get0();
+        };
+
+        for (int pk = 0; pk < 4; ++pk) {
+            e.execute_cql(format("INSERT INTO tbl (pk, ck, v) VALUES ({}, 0, 0)", pk)).get();
+        }
+        flush();
+        for (int pk = 0; pk < 4; ++pk) {
+            e.execute_cql(format("INSERT INTO tbl (pk, ck, v) VALUES ({}, 10, 1)", pk)).get();
+        }
+        flush();
+
+        auto checked = get_stat(&replica::cf_stats::sstables_checked_by_clustering_filter);
+        auto surviving = get_stat(&replica::cf_stats::surviving_sstables_after_clustering_filter);
+
+        assert_that(e.execute_cql("SELECT pk, ck, v FROM tbl WHERE ck >= 5 ALLOW FILTERING BYPASS CACHE").get0())
+            .is_rows().with_rows_ignore_order({
+                {int32_type->decompose(0), int32_type->decompose(10), int32_type->decompose(1)},
+                {int32_type->decompose(1), int32_type->decompose(10), int32_type->decompose(1)},
+                {int32_type->decompose(2), int32_type->decompose(10), int32_type->decompose(1)},
+                {int32_type->decompose(3), int32_type->decompose(10), int32_type->decompose(1)},
+            });
+
+        // Only the sstables of the second flush have rows in the range.
+        checked = get_stat(&replica::cf_stats::sstables_checked_by_clustering_filter) - checked;
+        surviving = get_stat(&replica::cf_stats::surviving_sstables_after_clustering_filter) - surviving;
+        BOOST_REQUIRE_GT(checked, 0);
+        BOOST_REQUIRE_EQUAL(surviving * 2, checked);
+    }).get();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_query_unselected_columns) {
     cql_test_config cfg;
 
@@ -5336,7 +5455,66 @@ SEASTAR_TEST_CASE(test_parallelized_select_sum_group_by) {
             {int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t((value_count - 1) * value_count / 2))}
         });
 
-        BOOST_CHECK_EQUAL(stat_parallelized, qp.get_cql_stats().select_parallelized);
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+    });
+}
+
+SEASTAR_TEST_CASE(test_parallelized_select_group_by_clustering_prefix) {
+    return with_parallelized_aggregation_enabled_thread([](cql_test_env& e) {
+        auto& qp = e.local_qp();
+        auto stat_parallelized = qp.get_cql_stats().select_parallelized;
+
+        e.execute_cql("CREATE TABLE tbl (k int, c1 int, c2 int, v int, PRIMARY KEY (k, c1, c2));").get();
+        for (int k = 0; k < 2; k++) {
+            for (int c1 = 0; c1 < 3; c1++) {
+                for (int c2 = 0; c2 <= c1; c2++) {
+                    e.execute_cql(format("INSERT INTO tbl (k, c1, c2, v) VALUES ({:d}, {:d}, {:d}, {:d});", k, c1, c2, k * 10 + c2)).get();
+                }
+            }
+        }
+
+        auto row = [] (int k, int c1) {
+            // c2 takes the values 0..c1 in group (k, c1), and v = k * 10 + c2.
+            // k is fetched for GROUP BY, so it's the last (non-serialized) column.
+            return std::vector<bytes_opt>{
+                long_type->decompose(int64_t(c1 + 1)),
+                int32_type->decompose(int32_t(c1)),
+                int32_type->decompose(int32_t(k * 10 + c1)),
+                int32_type->decompose(int32_t(k * 10 * (c1 + 1) + c1 * (c1 + 1) / 2)),
+                int32_type->decompose(int32_t(k)),
+            };
+        };
+
+        // The selected GROUP BY column doesn't come first, and k isn't selected at all.
+        auto msg = e.execute_cql("SELECT COUNT(*), c1, MAX(v), SUM(v) FROM tbl GROUP BY k, c1;").get();
+        assert_that(msg).is_rows().with_rows({
+            row(1, 0), row(1, 1), row(1, 2),
+            row(0, 0), row(0, 1), row(0, 2),
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 1, qp.get_cql_stats().select_parallelized);
+
+        msg = e.execute_cql("SELECT COUNT(*), c1, MAX(v), SUM(v) FROM tbl GROUP BY k, c1 LIMIT 4;").get();
+        assert_that(msg).is_rows().with_rows({
+            row(1, 0), row(1, 1), row(1, 2),
+            row(0, 0),
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 2, qp.get_cql_stats().select_parallelized);
+
+        // PER PARTITION LIMIT applies to groups, it's not supported by parallelized aggregation.
+        msg = e.execute_cql("SELECT COUNT(*), c1, MAX(v), SUM(v) FROM tbl GROUP BY k, c1 PER PARTITION LIMIT 1;").get();
+        assert_that(msg).is_rows().with_rows({
+            row(1, 0),
+            row(0, 0),
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 2, qp.get_cql_stats().select_parallelized);
+
+        // Selecting a column which isn't in GROUP BY isn't supported either.
+        msg = e.execute_cql("SELECT k, c2, COUNT(*) FROM tbl GROUP BY k;").get();
+        assert_that(msg).is_rows().with_rows({
+            {int32_type->decompose(int32_t(1)), int32_type->decompose(int32_t(0)), long_type->decompose(int64_t(6))},
+            {int32_type->decompose(int32_t(0)), int32_type->decompose(int32_t(0)), long_type->decompose(int64_t(6))},
+        });
+        BOOST_CHECK_EQUAL(stat_parallelized + 2, qp.get_cql_stats().select_parallelized);
     });
 }
 
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "cql3/simple_statement_parser.hh"
+#include "cql3/statements/raw/parsed_statement.hh"
+#include "db/config.hh"
+#include "exceptions/exceptions.hh"
+#include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
+#include "transport/messages/result_message.hh"
+
+// A comment makes the simple parser give up, so appending one to a
+// statement has it parsed by the ANTLR parser.
+static sstring with_antlr(std::string_view query) {
+    return format("{} /* parsed by ANTLR */", query);
+}
+
+static std::vector<std::vector<bytes_opt>> rows_of(shared_ptr<cql_transport::messages::result_message> msg) {
+    auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+    BOOST_REQUIRE(rows);
+    const auto& rs = rows->rs().result_set().rows();
+    return {rs.begin(), rs.end()};
+}
+
+SEASTAR_THREAD_TEST_CASE(test_simple_statement_shapes) {
+    for (std::string_view q : {
+            "SELECT * FROM t",
+            "select a, \"B\", key FROM ks.t WHERE a = 1 AND b >= -2.5e3 AND c != 'x''y' LIMIT 10 ALLOW FILTERING BYPASS CACHE;",
+            "SELECT a FROM t WHERE u = 01234567-89ab-cdef-0123-456789abcdef AND b = 0xcafe AND c = true AND d = null",
+            "INSERT INTO ks.t (a, b, c) VALUES (1, 'two', 3.0) IF NOT EXISTS",
+            "UPDATE t SET a = 1, b = 'x' WHERE k = 0",
+            "DELETE FROM t WHERE k = 0 AND c < 5",
+            "DELETE a, b FROM t WHERE k = 0;;",
+            "INSERT INTO t (k, v) VALUES (1, 'zażółć')",
+    }) {
+        BOOST_TEST_MESSAGE(q);
+        BOOST_REQUIRE(cql3::try_parse_simple_statement(q));
+    }
+
+    for (std::string_view q : {
+            "",
+            "SELECT * FROM t WHERE a = ?",
+            "SELECT * FROM t WHERE a = :x",
+            "SELECT * FROM t -- comment\n",
+            "SELECT count(*) FROM t",
+            "SELECT a AS b FROM t",
+            "SELECT DISTINCT a FROM t",
+            "SELECT JSON a FROM t",
+            "SELECT * FROM t WHERE a IN (1, 2)",
+            "SELECT * FROM t WHERE token(a) > 0",
+            "SELECT * FROM t WHERE a = 1 ORDER BY b DESC",
+            "SELECT * FROM t WHERE d = 1h",
+            "SELECT * FROM t WHERE a = now()",
+            "SELECT * FROM t WHERE a = {1, 2}",
+            "SELECT * FROM t USING TIMEOUT 10s",
+            "SELECT * FROM select",
+            "SELECT P1Y FROM t",
+            "INSERT INTO t JSON '{}'",
+            "INSERT INTO t (a) VALUES (1) USING TTL 10",
+            "UPDATE t USING TTL 10 SET a = 1 WHERE k = 0",
+            "UPDATE t SET a = a + 1 WHERE k = 0",
+            "UPDATE t SET l[0] = 1 WHERE k = 0",
+            "UPDATE t SET a = 1 WHERE k = 0 IF EXISTS",
+            "DELETE l[0] FROM t WHERE k = 0",
+            "DELETE FROM t WHERE k = 0 IF a = 1",
+            "BEGIN BATCH INSERT INTO t (a) VALUES (1) APPLY BATCH",
+            "SELECT * FROM t WHERE a = 1.",
+            "SELECT * FROM t WHERE a = 'unterminated",
+    }) {
+        BOOST_TEST_MESSAGE(q);
+        BOOST_REQUIRE(!cql3::try_parse_simple_statement(q));
+    }
+}
+
+// Statements handled by the simple parser must behave as if they were parsed
+// by the ANTLR parser.
+static void check_simple_statements_match_antlr(cql_test_env& e) {
+    for (auto tbl : {"t1", "t2"}) {
+        cquery_nofail(e, format("CREATE TABLE ks.{} (k int, c int, \"V\" text, f double, b blob, u uuid, s text, "
+                "PRIMARY KEY (k, c))", tbl));
+    }
+    auto both = [&] (std::string_view q) {
+        cquery_nofail(e, fmt::format(fmt::runtime(q), "t1"));
+        cquery_nofail(e, with_antlr(fmt::format(fmt::runtime(q), "t2")));
+    };
+    both("INSERT INTO ks.{} (k, c, \"V\", f, b, u) VALUES (1, 1, 'it''s', -1.5e2, 0xcafe, 01234567-89ab-cdef-0123-456789abcdef)");
+    both("INSERT INTO {} (k, c, \"V\") VALUES (1, 2, 'x') IF NOT EXISTS");
+    both("INSERT INTO {} (k, c, \"V\") VALUES (1, 2, 'y') IF NOT EXISTS");
+    both("INSERT INTO {} (k, c, s) VALUES (2, 1, null)");
+    both("UPDATE {} SET \"V\" = 'z', f = 3 WHERE k = 2 AND c = 1");
+    both("UPDATE {} SET s = 'a' WHERE k = 2 AND c = 2");
+    both("DELETE f FROM {} WHERE k = 1 AND c = 1");
+    both("DELETE FROM {} WHERE k = 2 AND c > 1");
+
+    for (auto q : {
+            "SELECT * FROM ks.{}",
+            "SELECT k, c, \"V\" FROM {} WHERE k = 1",
+            "SELECT * FROM {} WHERE k = 2 AND c >= 1 AND c < 3 LIMIT 1",
+            "SELECT * FROM {} WHERE \"V\" != 'x' ALLOW FILTERING",
+            "SELECT u FROM {} WHERE k = 1 AND c <= 1 BYPASS CACHE",
+    }) {
+        BOOST_TEST_MESSAGE(q);
+        auto expected = rows_of(cquery_nofail(e, with_antlr(fmt::format(fmt::runtime(q), "t2"))));
+        assert_that(cquery_nofail(e, fmt::format(fmt::runtime(q), "t1"))).is_rows().with_rows(expected);
+        assert_that(cquery_nofail(e, fmt::format(fmt::runtime(q), "t2"))).is_rows().with_rows(expected);
+    }
+}
+
+SEASTAR_TEST_CASE(test_simple_statements_match_antlr) {
+    return do_with_cql_env_thread(check_simple_statements_match_antlr);
+}
+
+static cql_test_config with_auto_prepare() {
+    cql_test_config cfg;
+    cfg.db_config->auto_prepare_statements.set(true);
+    return cfg;
+}
+
+SEASTAR_TEST_CASE(test_auto_prepared_statements_match_antlr) {
+    return do_with_cql_env_thread(check_simple_statements_match_antlr, with_auto_prepare());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_normalize_simple_statement) {
+    auto n = cql3::normalize_simple_statement("select \"A\"\"b\" FROM ks.t WHERE a = 'x''y' AND b<=-1 LIMIT 10");
+    BOOST_REQUIRE(n);
+    BOOST_REQUIRE_EQUAL(n->query, "select \"A\"\"b\" FROM ks . t WHERE a = ? AND b <= ? LIMIT ?");
+    BOOST_REQUIRE_EQUAL(n->values.size(), 3);
+    BOOST_REQUIRE_EQUAL(n->values[0].raw_text, "x'y");
+    BOOST_REQUIRE_EQUAL(n->values[1].raw_text, "-1");
+    BOOST_REQUIRE_EQUAL(n->values[2].raw_text, "10");
+
+    // Constants of different kinds give different keys.
+    BOOST_REQUIRE_EQUAL(cql3::normalize_simple_statement("SELECT * FROM t LIMIT 1")->key,
+            cql3::normalize_simple_statement("SELECT * FROM t LIMIT 2")->key);
+    BOOST_REQUIRE_NE(cql3::normalize_simple_statement("SELECT * FROM t LIMIT 1")->key,
+            cql3::normalize_simple_statement("SELECT * FROM t LIMIT 'x'")->key);
+    BOOST_REQUIRE(!cql3::normalize_simple_statement("SELECT * FROM t WHERE a = ?"));
+}
+
+SEASTAR_TEST_CASE(test_auto_prepared_statements) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (k int PRIMARY KEY, v text, w int)");
+        for (int i = 0; i < 3; ++i) {
+            cquery_nofail(e, format("INSERT INTO t (k, v, w) VALUES ({}, 'v{}', {})", i, i, i));
+        }
+        assert_that(cquery_nofail(e, "SELECT k, v FROM t WHERE k = 1")).is_rows().with_rows({
+            {int32_type->decompose(1), utf8_type->decompose("v1")},
+        });
+        assert_that(cquery_nofail(e, "SELECT k, v FROM t WHERE k = 2")).is_rows().with_rows({
+            {int32_type->decompose(2), utf8_type->decompose("v2")},
+        });
+
+        // Constants are validated as if they were in the statement.
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT k FROM t WHERE k = 'x'").get(), exceptions::invalid_request_exception);
+        BOOST_REQUIRE_THROW(e.execute_cql("INSERT INTO t (k, v) VALUES (1, 2)").get(), exceptions::invalid_request_exception);
+        // Not all simple looking statements are simple.
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT * FROM t LIMIT 'x'").get(), exceptions::syntax_exception);
+        assert_that(cquery_nofail(e, "SELECT count(*) FROM t")).is_rows().with_rows({{long_type->decompose(int64_t(3))}});
+
+        // Schema changes invalidate the prepared statements.
+        cquery_nofail(e, "SELECT w FROM t WHERE k = 1");
+        cquery_nofail(e, "ALTER TABLE t DROP w");
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT w FROM t WHERE k = 1").get(), exceptions::invalid_request_exception);
+        cquery_nofail(e, "ALTER TABLE t ADD w text");
+        cquery_nofail(e, "UPDATE t SET w = 'w' WHERE k = 1");
+        assert_that(cquery_nofail(e, "SELECT w FROM t WHERE k = 1")).is_rows().with_rows({{utf8_type->decompose("w")}});
+    }, with_auto_prepare());
+}
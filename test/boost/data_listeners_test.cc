@@ -114,3 +114,32 @@ SEASTAR_TEST_CASE(test_dlistener_t2) {
         BOOST_REQUIRE_EQUAL(0, res.write);
     });
 }
+
+SEASTAR_TEST_CASE(test_hot_partitions) {
+    cql_test_config cfg;
+    cfg.db_config->hot_partitions_sampling_period.set(1);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE hot (k int, c int, PRIMARY KEY (k, c));").get();
+        for (int i = 0; i < 10; ++i) {
+            e.execute_cql(format("INSERT INTO hot (k, c) VALUES (1, {});", i)).get();
+        }
+        e.execute_cql("INSERT INTO hot (k, c) VALUES (2, 0);").get();
+        for (int i = 0; i < 5; ++i) {
+            e.execute_cql("SELECT * FROM hot WHERE k = 1;").get();
+        }
+
+        auto id = e.local_db().find_schema("ks", "hot")->id();
+        auto hot = db::get_hot_partitions(e.db(), id).get0();
+
+        auto writes = hot.writes.top(10);
+        BOOST_REQUIRE_EQUAL(writes.size(), 2);
+        BOOST_REQUIRE_EQUAL(writes[0].count, 10);
+        BOOST_REQUIRE_EQUAL(writes[1].count, 1);
+
+        auto reads = hot.reads.top(10);
+        BOOST_REQUIRE_EQUAL(reads.size(), 1);
+        BOOST_REQUIRE_EQUAL(reads[0].count, 5);
+
+        BOOST_REQUIRE_EQUAL(hot.write_kbytes.top(10).size(), 2);
+    }, std::move(cfg));
+}
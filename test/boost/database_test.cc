@@ -19,6 +19,7 @@
 #include "test/lib/result_set_assertions.hh"
 #include "test/lib/log.hh"
 #include "test/lib/random_utils.hh"
+#include "test/lib/eventually.hh"
 
 #include "replica/database.hh"
 #include "utils/lister.hh"
@@ -182,6 +183,41 @@ SEASTAR_TEST_CASE(test_truncate_without_snapshot_during_writes) {
     }, cfg);
 }
 
+SEASTAR_TEST_CASE(test_truncate_deletes_sstables_in_background) {
+    auto cfg = make_shared<db::config>();
+    cfg->auto_snapshot.set(false);
+    return do_with_cql_env_and_compaction_groups([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k int primary key, v int);").get();
+        for (int i = 0; i < 10; ++i) {
+            e.execute_cql(format("insert into ks.cf (k, v) values ({}, {});", i, i)).get();
+            replica::database::flush_table_on_all_shards(e.db(), "ks", "cf").get();
+        }
+
+        auto files = e.db().map_reduce0([] (replica::database& db) {
+            std::vector<sstring> files;
+            for (auto& sst : *db.find_column_family("ks", "cf").get_sstables()) {
+                files.push_back(sst->get_filename());
+            }
+            return files;
+        }, std::vector<sstring>(), [] (std::vector<sstring> a, std::vector<sstring> b) {
+            std::move(b.begin(), b.end(), std::back_inserter(a));
+            return a;
+        }).get0();
+        BOOST_REQUIRE(!files.empty());
+
+        replica::database::truncate_table_on_all_shards(e.db(), "ks", "cf").get();
+
+        e.db().invoke_on_all([] (replica::database& db) {
+            BOOST_REQUIRE(db.find_column_family("ks", "cf").get_sstables()->empty());
+        }).get();
+        eventually([&] {
+            for (auto& f : files) {
+                BOOST_REQUIRE(!file_exists(f).get0());
+            }
+        });
+    }, cfg);
+}
+
 SEASTAR_TEST_CASE(test_querying_with_limits) {
     return do_with_cql_env_and_compaction_groups([](cql_test_env& e) {
             // FIXME: restore indent.
@@ -747,11 +783,34 @@ SEASTAR_TEST_CASE(clear_nonexistent_snapshot) {
     });
 }
 
+// Starts a snapshot_ctl, and the task manager which runs its backups.
+class snapshot_ctl_env {
+    sharded<abort_source> _as;
+    sharded<tasks::task_manager> _tm;
+    sharded<db::snapshot_ctl> _sc;
+public:
+    explicit snapshot_ctl_env(cql_test_env& e) {
+        _as.start().get();
+        _tm.start(tasks::task_manager::config{.task_ttl = utils::updateable_value<uint32_t>(3600)}, std::ref(_as)).get();
+        _sc.start(std::ref(e.db()), std::ref(_tm)).get();
+    }
+    ~snapshot_ctl_env() {
+        _sc.stop().get();
+        _tm.stop().get();
+        _as.stop().get();
+    }
+    sharded<db::snapshot_ctl>& sc() noexcept {
+        return _sc;
+    }
+    tasks::task_manager& tm() noexcept {
+        return _tm.local();
+    }
+};
+
 SEASTAR_TEST_CASE(test_snapshot_ctl_details) {
     return do_with_some_data({"cf"}, [] (cql_test_env& e) {
-        sharded<db::snapshot_ctl> sc;
-        sc.start(std::ref(e.db())).get();
-        auto stop_sc = deferred_stop(sc);
+        snapshot_ctl_env env(e);
+        auto& sc = env.sc();
 
         auto& cf = e.local_db().find_column_family("ks", "cf");
         take_snapshot(e).get();
@@ -799,9 +858,8 @@ SEASTAR_TEST_CASE(test_snapshot_ctl_details) {
 
 SEASTAR_TEST_CASE(test_snapshot_ctl_true_snapshots_size) {
     return do_with_some_data({"cf"}, [] (cql_test_env& e) {
-        sharded<db::snapshot_ctl> sc;
-        sc.start(std::ref(e.db())).get();
-        auto stop_sc = deferred_stop(sc);
+        snapshot_ctl_env env(e);
+        auto& sc = env.sc();
 
         auto& cf = e.local_db().find_column_family("ks", "cf");
         take_snapshot(e).get();
@@ -833,6 +891,51 @@ SEASTAR_TEST_CASE(test_snapshot_ctl_true_snapshots_size) {
     });
 }
 
+SEASTAR_TEST_CASE(test_snapshot_ctl_backup) {
+    return do_with_some_data({"cf"}, [] (cql_test_env& e) {
+        snapshot_ctl_env env(e);
+        auto& sc = env.sc();
+        tmpdir backup_dir;
+
+        auto backup = [&] (sstring tag) {
+            auto id = sc.local().start_backup("ks", tag, backup_dir.path().native()).get0();
+            auto task = env.tm().get_all_tasks().at(id);
+            task->done().get();
+            BOOST_REQUIRE(task->get_status().state == tasks::task_manager::task_state::done);
+            return task->get_progress().get0();
+        };
+
+        auto& cf = e.local_db().find_column_family("ks", "cf");
+        auto table_backup_dir = backup_dir.path() / "ks" / fs::path(cf.dir()).filename();
+
+        take_snapshot(e, "ks", "cf", "first").get();
+        auto first = backup("first");
+        BOOST_REQUIRE_GT(first.total, 0);
+        BOOST_REQUIRE_EQUAL(first.completed, first.total);
+        auto snapshot_dir = fs::path(cf.dir()) / sstables::snapshots_dir / "first";
+        lister::scan_dir(snapshot_dir, lister::dir_entry_types::of<directory_entry_type::regular>(), [&] (fs::path parent_dir, directory_entry de) {
+            auto copy = de.name == "manifest.json" || de.name == "schema.cql"
+                    ? table_backup_dir / sstables::snapshots_dir / "first" / de.name
+                    : table_backup_dir / de.name;
+            BOOST_REQUIRE_EQUAL(fs::file_size(copy), fs::file_size(parent_dir / de.name));
+            return make_ready_future<>();
+        }).get();
+
+        // Only the sstables written since the first snapshot are copied.
+        e.execute_cql("insert into cf (p1, c1, c2, r1) values ('key3', 7, 8, 9);").get();
+        take_snapshot(e, "ks", "cf", "second").get();
+        auto second = backup("second");
+        BOOST_REQUIRE_GT(second.total, 0);
+        BOOST_REQUIRE_LT(second.total, first.total);
+        BOOST_REQUIRE(fs::exists(table_backup_dir / sstables::snapshots_dir / "second" / "manifest.json"));
+
+        auto id = sc.local().start_backup("ks", "nonexistent", backup_dir.path().native()).get0();
+        BOOST_REQUIRE_THROW(env.tm().get_all_tasks().at(id)->done().get(), std::runtime_error);
+
+        return make_ready_future<>();
+    });
+}
+
 // toppartitions_query caused a lw_shared_ptr to cross shards when moving results, #5104
 SEASTAR_TEST_CASE(toppartitions_cross_shard_schema_ptr) {
     return do_with_cql_env_and_compaction_groups([] (cql_test_env& e) {
@@ -1319,3 +1422,57 @@ SEASTAR_TEST_CASE(drop_table_with_explicit_snapshot) {
         co_return;
     });
 }
+
+SEASTAR_TEST_CASE(test_coordinator_read_latency_percentile) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        using namespace std::chrono_literals;
+        e.execute_cql("create table cf (p int primary key, v int)").get();
+        auto& cf = e.local_db().find_column_family("ks", "cf");
+
+        // Not enough reads to estimate the 99th percentile.
+        for (int i = 0; i < 10; ++i) {
+            cf.add_coordinator_read_latency(300us);
+        }
+        BOOST_REQUIRE(!cf.get_coordinator_read_latency_percentile(0.99));
+
+        // Sub-millisecond latencies are not rounded up to a millisecond (values are in microseconds).
+        auto p50 = cf.get_coordinator_read_latency_percentile(0.5);
+        BOOST_REQUIRE(p50);
+        BOOST_REQUIRE_GE(p50->count(), 300);
+        BOOST_REQUIRE_LT(p50->count(), 1000);
+
+        for (int i = 0; i < 1000; ++i) {
+            cf.add_coordinator_read_latency(i < 980 ? 300us : 20ms);
+        }
+        // The cached value is reused for the same percentile.
+        BOOST_REQUIRE(cf.get_coordinator_read_latency_percentile(0.5) == p50);
+        auto p99 = cf.get_coordinator_read_latency_percentile(0.99);
+        BOOST_REQUIRE(p99);
+        BOOST_REQUIRE_GE(p99->count(), 20000);
+        BOOST_REQUIRE_LE(p99->count(), 25000);
+    });
+}
+
+SEASTAR_TEST_CASE(test_write_path_profiler) {
+    cql_test_config cfg;
+    cfg.db_config->write_path_profiling_period.set(1);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (k int PRIMARY KEY, v int);").get();
+        e.execute_cql("CREATE MATERIALIZED VIEW tv AS SELECT * FROM t WHERE v IS NOT NULL AND k IS NOT NULL PRIMARY KEY (v, k);").get();
+        for (int i = 0; i < 10; ++i) {
+            e.execute_cql(format("INSERT INTO t (k, v) VALUES ({}, {});", i, i)).get();
+        }
+
+        auto count = [&] (db::write_stage stage) {
+            return e.db().map_reduce0([stage] (replica::database& db) {
+                return db.get_write_path_profiler().get_histograms()[size_t(stage)].count();
+            }, int64_t(0), std::plus<int64_t>()).get0();
+        };
+        // The writes to the view go through the replica's stages too.
+        BOOST_REQUIRE_GE(count(db::write_stage::memtable), 10);
+        BOOST_REQUIRE_GE(count(db::write_stage::commitlog), 10);
+        BOOST_REQUIRE_GE(count(db::write_stage::view_updates), 10);
+        BOOST_REQUIRE_GE(count(db::write_stage::replication), 10);
+        BOOST_REQUIRE_EQUAL(count(db::write_stage::cdc_augmentation), 0);
+    }, std::move(cfg));
+}
@@ -263,6 +263,42 @@ SEASTAR_TEST_CASE(test_region_groups_basic_throttling) {
     });
 }
 
+SEASTAR_TEST_CASE(test_region_groups_gradual_throttling) {
+    return seastar::async([] {
+        raii_region_group rg({
+            .unspooled_hard_limit = 16 * logalloc::segment_size,
+            .unspooled_throttle_start = 2 * logalloc::segment_size,
+            .max_throttle_delay = 100ms,
+        });
+        auto region = std::make_unique<test_region>();
+        region->listen(&rg);
+
+        // Below the throttle start, requests run right away.
+        auto fut = rg.run_when_memory_available([] {}, db::no_timeout);
+        BOOST_REQUIRE(fut.available());
+        BOOST_REQUIRE_EQUAL(rg.delayed_requests_counter(), 0);
+
+        for (int i = 0; i < 4; ++i) {
+            region->alloc();
+        }
+        BOOST_REQUIRE_GT(rg.unspooled_memory_used(), 2 * logalloc::segment_size);
+        BOOST_REQUIRE_LT(rg.unspooled_memory_used(), 16 * logalloc::segment_size);
+
+        // Past the throttle start, they are delayed, but not blocked.
+        bool executed = false;
+        fut = rg.run_when_memory_available([&executed] { executed = true; }, db::no_timeout);
+        BOOST_REQUIRE(!fut.available());
+        BOOST_REQUIRE_EQUAL(rg.delayed_requests_counter(), 1);
+        BOOST_REQUIRE_EQUAL(rg.blocked_requests_counter(), 0);
+        quiesce(std::move(fut));
+        BOOST_REQUIRE(executed);
+
+        // Requests don't wait past their timeout.
+        fut = rg.run_when_memory_available([] {}, db::timeout_clock::now());
+        quiesce(std::move(fut));
+    });
+}
+
 SEASTAR_TEST_CASE(test_region_groups_fifo_order) {
     // tests that requests that are queued for later execution execute in FIFO order
     return seastar::async([] {
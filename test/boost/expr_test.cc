@@ -532,6 +532,27 @@ BOOST_AUTO_TEST_CASE(evaluate_bind_variable_vs_unset) {
     BOOST_REQUIRE_THROW(evaluate(new_bind_variable(0), evaluation_inputs{.options = &qo}), exceptions::invalid_request_exception);
 }
 
+BOOST_AUTO_TEST_CASE(evaluate_to_view_bind_variable) {
+    schema_ptr test_schema =
+        schema_builder("test_ks", "test_cf").with_column("pk", int32_type, column_kind::partition_key).build();
+    auto [inputs, inputs_data] = make_evaluation_inputs(test_schema, {{"pk", make_int_raw(1)}},
+                                                        {make_int_raw(123), make_bool_raw(true)});
+
+    // The value of the bind variable is not copied into storage.
+    raw_value storage = raw_value::make_null();
+    expression bind_var = bind_variable{.bind_index = 0, .receiver = make_receiver(int32_type, "bind_var_0")};
+    BOOST_REQUIRE_EQUAL(raw_value::make_value(evaluate_to_view(bind_var, *inputs.options, storage)), make_int_raw(123));
+    BOOST_REQUIRE(storage.is_null());
+
+    expression invalid_bind_var = bind_variable{.bind_index = 1, .receiver = make_receiver(int32_type, "bind_var_1")};
+    BOOST_REQUIRE_THROW(evaluate_to_view(invalid_bind_var, *inputs.options, storage), exceptions::invalid_request_exception);
+
+    // Other expressions are evaluated into storage.
+    expression value = make_int_const(456);
+    BOOST_REQUIRE_EQUAL(raw_value::make_value(evaluate_to_view(value, *inputs.options, storage)), make_int_raw(456));
+    BOOST_REQUIRE_EQUAL(storage, make_int_raw(456));
+}
+
 BOOST_AUTO_TEST_CASE(evaluate_list_collection_constructor_empty) {
     // TODO: Empty multi-cell collections are trated as NULL in the database,
     // should the conversion happen in evaluate?
@@ -866,6 +887,23 @@ BOOST_AUTO_TEST_CASE(evaluate_subscripted_map_basic) {
     BOOST_REQUIRE_EQUAL(evaluate_subscripted(map, make_int_const(6)), make_int_raw(7));
 }
 
+BOOST_AUTO_TEST_CASE(evaluate_subscripted_every_element) {
+    std::vector<constant> elements;
+    std::vector<std::pair<constant, constant>> entries;
+    for (int i = 0; i < 100; ++i) {
+        elements.push_back(make_int_const(i * 10));
+        entries.emplace_back(make_int_const(i), make_int_const(i * 10));
+    }
+    constant list = make_list_const(elements, int32_type);
+    constant map = make_map_const(entries, int32_type, int32_type);
+    for (int i = 0; i < 100; ++i) {
+        BOOST_REQUIRE_EQUAL(evaluate_subscripted(list, make_int_const(i)), make_int_raw(i * 10));
+        BOOST_REQUIRE_EQUAL(evaluate_subscripted(map, make_int_const(i)), make_int_raw(i * 10));
+    }
+    BOOST_REQUIRE_EQUAL(evaluate_subscripted(list, make_int_const(100)), raw_value::make_null());
+    BOOST_REQUIRE_EQUAL(evaluate_subscripted(map, make_int_const(100)), raw_value::make_null());
+}
+
 BOOST_AUTO_TEST_CASE(evaluate_subscripted_map_nonexistant_key) {
     constant map = make_subscript_test_map();
     BOOST_REQUIRE_EQUAL(evaluate_subscripted(map, make_int_const(3)), raw_value::make_null());
@@ -30,6 +30,35 @@ BOOST_AUTO_TEST_CASE(xx_hasher_sanity_check) {
     BOOST_CHECK_EQUAL(hash, expected);
 }
 
+BOOST_AUTO_TEST_CASE(xxh3_hasher_coalesces_updates) {
+    auto hash_of = [] (const bytes& b) {
+        xxh3_hasher hasher;
+        hasher.update(reinterpret_cast<const char*>(b.data()), b.size());
+        return hasher.finalize();
+    };
+
+    bytes data(bytes::initialized_later(), 5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = int8_t(i * 31);
+    }
+    auto expected = hash_of(data);
+    BOOST_REQUIRE_NE(expected, hash_of(bytes(data.begin(), data.begin() + 4999)));
+
+    // Small updates, and updates which don't fit the buffer or are larger than it.
+    for (size_t step : {1, 7, 64, 1000, 1024, 1500, 4096}) {
+        xxh3_hasher hasher;
+        for (size_t pos = 0; pos < data.size(); pos += step) {
+            auto len = std::min(step, data.size() - pos);
+            hasher.update(reinterpret_cast<const char*>(data.data() + pos), len);
+            if (pos >= data.size() / 2 && pos < data.size() / 2 + step) {
+                auto copy = hasher;
+                hasher = copy;
+            }
+        }
+        BOOST_REQUIRE_EQUAL(hasher.finalize(), expected);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(md5_hasher_sanity_check) {
     md5_hasher hasher;
     hasher.update(reinterpret_cast<const char*>(std::data(text_part1)), std::size(text_part1));
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include "sstables/hyperloglog.hh"
+
+static hll::HyperLogLog make_hll(uint64_t first, uint64_t last) {
+    hll::HyperLogLog ret;
+    for (uint64_t i = first; i < last; ++i) {
+        // Spread the values over the whole hash space, as hashes of keys are.
+        ret.offer_hashed(i * 0x9E3779B97F4A7C15ull);
+    }
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(test_from_bytes_restores_the_estimate) {
+    auto hll = make_hll(0, 1000);
+    auto bytes = hll.get_bytes();
+    auto restored = hll::HyperLogLog::from_bytes(bytes.get(), bytes.size());
+    BOOST_REQUIRE_EQUAL(restored.registerSize(), hll.registerSize());
+    BOOST_REQUIRE_EQUAL(restored.estimate(), hll.estimate());
+}
+
+BOOST_AUTO_TEST_CASE(test_from_bytes_rejects_malformed_bytes) {
+    auto bytes = make_hll(0, 1000).get_bytes();
+    BOOST_REQUIRE_THROW(hll::HyperLogLog::from_bytes(bytes.get(), bytes.size() - 1), std::invalid_argument);
+    BOOST_REQUIRE_THROW(hll::HyperLogLog::from_bytes(bytes.get(), 2), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_of_restored_estimators) {
+    auto a = make_hll(0, 1000).get_bytes();
+    auto b = make_hll(0, 1000).get_bytes();
+    auto c = make_hll(1000, 2000).get_bytes();
+
+    // Identical sets merge into the same estimate, disjoint ones add up.
+    auto same = hll::HyperLogLog::from_bytes(a.get(), a.size());
+    same.merge(hll::HyperLogLog::from_bytes(b.get(), b.size()));
+    BOOST_REQUIRE_EQUAL(same.estimate(), hll::HyperLogLog::from_bytes(a.get(), a.size()).estimate());
+
+    auto disjoint = hll::HyperLogLog::from_bytes(a.get(), a.size());
+    disjoint.merge(hll::HyperLogLog::from_bytes(c.get(), c.size()));
+    BOOST_REQUIRE_GT(disjoint.estimate(), same.estimate());
+}
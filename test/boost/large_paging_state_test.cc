@@ -113,3 +113,46 @@ SEASTAR_TEST_CASE(test_use_high_bits_of_remaining_rows_in_paging_state_filtering
         }
     });
 }
+
+// Range scans save the concurrency they ramped up to in the paging state, so
+// the next page can start at it. The value comes from the client, so an
+// out-of-range one must not break the query.
+SEASTAR_TEST_CASE(test_concurrency_factor_in_paging_state) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE test (pk int, ck int, PRIMARY KEY (pk, ck));").get();
+        auto id = e.prepare("INSERT INTO test (pk, ck) VALUES (?, ?);").get0();
+        const auto cql3_ck = cql3::raw_value::make_value(int32_type->decompose(data_value(0)));
+
+        const int total_rows = 100;
+        for (int i = 0; i < total_rows; i++) {
+            const auto cql3_pk = cql3::raw_value::make_value(int32_type->decompose(data_value(i)));
+            e.execute_prepared(id, {cql3_pk, cql3_ck}).get();
+        }
+
+        for (auto concurrency_factor : {uint32_t(0), uint32_t(1), std::numeric_limits<uint32_t>::max()}) {
+            auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                        cql3::query_options::specific_options{10, nullptr, {}, api::new_timestamp()});
+            auto msg = e.execute_cql("SELECT * FROM test;", std::move(qo)).get0();
+            size_t rows_fetched = count_rows_fetched(msg);
+            auto paging_state = extract_paging_state(msg);
+            BOOST_REQUIRE(paging_state);
+            BOOST_REQUIRE_GE(paging_state->get_concurrency_factor(), 1);
+
+            while (has_more_pages(msg)) {
+                paging_state->set_concurrency_factor(concurrency_factor);
+                auto state = service::pager::paging_state::deserialize(paging_state->serialize());
+                BOOST_REQUIRE_EQUAL(state->get_concurrency_factor(), concurrency_factor);
+                qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                        cql3::query_options::specific_options{10, state, {}, api::new_timestamp()});
+                msg = e.execute_cql("SELECT * FROM test;", std::move(qo)).get0();
+                rows_fetched += count_rows_fetched(msg);
+                if (has_more_pages(msg)) {
+                    paging_state = extract_paging_state(msg);
+                    BOOST_REQUIRE(paging_state);
+                    BOOST_REQUIRE_GE(paging_state->get_concurrency_factor(), 1);
+                }
+            }
+            BOOST_REQUIRE_EQUAL(rows_fetched, total_rows);
+        }
+    });
+}
@@ -430,6 +430,39 @@ BOOST_AUTO_TEST_CASE(test_dollar) {
     BOOST_TEST(matches(matcher(u8R"(a\$bc)"), u8"a$bc"));
 }
 
+BOOST_AUTO_TEST_CASE(test_simple_patterns) {
+    // Patterns matched without a regex.
+    auto any = matcher(u8"%%");
+    BOOST_TEST(matches(any, u8""));
+    BOOST_TEST(matches(any, u8"a\nb"));
+
+    auto prefix = matcher(u8"ab%");
+    BOOST_TEST(matches(prefix, u8"ab"));
+    BOOST_TEST(matches(prefix, u8"abШ"));
+    BOOST_TEST(!matches(prefix, u8"a"));
+    BOOST_TEST(!matches(prefix, u8"bab"));
+
+    auto suffix = matcher(u8"%Шb");
+    BOOST_TEST(matches(suffix, u8"Шb"));
+    BOOST_TEST(matches(suffix, u8"aШb"));
+    BOOST_TEST(!matches(suffix, u8"Шba"));
+
+    auto contains = matcher(u8R"(%%a\%\_%)");
+    BOOST_TEST(matches(contains, u8"a%_"));
+    BOOST_TEST(matches(contains, u8"xxa%_yy"));
+    BOOST_TEST(!matches(contains, u8"xxa%"));
+    BOOST_TEST(!matches(contains, u8"xxa%x_"));
+
+    auto escaped_wildcards = matcher(u8R"(\%\_)");
+    BOOST_TEST(matches(escaped_wildcards, u8"%_"));
+    BOOST_TEST(!matches(escaped_wildcards, u8"a_"));
+
+    // Not simple: wildcards inside the literal.
+    auto inner = matcher(u8"%a%b%");
+    BOOST_TEST(matches(inner, u8"xaxbx"));
+    BOOST_TEST(!matches(inner, u8"xbxax"));
+}
+
 BOOST_AUTO_TEST_CASE(test_reset) {
     auto m = matcher(u8"alpha");
     BOOST_TEST(matches(m, u8"alpha"));
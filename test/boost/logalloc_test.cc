@@ -96,6 +96,52 @@ SEASTAR_TEST_CASE(test_compaction) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_reclaim_statistics) {
+    auto sg = create_scheduling_group("reclaim_statistics", 100).get0();
+    auto destroy_sg = defer([&] () noexcept {
+        destroy_scheduling_group(sg).get();
+    });
+
+    region reg;
+    std::vector<managed_ref<int>> allocated;
+    auto free_allocated = defer([&] () noexcept {
+        with_allocator(reg.allocator(), [&] {
+            allocated.clear();
+        });
+    });
+    with_allocator(reg.allocator(), [&] {
+        for (int i = 0; i < 32 * 1024 * 8; i++) {
+            allocated.push_back(make_managed<int>());
+        }
+        shard_tracker().reclaim_all_free_segments();
+        for (size_t i = 0; i < allocated.size(); i += 2) {
+            allocated[i] = {};
+        }
+    });
+
+    auto find_stats = [&] {
+        for (auto& s : shard_tracker().reclaim_statistics()) {
+            if (s.group == sg && std::string_view(s.operation) == "reclaim") {
+                return std::make_optional(s);
+            }
+        }
+        return std::optional<logalloc::tracker::reclaim_stats>();
+    };
+    BOOST_REQUIRE(!find_stats());
+
+    with_scheduling_group(sg, [&reg] {
+        with_allocator(reg.allocator(), [] {
+            shard_tracker().reclaim(std::numeric_limits<size_t>::max());
+        });
+    }).get();
+
+    auto stats = find_stats();
+    BOOST_REQUIRE(stats);
+    BOOST_REQUIRE_EQUAL(stats->count, 1);
+    BOOST_REQUIRE_GT(stats->memory_released, 0);
+    BOOST_REQUIRE_GT(stats->segments_compacted, 0);
+}
+
 SEASTAR_TEST_CASE(test_occupancy) {
     return seastar::async([] {
         region reg;
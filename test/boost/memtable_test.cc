@@ -465,6 +465,44 @@ SEASTAR_TEST_CASE(test_fast_forward_to_after_memtable_is_flushed) {
     });
 }
 
+SEASTAR_TEST_CASE(test_flush_reader_of_split_memtable) {
+    return seastar::async([] {
+        schema_ptr s = schema_builder("ks", "cf")
+            .with_column("pk", bytes_type, column_kind::partition_key)
+            .with_column("col", bytes_type, column_kind::regular_column)
+            .build();
+
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        replica::table_stats tbl_stats;
+        replica::dirty_memory_manager mgr;
+
+        auto mt = make_lw_shared<replica::memtable>(s, mgr, tbl_stats);
+        BOOST_REQUIRE_EQUAL(mt->split_for_flush(4).size(), 1);
+
+        std::vector<mutation> ring = make_ring(s, 64);
+        for (auto& m : ring) {
+            mt->apply(m);
+        }
+
+        BOOST_REQUIRE_EQUAL(mt->split_for_flush(1).size(), 1);
+        BOOST_REQUIRE_EQUAL(mt->split_for_flush(128).size(), 1);
+
+        // The ranges are contiguous, so reading each of them in turn gives
+        // all the partitions, each once.
+        auto ranges = mt->split_for_flush(4);
+        BOOST_REQUIRE_EQUAL(ranges.size(), 4);
+        auto i = ring.begin();
+        for (auto& range : ranges) {
+            auto rd = assert_that(mt->make_flush_reader(s, semaphore.make_permit(), default_priority_class(), range));
+            while (i != ring.end() && range.contains(dht::ring_position(i->decorated_key()), dht::ring_position_comparator(*s))) {
+                rd.produces(*i++);
+            }
+            rd.produces_end_of_stream();
+        }
+        BOOST_REQUIRE(i == ring.end());
+    });
+}
+
 SEASTAR_TEST_CASE(test_exception_safety_of_partition_range_reads) {
     return seastar::async([] {
         random_mutation_generator gen(random_mutation_generator::generate_counters::no);
@@ -846,6 +884,55 @@ SEASTAR_THREAD_TEST_CASE(test_collecting_encoding_stats) {
 }
 
 
+SEASTAR_THREAD_TEST_CASE(test_batched_apply_coalesces_writes_to_same_partition) {
+    simple_schema ss;
+    auto s = ss.schema();
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto pks = ss.make_pkeys(3);
+
+    // Interleave writes to different partitions, including overwrites of the same row.
+    std::vector<mutation> muts;
+    for (int i = 0; i < 12; ++i) {
+        mutation m(s, pks[i % pks.size()]);
+        ss.add_row(m, ss.make_ckey(i % 4), format("v{}", i));
+        if (i == 7) {
+            ss.add_static_row(m, "static");
+        }
+        muts.push_back(std::move(m));
+    }
+    std::vector<frozen_mutation> fms;
+    for (auto& m : muts) {
+        fms.push_back(freeze(m));
+    }
+    std::vector<const frozen_mutation*> batch;
+    for (auto& fm : fms) {
+        batch.push_back(&fm);
+    }
+
+    std::vector<mutation> expected;
+    for (auto& pk : pks) {
+        mutation m(s, pk);
+        for (auto& mut : muts) {
+            if (mut.decorated_key().equal(*s, pk)) {
+                m.apply(mut);
+            }
+        }
+        expected.push_back(std::move(m));
+    }
+
+    replica::dirty_memory_manager mgr;
+    replica::table_stats tbl_stats;
+    auto mt = make_lw_shared<replica::memtable>(s, mgr, tbl_stats);
+    mt->apply(batch, s, std::vector<db::rp_handle>(batch.size()));
+
+    BOOST_REQUIRE_EQUAL(mt->partition_count(), pks.size());
+    assert_that(mt->make_flat_reader(s, semaphore.make_permit()))
+        .produces(expected[0])
+        .produces(expected[1])
+        .produces(expected[2])
+        .produces_end_of_stream();
+}
+
 SEASTAR_TEST_CASE(memtable_flush_compresses_mutations) {
     auto db_config = make_shared<db::config>();
     db_config->enable_cache.set(false);
@@ -109,3 +109,18 @@ BOOST_AUTO_TEST_CASE(test_hash_output) {
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_batched_hash_output) {
+    // Odd lengths, so that the batch has keys hashed both in lock-step and on their own.
+    for (size_t n : {1, 4, 5, 59}) {
+        std::vector<bytes_view> keys;
+        for (size_t i = 0; i < n; ++i) {
+            keys.push_back(bytes_view(full_sequence.begin(), (i * 7) % full_sequence.size()));
+        }
+        std::vector<std::array<uint64_t, 2>> hashes(n);
+        utils::murmur_hash::hash3_x64_128(keys, seed, hashes);
+        for (size_t i = 0; i < n; ++i) {
+            BOOST_REQUIRE(hashes[i] == prefix_hashes[keys[i].size()]);
+        }
+    }
+}
@@ -1840,6 +1840,42 @@ SEASTAR_THREAD_TEST_CASE(test_stopping_reader_with_pending_read_ahead) {
     }).get();
 }
 
+// Check that the combined reader waits for the first buffers of all its
+// readers at once, so that the latency of reading a partition from many
+// sstables is that of the slowest read, not the sum of all of them.
+SEASTAR_THREAD_TEST_CASE(test_combined_reader_fills_readers_concurrently) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto s = simple_schema();
+    auto permit = semaphore.make_permit();
+    const unsigned num_readers = 4;
+
+    std::vector<std::unique_ptr<puppet_reader_v2::control>> controls;
+    std::vector<flat_mutation_reader_v2> readers;
+    for (unsigned i = 0; i < num_readers; ++i) {
+        controls.push_back(std::make_unique<puppet_reader_v2::control>());
+        readers.push_back(make_flat_mutation_reader_v2<puppet_reader_v2>(s, permit, *controls.back(),
+                std::vector{puppet_reader_v2::fill_buffer_action::block}, std::vector<uint32_t>{0}));
+    }
+    auto reader = make_combined_reader(s.schema(), permit, std::move(readers),
+            streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+    auto close_reader = deferred_close(reader);
+
+    auto f = reader.fill_buffer();
+    for (auto& ctrl : controls) {
+        BOOST_REQUIRE(ctrl->pending);
+    }
+    BOOST_REQUIRE(!f.available());
+
+    for (auto& ctrl : controls) {
+        ctrl->buffer_filled.set_value();
+    }
+    f.get();
+
+    auto mf = reader().get();
+    BOOST_REQUIRE(mf && mf->is_partition_start());
+    BOOST_REQUIRE(mf->as_partition_start().key().equal(*s.schema(), s.make_pkey(0)));
+}
+
 struct multishard_reader_for_read_ahead {
     static const unsigned min_shards = 3;
     static const unsigned blocked_shard = 2;
@@ -2261,6 +2297,69 @@ SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_next_partition) {
     }).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_multishard_unordered_reader) {
+    do_with_cql_env_thread([&] (cql_test_env& env) -> future<> {
+        env.execute_cql("CREATE KEYSPACE multishard_unordered_reader_ks"
+                " WITH REPLICATION = {'class' : 'SimpleStrategy', 'replication_factor' : 1};").get();
+        env.execute_cql("CREATE TABLE multishard_unordered_reader_ks.test (pk int, ck int, v int, PRIMARY KEY(pk, ck));").get();
+
+        const auto insert_id = env.prepare("INSERT INTO multishard_unordered_reader_ks.test (\"pk\", \"ck\", \"v\") VALUES (?, ?, ?);").get0();
+
+        const auto partition_count = 1000;
+        const auto rows_per_partition = 4;
+
+        for (int pk = 0; pk < partition_count; ++pk) {
+            for (int ck = 0; ck < rows_per_partition; ++ck) {
+                env.execute_prepared(insert_id, {{
+                        cql3::raw_value::make_value(serialized(pk)),
+                        cql3::raw_value::make_value(serialized(ck)),
+                        cql3::raw_value::make_value(serialized(0))}}).get();
+            }
+        }
+
+        auto schema = env.local_db().find_column_family("multishard_unordered_reader_ks", "test").schema();
+
+        auto factory = [db = &env.db()] (
+                schema_ptr schema,
+                reader_permit permit,
+                const dht::partition_range& range,
+                const query::partition_slice& slice,
+                const io_priority_class& pc,
+                tracing::trace_state_ptr trace_state,
+                mutation_reader::forwarding fwd_mr) {
+            auto& table = db->local().find_column_family(schema);
+            auto reader = table.as_mutation_source().make_reader_v2(schema, std::move(permit), range, slice, pc, std::move(trace_state),
+                    streamed_mutation::forwarding::no, fwd_mr);
+            // Small buffers, so that shards are switched often.
+            reader.set_max_buffer_size(1);
+            return reader;
+        };
+        auto reader = make_multishard_unordered_reader_v2(
+                seastar::make_shared<test_reader_lifecycle_policy>(std::move(factory)),
+                schema,
+                make_reader_permit(env),
+                query::full_partition_range,
+                schema->full_slice(),
+                service::get_local_sstable_query_read_priority());
+        auto close_reader = deferred_close(reader);
+
+        std::vector<dht::decorated_key> keys;
+        while (auto mut_opt = read_mutation_from_flat_mutation_reader(reader).get0()) {
+            // Partitions must not be interleaved.
+            BOOST_REQUIRE_EQUAL(mut_opt->partition().row_count(), rows_per_partition);
+            keys.push_back(mut_opt->decorated_key());
+        }
+
+        BOOST_REQUIRE_EQUAL(keys.size(), partition_count);
+        std::ranges::sort(keys, dht::decorated_key::less_comparator(schema));
+        BOOST_REQUIRE(std::adjacent_find(keys.begin(), keys.end(), [schema] (const dht::decorated_key& a, const dht::decorated_key& b) {
+            return a.equal(*schema, b);
+        }) == keys.end());
+
+        return make_ready_future<>();
+    }).get();
+}
+
 // Test the multishard streaming reader in the context it was designed to work
 // in: as a mean to read data belonging to a shard according to a different
 // sharding configuration.
@@ -1252,13 +1252,15 @@ SEASTAR_TEST_CASE(test_query_digest) {
         auto check_digests_equal = [now] (const mutation& m1, const mutation& m2) {
             auto ps1 = partition_slice_builder(*m1.schema()).build();
             auto ps2 = partition_slice_builder(*m2.schema()).build();
-            auto digest1 = *query_mutation(mutation(m1), ps1, query::max_rows, now,
-                    query::result_options::only_digest(query::digest_algorithm::xxHash)).digest();
-            auto digest2 = *query_mutation( mutation(m2), ps2, query::max_rows, now,
-                    query::result_options::only_digest(query::digest_algorithm::xxHash)).digest();
-
-            if (digest1 != digest2) {
-                BOOST_FAIL(format("Digest should be the same for {} and {}", m1, m2));
+            for (auto algo : {query::digest_algorithm::xxHash, query::digest_algorithm::xxHash3}) {
+                auto digest1 = *query_mutation(mutation(m1), ps1, query::max_rows, now,
+                        query::result_options::only_digest(algo)).digest();
+                auto digest2 = *query_mutation( mutation(m2), ps2, query::max_rows, now,
+                        query::result_options::only_digest(algo)).digest();
+
+                if (digest1 != digest2) {
+                    BOOST_FAIL(format("Digest should be the same for {} and {}", m1, m2));
+                }
             }
         };
 
@@ -1461,6 +1461,42 @@ SEASTAR_TEST_CASE(test_versions_are_merged_when_snapshots_go_away) {
     });
 }
 
+SEASTAR_TEST_CASE(test_newer_versions_count) {
+    return seastar::async([] {
+        logalloc::region r;
+        mutation_cleaner cleaner(r, nullptr, app_stats_for_tests);
+        with_allocator(r.allocator(), [&] {
+            random_mutation_generator gen(random_mutation_generator::generate_counters::no);
+            auto s = gen.schema();
+
+            mutation m1 = gen();
+            m1.partition().make_fully_continuous();
+
+            auto e = partition_entry(mutation_partition(*s, m1.partition()));
+            auto snap1 = e.read(r, cleaner, s, nullptr);
+            BOOST_REQUIRE_EQUAL(0, snap1->newer_versions_count(10));
+
+            std::vector<partition_snapshot_ptr> snapshots;
+            for (int i = 0; i < 3; ++i) {
+                mutation m = gen();
+                m.partition().make_fully_continuous();
+                mutation_application_stats app_stats;
+                logalloc::reclaim_lock rl(r);
+                e.apply(r, cleaner, *s, m.partition(), *s, app_stats);
+                snapshots.push_back(e.read(r, cleaner, s, nullptr));
+            }
+            BOOST_REQUIRE_EQUAL(3, snap1->newer_versions_count(10));
+            BOOST_REQUIRE_EQUAL(2, snap1->newer_versions_count(2));
+            BOOST_REQUIRE_EQUAL(0, snapshots.back()->newer_versions_count(10));
+
+            snap1 = {};
+            snapshots.clear();
+            cleaner.drain().get();
+            BOOST_REQUIRE_EQUAL(1, boost::size(e.versions()));
+        });
+    });
+}
+
 // Reproducer of #4030
 SEASTAR_TEST_CASE(test_snapshot_merging_after_container_is_destroyed) {
     return seastar::async([] {
@@ -17,6 +17,7 @@
 #include "types.hh"
 #include "schema_builder.hh"
 #include "utils/div_ceil.hh"
+#include "utils/murmur_hash.hh"
 
 #include "test/lib/simple_schema.hh"
 #include "test/lib/log.hh"
@@ -56,6 +57,41 @@ SEASTAR_THREAD_TEST_CASE(test_decorated_key_is_compatible_with_origin) {
     BOOST_REQUIRE(dk._key.equal(*s, key));
 }
 
+SEASTAR_THREAD_TEST_CASE(test_get_tokens_matches_legacy_form_hash) {
+    auto singular = schema_builder("ks", "cf1")
+        .with_column("pk", utf8_type, column_kind::partition_key)
+        .with_column("v", int32_type)
+        .build();
+    auto compound = schema_builder("ks", "cf2")
+        .with_column("pk1", utf8_type, column_kind::partition_key)
+        .with_column("pk2", int32_type, column_kind::partition_key)
+        .with_column("v", int32_type)
+        .build();
+
+    dht::murmur3_partitioner partitioner;
+    for (auto s : {singular, compound}) {
+        std::vector<partition_key> keys;
+        // Include the empty key, which the legacy form treats specially, and
+        // keys not hashed in whole 16 byte blocks.
+        for (int i = 0; i < 70; ++i) {
+            auto value = sstring(i, 'a' + i % 26);
+            keys.push_back(s == singular ? partition_key::from_singular(*s, value)
+                    : partition_key::from_exploded(*s, std::vector<bytes>{utf8_type->decompose(value), int32_type->decompose(i)}));
+        }
+        std::vector<partition_key_view> views(keys.begin(), keys.end());
+        std::vector<dht::token> tokens(keys.size());
+        partitioner.get_tokens(*s, views, tokens);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            std::array<uint64_t, 2> hash;
+            auto legacy = keys[i].legacy_form(*s);
+            utils::murmur_hash::hash3_x64_128(legacy.begin(), legacy.size(), 0, hash);
+            auto expected = token_from_long(hash[0]);
+            BOOST_REQUIRE_EQUAL(partitioner.get_token(*s, keys[i]), expected);
+            BOOST_REQUIRE_EQUAL(tokens[i], expected);
+        }
+    }
+}
+
 SEASTAR_THREAD_TEST_CASE(test_token_wraparound_1) {
     auto t1 = token_from_long(0x7000'0000'0000'0000);
     auto t2 = token_from_long(0xa000'0000'0000'0000);
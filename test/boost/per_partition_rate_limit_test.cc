@@ -106,4 +106,33 @@ SEASTAR_TEST_CASE(test_internal_operation_filtering) {
 
         return make_ready_future<>();
     });
-}
\ No newline at end of file
+}
+SEASTAR_TEST_CASE(test_table_rate_limit) {
+    return do_with_cql_env_thread([] (cql_test_env& e) -> future<> {
+        cquery_nofail(e, "CREATE TABLE ks.tbl (pk int PRIMARY KEY) \
+                WITH per_partition_rate_limit = {'max_table_writes_per_second': 1}");
+
+        auto& db = e.db();
+        auto& qp = e.qp();
+        auto sgroups = get_scheduling_groups().get();
+
+        seastar::async(thread_attributes{sgroups.statement_scheduling_group}, [&] {
+            const auto sptr = db.local().find_schema("ks", "tbl");
+            // Writes to distinct partitions are not limited per partition,
+            // but they all count towards the limit of the table.
+            BOOST_REQUIRE_THROW([&] {
+                for (int32_t i = 0; i < 100; i++) {
+                    auto m = mutation(sptr, partition_key::from_singular(*sptr, i));
+                    qp.local().proxy().mutate({m},
+                            db::consistency_level::ALL,
+                            service::storage_proxy::clock_type::now() + std::chrono::seconds(10),
+                            nullptr,
+                            empty_service_permit(),
+                            db::allow_per_partition_rate_limit::yes).get();
+                }
+            }(), exceptions::rate_limit_exception);
+        }).get();
+
+        return make_ready_future<>();
+    });
+}
@@ -913,6 +913,37 @@ BOOST_AUTO_TEST_CASE(test_exception_safety) {
     });
 }
 
+BOOST_AUTO_TEST_CASE(test_apply_monotonically_moves_disjoint_tombstones) {
+    range_tombstone_list original(*s);
+    original.apply(*s, rtie(0, 2, 1));
+    original.apply(*s, rtie(10, 12, 1));
+    original.apply(*s, rtie(20, 22, 1));
+
+    range_tombstone_list to_apply(*s);
+    to_apply.apply(*s, rtie(3, 5, 2));   // disjoint
+    to_apply.apply(*s, rtie(5, 7, 1));   // adjacent, different timestamp
+    to_apply.apply(*s, rtie(12, 14, 1)); // adjacent, same timestamp
+    to_apply.apply(*s, rtie(18, 21, 2)); // overlapping
+    to_apply.apply(*s, rtie(30, 32, 3)); // after all
+
+    auto expected = original;
+    expected.apply(*s, to_apply);
+
+    memory::with_allocation_failures([&] () {
+        auto list = original;
+        auto src = to_apply;
+        auto d = defer([&] {
+            memory::scoped_critical_alloc_section dfg;
+            assert_that(*s, list).has_no_less_information_than(original);
+            list.apply(*s, src);
+            assert_that(*s, list).is_equal_to(expected);
+        });
+        list.apply_monotonically(*s, std::move(src));
+        assert_that(*s, list).is_equal_to(expected);
+        BOOST_REQUIRE(src.empty());
+    });
+}
+
 BOOST_AUTO_TEST_CASE(test_accumulator) {
     auto ts1 = 1;
     auto ts2 = 2;
@@ -1572,3 +1572,130 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_request_memory_preser
         do_check(permit, 1, 1, std::source_location::current());
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_reader_buffer_size) {
+    simple_schema s;
+    const auto default_size = flat_mutation_reader_v2::default_max_buffer_size_in_bytes();
+    const auto initial_resources = reader_concurrency_semaphore::resources{10, 16 * 1024 * 1024};
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), initial_resources.count, initial_resources.memory);
+    auto stop_sem = deferred_stop(semaphore);
+
+    // A lone reader grows its buffer.
+    auto permit1 = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::no_timeout).get0();
+    BOOST_REQUIRE_EQUAL(permit1.reader_buffer_size(default_size), default_size * reader_concurrency_semaphore::max_reader_buffer_growth);
+
+    auto permit2 = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::no_timeout).get0();
+    BOOST_REQUIRE_EQUAL(permit1.reader_buffer_size(default_size), default_size);
+
+    // Buffers shrink once less than half of the memory is available.
+    {
+        auto units = permit1.consume_memory(initial_resources.memory / 2);
+        BOOST_REQUIRE_LT(permit1.reader_buffer_size(default_size), default_size);
+        BOOST_REQUIRE_GT(permit1.reader_buffer_size(default_size), reader_concurrency_semaphore::min_reader_buffer_size);
+    }
+    {
+        auto units = permit1.consume_memory(initial_resources.memory);
+        BOOST_REQUIRE_EQUAL(permit1.reader_buffer_size(default_size), reader_concurrency_semaphore::min_reader_buffer_size);
+    }
+    BOOST_REQUIRE_EQUAL(permit1.reader_buffer_size(default_size), default_size);
+
+    reader_concurrency_semaphore unlimited_semaphore(reader_concurrency_semaphore::no_limits{}, get_name());
+    auto stop_unlimited_sem = deferred_stop(unlimited_semaphore);
+    auto permit3 = unlimited_semaphore.make_tracking_only_permit(s.schema().get(), get_name(), db::no_timeout);
+    BOOST_REQUIRE_EQUAL(permit3.reader_buffer_size(default_size), default_size);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_deadline_shedding) {
+    simple_schema s;
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 1, 1024 * 1024);
+    auto stop_sem = deferred_stop(semaphore);
+    semaphore.set_deadline_shedding(utils::updateable_value<bool>(true));
+
+    BOOST_REQUIRE(!semaphore.read_duration_estimate(s.schema()->id()));
+
+    // Learn the duration of reads of the table.
+    {
+        auto permit = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::no_timeout).get0();
+        seastar::sleep(std::chrono::milliseconds(100)).get();
+    }
+    auto estimate = semaphore.read_duration_estimate(s.schema()->id());
+    BOOST_REQUIRE(estimate);
+    BOOST_REQUIRE_GE(*estimate, std::chrono::milliseconds(50));
+
+    auto permit1 = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::no_timeout).get0();
+
+    // Can't complete in time, once admitted.
+    auto fut_short = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::timeout_clock::now() + *estimate / 2);
+    auto fut_long = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::timeout_clock::now() + std::chrono::seconds(60));
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(), 2);
+
+    permit1 = semaphore.make_tracking_only_permit(s.schema().get(), get_name(), db::no_timeout);
+
+    BOOST_REQUIRE_THROW(fut_short.get(), semaphore_timed_out);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().total_reads_shed_due_to_deadline, 1);
+    fut_long.get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_evicts_inactive_reads_by_expected_pause) {
+    simple_schema s;
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 2, 1024 * 1024);
+    auto stop_sem = deferred_stop(semaphore);
+
+    // The oldest inactive read is expected to be resumed only in an hour, so
+    // it is spared in favour of the newer one, of which nothing is known.
+    auto permit1 = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::no_timeout).get0();
+    auto irh1 = semaphore.register_inactive_read(make_empty_flat_reader_v2(s.schema(), permit1));
+    BOOST_REQUIRE(irh1);
+    semaphore.set_expected_pause(irh1, std::chrono::hours(1));
+
+    auto permit2 = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::no_timeout).get0();
+    auto irh2 = semaphore.register_inactive_read(make_empty_flat_reader_v2(s.schema(), permit2));
+    BOOST_REQUIRE(irh2);
+
+    auto permit3 = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::no_timeout).get0();
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().permit_based_evictions, 1);
+    BOOST_REQUIRE(irh1);
+    BOOST_REQUIRE(!irh2);
+
+    auto reader1 = semaphore.unregister_inactive_read(std::move(irh1));
+    BOOST_REQUIRE(reader1);
+    reader1->close().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_resource_usage) {
+    simple_schema s;
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 1, 1024 * 1024);
+    auto stop_sem = deferred_stop(semaphore);
+
+    BOOST_REQUIRE(semaphore.resource_usage_by_table().empty());
+
+    {
+        auto permit = semaphore.obtain_permit(s.schema().get(), get_name(), 1024, db::no_timeout).get0();
+        BOOST_REQUIRE_EQUAL(permit.resource_usage().cpu_time.count(), 0);
+
+        {
+            reader_permit::used_guard ug{permit};
+            seastar::sleep(std::chrono::milliseconds(10)).get();
+            {
+                // Time spent blocked doesn't count.
+                reader_permit::blocked_guard bg{permit};
+                seastar::sleep(std::chrono::milliseconds(100)).get();
+            }
+        }
+        const auto cpu_time = permit.resource_usage().cpu_time;
+        BOOST_REQUIRE_GE(cpu_time, std::chrono::milliseconds(10));
+        BOOST_REQUIRE_LT(cpu_time, std::chrono::milliseconds(100));
+
+        permit.on_disk_read(4096);
+        BOOST_REQUIRE_EQUAL(permit.resource_usage().disk_reads, 1);
+        BOOST_REQUIRE_EQUAL(permit.resource_usage().disk_bytes_read, 4096);
+    }
+
+    const auto& usage = semaphore.resource_usage_by_table();
+    BOOST_REQUIRE_EQUAL(usage.size(), 1);
+    const auto& table_usage = usage.at(s.schema()->id());
+    BOOST_REQUIRE_EQUAL(table_usage.reads, 1);
+    BOOST_REQUIRE_GE(table_usage.usage.cpu_time, std::chrono::milliseconds(10));
+    BOOST_REQUIRE_EQUAL(table_usage.usage.disk_reads, 1);
+    BOOST_REQUIRE_EQUAL(table_usage.usage.disk_bytes_read, 4096);
+}
@@ -17,7 +17,11 @@
 #include "test/lib/random_utils.hh"
 #include "test/lib/reader_concurrency_semaphore.hh"
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
 #include "readers/mutation_fragment_v1_stream.hh"
+#include "tombstone_gc.hh"
+#include "compaction/compaction_manager.hh"
+#include "utils/UUID_gen.hh"
 
 // Helper mutation_fragment_queue that stores the received stream of
 // mutation_fragments in a passed in deque of mutation_fragment_v2.
@@ -133,3 +137,52 @@ SEASTAR_TEST_CASE(flush_repair_rows_on_wire_to_sstable) {
     });
 }
 
+
+SEASTAR_THREAD_TEST_CASE(test_repair_history_index) {
+    auto tok = [] (int64_t v) { return dht::token::from_int64(v); };
+    auto time = [] (int s) { return gc_clock::time_point(gc_clock::duration(s)); };
+
+    per_table_history_maps maps;
+    tombstone_gc_state gc_state(&maps);
+    auto id = table_id(utils::UUID_gen::get_time_UUID());
+    BOOST_REQUIRE(!gc_state.get_repair_history_index_for_table(id));
+
+    gc_state.update_repair_time(id, dht::token_range::make({tok(0), false}, {tok(10), true}), time(100));
+    gc_state.update_repair_time(id, dht::token_range::make({tok(20), false}, {tok(30), true}), time(200));
+    auto index = gc_state.get_repair_history_index_for_table(id);
+    BOOST_REQUIRE(index);
+    BOOST_REQUIRE_EQUAL(index->entries().size(), 2);
+    // The index is shared until the history changes.
+    BOOST_REQUIRE_EQUAL(index.get(), gc_state.get_repair_history_index_for_table(id).get());
+
+    auto repair_time_of = [&] (int64_t t, size_t& pos) -> std::optional<gc_clock::time_point> {
+        if (auto e = index->find(tok(t), pos)) {
+            return e->repair_time;
+        }
+        return std::nullopt;
+    };
+
+    // In token order.
+    size_t pos = 0;
+    BOOST_REQUIRE(!repair_time_of(-5, pos));
+    BOOST_REQUIRE(!repair_time_of(0, pos));
+    BOOST_REQUIRE(repair_time_of(1, pos) == time(100));
+    BOOST_REQUIRE(repair_time_of(10, pos) == time(100));
+    BOOST_REQUIRE(!repair_time_of(15, pos));
+    BOOST_REQUIRE(repair_time_of(25, pos) == time(200));
+    BOOST_REQUIRE(!repair_time_of(35, pos));
+    // Out of order.
+    BOOST_REQUIRE(repair_time_of(5, pos) == time(100));
+    BOOST_REQUIRE(repair_time_of(30, pos) == time(200));
+    BOOST_REQUIRE(!repair_time_of(0, pos));
+
+    gc_state.update_repair_time(id, dht::token_range::make({tok(5), false}, {tok(25), true}), time(300));
+    auto new_index = gc_state.get_repair_history_index_for_table(id);
+    BOOST_REQUIRE_NE(index.get(), new_index.get());
+    // The old index keeps the history it was built from.
+    pos = 0;
+    BOOST_REQUIRE(repair_time_of(15, pos) == std::nullopt);
+    pos = 0;
+    BOOST_REQUIRE(new_index->find(tok(15), pos)->repair_time == time(300));
+    BOOST_REQUIRE(new_index->find(tok(28), pos)->repair_time == time(200));
+}
@@ -158,6 +158,38 @@ SEASTAR_TEST_CASE(test_cache_works_after_clearing) {
     });
 }
 
+SEASTAR_TEST_CASE(test_cached_partition_keys) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto mt = make_lw_shared<replica::memtable>(s);
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        BOOST_REQUIRE(cache.cached_partition_keys(10).get0().empty());
+
+        std::vector<dht::decorated_key> keys;
+        for (int i = 0; i < 100; i++) {
+            auto m = make_new_mutation(s);
+            keys.emplace_back(m.decorated_key());
+            cache.populate(m);
+        }
+        std::sort(keys.begin(), keys.end(), dht::decorated_key::less_comparator(s));
+
+        auto all = cache.cached_partition_keys(1000).get0();
+        BOOST_REQUIRE_EQUAL(all.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            BOOST_REQUIRE(all[i].equal(*s, keys[i]));
+        }
+
+        auto some = cache.cached_partition_keys(10).get0();
+        BOOST_REQUIRE_EQUAL(some.size(), 10);
+        for (size_t i = 0; i < some.size(); ++i) {
+            BOOST_REQUIRE(some[i].equal(*s, keys[i]));
+        }
+    });
+}
+
 class partition_counting_reader final : public delegating_reader_v2 {
     int& _counter;
     bool _count_fill_buffer = true;
@@ -596,6 +628,53 @@ SEASTAR_TEST_CASE(test_query_of_incomplete_range_goes_to_underlying) {
     });
 }
 
+SEASTAR_TEST_CASE(test_frequency_admission_policy) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        std::vector<mutation> mutations = make_ring(s, 2);
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        for (auto&& m : mutations) {
+            mt->apply(m);
+        }
+
+        cache_tracker tracker;
+        tracker.set_admission_policy(cache_tracker::admission_policy::frequency);
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        auto range = dht::partition_range::make_singular(query::ring_position(mutations[0].decorated_key()));
+
+        // The first miss is read from the underlying source, without populating.
+        assert_that(cache.make_reader(s, semaphore.make_permit(), range))
+            .produces(mutations[0])
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_rejections, 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_insertions, 0);
+
+        // The partition is read again, so it's worth caching.
+        assert_that(cache.make_reader(s, semaphore.make_permit(), range))
+            .produces(mutations[0])
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_admissions, 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_insertions, 1);
+
+        auto hits = tracker.get_stats().partition_hits;
+        assert_that(cache.make_reader(s, semaphore.make_permit(), range))
+            .produces(mutations[0])
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_hits, hits + 1);
+
+        tracker.set_admission_policy(cache_tracker::admission_policy::all);
+        auto range1 = dht::partition_range::make_singular(query::ring_position(mutations[1].decorated_key()));
+        assert_that(cache.make_reader(s, semaphore.make_permit(), range1))
+            .produces(mutations[1])
+            .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_insertions, 2);
+    });
+}
+
 SEASTAR_TEST_CASE(test_single_key_queries_after_population_in_reverse_order) {
     return seastar::async([] {
         auto s = make_schema();
@@ -957,6 +1036,38 @@ SEASTAR_TEST_CASE(test_eviction_after_schema_change) {
     });
 }
 
+SEASTAR_TEST_CASE(test_second_chance_eviction_spares_read_rows) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto mt = make_lw_shared<replica::memtable>(s);
+
+        cache_tracker tracker;
+        tracker.set_eviction_policy(cache_tracker::eviction_policy::second_chance);
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        auto hot = make_new_mutation(s);
+        cache.populate(hot);
+        {
+            auto rd = cache.make_reader(s, semaphore.make_permit(), dht::partition_range::make_singular(hot.decorated_key()));
+            auto close_rd = deferred_close(rd);
+            rd.fill_buffer().get();
+        }
+
+        // Populated but never read, like by a scan.
+        auto cold = make_new_mutation(s);
+        cache.populate(cold);
+
+        // The hot partition is at the front of the LRU, but is spared.
+        while (tracker.get_stats().partition_evictions == 0) {
+            BOOST_REQUIRE(tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something);
+        }
+        BOOST_REQUIRE_GT(tracker.get_lru().spared(), 0);
+        verify_does_not_have(cache, cold.decorated_key());
+        verify_has(cache, hot);
+    });
+}
+
 void test_sliced_read_row_presence(flat_mutation_reader_v2 reader, schema_ptr s, std::deque<int> expected)
 {
     auto close_reader = deferred_close(reader);
@@ -886,6 +886,55 @@ SEASTAR_TEST_CASE(test_local_index_paging) {
     });
 }
 
+// The rows of a partition found through a global index are read from the
+// base table together. Check that they are all returned, with and without
+// paging, including those of the partitions the pages end on.
+SEASTAR_TEST_CASE(test_global_index_many_rows_per_partition) {
+    return do_with_cql_env_thread([] (auto& e) {
+        e.execute_cql("CREATE TABLE tab (p int, c int, v int, PRIMARY KEY (p, c))").get();
+        e.execute_cql("CREATE INDEX ON tab (v)").get();
+
+        std::vector<std::vector<bytes_opt>> expected_rows;
+        for (int p = 0; p < 3; ++p) {
+            for (int c = 0; c < 10; ++c) {
+                int v = c % 3 == 0 ? 2 : 1;
+                e.execute_cql(format("INSERT INTO tab (p, c, v) VALUES ({}, {}, {})", p, c, v)).get();
+                if (v == 1) {
+                    expected_rows.push_back({int32_type->decompose(p), int32_type->decompose(c)});
+                }
+            }
+        }
+
+        eventually([&] {
+            auto res = e.execute_cql("SELECT p, c FROM tab WHERE v = 1").get0();
+            assert_that(res).is_rows().with_rows_ignore_order(expected_rows);
+        });
+
+        for (int page_size : {1, 4, 7, 100}) {
+            eventually([&] {
+                std::vector<std::vector<bytes_opt>> rows;
+                lw_shared_ptr<service::pager::paging_state> paging_state;
+                do {
+                    auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                            cql3::query_options::specific_options{page_size, paging_state, {}, api::new_timestamp()});
+                    auto res = e.execute_cql("SELECT p, c FROM tab WHERE v = 1", std::move(qo)).get0();
+                    auto rows_msg = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(res);
+                    for (auto& row : rows_msg->rs().result_set().rows()) {
+                        rows.push_back(row);
+                    }
+                    auto ps = rows_msg->rs().get_metadata().paging_state();
+                    paging_state = ps ? make_lw_shared<service::pager::paging_state>(*ps) : nullptr;
+                } while (paging_state);
+                BOOST_REQUIRE_EQUAL(rows.size(), expected_rows.size());
+                std::sort(rows.begin(), rows.end());
+                auto expected = expected_rows;
+                std::sort(expected.begin(), expected.end());
+                BOOST_REQUIRE(rows == expected);
+            });
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(test_malformed_local_index) {
     return do_with_cql_env_thread([] (auto& e) {
         e.execute_cql("CREATE TABLE tab (p1 int, p2 int, c1 int, c2 int, v int, PRIMARY KEY ((p1, p2), c1, c2))").get();
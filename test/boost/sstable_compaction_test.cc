@@ -1905,6 +1905,24 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
             sstables::test(sst).set_data_file_write_time(db_clock::now());
             auto descriptor = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, { sst });
             BOOST_REQUIRE(descriptor.sstables.size() == 0);
+            sstables::test(sst).set_data_file_write_time(db_clock::time_point::min());
+        }
+        // sstable above the urgent threshold is picked by all strategies, ahead of regular compactions
+        {
+            std::map<sstring, sstring> options;
+            options.emplace("tombstone_threshold", "0.5f");
+            options.emplace("urgent_tombstone_threshold", "0.2f");
+            for (auto type : {sstables::compaction_strategy_type::size_tiered, sstables::compaction_strategy_type::leveled,
+                    sstables::compaction_strategy_type::time_window}) {
+                auto cs = sstables::make_compaction_strategy(type, options);
+                auto descriptor = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, { sst });
+                BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), 1);
+                BOOST_REQUIRE(descriptor.sstables.front() == sst);
+            }
+            options["urgent_tombstone_threshold"] = "0.5f";
+            auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, options);
+            auto descriptor = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, { sst });
+            BOOST_REQUIRE(descriptor.sstables.size() == 0);
         }
     });
 }
@@ -2067,6 +2085,60 @@ SEASTAR_TEST_CASE(sstable_cleanup_correctness_test) {
     });
 }
 
+SEASTAR_TEST_CASE(sstable_cleanup_of_partially_owned_sstable_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cleanup_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::get_highest_sstable_version(), big);
+        };
+
+        std::vector<mutation> mutations;
+        for (auto& key : make_local_keys(20, s)) {
+            mutation m(s, partition_key::from_deeply_exploded(*s, { key }));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), api::timestamp_type(0));
+            mutations.push_back(std::move(m));
+        }
+        std::ranges::sort(mutations, mutation_decorated_key_less_comparator());
+        auto token = [&] (unsigned i) { return mutations[i].decorated_key().token(); };
+
+        table_for_tests cf(env.manager(), s, tmp.path().string());
+        auto close_cf = deferred_stop(cf);
+        cf->start();
+
+        auto cleanup = [&] (dht::token_range_vector owned_ranges) {
+            auto sst = make_sstable_containing(sst_gen, mutations);
+            auto run_identifier = sst->run_identifier();
+            auto descriptor = sstables::compaction_descriptor({std::move(sst)}, default_priority_class(), compaction_descriptor::default_level,
+                compaction_descriptor::default_max_sstable_bytes, run_identifier,
+                compaction_type_options::make_cleanup(compaction::make_owned_ranges_ptr(std::move(owned_ranges))));
+            return compact_sstables(std::move(descriptor), cf, sst_gen).get0();
+        };
+
+        // Owned ranges inside the sstable, and one past its end.
+        auto ret = cleanup({
+            dht::token_range::make(token(2), token(5)),
+            dht::token_range::make({token(10), false}, {token(13), true}),
+            dht::token_range::make_starting_with({dht::token::from_int64(std::numeric_limits<int64_t>::max() - 1), true}),
+        });
+        BOOST_REQUIRE_EQUAL(ret.new_sstables.size(), 1);
+        auto reader = assert_that(sstable_reader(ret.new_sstables.front(), s, env.make_reader_permit()));
+        for (unsigned i : {2, 3, 4, 5, 11, 12, 13}) {
+            reader.produces(mutations[i]);
+        }
+        reader.produces_end_of_stream();
+
+        // Owned ranges outside the sstable.
+        ret = cleanup({
+            dht::token_range::make_ending_with({dht::token::from_int64(std::numeric_limits<int64_t>::min() + 1), true}),
+        });
+        BOOST_REQUIRE(ret.new_sstables.empty());
+    });
+}
+
 std::vector<mutation_fragment_v2> write_corrupt_sstable(test_env& env, sstable& sst, reader_permit permit,
         std::function<void(mutation_fragment_v2&&, bool)> write_to_secondary) {
     auto schema = sst.get_schema();
@@ -3778,6 +3850,48 @@ SEASTAR_TEST_CASE(stcs_reshape_test) {
     });
 }
 
+SEASTAR_TEST_CASE(ics_run_based_selection_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        table_for_tests cf(env.manager(), s);
+        auto close_cf = deferred_stop(cf);
+
+        std::map<sstring, sstring> options = { { "sstable_size_in_mb", "1" } };
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, options);
+
+        // Create runs of similar size, each made of disjoint fragments.
+        constexpr unsigned runs = 4;
+        constexpr unsigned fragments_per_run = 4;
+        auto keys = token_generation_for_current_shard(fragments_per_run);
+        std::vector<shared_sstable> candidates;
+        auto gen = 1;
+        for (unsigned r = 0; r < runs; r++) {
+            auto identifier = sstables::run_id::create_random_id();
+            for (unsigned f = 0; f < fragments_per_run; f++) {
+                auto sst = env.make_sstable(s, "", gen++);
+                sstables::test(sst).set_values(keys[f].first, keys[f].first, stats_metadata{}, 1024);
+                sstables::test(sst).set_run_identifier(identifier);
+                candidates.push_back(std::move(sst));
+            }
+        }
+
+        auto strategy_c = make_strategy_control_for_test(false);
+        auto desc = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, candidates);
+        // All fragments of all runs should be compacted together, with output split into fragments.
+        BOOST_REQUIRE_EQUAL(desc.sstables.size(), runs * fragments_per_run);
+        BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, 1024 * 1024);
+        BOOST_REQUIRE_EQUAL(desc.fan_in(), runs);
+
+        // A single run is never compacted with itself, no matter how many fragments it has.
+        std::vector<shared_sstable> single_run(candidates.begin(), candidates.begin() + fragments_per_run);
+        desc = cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, single_run);
+        BOOST_REQUIRE(desc.sstables.empty());
+
+        BOOST_REQUIRE(cs.get_reshaping_job(candidates, s, default_priority_class(), reshape_mode::strict).sstables.size());
+    });
+}
+
 SEASTAR_TEST_CASE(lcs_reshape_test) {
     return test_env::do_with_async([] (test_env& env) {
         simple_schema ss;
@@ -3809,6 +3923,10 @@ SEASTAR_TEST_CASE(lcs_reshape_test) {
             }
 
             BOOST_REQUIRE(cs.get_reshaping_job(sstables, s, default_priority_class(), reshape_mode::strict).sstables.size() == uint64_t(s->max_compaction_threshold()));
+            // A higher fan-in lets the overlapping sstables be reshaped in fewer rounds.
+            BOOST_REQUIRE(cs.get_reshaping_job(sstables, s, default_priority_class(), reshape_mode::strict, 128).sstables.size() == 128);
+            // A fan-in lower than the schema's threshold has no effect.
+            BOOST_REQUIRE(cs.get_reshaping_job(sstables, s, default_priority_class(), reshape_mode::strict, 2).sstables.size() == uint64_t(s->max_compaction_threshold()));
         }
         // single sstable
         {
@@ -4745,6 +4863,7 @@ SEASTAR_TEST_CASE(simple_backlog_controller_test) {
        run_controller_test(sstables::compaction_strategy_type::size_tiered, env);
        run_controller_test(sstables::compaction_strategy_type::time_window, env);
        run_controller_test(sstables::compaction_strategy_type::leveled, env);
+       run_controller_test(sstables::compaction_strategy_type::incremental, env);
     });
 }
 
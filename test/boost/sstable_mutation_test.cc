@@ -15,6 +15,7 @@
 
 #include "test/boost/sstable_test.hh"
 #include "sstables/key.hh"
+#include "utils/bloom_filter.hh"
 #include <seastar/core/do_with.hh>
 #include <seastar/core/thread.hh>
 #include "sstables/sstables.hh"
@@ -916,6 +917,166 @@ SEASTAR_TEST_CASE(test_has_partition_key) {
     });
 }
 
+SEASTAR_TEST_CASE(test_split_block_filter) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto dir = tmpdir();
+        auto pkeys = ss.make_pkeys(1000);
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        for (auto& dk : pkeys) {
+            mutation m(s, dk);
+            ss.add_row(m, ss.make_ckey("ck"), "v");
+            mt->apply(std::move(m));
+        }
+
+        auto cfg = env.manager().configure_writer();
+        cfg.split_block_filter = true;
+        auto sst = make_sstable_easy(env, dir.path(), mt, cfg, 1, sstables::get_highest_sstable_version(), pkeys.size());
+
+        // The format must be detected at load time.
+        auto f = open_file_dma(sst->filename(component_type::Filter), open_flags::ro).get0();
+        auto close_f = deferred_close(f);
+        auto buf = f.dma_read_exactly<char>(0, 4).get0();
+        BOOST_REQUIRE_EQUAL(read_be<uint32_t>(buf.get()), utils::filter::split_block_bloom_filter::split_block_marker);
+
+        for (auto& dk : pkeys) {
+            BOOST_REQUIRE(sst->filter_has_key(*s, dk.key()));
+        }
+
+        unsigned false_positives = 0;
+        const unsigned absent_keys = 10000;
+        for (unsigned i = 0; i < absent_keys; i++) {
+            auto pk = partition_key::from_single_value(*s, serialized(format("absent{}", i)));
+            false_positives += sst->filter_has_key(*s, pk);
+        }
+        testlog.info("split block filter: {} false positives out of {} absent keys, fp chance {}", false_positives, absent_keys, s->bloom_filter_fp_chance());
+        BOOST_REQUIRE_LE(false_positives, absent_keys * s->bloom_filter_fp_chance() * 2);
+    });
+}
+
+SEASTAR_TEST_CASE(test_reading_cells_of_dropped_columns) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("ck", utf8_type, column_kind::clustering_key)
+                .with_column("v1", utf8_type)
+                .with_column("v2", utf8_type)
+                .build();
+        auto dir = tmpdir();
+        auto pkey = partition_key::from_single_value(*s, serialized("pk"));
+        auto ts = api::new_timestamp();
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        // Values of both fixed and variable length, some spanning several buffers.
+        for (auto v1_size : {0, 10, 1000, 300 * 1024}) {
+            mutation m(s, pkey);
+            auto ck = clustering_key::from_single_value(*s, serialized(format("ck{:06d}", v1_size)));
+            m.set_clustered_cell(ck, to_bytes("v1"), data_value(sstring(v1_size, 'a')), ts);
+            m.set_clustered_cell(ck, to_bytes("v2"), data_value(format("v2-{}", v1_size)), ts);
+            mt->apply(std::move(m));
+        }
+        auto version = sstables::get_highest_sstable_version();
+        make_sstable_easy(env, dir.path(), mt, env.manager().configure_writer(), 1, version);
+
+        auto new_s = schema_builder(s)
+                .without_column("v1", utf8_type, ts + 1)
+                .build();
+        mutation expected(new_s, pkey);
+        for (auto v1_size : {0, 10, 1000, 300 * 1024}) {
+            auto ck = clustering_key::from_single_value(*new_s, serialized(format("ck{:06d}", v1_size)));
+            expected.set_clustered_cell(ck, to_bytes("v2"), data_value(format("v2-{}", v1_size)), ts);
+        }
+
+        auto sst = env.reusable_sst(new_s, dir.path().string(), 1, version).get0();
+        assert_that(sst->make_reader(new_s, env.make_reader_permit(), query::full_partition_range, new_s->full_slice()))
+            .produces(expected)
+            .produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(test_lazily_loaded_filter) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto dir = tmpdir();
+        auto pkeys = ss.make_pkeys(100);
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        for (auto& dk : pkeys) {
+            mutation m(s, dk);
+            ss.add_row(m, ss.make_ckey("ck"), "v");
+            mt->apply(std::move(m));
+        }
+        auto version = sstables::get_highest_sstable_version();
+        make_sstable_easy(env, dir.path(), mt, env.manager().configure_writer(), 1, version, pkeys.size());
+
+        auto sst = env.make_sstable(s, dir.path().string(), 1, version);
+        sstable_open_config cfg;
+        cfg.load_filter_lazily = true;
+        sst->load(default_priority_class(), cfg).get();
+        BOOST_REQUIRE_EQUAL(sst->filter_memory_size(), 0);
+
+        // Until the filter is loaded, all keys are considered present.
+        auto absent = partition_key::from_single_value(*s, serialized("absent"));
+        BOOST_REQUIRE(sst->filter_has_key(*s, absent));
+        for (int i = 0; i < 1000 && !sst->filter_memory_size(); ++i) {
+            seastar::sleep(std::chrono::milliseconds(1)).get();
+        }
+        BOOST_REQUIRE_GT(sst->filter_memory_size(), 0);
+        for (auto& dk : pkeys) {
+            BOOST_REQUIRE(sst->filter_has_key(*s, dk.key()));
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_summary_thinned_to_fit_capacity) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("v", utf8_type)
+                .set_min_index_interval(1)
+                .set_max_index_interval(16)
+                .build();
+        auto dir = tmpdir();
+        auto pkeys = boost::copy_range<std::vector<dht::decorated_key>>(make_local_keys(20000, s)
+                | boost::adaptors::transformed([&] (const sstring& k) {
+            return dht::decorate_key(*s, partition_key::from_single_value(*s, serialized(k)));
+        }));
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        for (auto& dk : pkeys) {
+            mutation m(s, dk);
+            m.set_clustered_cell(clustering_key::make_empty(), to_bytes("v"), data_value("v"), api::new_timestamp());
+            mt->apply(std::move(m));
+        }
+        // Sample every partition.
+        env.db_config().sstable_summary_ratio.set(1.0);
+        env.db_config().index_summary_capacity_in_mb.set(1);
+        auto version = sstables::get_highest_sstable_version();
+        make_sstable_easy(env, dir.path(), mt, env.manager().configure_writer(), 1, version, pkeys.size());
+
+        // The summary of all partitions takes more than 1MB.
+        auto sst = env.reusable_sst(s, dir.path().string(), 1, version).get0();
+        auto& summary = sst->get_summary();
+        BOOST_REQUIRE_GT(summary.page_factor, 1);
+        BOOST_REQUIRE_LE(summary.page_factor, 16);
+        BOOST_REQUIRE_LT(summary.entries.size(), pkeys.size());
+        BOOST_REQUIRE_LE(env.manager().summary_memory_used(), env.manager().summary_memory_capacity());
+
+        for (size_t i = 0; i < pkeys.size(); i += 97) {
+            auto pr = dht::partition_range::make_singular(pkeys[i]);
+            assert_that(sst->make_reader(s, env.make_reader_permit(), pr, s->full_slice()))
+                .produces_partition_start(pkeys[i])
+                .next_partition()
+                .produces_end_of_stream();
+        }
+        assert_that(sst->make_reader(s, env.make_reader_permit(), query::full_partition_range, s->full_slice()))
+            .produces_partition_start(pkeys.front());
+    });
+}
+
 static std::unique_ptr<index_reader> get_index_reader(shared_sstable sst, reader_permit permit) {
     return std::make_unique<index_reader>(sst, std::move(permit), default_priority_class(),
                                           tracing::trace_state_ptr(), use_caching::yes);
@@ -1405,7 +1566,7 @@ SEASTAR_TEST_CASE(test_large_index_pages_do_not_cause_large_allocations) {
     auto mt = make_lw_shared<replica::memtable>(s);
     {
         mutation m(s, *large_key);
-        ss.add_row(m, ss.make_ckey(0), "v");
+        ss.add_row(m, ss.make_ckey("ck"), "v");
         mt->apply(m);
     }
 
@@ -12,6 +12,7 @@
 #include <seastar/testing/thread_test_case.hh>
 
 #include "sstables/partition_index_cache.hh"
+#include "sstables/mx/promoted_index_cache.hh"
 #include "test/lib/simple_schema.hh"
 
 using namespace sstables;
@@ -272,3 +273,70 @@ SEASTAR_THREAD_TEST_CASE(test_evict_gently) {
 
     cache.evict_gently().get();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_promoted_index_cache) {
+    ::lru lru;
+    simple_schema s;
+    logalloc::region r;
+    using block_start = mc::promoted_index_cache::block_start;
+    auto old_stats = mc::promoted_index_cache::shard_stats();
+
+    auto start = [&] (int i) {
+        return position_in_partition::for_key(s.make_ckey(i));
+    };
+
+    {
+        mc::promoted_index_cache cache(lru, r);
+
+        BOOST_REQUIRE(!cache.find(0, 1));
+
+        cache.insert(0, {block_start{1, 10, start(1)}, block_start{3, 30, start(3)}});
+        cache.insert(0, {block_start{2, 20, start(2)}, block_start{3, 30, start(3)}});
+        BOOST_REQUIRE_EQUAL(cache.shard_stats().populations, old_stats.populations + 3);
+
+        r.full_compaction();
+
+        for (int i : {1, 2, 3}) {
+            auto b = cache.find(0, i);
+            BOOST_REQUIRE(b);
+            BOOST_REQUIRE_EQUAL(b->index, i);
+            BOOST_REQUIRE_EQUAL(b->offset, i * 10);
+            BOOST_REQUIRE(position_in_partition::equal_compare(*s.schema())(b->start, start(i)));
+        }
+        BOOST_REQUIRE(!cache.find(0, 4));
+        BOOST_REQUIRE(!cache.find(1, 1));
+        BOOST_REQUIRE_EQUAL(cache.shard_stats().hits, old_stats.hits + 3);
+
+        // The number of blocks cached per partition is bounded
+        std::vector<block_start> many;
+        for (unsigned i = 0; i < mc::promoted_index_cache::max_blocks_per_partition + 1; ++i) {
+            many.push_back(block_start{i, i, start(i)});
+        }
+        cache.insert(1, many);
+        BOOST_REQUIRE(cache.find(1, mc::promoted_index_cache::max_blocks_per_partition - 1));
+        BOOST_REQUIRE(!cache.find(1, mc::promoted_index_cache::max_blocks_per_partition));
+        BOOST_REQUIRE_EQUAL(cache.shard_stats().populations,
+                old_stats.populations + 3 + mc::promoted_index_cache::max_blocks_per_partition);
+        BOOST_REQUIRE_GT(cache.shard_stats().used_bytes, old_stats.used_bytes);
+
+        with_allocator(r.allocator(), [&] {
+            lru.evict_all();
+        });
+
+        BOOST_REQUIRE(!cache.find(0, 1));
+        BOOST_REQUIRE(!cache.find(1, 1));
+        BOOST_REQUIRE_EQUAL(cache.shard_stats().evictions, old_stats.evictions + 2);
+        BOOST_REQUIRE_EQUAL(cache.shard_stats().used_bytes, old_stats.used_bytes);
+
+        cache.insert(2, {block_start{1, 10, start(1)}});
+        cache.evict_gently().get();
+        BOOST_REQUIRE(!cache.find(2, 1));
+        BOOST_REQUIRE_EQUAL(cache.shard_stats().evictions, old_stats.evictions + 3);
+
+        // Entries left in the cache are released on destruction
+        cache.insert(3, {block_start{1, 10, start(1)}});
+    }
+
+    BOOST_REQUIRE_EQUAL(mc::promoted_index_cache::shard_stats().evictions, old_stats.evictions + 4);
+    BOOST_REQUIRE_EQUAL(mc::promoted_index_cache::shard_stats().used_bytes, old_stats.used_bytes);
+}
@@ -7,12 +7,14 @@
  */
 
 
+#include <boost/range/adaptor/transformed.hpp>
 #include <seastar/testing/test_case.hh>
 
 #include "sstables/sstable_set_impl.hh"
 #include "sstables/shared_sstable.hh"
 #include "sstables/sstable_set.hh"
 #include "sstables/sstables.hh"
+#include "schema_builder.hh"
 #include "test/lib/simple_schema.hh"
 #include "test/lib/sstable_utils.hh"
 #include "readers/from_mutations_v2.hh"
@@ -89,3 +91,83 @@ SEASTAR_TEST_CASE(test_time_series_sstable_set_read_modify_write) {
         return make_ready_future<>();
     });
 }
+
+SEASTAR_TEST_CASE(test_partitioned_sstable_set_select) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf").with_column("p1", utf8_type, column_kind::partition_key).build();
+        auto keys = token_generation_for_current_shard(8);
+        auto dks = boost::copy_range<std::vector<dht::decorated_key>>(keys | boost::adaptors::transformed([&s] (const std::pair<sstring, dht::token>& key_and_token) {
+            auto value = bytes(reinterpret_cast<const signed char*>(key_and_token.first.data()), key_and_token.first.size());
+            return dht::decorate_key(*s, sstables::key::from_bytes(value).to_partition_key(*s));
+        }));
+
+        struct span {
+            shared_sstable sst;
+            size_t first;
+            size_t last;
+        };
+        int64_t gen = 1;
+        auto make_span = [&] (size_t first, size_t last, uint32_t level) {
+            auto sst = env.make_sstable(s, "", gen++, la, big);
+            sstables::test(sst).set_values_for_leveled_strategy(0, level, 0, keys[first].first, keys[last].first);
+            return span{sst, first, last};
+        };
+
+        // Checks that the set selects exactly the sstables of spans overlapping each range of keys.
+        auto check = [&] (const sstable_set& set, const std::vector<span>& spans) {
+            for (size_t i = 0; i < dks.size(); ++i) {
+                for (size_t j = i; j < dks.size(); ++j) {
+                    std::unordered_set<shared_sstable> expected;
+                    for (auto& sp : spans) {
+                        if (sp.first <= j && sp.last >= i) {
+                            expected.insert(sp.sst);
+                        }
+                    }
+                    auto selected = set.select(dht::partition_range::make({dks[i]}, {dks[j]}));
+                    BOOST_REQUIRE_EQUAL(selected.size(), expected.size());
+                    BOOST_REQUIRE(std::unordered_set<shared_sstable>(selected.begin(), selected.end()) == expected);
+                }
+            }
+            auto sel = set.make_incremental_selector();
+            for (size_t i = 0; i < dks.size(); ++i) {
+                std::unordered_set<shared_sstable> expected;
+                for (auto& sp : spans) {
+                    if (sp.first <= i && sp.last >= i) {
+                        expected.insert(sp.sst);
+                    }
+                }
+                auto selected = sel.select(dks[i]).sstables;
+                BOOST_REQUIRE_EQUAL(selected.size(), expected.size());
+                BOOST_REQUIRE(std::unordered_set<shared_sstable>(selected.begin(), selected.end()) == expected);
+            }
+        };
+
+        std::vector<span> spans = {
+            make_span(0, 1, 1),
+            make_span(2, 3, 1),
+            make_span(4, 4, 1),
+            make_span(1, 4, 2),
+            make_span(5, 7, 2),
+            make_span(0, 7, 3),
+            make_span(2, 5, 3),
+            make_span(3, 6, 0),
+        };
+        auto set = make_sstable_set(s, make_lw_shared<sstable_list>());
+        for (auto& sp : spans) {
+            set.insert(sp.sst);
+        }
+        check(set, spans);
+
+        // Changing a clone doesn't change the original, even though they share their sstables.
+        auto clone = set;
+        auto clone_spans = spans;
+        clone.erase(clone_spans[1].sst);
+        clone_spans.erase(clone_spans.begin() + 1);
+        clone_spans.push_back(make_span(6, 7, 1));
+        clone.insert(clone_spans.back().sst);
+        clone.erase(clone_spans[3].sst);
+        clone_spans.erase(clone_spans.begin() + 3);
+        check(clone, clone_spans);
+        check(set, spans);
+    });
+}
@@ -815,6 +815,145 @@ SEASTAR_TEST_CASE(test_skipping_in_compressed_stream) {
     });
 }
 
+SEASTAR_TEST_CASE(test_read_ahead_controller) {
+    sstables::read_ahead_controller c(16, 100);
+    BOOST_REQUIRE_EQUAL(c.window(), 16);
+    c.on_sequential_read();
+    BOOST_REQUIRE_EQUAL(c.window(), 32);
+    c.on_sequential_read();
+    c.on_sequential_read();
+    BOOST_REQUIRE_EQUAL(c.window(), 100);
+    c.on_skip();
+    BOOST_REQUIRE_EQUAL(c.window(), 16);
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_adaptive_file_input_stream) {
+    return seastar::async([] {
+        tmpdir tmp;
+        auto file_path = (tmp.path() / "test").string();
+        temporary_buffer<char> data(1024 * 1024);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data.get_write()[i] = char(i % 251);
+        }
+        {
+            file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+            auto out = make_file_output_stream(f, file_output_stream_options()).get0();
+            out.write(data.get(), data.size()).get();
+            out.close().get();
+        }
+
+        file f = open_file_dma(file_path, open_flags::ro).get0();
+        auto close_f = deferred_close(f);
+        file_input_stream_options opts;
+        opts.buffer_size = 64 * 1024;
+        opts.read_ahead = 4;
+        auto stats = make_lw_shared<sstables::data_read_stats>();
+
+        auto expect = [&] (input_stream<char>& in, size_t pos, size_t len) {
+            auto b = in.read_exactly(len).get0();
+            BOOST_REQUIRE(b == data.share(pos, len));
+        };
+
+        // Sequential reads grow.
+        {
+            auto in = make_adaptive_file_input_stream(f, 10, data.size() - 10, opts, stats);
+            auto close_in = deferred_close(in);
+            size_t pos = 10;
+            size_t first_size = 0;
+            size_t max_size = 0;
+            while (auto b = in.read().get0()) {
+                BOOST_REQUIRE(b == data.share(pos, b.size()));
+                pos += b.size();
+                first_size = first_size ? first_size : b.size();
+                max_size = std::max(max_size, b.size());
+            }
+            BOOST_REQUIRE_EQUAL(pos, data.size());
+            BOOST_REQUIRE_LT(first_size, max_size);
+            BOOST_REQUIRE_EQUAL(stats->bytes_consumed, data.size() - 10);
+            BOOST_REQUIRE_EQUAL(stats->bytes_read, data.size() - 10);
+        }
+
+        // Skips, within and past the data read ahead.
+        {
+            auto in = make_adaptive_file_input_stream(f, 0, 500000, opts, stats);
+            auto close_in = deferred_close(in);
+            expect(in, 0, 100);
+            in.skip(10).get();
+            expect(in, 110, 20000);
+            in.skip(300000).get();
+            expect(in, 320110, 100);
+            in.skip(500000).get();
+            BOOST_REQUIRE(in.read().get0().empty());
+        }
+        BOOST_REQUIRE_LE(stats->bytes_consumed, stats->bytes_read);
+    });
+}
+
+SEASTAR_TEST_CASE(test_zstd_dictionary_compressed_stream) {
+    return seastar::async([] {
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        tmpdir tmp;
+
+        compression_parameters cp({
+            { compression_parameters::SSTABLE_COMPRESSION, "ZstdCompressor" },
+            { compression_parameters::CHUNK_LENGTH_KB, "4" },
+            { "dictionary_size_in_kb", "4" },
+        });
+
+        // Small chunks of similar records, each of which compresses poorly on its own.
+        std::vector<temporary_buffer<char>> chunks;
+        unsigned id = 0;
+        for (int i = 0; i < 128; i++) {
+            sstring chunk;
+            while (chunk.size() < 4096) {
+                chunk += format("{{\"id\": {}, \"name\": \"user-{}\", \"email\": \"user-{}@example.com\", \"active\": {}}}",
+                        id, id * 7919, id * 104729, id % 3 == 0);
+                id++;
+            }
+            chunks.emplace_back(chunk.data(), 4096);
+        }
+
+        auto get_dictionary = [] (const sstables::compression& c) -> std::optional<sstring> {
+            for (auto& o : c.options.elements) {
+                if (sstring(o.key.value.begin(), o.key.value.end()) == "dictionary") {
+                    return sstring(o.value.value.begin(), o.value.value.end());
+                }
+            }
+            return std::nullopt;
+        };
+
+        auto write_and_verify = [&] (sstring name) {
+            auto file_path = (tmp.path() / name.c_str()).string();
+            file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+            sstables::compression c;
+            auto os = make_file_output_stream(f, file_output_stream_options()).get0();
+            auto out = make_compressed_file_m_format_output_stream(std::move(os), &c, cp);
+            for (auto& chunk : chunks) {
+                out.write(chunk.get(), chunk.size()).get();
+            }
+            out.close().get();
+            c.update(seastar::file_size(file_path).get0());
+
+            f = open_file_dma(file_path, open_flags::ro).get0();
+            auto in = make_compressed_file_m_format_input_stream(f, &c, 0, chunks.size() * 4096, file_input_stream_options(), semaphore.make_permit());
+            for (auto& chunk : chunks) {
+                BOOST_REQUIRE(in.read_exactly(chunk.size()).get0() == chunk);
+            }
+            BOOST_REQUIRE(in.read().get0().empty());
+            in.close().get();
+
+            auto dictionary = get_dictionary(c);
+            BOOST_REQUIRE(dictionary);
+            return *dictionary;
+        };
+
+        // The dictionary trained for the first file is reused for the following ones.
+        auto dictionary = write_and_verify("test1");
+        BOOST_REQUIRE_EQUAL(write_and_verify("test2"), dictionary);
+    });
+}
+
 // Test that sstables::key_view::tri_compare(const schema& s, partition_key_view other)
 // should correctly compare empty keys. The fact we did this incorrectly was
 // noticed while fixing #9375, and a separate issue on it is #10178.
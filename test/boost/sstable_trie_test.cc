@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/range/irange.hpp>
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/util/defer.hh>
+
+#include "test/lib/random_utils.hh"
+#include "test/lib/log.hh"
+#include "test/lib/tmpdir.hh"
+#include "test/lib/simple_schema.hh"
+
+#include "sstables/trie/trie.hh"
+#include "utils/cached_file.hh"
+#include "to_string.hh"
+
+using namespace sstables;
+
+static lru cf_lru;
+
+namespace {
+
+struct memory_output {
+    bytes_ostream buf;
+
+    void write(const char* p, size_t n) {
+        buf.write(bytes_view(reinterpret_cast<const int8_t*>(p), n));
+    }
+    uint64_t offset() const {
+        return buf.size();
+    }
+};
+
+// Writes the given trie to a file and provides a reader for it going through cached_file.
+class trie_file {
+    tmpdir _dir;
+    file _f;
+    cached_file::metrics _metrics;
+    logalloc::region _region;
+    std::unique_ptr<cached_file> _cf;
+public:
+    trie_file(const memory_output& out) {
+        auto path = _dir.path() / "trie";
+        auto f = open_file_dma(path.c_str(), open_flags::create | open_flags::rw).get0();
+        auto os = make_file_output_stream(f).get0();
+        for (auto frag : out.buf) {
+            os.write(reinterpret_cast<const char*>(frag.begin()), frag.size()).get();
+        }
+        os.close().get();
+        _f = open_file_dma(path.c_str(), open_flags::ro).get0();
+        _cf = std::make_unique<cached_file>(_f, _metrics, cf_lru, _region, out.offset());
+    }
+
+    ~trie_file() {
+        _cf.reset();
+        _f.close().get();
+    }
+
+    trie::trie_reader make_reader(uint64_t root) {
+        return trie::trie_reader(make_cached_seastar_file(*_cf), _cf->size(), root, default_priority_class());
+    }
+};
+
+}
+
+static bytes to_key(sstring s) {
+    return bytes(reinterpret_cast<const int8_t*>(s.data()), s.size());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_trie_lookups) {
+    std::vector<bytes> keys = { to_key("a"), to_key("ab"), to_key("abc"), to_key("abd"), to_key("b"), to_key("bcd"), to_key("xyz") };
+
+    memory_output out;
+    trie::trie_writer<memory_output> writer(out);
+    for (size_t i = 0; i < keys.size(); i++) {
+        writer.add(keys[i], i);
+    }
+    auto root = writer.finish();
+    BOOST_REQUIRE(root);
+
+    trie_file tf(out);
+    auto reader = tf.make_reader(*root);
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        BOOST_REQUIRE_EQUAL(reader.find(keys[i]).get0(), i);
+        BOOST_REQUIRE_EQUAL(reader.find_floor(keys[i]).get0(), i);
+        BOOST_REQUIRE_EQUAL(reader.find_ceiling(keys[i]).get0(), i);
+    }
+
+    BOOST_REQUIRE(!reader.find(to_key("abe")).get0());
+    BOOST_REQUIRE(!reader.find(to_key("")).get0());
+
+    BOOST_REQUIRE(!reader.find_floor(to_key("")).get0());
+    BOOST_REQUIRE_EQUAL(reader.find_floor(to_key("aa")).get0(), 0);
+    BOOST_REQUIRE_EQUAL(reader.find_floor(to_key("abca")).get0(), 2);
+    BOOST_REQUIRE_EQUAL(reader.find_floor(to_key("abz")).get0(), 3);
+    BOOST_REQUIRE_EQUAL(reader.find_floor(to_key("bc")).get0(), 4);
+    BOOST_REQUIRE_EQUAL(reader.find_floor(to_key("zzz")).get0(), 6);
+
+    BOOST_REQUIRE_EQUAL(reader.find_ceiling(to_key("")).get0(), 0);
+    BOOST_REQUIRE_EQUAL(reader.find_ceiling(to_key("aa")).get0(), 1);
+    BOOST_REQUIRE_EQUAL(reader.find_ceiling(to_key("abca")).get0(), 3);
+    BOOST_REQUIRE_EQUAL(reader.find_ceiling(to_key("abz")).get0(), 4);
+    BOOST_REQUIRE_EQUAL(reader.find_ceiling(to_key("bc")).get0(), 5);
+    BOOST_REQUIRE(!reader.find_ceiling(to_key("zzz")).get0());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_trie_rejects_unordered_keys) {
+    memory_output out;
+    trie::trie_writer<memory_output> writer(out);
+    writer.add(to_key("b"), 0);
+    BOOST_REQUIRE_THROW(writer.add(to_key("a"), 1), std::invalid_argument);
+    BOOST_REQUIRE_THROW(writer.add(to_key("b"), 1), std::invalid_argument);
+    BOOST_REQUIRE(!trie::trie_writer<memory_output>(out).finish());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_trie_partition_keys) {
+    simple_schema ss;
+    auto s = ss.schema();
+    auto dks = ss.make_pkeys(1000);
+    std::sort(dks.begin(), dks.end(), dht::decorated_key::less_comparator(s));
+
+    std::vector<bytes> keys;
+    for (auto& dk : dks) {
+        keys.push_back(trie::byte_comparable(dk));
+    }
+    // Byte-comparable encoding must preserve the ring order.
+    BOOST_REQUIRE(std::is_sorted(keys.begin(), keys.end(), [] (const bytes& a, const bytes& b) {
+        return compare_unsigned(a, b) < 0;
+    }));
+
+    memory_output out;
+    trie::trie_writer<memory_output> writer(out);
+    for (size_t i = 0; i < keys.size(); i++) {
+        writer.add(keys[i], i);
+    }
+    auto root = writer.finish();
+    BOOST_REQUIRE(root);
+    testlog.info("trie of {} partition keys takes {} bytes", keys.size(), out.offset());
+
+    trie_file tf(out);
+    auto reader = tf.make_reader(*root);
+    for ([[maybe_unused]] auto i : boost::irange<size_t>(0, 100)) {
+        auto idx = tests::random::get_int<size_t>(0, keys.size() - 1);
+        BOOST_REQUIRE_EQUAL(reader.find(keys[idx]).get0(), idx);
+        // Tokens sort before all keys owning them.
+        BOOST_REQUIRE_EQUAL(reader.find_ceiling(trie::byte_comparable(dks[idx].token())).get0(), idx);
+        if (idx > 0) {
+            BOOST_REQUIRE_EQUAL(reader.find_floor(trie::byte_comparable(dks[idx].token())).get0(), idx - 1);
+        }
+    }
+}
@@ -9,12 +9,16 @@
 
 #include <seastar/core/thread.hh>
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
 #include "query-result-writer.hh"
 
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/mutation_source_test.hh"
 #include "test/lib/result_set_assertions.hh"
+#include "test/lib/simple_schema.hh"
 #include "service/storage_proxy.hh"
+#include "service/replica_latency_tracker.hh"
+#include "service/read_repair_queue.hh"
 #include "query_ranges_to_vnodes.hh"
 #include "partition_slice_builder.hh"
 #include "schema_builder.hh"
@@ -103,3 +107,119 @@ SEASTAR_TEST_CASE(test_get_restricted_ranges) {
         });
     });
 }
+
+SEASTAR_TEST_CASE(test_replica_latency_tracker) {
+    using namespace std::chrono_literals;
+    service::replica_latency_tracker tracker;
+    const auto reset_interval = std::chrono::duration_cast<service::replica_latency_tracker::clock_type::duration>(1h);
+    const gms::inet_address a("127.0.0.1"), b("127.0.0.2"), c("127.0.0.3");
+    auto all_equally_close = [] (gms::inet_address, gms::inet_address) { return true; };
+    auto b_apart = [&] (gms::inet_address x, gms::inet_address y) { return (x == b) == (y == b); };
+    auto sorted = [&] (inet_address_vector_replica_set eps, double badness_threshold, auto equally_close) {
+        tracker.sort_by_score(eps, badness_threshold, reset_interval, equally_close);
+        return eps;
+    };
+
+    // Without samples, the order is kept.
+    BOOST_REQUIRE_EQUAL(sorted({a, b, c}, 0.1, all_equally_close), inet_address_vector_replica_set({a, b, c}));
+
+    for (auto [ep, latency] : {std::pair(a, 1000us), std::pair(b, 200us), std::pair(c, 950us)}) {
+        tracker.on_request_sent(ep);
+        tracker.on_response(ep, latency, reset_interval);
+    }
+    BOOST_REQUIRE_EQUAL(tracker.score(a, reset_interval), 1000);
+    BOOST_REQUIRE_EQUAL(tracker.score(b, reset_interval), 200);
+
+    BOOST_REQUIRE_EQUAL(sorted({a, b, c}, 0.1, all_equally_close), inet_address_vector_replica_set({b, c, a}));
+    // The first replica is within the threshold of the best one.
+    BOOST_REQUIRE_EQUAL(sorted({c, a, b}, 5, all_equally_close), inet_address_vector_replica_set({c, a, b}));
+    // Replicas are reordered only within runs of equally close ones.
+    BOOST_REQUIRE_EQUAL(sorted({a, c, b}, 0.01, b_apart), inet_address_vector_replica_set({c, a, b}));
+
+    // Requests in flight make the replica worse.
+    tracker.on_request_sent(b);
+    tracker.on_request_sent(b);
+    tracker.on_request_sent(b);
+    tracker.on_request_sent(b);
+    tracker.on_request_sent(b);
+    BOOST_REQUIRE_EQUAL(tracker.score(b, reset_interval), 200 * 6);
+    BOOST_REQUIRE_EQUAL(sorted({b, a, c}, 0.1, all_equally_close), inet_address_vector_replica_set({c, a, b}));
+
+    // A fast failure doesn't improve the score, a slow one makes it worse.
+    tracker.on_failure(b, 10us, reset_interval);
+    BOOST_REQUIRE_EQUAL(tracker.score(b, reset_interval), 200 * 5);
+    tracker.on_failure(b, 1000us, reset_interval);
+    BOOST_REQUIRE_EQUAL(tracker.score(b, reset_interval), (200 + 0.25 * 800) * 4);
+
+    // The moving average follows the replica's latency.
+    tracker.on_request_sent(a);
+    tracker.on_response(a, 200us, reset_interval);
+    BOOST_REQUIRE_EQUAL(tracker.score(a, reset_interval), 800);
+
+    // Forgotten and expired samples score 0.
+    tracker.forget(a);
+    BOOST_REQUIRE_EQUAL(tracker.score(a, reset_interval), 0);
+    BOOST_REQUIRE_EQUAL(tracker.score(c, service::replica_latency_tracker::clock_type::duration(-1)), 0);
+
+    // Suspected replicas go last.
+    auto suspected_last = [&] (inet_address_vector_replica_set eps) {
+        tracker.move_suspected_last(eps);
+        return eps;
+    };
+    tracker.set_suspected(a, true);
+    BOOST_REQUIRE(tracker.is_suspected(a));
+    BOOST_REQUIRE_EQUAL(suspected_last({a, b, c}), inet_address_vector_replica_set({b, c, a}));
+    tracker.set_suspected(c, true);
+    BOOST_REQUIRE_EQUAL(suspected_last({c, b, a}), inet_address_vector_replica_set({b, c, a}));
+    tracker.set_suspected(a, false);
+    tracker.set_suspected(c, false);
+    BOOST_REQUIRE_EQUAL(suspected_last({c, b, a}), inet_address_vector_replica_set({c, b, a}));
+
+    // Failures are reported at most once per interval.
+    BOOST_REQUIRE(tracker.should_report_failure(a, reset_interval));
+    BOOST_REQUIRE(!tracker.should_report_failure(a, reset_interval));
+    BOOST_REQUIRE(tracker.should_report_failure(a, service::replica_latency_tracker::clock_type::duration(-1)));
+
+    return make_ready_future<>();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_read_repair_queue) {
+    simple_schema ss;
+    const gms::inet_address a("127.0.0.1"), b("127.0.0.2");
+    auto repair = [&] (sstring pk, uint32_t ck, gms::inet_address ep) {
+        auto m = ss.new_mutation(pk);
+        ss.add_row(m, ss.make_ckey(ck), "v");
+        service::read_repair_queue::diffs_type diffs;
+        diffs.emplace(ep, std::move(m));
+        return service::read_repair_queue::entry{nullptr, db::consistency_level::QUORUM, std::move(diffs)};
+    };
+
+    service::read_repair_queue q;
+    BOOST_REQUIRE(q.push(repair("pk1", 1, a), 2));
+    // Repairs of a queued partition are merged into its entry, even if the queue is full.
+    BOOST_REQUIRE(q.push(repair("pk1", 2, a), 1));
+    BOOST_REQUIRE(q.push(repair("pk1", 3, b), 1));
+    BOOST_REQUIRE(q.push(repair("pk2", 1, a), 2));
+    BOOST_REQUIRE(!q.push(repair("pk3", 1, a), 2));
+    BOOST_REQUIRE_EQUAL(q.size(), 2);
+    BOOST_REQUIRE_EQUAL(q.get_stats().queued, 2);
+    BOOST_REQUIRE_EQUAL(q.get_stats().merged, 2);
+    BOOST_REQUIRE_EQUAL(q.get_stats().dropped, 1);
+
+    auto batch = q.pop(1);
+    BOOST_REQUIRE_EQUAL(batch.size(), 1);
+    BOOST_REQUIRE_EQUAL(q.size(), 1);
+    auto rest = q.pop(10);
+    BOOST_REQUIRE_EQUAL(rest.size(), 1);
+    BOOST_REQUIRE(q.empty());
+    std::move(rest.begin(), rest.end(), std::back_inserter(batch));
+
+    auto pk1 = ss.make_pkey("pk1");
+    auto it = std::find_if(batch.begin(), batch.end(), [&] (const service::read_repair_queue::entry& e) {
+        return e.diffs.begin()->second->decorated_key().equal(*ss.schema(), pk1);
+    });
+    BOOST_REQUIRE(it != batch.end());
+    BOOST_REQUIRE_EQUAL(it->diffs.size(), 2);
+    BOOST_REQUIRE_EQUAL(it->diffs.at(a)->partition().row_count(), 2);
+    BOOST_REQUIRE_EQUAL(it->diffs.at(b)->partition().row_count(), 1);
+}
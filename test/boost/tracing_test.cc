@@ -10,13 +10,14 @@
 
 #include "tracing/tracing.hh"
 #include "tracing/trace_state.hh"
+#include "tracing/trace_ring_helper.hh"
 #include "utils/class_registrator.hh"
 
 #include "test/lib/cql_test_env.hh"
 
-future<> do_with_tracing_env(std::function<future<>(cql_test_env&)> func, cql_test_config cfg_in = {}) {
-    return do_with_cql_env_thread([func](auto &env) {
-        tracing::tracing::create_tracing("trace_keyspace_helper").get();
+future<> do_with_tracing_env(std::function<future<>(cql_test_env&)> func, sstring backend = "trace_keyspace_helper", cql_test_config cfg_in = {}) {
+    return do_with_cql_env_thread([func, backend](auto &env) {
+        tracing::tracing::create_tracing(backend).get();
 
         tracing::tracing::start_tracing(env.qp()).get();
 
@@ -87,3 +88,33 @@ SEASTAR_TEST_CASE(tracing_slow_query_fast_mode) {
         return make_ready_future<>();
     });
 }
+
+SEASTAR_TEST_CASE(tracing_ring_backend) {
+    return do_with_tracing_env([](auto &e) {
+        tracing::tracing &t = tracing::tracing::get_local_tracing_instance();
+
+        tracing::trace_state_props_set trace_props;
+        trace_props.set(tracing::trace_state_props::full_tracing);
+        {
+            tracing::trace_state_ptr trace_state = t.create_session(tracing::trace_type::QUERY, trace_props);
+            tracing::begin(trace_state, "ring test", gms::inet_address());
+            tracing::trace(trace_state, "trace 1");
+            tracing::trace(trace_state, "trace 2");
+        }
+        t.write_pending_records();
+
+        auto& ring = dynamic_cast<tracing::trace_ring_helper&>(t.backend_helper());
+        auto sessions = ring.sessions();
+        BOOST_REQUIRE_EQUAL(sessions.size(), 1);
+        BOOST_REQUIRE(sessions[0].command == tracing::trace_type::QUERY);
+        BOOST_REQUIRE_EQUAL(sessions[0].request, "ring test");
+        BOOST_REQUIRE_EQUAL(sessions[0].events.size(), 2);
+        BOOST_REQUIRE_EQUAL(sessions[0].events[0].message, "trace 1");
+        BOOST_REQUIRE_EQUAL(sessions[0].events[1].message, "trace 2");
+
+        // The session was not that slow
+        BOOST_REQUIRE(ring.sessions(std::chrono::hours(1)).empty());
+
+        return make_ready_future<>();
+    }, "trace_ring_helper");
+}
@@ -10,6 +10,8 @@
 
 #include "transport/request.hh"
 #include "transport/response.hh"
+#include "transport/segment.hh"
+#include "exceptions/exceptions.hh"
 
 #include "test/lib/random_utils.hh"
 
@@ -79,6 +81,17 @@ SEASTAR_THREAD_TEST_CASE(test_response_request_reader) {
     res.write_string_map(string_map);
     auto string_unordered_map = std::unordered_map<sstring, sstring>(string_map.begin(), string_map.end());
 
+    // Bytes map, as in custom payloads
+    auto bytes_map = std::unordered_map<sstring, bytes>();
+    res.write_short(16);
+    for (int i = 0; i < 16; i++) {
+        auto key = format("key{}", i);
+        auto value = !tests::random::get_int(4) ? bytes_opt() : bytes_opt(tests::random::get_bytes(tests::random::get_int<int16_t>(1024)));
+        res.write_string(key);
+        res.write_value(value);
+        bytes_map.emplace(key, value.value_or(bytes()));
+    }
+
     static constexpr auto version = 4;
 
     using sc = cql_transport::event::schema_change;
@@ -128,6 +141,8 @@ SEASTAR_THREAD_TEST_CASE(test_response_request_reader) {
     auto received_string_map = req.read_string_map();
     BOOST_CHECK_EQUAL(received_string_map, string_unordered_map);
 
+    BOOST_CHECK(req.read_bytes_map() == bytes_map);
+
     BOOST_CHECK_EQUAL(req.read_string(), "CREATED");
     BOOST_CHECK_EQUAL(req.read_string(), "KEYSPACE");
     BOOST_CHECK_EQUAL(req.read_string(), "foo");
@@ -156,3 +171,153 @@ SEASTAR_THREAD_TEST_CASE(test_response_request_reader) {
     BOOST_CHECK_EQUAL(req.read_short(), 1);
     BOOST_CHECK_EQUAL(req.read_string(), "zed");
 }
+
+SEASTAR_THREAD_TEST_CASE(test_response_referenced_values) {
+    auto res = cql_transport::response(0, cql_transport::cql_binary_opcode::RESULT, tracing::trace_state_ptr());
+    constexpr auto threshold = cql_transport::response::min_referenced_value_size;
+
+    std::vector<bytes> values;
+    for (auto size : {size_t(10), threshold, threshold - 1, 3 * threshold, size_t(0), 2 * threshold}) {
+        values.push_back(tests::random::get_bytes(size));
+    }
+    // A fragmented value, like those read from a query result.
+    bytes_ostream fragmented;
+    fragmented.write(tests::random::get_bytes(threshold));
+    fragmented.write(tests::random::get_bytes(threshold));
+
+    res.write_value_view(std::nullopt);
+    for (auto& v : values) {
+        res.write_int(0x1234);
+        res.write_value_view(query::result_bytes_view(bytes_view(v)));
+    }
+    auto it = fragmented.fragments().begin();
+    auto first = *it++;
+    res.write_value_view(query::result_bytes_view(first, fragmented.size(), it));
+    BOOST_REQUIRE(res.references_external_data());
+
+    static constexpr auto version = 4;
+    auto msg = res.make_message(version, cql_transport::cql_compression::none).release();
+    auto total_length = msg.len();
+    BOOST_REQUIRE_EQUAL(total_length, res.size() + 9);
+    auto fbufs = fragmented_temporary_buffer(msg.release(), total_length);
+
+    bytes_ostream linearization_buffer;
+    auto req = cql_transport::request_reader(fbufs.get_istream(), linearization_buffer);
+    req.read_byte();
+    req.read_byte();
+    req.read_short();
+    req.read_byte();
+    BOOST_CHECK_EQUAL(req.read_int() + 9, total_length);
+
+    BOOST_CHECK(req.read_value_view(version).value.is_null());
+    for (auto& v : values) {
+        BOOST_CHECK_EQUAL(req.read_int(), 0x1234);
+        BOOST_CHECK_EQUAL(to_bytes(req.read_value_view(version).value), v);
+    }
+    BOOST_CHECK_EQUAL(to_bytes(req.read_value_view(version).value), fragmented.linearize());
+}
+
+// Decodes the segments, and returns the concatenation of their payloads, and
+// the number of segments which aren't self-contained.
+static std::pair<std::string, size_t> decode_segments(const std::vector<temporary_buffer<char>>& segments, bool compressed) {
+    namespace seg = cql_transport::segment;
+    auto header_size = compressed ? seg::compressed_header_size : seg::header_size;
+    std::string payloads;
+    size_t not_self_contained = 0;
+    for (auto& s : segments) {
+        auto h = seg::decode_header(s.get(), compressed);
+        BOOST_REQUIRE_LE(h.payload_length, seg::max_payload_size);
+        BOOST_REQUIRE_EQUAL(s.size(), header_size + h.payload_length + seg::trailer_size);
+        auto payload = seg::decode_payload(h, s.share(header_size, s.size() - header_size));
+        payloads.append(payload.get(), payload.size());
+        not_self_contained += !h.self_contained;
+    }
+    return {std::move(payloads), not_self_contained};
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_round_trip) {
+    namespace seg = cql_transport::segment;
+    for (bool compress : {false, true}) {
+        cql_transport::segment_writer out(compress);
+        std::string expected;
+        size_t expected_not_self_contained = 0;
+        for (size_t size : std::vector<size_t>{10, 1000, 100000, 300000, 5, seg::max_payload_size, seg::max_payload_size + 1, 2 * seg::max_payload_size, 1}) {
+            // Alternate between incompressible and compressible envelopes.
+            auto envelope = size % 2 ? tests::random::get_bytes(size) : bytes(size, int8_t('a'));
+            out.write(envelope.size(), [&] (auto&& append) {
+                append(bytes_view(envelope).substr(0, size / 3));
+                append(bytes_view(envelope).substr(size / 3));
+            });
+            expected.append(reinterpret_cast<const char*>(envelope.data()), envelope.size());
+            if (size > seg::max_payload_size) {
+                expected_not_self_contained += (size + seg::max_payload_size - 1) / seg::max_payload_size;
+            }
+        }
+        auto segments = out.flush();
+        BOOST_REQUIRE(out.flush().empty());
+
+        auto [payloads, not_self_contained] = decode_segments(segments, compress);
+        BOOST_REQUIRE(payloads == expected);
+        BOOST_REQUIRE_EQUAL(not_self_contained, expected_not_self_contained);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_compression) {
+    namespace seg = cql_transport::segment;
+    cql_transport::segment_writer out(true);
+    auto envelope = bytes(100000, int8_t('a'));
+    out.write(envelope.size(), [&] (auto&& append) {
+        append(bytes_view(envelope));
+    });
+    auto segments = out.flush();
+    BOOST_REQUIRE_EQUAL(segments.size(), 1);
+    auto h = seg::decode_header(segments[0].get(), true);
+    BOOST_REQUIRE_EQUAL(h.uncompressed_length, envelope.size());
+    BOOST_REQUIRE_LT(h.payload_length, envelope.size() / 10);
+    BOOST_REQUIRE(h.self_contained);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_corruption) {
+    namespace seg = cql_transport::segment;
+    for (bool compress : {false, true}) {
+        auto header_size = compress ? seg::compressed_header_size : seg::header_size;
+        cql_transport::segment_writer out(compress);
+        auto envelope = tests::random::get_bytes(1000);
+        out.write(envelope.size(), [&] (auto&& append) {
+            append(bytes_view(envelope));
+        });
+        auto segments = out.flush();
+        BOOST_REQUIRE_EQUAL(segments.size(), 1);
+
+        auto corrupt_header = segments[0].clone();
+        corrupt_header.get_write()[1] ^= 0x10;
+        BOOST_REQUIRE_THROW(seg::decode_header(corrupt_header.get(), compress), exceptions::protocol_exception);
+
+        auto corrupt_payload = segments[0].clone();
+        corrupt_payload.get_write()[header_size + 500] ^= 0x10;
+        auto h = seg::decode_header(corrupt_payload.get(), compress);
+        BOOST_REQUIRE_THROW(seg::decode_payload(h, corrupt_payload.share(header_size, corrupt_payload.size() - header_size)), exceptions::protocol_exception);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_response_segments) {
+    auto res = cql_transport::response(1, cql_transport::cql_binary_opcode::RESULT, tracing::trace_state_ptr());
+    res.write_int(0x1234);
+    auto value = tests::random::get_bytes(cql_transport::response::min_referenced_value_size * 2);
+    res.write_value_view(query::result_bytes_view(bytes_view(value)));
+
+    cql_transport::segment_writer out(false);
+    static constexpr auto version = 4;
+    res.write(out, version);
+    auto [payloads, not_self_contained] = decode_segments(out.flush(), false);
+    BOOST_REQUIRE_EQUAL(not_self_contained, 0);
+
+    auto msg = res.make_message(version, cql_transport::cql_compression::none).release();
+    auto total_length = msg.len();
+    std::string expected;
+    for (auto& b : msg.release()) {
+        expected.append(b.get(), b.size());
+    }
+    BOOST_REQUIRE_EQUAL(expected.size(), total_length);
+    BOOST_REQUIRE(payloads == expected);
+}
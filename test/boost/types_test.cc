@@ -871,6 +871,29 @@ BOOST_AUTO_TEST_CASE(test_map_to_json) {
     BOOST_REQUIRE_EQUAL(to_json_string(*m, map_v.serialize()), "{\"42\": \"abc\", \"42\": \"abc\"}");
 }
 
+BOOST_AUTO_TEST_CASE(test_nested_to_json) {
+    auto m = map_type_impl::get_instance(int32_type, utf8_type, false);
+    auto l = list_type_impl::get_instance(m, false);
+    auto t = tuple_type_impl::get_instance({long_type, l, byte_type, utf8_type});
+    auto v = make_tuple_value(t, {
+        data_value(std::numeric_limits<int64_t>::min()),
+        make_list_value(l, {
+            make_map_value(m, {{data_value(int32_t(-1)), data_value("a\"b")}}),
+            make_map_value(m, {}),
+        }),
+        data_value(int8_t(-128)),
+        data_value::make_null(utf8_type),
+    });
+    auto expected = "[-9223372036854775808, [{\"-1\": \"a\\\"b\"}, {}], -128, null]";
+    BOOST_REQUIRE_EQUAL(to_json_string(*t, v.serialize_nonnull()), expected);
+
+    bytes_ostream out;
+    out.write("x", 1);
+    to_json(*t, bytes_view(v.serialize_nonnull()), out);
+    auto linearized = out.linearize();
+    BOOST_REQUIRE_EQUAL(std::string_view(reinterpret_cast<const char*>(linearized.data()), linearized.size()), format("x{}", expected));
+}
+
 BOOST_AUTO_TEST_CASE(test_set_to_string) {
     auto m = set_type_impl::get_instance(int32_type, true);
     using native_type = std::vector<data_value>;
@@ -14,6 +14,7 @@
 #include <random>
 
 #include "utils/utf8.hh"
+#include "utils/ascii.hh"
 #include "utils/fragmented_temporary_buffer.hh"
 
 struct test_str {
@@ -223,3 +224,46 @@ BOOST_AUTO_TEST_CASE(test_utf8_fragmented) {
         BOOST_REQUIRE(result == bad_pos);
     }
 }
+
+// Sequences surrounded by blocks of ASCII characters, starting at every
+// offset of a block, so that they straddle the blocks of the SIMD versions.
+BOOST_AUTO_TEST_CASE(test_utf8_between_ascii) {
+    uint8_t buf[256];
+
+    auto check = [&] (const test_str& test, bool expected) {
+        for (size_t off = 0; off <= 64; ++off) {
+            memset(buf, 'a', sizeof(buf));
+            memcpy(buf + off, test.data, test.len);
+            for (size_t len : {off + test.len, off + test.len + 1, size_t(128), sizeof(buf)}) {
+                BOOST_CHECK_EQUAL(utils::utf8::validate(buf, len), expected);
+            }
+            // Truncated sequences are invalid, even if followed by nothing but ASCII.
+            if (test.len > 1 && buf[off] >= 0xC0) {
+                memset(buf + off + test.len - 1, 'a', 1);
+                BOOST_CHECK(!utils::utf8::validate(buf, sizeof(buf)));
+            }
+        }
+    };
+    for (auto& test : positive) {
+        check(test, true);
+    }
+    for (auto& test : negative) {
+        check(test, false);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ascii) {
+    uint8_t buf[256];
+    memset(buf, 'a', sizeof(buf));
+
+    for (size_t len = 0; len <= sizeof(buf); ++len) {
+        BOOST_CHECK(utils::ascii::validate(buf, len));
+    }
+    for (size_t pos = 0; pos < sizeof(buf); ++pos) {
+        buf[pos] = 0x80;
+        BOOST_CHECK(!utils::ascii::validate(buf, sizeof(buf)));
+        BOOST_CHECK(!utils::ascii::validate(buf + pos, sizeof(buf) - pos));
+        BOOST_CHECK(utils::ascii::validate(buf, pos));
+        buf[pos] = 'a';
+    }
+}
@@ -191,6 +191,49 @@ SEASTAR_TEST_CASE(test_updates_no_read_before_update) {
     });
 }
 
+// Updates of the base columns which are neither selected by a view with a
+// regular column in its key nor filtered on by it are applied without reading
+// the base row first. Check that the view stays correct through them, and
+// through the updates of the columns which do need the read.
+SEASTAR_TEST_CASE(test_updates_of_unselected_columns) {
+    return do_with_cql_env_thread([] (auto& e) {
+        e.execute_cql("create table base (k int, c int, v int, u int, f int, primary key (k, c));").get();
+        e.execute_cql("create materialized view mv as select k, c, v from base "
+                              "where k is not null and c is not null and v is not null and f = 1 primary key (v, k, c)").get();
+
+        auto assert_view = [&] (std::vector<std::vector<bytes_opt>> rows) {
+            eventually([&] {
+                auto msg = e.execute_cql("select v, k, c from mv").get0();
+                assert_that(msg).is_rows().with_rows_ignore_order(rows);
+            });
+        };
+
+        e.execute_cql("insert into base (k, c, v, u, f) values (0, 0, 0, 0, 1);").get();
+        assert_view({{int32_type->decompose(0), int32_type->decompose(0), int32_type->decompose(0)}});
+
+        e.execute_cql("update base set u = 1 where k = 0 and c = 0;").get();
+        assert_view({{int32_type->decompose(0), int32_type->decompose(0), int32_type->decompose(0)}});
+
+        e.execute_cql("delete u from base where k = 0 and c = 0;").get();
+        assert_view({{int32_type->decompose(0), int32_type->decompose(0), int32_type->decompose(0)}});
+
+        e.execute_cql("update base set f = 2 where k = 0 and c = 0;").get();
+        assert_view({});
+
+        e.execute_cql("update base set u = 2 where k = 0 and c = 0;").get();
+        assert_view({});
+
+        e.execute_cql("update base set f = 1 where k = 0 and c = 0;").get();
+        assert_view({{int32_type->decompose(0), int32_type->decompose(0), int32_type->decompose(0)}});
+
+        e.execute_cql("update base set v = 1, u = 3 where k = 0 and c = 0;").get();
+        assert_view({{int32_type->decompose(1), int32_type->decompose(0), int32_type->decompose(0)}});
+
+        e.execute_cql("update base set u = 4 where k = 0 and c = 1;").get();
+        assert_view({{int32_type->decompose(1), int32_type->decompose(0), int32_type->decompose(0)}});
+    });
+}
+
 SEASTAR_TEST_CASE(test_reuse_name) {
     return do_with_cql_env_thread([] (auto& e) {
         e.execute_cql("create table cf (p int primary key, v int);").get();
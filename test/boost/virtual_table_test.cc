@@ -10,6 +10,7 @@
 
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
+#include <seastar/util/closeable.hh>
 #include "test/lib/test_services.hh"
 #include "test/lib/cql_test_env.hh"
 
@@ -17,6 +18,8 @@
 #include "db/system_keyspace.hh"
 #include "db/config.hh"
 #include "test/lib/cql_assertions.hh"
+#include "test/lib/reader_concurrency_semaphore.hh"
+#include "partition_slice_builder.hh"
 
 namespace db {
 
@@ -53,6 +56,63 @@ class test_table : public virtual_table {
     }
 };
 
+// Emits partition 0, with rows 0 to 9, skipping the rows the query doesn't select.
+class test_streaming_table : public streaming_virtual_table {
+public:
+    size_t rows_emitted = 0;
+
+    test_streaming_table() : streaming_virtual_table(test_table::build_schema()) {
+        _shard_aware = true;
+    }
+
+    future<> execute(reader_permit permit, result_collector& result, const query_restrictions& qr) override {
+        auto dk = dht::decorate_key(*_s, partition_key::from_single_value(*_s, data_value(0).serialize_nonnull()));
+        co_await result.emit_partition_start(dk);
+        for (int i = 0; i < 10; ++i) {
+            auto ck = clustering_key::from_single_value(*_s, data_value(i).serialize_nonnull());
+            if (!contains_row(qr, dk, ck)) {
+                continue;
+            }
+            clustering_row cr(std::move(ck));
+            set_cell(cr.cells(), "v", i);
+            co_await result.emit_row(std::move(cr));
+            ++rows_emitted;
+        }
+        co_await result.emit_partition_end();
+    }
+};
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_streaming_table_clustering_restrictions) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    db::test_streaming_table table;
+    auto s = table.schema();
+    auto ms = table.as_mutation_source();
+    auto ck = [&] (int i) {
+        return clustering_key::from_single_value(*s, data_value(i).serialize_nonnull());
+    };
+    auto slice = partition_slice_builder(*s)
+            .with_range(query::clustering_range::make(ck(3), ck(5)))
+            .with_range(query::clustering_range::make_singular(ck(8)))
+            .build();
+
+    auto read_rows = [&] (const schema_ptr& query_schema, const query::partition_slice& slice) {
+        auto rd = ms.make_reader_v2(query_schema, semaphore.make_permit(), query::full_partition_range, slice);
+        auto close_rd = deferred_close(rd);
+        auto m = read_mutation_from_flat_mutation_reader(rd).get0();
+        BOOST_REQUIRE(m);
+        return m->partition().row_count();
+    };
+
+    BOOST_REQUIRE_EQUAL(read_rows(s, slice), 4);
+    BOOST_REQUIRE_EQUAL(table.rows_emitted, 4);
+
+    // Reversed reads aren't pushed down, but are still filtered.
+    table.rows_emitted = 0;
+    auto reversed_slice = query::reverse_slice(*s, slice);
+    BOOST_REQUIRE_EQUAL(read_rows(s->make_reversed(), reversed_slice), 4);
+    BOOST_REQUIRE_EQUAL(table.rows_emitted, 10);
 }
 
 SEASTAR_TEST_CASE(test_set_cell) {
@@ -235,6 +235,29 @@ def test_scylla_sstable_dump_data(cql, test_keyspace, scylla_path, scylla_data_d
         assert json.loads(out)
 
 
+@pytest.mark.parametrize("table_factory", [
+        simple_no_clustering_table,
+        simple_clustering_table,
+        clustering_table_with_collection,
+        table_with_counters,
+])
+def test_scylla_sstable_stats(cql, test_keyspace, scylla_path, scylla_data_dir, table_factory):
+    with scylla_sstable(table_factory, cql, test_keyspace, scylla_data_dir) as (schema_file, sstables):
+        common_args = [scylla_path, "sstable", "stats", "--schema-file", schema_file]
+        stats = json.loads(subprocess.check_output(common_args + sstables))
+        concurrent_stats = json.loads(subprocess.check_output(common_args + ["--concurrency", "4"] + sstables))
+        merged_stats = json.loads(subprocess.check_output(common_args + ["--merge"] + sstables))
+
+    print(stats)
+
+    assert stats == concurrent_stats
+    assert len(stats["sstables"]) == len(sstables)
+    assert stats["total"]["partitions"] == sum(s["partitions"] for s in stats["sstables"].values())
+    assert stats["total"]["partition_rows"]["count"] == stats["total"]["partitions"]
+    assert list(merged_stats["sstables"].keys()) == ["anonymous"]
+    assert merged_stats["total"] == merged_stats["sstables"]["anonymous"]
+
+
 @pytest.mark.parametrize("table_factory", [
         simple_no_clustering_table,
         simple_clustering_table,
@@ -25,6 +25,7 @@ def test_clients(scylla_only, cql):
         'port',
         'client_type',
         'connection_stage',
+        'cross_shard_requests',
         'driver_name',
         'driver_version',
         'hostname',
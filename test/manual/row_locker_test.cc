@@ -312,3 +312,24 @@ SEASTAR_TEST_CASE(test_block_partition_row) {
         flock1.get0();
     });
 }
+
+// Test that the lock entries of released locks are reused for other
+// partitions and rows, and that locks taken on reused entries are not
+// confused with the locks of their previous keys.
+SEASTAR_TEST_CASE(test_nonblock_reused_entries) {
+    return seastar::async([&] {
+        auto s = make_schema();
+        row_locker rl(s);
+        auto ignore = [] (auto) { };
+        for (int i = 0; i < 100; i++) {
+            auto lock = rl.lock_ck(make_pk(s, to_sstring(i)), make_ck(s, to_sstring(i)), true, db::timeout_clock::time_point::max(), row_locker_stats).get0();
+            // The entries just reused for partition i must not be locked for partition i - 1.
+            auto lock2 = rl.lock_ck(make_pk(s, to_sstring(i - 1)), make_ck(s, to_sstring(i)), true, db::timeout_clock::time_point::max(), row_locker_stats).get0();
+            auto lock3 = rl.lock_pk(make_pk(s, to_sstring(i + 1)), true, db::timeout_clock::time_point::max(), row_locker_stats).get0();
+            ignore(std::move(lock2));
+            ignore(std::move(lock3));
+            ignore(std::move(lock));
+        }
+        BOOST_REQUIRE(rl.empty() == true);
+    });
+}
@@ -141,15 +141,37 @@ struct mutation_settings {
     size_t partition_key_size;
     size_t clustering_key_size;
     size_t data_size;
+    // Type of regular columns. Values of fixed-width types ignore data_size.
+    data_type column_type = bytes_type;
 };
 
+static data_type parse_column_type(const sstring& name) {
+    if (name == "blob") {
+        return bytes_type;
+    } else if (name == "int") {
+        return int32_type;
+    } else if (name == "bigint") {
+        return long_type;
+    }
+    throw std::invalid_argument(format("unsupported column type: {}", name));
+}
+
+static bytes random_value(const mutation_settings& settings) {
+    if (settings.column_type == int32_type) {
+        return int32_type->decompose(int32_t(std::rand()));
+    } else if (settings.column_type == long_type) {
+        return long_type->decompose(int64_t(std::rand()));
+    }
+    return bytes_type->decompose(data_value(random_bytes(settings.data_size)));
+}
+
 static schema_ptr make_schema(const mutation_settings& settings) {
     auto builder = schema_builder("ks", "cf")
         .with_column("pk", bytes_type, column_kind::partition_key)
         .with_column("ck", bytes_type, column_kind::clustering_key);
 
     for (size_t i = 0; i < settings.column_count; ++i) {
-        builder.with_column(to_bytes(random_name(settings.column_name_size)), bytes_type);
+        builder.with_column(to_bytes(random_name(settings.column_name_size)), settings.column_type);
     }
 
     return builder.build();
@@ -162,8 +184,7 @@ static mutation make_mutation(schema_ptr s, mutation_settings settings) {
         auto ck = clustering_key::from_single_value(*s, bytes_type->decompose(data_value(random_bytes(settings.clustering_key_size))));
         for (auto&& col : s->regular_columns()) {
             m.set_clustered_cell(ck, col,
-                atomic_cell::make_live(*bytes_type, 1,
-                    bytes_type->decompose(data_value(random_bytes(settings.data_size)))));
+                atomic_cell::make_live(*settings.column_type, 1, random_value(settings)));
         }
     }
     return m;
@@ -232,7 +253,8 @@ int main(int argc, char** argv) {
         ("partition-count", bpo::value<size_t>()->default_value(1), "partition count")
         ("partition-key-size", bpo::value<size_t>()->default_value(10), "partition key size")
         ("clustering-key-size", bpo::value<size_t>()->default_value(10), "clustering key size")
-        ("data-size", bpo::value<size_t>()->default_value(32), "cell data size");
+        ("data-size", bpo::value<size_t>()->default_value(32), "cell data size")
+        ("column-type", bpo::value<sstring>()->default_value("blob"), "type of regular columns: blob, int or bigint");
 
     return app.run(argc, argv, [&] {
         if (smp::count != 1) {
@@ -252,12 +274,14 @@ int main(int argc, char** argv) {
             settings.partition_key_size = app.configuration()["partition-key-size"].as<size_t>();
             settings.clustering_key_size = app.configuration()["clustering-key-size"].as<size_t>();
             settings.data_size = app.configuration()["data-size"].as<size_t>();
+            settings.column_type = parse_column_type(app.configuration()["column-type"].as<sstring>());
 
             auto& tracker = env.local_db().find_column_family("system", "local").get_row_cache().get_cache_tracker();
             auto sizes = calculate_sizes(tracker, settings);
 
             std::cout << "mutation footprint:" << "\n";
             std::cout << " - in cache:     " << sizes.cache << "\n";
+            std::cout << "   per row:      " << sizes.cache / std::max<size_t>(settings.partition_count * settings.row_count, 1) << "\n";
             std::cout << " - in memtable:  " << sizes.memtable << "\n";
             std::cout << " - in sstable:\n";
             for (auto v : sizes.sstable) {
@@ -23,6 +23,14 @@ struct big_decimal_test {
     const sstring neg_data_neg_exponent = "-" + make_random_numeric_string(18) + "E-" + make_random_numeric_string(7);
     const sstring neg_data_fraction_exponent = "-" + make_random_numeric_string(14) + "E" + make_random_numeric_string(6);
     const sstring neg_data_fraction_neg_exponent = "-" + make_random_numeric_string(14) + "E-" + make_random_numeric_string(6);
+    // Prices, as summed by the sum() and avg() aggregates.
+    const std::vector<big_decimal> small_values = [] {
+        std::vector<big_decimal> ret;
+        for (int i = 0; i < 1000; ++i) {
+            ret.emplace_back(2, boost::multiprecision::cpp_int(i * 137 % 100000 - 50000));
+        }
+        return ret;
+    }();
 };
 
 PERF_TEST_F(big_decimal_test, from_string) {
@@ -36,3 +44,21 @@ PERF_TEST_F(big_decimal_test, from_string) {
     perf_tests::do_not_optimize(big_decimal{neg_data_fraction_neg_exponent});
 }
 
+
+PERF_TEST_F(big_decimal_test, sum_small_values) {
+    big_decimal sum;
+    for (auto& v : small_values) {
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum);
+    return small_values.size();
+}
+
+PERF_TEST_F(big_decimal_test, sum_small_values_with_big_decimal_sum) {
+    big_decimal_sum sum;
+    for (auto& v : small_values) {
+        sum += v;
+    }
+    perf_tests::do_not_optimize(sum);
+    return small_values.size();
+}
@@ -47,6 +47,7 @@ int main(int argc, char** argv) {
         ("trace", "Enables trace-level logging for the test actions")
         ("no-reads", "Disable reads during the test")
         ("seconds", bpo::value<unsigned>()->default_value(60), "Duration [s] after which the test terminates with a success")
+        ("eviction-policy", bpo::value<sstring>()->default_value("lru"), "Eviction policy of the cache, see the cache_eviction_policy config option")
         ;
 
     return app.run(argc, argv, [&app] {
@@ -58,6 +59,7 @@ int main(int argc, char** argv) {
         auto& cfg = *cfg_ptr;
         cfg.enable_commitlog(false);
         cfg.enable_cache(true);
+        cfg.cache_eviction_policy(app.configuration()["eviction-policy"].as<sstring>());
 
         return do_with_cql_env_thread([&app] (cql_test_env& env) {
             auto reads_enabled = !app.configuration().contains("no-reads");
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include "compress.hh"
 #include "sstables/checksum_utils.hh"
 #include "test/lib/make_random_string.hh"
 #include "utils/gz/crc_combine.hh"
@@ -53,3 +54,44 @@ PERF_TEST_F(crc_test, perf_zlib_crc32_checksum) {
     perf_tests::do_not_optimize(
         zlib_crc32_checksummer::checksum(data.data(), data.size()));
 }
+
+// Measures the cost of verifying the checksum of a compressed chunk relative
+// to decompressing it, as done for every chunk read from a compressed sstable.
+struct compressed_chunk_test {
+    const compressor_ptr compressor = compressor::lz4;
+    sstring data;
+    temporary_buffer<char> compressed;
+    temporary_buffer<char> uncompressed{64*1024};
+    uint32_t expected;
+
+    compressed_chunk_test() {
+        // Compressible data, with a ratio of about 2.
+        auto fragment = make_random_string(64);
+        while (data.size() < 64*1024) {
+            data += fragment;
+            data += make_random_string(64);
+        }
+        compressed = temporary_buffer<char>(compressor->compress_max_size(data.size()));
+        auto len = compressor->compress(data.data(), data.size(), compressed.get_write(), compressed.size());
+        compressed.trim(len);
+        expected = crc32_utils::checksum(compressed.get(), compressed.size());
+    }
+};
+
+PERF_TEST_F(compressed_chunk_test, perf_crc32_checksum_compressed_chunk) {
+    perf_tests::do_not_optimize(
+        crc32_utils::checksum(compressed.get(), compressed.size()));
+}
+
+PERF_TEST_F(compressed_chunk_test, perf_lz4_uncompress_chunk) {
+    perf_tests::do_not_optimize(
+        compressor->uncompress(compressed.get(), compressed.size(), uncompressed.get_write(), uncompressed.size()));
+}
+
+PERF_TEST_F(compressed_chunk_test, perf_lz4_verify_and_uncompress_chunk) {
+    if (crc32_utils::checksum(compressed.get(), compressed.size()) != expected) {
+        abort();
+    }
+    perf_tests::do_not_optimize(
+        compressor->uncompress(compressed.get(), compressed.size(), uncompressed.get_write(), uncompressed.size()));
+}
@@ -38,6 +38,8 @@ struct test_config {
 
     size_t min_data_size;
     size_t max_data_size;
+    // Write random, incompressible, data rather than a repeated byte.
+    bool random_data = false;
 
     uint64_t min_flush_delay_in_ms;
     uint64_t max_flush_delay_in_ms;
@@ -55,6 +57,7 @@ static void write_json_result(std::string result_file, const test_config& cfg, c
 
     params["min-data-size"] = cfg.min_data_size;
     params["max-data-size"] = cfg.max_data_size;
+    params["random-data"] = cfg.random_data;
     params["min-flush-delay-in-ms"] = cfg.min_flush_delay_in_ms;
     params["max-flush-delay-in-ms"] = cfg.max_flush_delay_in_ms;
 
@@ -106,6 +109,7 @@ struct commitlog_service {
     test_config cfg;
     std::uniform_int_distribution<unsigned> delay_dist;
     std::uniform_int_distribution<size_t> size_dist;
+    bytes random_data;
     std::optional<db::commitlog> log;
     std::optional<db::commitlog::flush_handler_anchor> fa;
     timer<> flush_timer;
@@ -114,6 +118,7 @@ struct commitlog_service {
         : cfg(c)
         , delay_dist(cfg.min_flush_delay_in_ms, cfg.max_flush_delay_in_ms)
         , size_dist(cfg.min_data_size, cfg.max_data_size)
+        , random_data(cfg.random_data ? tests::random::get_bytes(cfg.max_data_size) : bytes())
     {}
 
     future<> init(const db::commitlog::config& cfg) {
@@ -141,8 +146,12 @@ static std::vector<clperf_result> do_commitlog_test(distributed<commitlog_servic
     return time_parallel_ex<clperf_result>([&] {
         auto& log = cls.local();
         size_t size = log.size_dist(tests::random::gen());
-        return log.log->add_mutation(uuid, size, db::commitlog::force_sync::no, [size](db::commitlog::output& dst) {
-            dst.fill('1', size);
+        return log.log->add_mutation(uuid, size, db::commitlog::force_sync::no, [size, &log](db::commitlog::output& dst) {
+            if (log.random_data.empty()) {
+                dst.fill('1', size);
+            } else {
+                dst.write(reinterpret_cast<const char*>(log.random_data.data()), size);
+            }
         }).then([](db::rp_handle h) {
             h.release();
         });
@@ -164,9 +173,11 @@ int main(int argc, char** argv) {
         ("commitlog-sync-period-in-ms", bpo::value<unsigned>(), "how long the system waits for other writes before performing a sync in \"periodic\" mode")
         ("commitlog-use-o-dsync", bpo::value<bool>()->default_value(true), "whether or not to use O_DSYNC mode for commitlog segments io")
         ("commitlog-use-hard-size-limit", bpo::value<bool>()->default_value(true), "whether or not to use a hard size limit for commitlog disk usage")
+        ("commitlog-use-compression", bpo::value<bool>()->default_value(false), "whether or not to compress commitlog entries")
 
         ("min-data-size", bpo::value<size_t>()->default_value(200), "minimum size of data element added")
         ("max-data-size", bpo::value<size_t>()->default_value(32/2 * 1024 * 1024 - 1), "maximum size of data element added")
+        ("random-data", bpo::value<bool>()->default_value(false), "whether to add random, incompressible, data elements instead of repeated bytes")
 
         ("min-flush-delay-in-ms", bpo::value<uint64_t>()->default_value(10), "minimum flush response delay")
         ("max-flush-delay-in-ms", bpo::value<uint64_t>()->default_value(800), "maximum flush response delay")
@@ -207,6 +218,7 @@ int main(int argc, char** argv) {
         if (app.configuration().contains("commitlog-use-hard-size-limit")) {
             db_cfg->commitlog_use_hard_size_limit(app.configuration()["commitlog-use-hard-size-limit"].as<bool>());
         }
+        db_cfg->commitlog_use_compression(app.configuration()["commitlog-use-compression"].as<bool>());
 
         auto cfg = test_config();
         cfg.duration_in_seconds = app.configuration()["duration"].as<unsigned>();
@@ -216,6 +228,7 @@ int main(int argc, char** argv) {
         }
         cfg.min_data_size = app.configuration()["min-data-size"].as<size_t>();
         cfg.max_data_size = app.configuration()["max-data-size"].as<size_t>();
+        cfg.random_data = app.configuration()["random-data"].as<bool>();
         cfg.min_flush_delay_in_ms = app.configuration()["min-flush-delay-in-ms"].as<uint64_t>();
         cfg.max_flush_delay_in_ms = app.configuration()["min-flush-delay-in-ms"].as<uint64_t>();
 
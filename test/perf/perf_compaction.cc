@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+// Measures the throughput of memtable flushes and of compactions, on real
+// sstables written to --testdir.
+//
+// The data is --partitions partitions of one of the schemas below, with
+// --rows-per-partition rows each. Each sstable holds all the partitions, with
+// newer timestamps than the previous one, so that compaction has to merge them.
+//
+// Operations:
+// - flush: writes a memtable holding all the partitions to an sstable,
+// - regular: flushes --sstables sstables, running the jobs picked by the
+//   compaction strategy after each flush, like a table would,
+// - major: compacts --sstables sstables together,
+// - scrub: scrubs --sstables sstables, in abort mode,
+// - cleanup: cleans up --sstables sstables, keeping half of the token ring.
+//
+// Each iteration reports the time, the size of the input and output and the
+// write amplification: bytes written by flushes and compactions, per byte
+// flushed. With --json-result, the results are also written in the format
+// read by perf_fast_forward_report.py.
+
+#include <json/json.h>
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/util/closeable.hh>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <fstream>
+
+#include "compaction/compaction.hh"
+#include "compaction/compaction_strategy.hh"
+#include "compaction/strategy_control.hh"
+#include "counters.hh"
+#include "release.hh"
+#include "schema_builder.hh"
+#include "types/map.hh"
+#include "test/lib/random_utils.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/lib/sstable_test_env.hh"
+#include "test/lib/sstable_utils.hh"
+#include "test/lib/test_services.hh"
+#include "test/lib/tmpdir.hh"
+
+using namespace sstables;
+
+namespace {
+
+enum class schema_type { narrow, wide, collections, counters };
+enum class operation_type { flush, regular, major, scrub, cleanup };
+
+std::ostream& operator<<(std::ostream& os, schema_type t) {
+    switch (t) {
+        case schema_type::narrow: return os << "narrow";
+        case schema_type::wide: return os << "wide";
+        case schema_type::collections: return os << "collections";
+        case schema_type::counters: return os << "counters";
+    }
+    abort();
+}
+
+std::ostream& operator<<(std::ostream& os, operation_type t) {
+    switch (t) {
+        case operation_type::flush: return os << "flush";
+        case operation_type::regular: return os << "regular";
+        case operation_type::major: return os << "major";
+        case operation_type::scrub: return os << "scrub";
+        case operation_type::cleanup: return os << "cleanup";
+    }
+    abort();
+}
+
+template <typename Enum>
+Enum parse_enum(const sstring& name, std::initializer_list<Enum> values) {
+    for (auto v : values) {
+        if (format("{}", v) == name) {
+            return v;
+        }
+    }
+    throw std::invalid_argument(format("Invalid value: {}", name));
+}
+
+struct perf_config {
+    schema_type schema;
+    operation_type operation;
+    sstring compaction_strategy;
+    unsigned partitions;
+    unsigned rows_per_partition;
+    unsigned value_size;
+    unsigned sstables;
+    unsigned iterations;
+};
+
+struct iteration_result {
+    std::chrono::duration<double> duration{0};
+    uint64_t partitions = 0;
+    uint64_t bytes_flushed = 0;
+    // The input and output of the measured operation.
+    uint64_t input_bytes = 0;
+    uint64_t output_bytes = 0;
+    uint64_t compactions = 0;
+
+    double mb_per_second() const {
+        return input_bytes / duration.count() / (1 << 20);
+    }
+    double write_amplification() const {
+        return bytes_flushed ? double(bytes_flushed + output_bytes) / bytes_flushed : 0.0;
+    }
+};
+
+class simple_strategy_control : public strategy_control {
+public:
+    // Compaction jobs are executed one at a time.
+    bool has_ongoing_compaction(table_state& table_s) const noexcept override {
+        return false;
+    }
+};
+
+schema_ptr make_schema(const perf_config& cfg) {
+    auto builder = schema_builder("ks", "perf_compaction")
+            .with_column("pk", utf8_type, column_kind::partition_key);
+    switch (cfg.schema) {
+    case schema_type::narrow:
+        builder.with_column("v", utf8_type);
+        break;
+    case schema_type::wide:
+        builder.with_column("ck", int32_type, column_kind::clustering_key);
+        builder.with_column("v", utf8_type);
+        break;
+    case schema_type::collections:
+        builder.with_column("ck", int32_type, column_kind::clustering_key);
+        builder.with_column("m", map_type_impl::get_instance(int32_type, utf8_type, true));
+        break;
+    case schema_type::counters:
+        builder.with_column("ck", int32_type, column_kind::clustering_key);
+        builder.with_column("c", counter_type);
+        break;
+    }
+    builder.set_compaction_strategy(compaction_strategy::type(cfg.compaction_strategy));
+    return builder.build();
+}
+
+class compaction_perf {
+    test_env& _env;
+    table_for_tests& _table;
+    const perf_config& _cfg;
+    const sstring _dir;
+    schema_ptr _s;
+    std::vector<dht::decorated_key> _keys;
+    simple_strategy_control _control;
+    unsigned long _generation = 0;
+    // Timestamps of the data of successive flushes are an hour apart.
+    api::timestamp_type _next_timestamp;
+private:
+    shared_sstable make_sstable() {
+        return _env.make_sstable(_s, _dir, ++_generation);
+    }
+
+    mutation make_partition(const dht::decorated_key& dk, api::timestamp_type ts) {
+        mutation m(_s, dk);
+        auto value = [&] {
+            return data_value(tests::random::get_sstring(_cfg.value_size));
+        };
+        if (_cfg.schema == schema_type::narrow) {
+            m.set_clustered_cell(clustering_key::make_empty(), to_bytes("v"), value(), ts);
+            return m;
+        }
+        const auto& cdef = *_s->regular_begin();
+        for (unsigned i = 0; i < _cfg.rows_per_partition; ++i) {
+            auto ck = clustering_key::from_single_value(*_s, int32_type->decompose(int32_t(i)));
+            switch (_cfg.schema) {
+            case schema_type::narrow:
+                break;
+            case schema_type::wide:
+                m.set_clustered_cell(ck, cdef, atomic_cell::make_live(*utf8_type, ts, value().serialize_nonnull()));
+                break;
+            case schema_type::collections: {
+                collection_mutation_description cm;
+                for (int32_t k = 0; k < 4; ++k) {
+                    cm.cells.emplace_back(int32_type->decompose(k), atomic_cell::make_live(*utf8_type, ts, value().serialize_nonnull()));
+                }
+                m.set_clustered_cell(ck, cdef, cm.serialize(*cdef.type));
+                break;
+            }
+            case schema_type::counters:
+                m.set_clustered_cell(ck, cdef, counter_cell_builder::from_single_shard(ts, counter_shard(counter_id::create_random_id(), i, 1)));
+                break;
+            }
+        }
+        return m;
+    }
+
+    // Writes all the partitions, with the next timestamp, to a new sstable.
+    shared_sstable flush(iteration_result* timed = nullptr) {
+        auto mt = make_lw_shared<replica::memtable>(_s);
+        auto ts = _next_timestamp;
+        _next_timestamp += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::hours(1)).count();
+        for (const auto& dk : _keys) {
+            mt->apply(make_partition(dk, ts));
+            seastar::thread::maybe_yield();
+        }
+        auto start = std::chrono::steady_clock::now();
+        auto sst = make_sstable_easy(_env, fs::path(_dir.c_str()), mt, _env.manager().configure_writer(), ++_generation,
+                sstables::get_highest_sstable_version(), _keys.size());
+        if (timed) {
+            timed->duration += std::chrono::steady_clock::now() - start;
+            timed->partitions += _keys.size();
+            timed->input_bytes += sst->bytes_on_disk();
+        }
+        return sst;
+    }
+
+    compaction_result compact(compaction_descriptor desc, iteration_result& result) {
+        auto start = std::chrono::steady_clock::now();
+        auto ret = compact_sstables(_table.get_compaction_manager(), std::move(desc), _table.as_table_state(), [this] { return make_sstable(); }).get0();
+        result.duration += std::chrono::steady_clock::now() - start;
+        result.input_bytes += ret.stats.start_size;
+        result.output_bytes += ret.stats.end_size;
+        ++result.compactions;
+        return ret;
+    }
+
+    void remove(std::vector<shared_sstable>& ssts) {
+        for (auto& sst : ssts) {
+            sst->unlink().get();
+        }
+        ssts.clear();
+    }
+
+    iteration_result run_flush() {
+        iteration_result result;
+        auto sst = flush(&result);
+        result.bytes_flushed = result.input_bytes;
+        result.output_bytes = 0;
+        std::vector<shared_sstable> ssts{sst};
+        remove(ssts);
+        return result;
+    }
+
+    iteration_result run_regular() {
+        iteration_result result;
+        auto& table_s = _table.as_table_state();
+        std::vector<shared_sstable> ssts;
+        for (unsigned i = 0; i < _cfg.sstables; ++i) {
+            ssts.push_back(flush());
+            result.bytes_flushed += ssts.back()->bytes_on_disk();
+            for (;;) {
+                auto desc = table_s.get_compaction_strategy().get_sstables_for_compaction(table_s, _control, ssts);
+                if (desc.sstables.empty()) {
+                    break;
+                }
+                auto input = desc.sstables;
+                auto ret = compact(std::move(desc), result);
+                std::unordered_set<shared_sstable> compacted(input.begin(), input.end());
+                std::erase_if(ssts, [&] (const shared_sstable& sst) { return compacted.contains(sst); });
+                ssts.insert(ssts.end(), ret.new_sstables.begin(), ret.new_sstables.end());
+                remove(input);
+            }
+        }
+        result.partitions = _keys.size();
+        remove(ssts);
+        return result;
+    }
+
+    iteration_result run_one_compaction(compaction_type_options options) {
+        iteration_result result;
+        std::vector<shared_sstable> ssts;
+        for (unsigned i = 0; i < _cfg.sstables; ++i) {
+            ssts.push_back(flush());
+            result.bytes_flushed += ssts.back()->bytes_on_disk();
+        }
+        auto ret = compact(compaction_descriptor(ssts, default_priority_class(), 0, compaction_descriptor::default_max_sstable_bytes,
+                run_id::create_random_id(), std::move(options)), result);
+        result.partitions = _keys.size() * _cfg.sstables;
+        remove(ssts);
+        remove(ret.new_sstables);
+        return result;
+    }
+
+public:
+    compaction_perf(test_env& env, table_for_tests& table, const perf_config& cfg, sstring dir)
+        : _env(env)
+        , _table(table)
+        , _cfg(cfg)
+        , _dir(std::move(dir))
+        , _s(table.schema())
+    {
+        for (auto& key : make_local_keys(_cfg.partitions, _s)) {
+            _keys.push_back(dht::decorate_key(*_s, partition_key::from_single_value(*_s, to_bytes(key))));
+        }
+        std::sort(_keys.begin(), _keys.end(), dht::decorated_key::less_comparator(_s));
+        _next_timestamp = api::new_timestamp() - std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::hours(1)).count() * _cfg.sstables * _cfg.iterations;
+    }
+
+    iteration_result run_iteration() {
+        switch (_cfg.operation) {
+        case operation_type::flush:
+            return run_flush();
+        case operation_type::regular:
+            return run_regular();
+        case operation_type::major:
+            return run_one_compaction(compaction_type_options::make_regular());
+        case operation_type::scrub:
+            return run_one_compaction(compaction_type_options::make_scrub(compaction_type_options::scrub::mode::abort));
+        case operation_type::cleanup: {
+            // Own the first half of the token ring.
+            dht::token_range_vector owned{dht::token_range::make_ending_with({dht::token::from_int64(0), false})};
+            return run_one_compaction(compaction_type_options::make_cleanup(compaction::make_owned_ranges_ptr(std::move(owned))));
+        }
+        }
+        abort();
+    }
+};
+
+void write_json_result(const std::string& result_file, const perf_config& cfg, const std::vector<iteration_result>& results) {
+    Json::Value root;
+
+    Json::Value params;
+    params["schema"] = format("{}", cfg.schema);
+    params["operation"] = format("{}", cfg.operation);
+    params["compaction_strategy"] = std::string(cfg.compaction_strategy);
+    params["partitions"] = cfg.partitions;
+    params["rows_per_partition"] = cfg.rows_per_partition;
+    params["value_size"] = cfg.value_size;
+    params["sstables"] = cfg.sstables;
+    root["results"]["parameters"] = std::move(params);
+
+    Json::Value stats{Json::arrayValue};
+    for (const auto& r : results) {
+        Json::Value v;
+        v["time (s)"] = r.duration.count();
+        v["MB/s"] = r.mb_per_second();
+        v["partitions/s"] = r.partitions / r.duration.count();
+        v["input MB"] = double(r.input_bytes) / (1 << 20);
+        v["output MB"] = double(r.output_bytes) / (1 << 20);
+        v["write amplification"] = r.write_amplification();
+        v["compactions"] = Json::UInt64(r.compactions);
+        stats.append(std::move(v));
+    }
+    root["results"]["stats"] = std::move(stats);
+
+    // <version>-<release>, with <release> being <scylla-build>.<date>.<git-hash>
+    std::vector<std::string> version_parts;
+    auto version = scylla_version();
+    boost::algorithm::split(version_parts, version, boost::is_any_of("-"));
+    std::vector<std::string> release_parts;
+    boost::algorithm::split(release_parts, version_parts[1], boost::is_any_of("."));
+    auto current_time = std::time(nullptr);
+    char time_str[100];
+    ::tm time_buf;
+    std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", ::localtime_r(&current_time, &time_buf));
+    auto& scylla_server = root["versions"]["scylla-server"];
+    scylla_server["version"] = version_parts[0];
+    scylla_server["date"] = release_parts[1];
+    scylla_server["commit_id"] = release_parts[2];
+    scylla_server["run_date_time"] = time_str;
+
+    auto out = std::ofstream(result_file);
+    out << root;
+}
+
+} // anonymous namespace
+
+namespace perf {
+
+int scylla_compaction_main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("operation", bpo::value<sstring>()->default_value("major"), "operation to measure, one of (flush, regular, major, scrub, cleanup)")
+        ("schema", bpo::value<sstring>()->default_value("narrow"), "schema of the data, one of (narrow, wide, collections, counters)")
+        ("compaction-strategy", bpo::value<sstring>()->default_value("SizeTieredCompactionStrategy"), "compaction strategy of the table, one of "
+             "(SizeTieredCompactionStrategy, LeveledCompactionStrategy, TimeWindowCompactionStrategy, IncrementalCompactionStrategy)")
+        ("partitions", bpo::value<unsigned>()->default_value(10000), "number of partitions in each sstable")
+        ("rows-per-partition", bpo::value<unsigned>()->default_value(10), "number of rows in each partition, ignored by the narrow schema")
+        ("value-size", bpo::value<unsigned>()->default_value(64), "size of the values, in bytes")
+        ("sstables", bpo::value<unsigned>()->default_value(4), "number of sstables to compact, or to flush with the regular operation")
+        ("iterations", bpo::value<unsigned>()->default_value(5), "number of times to run the operation")
+        ("testdir", bpo::value<sstring>()->default_value(""), "directory to write the sstables to, a temporary directory by default")
+        ("json-result", bpo::value<std::string>(), "name of the json result file");
+
+    return app.run(argc, argv, [&app] {
+        return seastar::async([&app] {
+            auto& opts = app.configuration();
+            perf_config cfg{
+                .schema = parse_enum(opts["schema"].as<sstring>(),
+                        {schema_type::narrow, schema_type::wide, schema_type::collections, schema_type::counters}),
+                .operation = parse_enum(opts["operation"].as<sstring>(),
+                        {operation_type::flush, operation_type::regular, operation_type::major, operation_type::scrub, operation_type::cleanup}),
+                .compaction_strategy = opts["compaction-strategy"].as<sstring>(),
+                .partitions = std::max(opts["partitions"].as<unsigned>(), 1u),
+                .rows_per_partition = std::max(opts["rows-per-partition"].as<unsigned>(), 1u),
+                .value_size = opts["value-size"].as<unsigned>(),
+                .sstables = std::max(opts["sstables"].as<unsigned>(), 1u),
+                .iterations = std::max(opts["iterations"].as<unsigned>(), 1u),
+            };
+
+            std::optional<tmpdir> tmp;
+            auto dir = opts["testdir"].as<sstring>();
+            if (dir.empty()) {
+                tmp.emplace();
+                dir = tmp->path().string();
+            } else {
+                test_setup::create_empty_test_dir(dir).get();
+            }
+
+            test_env env;
+            auto stop_env = deferred_stop(env);
+            table_for_tests table(env.manager(), make_schema(cfg), dir);
+            auto stop_table = deferred_stop(table);
+            table->start();
+
+            compaction_perf perf(env, table, cfg, dir);
+            std::vector<iteration_result> results;
+            fmt::print("{:>10} {:>10} {:>14} {:>10} {:>10} {:>9} {:>12}\n",
+                    "time (s)", "MB/s", "partitions/s", "input MB", "output MB", "write_amp", "compactions");
+            for (unsigned i = 0; i < cfg.iterations; ++i) {
+                auto r = perf.run_iteration();
+                fmt::print("{:>10.3f} {:>10.2f} {:>14.0f} {:>10.2f} {:>10.2f} {:>9.2f} {:>12}\n",
+                        r.duration.count(), r.mb_per_second(), r.partitions / r.duration.count(),
+                        double(r.input_bytes) / (1 << 20), double(r.output_bytes) / (1 << 20), r.write_amplification(), r.compactions);
+                results.push_back(r);
+            }
+
+            if (opts.contains("json-result")) {
+                write_json_result(opts["json-result"].as<std::string>(), cfg, results);
+            }
+        });
+    });
+}
+
+} // namespace perf
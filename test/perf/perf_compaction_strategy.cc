@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+// Simulates a compaction strategy on a synthetic write workload.
+//
+// The sstables only have metadata (key range, size, timestamps and level),
+// so nothing is written to disk and weeks of flushes are simulated in seconds.
+// The candidates and compaction jobs are picked by the real strategy code, and
+// the jobs are executed by replacing their input with sstables having the
+// metadata compaction would give them.
+//
+// Data is modeled as a key space of --keys keys, holding --dataset-size-mb MB
+// once all keys are written. Each flush writes --flush-size-mb MB on a
+// contiguous slice of --key-range-ratio of the key space, at a random position.
+// Compaction output holds the keys covered by its input, so its size is that
+// of the merged key ranges of the input, but no more than the input's size.
+//
+// Reported, every --report-every flushes:
+// - write amplification: bytes written by flushes and compactions, per byte flushed,
+// - space amplification: bytes on disk, per byte of live data,
+// - sstables per read: average number of sstables overlapping a key,
+// - backlog: as computed by the backlog tracker of the strategy.
+
+#include <random>
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/util/closeable.hh>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+
+#include "compaction/compaction_strategy.hh"
+#include "compaction/strategy_control.hh"
+#include "schema_builder.hh"
+#include "test/lib/sstable_test_env.hh"
+#include "test/lib/sstable_utils.hh"
+#include "test/lib/test_services.hh"
+
+using namespace sstables;
+
+namespace {
+
+struct simulation_config {
+    unsigned flushes;
+    uint64_t flush_size;
+    uint64_t dataset_size;
+    unsigned keys;
+    double key_range_ratio;
+    std::chrono::seconds flush_interval;
+    unsigned report_every;
+    unsigned read_samples;
+};
+
+class simulation_strategy_control : public strategy_control {
+public:
+    // Compaction jobs are executed one at a time.
+    bool has_ongoing_compaction(table_state& table_s) const noexcept override {
+        return false;
+    }
+};
+
+class compaction_simulator {
+    // Inclusive range of indexes into _keys.
+    struct key_range {
+        unsigned first;
+        unsigned last;
+    };
+
+    test_env& _env;
+    table_for_tests& _table;
+    const simulation_config& _cfg;
+    simulation_strategy_control _control;
+    std::default_random_engine _rng{std::random_device{}()};
+    // Sorted by token.
+    std::vector<sstring> _keys;
+    std::vector<bool> _written;
+    unsigned _written_keys = 0;
+    std::vector<shared_sstable> _sstables;
+    std::unordered_map<shared_sstable, key_range> _ranges;
+    unsigned long _generation = 0;
+    api::timestamp_type _now;
+    uint64_t _bytes_flushed = 0;
+    uint64_t _bytes_compacted = 0;
+    uint64_t _compactions = 0;
+private:
+    uint64_t key_size() const {
+        return std::max(_cfg.dataset_size / _cfg.keys, uint64_t(1));
+    }
+
+    shared_sstable make_sstable(key_range range, uint64_t size, api::timestamp_type min_ts, api::timestamp_type max_ts, uint32_t level, run_id run) {
+        auto sst = _env.make_sstable(_table.schema(), "", ++_generation);
+        stats_metadata stats = {};
+        stats.min_timestamp = min_ts;
+        stats.max_timestamp = max_ts;
+        stats.max_local_deletion_time = std::numeric_limits<int32_t>::max();
+        stats.sstable_level = level;
+        sstables::test(sst).set_values(_keys[range.first], _keys[range.last], std::move(stats), std::max(size, uint64_t(1)));
+        sstables::test(sst).set_run_identifier(run);
+        _ranges.emplace(sst, range);
+        return sst;
+    }
+
+    void replace(const std::vector<shared_sstable>& old_ssts, const std::vector<shared_sstable>& new_ssts) {
+        std::unordered_set<shared_sstable> old_set(old_ssts.begin(), old_ssts.end());
+        std::erase_if(_sstables, [&] (const shared_sstable& sst) { return old_set.contains(sst); });
+        _sstables.insert(_sstables.end(), new_ssts.begin(), new_ssts.end());
+        _table.as_table_state().get_backlog_tracker().replace_sstables(old_ssts, new_ssts);
+        for (auto& sst : old_ssts) {
+            _ranges.erase(sst);
+        }
+    }
+
+    void flush() {
+        auto width = std::clamp(unsigned(_cfg.keys * _cfg.key_range_ratio), 1u, _cfg.keys);
+        auto first = std::uniform_int_distribution<unsigned>(0, _cfg.keys - width)(_rng);
+        key_range range{first, first + width - 1};
+        for (auto i = range.first; i <= range.last; ++i) {
+            if (!_written[i]) {
+                _written[i] = true;
+                ++_written_keys;
+            }
+        }
+        auto interval = std::chrono::duration_cast<std::chrono::microseconds>(_cfg.flush_interval).count();
+        auto sst = make_sstable(range, _cfg.flush_size, _now, _now + interval - 1, 0, run_id::create_random_id());
+        _now += interval;
+        _bytes_flushed += _cfg.flush_size;
+        replace({}, {sst});
+    }
+
+    // Returns the number of keys in the union of the key ranges of the given sstables.
+    uint64_t covered_keys(const std::vector<shared_sstable>& ssts) const {
+        std::vector<key_range> ranges;
+        for (auto& sst : ssts) {
+            ranges.push_back(_ranges.at(sst));
+        }
+        std::sort(ranges.begin(), ranges.end(), [] (const key_range& a, const key_range& b) { return a.first < b.first; });
+        uint64_t ret = 0;
+        std::optional<key_range> current;
+        for (auto& r : ranges) {
+            if (current && r.first <= current->last + 1) {
+                current->last = std::max(current->last, r.last);
+                continue;
+            }
+            if (current) {
+                ret += current->last - current->first + 1;
+            }
+            current = r;
+        }
+        if (current) {
+            ret += current->last - current->first + 1;
+        }
+        return ret;
+    }
+
+    void compact(const compaction_descriptor& desc) {
+        ++_compactions;
+        if (desc.has_only_fully_expired) {
+            replace(desc.sstables, {});
+            return;
+        }
+        uint64_t input_size = 0;
+        auto min_ts = api::max_timestamp;
+        auto max_ts = api::min_timestamp;
+        key_range hull{_cfg.keys, 0};
+        for (auto& sst : desc.sstables) {
+            input_size += sst->data_size();
+            min_ts = std::min(min_ts, sst->get_stats_metadata().min_timestamp);
+            max_ts = std::max(max_ts, sst->get_stats_metadata().max_timestamp);
+            auto& r = _ranges.at(sst);
+            hull.first = std::min(hull.first, r.first);
+            hull.last = std::max(hull.last, r.last);
+        }
+        auto output_size = std::min(input_size, covered_keys(desc.sstables) * key_size());
+
+        // Output is split by size, into sstables of a single run with disjoint key ranges.
+        auto width = hull.last - hull.first + 1;
+        uint64_t pieces = 1;
+        if (output_size > desc.max_sstable_bytes) {
+            pieces = std::min<uint64_t>((output_size + desc.max_sstable_bytes - 1) / desc.max_sstable_bytes, width);
+        }
+        std::vector<shared_sstable> output;
+        for (uint64_t i = 0; i < pieces; ++i) {
+            key_range r{unsigned(hull.first + width * i / pieces), unsigned(hull.first + width * (i + 1) / pieces - 1)};
+            output.push_back(make_sstable(r, output_size / pieces, min_ts, max_ts, desc.level, desc.run_identifier));
+        }
+        _bytes_compacted += output_size;
+        replace(desc.sstables, output);
+    }
+
+    void compact_until_done() {
+        auto& table_s = _table.as_table_state();
+        // Bounds the jobs run after a flush, in case of a strategy picking the same job forever.
+        for (unsigned i = 0; i < 10000; ++i) {
+            auto desc = table_s.get_compaction_strategy().get_sstables_for_compaction(table_s, _control, _sstables);
+            if (desc.sstables.empty()) {
+                return;
+            }
+            compact(desc);
+            seastar::thread::maybe_yield();
+        }
+    }
+
+    double sstables_per_read() {
+        if (_sstables.empty()) {
+            return 0;
+        }
+        auto dist = std::uniform_int_distribution<unsigned>(0, _cfg.keys - 1);
+        uint64_t total = 0;
+        for (unsigned i = 0; i < _cfg.read_samples; ++i) {
+            auto key = dist(_rng);
+            total += std::count_if(_ranges.begin(), _ranges.end(), [key] (const auto& e) {
+                return e.second.first <= key && key <= e.second.last;
+            });
+        }
+        return double(total) / _cfg.read_samples;
+    }
+
+    void report(unsigned flushes) {
+        uint64_t on_disk = 0;
+        for (auto& sst : _sstables) {
+            on_disk += sst->data_size();
+        }
+        auto live = std::min(_bytes_flushed, _written_keys * key_size());
+        fmt::print("{:>8} {:>9} {:>12} {:>9.2f} {:>9.2f} {:>14.2f} {:>12.2f}\n",
+                flushes, _sstables.size(), _compactions,
+                double(_bytes_flushed + _bytes_compacted) / _bytes_flushed,
+                double(on_disk) / live,
+                sstables_per_read(),
+                _table.as_table_state().get_backlog_tracker().backlog());
+    }
+public:
+    compaction_simulator(test_env& env, table_for_tests& table, const simulation_config& cfg)
+        : _env(env)
+        , _table(table)
+        , _cfg(cfg)
+        , _written(cfg.keys, false)
+    {
+        auto& s = *_table.schema();
+        std::vector<std::pair<dht::token, sstring>> keys;
+        keys.reserve(_cfg.keys);
+        for (unsigned i = 0; i < _cfg.keys; ++i) {
+            auto key = format("key{:010d}", i);
+            auto dk = dht::decorate_key(s, partition_key::from_single_value(s, to_bytes(key)));
+            keys.emplace_back(dk.token(), std::move(key));
+        }
+        std::sort(keys.begin(), keys.end());
+        for (auto& [token, key] : keys) {
+            _keys.push_back(std::move(key));
+        }
+        // Let the last flush be the most recent data, as time-based strategies compare timestamps with the current time.
+        _now = api::new_timestamp() - std::chrono::duration_cast<std::chrono::microseconds>(_cfg.flush_interval).count() * _cfg.flushes;
+    }
+
+    void run() {
+        fmt::print("{:>8} {:>9} {:>12} {:>9} {:>9} {:>14} {:>12}\n",
+                "flushes", "sstables", "compactions", "write_amp", "space_amp", "sstables/read", "backlog");
+        for (unsigned i = 1; i <= _cfg.flushes; ++i) {
+            flush();
+            compact_until_done();
+            if (i % _cfg.report_every == 0 || i == _cfg.flushes) {
+                report(i);
+            }
+        }
+    }
+};
+
+std::map<sstring, sstring> parse_strategy_options(const sstring& str) {
+    std::map<sstring, sstring> ret;
+    if (str.empty()) {
+        return ret;
+    }
+    std::vector<sstring> options;
+    boost::split(options, str, boost::is_any_of(","));
+    for (auto& option : options) {
+        auto pos = option.find('=');
+        if (pos == sstring::npos) {
+            throw std::invalid_argument(format("Invalid compaction strategy option {}, expected key=value", option));
+        }
+        ret.emplace(option.substr(0, pos), option.substr(pos + 1));
+    }
+    return ret;
+}
+
+} // anonymous namespace
+
+namespace perf {
+
+int scylla_compaction_strategy_main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("compaction-strategy", bpo::value<sstring>()->default_value("SizeTieredCompactionStrategy"), "compaction strategy to simulate, one of "
+             "(SizeTieredCompactionStrategy, LeveledCompactionStrategy, TimeWindowCompactionStrategy, IncrementalCompactionStrategy)")
+        ("compaction-options", bpo::value<sstring>()->default_value(""), "comma-separated key=value options of the compaction strategy")
+        ("flushes", bpo::value<unsigned>()->default_value(1000), "number of memtable flushes to simulate")
+        ("flush-size-mb", bpo::value<uint64_t>()->default_value(64), "size of the sstable written by a flush, in MB")
+        ("dataset-size-mb", bpo::value<uint64_t>()->default_value(64 * 1024), "size of the data once all keys are written, in MB")
+        ("keys", bpo::value<unsigned>()->default_value(100000), "number of keys the key space is divided in")
+        ("key-range-ratio", bpo::value<double>()->default_value(1.0), "fraction of the key space written by each flush")
+        ("flush-interval", bpo::value<unsigned>()->default_value(60), "time between flushes, in seconds")
+        ("report-every", bpo::value<unsigned>()->default_value(100), "number of flushes between reports")
+        ("read-samples", bpo::value<unsigned>()->default_value(1000), "number of keys sampled to compute sstables per read");
+
+    return app.run(argc, argv, [&app] {
+        return seastar::async([&app] {
+            auto& opts = app.configuration();
+            simulation_config cfg{
+                .flushes = opts["flushes"].as<unsigned>(),
+                .flush_size = opts["flush-size-mb"].as<uint64_t>() << 20,
+                .dataset_size = opts["dataset-size-mb"].as<uint64_t>() << 20,
+                .keys = std::max(opts["keys"].as<unsigned>(), 1u),
+                .key_range_ratio = opts["key-range-ratio"].as<double>(),
+                .flush_interval = std::chrono::seconds(opts["flush-interval"].as<unsigned>()),
+                .report_every = std::max(opts["report-every"].as<unsigned>(), 1u),
+                .read_samples = std::max(opts["read-samples"].as<unsigned>(), 1u),
+            };
+            auto strategy = compaction_strategy::type(opts["compaction-strategy"].as<sstring>());
+            auto strategy_options = parse_strategy_options(opts["compaction-options"].as<sstring>());
+
+            test_env env;
+            auto stop_env = deferred_stop(env);
+
+            auto builder = schema_builder("ks", "perf_compaction_strategy")
+                    .with_column("pk", utf8_type, column_kind::partition_key)
+                    .with_column("v", utf8_type);
+            builder.set_compaction_strategy(strategy);
+            builder.set_compaction_strategy_options(std::move(strategy_options));
+            table_for_tests table(env.manager(), builder.build());
+            auto stop_table = deferred_stop(table);
+
+            compaction_simulator(env, table, cfg).run();
+        });
+    });
+}
+
+} // namespace perf
@@ -11,6 +11,8 @@
 
 #include "cql3/error_collector.hh"
 #include "cql3/CqlParser.hpp"
+#include "cql3/simple_statement_parser.hh"
+#include "cql3/statements/raw/parsed_statement.hh"
 
 using namespace cql3;
 
@@ -30,4 +32,10 @@ int main(int argc, char* argv[]) {
         parser.set_error_listener(parser_error_collector);
         parser.query();
     });
+
+    std::cout << "Timing simple CQL statement parsing...\n";
+
+    time_it([&] {
+        cql3::try_parse_simple_statement(query);
+    });
 }
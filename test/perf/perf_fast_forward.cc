@@ -890,15 +890,20 @@ static test_result test_reading_all(flat_mutation_reader_v2& rd) {
     return {before, consume_all(rd)};
 }
 
-static test_result slice_rows_by_ck(replica::column_family& cf, clustered_ds& ds, int offset = 0, int n_read = 1) {
+static test_result slice_rows_by_ck(replica::column_family& cf, clustered_ds& ds, int offset = 0, int n_read = 1, bool reversed = false) {
     tests::reader_concurrency_semaphore_wrapper semaphore;
-    auto slice = partition_slice_builder(*cf.schema())
+    auto s = cf.schema();
+    auto slice = partition_slice_builder(*s)
         .with_range(query::clustering_range::make(
-            ds.make_ck(*cf.schema(), offset),
-            ds.make_ck(*cf.schema(), offset + n_read - 1)))
+            ds.make_ck(*s, offset),
+            ds.make_ck(*s, offset + n_read - 1)))
         .build();
-    auto pr = dht::partition_range::make_singular(dht::decorate_key(*cf.schema(), ds.make_pk(*cf.schema())));
-    auto rd = cf.make_reader_v2(cf.schema(), semaphore.make_permit(), pr, slice);
+    auto pr = dht::partition_range::make_singular(dht::decorate_key(*s, ds.make_pk(*s)));
+    if (reversed) {
+        slice = query::reverse_slice(*s, std::move(slice));
+        s = s->make_reversed();
+    }
+    auto rd = cf.make_reader_v2(s, semaphore.make_permit(), pr, slice);
     auto close_rd = deferred_close(rd);
 
     return test_reading_all(rd);
@@ -1570,6 +1575,29 @@ void test_large_partition_slicing_clustering_keys(replica::column_family& cf, cl
     test(n_rows / 2, 4096);
 }
 
+void test_large_partition_slicing_reversed(replica::column_family& cf, clustered_ds& ds) {
+    auto n_rows = ds.n_rows(cfg);
+
+    output_mgr->set_test_param_names({{"order", "{:<7}"}, {"offset", "{:<7}"}, {"read", "{:<7}"}}, test_result::stats_names());
+    auto test = [&] (int offset, int read) {
+        for (bool reversed : {false, true}) {
+            run_test_case([&] {
+                auto r = slice_rows_by_ck(cf, ds, offset, read, reversed);
+                r.set_params(to_sstrings(reversed ? "desc" : "asc", offset, read));
+                check_fragment_count(r, std::min(n_rows - offset, read));
+                return r;
+            });
+        }
+    };
+
+    test(0, 256);
+    test(0, 4096);
+    test(0, n_rows);
+
+    test(n_rows / 2, 256);
+    test(n_rows / 2, 4096);
+}
+
 void test_large_partition_slicing_single_partition_reader(replica::column_family& cf, clustered_ds& ds) {
     auto n_rows = ds.n_rows(cfg);
 
@@ -1827,6 +1855,13 @@ static std::initializer_list<test_group> test_groups = {
         test_group::type::large_partition,
         make_test_fn(test_large_partition_slicing_clustering_keys),
     },
+    {
+        "large-partition-slicing-reversed",
+        "Testing slicing of large partition using clustering keys, in both directions",
+        test_group::requires_cache::no,
+        test_group::type::large_partition,
+        make_test_fn(test_large_partition_slicing_reversed),
+    },
     {
         "large-partition-slicing-single-key-reader",
         "Testing slicing of large partition, single-partition reader",
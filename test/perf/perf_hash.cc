@@ -7,6 +7,7 @@
  */
 
 #include "utils/murmur_hash.hh"
+#include "xx_hasher.hh"
 #include "test/perf/perf.hh"
 
 volatile uint64_t black_hole;
@@ -35,5 +36,55 @@ int main(int argc, char* argv[]) {
         sink += dst[1];
     });
 
+    // Bulk paths compute the tokens of many partition keys, typically of a
+    // few dozen bytes each.
+    std::vector<bytes> keys(1000);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = bytes(bytes::initialized_later(), 8 + i % 32);
+        std::fill(keys[i].begin(), keys[i].end(), int8_t(i));
+    }
+    std::vector<bytes_view> key_views(keys.begin(), keys.end());
+    std::vector<std::array<uint64_t, 2>> key_hashes(keys.size());
+
+    std::cout << "Timing hash of 1000 keys one by one...\n";
+
+    time_it([&] {
+        for (size_t i = 0; i < key_views.size(); ++i) {
+            utils::murmur_hash::hash3_x64_128(key_views[i], seed, key_hashes[i]);
+        }
+        sink += key_hashes.back()[0];
+    }, 5, 10);
+
+    std::cout << "Timing batched hash of 1000 keys...\n";
+
+    time_it([&] {
+        utils::murmur_hash::hash3_x64_128(key_views, seed, key_hashes);
+        sink += key_hashes.back()[0];
+    }, 5, 10);
+
+    // Digests of wide partitions are fed many small values, e.g. the hash of
+    // every cell; compare hashing those one update at a time.
+    std::vector<uint64_t> cell_hashes(1000);
+    for (size_t i = 0; i < cell_hashes.size(); ++i) {
+        cell_hashes[i] = i * 0x9e3779b97f4a7c15ull;
+    }
+
+    auto time_digest = [&] (auto hasher) {
+        time_it([&] {
+            auto h = hasher;
+            for (auto& v : cell_hashes) {
+                h.update(reinterpret_cast<const char*>(&v), sizeof(v));
+            }
+            auto digest = h.finalize_array();
+            sink += digest[0];
+        }, 5, 10);
+    };
+
+    std::cout << "Timing xxHash64 digest of 1000 cells...\n";
+    time_digest(xx_hasher());
+
+    std::cout << "Timing coalesced xxh3 digest of 1000 cells...\n";
+    time_digest(xxh3_hasher());
+
     black_hole = sink;
 }
@@ -22,19 +22,33 @@ class frozen_mutation {
 
     mutation _one_small_row;
     ::frozen_mutation _frozen_one_small_row;
+
+    mutation _many_small_rows;
+    ::frozen_mutation _frozen_many_small_rows;
 public:
+    static constexpr size_t many_rows = 100;
+
     frozen_mutation()
         : _semaphore(__FILE__)
         , _one_small_row(_schema.schema(), _schema.make_pkey(0))
         , _frozen_one_small_row(_one_small_row)
+        , _many_small_rows(_schema.schema(), _schema.make_pkey(0))
+        , _frozen_many_small_rows(_many_small_rows)
     {
         _one_small_row.apply(_schema.make_row(_semaphore.make_permit(), _schema.make_ckey(0), "value"));
         _frozen_one_small_row = freeze(_one_small_row);
+
+        for (uint32_t i = 0; i < many_rows; ++i) {
+            _many_small_rows.apply(_schema.make_row(_semaphore.make_permit(), _schema.make_ckey(i), "value"));
+        }
+        _frozen_many_small_rows = freeze(_many_small_rows);
     }
     schema_ptr schema() const { return _schema.schema(); }
 
     const mutation& one_small_row() const { return _one_small_row; }
     const ::frozen_mutation& frozen_one_small_row() const { return _frozen_one_small_row; }
+
+    const ::frozen_mutation& frozen_many_small_rows() const { return _frozen_many_small_rows; }
 };
 
 PERF_TEST_F(frozen_mutation, freeze_one_small_row)
@@ -49,6 +63,15 @@ PERF_TEST_F(frozen_mutation, unfreeze_one_small_row)
     perf_tests::do_not_optimize(m);
 }
 
+// Deserializing the rows of a partition skips over their fixed size
+// members, such as the timestamps of the cells.
+PERF_TEST_F(frozen_mutation, unfreeze_many_small_rows)
+{
+    auto m = frozen_many_small_rows().unfreeze(schema());
+    perf_tests::do_not_optimize(m);
+    return many_rows;
+}
+
 PERF_TEST_F(frozen_mutation, apply_one_small_row)
 {
     auto m = mutation(schema(), frozen_one_small_row().key());
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/testing/test_runner.hh>
+
+#include <random>
+
+#include "utils/like_matcher.hh"
+
+class like {
+public:
+    static constexpr size_t count = 1000;
+    static constexpr size_t text_size = 256;
+private:
+    std::vector<bytes> _texts;
+public:
+    like() {
+        auto eng = seastar::testing::local_random_engine;
+        auto dist = std::uniform_int_distribution<int>('a', 'z');
+        for (size_t i = 0; i < count; ++i) {
+            bytes text(bytes::initialized_later{}, text_size);
+            std::generate(text.begin(), text.end(), [&] { return dist(eng); });
+            _texts.push_back(std::move(text));
+        }
+    }
+
+    size_t match(const char* pattern) const {
+        like_matcher m(bytes(pattern));
+        for (auto& text : _texts) {
+            perf_tests::do_not_optimize(m(text));
+        }
+        return count;
+    }
+};
+
+// Patterns without '_' and with '%' only around a literal are matched without a regex;
+// their counterparts with a '_' show the cost of matching with the regex.
+
+PERF_TEST_F(like, prefix) {
+    return match("foo%");
+}
+
+PERF_TEST_F(like, prefix_regex) {
+    return match("f_o%");
+}
+
+PERF_TEST_F(like, suffix) {
+    return match("%foo");
+}
+
+PERF_TEST_F(like, suffix_regex) {
+    return match("%f_o");
+}
+
+PERF_TEST_F(like, contains) {
+    return match("%foo%");
+}
+
+PERF_TEST_F(like, contains_regex) {
+    return match("%f_o%");
+}
@@ -11,6 +11,8 @@
 #include <json/json.h>
 
 #include <boost/range/irange.hpp>
+#include <cmath>
+#include <numeric>
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/alternator_test_env.hh"
 #include "test/perf/perf.hh"
@@ -59,8 +61,12 @@ static void execute_counter_update_for_key(cql_test_env& env, const bytes& key)
 };
 
 struct test_config {
-    enum class run_mode { read, write, del };
+    enum class run_mode { read, write, del, mixed };
     enum class frontend_type { cql, alternator };
+    enum class key_distribution { uniform, zipf };
+    // The kinds of operations of the mixed workload.
+    enum class operation { read, write, scan, lwt };
+    static constexpr size_t operation_count = 4;
 
     run_mode mode;
     frontend_type frontend;
@@ -74,6 +80,13 @@ struct test_config {
     bool stop_on_error;
     sstring timeout;
     bool bypass_cache;
+    key_distribution distribution = key_distribution::uniform;
+    double zipf_exponent = 1.0;
+    // The cumulative probability of each key, for the zipf distribution.
+    std::vector<double> zipf_cdf;
+    // The relative weights of the operations of the mixed workload.
+    std::array<unsigned, operation_count> mix = {50, 40, 5, 5};
+    bool with_view = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
@@ -81,6 +94,25 @@ std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
         case test_config::run_mode::write: return os << "write";
         case test_config::run_mode::read: return os << "read";
         case test_config::run_mode::del: return os << "delete";
+        case test_config::run_mode::mixed: return os << "mixed";
+    }
+    abort();
+}
+
+std::ostream& operator<<(std::ostream& os, const test_config::key_distribution& d) {
+    switch (d) {
+        case test_config::key_distribution::uniform: return os << "uniform";
+        case test_config::key_distribution::zipf: return os << "zipf";
+    }
+    abort();
+}
+
+std::ostream& operator<<(std::ostream& os, const test_config::operation& op) {
+    switch (op) {
+        case test_config::operation::read: return os << "read";
+        case test_config::operation::write: return os << "write";
+        case test_config::operation::scan: return os << "scan";
+        case test_config::operation::lwt: return os << "lwt";
     }
     abort();
 }
@@ -100,6 +132,7 @@ std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
            << ", frontend=" << cfg.frontend
            << ", query_single_key=" << (cfg.query_single_key ? "yes" : "no")
            << ", counters=" << (cfg.counters ? "yes" : "no")
+           << ", key_distribution=" << cfg.distribution
            << "}";
 }
 
@@ -119,8 +152,34 @@ static void create_partitions(cql_test_env& env, test_config& cfg) {
     }
 }
 
+static std::vector<double> make_zipf_cdf(unsigned partitions, double exponent) {
+    std::vector<double> cdf;
+    cdf.reserve(partitions);
+    double sum = 0;
+    for (unsigned rank = 1; rank <= partitions; ++rank) {
+        sum += 1 / std::pow(rank, exponent);
+        cdf.push_back(sum);
+    }
+    for (auto& p : cdf) {
+        p /= sum;
+    }
+    return cdf;
+}
+
 static int64_t make_random_seq(test_config& cfg) {
-    return cfg.query_single_key ? 0 : tests::random::get_int<uint64_t>(cfg.partitions - 1);
+    if (cfg.query_single_key) {
+        return 0;
+    }
+    switch (cfg.distribution) {
+    case test_config::key_distribution::uniform:
+        return tests::random::get_int<uint64_t>(cfg.partitions - 1);
+    case test_config::key_distribution::zipf: {
+        // The keys with the lowest sequence numbers are the hottest ones.
+        auto it = std::lower_bound(cfg.zipf_cdf.begin(), cfg.zipf_cdf.end(), tests::random::get_real<double>(0, 1));
+        return std::min<int64_t>(it - cfg.zipf_cdf.begin(), cfg.partitions - 1);
+    }
+    }
+    abort();
 }
 
 static bytes make_random_key(test_config& cfg) {
@@ -195,6 +254,64 @@ static std::vector<perf_result> test_counter_update(cql_test_env& env, test_conf
         }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
 }
 
+// The latencies of each kind of operation of the mixed workload, in
+// microseconds, indexed by test_config::operation.
+using operation_latencies = std::array<utils::estimated_histogram, test_config::operation_count>;
+
+static operation_latencies merge_latencies(const std::vector<operation_latencies>& shard_latencies) {
+    operation_latencies ret;
+    for (const auto& latencies : shard_latencies) {
+        for (size_t op = 0; op < test_config::operation_count; ++op) {
+            ret[op].merge(latencies[op]);
+        }
+    }
+    return ret;
+}
+
+// Runs reads, writes, token range scans and LWT updates at once, in the
+// proportions given by cfg.mix, and records the latencies of each kind of
+// operation in shard_latencies, one element per shard.
+static std::vector<perf_result> test_mixed(cql_test_env& env, test_config& cfg, std::vector<operation_latencies>& shard_latencies) {
+    if (cfg.with_view) {
+        env.execute_cql("CREATE MATERIALIZED VIEW cf_by_c0 AS SELECT * FROM cf "
+                "WHERE \"KEY\" IS NOT NULL AND \"C0\" IS NOT NULL PRIMARY KEY (\"KEY\", \"C0\")").get();
+    }
+    create_partitions(env, cfg);
+    sstring usings;
+    if (!cfg.timeout.empty()) {
+        usings += "USING TIMEOUT " + cfg.timeout + " ";
+    }
+    std::array<cql3::prepared_cache_key_type, test_config::operation_count> ids = {
+        env.prepare(format("SELECT \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" FROM cf WHERE \"KEY\" = ? {}", usings)).get0(),
+        env.prepare(format("UPDATE cf {}SET "
+                "\"C0\" = 0x8f75da6b3dcec90c8a404fb9a5f6b0621e62d39c69ba5758e5f41b78311fbb26cc7a,"
+                "\"C1\" = 0xa8761a2127160003033a8f4f3d1069b7833ebe24ef56b3beee728c2b686ca516fa51,"
+                "\"C2\" = 0x583449ce81bfebc2e1a695eb59aad5fcc74d6d7311fc6197b10693e1a161ca2e1c64,"
+                "\"C3\" = 0x62bcb1dbc0ff953abc703bcb63ea954f437064c0c45366799658bd6b91d0f92908d7,"
+                "\"C4\" = 0x222fcbe31ffa1e689540e1499b87fa3f9c781065fccd10e4772b4c7039c2efd0fb27 "
+                "WHERE \"KEY\" = ?", usings)).get0(),
+        env.prepare(format("SELECT \"KEY\" FROM cf WHERE token(\"KEY\") >= ? LIMIT 100 {}", usings)).get0(),
+        env.prepare("UPDATE cf SET \"C0\" = 0x00 WHERE \"KEY\" = ? IF EXISTS").get0(),
+    };
+    const auto total_weight = std::accumulate(cfg.mix.begin(), cfg.mix.end(), 0u);
+    shard_latencies.resize(smp::count);
+    return time_parallel([&env, &cfg, &shard_latencies, ids, total_weight] {
+            auto weight = tests::random::get_int<unsigned>(total_weight - 1);
+            size_t op = 0;
+            while (weight >= cfg.mix[op]) {
+                weight -= cfg.mix[op++];
+            }
+            auto value = op == size_t(test_config::operation::scan)
+                    ? cql3::raw_value::make_value(long_type->decompose(tests::random::get_int<int64_t>()))
+                    : cql3::raw_value::make_value(make_random_key(cfg));
+            auto start = std::chrono::steady_clock::now();
+            return env.execute_prepared(ids[op], {{std::move(value)}}).discard_result().finally([&shard_latencies, op, start] {
+                auto latency = std::chrono::steady_clock::now() - start;
+                shard_latencies[this_shard_id()][op].add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+            });
+        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+}
+
 static schema_ptr make_counter_schema(std::string_view ks_name) {
     return schema_builder(ks_name, "cf")
             .with_column("KEY", bytes_type, column_kind::partition_key)
@@ -400,6 +517,8 @@ static std::vector<perf_result> do_alternator_test(std::string isolation_level,
             return test_alternator_write(state, executor, cfg);
         case test_config::run_mode::del:
             return test_alternator_delete(state, std::move(flush_memtables), executor, cfg);
+        case test_config::run_mode::mixed:
+            throw std::invalid_argument("the mixed workload is not supported with alternator");
         };
     } catch (const alternator::api_error& e) {
         std::cout << "Alternator API error: " << e._msg << std::endl;
@@ -408,7 +527,7 @@ static std::vector<perf_result> do_alternator_test(std::string isolation_level,
     abort();
 }
 
-static std::vector<perf_result> do_cql_test(cql_test_env& env, test_config& cfg) {
+static std::vector<perf_result> do_cql_test(cql_test_env& env, test_config& cfg, std::vector<operation_latencies>& shard_latencies) {
     assert(cfg.frontend == test_config::frontend_type::cql);
 
     std::cout << "Running test with config: " << cfg << std::endl;
@@ -437,11 +556,14 @@ static std::vector<perf_result> do_cql_test(cql_test_env& env, test_config& cfg)
         }
     case test_config::run_mode::del:
         return test_delete(env, cfg);
+    case test_config::run_mode::mixed:
+        return test_mixed(env, cfg, shard_latencies);
     };
     abort();
 }
 
-void write_json_result(std::string result_file, const test_config& cfg, perf_result median, double mad, double max, double min) {
+void write_json_result(std::string result_file, const test_config& cfg, perf_result median, double mad, double max, double min,
+        const operation_latencies* latencies) {
     Json::Value results;
 
     Json::Value params;
@@ -460,6 +582,19 @@ void write_json_result(std::string result_file, const test_config& cfg, perf_res
     stats["mad tps"] = mad;
     stats["max tps"] = max;
     stats["min tps"] = min;
+    if (latencies) {
+        for (size_t op = 0; op < test_config::operation_count; ++op) {
+            const auto& hist = (*latencies)[op];
+            Json::Value op_stats;
+            op_stats["count"] = Json::Int64(hist.count());
+            op_stats["mean"] = Json::Int64(hist.mean());
+            op_stats["p50"] = Json::Int64(hist.percentile(0.5));
+            op_stats["p95"] = Json::Int64(hist.percentile(0.95));
+            op_stats["p99"] = Json::Int64(hist.percentile(0.99));
+            op_stats["max"] = Json::Int64(hist.max());
+            stats["latency_us"][fmt::format("{}", test_config::operation(op))] = std::move(op_stats);
+        }
+    }
     results["stats"] = std::move(stats);
 
     std::string test_type;
@@ -467,10 +602,14 @@ void write_json_result(std::string result_file, const test_config& cfg, perf_res
     case test_config::run_mode::read: test_type = "read"; break;
     case test_config::run_mode::write: test_type = "write"; break;
     case test_config::run_mode::del: test_type = "delete"; break;
+    case test_config::run_mode::mixed: test_type = "mixed"; break;
     }
     if (cfg.counters) {
         test_type += "_counters";
     }
+    if (cfg.distribution == test_config::key_distribution::zipf) {
+        test_type += "_zipf";
+    }
     results["test_properties"]["type"] = test_type;
 
     // <version>-<release>
@@ -509,6 +648,11 @@ int scylla_simple_query_main(int argc, char** argv) {
         ("partitions", bpo::value<unsigned>()->default_value(10000), "number of partitions")
         ("write", "test write path instead of read path")
         ("delete", "test delete path instead of read path")
+        ("mixed", "test a mix of reads, writes, token range scans and LWT updates instead of read path")
+        ("mix", bpo::value<std::string>()->default_value("read=50,write=40,scan=5,lwt=5"), "relative weights of the operations of the mixed test")
+        ("with-view", "create a materialized view on the table of the mixed test, so that writes generate view updates")
+        ("key-distribution", bpo::value<std::string>()->default_value("uniform"), "distribution of the accessed keys, one of (uniform, zipf)")
+        ("zipf-exponent", bpo::value<double>()->default_value(1.0), "exponent of the zipf key distribution")
         ("duration", bpo::value<unsigned>()->default_value(5), "test duration in seconds")
         ("query-single-key", "test reading with a single key instead of random keys")
         ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
@@ -553,6 +697,8 @@ int scylla_simple_query_main(int argc, char** argv) {
                 cfg.mode = test_config::run_mode::write;
             } else if (app.configuration().contains("delete")) {
                 cfg.mode = test_config::run_mode::del;
+            } else if (app.configuration().contains("mixed")) {
+                cfg.mode = test_config::run_mode::mixed;
             } else {
                 cfg.mode = test_config::run_mode::read;
             };
@@ -567,8 +713,42 @@ int scylla_simple_query_main(int argc, char** argv) {
             cfg.stop_on_error = app.configuration()["stop-on-error"].as<bool>();
             cfg.timeout = app.configuration()["timeout"].as<std::string>();
             cfg.bypass_cache = app.configuration().contains("bypass-cache");
+            const auto distribution = app.configuration()["key-distribution"].as<std::string>();
+            if (distribution == "zipf") {
+                cfg.distribution = test_config::key_distribution::zipf;
+                cfg.zipf_exponent = app.configuration()["zipf-exponent"].as<double>();
+                cfg.zipf_cdf = make_zipf_cdf(cfg.partitions, cfg.zipf_exponent);
+            } else if (distribution != "uniform") {
+                throw std::invalid_argument(format("invalid key distribution: {}", distribution));
+            }
+            if (cfg.mode == test_config::run_mode::mixed) {
+                if (cfg.counters) {
+                    throw std::invalid_argument("the mixed test does not support counters");
+                }
+                cfg.mix = {};
+                std::vector<std::string> weights;
+                auto mix = app.configuration()["mix"].as<std::string>();
+                boost::algorithm::split(weights, mix, boost::is_any_of(","));
+                for (const auto& w : weights) {
+                    auto pos = w.find('=');
+                    auto name = w.substr(0, pos);
+                    size_t op = 0;
+                    while (op < test_config::operation_count && fmt::format("{}", test_config::operation(op)) != name) {
+                        ++op;
+                    }
+                    if (pos == std::string::npos || op == test_config::operation_count) {
+                        throw std::invalid_argument(format("invalid operation weight: {}", w));
+                    }
+                    cfg.mix[op] = std::stoul(w.substr(pos + 1));
+                }
+                if (std::accumulate(cfg.mix.begin(), cfg.mix.end(), 0u) == 0) {
+                    throw std::invalid_argument("the weights of the mixed test operations are all zero");
+                }
+                cfg.with_view = app.configuration().contains("with-view");
+            }
+            std::vector<operation_latencies> shard_latencies;
             auto results = cfg.frontend == test_config::frontend_type::cql
-                    ? do_cql_test(env, cfg)
+                    ? do_cql_test(env, cfg, shard_latencies)
                     : do_alternator_test(app.configuration()["alternator"].as<std::string>(),
                             env.local_client_state(), env.qp(), env.migration_manager(), env.gossiper(), cfg);
 
@@ -586,8 +766,20 @@ int scylla_simple_query_main(int argc, char** argv) {
             auto mad = absolute_deviations[results.size() / 2];
             std::cout << format("\nmedian {}\nmedian absolute deviation: {:.2f}\nmaximum: {:.2f}\nminimum: {:.2f}\n", median_result, mad, max, min);
 
+            std::optional<operation_latencies> latencies;
+            if (!shard_latencies.empty()) {
+                latencies = merge_latencies(shard_latencies);
+                std::cout << "\nlatencies [us]:\n";
+                for (size_t op = 0; op < test_config::operation_count; ++op) {
+                    const auto& hist = (*latencies)[op];
+                    std::cout << format("{:>6}: {:10} ops, mean: {:8}, p50: {:8}, p95: {:8}, p99: {:8}, max: {:8}\n", test_config::operation(op),
+                            hist.count(), hist.mean(), hist.percentile(0.5), hist.percentile(0.95), hist.percentile(0.99), hist.max());
+                }
+            }
+
             if (app.configuration().contains("json-result")) {
-                write_json_result(app.configuration()["json-result"].as<std::string>(), cfg, median_result, mad, max, min);
+                write_json_result(app.configuration()["json-result"].as<std::string>(), cfg, median_result, mad, max, min,
+                        latencies ? &*latencies : nullptr);
             }
           }, std::move(cfg));
         });
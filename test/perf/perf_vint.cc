@@ -20,13 +20,17 @@ class vint {
     std::vector<uint64_t> _integers;
     bytes _serialized;
 public:
-    vint()
+    vint() : vint([] (auto& eng) {
+        return std::uniform_int_distribution<uint64_t>{}(eng);
+    }) {}
+
+    template <typename Generator>
+    explicit vint(Generator gen)
         : _integers(count)
         , _serialized(bytes::initialized_later{}, count * max_vint_length)
     {
         auto eng = seastar::testing::local_random_engine;
-        auto dist = std::uniform_int_distribution<uint64_t>{};
-        std::generate_n(_integers.begin(), count, [&] { return dist(eng); });
+        std::generate_n(_integers.begin(), count, [&] { return gen(eng); });
 
         auto dst = _serialized.data();
         for (auto v : _integers) {
@@ -58,3 +62,24 @@ PERF_TEST_F(vint, deserialize) {
     }
     return count;
 }
+
+// Uniformly distributed integers are almost all serialized on 9 bytes.
+// Lengths and deltas, which make most of the vints in sstables, are small,
+// and are serialized on all lengths.
+class small_vint : public vint {
+public:
+    small_vint() : vint([] (auto& eng) {
+        auto bits = std::uniform_int_distribution<unsigned>{0, 32}(eng);
+        return std::uniform_int_distribution<uint64_t>{0, (uint64_t(1) << bits) - 1}(eng);
+    }) {}
+};
+
+PERF_TEST_F(small_vint, deserialize) {
+    auto src = serialized();
+    for (auto i = 0u; i < count; i++) {
+        auto len = unsigned_vint::serialized_size_from_first_byte(src.front());
+        perf_tests::do_not_optimize(unsigned_vint::deserialize(src));
+        src.remove_prefix(len);
+    }
+    return count;
+}
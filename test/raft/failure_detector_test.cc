@@ -270,3 +270,58 @@ SEASTAR_TEST_CASE(failure_detector_test) {
 
     co_await fd.stop();
 }
+
+SEASTAR_TEST_CASE(failure_detector_suspect_test) {
+    test_pinger pinger;
+    test_clock clock;
+    sharded<direct_failure_detector::failure_detector> fd;
+    co_await fd.start(std::ref(pinger), std::ref(clock), 40);
+
+    test_listener l;
+    auto sub = co_await fd.local().register_listener(l, 400);
+
+    direct_failure_detector::pinger::endpoint_id ep{0, 1};
+    pinger._responding.insert(ep);
+    fd.local().add_endpoint(ep);
+
+    auto tick = [&clock] (size_t n) -> future<> {
+        for (size_t i = 0; i < n; ++i) {
+            co_await clock.tick();
+        }
+    };
+
+    auto pings_during = [&] (size_t ticks) -> future<size_t> {
+        auto p = pinger._pings[ep];
+        co_await tick(ticks);
+        co_return pinger._pings[ep] - p;
+    };
+
+    co_await tick(40);
+    co_await l.wait_for(ep, true);
+
+    // An endpoint is pinged every ping_period.
+    BOOST_REQUIRE_LE(co_await pings_during(80), 3);
+
+    // A suspected endpoint is pinged right away, without waiting for the clock...
+    {
+        auto p = pinger._pings[ep];
+        fd.local().suspect(ep);
+        while (pinger._pings[ep] == p) {
+            co_await ping_shards();
+        }
+    }
+
+    // ...and then more often, for a while.
+    BOOST_REQUIRE_GE(co_await pings_during(80), 4);
+
+    co_await tick(1000);
+    BOOST_REQUIRE_LE(co_await pings_during(80), 3);
+
+    // Suspecting an endpoint which isn't detected does nothing.
+    fd.local().suspect(direct_failure_detector::pinger::endpoint_id{0, 2});
+
+    std::optional<direct_failure_detector::subscription> sub_opt{std::move(sub)};
+    sub_opt.reset();
+
+    co_await fd.stop();
+}
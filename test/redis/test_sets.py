@@ -0,0 +1,49 @@
+#
+# Copyright (C) 2023-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+import pytest
+import redis
+import logging
+from util import random_string, connect
+
+logger = logging.getLogger('redis-test')
+
+def test_sadd_smembers_srem(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    members = {random_string(10) for _ in range(3)}
+
+    assert r.smembers(key) == set()
+    assert r.sadd(key, *members) == 3
+    assert r.smembers(key) == members
+
+    # Adding a member twice keeps a single copy of it
+    member = next(iter(members))
+    r.sadd(key, member)
+    assert r.smembers(key) == members
+
+    assert r.srem(key, member) == 1
+    assert r.smembers(key) == members - {member}
+
+    assert r.delete(key) == 1
+    assert r.smembers(key) == set()
+
+def test_sismember(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    member = random_string(10)
+
+    assert r.sismember(key, member) == 0
+    r.sadd(key, member)
+    assert r.sismember(key, member) == 1
+    assert r.sismember(key, random_string(10)) == 0
+
+def test_sets_wrong_number_of_arguments(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    for cmd in ["SADD testkey", "SREM testkey", "SMEMBERS"]:
+        with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+            r.execute_command(cmd)
+        assert "wrong number of arguments" in str(excinfo.value)
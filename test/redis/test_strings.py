@@ -147,6 +147,23 @@ def test_exists_lots_of_keys(redis_host, redis_port):
         keys.append(k)
     assert r.exists(*keys) == len(keys)
 
+def test_mset_mget(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    values = {random_string(10): random_string(10) for i in range(0, 30)}
+    missing = random_string(12)
+    r.delete(missing)
+
+    assert r.mset(values) == True
+    keys = list(values.keys())
+    assert r.mget(keys[:10] + [missing] + keys[10:]) == [values[k] for k in keys[:10]] + [None] + [values[k] for k in keys[10:]]
+    for k, v in values.items():
+        assert r.get(k) == v
+
+def test_mset_wrong_number_of_arguments(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    with pytest.raises(redis.exceptions.ResponseError):
+        r.execute_command('MSET', random_string(10))
+
 def test_setex_ttl(redis_host, redis_port):
     r = connect(redis_host, redis_port)
     key = random_string(10)
@@ -470,3 +470,29 @@ def test_storage_service_keyspace_upgrade_sstables(cql, this_dc, rest_api):
                 # non-existing table
                 resp = rest_api.send("GET", f"storage_service/keyspace_upgrade_sstables/{keyspace}", { "cf": f"{test_tables[0]},XXX" })
                 assert resp.status_code == requests.codes.bad_request
+
+def test_storage_service_keyspace_garbage_collection(cql, this_dc, rest_api):
+    with new_test_keyspace(cql, f"WITH REPLICATION = {{ 'class' : 'NetworkTopologyStrategy', '{this_dc}' : 1 }}") as keyspace:
+        schema = 'p int, v text, primary key (p)'
+        with new_test_table(cql, keyspace, schema, "WITH gc_grace_seconds = 0") as t0:
+            cql.execute(f"INSERT INTO {t0} (p, v) VALUES (0, 'hello')")
+            cql.execute(f"INSERT INTO {t0} (p, v) VALUES (1, 'world')")
+            cql.execute(f"DELETE FROM {t0} WHERE p = 0")
+
+            with new_test_table(cql, keyspace, schema) as t1:
+                test_tables = [t0.split('.')[1], t1.split('.')[1]]
+
+                resp = rest_api.send("POST", f"storage_service/keyspace_flush/{keyspace}")
+                resp.raise_for_status()
+
+                resp = rest_api.send("POST", f"storage_service/keyspace_garbage_collection/{keyspace}")
+                resp.raise_for_status()
+
+                resp = rest_api.send("POST", f"storage_service/keyspace_garbage_collection/{keyspace}", { "cf": f"{test_tables[0]}" })
+                resp.raise_for_status()
+
+                assert list(cql.execute(f"SELECT p, v FROM {t0}")) == [(1, 'world')]
+
+                # non-existing table
+                resp = rest_api.send("POST", f"storage_service/keyspace_garbage_collection/{keyspace}", { "cf": f"{test_tables[0]},XXX" })
+                assert resp.status_code == requests.codes.bad_request
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <algorithm>
 #include <chrono>
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_map.hpp>
@@ -53,6 +54,48 @@ void tombstone_gc_state::drop_repair_history_map_for_table(const table_id& id) {
     _repair_history_maps->erase(id);
 }
 
+repair_history_index::repair_history_index(const repair_history_map& m) {
+    _entries.reserve(boost::icl::interval_count(m.map));
+    for (auto& [interval, repair_time] : m.map) {
+        _entries.push_back(entry{locator::token_metadata::interval_to_range(interval), repair_time});
+    }
+}
+
+const repair_history_index::entry* repair_history_index::find(const dht::token& t, size_t& pos) const {
+    dht::token_comparator cmp;
+    if (pos > _entries.size() || (pos > 0 && !_entries[pos - 1].range.after(t, cmp))) {
+        pos = std::partition_point(_entries.begin(), _entries.end(), [&] (const entry& e) {
+            return e.range.after(t, cmp);
+        }) - _entries.begin();
+    }
+    while (pos < _entries.size() && _entries[pos].range.after(t, cmp)) {
+        ++pos;
+    }
+    if (pos < _entries.size() && _entries[pos].range.contains(t, cmp)) {
+        return &_entries[pos];
+    }
+    return nullptr;
+}
+
+repair_history_index_ptr tombstone_gc_state::get_repair_history_index_for_table(const table_id& id) const {
+    auto m = get_repair_history_map_for_table(id);
+    if (!m) {
+        return {};
+    }
+    if (!m->index) {
+        m->index = seastar::make_lw_shared<repair_history_index>(*m);
+    }
+    return m->index;
+}
+
+tombstone_gc_state::table_snapshot tombstone_gc_state::snapshot_for_table(schema_ptr s) const {
+    repair_history_index_ptr history;
+    if (s->tombstone_gc_options().mode() == tombstone_gc_mode::repair) {
+        history = get_repair_history_index_for_table(s->id());
+    }
+    return table_snapshot(std::move(s), std::move(history));
+}
+
 // This is useful for a sstable to query a gc_before for a range. The range is
 // defined by the first and last key in the sstable.
 //
@@ -136,29 +179,34 @@ gc_clock::time_point tombstone_gc_state::get_gc_before_for_key(schema_ptr s, con
         dblog.trace("Get gc_before for ks={}, table={}, dk={}, mode=immediate", s->ks_name(), s->cf_name(), dk);
         return gc_clock::time_point::max();
     case tombstone_gc_mode::repair:
-        const std::chrono::seconds& propagation_delay = options.propagation_delay_in_seconds();
-        auto gc_before = gc_clock::time_point::min();
-        auto repair_timestamp = gc_clock::time_point::min();
-        auto m = get_repair_history_map_for_table(s->id());
-        if (m) {
-            const auto it = m->map.find(dk.token());
-            if (it == m->map.end()) {
-                gc_before = gc_clock::time_point::min();
-            } else {
-                repair_timestamp = it->second;
-                gc_before = saturating_subtract(repair_timestamp, propagation_delay);
-            }
-        }
-        dblog.trace("Get gc_before for ks={}, table={}, dk={}, mode=repair, repair_timestamp={}, propagation_delay={}, gc_before={}",
-                s->ks_name(), s->cf_name(), dk, repair_timestamp, propagation_delay.count(), gc_before);
-        return gc_before;
+        return snapshot_for_table(std::move(s)).get_gc_before_for_key(dk, query_time);
     }
     std::abort();
 }
 
+gc_clock::time_point tombstone_gc_state::table_snapshot::get_gc_before_for_key(const dht::decorated_key& dk, const gc_clock::time_point& query_time) {
+    const auto& options = _schema->tombstone_gc_options();
+    if (options.mode() != tombstone_gc_mode::repair) {
+        return tombstone_gc_state(nullptr).get_gc_before_for_key(_schema, dk, query_time);
+    }
+    const std::chrono::seconds& propagation_delay = options.propagation_delay_in_seconds();
+    auto gc_before = gc_clock::time_point::min();
+    auto repair_timestamp = gc_clock::time_point::min();
+    if (_history) {
+        if (auto e = _history->find(dk.token(), _pos)) {
+            repair_timestamp = e->repair_time;
+            gc_before = saturating_subtract(repair_timestamp, propagation_delay);
+        }
+    }
+    dblog.trace("Get gc_before for ks={}, table={}, dk={}, mode=repair, repair_timestamp={}, propagation_delay={}, gc_before={}",
+            _schema->ks_name(), _schema->cf_name(), dk, repair_timestamp, propagation_delay.count(), gc_before);
+    return gc_before;
+}
+
 void tombstone_gc_state::update_repair_time(table_id id, const dht::token_range& range, gc_clock::time_point repair_time) {
     auto m = get_or_create_repair_history_map_for_table(id);
     m->map += std::make_pair(locator::token_metadata::range_to_interval(range), repair_time);
+    m->index = {};
 }
 
 static bool needs_repair_before_gc(const replica::database& db, sstring ks_name) {
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <vector>
 #include <seastar/core/shared_ptr.hh>
 #include "gc_clock.hh"
 #include "dht/token.hh"
@@ -32,11 +33,55 @@ class database;
 class repair_history_map;
 using per_table_history_maps = std::unordered_map<table_id, seastar::lw_shared_ptr<repair_history_map>>;
 
+// An immutable copy of the repair history of a table: the repaired token
+// ranges, sorted and non-overlapping, with the time of their last repair.
+// Later repairs produce a new copy, so it can be shared by compactions which
+// started before them.
+class repair_history_index {
+public:
+    struct entry {
+        dht::token_range range;
+        gc_clock::time_point repair_time;
+    };
+private:
+    std::vector<entry> _entries;
+public:
+    explicit repair_history_index(const repair_history_map& m);
+
+    // Returns the entry containing t, if any.
+    //
+    // pos is the position at which the previous lookup ended. It should be
+    // 0 on the first lookup. Looking up tokens in non-decreasing order takes
+    // amortized constant time, a token smaller than the previous one takes a
+    // binary search.
+    const entry* find(const dht::token& t, size_t& pos) const;
+
+    const std::vector<entry>& entries() const noexcept {
+        return _entries;
+    }
+};
+
+using repair_history_index_ptr = seastar::lw_shared_ptr<const repair_history_index>;
+
 class tombstone_gc_options;
 
 class tombstone_gc_state {
     per_table_history_maps* _repair_history_maps;
 public:
+    // The tombstone gc state of a table, as of the time it was taken.
+    // The keys must be looked up in non-decreasing token order, like
+    // compaction does, for each lookup to take amortized constant time.
+    class table_snapshot {
+        schema_ptr _schema;
+        repair_history_index_ptr _history;
+        size_t _pos = 0;
+    public:
+        table_snapshot(schema_ptr s, repair_history_index_ptr history) noexcept
+            : _schema(std::move(s)), _history(std::move(history)) {}
+
+        gc_clock::time_point get_gc_before_for_key(const dht::decorated_key& dk, const gc_clock::time_point& query_time);
+    };
+
     tombstone_gc_state() = delete;
     tombstone_gc_state(per_table_history_maps* maps) noexcept : _repair_history_maps(maps) {}
 
@@ -48,6 +93,12 @@ class tombstone_gc_state {
     seastar::lw_shared_ptr<repair_history_map> get_or_create_repair_history_map_for_table(const table_id& id);
     void drop_repair_history_map_for_table(const table_id& id);
 
+    // Returns the repair history of the table as of now, or null if the table
+    // wasn't repaired.
+    repair_history_index_ptr get_repair_history_index_for_table(const table_id& id) const;
+
+    table_snapshot snapshot_for_table(schema_ptr s) const;
+
     struct get_gc_before_for_range_result {
         gc_clock::time_point min_gc_before;
         gc_clock::time_point max_gc_before;
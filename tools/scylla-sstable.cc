@@ -8,11 +8,15 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/join.hpp>
+#include <boost/range/irange.hpp>
+#include <bit>
 #include <filesystem>
+#include <set>
 #include <source_location>
 #include <fmt/chrono.h>
 #include <seastar/core/app-template.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/util/closeable.hh>
 
 #include "compaction/compaction.hh"
@@ -36,6 +40,7 @@
 #include "tools/sstable_consumer.hh"
 #include "tools/utils.hh"
 #include "locator/host_id.hh"
+#include "utils/murmur_hash.hh"
 
 using namespace seastar;
 
@@ -815,6 +820,32 @@ void consume_sstables(schema_ptr schema, reader_permit permit, std::vector<sstab
     }
 }
 
+// Like consume_sstables(), but when not merging, scans up to concurrency
+// sstables at a time, each in its own thread. The reader consumer is passed
+// the index of the sstable in sstables, or 0 when merging.
+void consume_sstables_concurrently(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables, bool merge,
+        bool use_crawling_reader, unsigned concurrency, std::function<void(flat_mutation_reader_v2&, sstables::sstable*, size_t)> reader_consumer) {
+    sst_log.trace("consume_sstables_concurrently(): {} sstables, merge={}, use_crawling_reader={}, concurrency={}", sstables.size(), merge,
+            use_crawling_reader, concurrency);
+    if (merge || concurrency <= 1) {
+        size_t i = 0;
+        consume_sstables(schema, permit, sstables, merge, use_crawling_reader, [&] (flat_mutation_reader_v2& rd, sstables::sstable* sst) {
+            reader_consumer(rd, sst, i++);
+            return stop_iteration::no;
+        });
+        return;
+    }
+    max_concurrent_for_each(boost::irange(size_t(0), sstables.size()), concurrency, [&] (size_t i) {
+        return seastar::async([&, i] {
+            const auto& sst = sstables[i];
+            auto rd = use_crawling_reader
+                ? sst->make_crawling_reader(schema, permit)
+                : sst->make_reader(schema, permit, query::full_partition_range, schema->full_slice());
+            reader_consumer(rd, sst.get(), i);
+        });
+    }).get();
+}
+
 using operation_func = void(*)(schema_ptr, reader_permit, const std::vector<sstables::shared_sstable>&, sstables::sstables_manager&, const bpo::variables_map&);
 
 class operation {
@@ -849,14 +880,14 @@ void validate_operation(schema_ptr schema, reader_permit permit, const std::vect
         throw std::runtime_error("error: no sstables specified on the command line");
     }
     const auto merge = vm.count("merge");
+    const auto concurrency = vm["concurrency"].as<unsigned>();
     sstables::compaction_data info;
-    consume_sstables(schema, permit, sstables, merge, true, [&info] (flat_mutation_reader_v2& rd, sstables::sstable* sst) {
+    consume_sstables_concurrently(schema, permit, sstables, merge, true, concurrency, [&info] (flat_mutation_reader_v2& rd, sstables::sstable* sst, size_t) {
         if (sst) {
             sst_log.info("validating {}", sst->get_filename());
         }
         const auto errors = sstables::scrub_validate_mode_validate_reader(std::move(rd), info).get();
         sst_log.info("validated {}: {}", sst ? sst->get_filename() : "the stream", errors == 0 ? "valid" : "invalid");
-        return stop_iteration::no;
     });
 }
 
@@ -2408,6 +2439,340 @@ void sstable_consumer_operation(schema_ptr schema, reader_permit permit, const s
     consumer->consume_stream_end().get();
 }
 
+// Distributes values into power-of-two buckets: bucket i holds the values in
+// [2^(i-1), 2^i), bucket 0 holds the zeros.
+class log2_histogram {
+    std::array<uint64_t, 65> _buckets{};
+    uint64_t _count = 0;
+    uint64_t _sum = 0;
+    uint64_t _max = 0;
+
+public:
+    void add(uint64_t v) {
+        ++_buckets[std::bit_width(v)];
+        ++_count;
+        _sum += v;
+        _max = std::max(_max, v);
+    }
+    void merge(const log2_histogram& o) {
+        for (size_t i = 0; i < _buckets.size(); ++i) {
+            _buckets[i] += o._buckets[i];
+        }
+        _count += o._count;
+        _sum += o._sum;
+        _max = std::max(_max, o._max);
+    }
+    void write(json_writer& writer) const {
+        writer.StartObject();
+        writer.Key("count");
+        writer.Uint64(_count);
+        writer.Key("mean");
+        writer.Double(_count ? double(_sum) / _count : 0.0);
+        writer.Key("max");
+        writer.Uint64(_max);
+        writer.Key("buckets");
+        writer.StartArray();
+        for (size_t i = 0; i < _buckets.size(); ++i) {
+            if (!_buckets[i]) {
+                continue;
+            }
+            writer.StartObject();
+            writer.Key("max");
+            writer.Uint64(i == 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t(1) << i) - 1);
+            writer.Key("count");
+            writer.Uint64(_buckets[i]);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+};
+
+// Estimates the number of distinct values from the k smallest hashes of the
+// values, see "On Synopses for Distinct-Value Estimation Under Multiset
+// Operations" (Beyer et al.). It is exact up to k distinct values, takes
+// constant memory and the estimators of several sstables can be merged.
+class distinct_values_estimator {
+    static constexpr size_t k = 1024;
+    std::set<uint64_t> _hashes;
+
+public:
+    void add(uint64_t hash) {
+        if (_hashes.size() < k) {
+            _hashes.insert(hash);
+            return;
+        }
+        auto largest = std::prev(_hashes.end());
+        if (hash < *largest && _hashes.insert(hash).second) {
+            _hashes.erase(largest);
+        }
+    }
+    void add(bytes_view value) {
+        std::array<uint64_t, 2> hash;
+        utils::murmur_hash::hash3_x64_128(value, 0, hash);
+        add(hash[0]);
+    }
+    void merge(const distinct_values_estimator& o) {
+        for (auto hash : o._hashes) {
+            add(hash);
+        }
+    }
+    uint64_t estimate() const {
+        if (_hashes.size() < k) {
+            return _hashes.size();
+        }
+        // The k-th smallest of n uniformly distributed hashes is expected to
+        // be at k/n of the hash space.
+        return (k - 1) * (double(std::numeric_limits<uint64_t>::max()) / double(*_hashes.rbegin()));
+    }
+};
+
+struct sstable_content_statistics {
+    struct column_statistics {
+        uint64_t live_cells = 0;
+        uint64_t dead_cells = 0;
+        uint64_t expiring_cells = 0;
+        // Only for atomic, non-counter columns.
+        distinct_values_estimator distinct_values;
+
+        void merge(const column_statistics& o) {
+            live_cells += o.live_cells;
+            dead_cells += o.dead_cells;
+            expiring_cells += o.expiring_cells;
+            distinct_values.merge(o.distinct_values);
+        }
+    };
+
+    uint64_t partitions = 0;
+    uint64_t partition_tombstones = 0;
+    uint64_t static_rows = 0;
+    uint64_t rows = 0;
+    uint64_t row_tombstones = 0;
+    uint64_t range_tombstone_changes = 0;
+    log2_histogram partition_rows;
+    // The size of the keys and values of the partitions, before they are
+    // serialized and compressed.
+    log2_histogram partition_size;
+    // Indexed by the ordinal id of the column.
+    std::vector<column_statistics> columns;
+
+    explicit sstable_content_statistics(const schema& s) : columns(s.all_columns_count()) { }
+
+    void merge(const sstable_content_statistics& o) {
+        partitions += o.partitions;
+        partition_tombstones += o.partition_tombstones;
+        static_rows += o.static_rows;
+        rows += o.rows;
+        row_tombstones += o.row_tombstones;
+        range_tombstone_changes += o.range_tombstone_changes;
+        partition_rows.merge(o.partition_rows);
+        partition_size.merge(o.partition_size);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            columns[i].merge(o.columns[i]);
+        }
+    }
+
+    void write(json_writer& writer, const schema& s) const {
+        auto ratio = [] (uint64_t n, uint64_t total) {
+            return total ? double(n) / total : 0.0;
+        };
+        uint64_t live_cells = 0;
+        uint64_t dead_cells = 0;
+        for (const auto& c : columns) {
+            live_cells += c.live_cells;
+            dead_cells += c.dead_cells;
+        }
+
+        writer.StartObject();
+        writer.Key("partitions");
+        writer.Uint64(partitions);
+        writer.Key("partition_tombstones");
+        writer.Uint64(partition_tombstones);
+        writer.Key("static_rows");
+        writer.Uint64(static_rows);
+        writer.Key("rows");
+        writer.Uint64(rows);
+        writer.Key("row_tombstones");
+        writer.Uint64(row_tombstones);
+        writer.Key("range_tombstone_changes");
+        writer.Uint64(range_tombstone_changes);
+        writer.Key("live_cells");
+        writer.Uint64(live_cells);
+        writer.Key("dead_cells");
+        writer.Uint64(dead_cells);
+
+        writer.Key("tombstone_ratios");
+        writer.StartObject();
+        writer.Key("partitions");
+        writer.Double(ratio(partition_tombstones, partitions));
+        writer.Key("rows");
+        writer.Double(ratio(row_tombstones, rows));
+        writer.Key("cells");
+        writer.Double(ratio(dead_cells, live_cells + dead_cells));
+        writer.EndObject();
+
+        writer.Key("partition_rows");
+        partition_rows.write(writer);
+        writer.Key("partition_size");
+        partition_size.write(writer);
+
+        writer.Key("columns");
+        writer.StartObject();
+        for (const auto& cdef : s.all_columns()) {
+            if (cdef.is_primary_key()) {
+                continue;
+            }
+            const auto& c = columns[static_cast<size_t>(cdef.ordinal_id)];
+            writer.Key(cdef.name_as_text());
+            writer.StartObject();
+            writer.Key("live_cells");
+            writer.Uint64(c.live_cells);
+            writer.Key("dead_cells");
+            writer.Uint64(c.dead_cells);
+            writer.Key("expiring_cells");
+            writer.Uint64(c.expiring_cells);
+            if (cdef.is_atomic() && !cdef.is_counter()) {
+                writer.Key("distinct_values");
+                writer.Uint64(c.distinct_values.estimate());
+            }
+            writer.EndObject();
+        }
+        writer.EndObject();
+
+        writer.EndObject();
+    }
+};
+
+class statistics_collecting_consumer : public sstable_consumer {
+    schema_ptr _schema;
+    sstable_content_statistics& _stats;
+    uint64_t _partition_rows = 0;
+    uint64_t _partition_size = 0;
+
+private:
+    void collect_cell(atomic_cell_view cell, sstable_content_statistics::column_statistics& stats) {
+        if (!cell.is_live()) {
+            ++stats.dead_cells;
+            return;
+        }
+        ++stats.live_cells;
+        if (cell.is_live_and_has_ttl()) {
+            ++stats.expiring_cells;
+        }
+        _partition_size += cell.value().size_bytes();
+    }
+    void collect_row(const row& r, column_kind kind) {
+        r.for_each_cell([this, kind] (column_id id, const atomic_cell_or_collection& cell) {
+            const auto& cdef = _schema->column_at(kind, id);
+            auto& stats = _stats.columns[static_cast<size_t>(cdef.ordinal_id)];
+            if (cdef.is_atomic()) {
+                auto ac = cell.as_atomic_cell(cdef);
+                collect_cell(ac, stats);
+                if (ac.is_live() && !cdef.is_counter()) {
+                    ac.value().with_linearized([&] (bytes_view v) {
+                        stats.distinct_values.add(v);
+                    });
+                }
+            } else {
+                cell.as_collection_mutation().with_deserialized(*cdef.type, [&, this] (collection_mutation_view_description mv) {
+                    if (mv.tomb) {
+                        ++stats.dead_cells;
+                    }
+                    for (auto&& [key, c] : mv.cells) {
+                        _partition_size += key.size();
+                        collect_cell(c, stats);
+                    }
+                });
+            }
+        });
+    }
+
+public:
+    statistics_collecting_consumer(schema_ptr s, sstable_content_statistics& stats) : _schema(std::move(s)), _stats(stats) { }
+
+    virtual future<> consume_stream_start() override {
+        return make_ready_future<>();
+    }
+    virtual future<stop_iteration> consume_sstable_start(const sstables::sstable* const sst) override {
+        return make_ready_future<stop_iteration>(stop_iteration::no);
+    }
+    virtual future<stop_iteration> consume(partition_start&& ps) override {
+        ++_stats.partitions;
+        if (ps.partition_tombstone()) {
+            ++_stats.partition_tombstones;
+        }
+        _partition_rows = 0;
+        _partition_size = ps.key().key().representation().size();
+        return make_ready_future<stop_iteration>(stop_iteration::no);
+    }
+    virtual future<stop_iteration> consume(static_row&& sr) override {
+        ++_stats.static_rows;
+        collect_row(sr.cells(), column_kind::static_column);
+        return make_ready_future<stop_iteration>(stop_iteration::no);
+    }
+    virtual future<stop_iteration> consume(clustering_row&& cr) override {
+        ++_stats.rows;
+        ++_partition_rows;
+        if (cr.tomb() != row_tombstone{}) {
+            ++_stats.row_tombstones;
+        }
+        _partition_size += cr.key().representation().size();
+        collect_row(cr.cells(), column_kind::regular_column);
+        return make_ready_future<stop_iteration>(stop_iteration::no);
+    }
+    virtual future<stop_iteration> consume(range_tombstone_change&& rtc) override {
+        ++_stats.range_tombstone_changes;
+        return make_ready_future<stop_iteration>(stop_iteration::no);
+    }
+    virtual future<stop_iteration> consume(partition_end&& pe) override {
+        _stats.partition_rows.add(_partition_rows);
+        _stats.partition_size.add(_partition_size);
+        return make_ready_future<stop_iteration>(stop_iteration::no);
+    }
+    virtual future<stop_iteration> consume_sstable_end() override {
+        return make_ready_future<stop_iteration>(stop_iteration::no);
+    }
+    virtual future<> consume_stream_end() override {
+        return make_ready_future<>();
+    }
+};
+
+void stats_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
+        sstables::sstables_manager& sst_man, const bpo::variables_map& vm) {
+    if (sstables.empty()) {
+        throw std::runtime_error("error: no sstables specified on the command line");
+    }
+    const auto merge = vm.count("merge");
+    const auto no_skips = vm.count("no-skips");
+    const auto partitions = get_partitions(schema, vm);
+    const auto use_crawling_reader = no_skips || partitions.empty();
+    const auto concurrency = vm["concurrency"].as<unsigned>();
+
+    std::vector<sstable_content_statistics> stats(merge ? 1 : sstables.size(), sstable_content_statistics(*schema));
+    consume_sstables_concurrently(schema, permit, sstables, merge, use_crawling_reader, concurrency,
+            [&] (flat_mutation_reader_v2& rd, sstables::sstable* sst, size_t i) {
+        auto consumer = statistics_collecting_consumer(schema, stats[i]);
+        consume_reader(std::move(rd), consumer, sst, partitions, no_skips);
+    });
+
+    // The results are written in the order of the sstables on the command
+    // line, regardless of the order they were scanned in.
+    json_writer writer;
+    writer.StartStream();
+    for (size_t i = 0; i < stats.size(); ++i) {
+        writer.SstableKey(merge ? nullptr : sstables[i].get());
+        stats[i].write(writer, *schema);
+    }
+    writer.EndObject();
+    writer.Key("total");
+    auto total = sstable_content_statistics(*schema);
+    for (const auto& s : stats) {
+        total.merge(s);
+    }
+    total.write(writer, *schema);
+    writer.EndObject();
+}
+
 class basic_option {
 public:
     const char* name;
@@ -2462,6 +2827,7 @@ const std::vector<option> all_options {
     typed_option<sstring>("partitions-file", "file containing partition(s) to filter for, partitions are expected to be in the hex format"),
     typed_option<>("merge", "merge all sstables into a single mutation fragment stream (use a combining reader over all sstable readers)"),
     typed_option<>("no-skips", "don't use skips to skip to next partition when the partition filter rejects one, this is slower but works with corrupt index"),
+    typed_option<unsigned>("concurrency", 1, "the number of sstables to process at the same time, ignored with --merge"),
     typed_option<std::string>("bucket", "months", "the unit of time to use as bucket, one of (years, months, weeks, days, hours)"),
     typed_option<std::string>("output-format", "json", "the output-format, one of (text, json)"),
     typed_option<std::string>("input-file", "the file containing the input"),
@@ -2603,6 +2969,31 @@ following example python script:
 )",
             {"bucket"},
             sstable_consumer_operation<writetime_histogram_collecting_consumer>},
+/* stats */
+    {"stats",
+            "Collect statistics about the content of the sstable(s)",
+R"(
+Crawl over the data component and collect, in a single pass:
+* the number of partitions, rows and tombstones, and the ratio of the
+  partitions, rows and cells which are tombstones
+* the distribution of the number of rows and of the size of the partitions,
+  in power-of-two buckets; the size is that of the keys and values, before
+  they are serialized and compressed
+* the number of live, dead and expiring cells of each regular and static
+  column, and an estimate of the number of distinct values of each atomic
+  column
+
+The statistics are written to the standard output, as JSON, for each sstable
+and in total. With --merge, they are collected over the merged stream of all
+sstables instead, so the data shadowed by the tombstones of another sstable
+is not counted.
+
+Processing a large number of sstables is mostly bound by I/O, so the sstables
+can be processed concurrently with --concurrency; the output does not depend
+on it.
+)",
+            {"partition", "partitions-file", "merge", "no-skips", "concurrency"},
+            stats_operation},
 /* validate */
     {"validate",
             "Validate the sstable(s), same as scrub in validate mode",
@@ -2616,7 +3007,7 @@ validation will happen on the fragment level.
 See https://docs.scylladb.com/operating-scylla/admin-tools/scylla-sstable#validate
 for more information on this operation.
 )",
-            {"merge"},
+            {"merge", "concurrency"},
             validate_operation},
     {"validate-checksums",
             "Validate the checksums of the sstable(s)",
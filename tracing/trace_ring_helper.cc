@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/metrics.hh>
+#include "tracing/trace_ring_helper.hh"
+#include "utils/class_registrator.hh"
+
+namespace tracing {
+
+// The events of a session which is not finished yet. They are recorded
+// together with the session once it is.
+struct trace_ring_session_state final : public backend_session_state_base {
+    std::deque<event_record> events;
+    virtual ~trace_ring_session_state() {}
+};
+
+// A session is encoded as its fixed size fields, as little endian integers,
+// followed by its strings, each prefixed by its length:
+//
+//   session_id (16) | command (1) | started_at (8) | duration (8)
+//   client | username | request
+//   parameters count (4) | (name | value)*
+//   events count (4) | (elapsed (8) | message)*
+//
+// All times are in microseconds.
+class record_writer {
+    bytes _out;
+    size_t _pos = 0;
+public:
+    explicit record_writer(size_t size) : _out(bytes::initialized_later(), size) {}
+    template <typename T>
+    void write(T v) {
+        write_le<T>(reinterpret_cast<char*>(_out.data() + _pos), v);
+        _pos += sizeof(T);
+    }
+    void write(std::string_view s) {
+        write<uint32_t>(s.size());
+        std::copy(s.begin(), s.end(), reinterpret_cast<char*>(_out.data() + _pos));
+        _pos += s.size();
+    }
+    bytes release() && {
+        return std::move(_out);
+    }
+};
+
+class record_reader {
+    bytes_view _in;
+public:
+    explicit record_reader(bytes_view in) : _in(in) {}
+    template <typename T>
+    T read() {
+        auto v = read_le<T>(reinterpret_cast<const char*>(_in.data()));
+        _in.remove_prefix(sizeof(T));
+        return v;
+    }
+    sstring read_string() {
+        auto size = read<uint32_t>();
+        sstring s(reinterpret_cast<const char*>(_in.data()), size);
+        _in.remove_prefix(size);
+        return s;
+    }
+};
+
+static int64_t to_micros(std::chrono::nanoseconds d) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+static size_t encoded_size(std::string_view s) {
+    return sizeof(uint32_t) + s.size();
+}
+
+trace_ring_helper::trace_ring_helper(tracing& tr)
+        : i_tracing_backend_helper(tr)
+        , _capacity(default_capacity) {
+    namespace sm = seastar::metrics;
+
+    _metrics.add_group("tracing_ring_helper", {
+        sm::make_counter("sessions_recorded", [this] { return _stats.sessions_recorded; },
+                        sm::description("Counts the tracing sessions recorded in memory.")),
+        sm::make_counter("sessions_dropped", [this] { return _stats.sessions_dropped; },
+                        sm::description("Counts the tracing sessions dropped from memory to make room for newer ones.")),
+        sm::make_gauge("memory", [this] { return _used; },
+                        sm::description("Holds the memory taken by the tracing sessions kept in memory.")),
+    });
+}
+
+future<> trace_ring_helper::start(cql3::query_processor& qp) {
+    return make_ready_future<>();
+}
+
+future<> trace_ring_helper::stop() {
+    return make_ready_future<>();
+}
+
+bytes trace_ring_helper::encode(const one_session_records& records, const std::deque<event_record>& events) {
+    const session_record& rec = records.session_rec;
+    auto client = fmt::format("{}", rec.client);
+
+    size_t size = 16 + 1 + 8 + 8 + encoded_size(client) + encoded_size(rec.username) + encoded_size(rec.request) + 4 + 4;
+    for (auto& [name, value] : rec.parameters) {
+        size += encoded_size(name) + encoded_size(value);
+    }
+    for (auto& e : events) {
+        size += 8 + encoded_size(e.message);
+    }
+
+    record_writer w(size);
+    w.write<int64_t>(records.session_id.get_most_significant_bits());
+    w.write<int64_t>(records.session_id.get_least_significant_bits());
+    w.write<uint8_t>(static_cast<uint8_t>(rec.command));
+    w.write<int64_t>(to_micros(rec.started_at.time_since_epoch()));
+    w.write<int64_t>(to_micros(rec.elapsed));
+    w.write(client);
+    w.write(rec.username);
+    w.write(rec.request);
+    w.write<uint32_t>(rec.parameters.size());
+    for (auto& [name, value] : rec.parameters) {
+        w.write(name);
+        w.write(value);
+    }
+    w.write<uint32_t>(events.size());
+    for (auto& e : events) {
+        w.write<int64_t>(to_micros(e.elapsed));
+        w.write(e.message);
+    }
+    return std::move(w).release();
+}
+
+trace_ring_helper::session trace_ring_helper::decode(bytes_view record) {
+    record_reader r(record);
+    session s;
+    auto msb = r.read<int64_t>();
+    auto lsb = r.read<int64_t>();
+    s.session_id = utils::UUID(msb, lsb);
+    s.command = static_cast<trace_type>(r.read<uint8_t>());
+    s.started_at = std::chrono::system_clock::time_point(std::chrono::microseconds(r.read<int64_t>()));
+    s.duration = std::chrono::microseconds(r.read<int64_t>());
+    s.client = r.read_string();
+    s.username = r.read_string();
+    s.request = r.read_string();
+    for (auto n = r.read<uint32_t>(); n; --n) {
+        auto name = r.read_string();
+        s.parameters.emplace(std::move(name), r.read_string());
+    }
+    auto events = r.read<uint32_t>();
+    s.events.reserve(events);
+    for (; events; --events) {
+        auto elapsed = std::chrono::microseconds(r.read<int64_t>());
+        s.events.push_back(event{elapsed, r.read_string()});
+    }
+    return s;
+}
+
+void trace_ring_helper::push(bytes record) {
+    if (record.size() > _capacity) {
+        ++_stats.sessions_dropped;
+        return;
+    }
+    _used += record.size();
+    _records.push_back(std::move(record));
+    ++_stats.sessions_recorded;
+    while (_used > _capacity) {
+        _used -= _records.front().size();
+        _records.pop_front();
+        ++_stats.sessions_dropped;
+    }
+}
+
+void trace_ring_helper::write_records_bulk(records_bulk& bulk) {
+    for (auto& records : bulk) {
+        auto num_records = records->size();
+        auto& state = *static_cast<trace_ring_session_state*>(records->backend_state_ptr.get());
+        std::move(records->events_recs.begin(), records->events_recs.end(), std::back_inserter(state.events));
+        records->events_recs.clear();
+        if (records->session_rec.ready()) {
+            try {
+                push(encode(*records, state.events));
+            } catch (...) {
+                tracing_logger.debug("{}: failed to record the tracing session: {}", records->session_id, std::current_exception());
+            }
+            state.events.clear();
+        }
+        records->data_consumed();
+        _local_tracing.write_complete(num_records);
+    }
+}
+
+std::unique_ptr<backend_session_state_base> trace_ring_helper::allocate_session_state() const {
+    return std::make_unique<trace_ring_session_state>();
+}
+
+std::vector<trace_ring_helper::session> trace_ring_helper::sessions(std::chrono::microseconds min_duration) const {
+    std::vector<session> ret;
+    for (auto& record : _records) {
+        auto s = decode(record);
+        if (s.duration >= min_duration) {
+            ret.push_back(std::move(s));
+        }
+    }
+    return ret;
+}
+
+std::ostream& operator<<(std::ostream& os, const trace_ring_helper::session& s) {
+    fmt::print(os, "session_id={} command={} started_at={} duration={}us client={} username={} request={}",
+            s.session_id, type_to_string(s.command),
+            std::chrono::duration_cast<std::chrono::microseconds>(s.started_at.time_since_epoch()).count(),
+            s.duration.count(), s.client, s.username, s.request);
+    for (auto& [name, value] : s.parameters) {
+        fmt::print(os, " {}={}", name, value);
+    }
+    for (auto& e : s.events) {
+        fmt::print(os, "\n  [{}us] {}", e.elapsed.count(), e.message);
+    }
+    return os;
+}
+
+using registry_ring = class_registrator<i_tracing_backend_helper, trace_ring_helper, tracing&>;
+static registry_ring registrator_ring("trace_ring_helper");
+
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+#pragma once
+
+#include <deque>
+#include <seastar/core/metrics_registration.hh>
+#include "tracing/tracing.hh"
+#include "bytes.hh"
+
+namespace tracing {
+
+// A tracing backend which keeps the most recent finished sessions of each
+// shard in memory, instead of writing them to the system_traces keyspace.
+//
+// Writing to system_traces costs several CQL mutations per traced request,
+// which becomes a noticeable load when more than a small fraction of the
+// requests is traced. This backend only copies each session, with its
+// events, into a compact binary record, and drops the oldest records when
+// the shard's records exceed their capacity. This makes it cheap enough to
+// keep probabilistic tracing on, and to dump the traces of slow requests
+// after the fact.
+class trace_ring_helper final : public i_tracing_backend_helper {
+public:
+    // The memory taken by the records of each shard.
+    static constexpr size_t default_capacity = 8 << 20;
+
+    struct event {
+        std::chrono::microseconds elapsed;
+        sstring message;
+    };
+
+    struct session {
+        utils::UUID session_id;
+        trace_type command;
+        std::chrono::system_clock::time_point started_at;
+        std::chrono::microseconds duration;
+        sstring client;
+        sstring username;
+        sstring request;
+        std::map<sstring, sstring> parameters;
+        std::vector<event> events;
+    };
+private:
+    size_t _capacity;
+    size_t _used = 0;
+    // The encoded sessions, the oldest first.
+    std::deque<bytes> _records;
+
+    struct stats {
+        uint64_t sessions_recorded = 0;
+        uint64_t sessions_dropped = 0;
+    } _stats;
+
+    seastar::metrics::metric_groups _metrics;
+private:
+    static bytes encode(const one_session_records& records, const std::deque<event_record>& events);
+    static session decode(bytes_view record);
+    void push(bytes record);
+public:
+    trace_ring_helper(tracing& tr);
+
+    virtual future<> start(cql3::query_processor& qp) override;
+    virtual future<> stop() override;
+    virtual void write_records_bulk(records_bulk& bulk) override;
+    virtual std::unique_ptr<backend_session_state_base> allocate_session_state() const override;
+
+    // The sessions of this shard which took at least min_duration, the
+    // oldest first.
+    std::vector<session> sessions(std::chrono::microseconds min_duration = std::chrono::microseconds(0)) const;
+};
+
+std::ostream& operator<<(std::ostream& os, const trace_ring_helper::session& s);
+
+}
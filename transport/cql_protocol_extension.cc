@@ -8,6 +8,7 @@
 
 #include <seastar/core/print.hh>
 #include "transport/cql_protocol_extension.hh"
+#include "transport/response.hh"
 #include "cql3/result_set.hh"
 #include "exceptions/exceptions.hh"
 
@@ -17,7 +18,9 @@ namespace cql_transport {
 
 static const std::map<cql_protocol_extension, seastar::sstring> EXTENSION_NAMES = {
     {cql_protocol_extension::LWT_ADD_METADATA_MARK, "SCYLLA_LWT_ADD_METADATA_MARK"},
-    {cql_protocol_extension::RATE_LIMIT_ERROR, "SCYLLA_RATE_LIMIT_ERROR"}
+    {cql_protocol_extension::RATE_LIMIT_ERROR, "SCYLLA_RATE_LIMIT_ERROR"},
+    {cql_protocol_extension::SHARD_ROUTING_HINT, "SCYLLA_SHARD_ROUTING_HINT"},
+    {cql_protocol_extension::CONTINUOUS_PAGING, "SCYLLA_CONTINUOUS_PAGING"}
 };
 
 cql_protocol_extension_enum_set supported_cql_protocol_extensions() {
@@ -34,6 +37,12 @@ std::vector<seastar::sstring> additional_options_for_proto_ext(cql_protocol_exte
             return {format("LWT_OPTIMIZATION_META_BIT_MASK={:d}", cql3::prepared_metadata::LWT_FLAG_MASK)};
         case cql_protocol_extension::RATE_LIMIT_ERROR:
             return {format("ERROR_CODE={}", exceptions::exception_code::RATE_LIMIT_ERROR)};
+        case cql_protocol_extension::SHARD_ROUTING_HINT:
+            return {format("PAYLOAD_KEY={}", shard_routing_hint_payload_key)};
+        case cql_protocol_extension::CONTINUOUS_PAGING:
+            return {format("PAYLOAD_KEY={}", continuous_paging_payload_key),
+                    format("MAX_CREDIT={}", continuous_paging_max_credit),
+                    format("REVISE_REQUEST_OPCODE={:d}", uint8_t(cql_binary_opcode::REVISE_REQUEST))};
         default:
             return {};
     }
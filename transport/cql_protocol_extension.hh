@@ -11,6 +11,7 @@
 #include "enum_set.hh"
 
 #include <map>
+#include <string_view>
 
 namespace cql_transport {
 
@@ -29,15 +30,38 @@ namespace cql_transport {
  */
 enum class cql_protocol_extension {
     LWT_ADD_METADATA_MARK,
-    RATE_LIMIT_ERROR
+    RATE_LIMIT_ERROR,
+    SHARD_ROUTING_HINT,
+    CONTINUOUS_PAGING
 };
 
 using cql_protocol_extension_enum = super_enum<cql_protocol_extension,
     cql_protocol_extension::LWT_ADD_METADATA_MARK,
-    cql_protocol_extension::RATE_LIMIT_ERROR>;
+    cql_protocol_extension::RATE_LIMIT_ERROR,
+    cql_protocol_extension::SHARD_ROUTING_HINT,
+    cql_protocol_extension::CONTINUOUS_PAGING>;
 
 using cql_protocol_extension_enum_set = enum_set<cql_protocol_extension_enum>;
 
+/**
+ * The custom payload key under which the SHARD_ROUTING_HINT extension
+ * tells the client which shard owns the partition of a request.
+ */
+constexpr std::string_view shard_routing_hint_payload_key = "scylla-owner-shard";
+
+/**
+ * The custom payload key under which a QUERY or EXECUTE request asks for
+ * CONTINUOUS_PAGING, with the number of pages the server may push before
+ * the client grants more with a REVISE_REQUEST.
+ */
+constexpr std::string_view continuous_paging_payload_key = "scylla-continuous-paging";
+
+/**
+ * The most pages a CONTINUOUS_PAGING request may have granted at any time.
+ * Bounds the memory a single request holds in pages the client hasn't read.
+ */
+constexpr int32_t continuous_paging_max_credit = 64;
+
 cql_protocol_extension_enum_set supported_cql_protocol_extensions();
 
 /**
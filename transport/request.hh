@@ -200,6 +200,18 @@ class request_reader {
         return string_map;
     }
 
+    // Null values are read as empty.
+    std::unordered_map<sstring, bytes> read_bytes_map() {
+        std::unordered_map<sstring, bytes> bytes_map;
+        auto n = read_short();
+        for (auto i = 0; i < n; i++) {
+            auto key = read_string();
+            auto val = read_bytes();
+            bytes_map.emplace(std::move(key), val ? std::move(*val) : bytes());
+        }
+        return bytes_map;
+    }
+
 private:
     enum class options_flag {
         VALUES,
@@ -221,7 +233,7 @@ class request_reader {
         options_flag::NAMES_FOR_VALUES
     >;
 public:
-    std::unique_ptr<cql3::query_options> read_options(uint8_t version, const cql3::cql_config& cql_config) {
+    cql3::query_options read_options(uint8_t version, const cql3::cql_config& cql_config) {
         auto consistency = read_consistency();
         auto flags = enum_set<options_flag_enum>::from_mask(read_byte());
         std::vector<cql3::raw_value_view> values;
@@ -240,7 +252,6 @@ class request_reader {
         flags.remove<options_flag::VALUES>();
         flags.remove<options_flag::SKIP_METADATA>();
 
-        std::unique_ptr<cql3::query_options> options;
         if (flags) {
             lw_shared_ptr<service::pager::paging_state> paging_state;
             int32_t page_size = flags.contains<options_flag::PAGE_SIZE>() ? read_int() : -1;
@@ -266,16 +277,13 @@ class request_reader {
             if (!names.empty()) {
                 onames = std::move(names);
             }
-            options = std::make_unique<cql3::query_options>(cql_config, consistency, std::move(onames),
+            return cql3::query_options(cql_config, consistency, std::move(onames),
                 cql3::raw_value_view_vector_with_unset(std::move(values), std::move(unset)), skip_metadata,
                 cql3::query_options::specific_options{page_size, std::move(paging_state), serial_consistency, ts});
-        } else {
-            options = std::make_unique<cql3::query_options>(cql_config, consistency, std::nullopt,
-                cql3::raw_value_view_vector_with_unset(std::move(values), std::move(unset)), skip_metadata,
-                cql3::query_options::specific_options::DEFAULT);
         }
-
-        return options;
+        return cql3::query_options(cql_config, consistency, std::nullopt,
+            cql3::raw_value_view_vector_with_unset(std::move(values), std::move(unset)), skip_metadata,
+            cql3::query_options::specific_options::DEFAULT);
     }
 };
 
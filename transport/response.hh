@@ -9,6 +9,7 @@
 #pragma once
 
 #include "server.hh"
+#include "transport/segment.hh"
 #include "utils/reusable_buffer.hh"
 
 namespace cql_transport {
@@ -31,6 +32,8 @@ enum class cql_binary_opcode : uint8_t {
     AUTH_CHALLENGE = 14,
     AUTH_RESPONSE  = 15,
     AUTH_SUCCESS   = 16,
+    // Only with the SCYLLA_CONTINUOUS_PAGING protocol extension.
+    REVISE_REQUEST = 255,
 };
 
 class response {
@@ -38,10 +41,23 @@ class response {
     cql_binary_opcode _opcode;
     uint8_t           _flags = 0; // a bitwise OR mask of zero or more cql_frame_flags values
     bytes_ostream _body;
+    // Data referenced by write_value_view(), to be sent just before the given
+    // offset of _body. Ordered by offset.
+    struct external_fragment {
+        size_t body_offset;
+        bytes_view data;
+    };
+    std::vector<external_fragment> _external_fragments;
+    size_t _external_size = 0;
+    deleter _keepalive;
 public:
     template<typename T>
     class placeholder;
 
+    // Values at least this large are referenced instead of copied by write_value_view().
+    // Below that, an extra entry in the scatter-gather list costs more than the copy.
+    static constexpr size_t min_referenced_value_size = 4096;
+
     response(int16_t stream, cql_binary_opcode opcode, const tracing::trace_state_ptr& tr_state_ptr)
         : _stream{stream}
         , _opcode{opcode}
@@ -75,6 +91,10 @@ class response {
     void write_string_multimap(std::multimap<sstring, sstring> string_map);
     void write_value(bytes_opt value);
     void write_value(std::optional<query::result_bytes_view> value);
+    // Like write_value(), but large values are referenced by the message
+    // instead of being copied into the response. The value has to be kept
+    // alive with retain().
+    void write_value_view(std::optional<query::result_bytes_view> value);
     void write(const cql3::metadata& m, bool skip = false);
     void write(const cql3::prepared_metadata& m, uint8_t version);
 
@@ -82,19 +102,36 @@ class response {
     // as the response object is alive.
     scattered_message<char> make_message(uint8_t version, cql_compression compression);
 
+    // Keeps d alive as long as the response.
+    void retain(deleter d) {
+        _keepalive.append(std::move(d));
+    }
+    bool references_external_data() const noexcept {
+        return !_external_fragments.empty();
+    }
+
     cql_binary_opcode opcode() const {
         return _opcode;
     }
+
+    // Writes the message, as an envelope of protocol v5 and later, into segments,
+    // which are compressed as a whole, if at all.
+    void write(segment_writer& out, uint8_t version) const;
     size_t size() const {
-        return _body.size();
+        return _body.size() + _external_size;
     }
 private:
+    // Calls func for each fragment of the body, external fragments included, in order.
+    template <typename Func>
+    void for_each_body_fragment(Func&& func) const;
+    // Copies external fragments into _body.
+    void inline_external_fragments();
     void compress(cql_compression compression);
     void compress_lz4();
     void compress_snappy();
 
     template <typename CqlFrameHeaderType>
-    sstring make_frame_one(uint8_t version, size_t length) {
+    sstring make_frame_one(uint8_t version, size_t length) const {
         sstring frame_buf = uninitialized_string(sizeof(CqlFrameHeaderType));
         auto* frame = reinterpret_cast<CqlFrameHeaderType*>(frame_buf.data());
         frame->version = version | 0x80;
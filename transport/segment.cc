@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+
+#include <lz4.h>
+#include <zlib.h>
+
+#include "exceptions/exceptions.hh"
+#include "transport/segment.hh"
+
+namespace cql_transport {
+
+namespace segment {
+
+static constexpr unsigned header_value_size = 3;
+static constexpr unsigned compressed_header_value_size = 5;
+static constexpr unsigned header_crc_size = 3;
+static constexpr unsigned length_bits = 17;
+static constexpr uint64_t length_mask = (uint64_t(1) << length_bits) - 1;
+
+uint32_t crc24(uint64_t value, unsigned bytes) noexcept {
+    static constexpr uint32_t crc24_init = 0x875060;
+    static constexpr uint32_t crc24_poly = 0x1974F0B;
+    uint32_t crc = crc24_init;
+    while (bytes--) {
+        crc ^= (value & 0xff) << 16;
+        value >>= 8;
+        for (int i = 0; i < 8; ++i) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= crc24_poly;
+            }
+        }
+    }
+    return crc & 0xffffff;
+}
+
+payload_crc32::payload_crc32() noexcept
+        : _crc(::crc32(0, Z_NULL, 0)) {
+    static constexpr uint8_t initial_bytes[] = {0xfa, 0x2d, 0x55, 0xca};
+    _crc = ::crc32(_crc, initial_bytes, sizeof(initial_bytes));
+}
+
+void payload_crc32::process(bytes_view data) noexcept {
+    _crc = ::crc32(_crc, reinterpret_cast<const Bytef*>(data.data()), data.size());
+}
+
+static uint64_t read_le_bytes(const char* data, unsigned bytes) noexcept {
+    uint64_t value = 0;
+    for (unsigned i = 0; i < bytes; ++i) {
+        value |= uint64_t(uint8_t(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+static void write_le_bytes(char* data, uint64_t value, unsigned bytes) noexcept {
+    for (unsigned i = 0; i < bytes; ++i) {
+        data[i] = char(value >> (8 * i));
+    }
+}
+
+static void write_header(char* data, const header& h, bool compressed) noexcept {
+    uint64_t value;
+    unsigned bytes;
+    if (compressed) {
+        value = h.payload_length | (h.uncompressed_length << length_bits) | (uint64_t(h.self_contained) << (2 * length_bits));
+        bytes = compressed_header_value_size;
+    } else {
+        value = h.payload_length | (uint64_t(h.self_contained) << length_bits);
+        bytes = header_value_size;
+    }
+    write_le_bytes(data, value, bytes);
+    write_le_bytes(data + bytes, crc24(value, bytes), header_crc_size);
+}
+
+header decode_header(const char* data, bool compressed) {
+    auto bytes = compressed ? compressed_header_value_size : header_value_size;
+    auto value = read_le_bytes(data, bytes);
+    auto crc = read_le_bytes(data + bytes, header_crc_size);
+    if (crc != crc24(value, bytes)) {
+        throw exceptions::protocol_exception(format("Segment header CRC mismatch: got {:#x}, expected {:#x}", crc, crc24(value, bytes)));
+    }
+    if (compressed) {
+        return header{
+            .payload_length = size_t(value & length_mask),
+            .uncompressed_length = size_t((value >> length_bits) & length_mask),
+            .self_contained = bool(value & (uint64_t(1) << (2 * length_bits))),
+        };
+    }
+    return header{
+        .payload_length = size_t(value & length_mask),
+        .uncompressed_length = 0,
+        .self_contained = bool(value & (uint64_t(1) << length_bits)),
+    };
+}
+
+temporary_buffer<char> decode_payload(const header& h, temporary_buffer<char> payload_and_trailer) {
+    if (payload_and_trailer.size() != h.payload_length + trailer_size) {
+        throw exceptions::protocol_exception(format("Truncated segment: got {} bytes, expected {}", payload_and_trailer.size(), h.payload_length + trailer_size));
+    }
+    payload_crc32 crc;
+    crc.process(bytes_view(reinterpret_cast<const int8_t*>(payload_and_trailer.get()), h.payload_length));
+    auto expected_crc = read_le<uint32_t>(payload_and_trailer.get() + h.payload_length);
+    if (crc.get() != expected_crc) {
+        throw exceptions::protocol_exception(format("Segment payload CRC mismatch: got {:#x}, expected {:#x}", crc.get(), expected_crc));
+    }
+    payload_and_trailer.trim(h.payload_length);
+    if (!h.uncompressed_length) {
+        return payload_and_trailer;
+    }
+    temporary_buffer<char> payload(h.uncompressed_length);
+    auto ret = LZ4_decompress_safe(payload_and_trailer.get(), payload.get_write(), h.payload_length, h.uncompressed_length);
+    if (ret < 0 || size_t(ret) != h.uncompressed_length) {
+        throw exceptions::protocol_exception("Segment LZ4 decompression failure");
+    }
+    return payload;
+}
+
+future<std::optional<decoded_segment>> read(input_stream<char>& in, bool compressed) {
+    auto header_buf = co_await in.read_exactly(compressed ? compressed_header_size : header_size);
+    if (header_buf.empty()) {
+        co_return std::nullopt;
+    }
+    if (header_buf.size() != (compressed ? compressed_header_size : header_size)) {
+        throw exceptions::protocol_exception("Truncated segment header");
+    }
+    auto h = decode_header(header_buf.get(), compressed);
+    auto payload = co_await in.read_exactly(h.payload_length + trailer_size);
+    co_return decoded_segment{decode_payload(h, std::move(payload)), h.self_contained};
+}
+
+}
+
+segment_writer::segment_writer(bool compress)
+        : _compress(compress)
+{ }
+
+void segment_writer::begin_envelope(size_t size) {
+    if (_payload_size + size <= segment::max_payload_size) {
+        return;
+    }
+    if (_payload_size) {
+        emit_segment(true);
+    }
+    _splitting = size > segment::max_payload_size;
+}
+
+void segment_writer::append(bytes_view data) {
+    if (_payload.empty()) {
+        _payload = temporary_buffer<char>(segment::max_payload_size);
+    }
+    while (!data.empty()) {
+        if (_payload_size == segment::max_payload_size) {
+            emit_segment(false);
+        }
+        auto n = std::min(data.size(), segment::max_payload_size - _payload_size);
+        std::copy_n(reinterpret_cast<const char*>(data.data()), n, _payload.get_write() + _payload_size);
+        _payload_size += n;
+        data.remove_prefix(n);
+    }
+}
+
+void segment_writer::end_envelope() {
+    if (_splitting) {
+        if (_payload_size) {
+            emit_segment(false);
+        }
+        _splitting = false;
+    }
+}
+
+void segment_writer::emit_segment(bool self_contained) {
+    const auto header_size = _compress ? segment::compressed_header_size : segment::header_size;
+    segment::header h{_payload_size, 0, self_contained};
+    temporary_buffer<char> seg;
+    if (_compress) {
+        seg = temporary_buffer<char>(header_size + LZ4_compressBound(_payload_size) + segment::trailer_size);
+#ifdef HAVE_LZ4_COMPRESS_DEFAULT
+        auto compressed = LZ4_compress_default(_payload.get(), seg.get_write() + header_size, _payload_size, LZ4_compressBound(_payload_size));
+#else
+        auto compressed = LZ4_compress(_payload.get(), seg.get_write() + header_size, _payload_size);
+#endif
+        // Incompressible payloads are sent as they are.
+        if (compressed > 0 && size_t(compressed) < _payload_size) {
+            h.payload_length = compressed;
+            h.uncompressed_length = _payload_size;
+        } else {
+            std::copy_n(_payload.get(), _payload_size, seg.get_write() + header_size);
+        }
+    } else {
+        seg = temporary_buffer<char>(header_size + _payload_size + segment::trailer_size);
+        std::copy_n(_payload.get(), _payload_size, seg.get_write() + header_size);
+    }
+    segment::write_header(seg.get_write(), h, _compress);
+    segment::payload_crc32 crc;
+    crc.process(bytes_view(reinterpret_cast<const int8_t*>(seg.get() + header_size), h.payload_length));
+    write_le<uint32_t>(seg.get_write() + header_size + h.payload_length, crc.get());
+    seg.trim(header_size + h.payload_length + segment::trailer_size);
+    _segments.push_back(std::move(seg));
+    _payload_size = 0;
+}
+
+std::vector<temporary_buffer<char>> segment_writer::flush() {
+    if (_payload_size) {
+        emit_segment(true);
+    }
+    return std::exchange(_segments, {});
+}
+
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <seastar/core/iostream.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include "bytes.hh"
+#include "seastarx.hh"
+
+namespace cql_transport {
+
+// Framing of native protocol v5, in which messages ("envelopes") are sent in
+// segments once the connection is established.
+//
+// A segment carries up to max_payload_size bytes, and checksums of both its
+// header and its payload. If compression was negotiated, each segment is
+// compressed on its own, with lz4. A self-contained segment holds one or more
+// whole envelopes. An envelope too large for a single segment is split over
+// several ones, which are not self-contained.
+//
+// The header of an uncompressed segment is made of 3 bytes, little-endian: 17
+// bits of payload length and the self-contained flag. The header of a
+// compressed segment is made of 5 bytes: 17 bits of compressed length, 17 bits
+// of uncompressed length, zero if the payload is sent uncompressed, and the
+// self-contained flag. Either is followed by its CRC24, on 3 bytes. The
+// payload follows, and then its CRC32, on 4 bytes.
+namespace segment {
+
+static constexpr size_t max_payload_size = (1 << 17) - 1;
+static constexpr size_t header_size = 3 + 3;
+static constexpr size_t compressed_header_size = 5 + 3;
+static constexpr size_t trailer_size = 4;
+
+// CRC24 of the given number of low bytes of value, as in segment headers.
+uint32_t crc24(uint64_t value, unsigned bytes) noexcept;
+
+// CRC32 of the payload of a segment, over one or more calls.
+class payload_crc32 {
+    uint32_t _crc;
+public:
+    payload_crc32() noexcept;
+    void process(bytes_view data) noexcept;
+    uint32_t get() const noexcept {
+        return _crc;
+    }
+};
+
+struct header {
+    // On the wire.
+    size_t payload_length;
+    // Zero if the payload isn't compressed.
+    size_t uncompressed_length;
+    bool self_contained;
+};
+
+// Decodes a segment header of header_size, or compressed_header_size if compressed.
+// Throws exceptions::protocol_exception if it is corrupt.
+header decode_header(const char* data, bool compressed);
+
+// Checks and decompresses the payload of a segment with header h, given with its trailer.
+// Throws exceptions::protocol_exception if it is corrupt.
+temporary_buffer<char> decode_payload(const header& h, temporary_buffer<char> payload_and_trailer);
+
+struct decoded_segment {
+    temporary_buffer<char> payload;
+    bool self_contained;
+};
+
+// Reads the next segment, or returns std::nullopt at the end of the stream.
+future<std::optional<decoded_segment>> read(input_stream<char>& in, bool compressed);
+
+}
+
+// Packs the envelopes written to it into segments.
+class segment_writer {
+    const bool _compress;
+    temporary_buffer<char> _payload;
+    size_t _payload_size = 0;
+    // Whether the envelope being written is split over several segments.
+    bool _splitting = false;
+    std::vector<temporary_buffer<char>> _segments;
+private:
+    void begin_envelope(size_t size);
+    void append(bytes_view data);
+    void end_envelope();
+    void emit_segment(bool self_contained);
+public:
+    explicit segment_writer(bool compress);
+
+    // Writes an envelope of the given size. for_each_fragment is called with
+    // a function, to which it passes the fragments of the envelope, in order.
+    template <typename ForEachFragment>
+    void write(size_t size, ForEachFragment&& for_each_fragment) {
+        begin_envelope(size);
+        for_each_fragment([this] (bytes_view fragment) {
+            append(fragment);
+        });
+        end_envelope();
+    }
+
+    // Returns the segments of the envelopes written so far.
+    std::vector<temporary_buffer<char>> flush();
+};
+
+}
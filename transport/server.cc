@@ -16,6 +16,7 @@
 
 #include "cql3/statements/batch_statement.hh"
 #include "cql3/statements/modification_statement.hh"
+#include "cql3/statements/select_statement.hh"
 #include "types/collection.hh"
 #include "types/list.hh"
 #include "types/set.hh"
@@ -26,8 +27,10 @@
 #include "service/storage_proxy.hh"
 #include "db/consistency_level_type.hh"
 #include "db/write_type.hh"
+#include <seastar/core/byteorder.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/future-util.hh>
+#include <seastar/core/later.hh>
 #include <seastar/core/seastar.hh>
 #include "utils/UUID.hh"
 #include <seastar/net/byteorder.hh>
@@ -153,7 +156,9 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
     , _config(config)
     , _max_request_size(config.max_request_size)
     , _max_concurrent_requests(db_cfg.max_concurrent_requests_per_shard)
+    , _max_concurrent_requests_per_connection(db_cfg.max_concurrent_requests_per_connection)
     , _memory_available(ml.get_semaphore())
+    , _max_memory_per_connection(ml.total_memory() / 4)
     , _notifier(std::make_unique<event_notifier>(*this))
     , _auth_service(auth_service)
     , _sl_controller(sl_controller)
@@ -186,6 +191,12 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
         sm::make_counter("register_requests", _stats.register_requests,
                         sm::description("Counts the total number of received CQL REGISTER messages.")),
 
+        sm::make_counter("cross_shard_requests", _stats.cross_shard_requests,
+                        sm::description("Counts the total number of received CQL EXECUTE messages for a partition owned by another shard.")),
+
+        sm::make_counter("continuous_paging_pages", _stats.continuous_paging_pages,
+                        sm::description("Counts the total number of pages pushed to clients by continuous paging requests, not counting the last page of each.")),
+
         sm::make_counter("cql-connections", _stats.connects,
                         sm::description("Counts a number of client connections.")),
 
@@ -209,6 +220,9 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
         sm::make_counter("requests_shed", _stats.requests_shed,
                         sm::description("Holds an incrementing counter with the requests that were shed due to overload (threshold configured via max_concurrent_requests_per_shard). "
                                             "The first derivative of this value shows how often we shed requests due to overload in the \"CQL transport\" component.")),
+        sm::make_counter("requests_blocked_connection_limit", _stats.requests_blocked_connection_limit,
+                        sm::description("Holds an incrementing counter of the times a connection stopped reading requests because it reached its limit of in-flight requests "
+                                            "(configured via max_concurrent_requests_per_connection) or its share of the memory quota of the \"CQL transport\" component.")),
         sm::make_gauge("requests_memory_available", [this] { return _memory_available.current(); },
                         sm::description(
                             seastar::format("Holds the amount of available memory for admitting new requests (max is {}B)."
@@ -337,7 +351,7 @@ cql_server::connection::read_frame() {
 }
 
 future<foreign_ptr<std::unique_ptr<cql_server::response>>>
-    cql_server::connection::process_request_one(fragmented_temporary_buffer::istream fbuf, uint8_t op, uint16_t stream, service::client_state& client_state, tracing_request_type tracing_request, service_permit permit) {
+    cql_server::connection::process_request_one(fragmented_temporary_buffer::istream fbuf, uint8_t op, uint16_t stream, service::client_state& client_state, tracing_request_type tracing_request, service_permit permit, uint8_t flags) {
     using auth_state = service::client_state::auth_state;
 
     auto cqlop = static_cast<cql_binary_opcode>(op);
@@ -361,7 +375,7 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
 
     auto linearization_buffer = std::make_unique<bytes_ostream>();
     auto linearization_buffer_ptr = linearization_buffer.get();
-    return futurize_invoke([this, cqlop, stream, &fbuf, &client_state, linearization_buffer_ptr, permit = std::move(permit), trace_state] () mutable {
+    return futurize_invoke([this, cqlop, stream, flags, &fbuf, &client_state, linearization_buffer_ptr, permit = std::move(permit), trace_state] () mutable {
         // When using authentication, we need to ensure we are doing proper state transitions,
         // i.e. we cannot simply accept any query/exec ops unless auth is complete
         switch (client_state.get_auth_state()) {
@@ -391,6 +405,14 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
             });
         };
         auto in = request_reader(std::move(fbuf), *linearization_buffer_ptr);
+        lw_shared_ptr<continuous_paging_session> continuous_paging;
+        if ((flags & cql_frame_flags::custom_payload) && _version > 3) {
+            auto payload = in.read_bytes_map();
+            continuous_paging = make_continuous_paging_session(cqlop, payload, in, client_state);
+        }
+        if (continuous_paging) {
+            return process_continuous_paging(std::move(continuous_paging), cqlop, stream, client_state, std::move(permit), trace_state);
+        }
         switch (cqlop) {
         case cql_binary_opcode::STARTUP:       return wrap_in_foreign(process_startup(stream, std::move(in), client_state, trace_state));
         case cql_binary_opcode::AUTH_RESPONSE: return wrap_in_foreign(process_auth_response(stream, std::move(in), client_state, trace_state));
@@ -400,6 +422,11 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
         case cql_binary_opcode::EXECUTE:       return process_execute(stream, std::move(in), client_state, std::move(permit), trace_state);
         case cql_binary_opcode::BATCH:         return process_batch(stream, std::move(in), client_state, std::move(permit), trace_state);
         case cql_binary_opcode::REGISTER:      return wrap_in_foreign(process_register(stream, std::move(in), client_state, trace_state));
+        case cql_binary_opcode::REVISE_REQUEST:
+            if (client_state.is_protocol_extension_set(cql_protocol_extension::CONTINUOUS_PAGING)) {
+                return wrap_in_foreign(process_revise_request(stream, std::move(in), client_state, trace_state));
+            }
+            [[fallthrough]];
         default:                               throw exceptions::protocol_exception(format("Unknown opcode {:d}", int(cqlop)));
         }
     }).then_wrapped([this, cqlop, stream, &client_state, linearization_buffer = std::move(linearization_buffer), trace_state] (future<result_with_foreign_response_ptr> f) {
@@ -517,6 +544,10 @@ cql_server::connection::~connection() {
 void cql_server::connection::on_connection_close()
 {
     _server._notifier->unregister_connection(this);
+    for (auto& [stream, session] : _continuous_paging_sessions) {
+        session->cancelled = true;
+        session->credit_available.signal();
+    }
 }
 
 std::tuple<net::inet_address, int, client_type> cql_server::connection::make_client_key(const service::client_state& cli_state) {
@@ -529,6 +560,7 @@ client_data cql_server::connection::make_client_data() const {
     client_data cd;
     std::tie(cd.ip, cd.port, cd.ct) = make_client_key(_client_state);
     cd.shard_id = this_shard_id();
+    cd.cross_shard_requests = _cross_shard_requests;
     cd.protocol_version = _version;
     cd.driver_name = _client_state.get_driver_name();
     cd.driver_version = _client_state.get_driver_version();
@@ -561,7 +593,18 @@ void cql_server::connection::handle_error(future<>&& f) {
     }
 }
 
+bool cql_server::connection::can_admit_request() const noexcept {
+    // An idle connection is always admitted, however large its requests.
+    return _requests_in_flight == 0
+            || (_requests_in_flight < _server._max_concurrent_requests_per_connection()
+                && _memory_in_flight < _server._max_memory_per_connection);
+}
+
 future<> cql_server::connection::process_request() {
+    if (!can_admit_request()) {
+        ++_server._stats.requests_blocked_connection_limit;
+        return _requests_in_flight_cv.wait([this] { return can_admit_request(); });
+    }
     return read_frame().then_wrapped([this] (future<std::optional<cql_binary_frame_v3>>&& v) {
         auto maybe_frame = v.get0();
         if (!maybe_frame) {
@@ -571,7 +614,10 @@ future<> cql_server::connection::process_request() {
 
         auto& f = *maybe_frame;
 
-        const bool allow_shedding = _client_state.get_workload_type() == service::client_state::workload_type::interactive;
+        const auto workload_type = _client_state.get_workload_type();
+        // Interactive workloads would rather fail fast than queue up, batch
+        // workloads the other way around, see the workload_type doc.
+        const bool allow_shedding = workload_type == service::client_state::workload_type::interactive;
         if (allow_shedding && _shed_incoming_requests) {
             ++_server._stats.requests_shed;
             return _read_buf.skip(f.length).then([this, stream = f.stream] {
@@ -602,7 +648,9 @@ future<> cql_server::connection::process_request() {
             });
         }
 
-        if (_server._stats.requests_serving > _server._max_concurrent_requests) {
+        // Batch workloads have a fixed concurrency, so they are left waiting for
+        // memory below instead, which bounds them as well.
+        if (_server._stats.requests_serving > _server._max_concurrent_requests && workload_type != service::client_state::workload_type::batch) {
             ++_server._stats.requests_shed;
             return _read_buf.skip(f.length).then([this, stream = f.stream] {
                 write_response(make_error(stream, exceptions::exception_code::OVERLOADED,
@@ -635,22 +683,27 @@ future<> cql_server::connection::process_request() {
             ++_server._stats.requests_blocked_memory;
         }
 
-        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested] (auto mem_permit_fut) {
+        return fut.then_wrapped([this, length = f.length, flags = f.flags, op, stream, tracing_requested, mem_estimate] (auto mem_permit_fut) {
           if (mem_permit_fut.failed()) {
               // Ignore semaphore errors - they are expected if load shedding took place
               mem_permit_fut.ignore_ready_future();
               return make_ready_future<>();
           }
           semaphore_units<> mem_permit = mem_permit_fut.get0();
-          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit))] (fragmented_temporary_buffer buf) mutable {
+          return this->read_and_decompress_frame(length, flags).then([this, op, stream, flags, tracing_requested, mem_estimate, mem_permit = make_service_permit(std::move(mem_permit))] (fragmented_temporary_buffer buf) mutable {
 
             ++_server._stats.requests_served;
             ++_server._stats.requests_serving;
 
             _pending_requests_gate.enter();
-            auto leave = defer([this] {
+            ++_requests_in_flight;
+            _memory_in_flight += mem_estimate;
+            auto leave = defer([this, mem_estimate] {
                 _shedding_timer.cancel();
                 _shed_incoming_requests = false;
+                --_requests_in_flight;
+                _memory_in_flight -= mem_estimate;
+                _requests_in_flight_cv.signal();
                 _pending_requests_gate.leave();
             });
             auto istream = buf.get_istream();
@@ -664,8 +717,8 @@ future<> cql_server::connection::process_request() {
                     op == uint8_t(cql_binary_opcode::BATCH));
 
             future<foreign_ptr<std::unique_ptr<cql_server::response>>> request_process_future = should_paralelize ?
-                    _process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit) :
-                    process_request_one(istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit);
+                    _process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit, flags) :
+                    process_request_one(istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit, flags);
 
             future<> request_response_future = request_process_future.then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
                     try {
@@ -830,8 +883,8 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_op
 }
 
 std::unique_ptr<cql_server::response>
-make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata = false);
+make_result(int16_t stream, ::shared_ptr<messages::result_message> msg, const tracing::trace_state_ptr& tr_state,
+        cql_protocol_version_type version, bool skip_metadata = false, std::optional<unsigned> owner_shard_hint = std::nullopt);
 
 template<typename Process>
 future<cql_server::result_with_foreign_response_ptr>
@@ -865,6 +918,16 @@ static inline cql_server::result_with_foreign_response_ptr convert_error_message
     return std::move(*dynamic_cast<messages::result_message::exception*>(msg)).get_exception();
 }
 
+// Where the page after the one in msg starts, if there is one.
+static lw_shared_ptr<service::pager::paging_state> next_page_state(const messages::result_message& msg) {
+    auto rows = dynamic_cast<const messages::result_message::rows*>(&msg);
+    if (!rows) {
+        return nullptr;
+    }
+    auto paging_state = rows->rs().get_metadata().paging_state();
+    return paging_state ? make_lw_shared<service::pager::paging_state>(*paging_state) : nullptr;
+}
+
 template<typename Process>
 future<cql_server::result_with_foreign_response_ptr>
 cql_server::connection::process(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit,
@@ -887,11 +950,17 @@ cql_server::connection::process(uint16_t stream, request_reader in, service::cli
 static future<process_fn_return_type>
 process_query_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version,
-        service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
+        service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls,
+        cql_server::connection::continuous_paging_session* continuous_paging) {
     auto query = in.read_long_string_view();
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
     auto& query_state = q_state->query_state;
-    q_state->options = in.read_options(version, qp.local().get_cql_config());
+    auto opts = in.read_options(version, qp.local().get_cql_config());
+    if (continuous_paging && continuous_paging->paging_state) {
+        q_state->options.emplace(std::move(opts), std::move(continuous_paging->paging_state));
+    } else {
+        q_state->options.emplace(std::move(opts));
+    }
     auto& options = *q_state->options;
     if (!cached_pk_fn_calls.empty()) {
         options.set_cached_pk_function_calls(std::move(cached_pk_fn_calls));
@@ -908,22 +977,33 @@ process_query_internal(service::client_state& client_state, distributed<cql3::qu
         tracing::begin(trace_state, "Execute CQL3 query", client_state.get_client_address());
     }
 
-    return qp.local().execute_direct_without_checking_exception_message(query, query_state, options).then([q_state = std::move(q_state), stream, skip_metadata, version] (auto msg) {
+    return qp.local().execute_direct_without_checking_exception_message(query, query_state, options).then([q_state = std::move(q_state), stream, skip_metadata, version, continuous_paging] (auto msg) {
+        if (continuous_paging) {
+            continuous_paging->paging_state = next_page_state(*msg);
+        }
         if (msg->move_to_shard()) {
             return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
         } else if (msg->is_exception()) {
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return process_fn_return_type(make_foreign(make_result(stream, msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
         }
     });
 }
 
 future<cql_server::result_with_foreign_response_ptr>
-cql_server::connection::process_query(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state) {
+cql_server::connection::process_query(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state,
+        continuous_paging_session* continuous_paging) {
     ++_server._stats.query_requests;
-    return process(stream, in, client_state, std::move(permit), std::move(trace_state), process_query_internal);
+    return process(stream, in, client_state, std::move(permit), std::move(trace_state),
+            [continuous_paging] (service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
+                    uint16_t stream, cql_protocol_version_type version,
+                    service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
+        // The session belongs to the shard of the connection, which is the only one setting init_trace.
+        return process_query_internal(client_state, qp, std::move(in), stream, version, std::move(permit), std::move(trace_state),
+                init_trace, std::move(cached_pk_fn_calls), init_trace ? continuous_paging : nullptr);
+    });
 }
 
 future<std::unique_ptr<cql_server::response>> cql_server::connection::process_prepare(uint16_t stream, request_reader in, service::client_state& client_state,
@@ -951,15 +1031,48 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_pr
             tracing::trace(trace_state, "Done preparing on a local shard - preparing a result. ID is [{}]", seastar::value_of([&msg] {
                 return messages::result_message::prepared::cql::get_id(msg);
             }));
-            return make_result(stream, *msg, trace_state, _version);
+            return make_result(stream, msg, trace_state, _version);
         });
     });
 }
 
+// Returns the shard owning the partition a prepared statement operates on,
+// if its partition key is fully bound.
+static std::optional<unsigned>
+owner_shard_of(const cql3::statements::prepared_statement& prepared, const cql3::query_options& options) {
+    auto& bind_indices = prepared.partition_key_bind_indices;
+    if (bind_indices.empty()) {
+        return std::nullopt;
+    }
+    schema_ptr schema;
+    if (auto select = dynamic_cast<const cql3::statements::select_statement*>(prepared.statement.get())) {
+        schema = select->get_schema();
+    } else if (auto modification = dynamic_cast<const cql3::statements::modification_statement*>(prepared.statement.get())) {
+        schema = modification->s;
+    } else {
+        return std::nullopt;
+    }
+    std::vector<managed_bytes> components;
+    components.reserve(bind_indices.size());
+    for (auto idx : bind_indices) {
+        if (options.is_unset(idx)) {
+            return std::nullopt;
+        }
+        auto value = to_managed_bytes_opt(options.get_value_at(idx));
+        if (!value) {
+            return std::nullopt;
+        }
+        components.push_back(std::move(*value));
+    }
+    auto key = partition_key::from_exploded(*schema, components);
+    return dht::shard_of(*schema, dht::get_token(*schema, key));
+}
+
 static future<process_fn_return_type>
 process_execute_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version,
-        service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
+        service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls,
+        cql_server::connection* conn, cql_server::connection::continuous_paging_session* continuous_paging) {
     cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
     auto& id = cql3::prepared_cache_key_type::cql_id(cache_key);
     bool needs_authorization = false;
@@ -978,7 +1091,12 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
 
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
     auto& query_state = q_state->query_state;
-    q_state->options = in.read_options(version, qp.local().get_cql_config());
+    auto opts = in.read_options(version, qp.local().get_cql_config());
+    if (continuous_paging && continuous_paging->paging_state) {
+        q_state->options.emplace(std::move(opts), std::move(continuous_paging->paging_state));
+    } else {
+        q_state->options.emplace(std::move(opts));
+    }
     auto& options = *q_state->options;
     if (!cached_pk_fn_calls.empty()) {
         options.set_cached_pk_function_calls(std::move(cached_pk_fn_calls));
@@ -1012,24 +1130,51 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
         tracing::add_prepared_query_options(trace_state, options);
     }
 
+    // Only the shard which received the request checks its routing; the
+    // request may be bounced to another shard later.
+    std::optional<unsigned> owner_shard_hint;
+    if (conn) {
+        try {
+            auto owner = owner_shard_of(*prepared, options);
+            if (owner && *owner != this_shard_id()) {
+                conn->count_cross_shard_request();
+                if (client_state.is_protocol_extension_set(cql_transport::cql_protocol_extension::SHARD_ROUTING_HINT)) {
+                    owner_shard_hint = owner;
+                }
+            }
+        } catch (...) {
+            // Malformed keys are reported by the statement itself.
+        }
+    }
+
     tracing::trace(trace_state, "Processing a statement");
     return qp.local().execute_prepared_without_checking_exception_message(std::move(prepared), std::move(cache_key), query_state, options, needs_authorization)
-            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version] (auto msg) {
+            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version, owner_shard_hint, continuous_paging] (auto msg) {
+        if (continuous_paging) {
+            continuous_paging->paging_state = next_page_state(*msg);
+        }
         if (msg->move_to_shard()) {
             return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
         } else if (msg->is_exception()) {
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return process_fn_return_type(make_foreign(make_result(stream, msg, q_state->query_state.get_trace_state(), version, skip_metadata, owner_shard_hint)));
         }
     });
 }
 
 future<cql_server::result_with_foreign_response_ptr> cql_server::connection::process_execute(uint16_t stream, request_reader in,
-        service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state) {
+        service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state, continuous_paging_session* continuous_paging) {
     ++_server._stats.execute_requests;
-    return process(stream, in, client_state, std::move(permit), std::move(trace_state), process_execute_internal);
+    return process(stream, in, client_state, std::move(permit), std::move(trace_state),
+            [this, continuous_paging] (service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
+                    uint16_t stream, cql_protocol_version_type version,
+                    service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
+        // init_trace is only set on the shard of the connection.
+        return process_execute_internal(client_state, qp, std::move(in), stream, version, std::move(permit), std::move(trace_state),
+                init_trace, std::move(cached_pk_fn_calls), init_trace ? this : nullptr, init_trace ? continuous_paging : nullptr);
+    });
 }
 
 static future<process_fn_return_type>
@@ -1120,8 +1265,7 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
     auto& query_state = q_state->query_state;
     // #563. CQL v2 encodes query_options in v1 format for batch requests.
-    q_state->options = std::make_unique<cql3::query_options>(cql3::query_options::make_batch_options(std::move(*in.read_options(version,
-                                                                     qp.local().get_cql_config())), std::move(values)));
+    q_state->options.emplace(cql3::query_options::make_batch_options(in.read_options(version, qp.local().get_cql_config()), std::move(values)));
     auto& options = *q_state->options;
     if (!cached_pk_fn_calls.empty()) {
         options.set_cached_pk_function_calls(std::move(cached_pk_fn_calls));
@@ -1143,7 +1287,7 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, trace_state, version)));
+            return process_fn_return_type(make_foreign(make_result(stream, msg, trace_state, version)));
         }
     });
 }
@@ -1169,6 +1313,95 @@ cql_server::connection::process_register(uint16_t stream, request_reader in, ser
     return make_ready_future<std::unique_ptr<cql_server::response>>(make_ready(stream, std::move(trace_state)));
 }
 
+lw_shared_ptr<cql_server::connection::continuous_paging_session>
+cql_server::connection::make_continuous_paging_session(cql_binary_opcode op, const std::unordered_map<sstring, bytes>& payload,
+        request_reader& in, const service::client_state& client_state) const {
+    auto it = payload.find(sstring(continuous_paging_payload_key));
+    if (it == payload.end() || !client_state.is_protocol_extension_set(cql_protocol_extension::CONTINUOUS_PAGING)) {
+        return nullptr;
+    }
+    if (op != cql_binary_opcode::QUERY && op != cql_binary_opcode::EXECUTE) {
+        throw exceptions::protocol_exception(format("Continuous paging is not supported for message {:d}", int(op)));
+    }
+    if (it->second.size() != sizeof(int32_t)) {
+        throw exceptions::protocol_exception(format("Invalid continuous paging credit of {:d} bytes", it->second.size()));
+    }
+    auto credit = read_be<int32_t>(reinterpret_cast<const char*>(it->second.data()));
+    if (credit <= 0) {
+        throw exceptions::protocol_exception(format("Invalid continuous paging credit: {:d}", credit));
+    }
+    auto session = make_lw_shared<continuous_paging_session>();
+    session->credit = std::min(credit, continuous_paging_max_credit);
+    // The frame is released once the first page is done, keep a copy.
+    auto body = in.read_raw_bytes_view(in.bytes_left());
+    std::vector<temporary_buffer<char>> fragments;
+    fragments.emplace_back(reinterpret_cast<const char*>(body.data()), body.size());
+    session->body = fragmented_temporary_buffer(std::move(fragments), body.size());
+    return session;
+}
+
+// Pushes the pages of a CONTINUOUS_PAGING request, for as long as the client
+// grants them. All pages but the last are written from here, the last one is
+// returned as the response to the request, so that the request stays in flight
+// and holds its memory permit until it's done.
+future<cql_server::result_with_foreign_response_ptr>
+cql_server::connection::process_continuous_paging(lw_shared_ptr<continuous_paging_session> session, cql_binary_opcode op, uint16_t stream,
+        service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state) {
+    if (_continuous_paging_sessions.contains(stream)) {
+        throw exceptions::protocol_exception(format("Stream {:d} is already in use by a continuous paging request", stream));
+    }
+    _continuous_paging_sessions.emplace(stream, session);
+    auto unregister = defer([this, stream] () noexcept {
+        _continuous_paging_sessions.erase(stream);
+    });
+    for (;;) {
+        bytes_ostream linearization_buffer;
+        request_reader in(session->body.get_istream(), linearization_buffer);
+        auto res = co_await (op == cql_binary_opcode::QUERY
+                ? process_query(stream, std::move(in), client_state, permit, trace_state, session.get())
+                : process_execute(stream, std::move(in), client_state, permit, trace_state, session.get()));
+        // Only the first page is traced.
+        trace_state = nullptr;
+        if (!res || !session->paging_state || session->cancelled) {
+            co_return res;
+        }
+        write_response(std::move(res).assume_value(), permit, _compression);
+        ++_server._stats.continuous_paging_pages;
+        --session->credit;
+        try {
+            co_await session->credit_available.wait(timeout_config().range_read_timeout, [&session] {
+                return session->credit > 0 || session->cancelled;
+            });
+        } catch (const condition_variable_timed_out&) {
+            session->cancelled = true;
+        }
+        if (session->cancelled) {
+            // The client can go on from the last page it got, with regular paging.
+            co_return make_foreign(make_result(stream, ::make_shared<messages::result_message::void_message>(), tracing::trace_state_ptr(), _version));
+        }
+    }
+}
+
+future<std::unique_ptr<cql_server::response>>
+cql_server::connection::process_revise_request(uint16_t stream, request_reader in, service::client_state& client_state,
+        tracing::trace_state_ptr trace_state) {
+    auto target_stream = in.read_short();
+    auto pages = in.read_int();
+    // The request may have completed in the meantime.
+    auto it = _continuous_paging_sessions.find(target_stream);
+    if (it != _continuous_paging_sessions.end()) {
+        auto& session = *it->second;
+        if (pages > 0) {
+            session.credit = std::min(int64_t(session.credit) + pages, int64_t(continuous_paging_max_credit));
+        } else {
+            session.cancelled = true;
+        }
+        session.credit_available.signal();
+    }
+    return make_ready_future<std::unique_ptr<cql_server::response>>(
+            make_result(stream, ::make_shared<messages::result_message::void_message>(), trace_state, _version));
+}
+
 std::unique_ptr<cql_server::response> cql_server::connection::make_unavailable_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t required, int32_t alive, const tracing::trace_state_ptr& tr_state) const
 {
     auto response = std::make_unique<cql_server::response>(stream, cql_binary_opcode::ERROR, tr_state);
@@ -1407,6 +1640,10 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
             void accept_value(std::optional<query::result_bytes_view> cell) {
                 _response.write_value(cell);
             }
+            // The response keeps the result alive, see make_result().
+            void accept_stable_value(std::optional<query::result_bytes_view> cell) {
+                _response.write_value_view(cell);
+            }
             void end_row() { }
 
             int64_t row_count() const { return _row_count; }
@@ -1419,15 +1656,25 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
 };
 
 std::unique_ptr<cql_server::response>
-make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata) {
+make_result(int16_t stream, ::shared_ptr<messages::result_message> msg, const tracing::trace_state_ptr& tr_state,
+        cql_protocol_version_type version, bool skip_metadata, std::optional<unsigned> owner_shard_hint) {
     auto response = std::make_unique<cql_server::response>(stream, cql_binary_opcode::RESULT, tr_state);
-    if (__builtin_expect(!msg.warnings().empty() && version > 3, false)) {
+    if (__builtin_expect(!msg->warnings().empty() && version > 3, false)) {
         response->set_frame_flag(cql_frame_flags::warning);
-        response->write_string_list(msg.warnings());
+        response->write_string_list(msg->warnings());
+    }
+    if (owner_shard_hint && version > 3) {
+        response->set_frame_flag(cql_frame_flags::custom_payload);
+        response->write_short(1);
+        response->write_string(shard_routing_hint_payload_key);
+        response->write_bytes(int32_type->decompose(int32_t(*owner_shard_hint)));
     }
     cql_server::fmt_visitor fmt{version, *response, skip_metadata};
-    msg.accept(fmt);
+    msg->accept(fmt);
+    if (response->references_external_data()) {
+        // Large values are sent straight from the result, keep it alive until the response is written.
+        response->retain(make_object_deleter(std::move(msg)));
+    }
     return response;
 }
 
@@ -1462,28 +1709,110 @@ cql_server::connection::make_schema_change_event(const event::schema_change& eve
 
 void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression)
 {
-    _ready_to_respond = _ready_to_respond.then([this, compression, response = std::move(response), permit = std::move(permit)] () mutable {
-        auto message = response->make_message(_version, compression);
-        message.on_delete([response = std::move(response)] { });
-        return _write_buf.write(std::move(message)).then([this] {
-            return _write_buf.flush();
+    _pending_responses.push_back(pending_response{std::move(response), std::move(permit), compression});
+    if (!_sending_responses) {
+        _sending_responses = true;
+        _ready_to_respond = _ready_to_respond.then_wrapped([this] (future<> f) {
+            if (f.failed()) {
+                // Nothing more can be written, don't hold on to the responses.
+                _pending_responses.clear();
+                _sending_responses = false;
+                return f;
+            }
+            return send_pending_responses();
         });
+    }
+}
+
+// Responses which complete while others are being written are sent together,
+// with a single flush. A connection with many responses pending yields after
+// each batch, so that the connections of the shard take turns in sending
+// theirs, rather than one of them hogging the shard with a long backlog.
+future<> cql_server::connection::send_pending_responses() {
+    static constexpr size_t max_batch_bytes = 256 * 1024;
+    try {
+        while (!_pending_responses.empty()) {
+            size_t batch_bytes = 0;
+            while (!_pending_responses.empty() && batch_bytes < max_batch_bytes) {
+                auto r = std::move(_pending_responses.front());
+                _pending_responses.pop_front();
+                auto message = r.response->make_message(_version, r.compression);
+                batch_bytes += message.len();
+                message.on_delete([response = std::move(r.response), permit = std::move(r.permit)] { });
+                co_await _write_buf.write(std::move(message));
+            }
+            co_await _write_buf.flush();
+            if (!_pending_responses.empty()) {
+                co_await seastar::yield();
+            }
+        }
+    } catch (...) {
+        _pending_responses.clear();
+        _sending_responses = false;
+        throw;
+    }
+    _sending_responses = false;
+}
+
+template <typename Func>
+void cql_server::response::for_each_body_fragment(Func&& func) const {
+    auto ext = _external_fragments.begin();
+    size_t offset = 0;
+    for (bytes_view fragment : _body.fragments()) {
+        for (; ext != _external_fragments.end() && ext->body_offset <= offset + fragment.size(); ++ext) {
+            auto n = ext->body_offset - offset;
+            if (n) {
+                func(fragment.substr(0, n));
+                fragment.remove_prefix(n);
+                offset += n;
+            }
+            func(ext->data);
+        }
+        if (!fragment.empty()) {
+            func(fragment);
+            offset += fragment.size();
+        }
+    }
+    for (; ext != _external_fragments.end(); ++ext) {
+        func(ext->data);
+    }
+}
+
+void cql_server::response::inline_external_fragments() {
+    if (_external_fragments.empty()) {
+        return;
+    }
+    bytes_ostream body;
+    for_each_body_fragment([&] (bytes_view fragment) {
+        body.write(fragment);
     });
+    _body = std::move(body);
+    _external_fragments.clear();
+    _external_size = 0;
 }
 
 scattered_message<char> cql_server::response::make_message(uint8_t version, cql_compression compression) {
     if (compression != cql_compression::none) {
+        inline_external_fragments();
         compress(compression);
     }
     scattered_message<char> msg;
-    auto frame = make_frame(version, _body.size());
+    auto frame = make_frame(version, size());
     msg.append(std::move(frame));
-    for (auto&& fragment : _body.fragments()) {
+    for_each_body_fragment([&] (bytes_view fragment) {
         msg.append_static(reinterpret_cast<const char*>(fragment.data()), fragment.size());
-    }
+    });
     return msg;
 }
 
+void cql_server::response::write(segment_writer& out, uint8_t version) const {
+    auto frame = make_frame_one<cql_binary_frame_v3>(version, size());
+    out.write(frame.size() + size(), [&] (auto&& append) {
+        append(bytes_view(reinterpret_cast<const int8_t*>(frame.data()), frame.size()));
+        for_each_body_fragment(append);
+    });
+}
+
 void cql_server::response::compress(cql_compression compression)
 {
     switch (compression) {
@@ -1709,6 +2038,21 @@ void cql_server::response::write_value(std::optional<query::result_bytes_view> v
     });
 }
 
+void cql_server::response::write_value_view(std::optional<query::result_bytes_view> value)
+{
+    if (!value || value->size_bytes() < min_referenced_value_size) {
+        write_value(value);
+        return;
+    }
+
+    write_int(value->size_bytes());
+    using boost::range::for_each;
+    for_each(*value, [&] (bytes_view fragment) {
+        _external_fragments.push_back(external_fragment{_body.size(), fragment});
+        _external_size += fragment.size();
+    });
+}
+
 class type_codec {
 private:
     enum class type_id : int16_t {
@@ -16,6 +16,8 @@
 #include <seastar/core/distributed.hh>
 #include "timeout_config.hh"
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/condition-variable.hh>
+#include <deque>
 #include <memory>
 #include <boost/intrusive/list.hpp>
 #include <seastar/net/tls.hh>
@@ -64,6 +66,7 @@ namespace cql_transport {
 
 class request_reader;
 class response;
+enum class cql_binary_opcode : uint8_t;
 
 enum class cql_compression {
     none,
@@ -74,6 +77,7 @@ enum class cql_compression {
 enum cql_frame_flags {
     compression = 0x01,
     tracing     = 0x02,
+    custom_payload = 0x04,
     warning     = 0x08,
 };
 
@@ -90,9 +94,11 @@ struct [[gnu::packed]] cql_binary_frame_v3 {
     }
 };
 
+// Kept for the duration of a request. The options are held in place, so that
+// a request takes a single allocation for both.
 struct cql_query_state {
     service::query_state query_state;
-    std::unique_ptr<cql3::query_options> options;
+    std::optional<cql3::query_options> options;
 
     cql_query_state(service::client_state& client_state, tracing::trace_state_ptr trace_state_ptr, service_permit permit)
         : query_state(client_state, std::move(trace_state_ptr), std::move(permit))
@@ -120,6 +126,7 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         uint32_t requests_serving;
         uint64_t requests_blocked_memory;
         uint64_t requests_shed;
+        uint64_t requests_blocked_connection_limit;
 
         // cql message stats
         uint64_t startups;
@@ -131,6 +138,12 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         uint64_t batch_requests;
         uint64_t register_requests;
 
+        // EXECUTE requests for a partition owned by another shard
+        uint64_t cross_shard_requests;
+
+        // Pages pushed by CONTINUOUS_PAGING requests, but their last
+        uint64_t continuous_paging_pages;
+
         std::unordered_map<exceptions::exception_code, uint64_t> errors;
     };
 private:
@@ -142,7 +155,11 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
     cql_server_config _config;
     size_t _max_request_size;
     utils::updateable_value<uint32_t> _max_concurrent_requests;
+    utils::updateable_value<uint32_t> _max_concurrent_requests_per_connection;
     semaphore& _memory_available;
+    // A single connection never holds more than this much of the memory
+    // of _memory_available, so that it cannot starve the other connections.
+    size_t _max_memory_per_connection;
     seastar::metrics::metric_groups _metrics;
     std::unique_ptr<event_notifier> _notifier;
 private:
@@ -167,9 +184,10 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
 private:
     class fmt_visitor;
     friend class connection;
-    friend std::unique_ptr<cql_server::response> make_result(int16_t stream, messages::result_message& msg,
-            const tracing::trace_state_ptr& tr_state, cql_protocol_version_type version, bool skip_metadata);
-
+    friend std::unique_ptr<cql_server::response> make_result(int16_t stream, ::shared_ptr<messages::result_message> msg,
+            const tracing::trace_state_ptr& tr_state, cql_protocol_version_type version, bool skip_metadata,
+            std::optional<unsigned> owner_shard_hint);
+public:
     class connection : public generic_server::connection {
         cql_server& _server;
         socket_address _server_addr;
@@ -182,6 +200,39 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         unsigned _request_cpu = 0;
         bool _ready = false;
         bool _authenticating = false;
+        // EXECUTE requests for a partition owned by another shard
+        uint64_t _cross_shard_requests = 0;
+        // Requests read off the connection and not yet responded to, and the
+        // memory they hold. No more requests are read while either is at its
+        // limit, which pushes back on the client through TCP flow control.
+        uint32_t _requests_in_flight = 0;
+        size_t _memory_in_flight = 0;
+        condition_variable _requests_in_flight_cv;
+
+        struct pending_response {
+            foreign_ptr<std::unique_ptr<cql_server::response>> response;
+            service_permit permit;
+            cql_compression compression;
+        };
+        // Responses waiting to be written, in completion order.
+        std::deque<pending_response> _pending_responses;
+        bool _sending_responses = false;
+    public:
+        // A QUERY or EXECUTE request of the CONTINUOUS_PAGING protocol extension,
+        // whose pages are pushed to the client as long as it grants them.
+        struct continuous_paging_session {
+            // Pages which can still be sent before the client grants more.
+            int32_t credit;
+            bool cancelled = false;
+            // The request without its custom payload, read again for every page.
+            fragmented_temporary_buffer body;
+            // Where the next page starts, if any. Set by the processing of a page.
+            lw_shared_ptr<service::pager::paging_state> paging_state;
+            condition_variable credit_available;
+        };
+    private:
+        // By stream of the request.
+        std::unordered_map<uint16_t, lw_shared_ptr<continuous_paging_session>> _continuous_paging_sessions;
 
         enum class tracing_request_type : uint8_t {
             not_requested,
@@ -197,7 +248,8 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
                 uint16_t,
                 service::client_state&,
                 tracing_request_type,
-                service_permit>;
+                service_permit,
+                uint8_t>;
         static thread_local execution_stage_type _process_request_stage;
     public:
         connection(cql_server& server, socket_address server_addr, connected_socket&& fd, socket_address addr);
@@ -208,23 +260,36 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         static std::tuple<net::inet_address, int, client_type> make_client_key(const service::client_state& cli_state);
         client_data make_client_data() const;
         const service::client_state& get_client_state() const { return _client_state; }
+        void count_cross_shard_request() noexcept {
+            ++_cross_shard_requests;
+            ++_server._stats.cross_shard_requests;
+        }
     private:
         const ::timeout_config& timeout_config() const { return _server.timeout_config(); }
         friend class process_request_executor;
-        future<foreign_ptr<std::unique_ptr<cql_server::response>>> process_request_one(fragmented_temporary_buffer::istream buf, uint8_t op, uint16_t stream, service::client_state& client_state, tracing_request_type tracing_request, service_permit permit);
+        future<foreign_ptr<std::unique_ptr<cql_server::response>>> process_request_one(fragmented_temporary_buffer::istream buf, uint8_t op, uint16_t stream, service::client_state& client_state, tracing_request_type tracing_request, service_permit permit, uint8_t flags);
         unsigned frame_size() const;
         unsigned pick_request_cpu();
+        bool can_admit_request() const noexcept;
+        future<> send_pending_responses();
         cql_binary_frame_v3 parse_frame(temporary_buffer<char> buf) const;
         future<fragmented_temporary_buffer> read_and_decompress_frame(size_t length, uint8_t flags);
         future<std::optional<cql_binary_frame_v3>> read_frame();
         future<std::unique_ptr<cql_server::response>> process_startup(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
         future<std::unique_ptr<cql_server::response>> process_auth_response(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
         future<std::unique_ptr<cql_server::response>> process_options(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
-        future<result_with_foreign_response_ptr> process_query(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state);
+        future<result_with_foreign_response_ptr> process_query(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state,
+                continuous_paging_session* continuous_paging = nullptr);
         future<std::unique_ptr<cql_server::response>> process_prepare(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
-        future<result_with_foreign_response_ptr> process_execute(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state);
+        future<result_with_foreign_response_ptr> process_execute(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state,
+                continuous_paging_session* continuous_paging = nullptr);
         future<result_with_foreign_response_ptr> process_batch(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state);
         future<std::unique_ptr<cql_server::response>> process_register(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
+        lw_shared_ptr<continuous_paging_session> make_continuous_paging_session(cql_binary_opcode op, const std::unordered_map<sstring, bytes>& payload,
+                request_reader& in, const service::client_state& client_state) const;
+        future<result_with_foreign_response_ptr> process_continuous_paging(lw_shared_ptr<continuous_paging_session> session, cql_binary_opcode op, uint16_t stream,
+                service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state);
+        future<std::unique_ptr<cql_server::response>> process_revise_request(uint16_t stream, request_reader in, service::client_state& client_state, tracing::trace_state_ptr trace_state);
 
         std::unique_ptr<cql_server::response> make_unavailable_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t required, int32_t alive, const tracing::trace_state_ptr& tr_state) const;
         std::unique_ptr<cql_server::response> make_read_timeout_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t blockfor, bool data_present, const tracing::trace_state_ptr& tr_state) const;
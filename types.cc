@@ -2024,6 +2024,18 @@ data_value deserialize_aux(const tuple_type_impl& t, View v) {
 template<FragmentedView View>
 utils::multiprecision_int deserialize_value(const varint_type_impl&, View v) {
     bool negative = v.current_fragment().front() < 0;
+    if (v.size_bytes() <= sizeof(int64_t)) {
+        // Most values fit in a native integer, so avoid the multiprecision
+        // shifts and additions for them.
+        uint64_t x = negative ? ~uint64_t(0) : 0;
+        while (v.size_bytes()) {
+            for (uint8_t b : v.current_fragment()) {
+                x = (x << 8) | b;
+            }
+            v.remove_current();
+        }
+        return utils::multiprecision_int(static_cast<int64_t>(x));
+    }
     utils::multiprecision_int num;
   while (v.size_bytes()) {
     for (uint8_t b : v.current_fragment()) {
@@ -20,14 +20,20 @@
 
 namespace utils {
 
-static int64_t make_thread_local_node(int64_t node) {
+static int64_t local_thread_id() {
     // An atomic counter to issue thread identifiers.
     // We should take current core number into consideration
     // because create_time_safe() doesn't synchronize across cores and
     // it's easy to get duplicates. Use an own counter since
     // seastar::this_shard_id() may not yet be available.
+    // The counter is only touched once per thread.
     static std::atomic<int64_t> thread_id_counter;
     static thread_local int64_t thread_id = thread_id_counter.fetch_add(1);
+    return thread_id;
+}
+
+static int64_t make_thread_local_node(int64_t node) {
+    auto thread_id = local_thread_id();
     // Mix in the core number into Organisational Unique
     // Identifier, to leave NIC intact, assuming tampering
     // with NIC is more likely to lead to collision within
@@ -107,8 +113,15 @@ static int64_t make_clock_seq_and_node()
     // since the epoch, and taking 14 bits of it. We don't do exactly
     // the same, but the idea is the same.
     //long clock = new Random(System.currentTimeMillis()).nextLong();
-    unsigned int seed = std::chrono::system_clock::now().time_since_epoch().count();
-    int clock = rand_r(&seed);
+    static const int process_clock = [] {
+        unsigned int seed = std::chrono::system_clock::now().time_since_epoch().count();
+        return rand_r(&seed);
+    }();
+    // The random clock sequence of the process is offset by the thread
+    // identifier, so that the UUIDs generated by different threads differ
+    // in the clock sequence, and can't collide even if generated at the
+    // same time.
+    int64_t clock = process_clock + local_thread_id();
 
     long lsb = 0;
     lsb |= 0x8000000000000000L;                 // variant (2 bits)
@@ -159,8 +172,15 @@ UUID UUID_gen::negate(UUID o) {
     return UUID(o.get_most_significant_bits(), lsb);
 }
 
+int64_t UUID_gen::init_clock_seq_and_node() noexcept {
+    if (_state.clock_seq_and_node == 0) {
+        _state.clock_seq_and_node = make_clock_seq_and_node();
+    }
+    return _state.clock_seq_and_node;
+}
+
+thread_local constinit UUID_gen::generator_state UUID_gen::_state;
 const thread_local int64_t UUID_gen::spoof_node = make_thread_local_node(make_random_node());
-const thread_local int64_t UUID_gen::clock_seq_and_node = make_clock_seq_and_node();
-thread_local UUID_gen UUID_gen::_instance;
+const thread_local int64_t UUID_gen::clock_seq_and_node = init_clock_seq_and_node();
 
 } // namespace utils
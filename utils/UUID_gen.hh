@@ -72,34 +72,44 @@ class UUID_gen
     static constexpr int64_t MIN_CLOCK_SEQ_AND_NODE = 0x8080808080808080L;
     static constexpr int64_t MAX_CLOCK_SEQ_AND_NODE = 0x7f7f7f7f7f7f7f7fL;
 
-    // An instance of UUID_gen uses clock_seq_and_node so should
-    // be constructed after it.
-    static thread_local UUID_gen _instance;
-
-    decimicroseconds _last_used_time = decimicroseconds{0};
-
-    UUID_gen()
-    {
-        // make sure someone didn't whack the clockSeqAndNode by changing the order of instantiation.
-        assert(clock_seq_and_node != 0);
+    // The state of the time UUID generator of this thread. It's constant
+    // initialized, so that accessing it doesn't go through the thread_local
+    // initialization guard. The clock sequence and node are set on the first
+    // use, see local_clock_seq_and_node().
+    struct generator_state {
+        decimicroseconds last_used_time{0};
+        int64_t clock_seq_and_node = 0;
+    };
+    static thread_local constinit generator_state _state;
+
+    static int64_t init_clock_seq_and_node() noexcept;
+
+    static int64_t local_clock_seq_and_node() noexcept {
+        auto csn = _state.clock_seq_and_node;
+        if (csn == 0) [[unlikely]] {
+            csn = init_clock_seq_and_node();
+        }
+        return csn;
     }
 
-    // Return decimicrosecond time based on the system time,
-    // in milliseconds. If the current millisecond hasn't change
-    // from the previous call, increment the previously used
-    // value by one decimicrosecond.
+    // Return decimicrosecond time based on the system time.
+    // If it hasn't changed from the previous call, increment
+    // the previously used value by one decimicrosecond.
     // NOTE: In the original Java code this function was
     // "synchronized". This isn't needed since in Scylla we do not
     // need monotonicity between time UUIDs created at different
-    // shards and UUID code uses thread local state on each shard.
-    int64_t create_time_safe() {
+    // threads, and each thread embeds its own identifier in the
+    // clock sequence, so their UUIDs never collide.
+    // The original code also used the time in milliseconds, which
+    // makes the time run ahead of the clock after 10000 UUIDs
+    // generated within a millisecond.
+    static int64_t create_time_safe() noexcept {
         using std::chrono::system_clock;
-        auto millis = duration_cast<milliseconds>(system_clock::now().time_since_epoch());
-        decimicroseconds when = from_unix_timestamp(millis);
-        if (when > _last_used_time) {
-            _last_used_time = when;
+        decimicroseconds when = from_unix_timestamp(system_clock::now().time_since_epoch());
+        if (when > _state.last_used_time) {
+            _state.last_used_time = when;
         } else {
-            when = ++_last_used_time;
+            when = ++_state.last_used_time;
         }
         return create_time(when);
     }
@@ -115,7 +125,7 @@ class UUID_gen
      */
     static UUID get_time_UUID()
     {
-        auto uuid = UUID(_instance.create_time_safe(), clock_seq_and_node);
+        auto uuid = UUID(create_time_safe(), local_clock_seq_and_node());
         assert(uuid.is_timestamp());
         return uuid;
     }
@@ -268,8 +278,8 @@ class UUID_gen
      */
     static std::array<int8_t, 16> get_time_UUID_bytes() {
 
-        uint64_t msb = _instance.create_time_safe();
-        uint64_t lsb = clock_seq_and_node;
+        uint64_t msb = create_time_safe();
+        uint64_t lsb = local_clock_seq_and_node();
         std::array<int8_t, 16> uuid_bytes;
 
         for (int i = 0; i < 8; i++) {
@@ -52,6 +52,15 @@ arch_target("default") unsigned array_search_x32_eq_impl(uint8_t val, const uint
     return array_search_eq_impl(val, arr, 32 * nr);
 }
 
+arch_target("default") std::pair<unsigned, unsigned> array_search_eq_range_impl(uint64_t val, const uint64_t* array, unsigned size) {
+    unsigned s, e;
+
+    for (s = 0; s < size && array[s] < val; s++);
+    for (e = s; e < size && array[e] == val; e++);
+
+    return {s, e};
+}
+
 #ifdef __x86_64__
 
 /*
@@ -136,6 +145,34 @@ arch_target("avx2") unsigned array_search_x32_eq_impl(uint8_t val, const uint8_t
     return len;
 }
 
+/*
+ * AVX2 version of searching for the range of equal elements.
+ *
+ * The array is sorted, so the range starts after all the elements that
+ * are less than the value and ends before all the greater ones. Both are
+ * counted with comparisons, 4 elements in one go, without branches. The
+ * comparison is signed, so both sides are shifted by flipping the sign
+ * bit to get the unsigned order.
+ */
+arch_target("avx2") std::pair<unsigned, unsigned> array_search_eq_range_impl(uint64_t val, const uint64_t* array, unsigned size) {
+    const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+    __m256i k = _mm256_xor_si256(_mm256_set1_epi64x(val), sign);
+    unsigned lt = 0, gt = 0, i;
+
+    for (i = 0; i + 4 <= size; i += 4) {
+        __m256i a = _mm256_xor_si256(_mm256_lddqu_si256((__m256i*)&array[i]), sign);
+        lt += _mm_popcnt_u32(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, a))));
+        gt += _mm_popcnt_u32(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, k))));
+    }
+
+    for (; i < size; i++) {
+        lt += array[i] < val;
+        gt += array[i] > val;
+    }
+
+    return {lt, size - gt};
+}
+
 #endif
 
 int array_search_gt(int64_t val, const int64_t* array, const int capacity, const int size) {
@@ -154,4 +191,8 @@ unsigned array_search_x32_eq(uint8_t val, const uint8_t* array, int nr) {
     return array_search_x32_eq_impl(val, array, nr);
 }
 
+std::pair<unsigned, unsigned> array_search_eq_range(uint64_t val, const uint64_t* array, unsigned size) {
+    return array_search_eq_range_impl(val, array, size);
+}
+
 }
@@ -10,6 +10,7 @@
 
 #include <cstdint>
 #include <limits>
+#include <utility>
 
 namespace utils {
 
@@ -57,4 +58,14 @@ unsigned array_search_16_eq(uint8_t val, const uint8_t* array);
 unsigned array_search_32_eq(uint8_t val, const uint8_t* array);
 unsigned array_search_x32_eq(uint8_t val, const uint8_t* array, int nr);
 
+/*
+ * array_search_eq_range(value, array, size)
+ *
+ * Returns the [first, last) range of indexes of the elements equal to
+ * the given value in the array sorted in ascending (unsigned) order.
+ * When there are no such elements both are the index of the first
+ * element that's greater than the value.
+ */
+std::pair<unsigned, unsigned> array_search_eq_range(uint64_t val, const uint64_t* array, unsigned size);
+
 }
@@ -10,12 +10,16 @@
 
 #include "ascii.hh"
 #include <seastar/core/byteorder.hh>
+#ifdef __x86_64__
+#include <x86intrin.h>
+#define arch_target(name) [[gnu::target(name)]]
+#endif
 
 namespace utils {
 
 namespace ascii {
 
-bool validate(const uint8_t *data, size_t len) {
+static bool validate_scalar(const uint8_t *data, size_t len) {
     // OR all bytes
     uint8_t orall = 0;
 
@@ -46,6 +50,47 @@ bool validate(const uint8_t *data, size_t len) {
     return orall < 0x80;
 }
 
+#ifdef __x86_64__
+
+arch_target("default") bool validate_impl(const uint8_t *data, size_t len) {
+    return validate_scalar(data, len);
+}
+
+arch_target("avx2") bool validate_impl(const uint8_t *data, size_t len) {
+    // OR 32 bytes at a time, with two independent streams
+    if (len >= 64) {
+        __m256i or1 = _mm256_setzero_si256();
+        __m256i or2 = _mm256_setzero_si256();
+
+        do {
+            or1 = _mm256_or_si256(or1, _mm256_lddqu_si256((const __m256i *)data));
+            or2 = _mm256_or_si256(or2, _mm256_lddqu_si256((const __m256i *)(data + 32)));
+
+            data += 64;
+            len -= 64;
+        } while (len >= 64);
+
+        // 7-th bit of every byte should be 0
+        if (_mm256_movemask_epi8(_mm256_or_si256(or1, or2))) {
+            return false;
+        }
+    }
+
+    return validate_scalar(data, len);
+}
+
+bool validate(const uint8_t *data, size_t len) {
+    return validate_impl(data, len);
+}
+
+#else
+
+bool validate(const uint8_t *data, size_t len) {
+    return validate_scalar(data, len);
+}
+
+#endif
+
 } // namespace ascii
 
 } // namespace utils
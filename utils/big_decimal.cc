@@ -11,6 +11,8 @@
 #include "marshal_exception.hh"
 #include <seastar/core/print.hh>
 
+#include <array>
+#include <limits>
 #include <regex>
 
 #ifdef __clang__
@@ -185,6 +187,87 @@ big_decimal big_decimal::operator-(const big_decimal& other) const {
     return ret;
 }
 
+static std::optional<int64_t> to_int64(const boost::multiprecision::cpp_int& v) {
+    if (v < std::numeric_limits<int64_t>::min() || v > std::numeric_limits<int64_t>::max()) {
+        return std::nullopt;
+    }
+    return v.convert_to<int64_t>();
+}
+
+static boost::multiprecision::cpp_int to_cpp_int(__int128 v) {
+    if (v >= std::numeric_limits<int64_t>::min() && v <= std::numeric_limits<int64_t>::max()) {
+        return boost::multiprecision::cpp_int(int64_t(v));
+    }
+    unsigned __int128 m = v < 0 ? -static_cast<unsigned __int128>(v) : v;
+    boost::multiprecision::cpp_int ret(uint64_t(m >> 64));
+    ret <<= 64;
+    ret += uint64_t(m);
+    return v < 0 ? -ret : ret;
+}
+
+// Multiplies v by 10^by, returns false on overflow.
+static bool rescale(__int128& v, int64_t by) noexcept {
+    static constexpr auto pow10 = [] {
+        std::array<__int128, 39> ret;
+        ret[0] = 1;
+        for (size_t i = 1; i < ret.size(); i++) {
+            ret[i] = ret[i - 1] * 10;
+        }
+        return ret;
+    }();
+
+    if (v == 0) {
+        return true;
+    }
+    if (by >= int64_t(pow10.size())) {
+        return false;
+    }
+    return !__builtin_mul_overflow(v, pow10[by], &v);
+}
+
+bool big_decimal_sum::add_small(int32_t scale, __int128 v) noexcept {
+    __int128 sum = _small;
+    auto max_scale = std::max(_scale, scale);
+    if (!rescale(sum, int64_t(max_scale) - _scale) || !rescale(v, int64_t(max_scale) - scale)
+            || __builtin_add_overflow(sum, v, &sum)) {
+        return false;
+    }
+    _small = sum;
+    _scale = max_scale;
+    return true;
+}
+
+void big_decimal_sum::promote() {
+    _big.emplace(_scale, to_cpp_int(_small));
+}
+
+big_decimal_sum& big_decimal_sum::operator+=(const big_decimal& x) {
+    if (!_big) {
+        auto v = to_int64(x.unscaled_value());
+        if (v && add_small(x.scale(), *v)) {
+            return *this;
+        }
+        promote();
+    }
+    *_big += x;
+    return *this;
+}
+
+big_decimal_sum& big_decimal_sum::operator+=(const big_decimal_sum& x) {
+    if (!_big && !x._big && add_small(x._scale, x._small)) {
+        return *this;
+    }
+    if (!_big) {
+        promote();
+    }
+    *_big += x.get();
+    return *this;
+}
+
+big_decimal big_decimal_sum::get() const {
+    return _big ? *_big : big_decimal(_scale, to_cpp_int(_small));
+}
+
 big_decimal big_decimal::div(const ::uint64_t y, const rounding_mode mode) const
 {
     if (mode != rounding_mode::HALF_EVEN) {
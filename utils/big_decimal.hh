@@ -12,6 +12,7 @@
 #include <boost/multiprecision/cpp_int.hpp>
 #include <ostream>
 #include <compare>
+#include <optional>
 
 #include "bytes.hh"
 
@@ -54,3 +55,32 @@ class big_decimal {
 inline std::ostream& operator<<(std::ostream& s, const big_decimal& v) {
     return s << v.to_string();
 }
+
+// Accumulates a sum of decimals, as the sum() and avg() aggregates do.
+//
+// Most decimals have small unscaled values, and adding them as cpp_int-s
+// costs much more than the addition itself. So the sum is kept in a native
+// 128-bit integer, as long as the added values fit in 64 bits and neither
+// the rescaling nor the addition overflows. Otherwise the sum is promoted
+// to a big_decimal for good. The result is the same as of adding the values
+// to a big_decimal{}, including its scale.
+class big_decimal_sum {
+    int32_t _scale = 0;
+    __int128 _small = 0;
+    std::optional<big_decimal> _big;
+private:
+    bool add_small(int32_t scale, __int128 v) noexcept;
+    void promote();
+public:
+    big_decimal_sum() = default;
+    explicit big_decimal_sum(const big_decimal& x) {
+        *this += x;
+    }
+
+    big_decimal_sum& operator+=(const big_decimal& x);
+    big_decimal_sum& operator+=(const big_decimal_sum& x);
+
+    // Whether the sum is still kept in the native integer.
+    bool is_small() const noexcept { return !_big; }
+    big_decimal get() const;
+};
@@ -17,6 +17,7 @@
 #include <seastar/core/loop.hh>
 #include "utils/large_bitset.hh"
 #include <array>
+#include <cmath>
 #include <cstdlib>
 #include "bloom_filter.hh"
 
@@ -73,6 +74,100 @@ bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
 
+void bloom_filter::prefetch(hashed_key key) const {
+    auto& storage = _bitset.get_storage();
+    for_each_index(key, _hash_count, _bitset.size(), _format, [&storage] (auto i) {
+        __builtin_prefetch(&storage[i / std::numeric_limits<uint64_t>::digits]);
+        return stop_iteration::no;
+    });
+}
+
+// Odd constants used to derive the bit set in each word of a block from a
+// single 32-bit hash (as in Parquet's split block bloom filter).
+static constexpr std::array<uint32_t, split_block_bloom_filter::words_per_block> split_block_salts = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+static std::array<uint64_t, split_block_bloom_filter::words_per_block> split_block_mask(hashed_key key) noexcept {
+    auto h = uint32_t(key.hash()[1]);
+    std::array<uint64_t, split_block_bloom_filter::words_per_block> mask;
+    for (size_t i = 0; i < mask.size(); ++i) {
+        // The top 6 bits select one of the 64 bits of the word.
+        mask[i] = uint64_t(1) << ((h * split_block_salts[i]) >> 26);
+    }
+    return mask;
+}
+
+split_block_bloom_filter::split_block_bloom_filter(utils::chunked_vector<uint64_t> words)
+    : _words(std::move(words))
+    , _blocks(_words.size() / words_per_block)
+{
+    if (!_blocks || _words.size() % words_per_block) {
+        throw std::invalid_argument(format("split block bloom filter of {} words is not made of blocks of {} words", _words.size(), words_per_block));
+    }
+    _stats.memory_size += memory_size();
+}
+
+split_block_bloom_filter::~split_block_bloom_filter() noexcept {
+    _stats.memory_size -= memory_size();
+}
+
+const uint64_t* split_block_bloom_filter::block(hashed_key key) const noexcept {
+    // Maps the hash to [0, _blocks) without a division.
+    auto idx = uint64_t((unsigned __int128)key.hash()[0] * _blocks >> 64);
+    // Chunks of _words are a multiple of words_per_block, so a block is contiguous.
+    return &_words[idx * words_per_block];
+}
+
+void split_block_bloom_filter::add(const bytes_view& key) {
+    auto hk = make_hashed_key(key);
+    auto mask = split_block_mask(hk);
+    auto* b = block(hk);
+    for (size_t i = 0; i < words_per_block; ++i) {
+        b[i] |= mask[i];
+    }
+}
+
+bool split_block_bloom_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
+bool split_block_bloom_filter::is_present(hashed_key key) {
+    auto mask = split_block_mask(key);
+    auto* b = block(key);
+    uint64_t missing = 0;
+    for (size_t i = 0; i < words_per_block; ++i) {
+        missing |= ~b[i] & mask[i];
+    }
+    return !missing;
+}
+
+void split_block_bloom_filter::prefetch(hashed_key key) const {
+    __builtin_prefetch(block(key));
+}
+
+void split_block_bloom_filter::clear() {
+    for (auto& w : _words) {
+        w = 0;
+    }
+}
+
+size_t split_block_bloom_filter::words_for(int64_t num_elements, double max_false_pos_prob) {
+    // With one bit per word set by each of the words_per_block hashes, a word is
+    // a tiny bloom filter, for which bits per element = -k / ln(1 - p^(1/k)).
+    // Variance of the load of blocks is compensated for by the tighter target.
+    auto p = max_false_pos_prob * 0.8;
+    auto k = double(words_per_block);
+    auto bits = -k * double(std::max(num_elements, int64_t(1))) / std::log(1 - std::pow(p, 1 / k));
+    auto blocks = std::max<size_t>(1, std::ceil(bits / (words_per_block * std::numeric_limits<uint64_t>::digits)));
+    return blocks * words_per_block;
+}
+
+filter_ptr create_split_block_filter(utils::chunked_vector<uint64_t> words) {
+    return std::make_unique<split_block_bloom_filter>(std::move(words));
+}
+
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format) {
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
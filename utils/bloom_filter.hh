@@ -47,6 +47,8 @@ class bloom_filter: public i_filter {
 
     virtual bool is_present(hashed_key key) override;
 
+    virtual void prefetch(hashed_key key) const override;
+
     virtual void clear() override {
         _bitset.clear();
     }
@@ -60,6 +62,8 @@ class bloom_filter: public i_filter {
     static const stats& get_shard_stats() noexcept {
         return _shard_stats;
     }
+
+    friend class split_block_bloom_filter;
 };
 
 struct murmur3_bloom_filter: public bloom_filter {
@@ -69,6 +73,59 @@ struct murmur3_bloom_filter: public bloom_filter {
     {}
 };
 
+// A bloom filter made of cache-line-sized blocks (split block bloom filter).
+//
+// Each key maps to a single block of 8 64-bit words, and sets one bit in
+// each of them, so probing touches a single cache line, as opposed to one
+// cache line per hash function for bloom_filter. The probe is branch-free
+// over the 8 words, so that the compiler can vectorize it.
+//
+// The price is a slightly higher false positive rate for the same size, so
+// the filter is sized for the requested probability with a bit of slack.
+//
+// Persisted in the same Filter.db layout as bloom_filter, with the number
+// of hashes set to split_block_marker, which no bloom_filter can have.
+class split_block_bloom_filter: public i_filter {
+public:
+    static constexpr uint32_t split_block_marker = 0x53424246; // "SBBF"
+    static constexpr size_t words_per_block = 8;
+private:
+    utils::chunked_vector<uint64_t> _words;
+    size_t _blocks;
+    bloom_filter::stats& _stats = bloom_filter::_shard_stats;
+
+    const uint64_t* block(hashed_key key) const noexcept;
+    uint64_t* block(hashed_key key) noexcept {
+        return const_cast<uint64_t*>(std::as_const(*this).block(key));
+    }
+public:
+    explicit split_block_bloom_filter(utils::chunked_vector<uint64_t> words);
+    ~split_block_bloom_filter() noexcept;
+
+    const utils::chunked_vector<uint64_t>& words() const noexcept {
+        return _words;
+    }
+
+    virtual void add(const bytes_view& key) override;
+
+    virtual bool is_present(const bytes_view& key) override;
+
+    virtual bool is_present(hashed_key key) override;
+
+    virtual void prefetch(hashed_key key) const override;
+
+    virtual void clear() override;
+
+    virtual void close() override { }
+
+    virtual size_t memory_size() override {
+        return _words.memory_size();
+    }
+
+    // Returns the number of 64-bit words needed for num_elements with the given false positive probability.
+    static size_t words_for(int64_t num_elements, double max_false_pos_prob);
+};
+
 struct always_present_filter: public i_filter {
 
     virtual bool is_present(const bytes_view& key) override {
@@ -91,6 +148,7 @@ struct always_present_filter: public i_filter {
 };
 
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format);
+filter_ptr create_split_block_filter(utils::chunked_vector<uint64_t> words);
 filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter_format format);
 }
 }
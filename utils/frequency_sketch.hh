@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2022-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <seastar/core/bitops.hh>
+
+namespace utils {
+
+// Estimates how many times keys were seen recently, as used by the TinyLFU
+// admission policy.
+//
+// A count-min sketch of 4-bit counters: every key has one counter in each of
+// the rows, and its estimated frequency is the smallest of them. Once the
+// number of recorded events reaches the sample size, all counters are halved,
+// so that keys which stopped being accessed eventually fade away.
+//
+// Keys are expected to be well-distributed 64-bit hashes (e.g. tokens).
+class frequency_sketch {
+    static constexpr unsigned rows = 4;
+    static constexpr unsigned counters_per_word = 16;
+    static constexpr uint8_t max_count = 15;
+    static constexpr std::array<uint64_t, rows> seeds = {
+        0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL,
+    };
+
+    // rows * _width counters, row after row.
+    std::vector<uint64_t> _table;
+    uint64_t _width;
+    uint64_t _sample_size;
+    uint64_t _additions = 0;
+private:
+    uint64_t counter_index(uint64_t hash, unsigned row) const noexcept {
+        auto h = (hash ^ (hash >> 29)) * seeds[row];
+        return row * _width + ((h >> 32) & (_width - 1));
+    }
+
+    uint8_t get(uint64_t idx) const noexcept {
+        return (_table[idx / counters_per_word] >> (idx % counters_per_word * 4)) & 0xf;
+    }
+
+    void reset() noexcept {
+        for (auto& w : _table) {
+            w = (w >> 1) & 0x7777777777777777ULL;
+        }
+        _additions /= 2;
+    }
+public:
+    // Sized for tracking about `capacity` distinct keys.
+    explicit frequency_sketch(size_t capacity)
+        : _width(std::max<uint64_t>(counters_per_word, 1ULL << log2ceil(std::max<size_t>(capacity, 1))))
+        , _sample_size(_width * 10)
+    {
+        _table.resize(rows * _width / counters_per_word);
+    }
+
+    // Records an occurrence of the key.
+    void increment(uint64_t hash) noexcept {
+        bool added = false;
+        for (unsigned row = 0; row < rows; ++row) {
+            auto idx = counter_index(hash, row);
+            if (get(idx) < max_count) {
+                _table[idx / counters_per_word] += uint64_t(1) << (idx % counters_per_word * 4);
+                added = true;
+            }
+        }
+        if (added && ++_additions >= _sample_size) {
+            reset();
+        }
+    }
+
+    // Returns the estimated number of recent occurrences of the key, at most 15.
+    uint8_t estimate(uint64_t hash) const noexcept {
+        uint8_t ret = max_count;
+        for (unsigned row = 0; row < rows; ++row) {
+            ret = std::min(ret, get(counter_index(hash, row)));
+        }
+        return ret;
+    }
+
+    size_t memory_usage() const noexcept {
+        return _table.size() * sizeof(uint64_t);
+    }
+};
+
+}
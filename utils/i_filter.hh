@@ -20,6 +20,8 @@ using filter_ptr = std::unique_ptr<i_filter>;
 enum class filter_format {
     k_l_format,
     m_format,
+    // Split block bloom filter, see filter::split_block_bloom_filter.
+    split_block,
 };
 
 class hashed_key {
@@ -40,6 +42,9 @@ struct i_filter {
     virtual void add(const bytes_view& key) = 0;
     virtual bool is_present(const bytes_view& key) = 0;
     virtual bool is_present(hashed_key) = 0;
+    // Hints that is_present(key) is about to be called, so that memory it
+    // touches can be fetched in parallel with probes of other filters.
+    virtual void prefetch(hashed_key) const {}
     virtual void clear() = 0;
     virtual void close() = 0;
 
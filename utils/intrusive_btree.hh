@@ -11,10 +11,12 @@
 #include <boost/intrusive/parent_from_member.hpp>
 #include <seastar/util/alloc_failure_injector.hh>
 #include <cassert>
+#include <optional>
 #include <fmt/core.h>
 #include "utils/collection-concepts.hh"
 #include "utils/neat-object-id.hh"
 #include "utils/allocation_strategy.hh"
+#include "utils/array-search.hh"
 
 namespace intrusive_b {
 
@@ -34,6 +36,30 @@ concept KeyPointer = std::is_nothrow_move_constructible_v<Pointer> &&
     requires (Pointer p) { { *p } -> std::same_as<T&>; } &&
     requires (Pointer p) { { p.release() } noexcept -> std::same_as<T*>; };
 
+/*
+ * A key can provide a fixed-width prefix of itself. If it does, the
+ * nodes keep the prefixes of their keys next to the pointers on them
+ * and narrow down the search by comparing the prefixes, without touching
+ * the keys' memory.
+ *
+ * The prefixes are only used if the compare also provides the prefix
+ * of the key being searched. It may return a disengaged optional, if
+ * the prefixes don't follow the order it defines, e.g. because the
+ * order depends on the schema.
+ *
+ * When used, the prefixes must be monotonic: for keys a < b it should
+ * hold that a.key_prefix() <= b.key_prefix() (unsigned).
+ */
+template <typename Key>
+concept WithKeyPrefix = requires (const Key& k) {
+    { k.key_prefix() } noexcept -> std::same_as<uint64_t>;
+};
+
+template <typename Compare, typename K>
+concept CompareWithKeyPrefix = requires (const Compare& c, const K& k) {
+    { c.key_prefix(k) } noexcept -> std::same_as<std::optional<uint64_t>>;
+};
+
 enum class with_debug { no, yes };
 enum class key_search { linear, binary, both };
 
@@ -74,6 +100,13 @@ class node_base {
      */
     member_hook* keys[0];
 
+    /*
+     * Nodes with keys providing prefixes keep them right after the
+     * pointers, see node::__room_for_keys. Not for the inline node.
+     */
+    uint64_t* key_prefixes() noexcept { return reinterpret_cast<uint64_t*>(&keys[capacity]); }
+    const uint64_t* key_prefixes() const noexcept { return reinterpret_cast<const uint64_t*>(&keys[capacity]); }
+
     static constexpr unsigned short NODE_ROOT = 0x1;
     static constexpr unsigned short NODE_LEAF = 0x2;
     static constexpr unsigned short NODE_LEFTMOST = 0x4; // leaf with smallest keys in the tree
@@ -320,6 +353,9 @@ class tree {
     void break_inline() {
         node* n = node::create_empty_root();
         _inline.keys[0]->attach_first(n->_base);
+        if constexpr (WithKeyPrefix<Key>) {
+            n->_base.key_prefixes()[0] = _inline.keys[0]->template to_key<Key, Hook>()->key_prefix();
+        }
         do_set_root(*n);
         do_set_left(*n);
         do_set_right(*n);
@@ -824,6 +860,23 @@ class tree {
                 return nullptr;
             }
         }
+
+        /*
+         * Returns pointer on the owning tree, found by walking up to the root.
+         */
+        tree_ptr owning_tree() noexcept {
+            node_base* n = revalidate();
+
+            if (n->is_inline()) {
+                return tree::from_inline(n);
+            }
+
+            node_ptr nd = node::from_base(n);
+            while (!nd->is_root()) {
+                nd = nd->_parent.n;
+            }
+            return nd->_parent.t;
+        }
     };
 
     using iterator_base_const = iterator_base<true>;
@@ -1032,19 +1085,41 @@ class tree {
  * The ge() method accepts sorted array of keys and searches the index of the
  * lower-bound element of the given key. The bool match is set to true if the
  * key matched, to false otherwise.
+ *
+ * If the node keeps the keys' prefixes, the search is first narrowed down to
+ * the keys with the same prefix as the given one. All the keys on the left of
+ * them are less and all on the right are greater than the given key, so the
+ * keys themselves are only compared within this range, if it's not empty.
  */
 
+template <typename K, typename Key, typename Compare>
+inline bool narrow_by_prefix(const K& k, const node_base& node, const Compare& cmp, key_index& s, key_index& e) noexcept {
+    if constexpr (WithKeyPrefix<Key> && CompareWithKeyPrefix<Compare, K>) {
+        if (auto kp = cmp.key_prefix(k)) {
+            auto r = utils::array_search_eq_range(*kp, node.key_prefixes(), node.num_keys);
+            s = r.first;
+            e = r.second;
+            return true;
+        }
+    }
+    return false;
+}
+
 template <typename K, typename Key, member_hook Key::* Hook, typename Compare, key_search Search>
 struct searcher { };
 
 template <typename K, typename Key, member_hook Key::* Hook, typename Compare>
 struct searcher<K, Key, Hook, Compare, key_search::linear> {
     static key_index ge(const K& k, const node_base& node, const Compare& cmp, bool& match) {
-        key_index i;
+        key_index i = 0, end = node.num_keys;
 
         match = false;
-        for (i = 0; i < node.num_keys; i++) {
-            if (i + 1 < node.num_keys) {
+        if (narrow_by_prefix<K, Key>(k, node, cmp, i, end) && i == end) {
+            return i;
+        }
+
+        for (; i < end; i++) {
+            if (i + 1 < end) {
                 __builtin_prefetch(node.keys[i + 1]->to_key<Key, Hook>());
             }
             auto x = cmp(k, *node.keys[i]->to_key<Key, Hook>());
@@ -1061,7 +1136,14 @@ struct searcher<K, Key, Hook, Compare, key_search::linear> {
 template <typename K, typename Key, member_hook Key::* Hook, typename Compare>
 struct searcher<K, Key, Hook, Compare, key_search::binary> {
     static key_index ge(const K& k, const node_base& node, const Compare& cmp, bool& match) {
-        ssize_t s = 0, e = node.num_keys - 1; // signed for below s <= e corner cases
+        key_index lo = 0, hi = node.num_keys;
+
+        if (narrow_by_prefix<K, Key>(k, node, cmp, lo, hi) && lo == hi) {
+            match = false;
+            return lo;
+        }
+
+        ssize_t s = lo, e = ssize_t(hi) - 1; // signed for below s <= e corner cases
 
         while (s <= e) {
             key_index i = (s + e) / 2;
@@ -1149,9 +1231,11 @@ class node {
     /*
      * The node_base has keys[] field of zero size at the end, because it should
      * be NodeSize-agnostic. Thus the real memory for key's pointers is reserved
-     * here.
+     * here, followed by the memory for keys' prefixes, if the key has them.
      */
-    char __room_for_keys[NodeSize * sizeof(member_hook*)];
+    static constexpr bool with_prefixes = WithKeyPrefix<Key>;
+    static constexpr size_t key_slot_size = sizeof(member_hook*) + (with_prefixes ? sizeof(uint64_t) : 0);
+    char __room_for_keys[NodeSize * key_slot_size];
     static_assert(offsetof(node_base, keys[NodeSize]) == sizeof(node_base) + NodeSize * sizeof(member_hook*));
 
     /*
@@ -1190,6 +1274,7 @@ class node {
      *  _base.flags    (short)
      *  ...            (int compiler's alignment gap)
      *  _base.keys     (N pointers, thanks to __room_for_keys)
+     *  prefixes       (N uint64_t-s, if the key has them)
      *  _leaf_tree     (pointer)
      */
     static constexpr size_t leaf_node_size = sizeof(node);
@@ -1202,6 +1287,7 @@ class node {
      *  _base.flags    (short)
      *  ...            (int compiler's alignment gap)
      *  _base.keys     (N pointers)
+     *  prefixes       (N uint64_t-s, if the key has them)
      *  _kids          (N + 1 pointers)
      */
     static constexpr size_t inner_node_size = sizeof(node) - sizeof(tree*) + (NodeSize + 1) * sizeof(node*);
@@ -1215,9 +1301,10 @@ class node {
      *  _base.capacity (short)
      *  ...            (short compiler's alignment gap)
      *  _base.keys     (.capacity pointers)
+     *  prefixes       (.capacity uint64_t-s, if the key has them)
      */
     static size_t linear_node_size(size_t cap) {
-        return sizeof(node) - sizeof(tree*) - NodeSize * sizeof(member_hook*) + cap * sizeof(member_hook*);
+        return sizeof(node) - sizeof(tree*) - NodeSize * key_slot_size + cap * key_slot_size;
     }
 
 private:
@@ -1232,6 +1319,9 @@ class node {
     // ... locally
     void move_key(key_index f, key_index t) noexcept {
         _base.keys[t] = _base.keys[f];
+        if constexpr (with_prefixes) {
+            _base.key_prefixes()[t] = _base.key_prefixes()[f];
+        }
     }
     void move_kid(kid_index f, kid_index t) noexcept {
         _kids[t] = _kids[f];
@@ -1240,6 +1330,9 @@ class node {
     void set_key(key_index idx, member_hook* hook) noexcept {
         _base.keys[idx] = hook;
         hook->_node = &_base;
+        if constexpr (with_prefixes) {
+            _base.key_prefixes()[idx] = hook->to_key<Key, Hook>()->key_prefix();
+        }
     }
     void set_kid(kid_index idx, node* n) noexcept {
         _kids[idx] = n;
@@ -1248,7 +1341,12 @@ class node {
 
     // ... to other nodes
     void move_key(key_index f, node& n, key_index t) noexcept {
-        n.set_key(t, _base.keys[f]);
+        member_hook* hook = _base.keys[f];
+        n._base.keys[t] = hook;
+        hook->_node = &n._base;
+        if constexpr (with_prefixes) {
+            n._base.key_prefixes()[t] = _base.key_prefixes()[f];
+        }
     }
     void move_kid(kid_index f, node& n, kid_index t) noexcept {
         n.set_kid(t, _kids[f]);
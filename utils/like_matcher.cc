@@ -12,6 +12,8 @@
 
 #include <boost/regex/icu.hpp>
 #include <boost/locale/encoding.hpp>
+#include <cstring>
+#include <optional>
 #include <string>
 
 namespace {
@@ -75,18 +77,69 @@ wstring regex_from_pattern(bytes_view pattern) {
     return re;
 }
 
+/// The most common patterns, which don't need a regex: a literal, optionally preceded
+/// and/or followed by '%'.
+struct simple_pattern {
+    enum class kind { exact, prefix, suffix, contains };
+    kind type;
+    bytes literal;
+};
+
+/// Returns the simple form of the given LIKE pattern, if it has one.
+///
+/// Works on the bytes of the pattern, as all the special characters are ASCII, and the
+/// literal is matched bytewise, which is the same as matching it character by character
+/// in a valid UTF-8 text.
+std::optional<simple_pattern> simple_pattern_from(bytes_view pattern) {
+    bool leading_percent = false;
+    bool trailing_percent = false;
+    bytes literal;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        auto c = pattern[i];
+        if (c == '_') {
+            return std::nullopt;
+        } else if (c == '%') {
+            if (literal.empty()) {
+                leading_percent = true;
+            } else {
+                trailing_percent = true;
+            }
+            continue;
+        } else if (trailing_percent) {
+            // Something follows a '%' which follows the literal.
+            return std::nullopt;
+        }
+        // A backslash at the end matches verbatim, see regex_from_pattern().
+        if (c == '\\' && i + 1 < pattern.size()) {
+            c = pattern[++i];
+        }
+        literal.push_back(c);
+    }
+    if (literal.empty()) {
+        // Either "", which only matches the empty text, or a run of '%', matching anything.
+        return simple_pattern{leading_percent ? simple_pattern::kind::prefix : simple_pattern::kind::exact, std::move(literal)};
+    }
+    using kind = simple_pattern::kind;
+    auto type = leading_percent ? (trailing_percent ? kind::contains : kind::suffix) : (trailing_percent ? kind::prefix : kind::exact);
+    return simple_pattern{type, std::move(literal)};
+}
+
 } // anonymous namespace
 
 class like_matcher::impl {
     bytes _pattern;
-    boost::u32regex _re; // Performs pattern matching.
+    std::optional<simple_pattern> _simple; // Performs pattern matching, if set.
+    boost::u32regex _re; // Performs pattern matching otherwise.
   public:
     explicit impl(bytes_view pattern);
     bool operator()(bytes_view text) const;
     void reset(bytes_view pattern);
   private:
     void init_re() {
-        _re = boost::make_u32regex(regex_from_pattern(_pattern), boost::u32regex::basic | boost::u32regex::optimize);
+        _simple = simple_pattern_from(_pattern);
+        if (!_simple) {
+            _re = boost::make_u32regex(regex_from_pattern(_pattern), boost::u32regex::basic | boost::u32regex::optimize);
+        }
     }
 };
 
@@ -95,6 +148,20 @@ like_matcher::impl::impl(bytes_view pattern) : _pattern(pattern) {
 }
 
 bool like_matcher::impl::operator()(bytes_view text) const {
+    if (_simple) {
+        bytes_view literal = _simple->literal;
+        switch (_simple->type) {
+        case simple_pattern::kind::exact:
+            return text == literal;
+        case simple_pattern::kind::prefix:
+            return text.starts_with(literal);
+        case simple_pattern::kind::suffix:
+            return text.ends_with(literal);
+        case simple_pattern::kind::contains:
+            // glibc's memmem() is vectorized, unlike a search through the regex engine.
+            return ::memmem(text.data(), text.size(), literal.data(), literal.size()) != nullptr;
+        }
+    }
     return boost::u32regex_match(text.begin(), text.end(), _re);
 }
 
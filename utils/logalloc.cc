@@ -14,6 +14,7 @@
 #include <boost/intrusive/slist.hpp>
 #include <boost/range/adaptors.hpp>
 #include <stack>
+#include <array>
 
 #include <seastar/core/memory.hh>
 #include <seastar/core/align.hh>
@@ -368,13 +369,15 @@ class background_reclaimer {
     timer<lowres_clock> _adjust_shares_timer;
     // If engaged, main loop is not running, set_value() to wake it.
     promise<>* _main_loop_wait = nullptr;
+    // Free memory the reclaimer keeps ready ahead of allocations, so that
+    // they don't have to reclaim it synchronously.
+    size_t _free_memory_threshold;
     future<> _done;
     bool _stopping = false;
-    static constexpr size_t free_memory_threshold = 60'000'000;
 private:
     bool have_work() const {
 #ifndef SEASTAR_DEFAULT_ALLOCATOR
-        return memory::free_memory() < free_memory_threshold;
+        return memory::free_memory() < _free_memory_threshold;
 #else
         return false;
 #endif
@@ -400,14 +403,14 @@ class background_reclaimer {
             if (_stopping) {
                 break;
             }
-            _reclaim(free_memory_threshold - memory::free_memory());
+            _reclaim(_free_memory_threshold - memory::free_memory());
             co_await coroutine::maybe_yield();
         }
         llogger.debug("background_reclaimer::main_loop: exit");
     }
     void adjust_shares() {
         if (have_work()) {
-            auto shares = 1 + (1000 * (free_memory_threshold - memory::free_memory())) / free_memory_threshold;
+            auto shares = 1 + (1000 * (_free_memory_threshold - memory::free_memory())) / _free_memory_threshold;
             _sg.set_shares(shares);
             llogger.trace("background_reclaimer::adjust_shares: {}", shares);
             if (_main_loop_wait) {
@@ -416,10 +419,11 @@ class background_reclaimer {
         }
     }
 public:
-    explicit background_reclaimer(scheduling_group sg, noncopyable_function<void (size_t target)> reclaim)
+    explicit background_reclaimer(scheduling_group sg, size_t free_memory_threshold, noncopyable_function<void (size_t target)> reclaim)
             : _sg(sg)
             , _reclaim(std::move(reclaim))
             , _adjust_shares_timer(default_scheduling_group(), [this] { adjust_shares(); })
+            , _free_memory_threshold(std::max(free_memory_threshold, size_t(1)))
             , _done(with_scheduling_group(_sg, [this] { return main_loop(); })) {
         if (sg != default_scheduling_group()) {
             _adjust_shares_timer.arm_periodic(50ms);
@@ -445,6 +449,14 @@ class tracker::impl {
     bool _abort_on_bad_alloc = false;
     bool _sanitizer_report_backtrace = false;
     reclaim_timer* _active_timer = nullptr;
+    // Enough for every operation in every scheduling group, so that
+    // accounting a reclamation never allocates.
+    static constexpr size_t max_reclaim_sites = 256;
+    std::array<tracker::reclaim_stats, max_reclaim_sites> _reclaim_sites;
+    size_t _reclaim_sites_used = 0;
+    // Reclamation requested by the allocator, which allocations wait for.
+    uint64_t _synchronous_reclaims = 0;
+    uint64_t _memory_reclaimed_in_background = 0;
 private:
     // Prevents tracker's reclaimer from running while live. Reclaimer may be
     // invoked synchronously with allocator. This guard ensures that this
@@ -503,12 +515,13 @@ class tracker::impl {
     // Abort on allocation failure from LSA
     void enable_abort_on_bad_alloc() noexcept { _abort_on_bad_alloc = true; }
     bool should_abort_on_bad_alloc() const noexcept { return _abort_on_bad_alloc; }
-    void setup_background_reclaim(scheduling_group sg) {
+    void setup_background_reclaim(scheduling_group sg, size_t free_memory_threshold) {
         assert(!_background_reclaimer);
-        _background_reclaimer.emplace(sg, [this] (size_t target) {
-            reclaim(target, is_preemptible::yes);
+        _background_reclaimer.emplace(sg, free_memory_threshold, [this] (size_t target) {
+            _memory_reclaimed_in_background += reclaim(target, is_preemptible::yes);
         });
     }
+    void on_synchronous_reclaim() noexcept { ++_synchronous_reclaims; }
     // const bool&, so interested parties can save a reference and see updates.
     const bool& sanitizer_report_backtrace() const { return _sanitizer_report_backtrace; }
     void set_sanitizer_report_backtrace(bool rb) { _sanitizer_report_backtrace = rb; }
@@ -526,6 +539,23 @@ class tracker::impl {
         }
         return false;
     }
+    void on_reclaim(const char* operation, std::chrono::microseconds duration, bool stall, size_t memory_released, const tracker::stats& diff) noexcept;
+    std::vector<tracker::reclaim_stats> reclaim_statistics() const {
+        return {_reclaim_sites.begin(), _reclaim_sites.begin() + _reclaim_sites_used};
+    }
+    tracker::reclaim_stats reclaim_statistics(std::string_view operation) const noexcept {
+        tracker::reclaim_stats ret;
+        for (size_t i = 0; i < _reclaim_sites_used; ++i) {
+            auto& s = _reclaim_sites[i];
+            if (s.operation == operation) {
+                ret.count += s.count;
+                ret.stalls += s.stalls;
+                ret.total_time += s.total_time;
+                ret.max_time = std::max(ret.max_time, s.max_time);
+            }
+        }
+        return ret;
+    }
 private:
     // Like compact_and_evict() but assumes that reclaim_lock is held around the operation.
     size_t compact_and_evict_locked(size_t reserve_segments, size_t bytes, is_preemptible preempt);
@@ -724,6 +754,8 @@ class segment_store_backend {
 // Segments are allocated from the seastar allocator.
 // The entire memory area of the local shard is used as a segment store, i.e.
 // segments are allocated from the same memory area regular objeces are.
+// That area is bound to the NUMA node of the shard, and backed by huge pages
+// when seastar runs with --hugepages, so segments inherit both.
 class seastar_memory_segment_store_backend : public segment_store_backend {
 public:
     seastar_memory_segment_store_backend()
@@ -754,16 +786,31 @@ class standard_memory_segment_store_backend : public segment_store_backend {
     size_t _available_segments; // for fast free_memory()
 
 private:
+    static constexpr size_t huge_page_size = 2 << 20;
+
+    // Segments are traversed by cache readers all over, so back the area with
+    // huge pages to cut on TLB misses. Huge pages reserved up front are preferred,
+    // as transparent huge pages are only a hint to the kernel. The mapping is
+    // reserved whole, so that faulting it in can't fail later on.
+    // Pages are placed on the NUMA node of the thread which touches them first,
+    // which is the one of the shard allocating segments from the area.
     static memory::memory_layout allocate_memory(size_t segments) {
-        const auto size = segments * segment_size;
+        const auto size = align_up(segments * segment_size, huge_page_size);
         auto p = mmap(nullptr, size,
                 PROT_READ | PROT_WRITE,
-                MAP_PRIVATE | MAP_ANONYMOUS,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
                 -1, 0);
         if (p == MAP_FAILED) {
-            std::abort();
+            p = mmap(nullptr, size,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS,
+                    -1, 0);
+            if (p == MAP_FAILED) {
+                std::abort();
+            }
+            madvise(p, size, MADV_HUGEPAGE);
+            llogger.debug("huge pages are not reserved, backing the segment pool with transparent huge pages");
         }
-        madvise(p, size, MADV_HUGEPAGE);
         auto start = reinterpret_cast<uintptr_t>(p);
         return {start, start + size};
     }
@@ -1194,6 +1241,34 @@ tracker::stats tracker::statistics() const {
     return _impl->segment_pool().statistics();
 }
 
+std::vector<tracker::reclaim_stats> tracker::reclaim_statistics() const {
+    return _impl->reclaim_statistics();
+}
+
+void tracker::impl::on_reclaim(const char* operation, std::chrono::microseconds duration, bool stall, size_t memory_released, const tracker::stats& diff) noexcept {
+    auto sg = current_scheduling_group();
+    auto end = _reclaim_sites.begin() + _reclaim_sites_used;
+    auto it = std::find_if(_reclaim_sites.begin(), end, [&] (const tracker::reclaim_stats& s) {
+        return s.group == sg && std::string_view(s.operation) == operation;
+    });
+    if (it == end) {
+        if (_reclaim_sites_used == max_reclaim_sites) {
+            return;
+        }
+        ++_reclaim_sites_used;
+        it->operation = operation;
+        it->group = sg;
+    }
+    ++it->count;
+    it->stalls += stall;
+    it->total_time += duration;
+    it->max_time = std::max(it->max_time, duration);
+    it->memory_released += memory_released;
+    it->segments_compacted += diff.segments_compacted;
+    it->memory_compacted += diff.memory_compacted;
+    it->memory_evicted += diff.memory_evicted;
+}
+
 size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
     // Reclaimer tries to release segments occupying lower parts of the address
     // space.
@@ -1481,9 +1556,10 @@ reclaim_timer::~reclaim_timer() {
 
     _duration = clock::now() - _start;
     _stall_detected = _duration >= _duration_threshold;
+    sample_stats(_end_stats);
+    _stat_diff = _end_stats - _start_stats;
+    _tracker.on_reclaim(_name, std::chrono::duration_cast<std::chrono::microseconds>(_duration), _stall_detected, _memory_released, _stat_diff.pool_stats);
     if (_debug_enabled || _stall_detected) {
-        sample_stats(_end_stats);
-        _stat_diff = _end_stats - _start_stats;
         report();
     }
 }
@@ -2314,11 +2390,12 @@ void tracker::configure(const config& cfg) {
     if (cfg.abort_on_lsa_bad_alloc) {
         _impl->enable_abort_on_bad_alloc();
     }
-    _impl->setup_background_reclaim(cfg.background_reclaim_sched_group);
+    _impl->setup_background_reclaim(cfg.background_reclaim_sched_group, cfg.background_reclaim_free_memory_threshold);
     _impl->set_sanitizer_report_backtrace(cfg.sanitizer_report_backtrace);
 }
 
 memory::reclaiming_result tracker::reclaim(seastar::memory::reclaimer::request r) {
+    _impl->on_synchronous_reclaim();
     return reclaim(std::max(r.bytes_to_reclaim, _impl->reclamation_step() * segment::size))
            ? memory::reclaiming_result::reclaimed_something
            : memory::reclaiming_result::reclaimed_nothing;
@@ -2804,7 +2881,27 @@ tracker::impl::impl() : _segment_pool(std::make_unique<logalloc::segment_pool>(*
 
         sm::make_counter("memory_freed", [this] { return _segment_pool->statistics().memory_freed; },
                         sm::description("Counts number of bytes which were requested to be freed in LSA.")),
+        sm::make_counter("synchronous_reclaims", [this] { return _synchronous_reclaims; },
+                        sm::description("Counts the reclamations requested by the allocator, which allocations had to wait for. "
+                                        "The background reclaimer reclaims ahead of allocations to keep this low.")),
+        sm::make_counter("memory_reclaimed_in_background", [this] { return _memory_reclaimed_in_background; },
+                        sm::description("Counts number of bytes reclaimed by the background reclaimer, ahead of allocations.")),
     });
+
+    // The reclaim_timer operations.
+    for (const char* operation : {"reclaim_segments", "reclaim", "compact", "evict"}) {
+        auto op_label = sm::label("operation");
+        _metrics.add_group("lsa", {
+            sm::make_counter("reclaim_operations", [this, operation] { return reclaim_statistics(operation).count; },
+                            sm::description("Counts the reclamation operations."), {op_label(operation)}),
+            sm::make_counter("reclaim_stalls", [this, operation] { return reclaim_statistics(operation).stalls; },
+                            sm::description("Counts the reclamation operations which took long enough to stall the reactor."), {op_label(operation)}),
+            sm::make_counter("reclaim_time_us", [this, operation] { return reclaim_statistics(operation).total_time.count(); },
+                            sm::description("Counts the time spent in reclamation operations, in microseconds."), {op_label(operation)}),
+            sm::make_gauge("reclaim_max_time_us", [this, operation] { return reclaim_statistics(operation).max_time.count(); },
+                            sm::description("Holds the longest reclamation operation, in microseconds."), {op_label(operation)}),
+        });
+    }
 }
 
 tracker::impl::~impl() {
@@ -63,6 +63,8 @@ class tracker {
         bool sanitizer_report_backtrace = false; // Better reports but slower
         size_t lsa_reclamation_step;
         scheduling_group background_reclaim_sched_group;
+        // The background reclaimer runs while free memory is below this threshold.
+        size_t background_reclaim_free_memory_threshold = 60'000'000;
     };
 
     struct stats {
@@ -103,6 +105,25 @@ class tracker {
         }
     };
 
+    // The reclamation done by one operation of the tracker (e.g. "compact" or
+    // "evict") in one scheduling group, which tells what the memory was
+    // reclaimed for, e.g. a memtable flush or a read. Nested operations are
+    // accounted to the outermost one. Times are measured with a coarse clock,
+    // so short operations may be accounted as taking no time.
+    struct reclaim_stats {
+        const char* operation = nullptr;
+        scheduling_group group;
+        uint64_t count = 0;
+        // Operations which took long enough to be reported as stalls.
+        uint64_t stalls = 0;
+        std::chrono::microseconds total_time{0};
+        std::chrono::microseconds max_time{0};
+        uint64_t memory_released = 0;
+        size_t segments_compacted = 0;
+        uint64_t memory_compacted = 0;
+        uint64_t memory_evicted = 0;
+    };
+
     void configure(const config& cfg);
     future<> stop();
 
@@ -119,6 +140,8 @@ class tracker {
 
     stats statistics() const;
 
+    std::vector<reclaim_stats> reclaim_statistics() const;
+
     //
     // Tries to reclaim given amount of bytes in total using all compactible
     // and evictable regions. Returns the number of bytes actually reclaimed.
@@ -38,6 +38,12 @@ class evictable {
 
     virtual void on_evicted() noexcept = 0;
 
+    // Called when the element is at the front of the LRU, about to be evicted.
+    // Returning true spares it, moving it to the back of the LRU instead.
+    virtual bool spare_from_eviction() noexcept {
+        return false;
+    }
+
     bool is_linked() const {
         return _lru_link.is_linked();
     }
@@ -54,9 +60,13 @@ class lru {
         boost::intrusive::member_hook<evictable, evictable::lru_link_type, &evictable::_lru_link>,
         boost::intrusive::constant_time_size<false>>; // we need this to have bi::auto_unlink on hooks.
     lru_type _list;
+    uint64_t _spared = 0;
 public:
     using reclaiming_result = seastar::memory::reclaiming_result;
 
+    // Bounds the work of a single evict() when many elements ask to be spared.
+    static constexpr unsigned max_spared_per_eviction = 32;
+
     ~lru() {
         _list.clear_and_dispose([] (evictable* e) {
             e->on_evicted();
@@ -81,12 +91,26 @@ class lru {
         if (_list.empty()) {
             return reclaiming_result::reclaimed_nothing;
         }
+        for (unsigned i = 0; i < max_spared_per_eviction; ++i) {
+            evictable& e = _list.front();
+            if (!e.spare_from_eviction()) {
+                break;
+            }
+            _list.pop_front();
+            _list.push_back(e);
+            ++_spared;
+        }
         evictable& e = _list.front();
         _list.pop_front();
         e.on_evicted();
         return reclaiming_result::reclaimed_something;
     }
 
+    // Number of times an element was spared from eviction.
+    uint64_t spared() const noexcept {
+        return _spared;
+    }
+
     // Evicts all elements.
     // May stall the reactor, use only in tests.
     void evict_all() {
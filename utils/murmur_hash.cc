@@ -11,6 +11,9 @@
 
 #include "murmur_hash.hh"
 
+#include <algorithm>
+#include <limits>
+
 namespace utils {
 
 namespace murmur_hash {
@@ -142,24 +145,21 @@ static inline uint64_t getblock(bytes_view key, uint32_t index)
             | (uint64_t(p[7]) << 56);
 }
 
-void hash3_x64_128(bytes_view key, uint64_t seed, std::array<uint64_t,2> &result)
-{
-    uint32_t length = key.size();
-    const uint32_t nblocks = length >> 4; // Process as 128-bit blocks.
+namespace {
 
-    uint64_t h1 = seed;
-    uint64_t h2 = seed;
+struct hash3_state {
+    uint64_t h1;
+    uint64_t h2;
 
-    uint64_t c1 = 0x87c37b91114253d5L;
-    uint64_t c2 = 0x4cf5ad432745937fL;
+    static constexpr uint64_t c1 = 0x87c37b91114253d5L;
+    static constexpr uint64_t c2 = 0x4cf5ad432745937fL;
 
-    //----------
-    // body
+    explicit hash3_state(uint64_t seed) : h1(seed), h2(seed) {}
 
-    for(uint32_t i = 0; i < nblocks; i++)
-    {
-        uint64_t k1 = getblock(key, i*2+0);
-        uint64_t k2 = getblock(key, i*2+1);
+    // Mixes in the index-th 128-bit block of the key.
+    void block(bytes_view key, uint32_t index) {
+        uint64_t k1 = getblock(key, index*2+0);
+        uint64_t k2 = getblock(key, index*2+1);
 
         k1 *= c1; k1 = rotl64(k1,31); k1 *= c2; h1 ^= k1;
 
@@ -170,52 +170,101 @@ void hash3_x64_128(bytes_view key, uint64_t seed, std::array<uint64_t,2> &result
         h2 = rotl64(h2,31); h2 += h1; h2 = h2*5+0x38495ab5;
     }
 
-    //----------
-    // tail
-
-    // Advance offset to the unprocessed tail of the data.
-    key.remove_prefix(nblocks * 16);
+    // Mixes in the bytes past the last whole block, and finalizes the hash.
+    void finish(bytes_view key, std::array<uint64_t,2>& result) {
+        uint32_t length = key.size();
+        key.remove_prefix((length >> 4) * 16);
 
-    uint64_t k1 = 0;
-    uint64_t k2 = 0;
+        uint64_t k1 = 0;
+        uint64_t k2 = 0;
 
-    switch (length & 15)
-    {
-    case 15: k2 ^= ((uint64_t) key[14]) << 48;
-    case 14: k2 ^= ((uint64_t) key[13]) << 40;
-    case 13: k2 ^= ((uint64_t) key[12]) << 32;
-    case 12: k2 ^= ((uint64_t) key[11]) << 24;
-    case 11: k2 ^= ((uint64_t) key[10]) << 16;
-    case 10: k2 ^= ((uint64_t) key[9]) << 8;
-    case  9: k2 ^= ((uint64_t) key[8]) << 0;
-        k2 *= c2; k2  = rotl64(k2,33); k2 *= c1; h2 ^= k2;
-    case  8: k1 ^= ((uint64_t) key[7]) << 56;
-    case  7: k1 ^= ((uint64_t) key[6]) << 48;
-    case  6: k1 ^= ((uint64_t) key[5]) << 40;
-    case  5: k1 ^= ((uint64_t) key[4]) << 32;
-    case  4: k1 ^= ((uint64_t) key[3]) << 24;
-    case  3: k1 ^= ((uint64_t) key[2]) << 16;
-    case  2: k1 ^= ((uint64_t) key[1]) << 8;
-    case  1: k1 ^= ((uint64_t) key[0]);
-        k1 *= c1; k1  = rotl64(k1,31); k1 *= c2; h1 ^= k1;
-    };
-
-    //----------
-    // finalization
-
-    h1 ^= length; h2 ^= length;
+        switch (length & 15)
+        {
+        case 15: k2 ^= ((uint64_t) key[14]) << 48;
+        case 14: k2 ^= ((uint64_t) key[13]) << 40;
+        case 13: k2 ^= ((uint64_t) key[12]) << 32;
+        case 12: k2 ^= ((uint64_t) key[11]) << 24;
+        case 11: k2 ^= ((uint64_t) key[10]) << 16;
+        case 10: k2 ^= ((uint64_t) key[9]) << 8;
+        case  9: k2 ^= ((uint64_t) key[8]) << 0;
+            k2 *= c2; k2  = rotl64(k2,33); k2 *= c1; h2 ^= k2;
+        case  8: k1 ^= ((uint64_t) key[7]) << 56;
+        case  7: k1 ^= ((uint64_t) key[6]) << 48;
+        case  6: k1 ^= ((uint64_t) key[5]) << 40;
+        case  5: k1 ^= ((uint64_t) key[4]) << 32;
+        case  4: k1 ^= ((uint64_t) key[3]) << 24;
+        case  3: k1 ^= ((uint64_t) key[2]) << 16;
+        case  2: k1 ^= ((uint64_t) key[1]) << 8;
+        case  1: k1 ^= ((uint64_t) key[0]);
+            k1 *= c1; k1  = rotl64(k1,31); k1 *= c2; h1 ^= k1;
+        };
+
+        //----------
+        // finalization
+
+        h1 ^= length; h2 ^= length;
+
+        h1 += h2;
+        h2 += h1;
+
+        h1 = fmix(h1);
+        h2 = fmix(h2);
+
+        h1 += h2;
+        h2 += h1;
+
+        result[0] = h1;
+        result[1] = h2;
+    }
+};
 
-    h1 += h2;
-    h2 += h1;
+}
 
-    h1 = fmix(h1);
-    h2 = fmix(h2);
+void hash3_x64_128(bytes_view key, uint64_t seed, std::array<uint64_t,2> &result)
+{
+    const uint32_t nblocks = key.size() >> 4; // Process as 128-bit blocks.
 
-    h1 += h2;
-    h2 += h1;
+    hash3_state st(seed);
+    for (uint32_t i = 0; i < nblocks; i++) {
+        st.block(key, i);
+    }
+    st.finish(key, result);
+}
 
-    result[0] = h1;
-    result[1] = h2;
+void hash3_x64_128(std::span<const bytes_view> keys, uint64_t seed, std::span<std::array<uint64_t,2>> results)
+{
+    // Each hash is a long chain of dependent multiplications, so hashing one
+    // key at a time leaves most of the CPU's multipliers idle. Hashing a few
+    // keys in lock-step gives it independent chains to overlap.
+    constexpr size_t lanes = 4;
+
+    size_t i = 0;
+    for (; i + lanes <= keys.size(); i += lanes) {
+        auto in = keys.subspan(i, lanes);
+        std::array<hash3_state, lanes> st{hash3_state(seed), hash3_state(seed), hash3_state(seed), hash3_state(seed)};
+        std::array<uint32_t, lanes> nblocks;
+        uint32_t common_blocks = std::numeric_limits<uint32_t>::max();
+        for (size_t l = 0; l < lanes; ++l) {
+            nblocks[l] = in[l].size() >> 4;
+            common_blocks = std::min(common_blocks, nblocks[l]);
+        }
+        for (uint32_t b = 0; b < common_blocks; ++b) {
+            for (size_t l = 0; l < lanes; ++l) {
+                st[l].block(in[l], b);
+            }
+        }
+        for (size_t l = 0; l < lanes; ++l) {
+            for (uint32_t b = common_blocks; b < nblocks[l]; ++b) {
+                st[l].block(in[l], b);
+            }
+        }
+        for (size_t l = 0; l < lanes; ++l) {
+            st[l].finish(in[l], results[i + l]);
+        }
+    }
+    for (; i < keys.size(); ++i) {
+        hash3_x64_128(keys[i], seed, results[i]);
+    }
 }
 
 } // namespace murmur_hash
@@ -12,6 +12,7 @@
 
 #include <cstdint>
 #include <array>
+#include <span>
 
 #include "bytes.hh"
 
@@ -139,6 +140,11 @@ void hash3_x64_128(InputIterator in, uint32_t length, uint64_t seed, std::array<
 
 void hash3_x64_128(bytes_view key, uint64_t seed, std::array<uint64_t, 2>& result);
 
+// Hashes each of the keys, as hash3_x64_128(bytes_view) does, into the
+// corresponding element of results, which must be at least as long.
+// Faster than hashing the keys one by one.
+void hash3_x64_128(std::span<const bytes_view> keys, uint64_t seed, std::span<std::array<uint64_t, 2>> results);
+
 } // namespace murmur_hash
 
 } // namespace utils
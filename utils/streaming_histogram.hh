@@ -150,6 +150,42 @@ struct streaming_histogram {
         return sum;
     }
 
+    /**
+     * Estimates the point b such that q of the points are in interval [-inf,b],
+     * i.e. the inverse of sum().
+     *
+     * @param q fraction of the points, in [0, 1]
+     * @return estimated point b, or 0 if the histogram is empty.
+     */
+    double quantile(double q) const {
+        if (bin.empty()) {
+            return 0;
+        }
+        uint64_t total = 0;
+        for (auto& e : bin) {
+            total += e.second;
+        }
+        double target = q * total;
+        // sum() is non-decreasing, so bisect it between the first and last points.
+        double lo = bin.begin()->first;
+        double hi = bin.rbegin()->first;
+        if (sum(lo) >= target) {
+            return lo;
+        }
+        for (int i = 0; i < 64 && lo < hi; ++i) {
+            double mid = lo + (hi - lo) / 2;
+            if (mid <= lo || mid >= hi) {
+                break;
+            }
+            if (sum(mid) < target) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return hi;
+    }
+
     // FIXME: convert Java code below.
 #if 0
     public Map<Double, Long> getAsMap()
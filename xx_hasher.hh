@@ -17,6 +17,7 @@
 #pragma GCC diagnostic pop
 
 #include <array>
+#include <cstring>
 
 class xx_hasher {
     static constexpr size_t digest_size = 16;
@@ -61,3 +62,81 @@ class legacy_xx_hasher_without_null_digest : public xx_hasher {
 public:
     explicit legacy_xx_hasher_without_null_digest(uint64_t seed = 0) noexcept : xx_hasher(seed) {}
 };
+
+// Hashes with the 128-bit variant of XXH3, whose inner loop is vectorized.
+//
+// Digests are fed many small values (cell hashes, timestamps, lengths), and
+// XXH3 is at its fastest when given large inputs, so updates are coalesced
+// in a buffer which is handed over to XXH3 when full.
+class xxh3_hasher {
+    static constexpr size_t digest_size = 16;
+    static constexpr size_t buffer_size = 1024;
+    XXH3_state_t _state;
+    size_t _buffered = 0;
+    std::array<char, buffer_size> _buffer;
+private:
+    void flush() noexcept {
+        XXH3_128bits_update(&_state, _buffer.data(), _buffered);
+        _buffered = 0;
+    }
+
+    XXH128_hash_t digest() noexcept {
+        flush();
+        return XXH3_128bits_digest(&_state);
+    }
+public:
+    explicit xxh3_hasher(uint64_t seed = 0) noexcept {
+        XXH3_128bits_reset_withSeed(&_state, seed);
+    }
+
+    // Only the buffered part of the buffer is copied.
+    xxh3_hasher(const xxh3_hasher& o) noexcept : _buffered(o._buffered) {
+        XXH3_copyState(&_state, &o._state);
+        std::memcpy(_buffer.data(), o._buffer.data(), _buffered);
+    }
+
+    xxh3_hasher& operator=(const xxh3_hasher& o) noexcept {
+        if (this != &o) {
+            XXH3_copyState(&_state, &o._state);
+            _buffered = o._buffered;
+            std::memcpy(_buffer.data(), o._buffer.data(), _buffered);
+        }
+        return *this;
+    }
+
+    void update(const char* ptr, size_t length) noexcept {
+        if (length > buffer_size - _buffered) [[unlikely]] {
+            flush();
+            if (length >= buffer_size) {
+                XXH3_128bits_update(&_state, ptr, length);
+                return;
+            }
+        }
+        std::memcpy(_buffer.data() + _buffered, ptr, length);
+        _buffered += length;
+    }
+
+    bytes finalize() {
+        bytes digest{bytes::initialized_later(), digest_size};
+        serialize_to(digest.begin());
+        return digest;
+    }
+
+    std::array<uint8_t, digest_size> finalize_array() {
+        std::array<uint8_t, digest_size> digest;
+        serialize_to(digest.begin());
+        return digest;
+    }
+
+    uint64_t finalize_uint64() {
+        return digest().low64;
+    }
+
+private:
+    template<typename OutIterator>
+    void serialize_to(OutIterator&& out) {
+        auto h = digest();
+        serialize_int64(out, h.high64);
+        serialize_int64(out, h.low64);
+    }
+};
@@ -12,15 +12,53 @@
 // which are available only when the library is linked statically.
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd.h"
+#include "zdict.h"
 
 #include "compress.hh"
+#include "utils/base64.hh"
 #include "utils/class_registrator.hh"
 
 static const sstring COMPRESSION_LEVEL = "compression_level";
+static const sstring DICTIONARY_SIZE_KB = "dictionary_size_in_kb";
+// Not accepted from the user, only set in CompressionInfo of SSTables compressed with a dictionary.
+// Holds the base64-encoded dictionary.
+static const sstring DICTIONARY = "dictionary";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
 
+// Values of CompressionInfo options are limited to 64k, which must fit the base64-encoded dictionary.
+static constexpr int max_dictionary_size_kb = 32;
+// zstd recommends training dictionaries on about 100 times their size worth of samples.
+static constexpr size_t dictionary_sample_ratio = 64;
+
+struct cdict_deleter {
+    void operator()(ZSTD_CDict* cdict) const noexcept {
+        ZSTD_freeCDict(cdict);
+    }
+};
+
+struct ddict_deleter {
+    void operator()(ZSTD_DDict* ddict) const noexcept {
+        ZSTD_freeDDict(ddict);
+    }
+};
+
 class zstd_processor : public compressor {
     int _compression_level = 3;
+    int _chunk_len;
+    int _dictionary_size_kb = 0;
+
+    // Dictionary used by this compressor, empty if none.
+    bytes _dictionary;
+    ZSTD_compressionParameters _cparams;
+    // Digested dictionaries, created on first use, since SSTable readers
+    // only decompress and writers only compress.
+    mutable std::unique_ptr<ZSTD_CDict, cdict_deleter> _cdict;
+    mutable std::unique_ptr<ZSTD_DDict, ddict_deleter> _ddict;
+
+    // Base64-encoded dictionary trained for the first SSTable written using this
+    // compressor (i.e. the table's), reused by all SSTables written after it,
+    // so that the cost of training is paid once per table schema and shard.
+    mutable std::optional<sstring> _trained_dictionary;
 
     // Manages memory for the compression context.
     std::unique_ptr<char[], free_deleter> _cctx_raw;
@@ -42,6 +80,9 @@ class zstd_processor : public compressor {
 
     std::set<sstring> option_names() const override;
     std::map<sstring, sstring> options() const override;
+
+    size_t dictionary_sample_size() const override;
+    shared_ptr<compressor> with_dictionary(const std::vector<temporary_buffer<char>>& samples) const override;
 };
 
 zstd_processor::zstd_processor(const opt_getter& opts)
@@ -67,14 +108,34 @@ zstd_processor::zstd_processor(const opt_getter& opts)
     if (!chunk_len_kb) {
         chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
     }
-    auto chunk_len = chunk_len_kb
+    _chunk_len = chunk_len_kb
        // This parameter has already been validated.
        ? std::stoi(*chunk_len_kb) * 1024
        : compression_parameters::DEFAULT_CHUNK_LENGTH;
 
+    auto dictionary_size_kb = opts(DICTIONARY_SIZE_KB);
+    if (dictionary_size_kb) {
+        try {
+            _dictionary_size_kb = std::stoi(*dictionary_size_kb);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(
+                format("Invalid integer value {} for {}", *dictionary_size_kb, DICTIONARY_SIZE_KB));
+        }
+
+        if (_dictionary_size_kb < 0 || _dictionary_size_kb > max_dictionary_size_kb) {
+            throw exceptions::configuration_exception(
+                format("{} must be between 0 and {}, got {}", DICTIONARY_SIZE_KB, max_dictionary_size_kb, _dictionary_size_kb));
+        }
+    }
+
+    auto dictionary = opts(DICTIONARY);
+    if (dictionary) {
+        _dictionary = base64_decode(*dictionary);
+    }
+
     // We assume that the uncompressed input length is always <= chunk_len.
-    auto cparams = ZSTD_getCParams(_compression_level, chunk_len, 0);
-    auto cctx_size = ZSTD_estimateCCtxSize_usingCParams(cparams);
+    _cparams = ZSTD_getCParams(_compression_level, _chunk_len, _dictionary.size());
+    auto cctx_size = ZSTD_estimateCCtxSize_usingCParams(_cparams);
     // According to the ZSTD documentation, pointer to the context buffer must be 8-bytes aligned.
     _cctx_raw = allocate_aligned_buffer<char>(cctx_size, 8);
     _cctx = ZSTD_initStaticCCtx(_cctx_raw.get(), cctx_size);
@@ -91,7 +152,15 @@ zstd_processor::zstd_processor(const opt_getter& opts)
 }
 
 size_t zstd_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
+    if (!_dictionary.empty() && !_ddict) {
+        _ddict.reset(ZSTD_createDDict(_dictionary.data(), _dictionary.size()));
+        if (!_ddict) {
+            throw std::runtime_error("Unable to create ZSTD decompression dictionary");
+        }
+    }
+    auto ret = _ddict
+        ? ZSTD_decompress_usingDDict(_dctx, output, output_len, input, input_len, _ddict.get())
+        : ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD decompression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -100,7 +169,17 @@ size_t zstd_processor::uncompress(const char* input, size_t input_len, char* out
 
 
 size_t zstd_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
+    if (!_dictionary.empty() && !_cdict) {
+        // Digest the dictionary with the same parameters the compression context was sized for.
+        _cdict.reset(ZSTD_createCDict_advanced(_dictionary.data(), _dictionary.size(),
+                ZSTD_dlm_byCopy, ZSTD_dct_auto, _cparams, ZSTD_defaultCMem));
+        if (!_cdict) {
+            throw std::runtime_error("Unable to create ZSTD compression dictionary");
+        }
+    }
+    auto ret = _cdict
+        ? ZSTD_compress_usingCDict(_cctx, output, output_len, input, input_len, _cdict.get())
+        : ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD compression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -112,11 +191,67 @@ size_t zstd_processor::compress_max_size(size_t input_len) const {
 }
 
 std::set<sstring> zstd_processor::option_names() const {
-    return {COMPRESSION_LEVEL};
+    return {COMPRESSION_LEVEL, DICTIONARY_SIZE_KB};
 }
 
 std::map<sstring, sstring> zstd_processor::options() const {
-    return {{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    std::map<sstring, sstring> opts{{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    if (_dictionary_size_kb) {
+        opts.emplace(DICTIONARY_SIZE_KB, std::to_string(_dictionary_size_kb));
+    }
+    if (!_dictionary.empty()) {
+        opts.emplace(DICTIONARY, sstring(base64_encode(_dictionary)));
+    }
+    return opts;
+}
+
+size_t zstd_processor::dictionary_sample_size() const {
+    if (!_dictionary_size_kb || !_dictionary.empty()) {
+        return 0;
+    }
+    if (_trained_dictionary) {
+        // Nothing to train, but we still want with_dictionary() to be called.
+        return 1;
+    }
+    return _dictionary_size_kb * 1024 * dictionary_sample_ratio;
+}
+
+shared_ptr<compressor> zstd_processor::with_dictionary(const std::vector<temporary_buffer<char>>& samples) const {
+    if (!_dictionary_size_kb || !_dictionary.empty()) {
+        return nullptr;
+    }
+    if (!_trained_dictionary) {
+        std::vector<size_t> sample_sizes;
+        sample_sizes.reserve(samples.size());
+        size_t total_size = 0;
+        for (auto& s : samples) {
+            sample_sizes.push_back(s.size());
+            total_size += s.size();
+        }
+        auto buf = std::make_unique<char[]>(total_size);
+        auto* p = buf.get();
+        for (auto& s : samples) {
+            p = std::copy(s.begin(), s.end(), p);
+        }
+        bytes dictionary(bytes::initialized_later(), _dictionary_size_kb * 1024);
+        auto ret = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), buf.get(), sample_sizes.data(), sample_sizes.size());
+        if (ZDICT_isError(ret)) {
+            // Typically, too little data to train on. Try again with the next SSTable.
+            return nullptr;
+        }
+        dictionary.resize(ret);
+        _trained_dictionary = sstring(base64_encode(dictionary));
+    }
+    auto opts = options();
+    opts.emplace(DICTIONARY, *_trained_dictionary);
+    opts.emplace(compression_parameters::CHUNK_LENGTH_KB, std::to_string(_chunk_len / 1024));
+    return ::make_shared<zstd_processor>([&opts] (const sstring& key) -> opt_string {
+        auto i = opts.find(key);
+        if (i == opts.end()) {
+            return std::nullopt;
+        }
+        return i->second;
+    });
 }
 
 static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>